@@ -44,6 +44,10 @@ DEFINE_int32(erase_percent, 10,
              "Ratio of erase to total workload (expressed as a percentage)");
 
 DEFINE_bool(use_clock_cache, false, "");
+DEFINE_bool(use_lock_free_clock_cache, false, "");
+DEFINE_uint64(estimated_entry_charge, 1,
+              "Expected average charge of an entry, for sizing the table of "
+              "the lock-free clock cache.");
 
 namespace rocksdb {
 
@@ -135,6 +139,14 @@ class CacheBench {
         fprintf(stderr, "Clock cache not supported.\n");
         exit(1);
       }
+    } else if (FLAGS_use_lock_free_clock_cache) {
+      cache_ = NewLockFreeClockCache(FLAGS_cache_size,
+                                     FLAGS_estimated_entry_charge,
+                                     FLAGS_num_shard_bits);
+      if (!cache_) {
+        fprintf(stderr, "Invalid lock-free clock cache options.\n");
+        exit(1);
+      }
     } else {
       cache_ = NewLRUCache(FLAGS_cache_size, FLAGS_num_shard_bits);
     }
@@ -245,6 +257,7 @@ class CacheBench {
 
   void PrintEnv() const {
     printf("RocksDB version     : %d.%d\n", kMajorVersion, kMinorVersion);
+    printf("Cache type          : %s\n", cache_->Name());
     printf("Number of threads   : %d\n", FLAGS_threads);
     printf("Ops per thread      : %" PRIu64 "\n", FLAGS_ops_per_thread);
     printf("Cache size          : %" PRIu64 "\n", FLAGS_cache_size);
@@ -39,6 +39,7 @@ static int DecodeValue(void* v) {
 
 const std::string kLRU = "lru";
 const std::string kClock = "clock";
+const std::string kLockFreeClock = "lock_free_clock";
 
 void dumbDeleter(const Slice& /*key*/, void* /*value*/) {}
 
@@ -83,6 +84,10 @@ class CacheTest : public testing::TestWithParam<std::string> {
     if (type == kClock) {
       return NewClockCache(capacity);
     }
+    if (type == kLockFreeClock) {
+      return NewLockFreeClockCache(capacity,
+                                   4096 /* estimated_entry_charge */);
+    }
     return nullptr;
   }
 
@@ -95,9 +100,21 @@ class CacheTest : public testing::TestWithParam<std::string> {
     if (type == kClock) {
       return NewClockCache(capacity, num_shard_bits, strict_capacity_limit);
     }
+    if (type == kLockFreeClock) {
+      return NewLockFreeClockCache(capacity, 1 /* estimated_entry_charge */,
+                                   num_shard_bits, strict_capacity_limit);
+    }
     return nullptr;
   }
 
+  // Number of inserts of new keys into cache_ after which every unpinned
+  // entry that is not looked up is expected to be evicted. In the lock-free
+  // clock cache, the eviction order depends on where entries land in the
+  // table, so the clock hand needs a few laps over each shard.
+  int NumInsertsToEvictAll() {
+    return GetParam() == kLockFreeClock ? 4 * kCacheSize : kCacheSize + 200;
+  }
+
   int Lookup(std::shared_ptr<Cache> cache, int key) {
     Cache::Handle* handle = cache->Lookup(EncodeKey(key));
     const int r = (handle == nullptr) ? -1 : DecodeValue(cache->Value(handle));
@@ -306,7 +323,7 @@ TEST_P(CacheTest, EvictionPolicy) {
   Insert(200, 201);
 
   // Frequently used entry must be kept around
-  for (int i = 0; i < kCacheSize + 200; i++) {
+  for (int i = 0; i < NumInsertsToEvictAll(); i++) {
     Insert(1000+i, 2000+i);
     ASSERT_EQ(101, Lookup(100));
   }
@@ -359,7 +376,7 @@ TEST_P(CacheTest, EvictionPolicyRef) {
   Insert(303, 104);
 
   // Insert entries much more than Cache capacity
-  for (int i = 0; i < kCacheSize + 200; i++) {
+  for (int i = 0; i < NumInsertsToEvictAll(); i++) {
     Insert(1000 + i, 2000 + i);
   }
 
@@ -700,9 +717,10 @@ TEST_P(CacheTest, GetCharge) {
 std::shared_ptr<Cache> (*new_clock_cache_func)(size_t, int,
                                                bool) = NewClockCache;
 INSTANTIATE_TEST_CASE_P(CacheTestInstance, CacheTest,
-                        testing::Values(kLRU, kClock));
+                        testing::Values(kLRU, kClock, kLockFreeClock));
 #else
-INSTANTIATE_TEST_CASE_P(CacheTestInstance, CacheTest, testing::Values(kLRU));
+INSTANTIATE_TEST_CASE_P(CacheTestInstance, CacheTest,
+                        testing::Values(kLRU, kLockFreeClock));
 #endif  // SUPPORT_CLOCK_CACHE
 
 }  // namespace rocksdb
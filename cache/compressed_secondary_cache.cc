@@ -0,0 +1,147 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "cache/compressed_secondary_cache.h"
+
+#include <stdio.h>
+
+#include "table/block_based/block_based_table_builder.h"
+#include "table/format.h"
+#include "util/compression.h"
+
+namespace rocksdb {
+
+namespace {
+void DeleteEntry(const Slice& /*key*/, void* value) {
+  delete reinterpret_cast<std::string*>(value);
+}
+}  // namespace
+
+CompressedSecondaryCache::CompressedSecondaryCache(
+    const CompressedSecondaryCacheOptions& opts)
+    : opts_(opts),
+      cache_(NewLRUCache(opts.capacity, opts.num_shard_bits,
+                         false /* strict_capacity_limit */,
+                         0.0 /* high_pri_pool_ratio */)),
+      options_(),
+      ioptions_(options_) {}
+
+CompressedSecondaryCache::~CompressedSecondaryCache() {}
+
+Status CompressedSecondaryCache::Insert(const Slice& key, void* value,
+                                        const Cache::CacheItemHelper* helper) {
+  if (helper == nullptr || helper->size_cb == nullptr ||
+      helper->saveto_cb == nullptr) {
+    return Status::NotSupported("Entry cannot be serialized");
+  }
+  size_t size = (*helper->size_cb)(value);
+  std::string raw;
+  raw.resize(size);
+  Status s = (*helper->saveto_cb)(value, 0, size, &raw[0]);
+  if (!s.ok()) {
+    return s;
+  }
+
+  // CompressBlock falls back to the raw contents when the type is not
+  // supported or the ratio is not worth it.
+  CompressionOptions compression_opts;
+  CompressionContext context(opts_.compression_type);
+  CompressionInfo info(compression_opts, context,
+                       CompressionDict::GetEmptyDict(), opts_.compression_type,
+                       0 /* sample_for_compression */);
+  CompressionType type = opts_.compression_type;
+  std::string compressed;
+  Slice contents =
+      CompressBlock(raw, info, &type, kCompressFormatVersion,
+                    false /* do_sample */, &compressed, nullptr, nullptr);
+
+  std::string* entry = new std::string();
+  entry->reserve(contents.size() + 1);
+  entry->push_back(static_cast<char>(type));
+  entry->append(contents.data(), contents.size());
+  return cache_->Insert(key, entry, entry->size(), &DeleteEntry);
+}
+
+Status CompressedSecondaryCache::Lookup(const Slice& key,
+                                        const Cache::CreateCallback& create_cb,
+                                        void** value, size_t* charge) {
+  Cache::Handle* handle = cache_->Lookup(key);
+  if (handle == nullptr) {
+    return Status::NotFound();
+  }
+  const std::string* entry =
+      reinterpret_cast<const std::string*>(cache_->Value(handle));
+  assert(!entry->empty());
+  CompressionType type = static_cast<CompressionType>((*entry)[0]);
+  Slice data(entry->data() + 1, entry->size() - 1);
+
+  Status s;
+  BlockContents contents;
+  if (type != kNoCompression) {
+    UncompressionContext context(type);
+    UncompressionInfo info(context, UncompressionDict::GetEmptyDict(), type);
+    s = UncompressBlockContentsForCompressionType(
+        info, data.data(), data.size(), &contents, kCompressFormatVersion,
+        ioptions_, opts_.memory_allocator.get());
+    data = contents.data;
+  }
+  if (s.ok()) {
+    s = create_cb(data.data(), data.size(), value, charge);
+  }
+
+  // The entry goes back to the primary cache. Other threads looking it up
+  // at the same time still hold their own reference. If it could not be
+  // recreated, keep it here rather than losing it from both tiers.
+  if (s.ok()) {
+    cache_->Erase(key);
+  }
+  cache_->Release(handle);
+  return s;
+}
+
+void CompressedSecondaryCache::Erase(const Slice& key) { cache_->Erase(key); }
+
+size_t CompressedSecondaryCache::GetUsage() const {
+  return cache_->GetUsage();
+}
+
+std::string CompressedSecondaryCache::GetPrintableOptions() const {
+  const int kBufferSize = 200;
+  char buffer[kBufferSize];
+  std::string ret;
+  snprintf(buffer, kBufferSize, "    capacity : %" ROCKSDB_PRIszt "\n",
+           opts_.capacity);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "    num_shard_bits : %d\n",
+           opts_.num_shard_bits);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "    compression_type : %s\n",
+           CompressionTypeToString(opts_.compression_type).c_str());
+  ret.append(buffer);
+  return ret;
+}
+
+bool CompressedSecondaryCache::TEST_GetCompressionType(const Slice& key,
+                                                       CompressionType* type) {
+  Cache::Handle* handle = cache_->Lookup(key);
+  if (handle == nullptr) {
+    return false;
+  }
+  const std::string* entry =
+      reinterpret_cast<const std::string*>(cache_->Value(handle));
+  *type = static_cast<CompressionType>((*entry)[0]);
+  cache_->Release(handle);
+  return true;
+}
+
+std::shared_ptr<SecondaryCache> NewCompressedSecondaryCache(
+    const CompressedSecondaryCacheOptions& opts) {
+  if (opts.num_shard_bits >= 20) {
+    return nullptr;  // the cache cannot be sharded into too many fine pieces
+  }
+  return std::make_shared<CompressedSecondaryCache>(opts);
+}
+
+}  // namespace rocksdb
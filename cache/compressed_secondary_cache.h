@@ -0,0 +1,60 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "options/cf_options.h"
+#include "rocksdb/cache.h"
+#include "rocksdb/options.h"
+#include "rocksdb/secondary_cache.h"
+
+namespace rocksdb {
+
+// An in-memory secondary cache of compressed entries. The entries live in an
+// LRU cache of their own, keyed like the primary cache, whose values are
+// the serialized entry compressed with opts.compression_type and prefixed
+// with the compression type actually used (one byte).
+//
+// A hit decompresses the entry, recreates it with the caller's
+// CreateCallback and erases it from this tier, since the primary cache is
+// about to hold it again.
+class CompressedSecondaryCache : public SecondaryCache {
+ public:
+  explicit CompressedSecondaryCache(const CompressedSecondaryCacheOptions& opts);
+  ~CompressedSecondaryCache() override;
+
+  const char* Name() const override { return "CompressedSecondaryCache"; }
+
+  Status Insert(const Slice& key, void* value,
+                const Cache::CacheItemHelper* helper) override;
+
+  Status Lookup(const Slice& key, const Cache::CreateCallback& create_cb,
+                void** value, size_t* charge) override;
+
+  void Erase(const Slice& key) override;
+
+  size_t GetUsage() const override;
+
+  std::string GetPrintableOptions() const override;
+
+  // Compression type of the entry for key, or false if it is not cached.
+  // For testing.
+  bool TEST_GetCompressionType(const Slice& key, CompressionType* type);
+
+ private:
+  // Same block format as the block based table (format_version >= 2)
+  static const uint32_t kCompressFormatVersion = 2;
+
+  const CompressedSecondaryCacheOptions opts_;
+  std::shared_ptr<Cache> cache_;
+  // For the statistics and environment used by decompression
+  const Options options_;
+  const ImmutableCFOptions ioptions_;
+};
+
+}  // namespace rocksdb
@@ -0,0 +1,377 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "cache/compressed_secondary_cache.h"
+
+#include <string>
+#include <vector>
+#include "cache/lru_cache.h"
+#include "test_util/testharness.h"
+#include "test_util/testutil.h"
+#include "util/compression.h"
+#include "util/random.h"
+
+namespace rocksdb {
+
+namespace {
+struct TestItem {
+  explicit TestItem(const std::string& _buf) : buf(_buf) {}
+  std::string buf;
+};
+
+std::atomic<int> num_deleted;
+
+size_t SizeCallback(void* obj) {
+  return reinterpret_cast<TestItem*>(obj)->buf.size();
+}
+
+Status SaveToCallback(void* from_obj, size_t from_offset, size_t length,
+                      void* out) {
+  TestItem* item = reinterpret_cast<TestItem*>(from_obj);
+  memcpy(out, item->buf.data() + from_offset, length);
+  return Status::OK();
+}
+
+void DeletionCallback(const Slice& /*key*/, void* obj) {
+  delete reinterpret_cast<TestItem*>(obj);
+  num_deleted.fetch_add(1);
+}
+
+Cache::CacheItemHelper helper(&SizeCallback, &SaveToCallback,
+                              &DeletionCallback);
+
+Status CreateCallback(const void* buf, size_t size, void** out_obj,
+                      size_t* charge) {
+  *out_obj = new TestItem(std::string(reinterpret_cast<const char*>(buf), size));
+  *charge = size;
+  return Status::OK();
+}
+
+// Highly compressible contents of length len
+std::string CompressibleString(Random* rnd, size_t len) {
+  std::string str;
+  test::CompressibleString(rnd, 0.2, static_cast<int>(len), &str);
+  return str;
+}
+
+// Incompressible contents of length len
+std::string RandomContents(Random* rnd, size_t len) {
+  std::string str;
+  for (size_t i = 0; i < len; i++) {
+    str.push_back(static_cast<char>(rnd->Uniform(256)));
+  }
+  return str;
+}
+
+// The type to expect for compressible entries
+CompressionType SupportedCompression() {
+  for (CompressionType type : {kLZ4Compression, kSnappyCompression,
+                               kZSTD, kZlibCompression}) {
+    if (CompressionTypeSupported(type)) {
+      return type;
+    }
+  }
+  return kNoCompression;
+}
+
+// Counts the erases that reach the wrapped secondary cache
+class EraseCountingSecondaryCache : public SecondaryCache {
+ public:
+  explicit EraseCountingSecondaryCache(std::shared_ptr<SecondaryCache> target)
+      : target_(std::move(target)), num_erases_(0) {}
+
+  const char* Name() const override { return "EraseCountingSecondaryCache"; }
+  Status Insert(const Slice& key, void* value,
+                const Cache::CacheItemHelper* item_helper) override {
+    return target_->Insert(key, value, item_helper);
+  }
+  Status Lookup(const Slice& key, const Cache::CreateCallback& create_cb,
+                void** value, size_t* charge) override {
+    return target_->Lookup(key, create_cb, value, charge);
+  }
+  void Erase(const Slice& key) override {
+    num_erases_++;
+    target_->Erase(key);
+  }
+  size_t GetUsage() const override { return target_->GetUsage(); }
+  std::string GetPrintableOptions() const override {
+    return target_->GetPrintableOptions();
+  }
+
+  int num_erases() const { return num_erases_; }
+
+ private:
+  std::shared_ptr<SecondaryCache> target_;
+  std::atomic<int> num_erases_;
+};
+}  // namespace
+
+class CompressedSecondaryCacheTest : public testing::Test {
+ public:
+  CompressedSecondaryCacheTest() : rnd_(301) { num_deleted = 0; }
+
+  std::unique_ptr<CompressedSecondaryCache> NewSecondaryCache(
+      size_t capacity, CompressionType type = SupportedCompression()) {
+    CompressedSecondaryCacheOptions opts(capacity, 0 /* num_shard_bits */,
+                                         type);
+    return std::unique_ptr<CompressedSecondaryCache>(
+        new CompressedSecondaryCache(opts));
+  }
+
+  std::string Lookup(SecondaryCache* cache, const std::string& key) {
+    void* value = nullptr;
+    size_t charge = 0;
+    Status s = cache->Lookup(key, &CreateCallback, &value, &charge);
+    if (!s.ok()) {
+      EXPECT_TRUE(s.IsNotFound());
+      return "NOT_FOUND";
+    }
+    TestItem* item = reinterpret_cast<TestItem*>(value);
+    EXPECT_EQ(item->buf.size(), charge);
+    std::string result = item->buf;
+    delete item;
+    return result;
+  }
+
+  Random rnd_;
+};
+
+TEST_F(CompressedSecondaryCacheTest, BasicTest) {
+  auto cache = NewSecondaryCache(1 << 20);
+  std::string str1 = CompressibleString(&rnd_, 1000);
+  TestItem item1(str1);
+  ASSERT_OK(cache->Insert("k1", &item1, &helper));
+  // The item stays owned by the caller
+  ASSERT_EQ(0, num_deleted.load());
+
+  CompressionType type;
+  ASSERT_TRUE(cache->TEST_GetCompressionType("k1", &type));
+  ASSERT_EQ(SupportedCompression(), type);
+  if (type != kNoCompression) {
+    ASSERT_LT(cache->GetUsage(), str1.size());
+  }
+
+  // Random contents are kept as they are
+  std::string str2 = RandomContents(&rnd_, 1000);
+  TestItem item2(str2);
+  ASSERT_OK(cache->Insert("k2", &item2, &helper));
+  ASSERT_TRUE(cache->TEST_GetCompressionType("k2", &type));
+  ASSERT_EQ(kNoCompression, type);
+
+  ASSERT_EQ(str1, Lookup(cache.get(), "k1"));
+  ASSERT_EQ(str2, Lookup(cache.get(), "k2"));
+  // A hit moves the entry out of the secondary cache
+  ASSERT_EQ("NOT_FOUND", Lookup(cache.get(), "k1"));
+  ASSERT_EQ(0, cache->GetUsage());
+
+  ASSERT_OK(cache->Insert("k1", &item1, &helper));
+  cache->Erase("k1");
+  ASSERT_EQ("NOT_FOUND", Lookup(cache.get(), "k1"));
+}
+
+TEST_F(CompressedSecondaryCacheTest, NoCompression) {
+  auto cache = NewSecondaryCache(1 << 20, kNoCompression);
+  std::string str = CompressibleString(&rnd_, 1000);
+  TestItem item(str);
+  ASSERT_OK(cache->Insert("k1", &item, &helper));
+  CompressionType type;
+  ASSERT_TRUE(cache->TEST_GetCompressionType("k1", &type));
+  ASSERT_EQ(kNoCompression, type);
+  ASSERT_EQ(str, Lookup(cache.get(), "k1"));
+}
+
+TEST_F(CompressedSecondaryCacheTest, ZlibCompression) {
+  if (!Zlib_Supported()) {
+    fprintf(stderr, "zlib compression not supported, skip\n");
+    return;
+  }
+  auto cache = NewSecondaryCache(1 << 20, kZlibCompression);
+  std::string str = CompressibleString(&rnd_, 4000);
+  TestItem item(str);
+  ASSERT_OK(cache->Insert("k1", &item, &helper));
+  CompressionType type;
+  ASSERT_TRUE(cache->TEST_GetCompressionType("k1", &type));
+  ASSERT_EQ(kZlibCompression, type);
+  ASSERT_LT(cache->GetUsage(), str.size() / 2);
+  ASSERT_EQ(str, Lookup(cache.get(), "k1"));
+  ASSERT_EQ(0, cache->GetUsage());
+}
+
+TEST_F(CompressedSecondaryCacheTest, FailedCreateKeepsEntry) {
+  auto cache = NewSecondaryCache(1 << 20);
+  std::string str = CompressibleString(&rnd_, 1000);
+  TestItem item(str);
+  ASSERT_OK(cache->Insert("k1", &item, &helper));
+
+  void* value = nullptr;
+  size_t charge = 0;
+  Cache::CreateCallback fail_cb = [](const void* /*buf*/, size_t /*size*/,
+                                     void** /*out_obj*/, size_t* /*charge*/) {
+    return Status::Corruption("create failed");
+  };
+  ASSERT_TRUE(cache->Lookup("k1", fail_cb, &value, &charge).IsCorruption());
+  // A failed promotion leaves the entry in place
+  ASSERT_EQ(str, Lookup(cache.get(), "k1"));
+}
+
+TEST_F(CompressedSecondaryCacheTest, Capacity) {
+  auto cache = NewSecondaryCache(5000, kNoCompression);
+  for (int i = 0; i < 10; i++) {
+    TestItem item(RandomContents(&rnd_, 1000));
+    ASSERT_OK(cache->Insert("k" + ToString(i), &item, &helper));
+  }
+  ASSERT_LE(cache->GetUsage(), 5000);
+  // The oldest entries are evicted first
+  ASSERT_EQ("NOT_FOUND", Lookup(cache.get(), "k0"));
+  ASSERT_NE("NOT_FOUND", Lookup(cache.get(), "k9"));
+}
+
+TEST_F(CompressedSecondaryCacheTest, LRUCacheIntegration) {
+  const size_t kEntrySize = 64 * 1024;
+  const size_t kCapacity = 4 << 20;
+  const size_t kSecondaryCapacity = 1 << 20;
+  std::shared_ptr<SecondaryCache> secondary_cache =
+      NewCompressedSecondaryCache(CompressedSecondaryCacheOptions(
+          kSecondaryCapacity, 0 /* num_shard_bits */, SupportedCompression()));
+  LRUCacheOptions opts(kCapacity, 0 /* num_shard_bits */,
+                       false /* strict_capacity_limit */,
+                       0.0 /* high_pri_pool_ratio */);
+  opts.secondary_cache = secondary_cache;
+  std::shared_ptr<Cache> cache = NewLRUCache(opts);
+  LRUCache* lru_cache = static_cast<LRUCache*>(cache.get());
+
+  // Twice the capacity, so that half of the entries get evicted
+  const int kNumEntries = static_cast<int>(2 * kCapacity / kEntrySize);
+  std::vector<std::string> values;
+  for (int i = 0; i < kNumEntries; i++) {
+    values.push_back(CompressibleString(&rnd_, kEntrySize));
+    TestItem* item = new TestItem(values.back());
+    ASSERT_OK(cache->InsertWithHelper("k" + ToString(i), item, &helper,
+                                      kEntrySize));
+  }
+  ASSERT_LE(cache->GetUsage(), kCapacity);
+  ASSERT_GT(secondary_cache->GetUsage(), 0);
+  // The memory of the secondary cache is charged to the primary cache, in
+  // 256KB units.
+  size_t reservation = lru_cache->GetSecondaryCacheReservation();
+  ASSERT_GE(reservation, secondary_cache->GetUsage());
+  ASSERT_LT(reservation, secondary_cache->GetUsage() + 256 * 1024);
+
+  // The most recently evicted entries are in the secondary cache
+  int newest_evicted = kNumEntries - 1;
+  for (; newest_evicted >= 0; newest_evicted--) {
+    Cache::Handle* handle = cache->Lookup("k" + ToString(newest_evicted));
+    if (handle == nullptr) {
+      break;
+    }
+    cache->Release(handle);
+  }
+  ASSERT_GT(newest_evicted, 0);
+  std::string key = "k" + ToString(newest_evicted);
+  Cache::Handle* handle =
+      cache->LookupWithHelper(key, &helper, &CreateCallback);
+  ASSERT_NE(nullptr, handle);
+  ASSERT_EQ(values[newest_evicted],
+            reinterpret_cast<TestItem*>(cache->Value(handle))->buf);
+  cache->Release(handle);
+  // It was promoted
+  handle = cache->Lookup(key);
+  ASSERT_NE(nullptr, handle);
+  cache->Release(handle);
+
+  // Erase reaches both tiers
+  key = "k" + ToString(newest_evicted - 1);
+  cache->Erase(key);
+  ASSERT_EQ(nullptr, cache->LookupWithHelper(key, &helper, &CreateCallback));
+
+  // Entries inserted without a helper are never saved
+  ASSERT_OK(cache->Insert("plain", new TestItem("x"), kCapacity,
+                          &DeletionCallback, &handle));
+  cache->Release(handle);
+  ASSERT_EQ(nullptr,
+            cache->LookupWithHelper("plain", &helper, &CreateCallback));
+}
+
+TEST_F(CompressedSecondaryCacheTest, EraseSkipsSecondaryUnlessSpilled) {
+  const size_t kEntrySize = 64 * 1024;
+  const size_t kCapacity = 4 << 20;
+  const size_t kSecondaryCapacity = 1 << 20;
+  auto secondary_cache = std::make_shared<EraseCountingSecondaryCache>(
+      NewCompressedSecondaryCache(CompressedSecondaryCacheOptions(
+          kSecondaryCapacity, 0 /* num_shard_bits */, kNoCompression)));
+  LRUCacheOptions opts(kCapacity, 0 /* num_shard_bits */,
+                       false /* strict_capacity_limit */,
+                       0.0 /* high_pri_pool_ratio */);
+  opts.secondary_cache = secondary_cache;
+  std::shared_ptr<Cache> cache = NewLRUCache(opts);
+
+  // Nothing was ever spilled
+  TestItem* item = new TestItem(RandomContents(&rnd_, kEntrySize));
+  ASSERT_OK(cache->InsertWithHelper("k0", item, &helper, kEntrySize));
+  cache->Erase("k0");
+  cache->Erase("missing");
+  ASSERT_EQ(0, secondary_cache->num_erases());
+
+  const int kNumEntries = static_cast<int>(2 * kCapacity / kEntrySize);
+  for (int i = 1; i <= kNumEntries; i++) {
+    ASSERT_OK(cache->InsertWithHelper(
+        "k" + ToString(i), new TestItem(RandomContents(&rnd_, kEntrySize)),
+        &helper, kEntrySize));
+  }
+  ASSERT_GT(secondary_cache->GetUsage(), 0);
+
+  // An entry of the primary cache was not spilled
+  std::string key = "k" + ToString(kNumEntries);
+  Cache::Handle* handle = cache->Lookup(key);
+  ASSERT_NE(nullptr, handle);
+  cache->Release(handle);
+  cache->Erase(key);
+  ASSERT_EQ(0, secondary_cache->num_erases());
+
+  // An evicted one may have been
+  int evicted = kNumEntries - 1;
+  for (; evicted > 0; evicted--) {
+    handle = cache->Lookup("k" + ToString(evicted));
+    if (handle == nullptr) {
+      break;
+    }
+    cache->Release(handle);
+  }
+  ASSERT_GT(evicted, 0);
+  key = "k" + ToString(evicted);
+  cache->Erase(key);
+  ASSERT_EQ(1, secondary_cache->num_erases());
+  ASSERT_EQ(nullptr, cache->LookupWithHelper(key, &helper, &CreateCallback));
+}
+
+TEST_F(CompressedSecondaryCacheTest, StrictCapacityLimit) {
+  const size_t kCapacity = 1 << 20;
+  std::shared_ptr<SecondaryCache> secondary_cache =
+      NewCompressedSecondaryCache(CompressedSecondaryCacheOptions(
+          kCapacity, 0 /* num_shard_bits */, kNoCompression));
+  LRUCacheOptions opts(kCapacity, 0 /* num_shard_bits */,
+                       true /* strict_capacity_limit */,
+                       0.0 /* high_pri_pool_ratio */);
+  opts.secondary_cache = secondary_cache;
+  std::shared_ptr<Cache> cache = NewLRUCache(opts);
+
+  TestItem* item = new TestItem(RandomContents(&rnd_, 1000));
+  ASSERT_OK(cache->InsertWithHelper("k1", item, &helper, 1000));
+  // Pin the whole capacity; spilling k1 cannot be charged for now
+  Cache::Handle* pinned = nullptr;
+  ASSERT_OK(cache->InsertWithHelper("k2", new TestItem("x"), &helper,
+                                    kCapacity, &pinned));
+  // k1 cannot be promoted while the cache is full, and is dropped
+  ASSERT_EQ(nullptr, cache->LookupWithHelper("k1", &helper, &CreateCallback));
+  ASSERT_EQ(0, secondary_cache->GetUsage());
+  cache->Release(pinned);
+}
+
+}  // namespace rocksdb
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,503 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "cache/lock_free_clock_cache.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+
+namespace rocksdb {
+
+namespace {
+
+// Target fraction of slots in use when the cache is at capacity and
+// entries have the estimated charge
+const double kLoadFactor = 0.7;
+// Fraction of slots in use above which Insert evicts regardless of usage
+const double kStrictLoadFactor = 0.84;
+
+const int kMinLengthBits = 4;
+const int kMaxLengthBits = 30;
+
+// Number of slots the clock hand advances per atomic increment, to amortize
+// contention on the clock pointer
+const size_t kClockStepSize = 4;
+
+int CalcLengthBits(size_t capacity, size_t estimated_entry_charge) {
+  double num_slots =
+      static_cast<double>(capacity) / estimated_entry_charge / kLoadFactor;
+  int length_bits = kMinLengthBits;
+  while (length_bits < kMaxLengthBits &&
+         static_cast<double>(uint64_t{1} << length_bits) < num_slots) {
+    length_bits++;
+  }
+  return length_bits;
+}
+
+}  // namespace
+
+typedef LockFreeClockHandle Handle;
+
+LockFreeClockCacheShard::LockFreeClockCacheShard(
+    size_t capacity, size_t estimated_entry_charge,
+    bool strict_capacity_limit)
+    : length_bits_(CalcLengthBits(capacity, estimated_entry_charge)),
+      length_mask_((size_t{1} << length_bits_) - 1),
+      occupancy_limit_(static_cast<size_t>((size_t{1} << length_bits_) *
+                                           kStrictLoadFactor)),
+      array_(new Handle[size_t{1} << length_bits_]),
+      capacity_(capacity),
+      strict_capacity_limit_(strict_capacity_limit),
+      clock_pointer_(0),
+      occupancy_(0),
+      usage_(0) {}
+
+LockFreeClockCacheShard::~LockFreeClockCacheShard() {
+  // No concurrent operations are possible any more; outstanding handles
+  // are a usage error, as in LRUCache.
+  for (size_t i = 0; i <= length_mask_; i++) {
+    Handle* h = &array_[i];
+    if (h->meta.load(std::memory_order_relaxed) & Handle::kStateShareableBit) {
+      (*h->deleter)(h->key(), h->value);
+      delete[] h->key_data;
+    }
+  }
+}
+
+void LockFreeClockCacheShard::SetCapacity(size_t capacity) {
+  capacity_.store(capacity, std::memory_order_relaxed);
+  EvictFromClock(0);
+}
+
+void LockFreeClockCacheShard::SetStrictCapacityLimit(
+    bool strict_capacity_limit) {
+  strict_capacity_limit_.store(strict_capacity_limit,
+                               std::memory_order_relaxed);
+}
+
+Status LockFreeClockCacheShard::Insert(
+    const Slice& key, uint32_t hash, void* value, size_t charge,
+    void (*deleter)(const Slice& key, void* value), Cache::Handle** handle,
+    Cache::Priority priority) {
+  // Concurrent inserts of the same key can both leave a visible entry; a
+  // lookup returns either of them and the other one ages out.
+  EraseVisible(key, hash);
+
+  EvictFromClock(charge);
+
+  Handle* h = nullptr;
+  if (!strict_capacity_limit_.load(std::memory_order_relaxed) ||
+      usage_.load(std::memory_order_relaxed) + charge <=
+          capacity_.load(std::memory_order_relaxed)) {
+    h = ClaimSlot(hash);
+  }
+  if (h == nullptr) {
+    if (handle == nullptr) {
+      // Don't insert the entry but still return ok, as if the entry
+      // inserted into cache and get evicted immediately.
+      (*deleter)(key, value);
+      return Status::OK();
+    }
+    *handle = nullptr;
+    return Status::Incomplete("Insert failed due to clock cache being full.");
+  }
+
+  h->hash.store(hash, std::memory_order_relaxed);
+  h->value = value;
+  h->deleter = deleter;
+  h->key_data = new char[key.size()];
+  memcpy(h->key_data, key.data(), key.size());
+  h->key_length = key.size();
+  h->charge = charge;
+  usage_.fetch_add(charge, std::memory_order_relaxed);
+
+  uint64_t countdown =
+      priority == Cache::Priority::HIGH ? Handle::kMaxCountdown : 2;
+  uint64_t meta = Handle::kStateVisible |
+                  (countdown << Handle::kAcquireCounterShift) |
+                  (countdown << Handle::kReleaseCounterShift);
+  if (handle != nullptr) {
+    meta += Handle::kAcquireIncrement;
+    *handle = reinterpret_cast<Cache::Handle*>(h);
+  }
+  h->meta.store(meta, std::memory_order_release);
+  return Status::OK();
+}
+
+Cache::Handle* LockFreeClockCacheShard::Lookup(const Slice& key,
+                                               uint32_t hash) {
+  return reinterpret_cast<Cache::Handle*>(FindAndRef(key, hash));
+}
+
+bool LockFreeClockCacheShard::Ref(Cache::Handle* handle) {
+  Handle* h = reinterpret_cast<Handle*>(handle);
+  // Only valid on a handle that is already referenced, hence shareable
+  h->meta.fetch_add(Handle::kAcquireIncrement, std::memory_order_relaxed);
+  return true;
+}
+
+bool LockFreeClockCacheShard::Release(Cache::Handle* handle,
+                                      bool force_erase) {
+  if (handle == nullptr) {
+    return false;
+  }
+  Handle* h = reinterpret_cast<Handle*>(handle);
+  // Like LRUCache, drop the entry on its last release while over capacity
+  bool erase_if_last = force_erase || usage_.load(std::memory_order_relaxed) >
+                                          capacity_.load(
+                                              std::memory_order_relaxed);
+  return Unref(h, false /* undo */, erase_if_last);
+}
+
+void LockFreeClockCacheShard::Erase(const Slice& key, uint32_t hash) {
+  EraseVisible(key, hash);
+}
+
+size_t LockFreeClockCacheShard::GetUsage() const {
+  return usage_.load(std::memory_order_relaxed);
+}
+
+size_t LockFreeClockCacheShard::GetPinnedUsage() const {
+  auto* self = const_cast<LockFreeClockCacheShard*>(this);
+  size_t pinned_usage = 0;
+  for (size_t i = 0; i <= length_mask_; i++) {
+    Handle* h = &array_[i];
+    uint64_t meta = h->meta.load(std::memory_order_relaxed);
+    if ((meta & Handle::kStateShareableBit) == 0 ||
+        Handle::GetRefs(meta) == 0) {
+      continue;
+    }
+    // Take a reference so that the charge can be read safely
+    uint64_t old_meta = h->meta.fetch_add(Handle::kAcquireIncrement,
+                                          std::memory_order_acquire);
+    if (old_meta & Handle::kStateShareableBit) {
+      if (Handle::GetRefs(old_meta) > 0) {
+        pinned_usage += h->charge;
+      }
+      self->Unref(h, true /* undo */, false /* erase_if_last */);
+    }
+  }
+  return pinned_usage;
+}
+
+void LockFreeClockCacheShard::ApplyToAllCacheEntries(
+    void (*callback)(void*, size_t), bool /*thread_safe*/) {
+  for (size_t i = 0; i <= length_mask_; i++) {
+    Handle* h = &array_[i];
+    uint64_t meta = h->meta.load(std::memory_order_relaxed);
+    if ((meta & Handle::kStateVisible) != Handle::kStateVisible) {
+      continue;
+    }
+    uint64_t old_meta = h->meta.fetch_add(Handle::kAcquireIncrement,
+                                          std::memory_order_acquire);
+    if (old_meta & Handle::kStateShareableBit) {
+      if ((old_meta & Handle::kStateVisible) == Handle::kStateVisible) {
+        callback(h->value, h->charge);
+      }
+      Unref(h, true /* undo */, false /* erase_if_last */);
+    }
+  }
+}
+
+void LockFreeClockCacheShard::EraseUnRefEntries() {
+  for (size_t i = 0; i <= length_mask_; i++) {
+    Handle* h = &array_[i];
+    uint64_t meta = h->meta.load(std::memory_order_relaxed);
+    if ((meta & Handle::kStateShareableBit) && Handle::GetRefs(meta) == 0) {
+      TryFree(h, meta);
+    }
+  }
+}
+
+std::string LockFreeClockCacheShard::GetPrintableOptions() const {
+  const int kBufferSize = 200;
+  char buffer[kBufferSize];
+  snprintf(buffer, kBufferSize, "    table_size: %" ROCKSDB_PRIszt "\n",
+           GetTableSize());
+  return std::string(buffer);
+}
+
+Handle* LockFreeClockCacheShard::FindAndRef(const Slice& key,
+                                            uint32_t hash) {
+  size_t index = ProbeBase(hash);
+  const size_t increment = ProbeIncrement(hash);
+  for (size_t probes = 0; probes <= length_mask_; probes++) {
+    Handle* h = &array_[index];
+    uint64_t meta = h->meta.load(std::memory_order_relaxed);
+    if ((meta & Handle::kStateVisible) == Handle::kStateVisible &&
+        h->hash.load(std::memory_order_relaxed) == hash) {
+      // Optimistically take a reference, which prevents the entry from
+      // being freed, then check that it is still the entry for key
+      uint64_t old_meta = h->meta.fetch_add(Handle::kAcquireIncrement,
+                                            std::memory_order_acquire);
+      if ((old_meta & Handle::kStateVisible) == Handle::kStateVisible &&
+          h->hash.load(std::memory_order_relaxed) == hash &&
+          h->key() == key) {
+        return h;
+      }
+      if (old_meta & Handle::kStateShareableBit) {
+        Unref(h, true /* undo */, false /* erase_if_last */);
+      }
+      // Otherwise the slot was being (re)constructed or freed, which
+      // overwrites the meta word including our increment.
+    }
+    if (h->displacements.load(std::memory_order_relaxed) == 0) {
+      break;
+    }
+    index = (index + increment) & length_mask_;
+  }
+  return nullptr;
+}
+
+Handle* LockFreeClockCacheShard::ClaimSlot(uint32_t hash) {
+  const size_t base = ProbeBase(hash);
+  const size_t increment = ProbeIncrement(hash);
+  size_t index = base;
+  size_t probes = 0;
+  for (; probes <= length_mask_; probes++) {
+    Handle* h = &array_[index];
+    uint64_t meta = h->meta.load(std::memory_order_relaxed);
+    if ((meta & Handle::kStateOccupiedBit) == 0) {
+      uint64_t old_meta = h->meta.fetch_or(Handle::kStateOccupiedBit,
+                                           std::memory_order_acq_rel);
+      if ((old_meta & Handle::kStateOccupiedBit) == 0) {
+        occupancy_.fetch_add(1, std::memory_order_relaxed);
+        return h;
+      }
+    }
+    h->displacements.fetch_add(1, std::memory_order_relaxed);
+    index = (index + increment) & length_mask_;
+  }
+  // Table is full; roll back the displacements
+  index = base;
+  for (size_t i = 0; i < probes; i++) {
+    array_[index].displacements.fetch_sub(1, std::memory_order_relaxed);
+    index = (index + increment) & length_mask_;
+  }
+  return nullptr;
+}
+
+void LockFreeClockCacheShard::EraseVisible(const Slice& key, uint32_t hash) {
+  Handle* h;
+  while ((h = FindAndRef(key, hash)) != nullptr) {
+    h->meta.fetch_and(~Handle::kStateVisibleBit, std::memory_order_acq_rel);
+    Unref(h, true /* undo */, false /* erase_if_last */);
+  }
+}
+
+bool LockFreeClockCacheShard::Unref(Handle* h, bool undo,
+                                    bool erase_if_last) {
+  uint64_t old_meta;
+  uint64_t meta;
+  if (undo) {
+    old_meta = h->meta.fetch_sub(Handle::kAcquireIncrement,
+                                 std::memory_order_release);
+    meta = old_meta - Handle::kAcquireIncrement;
+  } else {
+    old_meta = h->meta.fetch_add(Handle::kReleaseIncrement,
+                                 std::memory_order_release);
+    meta = old_meta + Handle::kReleaseIncrement;
+  }
+  assert(meta & Handle::kStateShareableBit);
+  if (Handle::GetRefs(meta) == 0 &&
+      ((meta & Handle::kStateVisibleBit) == 0 || erase_if_last)) {
+    return TryFree(h, meta);
+  }
+  if (!undo) {
+    CorrectNearOverflow(old_meta, h);
+  }
+  return false;
+}
+
+bool LockFreeClockCacheShard::TryFree(Handle* h, uint64_t expected_meta) {
+  assert(expected_meta & Handle::kStateShareableBit);
+  assert(Handle::GetRefs(expected_meta) == 0);
+  if (h->meta.compare_exchange_strong(expected_meta,
+                                      Handle::kStateConstruction,
+                                      std::memory_order_acquire)) {
+    FreeSlot(h);
+    return true;
+  }
+  // Someone else took a reference or is freeing the entry
+  return false;
+}
+
+void LockFreeClockCacheShard::FreeSlot(Handle* h) {
+  const Slice key = h->key();
+  void* value = h->value;
+  auto deleter = h->deleter;
+  size_t charge = h->charge;
+  uint32_t hash = h->hash.load(std::memory_order_relaxed);
+
+  size_t index = ProbeBase(hash);
+  const size_t increment = ProbeIncrement(hash);
+  for (Handle* p = &array_[index]; p != h; p = &array_[index]) {
+    p->displacements.fetch_sub(1, std::memory_order_relaxed);
+    index = (index + increment) & length_mask_;
+  }
+  h->key_data = nullptr;
+  h->meta.store(Handle::kStateEmpty, std::memory_order_release);
+  occupancy_.fetch_sub(1, std::memory_order_relaxed);
+  usage_.fetch_sub(charge, std::memory_order_relaxed);
+
+  // The slot can be reused from here on; the deleter may even call back
+  // into the cache.
+  (*deleter)(key, value);
+  delete[] key.data();
+}
+
+void LockFreeClockCacheShard::EvictFromClock(size_t charge) {
+  auto needs_eviction = [&]() {
+    return usage_.load(std::memory_order_relaxed) + charge >
+               capacity_.load(std::memory_order_relaxed) ||
+           occupancy_.load(std::memory_order_relaxed) >= occupancy_limit_;
+  };
+  if (!needs_eviction()) {
+    return;
+  }
+  // Stop after every entry had a chance to count down to zero
+  const uint64_t max_clock_pointer =
+      clock_pointer_.load(std::memory_order_relaxed) +
+      (Handle::kMaxCountdown + 1) * GetTableSize();
+  for (;;) {
+    uint64_t old_clock_pointer =
+        clock_pointer_.fetch_add(kClockStepSize, std::memory_order_relaxed);
+    for (size_t i = 0; i < kClockStepSize; i++) {
+      Handle* h = &array_[(old_clock_pointer + i) & length_mask_];
+      uint64_t meta = h->meta.load(std::memory_order_relaxed);
+      if ((meta & Handle::kStateShareableBit) == 0 ||
+          Handle::GetRefs(meta) != 0) {
+        // Empty, under construction, or pinned
+        continue;
+      }
+      uint64_t countdown =
+          (meta >> Handle::kAcquireCounterShift) & Handle::kCounterMask;
+      if ((meta & Handle::kStateVisibleBit) && countdown > 0) {
+        if (countdown > Handle::kMaxCountdown) {
+          countdown = Handle::kMaxCountdown;
+        }
+        countdown--;
+        uint64_t new_meta = (meta & Handle::kStateVisible) |
+                            (countdown << Handle::kAcquireCounterShift) |
+                            (countdown << Handle::kReleaseCounterShift);
+        // Lost races just leave the entry alone for this round
+        h->meta.compare_exchange_strong(meta, new_meta,
+                                        std::memory_order_relaxed);
+      } else {
+        TryFree(h, meta);
+      }
+    }
+    if (!needs_eviction() || old_clock_pointer >= max_clock_pointer) {
+      return;
+    }
+  }
+}
+
+void LockFreeClockCacheShard::CorrectNearOverflow(uint64_t old_meta,
+                                                  Handle* h) {
+  // A release counter at the top bit implies an acquire counter at the
+  // top bit too, since there are fewer than 2^29 references; clearing
+  // both keeps the reference count and keeps the counters from wrapping.
+  if (old_meta &
+      (Handle::kCounterTopBit << Handle::kReleaseCounterShift)) {
+    h->meta.fetch_and(
+        ~((Handle::kCounterTopBit << Handle::kAcquireCounterShift) |
+          (Handle::kCounterTopBit << Handle::kReleaseCounterShift)),
+        std::memory_order_relaxed);
+  }
+}
+
+LockFreeClockCache::LockFreeClockCache(
+    size_t capacity, size_t estimated_entry_charge, int num_shard_bits,
+    bool strict_capacity_limit,
+    std::shared_ptr<MemoryAllocator> memory_allocator)
+    : ShardedCache(capacity, num_shard_bits, strict_capacity_limit,
+                   std::move(memory_allocator)) {
+  num_shards_ = 1 << num_shard_bits;
+  shards_ = reinterpret_cast<LockFreeClockCacheShard*>(
+      port::cacheline_aligned_alloc(sizeof(LockFreeClockCacheShard) *
+                                    num_shards_));
+  size_t per_shard = (capacity + (num_shards_ - 1)) / num_shards_;
+  for (int i = 0; i < num_shards_; i++) {
+    new (&shards_[i]) LockFreeClockCacheShard(
+        per_shard, estimated_entry_charge, strict_capacity_limit);
+  }
+}
+
+LockFreeClockCache::~LockFreeClockCache() {
+  if (shards_ != nullptr) {
+    assert(num_shards_ > 0);
+    for (int i = 0; i < num_shards_; i++) {
+      shards_[i].~LockFreeClockCacheShard();
+    }
+    port::cacheline_aligned_free(shards_);
+  }
+}
+
+CacheShard* LockFreeClockCache::GetShard(int shard) {
+  return reinterpret_cast<CacheShard*>(&shards_[shard]);
+}
+
+const CacheShard* LockFreeClockCache::GetShard(int shard) const {
+  return reinterpret_cast<CacheShard*>(&shards_[shard]);
+}
+
+void* LockFreeClockCache::Value(Handle* handle) {
+  return reinterpret_cast<const LockFreeClockHandle*>(handle)->value;
+}
+
+size_t LockFreeClockCache::GetCharge(Handle* handle) const {
+  return reinterpret_cast<const LockFreeClockHandle*>(handle)->charge;
+}
+
+uint32_t LockFreeClockCache::GetHash(Handle* handle) const {
+  return reinterpret_cast<const LockFreeClockHandle*>(handle)->hash.load(
+      std::memory_order_relaxed);
+}
+
+void LockFreeClockCache::DisownData() {
+// Do not drop data if compile with ASAN to suppress leak warning.
+#if defined(__clang__)
+#if !defined(__has_feature) || !__has_feature(address_sanitizer)
+  shards_ = nullptr;
+  num_shards_ = 0;
+#endif
+#else  // __clang__
+#ifndef __SANITIZE_ADDRESS__
+  shards_ = nullptr;
+  num_shards_ = 0;
+#endif  // !__SANITIZE_ADDRESS__
+#endif  // __clang__
+}
+
+size_t LockFreeClockCache::TEST_GetTableSize() const {
+  size_t table_size = 0;
+  for (int i = 0; i < num_shards_; i++) {
+    table_size += shards_[i].GetTableSize();
+  }
+  return table_size;
+}
+
+std::shared_ptr<Cache> NewLockFreeClockCache(
+    size_t capacity, size_t estimated_entry_charge, int num_shard_bits,
+    bool strict_capacity_limit,
+    std::shared_ptr<MemoryAllocator> memory_allocator) {
+  if (num_shard_bits >= 20) {
+    return nullptr;  // the cache cannot be sharded into too many fine pieces
+  }
+  if (estimated_entry_charge == 0) {
+    return nullptr;
+  }
+  if (num_shard_bits < 0) {
+    num_shard_bits = GetDefaultCacheShardBits(capacity);
+  }
+  return std::make_shared<LockFreeClockCache>(
+      capacity, estimated_entry_charge, num_shard_bits,
+      strict_capacity_limit, std::move(memory_allocator));
+}
+
+}  // namespace rocksdb
@@ -0,0 +1,230 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+#include "cache/sharded_cache.h"
+#include "port/port.h"
+#include "rocksdb/cache.h"
+
+namespace rocksdb {
+
+// A cache shard with no mutex at all: entries live in a fixed-size open
+// addressing table, and every operation on an entry is a handful of atomic
+// operations on a single 64-bit word of the slot (its "meta" word).
+//
+// Meta word layout:
+//   bits [0, 30)   acquire counter
+//   bits [30, 60)  release counter
+//   bits [61, 64)  state: occupied, shareable and visible bits
+//
+// The number of references to an entry is acquire - release (mod 2^30).
+// Lookup optimistically increments the acquire counter of a slot before
+// checking the key, and undoes the increment on a mismatch. Release
+// increments the release counter, so readers never write a shared list.
+//
+// States:
+//   Empty          000  slot is free
+//   Construction   001  one thread has exclusive ownership of the slot
+//                       (initializing or freeing the entry)
+//   Invisible      011  entry can still be referenced through existing
+//                       handles, but is not found by Lookup (erased or
+//                       replaced by another Insert)
+//   Visible        111  entry can be found and referenced
+//
+// Eviction is CLOCK: while there is no reference to an entry, the counters
+// double as its clock countdown (acquire == release == countdown). Insert
+// sets the countdown to 2 (LOW priority) or 3 (HIGH priority), each lookup
+// and release pair raises it back towards 3, and the clock hand decrements
+// it. Entries reaching zero are evicted.
+//
+// Keys that do not sit in their home slot bump a "displacements" count on
+// each slot they probed past, so that Lookup can stop at the first slot
+// with no displacements instead of probing the whole table.
+//
+// The table cannot grow, so it is sized up front from the capacity and an
+// estimate of the average charge per entry (see NewLockFreeClockCache()).
+struct LockFreeClockHandle {
+  std::atomic<uint64_t> meta{0};
+  std::atomic<uint32_t> displacements{0};
+  // Atomic only so that Lookup can skip other keys without taking a
+  // reference first; like the fields below, it is written only in the
+  // Construction state.
+  std::atomic<uint32_t> hash{0};
+  // The fields below are read-only while the entry is shareable.
+  void* value = nullptr;
+  void (*deleter)(const Slice&, void* value) = nullptr;
+  char* key_data = nullptr;
+  size_t key_length = 0;
+  size_t charge = 0;
+
+  Slice key() const { return Slice(key_data, key_length); }
+
+  static const int kCounterNumBits = 30;
+  static const uint64_t kCounterMask = (uint64_t{1} << kCounterNumBits) - 1;
+  static const int kAcquireCounterShift = 0;
+  static const uint64_t kAcquireIncrement = uint64_t{1}
+                                            << kAcquireCounterShift;
+  static const int kReleaseCounterShift = kCounterNumBits;
+  static const uint64_t kReleaseIncrement = uint64_t{1}
+                                            << kReleaseCounterShift;
+  // Counter values are kept below this bit, see CorrectNearOverflow()
+  static const uint64_t kCounterTopBit = uint64_t{1} << (kCounterNumBits - 1);
+
+  static const uint64_t kStateOccupiedBit = uint64_t{1} << 61;
+  static const uint64_t kStateShareableBit = uint64_t{1} << 62;
+  static const uint64_t kStateVisibleBit = uint64_t{1} << 63;
+
+  static const uint64_t kStateEmpty = 0;
+  static const uint64_t kStateConstruction = kStateOccupiedBit;
+  static const uint64_t kStateInvisible =
+      kStateOccupiedBit | kStateShareableBit;
+  static const uint64_t kStateVisible =
+      kStateOccupiedBit | kStateShareableBit | kStateVisibleBit;
+
+  static const uint64_t kMaxCountdown = 3;
+
+  static inline uint64_t GetRefs(uint64_t meta) {
+    return ((meta >> kAcquireCounterShift) -
+            (meta >> kReleaseCounterShift)) &
+           kCounterMask;
+  }
+};
+
+class ALIGN_AS(CACHE_LINE_SIZE) LockFreeClockCacheShard final
+    : public CacheShard {
+ public:
+  LockFreeClockCacheShard(size_t capacity, size_t estimated_entry_charge,
+                          bool strict_capacity_limit);
+  virtual ~LockFreeClockCacheShard() override;
+
+  virtual void SetCapacity(size_t capacity) override;
+  virtual void SetStrictCapacityLimit(bool strict_capacity_limit) override;
+
+  virtual Status Insert(const Slice& key, uint32_t hash, void* value,
+                        size_t charge,
+                        void (*deleter)(const Slice& key, void* value),
+                        Cache::Handle** handle,
+                        Cache::Priority priority) override;
+  virtual Cache::Handle* Lookup(const Slice& key, uint32_t hash) override;
+  virtual bool Ref(Cache::Handle* handle) override;
+  virtual bool Release(Cache::Handle* handle,
+                       bool force_erase = false) override;
+  virtual void Erase(const Slice& key, uint32_t hash) override;
+
+  virtual size_t GetUsage() const override;
+  virtual size_t GetPinnedUsage() const override;
+
+  virtual void ApplyToAllCacheEntries(void (*callback)(void*, size_t),
+                                      bool thread_safe) override;
+
+  virtual void EraseUnRefEntries() override;
+
+  virtual std::string GetPrintableOptions() const override;
+
+  size_t GetTableSize() const { return size_t{1} << length_bits_; }
+  size_t GetOccupancy() const {
+    return occupancy_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  typedef LockFreeClockHandle Handle;
+
+  // Probe sequence of a hash: double hashing with an odd increment, so
+  // that every slot is visited in GetTableSize() steps.
+  inline size_t ProbeBase(uint32_t hash) const {
+    return static_cast<size_t>(hash) & length_mask_;
+  }
+  inline size_t ProbeIncrement(uint32_t hash) const {
+    return (static_cast<size_t>(hash * 0x9e3779b9U) >> (32 - length_bits_)) |
+           1;
+  }
+
+  // Finds a visible entry for key and takes a reference to it
+  Handle* FindAndRef(const Slice& key, uint32_t hash);
+
+  // Claims an empty slot along the probe sequence of hash, in
+  // Construction state. Returns nullptr if all slots are occupied.
+  Handle* ClaimSlot(uint32_t hash);
+
+  // Makes any visible entry for key invisible, freeing it if unreferenced
+  void EraseVisible(const Slice& key, uint32_t hash);
+
+  // Drops one reference taken through the acquire counter (undo == true)
+  // or a handle (undo == false), freeing the entry if it was the last
+  // reference to an invisible entry or erase_if_last is set.
+  bool Unref(Handle* h, bool undo, bool erase_if_last);
+
+  // Attempts to take exclusive ownership of an unreferenced, shareable
+  // entry whose meta word was last seen as expected_meta, and frees it.
+  bool TryFree(Handle* h, uint64_t expected_meta);
+
+  // Frees the entry of a slot in Construction state, and returns the slot
+  // to the Empty state.
+  void FreeSlot(Handle* h);
+
+  // Runs the clock hand until an entry of the given charge fits within
+  // capacity and the occupancy limit, or every entry was visited
+  // kMaxCountdown + 1 times.
+  void EvictFromClock(size_t charge);
+
+  void CorrectNearOverflow(uint64_t old_meta, Handle* h);
+
+  const int length_bits_;
+  const size_t length_mask_;
+  // Insert evicts entries before the table gets fuller than this, which
+  // keeps probe sequences short.
+  const size_t occupancy_limit_;
+  std::unique_ptr<Handle[]> array_;
+
+  std::atomic<size_t> capacity_;
+  std::atomic<bool> strict_capacity_limit_;
+
+  // ------------^^^^^^^^^^^^^-----------
+  // Not frequently modified data members
+  // ------------------------------------
+  //
+  // Keep the frequently modified counters on their own cache line
+  //
+  // ------------------------------------
+  // Frequently modified data members
+  // ------------vvvvvvvvvvvvv-----------
+  ALIGN_AS(CACHE_LINE_SIZE) std::atomic<uint64_t> clock_pointer_;
+  std::atomic<size_t> occupancy_;
+  std::atomic<size_t> usage_;
+};
+
+class LockFreeClockCache
+#ifdef NDEBUG
+    final
+#endif
+    : public ShardedCache {
+ public:
+  LockFreeClockCache(size_t capacity, size_t estimated_entry_charge,
+                     int num_shard_bits, bool strict_capacity_limit,
+                     std::shared_ptr<MemoryAllocator> memory_allocator =
+                         nullptr);
+  virtual ~LockFreeClockCache();
+  virtual const char* Name() const override { return "LockFreeClockCache"; }
+  virtual CacheShard* GetShard(int shard) override;
+  virtual const CacheShard* GetShard(int shard) const override;
+  virtual void* Value(Handle* handle) override;
+  virtual size_t GetCharge(Handle* handle) const override;
+  virtual uint32_t GetHash(Handle* handle) const override;
+  virtual void DisownData() override;
+
+  // Number of slots across all shards, for tests
+  size_t TEST_GetTableSize() const;
+
+ private:
+  LockFreeClockCacheShard* shards_ = nullptr;
+  int num_shards_ = 0;
+};
+
+}  // namespace rocksdb
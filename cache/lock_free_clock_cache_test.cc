@@ -0,0 +1,224 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "cache/lock_free_clock_cache.h"
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include "port/port.h"
+#include "test_util/testharness.h"
+#include "util/coding.h"
+#include "util/random.h"
+
+namespace rocksdb {
+
+namespace {
+std::atomic<int> num_deleted;
+
+void CountingDeleter(const Slice& key, void* value) {
+  // Values are the key, so that a mixup of entries is detected
+  ASSERT_EQ(DecodeFixed32(key.data()),
+            static_cast<uint32_t>(reinterpret_cast<uintptr_t>(value)));
+  num_deleted.fetch_add(1);
+}
+
+std::string EncodeKey(uint32_t k) {
+  std::string result;
+  PutFixed32(&result, k);
+  return result;
+}
+
+void* EncodeValue(uint32_t k) {
+  return reinterpret_cast<void*>(static_cast<uintptr_t>(k));
+}
+}  // namespace
+
+class LockFreeClockCacheTest : public testing::Test {
+ public:
+  LockFreeClockCacheTest() { num_deleted = 0; }
+  ~LockFreeClockCacheTest() override { DeleteShard(); }
+
+  void DeleteShard() {
+    if (shard_ != nullptr) {
+      shard_->~LockFreeClockCacheShard();
+      port::cacheline_aligned_free(shard_);
+      shard_ = nullptr;
+    }
+  }
+
+  void NewShard(size_t capacity, size_t estimated_entry_charge,
+                bool strict_capacity_limit = false) {
+    DeleteShard();
+    shard_ = reinterpret_cast<LockFreeClockCacheShard*>(
+        port::cacheline_aligned_alloc(sizeof(LockFreeClockCacheShard)));
+    new (shard_) LockFreeClockCacheShard(capacity, estimated_entry_charge,
+                                         strict_capacity_limit);
+  }
+
+  Status Insert(uint32_t k, Cache::Handle** handle = nullptr,
+                Cache::Priority priority = Cache::Priority::LOW) {
+    return shard_->Insert(EncodeKey(k), k /* hash */, EncodeValue(k),
+                          1 /* charge */, &CountingDeleter, handle, priority);
+  }
+
+  Cache::Handle* Lookup(uint32_t k) {
+    return shard_->Lookup(EncodeKey(k), k /* hash */);
+  }
+
+  LockFreeClockCacheShard* shard_ = nullptr;
+};
+
+TEST_F(LockFreeClockCacheTest, TableSize) {
+  NewShard(1000, 10);
+  // 100 entries at 0.7 load factor
+  ASSERT_EQ(256, shard_->GetTableSize());
+  NewShard(1, 10);
+  ASSERT_EQ(16, shard_->GetTableSize());
+}
+
+TEST_F(LockFreeClockCacheTest, TableFull) {
+  // Capacity is not the limit, slots are
+  NewShard(1000, 1000);
+  const uint32_t kTableSize = static_cast<uint32_t>(shard_->GetTableSize());
+  std::vector<Cache::Handle*> handles;
+  for (uint32_t k = 0; k < kTableSize; k++) {
+    Cache::Handle* handle = nullptr;
+    ASSERT_OK(Insert(k, &handle));
+    handles.push_back(handle);
+  }
+  ASSERT_EQ(kTableSize, shard_->GetOccupancy());
+
+  // Every slot is pinned
+  Cache::Handle* handle = nullptr;
+  ASSERT_TRUE(Insert(kTableSize, &handle).IsIncomplete());
+  ASSERT_EQ(nullptr, handle);
+  ASSERT_EQ(0, num_deleted.load());
+  // Without a handle, the entry is dropped as if evicted right away
+  ASSERT_OK(Insert(kTableSize));
+  ASSERT_EQ(1, num_deleted.load());
+  ASSERT_EQ(nullptr, Lookup(kTableSize));
+
+  // Every key is still found, even though most of them are displaced
+  for (uint32_t k = 0; k < kTableSize; k++) {
+    Cache::Handle* h = Lookup(k);
+    ASSERT_EQ(handles[k], h);
+    shard_->Release(h);
+    shard_->Release(handles[k]);
+  }
+  // Now there is room again, mostly by evicting at the occupancy limit
+  ASSERT_OK(Insert(kTableSize));
+  ASSERT_LT(shard_->GetOccupancy(), kTableSize);
+  shard_->EraseUnRefEntries();
+  ASSERT_EQ(0, shard_->GetOccupancy());
+  ASSERT_EQ(0, shard_->GetUsage());
+  ASSERT_EQ(kTableSize + 2, num_deleted.load());
+}
+
+TEST_F(LockFreeClockCacheTest, EraseReferenced) {
+  NewShard(10, 1);
+  Cache::Handle* handle = nullptr;
+  ASSERT_OK(Insert(1, &handle));
+  shard_->Erase(EncodeKey(1), 1 /* hash */);
+  ASSERT_EQ(nullptr, Lookup(1));
+  ASSERT_EQ(0, num_deleted.load());
+  ASSERT_EQ(1, shard_->GetPinnedUsage());
+
+  // A new entry for the same key does not disturb the erased one
+  ASSERT_OK(Insert(1));
+  Cache::Handle* h = Lookup(1);
+  ASSERT_NE(handle, h);
+  shard_->Release(h);
+  ASSERT_EQ(2, shard_->GetUsage());
+
+  ASSERT_TRUE(shard_->Release(handle));
+  ASSERT_EQ(1, num_deleted.load());
+  ASSERT_EQ(1, shard_->GetUsage());
+  ASSERT_EQ(0, shard_->GetPinnedUsage());
+}
+
+TEST_F(LockFreeClockCacheTest, Priority) {
+  NewShard(10, 1);
+  ASSERT_OK(Insert(1, nullptr, Cache::Priority::HIGH));
+  ASSERT_OK(Insert(2, nullptr, Cache::Priority::LOW));
+  // Fill to capacity with entries that were hit once
+  for (uint32_t k = 100; k < 108; k++) {
+    ASSERT_OK(Insert(k));
+    shard_->Release(Lookup(k));
+  }
+  ASSERT_EQ(10, shard_->GetUsage());
+
+  // The low priority entry that was never hit goes first
+  ASSERT_OK(Insert(108));
+  ASSERT_EQ(10, shard_->GetUsage());
+  ASSERT_EQ(nullptr, Lookup(2));
+  Cache::Handle* h = Lookup(1);
+  ASSERT_NE(nullptr, h);
+  shard_->Release(h);
+}
+
+TEST_F(LockFreeClockCacheTest, Concurrent) {
+  const int kNumThreads = 8;
+  const uint32_t kNumKeys = 1000;
+  const int kOpsPerThread = 100000;
+  // Entries get evicted, erased and replaced all the time
+  NewShard(kNumKeys / 4, 1);
+  std::atomic<int> num_inserted(0);
+
+  std::vector<port::Thread> threads;
+  for (int t = 0; t < kNumThreads; t++) {
+    threads.emplace_back([&, t]() {
+      Random rnd(301 + t);
+      for (int i = 0; i < kOpsPerThread; i++) {
+        uint32_t k = rnd.Uniform(kNumKeys);
+        switch (rnd.Uniform(4)) {
+          case 0: {
+            Cache::Handle* handle = nullptr;
+            Status s = Insert(k, rnd.OneIn(2) ? &handle : nullptr);
+            ASSERT_TRUE(s.ok() || s.IsIncomplete());
+            if (handle != nullptr) {
+              ASSERT_EQ(EncodeValue(k),
+                        reinterpret_cast<LockFreeClockHandle*>(handle)->value);
+              shard_->Release(handle);
+            }
+            if (s.ok()) {
+              num_inserted.fetch_add(1);
+            }
+            break;
+          }
+          case 1:
+            shard_->Erase(EncodeKey(k), k);
+            break;
+          default: {
+            Cache::Handle* handle = Lookup(k);
+            if (handle != nullptr) {
+              ASSERT_EQ(EncodeValue(k),
+                        reinterpret_cast<LockFreeClockHandle*>(handle)->value);
+              shard_->Release(handle, rnd.OneIn(10) /* force_erase */);
+            }
+            break;
+          }
+        }
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  // Eviction may have been held up by entries pinned at the time
+  shard_->SetCapacity(kNumKeys / 4);
+  ASSERT_LE(shard_->GetUsage(), kNumKeys / 4);
+  ASSERT_EQ(0, shard_->GetPinnedUsage());
+  ASSERT_EQ(shard_->GetUsage(), shard_->GetOccupancy());
+  DeleteShard();
+  ASSERT_EQ(num_inserted.load(), num_deleted.load());
+}
+
+}  // namespace rocksdb
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
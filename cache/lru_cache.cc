@@ -14,6 +14,7 @@
 #include <stdlib.h>
 #include <string>
 
+#include "util/coding.h"
 #include "util/mutexlock.h"
 
 namespace rocksdb {
@@ -95,16 +96,96 @@ void LRUHandleTable::Resize() {
   length_ = new_length;
 }
 
+FrequencySketch::FrequencySketch()
+    : index_shift_(0), sized_for_(0), sample_size_(0), additions_(0) {
+  EnsureCapacity(1);
+}
+
+void FrequencySketch::EnsureCapacity(size_t num_entries) {
+  if (table_.empty()) {
+    table_.assign(1, 0);
+    index_shift_ = 64 - 4;
+    sized_for_ = 1;
+  }
+  // A word of 16 counters per entry. Indexes are the upper bits of a hash,
+  // so doubling the table turns counter i into counters 2i and 2i+1.
+  while (sized_for_ < num_entries) {
+    std::vector<uint64_t> grown(table_.size() * 2, 0);
+    for (size_t i = 0; i < table_.size() * 16; i++) {
+      uint64_t count = (table_[i >> 4] >> ((i & 15) * 4)) & 0xf;
+      for (size_t j = 2 * i; j <= 2 * i + 1; j++) {
+        grown[j >> 4] |= count << ((j & 15) * 4);
+      }
+    }
+    table_.swap(grown);
+    index_shift_--;
+    sized_for_ *= 2;
+  }
+  sample_size_ = 10 * sized_for_;
+}
+
+uint32_t FrequencySketch::CounterIndex(uint32_t hash, int i) const {
+  // Double hashing on the upper bits of two multiplicative hashes. All bits
+  // of hash matter, including those that picked the shard.
+  uint64_t h1 = uint64_t{hash} * 0x9E3779B97F4A7C15ull;
+  uint64_t h2 = (uint64_t{hash} * 0xC2B2AE3D27D4EB4Full) | 1;
+  return static_cast<uint32_t>((h1 + static_cast<uint64_t>(i) * h2) >>
+                               index_shift_);
+}
+
+void FrequencySketch::Increment(uint32_t hash) {
+  bool added = false;
+  for (int i = 0; i < 4; i++) {
+    uint32_t index = CounterIndex(hash, i);
+    uint64_t& word = table_[index >> 4];
+    int offset = (index & 15) * 4;
+    if (((word >> offset) & 0xf) < 15) {
+      word += uint64_t{1} << offset;
+      added = true;
+    }
+  }
+  if (added && ++additions_ >= sample_size_) {
+    Age();
+  }
+}
+
+int FrequencySketch::Estimate(uint32_t hash) const {
+  int frequency = 15;
+  for (int i = 0; i < 4; i++) {
+    uint32_t index = CounterIndex(hash, i);
+    int count =
+        static_cast<int>((table_[index >> 4] >> ((index & 15) * 4)) & 0xf);
+    if (count < frequency) {
+      frequency = count;
+    }
+  }
+  return frequency;
+}
+
+void FrequencySketch::Age() {
+  for (auto& word : table_) {
+    word = (word >> 1) & 0x7777777777777777ull;
+  }
+  additions_ /= 2;
+}
+
 LRUCacheShard::LRUCacheShard(size_t capacity, bool strict_capacity_limit,
                              double high_pri_pool_ratio,
-                             bool use_adaptive_mutex)
-    : capacity_(0),
+                             bool use_adaptive_mutex, bool tiny_lfu_admission,
+                             std::shared_ptr<SecondaryCache> secondary_cache,
+                             LRUCache* parent)
+    : tiny_lfu_admission_(tiny_lfu_admission),
+      secondary_cache_(std::move(secondary_cache)),
+      parent_(parent),
+      capacity_(0),
       high_pri_pool_usage_(0),
       strict_capacity_limit_(strict_capacity_limit),
       high_pri_pool_ratio_(high_pri_pool_ratio),
       high_pri_pool_capacity_(0),
       usage_(0),
       lru_usage_(0),
+      num_admission_rejects_(0),
+      spilled_(false),
       mutex_(use_adaptive_mutex) {
   // Make empty circular linked list
   lru_.next = &lru_;
@@ -171,6 +252,16 @@ double LRUCacheShard::GetHighPriPoolRatio() {
   return high_pri_pool_ratio_;
 }
 
+uint64_t LRUCacheShard::GetNumAdmissionRejects() const {
+  MutexLock l(&mutex_);
+  return num_admission_rejects_;
+}
+
+int LRUCacheShard::TEST_EstimateFrequency(uint32_t hash) {
+  MutexLock l(&mutex_);
+  return sketch_.Estimate(hash);
+}
+
 void LRUCacheShard::LRU_Remove(LRUHandle* e) {
   assert(e->next != nullptr);
   assert(e->prev != nullptr);
@@ -236,6 +327,19 @@ void LRUCacheShard::EvictFromLRU(size_t charge,
   }
 }
 
+bool LRUCacheShard::Admit(const LRUHandle* e) {
+  if (e->IsHighPri()) {
+    // Index and filter blocks are admitted as before
+    return true;
+  }
+  const LRUHandle* victim = lru_.next;
+  if (victim == &lru_) {
+    // Nothing could be evicted anyway
+    return true;
+  }
+  return sketch_.Estimate(e->hash) > sketch_.Estimate(victim->hash);
+}
+
 void LRUCacheShard::SetCapacity(size_t capacity) {
   autovector<LRUHandle*> last_reference_list;
   {
@@ -246,9 +350,26 @@ void LRUCacheShard::SetCapacity(size_t capacity) {
   }
 
   // Free the entries outside of mutex for performance reasons
-  for (auto entry : last_reference_list) {
+  SpillAndFree(last_reference_list);
+}
+
+void LRUCacheShard::SpillAndFree(const autovector<LRUHandle*>& evicted) {
+  bool spilled = false;
+  for (auto entry : evicted) {
+    if (secondary_cache_ != nullptr && entry->IsSecondaryCacheCompatible()) {
+      // Not being kept by the secondary cache is no different from being
+      // evicted from it right away, so the status is of no interest.
+      secondary_cache_->Insert(entry->key(), entry->value, entry->helper);
+      spilled = true;
+    }
     entry->Free();
   }
+  if (spilled) {
+    spilled_.store(true, std::memory_order_relaxed);
+    if (parent_ != nullptr) {
+      parent_->UpdateSecondaryCacheReservation();
+    }
+  }
 }
 
 void LRUCacheShard::SetStrictCapacityLimit(bool strict_capacity_limit) {
@@ -258,6 +379,10 @@ void LRUCacheShard::SetStrictCapacityLimit(bool strict_capacity_limit) {
 
 Cache::Handle* LRUCacheShard::Lookup(const Slice& key, uint32_t hash) {
   MutexLock l(&mutex_);
+  if (tiny_lfu_admission_) {
+    // Misses count too: a block read again and again deserves a place
+    sketch_.Increment(hash);
+  }
   LRUHandle* e = table_.Lookup(key, hash);
   if (e != nullptr) {
     assert(e->InCache());
@@ -293,6 +418,7 @@ bool LRUCacheShard::Release(Cache::Handle* handle, bool force_erase) {
   }
   LRUHandle* e = reinterpret_cast<LRUHandle*>(handle);
   bool last_reference = false;
+  bool evicted = false;
   {
     MutexLock l(&mutex_);
     last_reference = e->Unref();
@@ -304,6 +430,7 @@ bool LRUCacheShard::Release(Cache::Handle* handle, bool force_erase) {
         // Take this opportunity and remove the item
         table_.Remove(e->key(), e->hash);
         e->SetInCache(false);
+        evicted = !force_erase;
       } else {
         // Put the item back on the LRU list, and don't free it
         LRU_Insert(e);
@@ -316,7 +443,9 @@ bool LRUCacheShard::Release(Cache::Handle* handle, bool force_erase) {
   }
 
   // Free the entry here outside of mutex for performance reasons
-  if (last_reference) {
+  if (evicted) {
+    SpillAndFree({e});
+  } else if (last_reference) {
     e->Free();
   }
   return last_reference;
@@ -331,8 +460,6 @@ Status LRUCacheShard::Insert(const Slice& key, uint32_t hash, void* value,
   // It shouldn't happen very often though.
   LRUHandle* e = reinterpret_cast<LRUHandle*>(
       new char[sizeof(LRUHandle) - 1 + key.size()]);
-  Status s = Status::OK();
-  autovector<LRUHandle*> last_reference_list;
 
   e->value = value;
   e->deleter = deleter;
@@ -346,15 +473,95 @@ Status LRUCacheShard::Insert(const Slice& key, uint32_t hash, void* value,
   e->SetPriority(priority);
   memcpy(e->key_data, key.data(), key.size());
 
+  return InsertItem(e, handle);
+}
+
+Status LRUCacheShard::InsertWithHelper(const Slice& key, uint32_t hash,
+                                       void* value,
+                                       const Cache::CacheItemHelper* helper,
+                                       size_t charge, Cache::Handle** handle,
+                                       Cache::Priority priority) {
+  LRUHandle* e = reinterpret_cast<LRUHandle*>(
+      new char[sizeof(LRUHandle) - 1 + key.size()]);
+
+  e->value = value;
+  e->helper = helper;
+  e->charge = charge;
+  e->key_length = key.size();
+  e->flags = 0;
+  e->hash = hash;
+  e->refs = 0;
+  e->next = e->prev = nullptr;
+  e->SetInCache(true);
+  e->SetPriority(priority);
+  e->SetSecondaryCacheCompatible(true);
+  memcpy(e->key_data, key.data(), key.size());
+
+  return InsertItem(e, handle);
+}
+
+Cache::Handle* LRUCacheShard::LookupWithHelper(
+    const Slice& key, uint32_t hash, const Cache::CacheItemHelper* helper,
+    const Cache::CreateCallback& create_cb, Cache::Priority priority) {
+  Cache::Handle* handle = Lookup(key, hash);
+  if (handle != nullptr || secondary_cache_ == nullptr || helper == nullptr) {
+    return handle;
+  }
+
+  void* value = nullptr;
+  size_t charge = 0;
+  Status s = secondary_cache_->Lookup(key, create_cb, &value, &charge);
+  if (!s.ok()) {
+    return nullptr;
+  }
+  // Promote the entry. It has left the secondary cache either way, so
+  // the reservation shrinks even if the primary cache has no room for it.
+  s = InsertWithHelper(key, hash, value, helper, charge, &handle, priority);
+  if (!s.ok()) {
+    assert(handle == nullptr);
+    (*helper->del_cb)(key, value);
+  }
+  if (parent_ != nullptr) {
+    parent_->UpdateSecondaryCacheReservation();
+  }
+  return handle;
+}
+
+Status LRUCacheShard::InsertItem(LRUHandle* e, Cache::Handle** handle) {
+  Status s = Status::OK();
+  autovector<LRUHandle*> evicted_list;
+  autovector<LRUHandle*> last_reference_list;
+  const size_t charge = e->charge;
+
   {
     MutexLock l(&mutex_);
 
+    // A caller under strict capacity limit that needs a handle gets the
+    // plain LRU behavior.
+    const bool admitted =
+        !tiny_lfu_admission_ || (usage_ + charge) <= capacity_ ||
+        (handle != nullptr && strict_capacity_limit_) || Admit(e);
+
     // Free the space following strict LRU policy until enough space
     // is freed or the lru list is empty
-    EvictFromLRU(charge, &last_reference_list);
+    if (admitted) {
+      EvictFromLRU(charge, &evicted_list);
+    }
 
-    if ((usage_ + charge) > capacity_ &&
-        (strict_capacity_limit_ || handle == nullptr)) {
+    if (!admitted) {
+      // Keep the cache as it is. A caller that needs a handle gets one to
+      // an entry outside of the cache, freed on its last Release().
+      num_admission_rejects_++;
+      e->SetInCache(false);
+      if (handle == nullptr) {
+        last_reference_list.push_back(e);
+      } else {
+        e->Ref();
+        usage_ += charge;
+        *handle = reinterpret_cast<Cache::Handle*>(e);
+      }
+    } else if ((usage_ + charge) > capacity_ &&
+               (strict_capacity_limit_ || handle == nullptr)) {
       if (handle == nullptr) {
         // Don't insert the entry but still return ok, as if the entry inserted
         // into cache and get evicted immediately.
@@ -386,10 +593,15 @@ Status LRUCacheShard::Insert(const Slice& key, uint32_t hash, void* value,
         e->Ref();
         *handle = reinterpret_cast<Cache::Handle*>(e);
       }
+      if (tiny_lfu_admission_) {
+        // The sketch follows the number of entries the capacity holds
+        sketch_.EnsureCapacity(table_.GetNumEntries());
+      }
     }
   }
 
   // Free the entries here outside of mutex for performance reasons
+  SpillAndFree(evicted_list);
   for (auto entry : last_reference_list) {
     entry->Free();
   }
@@ -420,6 +632,16 @@ void LRUCacheShard::Erase(const Slice& key, uint32_t hash) {
   if (last_reference) {
     e->Free();
   }
+  // A key still in this shard cannot be in the secondary cache as well,
+  // since promoting an entry takes it out of there, so only a key this
+  // shard may have spilled is worth looking for.
+  if (e == nullptr && secondary_cache_ != nullptr &&
+      spilled_.load(std::memory_order_relaxed)) {
+    secondary_cache_->Erase(key);
+    if (parent_ != nullptr) {
+      parent_->UpdateSecondaryCacheReservation();
+    }
+  }
 }
 
 size_t LRUCacheShard::GetUsage() const {
@@ -438,18 +660,30 @@ std::string LRUCacheShard::GetPrintableOptions() const {
   char buffer[kBufferSize];
   {
     MutexLock l(&mutex_);
-    snprintf(buffer, kBufferSize, "    high_pri_pool_ratio: %.3lf\n",
-             high_pri_pool_ratio_);
+    snprintf(buffer, kBufferSize,
+             "    high_pri_pool_ratio: %.3lf\n"
+             "    tiny_lfu_admission: %d\n",
+             high_pri_pool_ratio_, tiny_lfu_admission_);
   }
-  return std::string(buffer);
+  std::string ret(buffer);
+  if (secondary_cache_ != nullptr) {
+    ret.append("    secondary_cache:\n");
+    ret.append(secondary_cache_->GetPrintableOptions());
+  }
+  return ret;
 }
 
 LRUCache::LRUCache(size_t capacity, int num_shard_bits,
                    bool strict_capacity_limit, double high_pri_pool_ratio,
                    std::shared_ptr<MemoryAllocator> allocator,
-                   bool use_adaptive_mutex)
+                   bool use_adaptive_mutex,
+                   std::shared_ptr<SecondaryCache> secondary_cache,
+                   bool tiny_lfu_admission)
     : ShardedCache(capacity, num_shard_bits, strict_capacity_limit,
-                   std::move(allocator)) {
+                   std::move(allocator)),
+      secondary_cache_(std::move(secondary_cache)),
+      reservation_in_progress_(false),
+      secondary_cache_reservation_(0) {
   num_shards_ = 1 << num_shard_bits;
   shards_ = reinterpret_cast<LRUCacheShard*>(
       port::cacheline_aligned_alloc(sizeof(LRUCacheShard) * num_shards_));
@@ -457,12 +691,17 @@ LRUCache::LRUCache(size_t capacity, int num_shard_bits,
   for (int i = 0; i < num_shards_; i++) {
     new (&shards_[i])
         LRUCacheShard(per_shard, strict_capacity_limit, high_pri_pool_ratio,
-            use_adaptive_mutex);
+                      use_adaptive_mutex, tiny_lfu_admission,
+                      secondary_cache_, this);
   }
 }
 
 LRUCache::~LRUCache() {
   if (shards_ != nullptr) {
+    // The reservation entries are pinned and would otherwise never be freed
+    for (auto handle : reservation_handles_) {
+      Release(handle, true /* force_erase */);
+    }
     assert(num_shards_ > 0);
     for (int i = 0; i < num_shards_; i++) {
       shards_[i].~LRUCacheShard();
@@ -522,33 +761,106 @@ double LRUCache::GetHighPriPoolRatio() {
   return result;
 }
 
-std::shared_ptr<Cache> NewLRUCache(const LRUCacheOptions& cache_opts) {
-  return NewLRUCache(cache_opts.capacity, cache_opts.num_shard_bits,
-                     cache_opts.strict_capacity_limit,
-                     cache_opts.high_pri_pool_ratio,
-                     cache_opts.memory_allocator,
-                     cache_opts.use_adaptive_mutex);
+uint64_t LRUCache::GetNumAdmissionRejects() const {
+  uint64_t result = 0;
+  for (int i = 0; i < num_shards_; i++) {
+    result += shards_[i].GetNumAdmissionRejects();
+  }
+  return result;
 }
 
-std::shared_ptr<Cache> NewLRUCache(
-    size_t capacity, int num_shard_bits, bool strict_capacity_limit,
-    double high_pri_pool_ratio,
-    std::shared_ptr<MemoryAllocator> memory_allocator,
-    bool use_adaptive_mutex) {
-  if (num_shard_bits >= 20) {
+void LRUCache::UpdateSecondaryCacheReservation() {
+  if (secondary_cache_ == nullptr) {
+    return;
+  }
+  // Same granularity as the dummy entries of WriteBufferManager
+  const size_t kSizeReservationEntry = 256 * 1024;
+  // The prefix keeps the keys apart from those of other users of the cache,
+  // like the cache key prefixes of tables.
+  const size_t kReservationKeyPrefixSize = kMaxVarint64Length * 4 + 1;
+  char key_buf[kReservationKeyPrefixSize + kMaxVarint64Length];
+  memset(key_buf, 0, kReservationKeyPrefixSize);
+  EncodeVarint64(key_buf, reinterpret_cast<uint64_t>(this));
+
+  while (true) {
+    bool expected = false;
+    if (!reservation_in_progress_.compare_exchange_strong(
+            expected, true, std::memory_order_acquire)) {
+      // Another thread, possibly this one further up the stack while its
+      // own dummy entries evict and spill, is adjusting it already.
+      return;
+    }
+    size_t target = secondary_cache_->GetUsage();
+    size_t reserved = reservation_handles_.size() * kSizeReservationEntry;
+    bool cache_full = false;
+    while (reserved < target) {
+      char* end = EncodeVarint64(key_buf + kReservationKeyPrefixSize,
+                                 next_reservation_key_id_++);
+      Slice key(key_buf, static_cast<size_t>(end - key_buf));
+      Handle* handle = nullptr;
+      Status s = Insert(key, nullptr, kSizeReservationEntry, nullptr, &handle,
+                        Cache::Priority::LOW);
+      if (!s.ok()) {
+        // Strict capacity limit with everything pinned
+        cache_full = true;
+        break;
+      }
+      reservation_handles_.push_back(handle);
+      reserved += kSizeReservationEntry;
+      // Evictions caused by the insert may have grown the secondary cache
+      target = secondary_cache_->GetUsage();
+    }
+    while (reserved >= target + kSizeReservationEntry &&
+           !reservation_handles_.empty()) {
+      Release(reservation_handles_.back(), true /* force_erase */);
+      reservation_handles_.pop_back();
+      reserved -= kSizeReservationEntry;
+    }
+    secondary_cache_reservation_.store(reserved, std::memory_order_relaxed);
+    reservation_in_progress_.store(false, std::memory_order_release);
+
+    if (cache_full) {
+      // Retried on the next change of the secondary cache
+      return;
+    }
+    // Catch up with a change made while this thread held the flag
+    target = secondary_cache_->GetUsage();
+    if (reserved >= target &&
+        (reserved < target + kSizeReservationEntry || reserved == 0)) {
+      return;
+    }
+  }
+}
+
+std::shared_ptr<Cache> NewLRUCache(const LRUCacheOptions& cache_opts) {
+  if (cache_opts.num_shard_bits >= 20) {
     return nullptr;  // the cache cannot be sharded into too many fine pieces
   }
-  if (high_pri_pool_ratio < 0.0 || high_pri_pool_ratio > 1.0) {
+  if (cache_opts.high_pri_pool_ratio < 0.0 ||
+      cache_opts.high_pri_pool_ratio > 1.0) {
     // invalid high_pri_pool_ratio
     return nullptr;
   }
+  int num_shard_bits = cache_opts.num_shard_bits;
   if (num_shard_bits < 0) {
-    num_shard_bits = GetDefaultCacheShardBits(capacity);
+    num_shard_bits = GetDefaultCacheShardBits(cache_opts.capacity);
   }
-  return std::make_shared<LRUCache>(capacity, num_shard_bits,
-                                    strict_capacity_limit, high_pri_pool_ratio,
-                                    std::move(memory_allocator),
-                                    use_adaptive_mutex);
+  return std::make_shared<LRUCache>(
+      cache_opts.capacity, num_shard_bits, cache_opts.strict_capacity_limit,
+      cache_opts.high_pri_pool_ratio, cache_opts.memory_allocator,
+      cache_opts.use_adaptive_mutex, cache_opts.secondary_cache,
+      cache_opts.tiny_lfu_admission);
+}
+
+std::shared_ptr<Cache> NewLRUCache(
+    size_t capacity, int num_shard_bits, bool strict_capacity_limit,
+    double high_pri_pool_ratio,
+    std::shared_ptr<MemoryAllocator> memory_allocator,
+    bool use_adaptive_mutex) {
+  return NewLRUCache(LRUCacheOptions(capacity, num_shard_bits,
+                                     strict_capacity_limit, high_pri_pool_ratio,
+                                     std::move(memory_allocator),
+                                     use_adaptive_mutex));
 }
 
 }  // namespace rocksdb
@@ -8,11 +8,14 @@
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 #pragma once
 
+#include <atomic>
 #include <string>
+#include <vector>
 
 #include "cache/sharded_cache.h"
 
 #include "port/port.h"
+#include "rocksdb/secondary_cache.h"
 #include "util/autovector.h"
 
 namespace rocksdb {
@@ -48,7 +51,11 @@ namespace rocksdb {
 
 struct LRUHandle {
   void* value;
-  void (*deleter)(const Slice&, void* value);
+  union {
+    void (*deleter)(const Slice&, void* value);
+    // For entries inserted with a helper (IS_SECONDARY_CACHE_COMPATIBLE)
+    const Cache::CacheItemHelper* helper;
+  };
   LRUHandle* next_hash;
   LRUHandle* next;
   LRUHandle* prev;
@@ -68,6 +75,8 @@ struct LRUHandle {
     IN_HIGH_PRI_POOL = (1 << 2),
     // Wwhether this entry has had any lookups (hits).
     HAS_HIT = (1 << 3),
+    // Whether this entry can be saved to a secondary cache, through helper.
+    IS_SECONDARY_CACHE_COMPATIBLE = (1 << 4),
   };
 
   uint8_t flags;
@@ -94,6 +103,9 @@ struct LRUHandle {
   bool IsHighPri() const { return flags & IS_HIGH_PRI; }
   bool InHighPriPool() const { return flags & IN_HIGH_PRI_POOL; }
   bool HasHit() const { return flags & HAS_HIT; }
+  bool IsSecondaryCacheCompatible() const {
+    return flags & IS_SECONDARY_CACHE_COMPATIBLE;
+  }
 
   void SetInCache(bool in_cache) {
     if (in_cache) {
@@ -121,9 +133,19 @@ struct LRUHandle {
 
   void SetHit() { flags |= HAS_HIT; }
 
+  void SetSecondaryCacheCompatible(bool compat) {
+    if (compat) {
+      flags |= IS_SECONDARY_CACHE_COMPATIBLE;
+    } else {
+      flags &= ~IS_SECONDARY_CACHE_COMPATIBLE;
+    }
+  }
+
   void Free() {
     assert(refs == 0);
-    if (deleter) {
+    if (IsSecondaryCacheCompatible()) {
+      (*helper->del_cb)(key(), value);
+    } else if (deleter) {
       (*deleter)(key(), value);
     }
     delete[] reinterpret_cast<char*>(this);
@@ -144,6 +166,8 @@ class LRUHandleTable {
   LRUHandle* Insert(LRUHandle* h);
   LRUHandle* Remove(const Slice& key, uint32_t hash);
 
+  uint32_t GetNumEntries() const { return elems_; }
+
   template <typename T>
   void ApplyToAllCacheEntries(T func) {
     for (uint32_t i = 0; i < length_; i++) {
@@ -172,11 +196,55 @@ class LRUHandleTable {
   uint32_t elems_;
 };
 
+// Estimates how often each key was accessed recently, for the TinyLFU
+// admission policy of LRUCacheShard. It is a count-min sketch of 4-bit
+// counters, 16 per 64-bit word, four of which are incremented for each
+// access. After 10 accesses per entry the sketch was sized for, all
+// counters are halved, so that the estimates follow a changing workload.
+//
+// Not thread safe.
+class FrequencySketch {
+ public:
+  FrequencySketch();
+
+  // Grows the sketch for num_entries entries, if it was sized for fewer.
+  // Each counter is split into the two that take over its indexes, so the
+  // estimates carry over.
+  void EnsureCapacity(size_t num_entries);
+
+  void Increment(uint32_t hash);
+
+  // Estimated number of accesses, between 0 and 15.
+  int Estimate(uint32_t hash) const;
+
+  size_t TEST_GetNumCounters() const { return table_.size() * 16; }
+
+ private:
+  // Index of the i-th counter of hash among all counters
+  uint32_t CounterIndex(uint32_t hash, int i) const;
+
+  // Halves all counters
+  void Age();
+
+  std::vector<uint64_t> table_;
+  int index_shift_;
+  size_t sized_for_;
+  size_t sample_size_;
+  size_t additions_;
+};
+
+class LRUCache;
+
 // A single shard of sharded cache.
 class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShard {
  public:
+  // If parent is not nullptr, it is notified whenever the usage of
+  // secondary_cache may have changed.
   LRUCacheShard(size_t capacity, bool strict_capacity_limit,
-                double high_pri_pool_ratio, bool use_adaptive_mutex);
+                double high_pri_pool_ratio, bool use_adaptive_mutex,
+                bool tiny_lfu_admission = false,
+                std::shared_ptr<SecondaryCache> secondary_cache = nullptr,
+                LRUCache* parent = nullptr);
   virtual ~LRUCacheShard() override = default;
 
   // Separate from constructor so caller can easily make an array of LRUCache
@@ -197,6 +265,14 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShard {
                         Cache::Handle** handle,
                         Cache::Priority priority) override;
   virtual Cache::Handle* Lookup(const Slice& key, uint32_t hash) override;
+  virtual Status InsertWithHelper(const Slice& key, uint32_t hash, void* value,
+                                  const Cache::CacheItemHelper* helper,
+                                  size_t charge, Cache::Handle** handle,
+                                  Cache::Priority priority) override;
+  virtual Cache::Handle* LookupWithHelper(
+      const Slice& key, uint32_t hash, const Cache::CacheItemHelper* helper,
+      const Cache::CreateCallback& create_cb,
+      Cache::Priority priority) override;
   virtual bool Ref(Cache::Handle* handle) override;
   virtual bool Release(Cache::Handle* handle,
                        bool force_erase = false) override;
@@ -225,6 +301,11 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShard {
   //  Retrives high pri pool ratio
   double GetHighPriPoolRatio();
 
+  // Number of inserts turned away by the admission policy
+  uint64_t GetNumAdmissionRejects() const;
+
+  int TEST_EstimateFrequency(uint32_t hash);
+
  private:
   void LRU_Remove(LRUHandle* e);
   void LRU_Insert(LRUHandle* e);
@@ -239,6 +320,24 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShard {
   // holding the mutex_
   void EvictFromLRU(size_t charge, autovector<LRUHandle*>* deleted);
 
+  // TinyLFU admission: whether e, which does not fit without evicting,
+  // is accessed more often than the entry it would evict first. Must be
+  // called while holding mutex_.
+  bool Admit(const LRUHandle* e);
+
+  // Common part of Insert() and InsertWithHelper(), for an entry allocated
+  // and filled in by the caller.
+  Status InsertItem(LRUHandle* e, Cache::Handle** handle);
+
+  // Frees entries evicted from this shard, after saving those that allow it
+  // to the secondary cache. Must be called without holding mutex_.
+  void SpillAndFree(const autovector<LRUHandle*>& evicted);
+
+  // All set at construction
+  const bool tiny_lfu_admission_;
+  std::shared_ptr<SecondaryCache> secondary_cache_;
+  LRUCache* parent_;
+
   // Initialized before use.
   size_t capacity_;
 
@@ -282,6 +381,13 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShard {
   // Memory size for entries residing only in the LRU list
   size_t lru_usage_;
 
+  // Access frequencies, if tiny_lfu_admission_
+  FrequencySketch sketch_;
+  uint64_t num_admission_rejects_;
+
+  // Whether SpillAndFree() ever saved an entry to the secondary cache
+  std::atomic<bool> spilled_;
+
   // mutex_ protects the following state.
   // We don't count mutex_ as the cache's internal state so semantically we
   // don't mind mutex_ invoking the non-const actions.
@@ -297,7 +403,9 @@ class LRUCache
   LRUCache(size_t capacity, int num_shard_bits, bool strict_capacity_limit,
            double high_pri_pool_ratio,
            std::shared_ptr<MemoryAllocator> memory_allocator = nullptr,
-           bool use_adaptive_mutex = kDefaultToAdaptiveMutex);
+           bool use_adaptive_mutex = kDefaultToAdaptiveMutex,
+           std::shared_ptr<SecondaryCache> secondary_cache = nullptr,
+           bool tiny_lfu_admission = false);
   virtual ~LRUCache();
   virtual const char* Name() const override { return "LRUCache"; }
   virtual CacheShard* GetShard(int shard) override;
@@ -312,9 +420,31 @@ class LRUCache
   //  Retrives high pri pool ratio
   double GetHighPriPoolRatio();
 
+  // Sum of LRUCacheShard::GetNumAdmissionRejects() over all shards
+  uint64_t GetNumAdmissionRejects() const;
+
+  // Brings the dummy entries that charge the memory of the secondary cache
+  // to this cache in line with its current usage. Adjustments by several
+  // threads are not serialized: a thread that finds another one adjusting
+  // leaves it to that thread.
+  void UpdateSecondaryCacheReservation();
+
+  // Memory of the secondary cache currently charged to this cache
+  size_t GetSecondaryCacheReservation() const {
+    return secondary_cache_reservation_.load(std::memory_order_relaxed);
+  }
+
  private:
   LRUCacheShard* shards_ = nullptr;
   int num_shards_ = 0;
+
+  std::shared_ptr<SecondaryCache> secondary_cache_;
+  // Held by the thread adjusting the reservation, which owns
+  // reservation_handles_ and next_reservation_key_id_ while it does
+  std::atomic<bool> reservation_in_progress_;
+  std::atomic<size_t> secondary_cache_reservation_;
+  std::vector<Cache::Handle*> reservation_handles_;
+  uint64_t next_reservation_key_id_ = 0;
 };
 
 }  // namespace rocksdb
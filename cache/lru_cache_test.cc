@@ -9,6 +9,8 @@
 #include <vector>
 #include "port/port.h"
 #include "test_util/testharness.h"
+#include "util/hash.h"
+#include "util/string_util.h"
 
 namespace rocksdb {
 
@@ -26,17 +28,24 @@ class LRUCacheTest : public testing::Test {
   }
 
   void NewCache(size_t capacity, double high_pri_pool_ratio = 0.0,
-                bool use_adaptive_mutex = kDefaultToAdaptiveMutex) {
+                bool use_adaptive_mutex = kDefaultToAdaptiveMutex,
+                bool tiny_lfu_admission = false) {
     DeleteCache();
     cache_ = reinterpret_cast<LRUCacheShard*>(
         port::cacheline_aligned_alloc(sizeof(LRUCacheShard)));
     new (cache_) LRUCacheShard(capacity, false /*strict_capcity_limit*/,
-                               high_pri_pool_ratio, use_adaptive_mutex);
+                               high_pri_pool_ratio, use_adaptive_mutex,
+                               tiny_lfu_admission);
+  }
+
+  // The admission policy tells keys apart by hash
+  static uint32_t KeyHash(const std::string& key) {
+    return Hash(key.data(), key.size(), 0);
   }
 
   void Insert(const std::string& key,
               Cache::Priority priority = Cache::Priority::LOW) {
-    cache_->Insert(key, 0 /*hash*/, nullptr /*value*/, 1 /*charge*/,
+    cache_->Insert(key, KeyHash(key), nullptr /*value*/, 1 /*charge*/,
                    nullptr /*deleter*/, nullptr /*handle*/, priority);
   }
 
@@ -45,7 +54,7 @@ class LRUCacheTest : public testing::Test {
   }
 
   bool Lookup(const std::string& key) {
-    auto handle = cache_->Lookup(key, 0 /*hash*/);
+    auto handle = cache_->Lookup(key, KeyHash(key));
     if (handle) {
       cache_->Release(handle);
       return true;
@@ -55,7 +64,7 @@ class LRUCacheTest : public testing::Test {
 
   bool Lookup(char key) { return Lookup(std::string(1, key)); }
 
-  void Erase(const std::string& key) { cache_->Erase(key, 0 /*hash*/); }
+  void Erase(const std::string& key) { cache_->Erase(key, KeyHash(key)); }
 
   void ValidateLRUList(std::vector<std::string> keys,
                        size_t num_high_pri_pool_keys = 0) {
@@ -86,7 +95,7 @@ class LRUCacheTest : public testing::Test {
     ASSERT_EQ(num_high_pri_pool_keys, high_pri_pool_keys);
   }
 
- private:
+ protected:
   LRUCacheShard* cache_ = nullptr;
 };
 
@@ -189,6 +198,78 @@ TEST_F(LRUCacheTest, EntriesWithPriority) {
   ValidateLRUList({"e", "f", "g", "Z", "d"}, 2);
 }
 
+TEST_F(LRUCacheTest, FrequencySketch) {
+  FrequencySketch sketch;
+  sketch.EnsureCapacity(100);
+  ASSERT_EQ(128 * 16, sketch.TEST_GetNumCounters());
+  uint32_t hot = KeyHash("hot");
+  uint32_t cold = KeyHash("cold");
+  for (int i = 0; i < 20; i++) {
+    sketch.Increment(hot);
+  }
+  sketch.Increment(cold);
+  // Counters saturate at 15
+  ASSERT_EQ(15, sketch.Estimate(hot));
+  ASSERT_EQ(1, sketch.Estimate(cold));
+  ASSERT_EQ(0, sketch.Estimate(KeyHash("unseen")));
+
+  // Aging after 10 accesses per entry halves the counts
+  for (uint32_t i = 0; i < 10 * 128; i++) {
+    sketch.Increment(KeyHash("other" + ToString(i)));
+  }
+  ASSERT_LE(sketch.Estimate(hot), 8);
+  ASSERT_GE(sketch.Estimate(hot), 7);
+
+  // Growing keeps the counts, shrinking is ignored
+  int hot_estimate = sketch.Estimate(hot);
+  int other_estimate = sketch.Estimate(KeyHash("other0"));
+  sketch.EnsureCapacity(10);
+  ASSERT_EQ(128 * 16, sketch.TEST_GetNumCounters());
+  sketch.EnsureCapacity(1000);
+  ASSERT_EQ(1024 * 16, sketch.TEST_GetNumCounters());
+  ASSERT_EQ(hot_estimate, sketch.Estimate(hot));
+  ASSERT_EQ(other_estimate, sketch.Estimate(KeyHash("other0")));
+}
+
+TEST_F(LRUCacheTest, TinyLFUAdmission) {
+  NewCache(5, 0.0, kDefaultToAdaptiveMutex, true /*tiny_lfu_admission*/);
+  for (char ch = 'a'; ch <= 'e'; ch++) {
+    Insert(ch);
+    ASSERT_TRUE(Lookup(ch));
+  }
+  ValidateLRUList({"a", "b", "c", "d", "e"});
+
+  // An entry that was never looked up does not push out one that was
+  Insert('x');
+  ValidateLRUList({"a", "b", "c", "d", "e"});
+  ASSERT_EQ(1, cache_->GetNumAdmissionRejects());
+
+  // Misses count, so a key in demand gets in eventually
+  ASSERT_FALSE(Lookup('y'));
+  ASSERT_FALSE(Lookup('y'));
+  Insert('y');
+  ValidateLRUList({"b", "c", "d", "e", "y"});
+  ASSERT_EQ(1, cache_->GetNumAdmissionRejects());
+
+  // High priority entries are always admitted
+  Insert('z', Cache::Priority::HIGH);
+  ValidateLRUList({"c", "d", "e", "y", "z"});
+
+  // A rejected insert that asks for a handle gets one to an entry outside
+  // of the cache
+  Cache::Handle* handle = nullptr;
+  ASSERT_OK(cache_->Insert("w", KeyHash("w"), nullptr /*value*/,
+                           1 /*charge*/, nullptr /*deleter*/, &handle,
+                           Cache::Priority::LOW));
+  ASSERT_NE(nullptr, handle);
+  ASSERT_EQ(2, cache_->GetNumAdmissionRejects());
+  ASSERT_EQ(6, cache_->GetUsage());
+  ASSERT_FALSE(Lookup('w'));
+  ValidateLRUList({"c", "d", "e", "y", "z"});
+  ASSERT_TRUE(cache_->Release(handle));
+  ASSERT_EQ(5, cache_->GetUsage());
+}
+
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
@@ -21,6 +21,7 @@
 
 #include "cloud/aws/aws_file.h"
 #include "cloud/cloud_log_controller.h"
+#include "cloud/cloud_transfer_limiter.h"
 #include "cloud/db_cloud_impl.h"
 
 namespace rocksdb {
@@ -1801,12 +1802,23 @@ Status AwsEnv::GetObject(const std::string& bucket_name,
   Env* localenv = GetBaseEnv();
   std::string tmp_destination = local_destination + ".tmp";
 
+  // The size of the object is not known before the download, so admit the
+  // request first and charge the bytes once they arrived.
+  CloudTransferLimiter* limiter = cloud_env_options.transfer_limiter.get();
+  CloudTransferPriority priority = CloudTransferPriorityScope::Current();
+  if (limiter != nullptr) {
+    limiter->Request(0, priority);
+  }
+
   GetObjectResult result;
   if (cloud_env_options.use_aws_transfer_manager) {
     result = DoGetObjectWithTransferManager(ToAwsString(bucket_name), ToAwsString(object_path), tmp_destination);
   } else {
     result = DoGetObject(ToAwsString(bucket_name), ToAwsString(object_path), tmp_destination);
   }
+  if (limiter != nullptr && result.success) {
+    limiter->Charge(static_cast<int64_t>(result.objectSize), priority);
+  }
 
   if (!result.success) {
     localenv->DeleteFile(tmp_destination);
@@ -1914,6 +1926,11 @@ Status AwsEnv::PutObject(const std::string& local_file,
     return Status::IOError(local_file + " Zero size.");
   }
 
+  if (cloud_env_options.transfer_limiter) {
+    cloud_env_options.transfer_limiter->Request(static_cast<int64_t>(fsize),
+                                                CloudTransferPriority::kUpload);
+  }
+
   auto s3_bucket = ToAwsString(bucket_name);
   PutObjectResult result;
   if (cloud_env_options.use_aws_transfer_manager) {
@@ -1969,6 +1986,43 @@ Status AwsEnv::NewLogger(const std::string& fname,
   return base_env_->NewLogger(fname, result);
 }
 
+namespace {
+// A background job submitted through AwsEnv::Schedule()
+struct TransferPriorityJob {
+  void (*function)(void* arg);
+  void (*unschedFunction)(void* arg);
+  void* arg;
+};
+}  // namespace
+
+void AwsEnv::Schedule(void (*function)(void* arg), void* arg, Priority pri,
+                      void* tag, void (*unschedFunction)(void* arg)) {
+  if (!cloud_env_options.transfer_limiter) {
+    base_env_->Schedule(function, arg, pri, tag, unschedFunction);
+    return;
+  }
+  // Always install an unschedule callback so that the wrapper is released
+  // when the job is dropped from the queue.
+  auto job = new TransferPriorityJob{function, unschedFunction, arg};
+  base_env_->Schedule(&AwsEnv::BGWorkWithTransferPriority, job, pri, tag,
+                      &AwsEnv::UnscheduleWithTransferPriority);
+}
+
+void AwsEnv::BGWorkWithTransferPriority(void* arg) {
+  std::unique_ptr<TransferPriorityJob> job(
+      reinterpret_cast<TransferPriorityJob*>(arg));
+  CloudTransferPriorityScope scope(CloudTransferPriority::kCompactionRead);
+  job->function(job->arg);
+}
+
+void AwsEnv::UnscheduleWithTransferPriority(void* arg) {
+  std::unique_ptr<TransferPriorityJob> job(
+      reinterpret_cast<TransferPriorityJob*>(arg));
+  if (job->unschedFunction != nullptr) {
+    job->unschedFunction(job->arg);
+  }
+}
+
 // The factory method for creating an S3 Env
 Status AwsEnv::NewAwsEnv(Env* base_env,
                          const CloudEnvOptions& cloud_options,
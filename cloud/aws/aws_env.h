@@ -168,11 +168,11 @@ class AwsEnv : public CloudEnvImpl {
   virtual Status NewLogger(const std::string& fname,
                            std::shared_ptr<Logger>* result) override;
 
+  // If a transfer limiter is configured, background jobs are wrapped so that
+  // the cloud reads they issue are charged as compaction reads.
   virtual void Schedule(void (*function)(void* arg), void* arg,
                         Priority pri = LOW, void* tag = nullptr,
-                        void (*unschedFunction)(void* arg) = 0) override {
-    base_env_->Schedule(function, arg, pri, tag, unschedFunction);
-  }
+                        void (*unschedFunction)(void* arg) = 0) override;
 
   virtual int UnSchedule(void* tag, Priority pri) override {
     return base_env_->UnSchedule(tag, pri);
@@ -319,6 +319,10 @@ class AwsEnv : public CloudEnvImpl {
                                                  const Aws::String& key,
                                                  uint64_t sizeHint);
 
+  // Invoked by the background threads for jobs submitted through Schedule()
+  static void BGWorkWithTransferPriority(void* arg);
+  static void UnscheduleWithTransferPriority(void* arg);
+
   // The pathname that contains a list of all db's inside a bucket.
   static constexpr const char* dbid_registry_ = "/.rockset/dbid/";
 
@@ -13,6 +13,7 @@
 
 #include "cloud/aws/aws_env.h"
 #include "cloud/aws/aws_file.h"
+#include "cloud/cloud_transfer_limiter.h"
 #include "util/coding.h"
 #include "util/stderr_logger.h"
 #include "util/string_util.h"
@@ -90,6 +91,12 @@ Status S3ReadableFile::Read(uint64_t offset, size_t n, Slice* result,
   }
   Aws::String range(buffer);
 
+  const auto& limiter = env_->GetCloudEnvOptions().transfer_limiter;
+  if (limiter) {
+    limiter->Request(static_cast<int64_t>(n),
+                     CloudTransferPriorityScope::Current());
+  }
+
   // set up S3 request to read this range
   Aws::S3::Model::GetObjectRequest request;
   request.SetBucket(s3_bucket_);
@@ -30,6 +30,14 @@ void CloudEnvOptions::Dump(Logger* log) const {
          skip_dbid_verification ? "true" : "false");
   Header(log, "           COptions.use_aws_transfer_manager: %s",
          use_aws_transfer_manager ? "true" : "false");
+  Header(log, "                   COptions.transfer_limiter: %p",
+         transfer_limiter.get());
+  if (transfer_limiter) {
+    Header(log, "     COptions.transfer_limiter.bytes_per_sec: %" PRId64,
+           transfer_limiter->GetBytesPerSecond());
+    Header(log, "  COptions.transfer_limiter.requests_per_sec: %" PRId64,
+           transfer_limiter->GetRequestsPerSecond());
+  }
 }
 
 }  // namespace rocksdb
@@ -0,0 +1,251 @@
+//  Copyright (c) 2016-present, Rockset, Inc.  All rights reserved.
+
+#include "cloud/cloud_transfer_limiter.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include "util/mutexlock.h"
+
+namespace rocksdb {
+
+namespace {
+#ifdef ROCKSDB_SUPPORT_THREAD_LOCAL
+__thread CloudTransferPriority current_read_priority =
+    CloudTransferPriority::kUserRead;
+#endif
+}  // namespace
+
+CloudTransferPriorityScope::CloudTransferPriorityScope(
+    CloudTransferPriority pri)
+    : prev_(Current()) {
+#ifdef ROCKSDB_SUPPORT_THREAD_LOCAL
+  current_read_priority = pri;
+#else
+  (void)pri;
+#endif
+}
+
+CloudTransferPriorityScope::~CloudTransferPriorityScope() {
+#ifdef ROCKSDB_SUPPORT_THREAD_LOCAL
+  current_read_priority = prev_;
+#endif
+}
+
+CloudTransferPriority CloudTransferPriorityScope::Current() {
+#ifdef ROCKSDB_SUPPORT_THREAD_LOCAL
+  return current_read_priority;
+#else
+  return CloudTransferPriority::kUserRead;
+#endif
+}
+
+CloudTransferLimiterImpl::CloudTransferLimiterImpl(int64_t bytes_per_second,
+                                                   int64_t requests_per_second,
+                                                   int64_t refill_period_us,
+                                                   int32_t fairness, Env* env)
+    : cv_(&mu_),
+      env_(env),
+      refill_period_us_(refill_period_us),
+      fairness_(fairness > 100 ? 100 : fairness),
+      bytes_per_second_(bytes_per_second),
+      requests_per_second_(requests_per_second),
+      last_refill_us_(env->NowMicros()) {
+  assert(bytes_per_second >= 0);
+  assert(requests_per_second >= 0);
+  assert(refill_period_us > 0);
+  assert(fairness > 0);
+  available_bytes_ = BurstBytes();
+  available_requests_ = BurstRequests();
+  for (int i = 0; i < kNumPriorities; ++i) {
+    waiters_[i] = 0;
+    bypassed_[i] = 0;
+    total_bytes_[i] = 0;
+    total_requests_[i] = 0;
+    total_wait_micros_[i] = 0;
+  }
+}
+
+void CloudTransferLimiterImpl::RefillLocked() {
+  mu_.AssertHeld();
+  uint64_t now = env_->NowMicros();
+  if (now <= last_refill_us_) {
+    return;
+  }
+  double elapsed = static_cast<double>(now - last_refill_us_);
+  last_refill_us_ = now;
+  if (bytes_per_second_ > 0) {
+    available_bytes_ = std::min(
+        BurstBytes(), available_bytes_ + elapsed * bytes_per_second_ / 1e6);
+  }
+  if (requests_per_second_ > 0) {
+    available_requests_ =
+        std::min(BurstRequests(),
+                 available_requests_ + elapsed * requests_per_second_ / 1e6);
+  }
+}
+
+bool CloudTransferLimiterImpl::HasBudgetLocked() const {
+  mu_.AssertHeld();
+  return (bytes_per_second_ == 0 || available_bytes_ > 0) &&
+         (requests_per_second_ == 0 || available_requests_ >= 1);
+}
+
+bool CloudTransferLimiterImpl::IsTurnLocked(int pri) const {
+  mu_.AssertHeld();
+  // A starving lower priority request goes first
+  for (int i = pri + 1; i < kNumPriorities; ++i) {
+    if (waiters_[i] > 0 && bypassed_[i] >= fairness_) {
+      return false;
+    }
+  }
+  if (bypassed_[pri] >= fairness_) {
+    return true;
+  }
+  for (int i = 0; i < pri; ++i) {
+    if (waiters_[i] > 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+uint64_t CloudTransferLimiterImpl::MicrosUntilBudgetLocked() const {
+  mu_.AssertHeld();
+  double wait = 0;
+  if (bytes_per_second_ > 0 && available_bytes_ <= 0) {
+    wait = std::max(wait, (1 - available_bytes_) * 1e6 / bytes_per_second_);
+  }
+  if (requests_per_second_ > 0 && available_requests_ < 1) {
+    wait = std::max(wait,
+                    (1 - available_requests_) * 1e6 / requests_per_second_);
+  }
+  return std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(wait)));
+}
+
+void CloudTransferLimiterImpl::GrantLocked(int pri, int64_t bytes) {
+  mu_.AssertHeld();
+  if (bytes_per_second_ > 0) {
+    available_bytes_ -= static_cast<double>(bytes);
+  }
+  if (requests_per_second_ > 0) {
+    available_requests_ -= 1;
+  }
+  total_bytes_[pri] += bytes;
+  total_requests_[pri]++;
+  bypassed_[pri] = 0;
+  for (int i = pri + 1; i < kNumPriorities; ++i) {
+    if (waiters_[i] > 0) {
+      bypassed_[i]++;
+    }
+  }
+}
+
+void CloudTransferLimiterImpl::Request(int64_t bytes,
+                                       CloudTransferPriority pri) {
+  assert(bytes >= 0);
+  assert(pri < CloudTransferPriority::kTotal);
+  int p = static_cast<int>(pri);
+
+  MutexLock g(&mu_);
+  RefillLocked();
+  if (!HasBudgetLocked() || !IsTurnLocked(p)) {
+    uint64_t start = env_->NowMicros();
+    waiters_[p]++;
+    while (true) {
+      RefillLocked();
+      bool has_budget = HasBudgetLocked();
+      if (has_budget && IsTurnLocked(p)) {
+        break;
+      }
+      // Somebody else's grant wakes us up when we are only waiting for our
+      // turn; the timeout covers a concurrent change of the budgets.
+      uint64_t wait =
+          has_budget ? static_cast<uint64_t>(refill_period_us_)
+                     : std::min(MicrosUntilBudgetLocked(),
+                                static_cast<uint64_t>(refill_period_us_));
+      cv_.TimedWait(env_->NowMicros() + wait);
+    }
+    waiters_[p]--;
+    total_wait_micros_[p] += static_cast<int64_t>(env_->NowMicros() - start);
+  }
+  GrantLocked(p, bytes);
+  // Lower priority waiters may have become eligible through the fairness
+  // bound, and waiters of our own priority may still have budget left.
+  cv_.SignalAll();
+}
+
+void CloudTransferLimiterImpl::Charge(int64_t bytes,
+                                      CloudTransferPriority pri) {
+  assert(bytes >= 0);
+  assert(pri < CloudTransferPriority::kTotal);
+  MutexLock g(&mu_);
+  RefillLocked();
+  if (bytes_per_second_ > 0) {
+    available_bytes_ -= static_cast<double>(bytes);
+  }
+  total_bytes_[static_cast<int>(pri)] += bytes;
+}
+
+void CloudTransferLimiterImpl::SetBytesPerSecond(int64_t bytes_per_second) {
+  assert(bytes_per_second >= 0);
+  MutexLock g(&mu_);
+  RefillLocked();
+  bytes_per_second_ = bytes_per_second;
+  available_bytes_ = std::min(available_bytes_, BurstBytes());
+  cv_.SignalAll();
+}
+
+void CloudTransferLimiterImpl::SetRequestsPerSecond(
+    int64_t requests_per_second) {
+  assert(requests_per_second >= 0);
+  MutexLock g(&mu_);
+  RefillLocked();
+  requests_per_second_ = requests_per_second;
+  available_requests_ = std::min(available_requests_, BurstRequests());
+  cv_.SignalAll();
+}
+
+int64_t CloudTransferLimiterImpl::GetBytesPerSecond() const {
+  MutexLock g(&mu_);
+  return bytes_per_second_;
+}
+
+int64_t CloudTransferLimiterImpl::GetRequestsPerSecond() const {
+  MutexLock g(&mu_);
+  return requests_per_second_;
+}
+
+int64_t CloudTransferLimiterImpl::GetTotalBytesThrough(
+    CloudTransferPriority pri) const {
+  MutexLock g(&mu_);
+  return Sum(total_bytes_, pri);
+}
+
+int64_t CloudTransferLimiterImpl::GetTotalRequests(
+    CloudTransferPriority pri) const {
+  MutexLock g(&mu_);
+  return Sum(total_requests_, pri);
+}
+
+int64_t CloudTransferLimiterImpl::GetTotalWaitMicros(
+    CloudTransferPriority pri) const {
+  MutexLock g(&mu_);
+  return Sum(total_wait_micros_, pri);
+}
+
+CloudTransferLimiter* NewCloudTransferLimiter(int64_t bytes_per_second,
+                                              int64_t requests_per_second,
+                                              int64_t refill_period_us,
+                                              int32_t fairness) {
+  assert(bytes_per_second >= 0);
+  assert(requests_per_second >= 0);
+  assert(refill_period_us > 0);
+  assert(fairness > 0);
+  return new CloudTransferLimiterImpl(bytes_per_second, requests_per_second,
+                                      refill_period_us, fairness,
+                                      Env::Default());
+}
+
+}  // namespace rocksdb
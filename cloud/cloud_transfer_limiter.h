@@ -0,0 +1,117 @@
+//  Copyright (c) 2016-present, Rockset, Inc.  All rights reserved.
+
+#pragma once
+#include <algorithm>
+#include "port/port.h"
+#include "rocksdb/cloud/cloud_env_options.h"
+#include "rocksdb/env.h"
+
+namespace rocksdb {
+
+//
+// A token-bucket implementation of CloudTransferLimiter. Both budgets refill
+// continuously and are capped at one refill period worth of tokens. A request
+// is admitted when every enabled budget is positive and no request of a
+// higher priority is waiting (subject to the fairness bound).
+//
+class CloudTransferLimiterImpl : public CloudTransferLimiter {
+ public:
+  CloudTransferLimiterImpl(int64_t bytes_per_second,
+                           int64_t requests_per_second,
+                           int64_t refill_period_us, int32_t fairness,
+                           Env* env);
+
+  virtual ~CloudTransferLimiterImpl() {}
+
+  void Request(int64_t bytes, CloudTransferPriority pri) override;
+  void Charge(int64_t bytes, CloudTransferPriority pri) override;
+
+  void SetBytesPerSecond(int64_t bytes_per_second) override;
+  void SetRequestsPerSecond(int64_t requests_per_second) override;
+
+  int64_t GetBytesPerSecond() const override;
+  int64_t GetRequestsPerSecond() const override;
+
+  int64_t GetTotalBytesThrough(
+      CloudTransferPriority pri = CloudTransferPriority::kTotal) const override;
+  int64_t GetTotalRequests(
+      CloudTransferPriority pri = CloudTransferPriority::kTotal) const override;
+  int64_t GetTotalWaitMicros(
+      CloudTransferPriority pri = CloudTransferPriority::kTotal) const override;
+
+ private:
+  static const int kNumPriorities =
+      static_cast<int>(CloudTransferPriority::kTotal);
+
+  // Adds the tokens accumulated since the last refill. REQUIRES: mu_ held
+  void RefillLocked();
+  // Whether every enabled budget can admit a request. REQUIRES: mu_ held
+  bool HasBudgetLocked() const;
+  // Whether no higher priority request should go first. REQUIRES: mu_ held
+  bool IsTurnLocked(int pri) const;
+  // Time until HasBudgetLocked() becomes true. REQUIRES: mu_ held
+  uint64_t MicrosUntilBudgetLocked() const;
+  void GrantLocked(int pri, int64_t bytes);
+
+  double BurstBytes() const {
+    return static_cast<double>(bytes_per_second_) * refill_period_us_ / 1e6;
+  }
+  double BurstRequests() const {
+    return std::max(
+        1.0, static_cast<double>(requests_per_second_) * refill_period_us_ /
+                 1e6);
+  }
+
+  static int64_t Sum(const int64_t* counters, CloudTransferPriority pri) {
+    if (pri == CloudTransferPriority::kTotal) {
+      int64_t total = 0;
+      for (int i = 0; i < kNumPriorities; ++i) {
+        total += counters[i];
+      }
+      return total;
+    }
+    return counters[static_cast<int>(pri)];
+  }
+
+  // This mutex guards all internal states
+  mutable port::Mutex mu_;
+  port::CondVar cv_;
+  Env* const env_;
+
+  const int64_t refill_period_us_;
+  const int32_t fairness_;
+
+  int64_t bytes_per_second_;
+  int64_t requests_per_second_;
+  double available_bytes_;
+  double available_requests_;
+  uint64_t last_refill_us_;
+
+  // Number of requests blocked in Request(), per priority
+  int32_t waiters_[kNumPriorities];
+  // Number of requests admitted ahead of the oldest waiter of each priority
+  int32_t bypassed_[kNumPriorities];
+
+  int64_t total_bytes_[kNumPriorities];
+  int64_t total_requests_[kNumPriorities];
+  int64_t total_wait_micros_[kNumPriorities];
+};
+
+//
+// Sets the priority charged for cloud reads issued by the current thread for
+// the lifetime of this object. Threads that never set one issue kUserRead
+// requests.
+//
+class CloudTransferPriorityScope {
+ public:
+  explicit CloudTransferPriorityScope(CloudTransferPriority pri);
+  ~CloudTransferPriorityScope();
+
+  // Returns the read priority of the current thread
+  static CloudTransferPriority Current();
+
+ private:
+  CloudTransferPriority prev_;
+};
+
+}  // namespace rocksdb
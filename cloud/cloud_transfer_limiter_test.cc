@@ -0,0 +1,151 @@
+// Copyright (c) 2017 Rockset
+
+#include "cloud/cloud_transfer_limiter.h"
+
+#include <atomic>
+#include <memory>
+
+#include "port/port.h"
+#include "rocksdb/env.h"
+#include "test_util/testharness.h"
+
+namespace rocksdb {
+
+class CloudTransferLimiterTest : public testing::Test {
+ public:
+  CloudTransferLimiterTest() : env_(Env::Default()) {}
+
+ protected:
+  Env* env_;
+};
+
+TEST_F(CloudTransferLimiterTest, Unlimited) {
+  std::unique_ptr<CloudTransferLimiter> limiter(
+      NewCloudTransferLimiter(0 /* bytes_per_second */,
+                              0 /* requests_per_second */));
+  for (int i = 0; i < 1000; ++i) {
+    limiter->Request(1 << 20, CloudTransferPriority::kUserRead);
+  }
+  limiter->Request(10, CloudTransferPriority::kUpload);
+  limiter->Charge(5, CloudTransferPriority::kCompactionRead);
+
+  ASSERT_EQ(1000, limiter->GetTotalRequests(CloudTransferPriority::kUserRead));
+  ASSERT_EQ(1001, limiter->GetTotalRequests());
+  ASSERT_EQ(1000LL << 20,
+            limiter->GetTotalBytesThrough(CloudTransferPriority::kUserRead));
+  ASSERT_EQ(5, limiter->GetTotalBytesThrough(
+                   CloudTransferPriority::kCompactionRead));
+  ASSERT_EQ((1000LL << 20) + 15, limiter->GetTotalBytesThrough());
+  ASSERT_EQ(0, limiter->GetTotalWaitMicros());
+}
+
+TEST_F(CloudTransferLimiterTest, RequestRate) {
+  // 100 requests/sec with a burst of one request
+  std::unique_ptr<CloudTransferLimiter> limiter(NewCloudTransferLimiter(
+      0 /* bytes_per_second */, 100 /* requests_per_second */,
+      10 * 1000 /* refill_period_us */));
+  uint64_t start = env_->NowMicros();
+  for (int i = 0; i < 21; ++i) {
+    limiter->Request(0, CloudTransferPriority::kUserRead);
+  }
+  uint64_t elapsed = env_->NowMicros() - start;
+  ASSERT_GE(elapsed, 180 * 1000U);
+  ASSERT_GT(limiter->GetTotalWaitMicros(CloudTransferPriority::kUserRead), 0);
+}
+
+TEST_F(CloudTransferLimiterTest, ByteRateOverdraft) {
+  // 1MB/sec with a burst of 100KB
+  std::unique_ptr<CloudTransferLimiter> limiter(
+      NewCloudTransferLimiter(1 << 20 /* bytes_per_second */,
+                              0 /* requests_per_second */));
+  uint64_t start = env_->NowMicros();
+  // Larger than a burst, admitted immediately
+  limiter->Request(300 << 10, CloudTransferPriority::kUpload);
+  ASSERT_LT(env_->NowMicros() - start, 100 * 1000U);
+  // Has to wait until the overdraft is repaid
+  limiter->Request(1, CloudTransferPriority::kUpload);
+  ASSERT_GE(env_->NowMicros() - start, 150 * 1000U);
+
+  // Charging does not block, but delays the next request
+  limiter->Charge(200 << 10, CloudTransferPriority::kCompactionRead);
+  start = env_->NowMicros();
+  limiter->Request(1, CloudTransferPriority::kUserRead);
+  ASSERT_GE(env_->NowMicros() - start, 150 * 1000U);
+}
+
+TEST_F(CloudTransferLimiterTest, SetRates) {
+  std::unique_ptr<CloudTransferLimiter> limiter(NewCloudTransferLimiter(
+      1 /* bytes_per_second */, 1 /* requests_per_second */));
+  ASSERT_EQ(1, limiter->GetBytesPerSecond());
+  ASSERT_EQ(1, limiter->GetRequestsPerSecond());
+
+  // Exhaust the budget, then lift the limits from another thread while a
+  // request is blocked.
+  limiter->Request(100, CloudTransferPriority::kUserRead);
+  port::Thread t([&]() {
+    env_->SleepForMicroseconds(50 * 1000);
+    limiter->SetBytesPerSecond(0);
+    limiter->SetRequestsPerSecond(0);
+  });
+  uint64_t start = env_->NowMicros();
+  limiter->Request(100, CloudTransferPriority::kUserRead);
+  ASSERT_LT(env_->NowMicros() - start, 1000 * 1000U);
+  t.join();
+  ASSERT_EQ(0, limiter->GetBytesPerSecond());
+  ASSERT_EQ(0, limiter->GetRequestsPerSecond());
+}
+
+TEST_F(CloudTransferLimiterTest, Priority) {
+  // 10 requests/sec with a burst of one request
+  std::unique_ptr<CloudTransferLimiter> limiter(NewCloudTransferLimiter(
+      0 /* bytes_per_second */, 10 /* requests_per_second */));
+  limiter->Request(0, CloudTransferPriority::kUpload);
+
+  // The upload starts waiting first, but the user read is admitted first
+  std::atomic<int> order(0);
+  int upload_order = -1;
+  int read_order = -1;
+  port::Thread upload([&]() {
+    limiter->Request(0, CloudTransferPriority::kUpload);
+    upload_order = order.fetch_add(1);
+  });
+  env_->SleepForMicroseconds(20 * 1000);
+  port::Thread read([&]() {
+    limiter->Request(0, CloudTransferPriority::kUserRead);
+    read_order = order.fetch_add(1);
+  });
+  upload.join();
+  read.join();
+  ASSERT_EQ(0, read_order);
+  ASSERT_EQ(1, upload_order);
+}
+
+TEST_F(CloudTransferLimiterTest, Fairness) {
+  // With fairness 1, a waiting upload is admitted after one user read
+  std::unique_ptr<CloudTransferLimiter> limiter(NewCloudTransferLimiter(
+      0 /* bytes_per_second */, 20 /* requests_per_second */,
+      50 * 1000 /* refill_period_us */, 1 /* fairness */));
+  limiter->Request(0, CloudTransferPriority::kUserRead);
+
+  std::atomic<bool> upload_done(false);
+  int64_t reads_before_upload = -1;
+  port::Thread upload([&]() {
+    limiter->Request(0, CloudTransferPriority::kUpload);
+    reads_before_upload =
+        limiter->GetTotalRequests(CloudTransferPriority::kUserRead);
+    upload_done = true;
+  });
+  env_->SleepForMicroseconds(10 * 1000);
+  while (!upload_done) {
+    limiter->Request(0, CloudTransferPriority::kUserRead);
+  }
+  upload.join();
+  ASSERT_EQ(2, reads_before_upload);
+}
+
+}  //  namespace rocksdb
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -20,6 +20,7 @@
 #include "rocksdb/persistent_cache.h"
 #include "rocksdb/status.h"
 #include "rocksdb/table.h"
+#include "util/string_util.h"
 #include "util/xxhash.h"
 
 namespace rocksdb {
@@ -63,6 +64,15 @@ Status DBCloud::Open(const Options& opt, const std::string& local_dbname,
   Status st;
   Options options = opt;
 
+  // The cloud env only keeps table files in the bucket, so blob files
+  // would be lost with the local directory.
+  for (const auto& cf : column_families) {
+    if (cf.options.enable_blob_files) {
+      return Status::NotSupported(
+          "enable_blob_files is not supported by DBCloud");
+    }
+  }
+
   // Created logger if it is not already pre-created by user.
   if (!options.info_log) {
     CreateLoggerFromOptions(local_dbname, options, &options.info_log);
@@ -225,6 +235,59 @@ Status DBCloudImpl::Savepoint() {
   return st;
 }
 
+Status DBCloudImpl::SetDBOptions(
+    const std::unordered_map<std::string, std::string>& options_map) {
+  // Peel off the options of the cloud transfer limiter; everything else is
+  // handled by the base db.
+  static const std::string kBytesPerSec = "cloud_transfer_bytes_per_sec";
+  static const std::string kRequestsPerSec = "cloud_transfer_requests_per_sec";
+  std::unordered_map<std::string, std::string> db_options_map;
+  int64_t bytes_per_sec = -1;
+  int64_t requests_per_sec = -1;
+  for (const auto& opt : options_map) {
+    if (opt.first != kBytesPerSec && opt.first != kRequestsPerSec) {
+      db_options_map.insert(opt);
+      continue;
+    }
+    int64_t value;
+    try {
+      value = ParseInt64(opt.second);
+    } catch (const std::exception&) {
+      return Status::InvalidArgument("Error parsing " + opt.first + ":",
+                                     opt.second);
+    }
+    if (value < 0) {
+      return Status::InvalidArgument(opt.first + " must not be negative");
+    }
+    (opt.first == kBytesPerSec ? bytes_per_sec : requests_per_sec) = value;
+  }
+
+  const bool set_limiter = bytes_per_sec >= 0 || requests_per_sec >= 0;
+  auto cenv = static_cast<CloudEnvImpl*>(GetEnv());
+  const auto& limiter = cenv->GetCloudEnvOptions().transfer_limiter;
+  if (set_limiter && !limiter) {
+    return Status::InvalidArgument(
+        "No cloud transfer limiter configured in CloudEnvOptions");
+  }
+  // Only touch the limiter once the rest of the options were accepted, so
+  // that a failed call leaves everything unchanged.
+  if (!db_options_map.empty()) {
+    Status s = DBCloud::SetDBOptions(db_options_map);
+    if (!s.ok()) {
+      return s;
+    }
+  }
+  if (set_limiter) {
+    if (bytes_per_sec >= 0) {
+      limiter->SetBytesPerSecond(bytes_per_sec);
+    }
+    if (requests_per_sec >= 0) {
+      limiter->SetRequestsPerSecond(requests_per_sec);
+    }
+  }
+  return Status::OK();
+}
+
 Status DBCloudImpl::CheckpointToCloud(const BucketOptions& destination,
                                       const CheckpointToCloudOptions& options) {
   DisableFileDeletions();
@@ -24,6 +24,12 @@ class DBCloudImpl : public DBCloud {
   virtual ~DBCloudImpl();
   Status Savepoint() override;
 
+  // Also accepts "cloud_transfer_bytes_per_sec" and
+  // "cloud_transfer_requests_per_sec", which reconfigure the transfer limiter
+  // of the CloudEnv.
+  Status SetDBOptions(
+      const std::unordered_map<std::string, std::string>& options_map) override;
+
   Status CheckpointToCloud(const BucketOptions& destination,
                            const CheckpointToCloudOptions& options) override;
 
@@ -719,6 +719,22 @@ TEST_F(CloudTest, Encryption) {
   CloseDB();
 }
 
+TEST_F(CloudTest, BlobFilesNotSupported) {
+  CreateAwsEnv();
+  options_.env = aenv_.get();
+  ColumnFamilyOptions cfopt = options_;
+  cfopt.enable_blob_files = true;
+  std::vector<ColumnFamilyDescriptor> column_families;
+  column_families.emplace_back(
+      ColumnFamilyDescriptor(kDefaultColumnFamilyName, cfopt));
+  std::vector<ColumnFamilyHandle*> handles;
+  ASSERT_TRUE(DBCloud::Open(options_, dbname_, column_families,
+                            persistent_cache_path_, persistent_cache_size_gb_,
+                            &handles, &db_)
+                  .IsNotSupported());
+  ASSERT_TRUE(db_ == nullptr);
+}
+
 TEST_F(CloudTest, DirectReads) {
   options_.use_direct_reads = true;
   options_.use_direct_io_for_flush_and_compaction = true;
@@ -0,0 +1,18 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/blob_fetcher.h"
+
+#include "db/version_set.h"
+
+namespace rocksdb {
+
+Status BlobFetcher::FetchBlob(const Slice& user_key, const Slice& blob_index,
+                              PinnableSlice* blob_value) const {
+  assert(version_ != nullptr);
+  return version_->GetBlob(read_options_, user_key, blob_index, blob_value);
+}
+
+}  // namespace rocksdb
@@ -0,0 +1,160 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/blob_file_builder.h"
+
+#include "db/version_set.h"
+#include "file/filename.h"
+#include "options/cf_options.h"
+#include "util/file_reader_writer.h"
+#include "utilities/blob_db/blob_index.h"
+#include "utilities/blob_db/blob_log_format.h"
+
+namespace rocksdb {
+
+BlobFileBuilder::BlobFileBuilder(VersionSet* versions, Env* env,
+                                 const EnvOptions& env_options,
+                                 const ImmutableCFOptions* ioptions,
+                                 uint32_t column_family_id,
+                                 Env::IOPriority io_priority,
+                                 Env::WriteLifeTimeHint write_hint)
+    : versions_(versions),
+      env_(env),
+      env_options_(env_options),
+      ioptions_(ioptions),
+      column_family_id_(column_family_id),
+      io_priority_(io_priority),
+      write_hint_(write_hint) {
+  assert(!ioptions_->cf_paths.empty());
+}
+
+BlobFileBuilder::~BlobFileBuilder() {
+  // Finish() or Abandon() must have been called
+  assert(writer_ == nullptr);
+}
+
+Status BlobFileBuilder::Add(const Slice& user_key, const Slice& value,
+                            std::string* blob_index) {
+  assert(blob_index != nullptr);
+  blob_index->clear();
+  if (value.size() < ioptions_->min_blob_size) {
+    return Status::OK();
+  }
+
+  Status s;
+  if (writer_ == nullptr) {
+    s = OpenBlobFile();
+    if (!s.ok()) {
+      return s;
+    }
+  }
+
+  blob_db::BlobLogRecord record;
+  record.key = user_key;
+  record.value = value;
+  record.expiration = 0;
+  record.EncodeHeaderTo(&buf_);
+  s = writer_->Append(buf_);
+  if (s.ok()) {
+    s = writer_->Append(user_key);
+  }
+  if (s.ok()) {
+    s = writer_->Append(value);
+  }
+  if (!s.ok()) {
+    return s;
+  }
+
+  const uint64_t value_offset =
+      blob_file_size_ + blob_db::BlobLogRecord::kHeaderSize + user_key.size();
+  const uint64_t record_size =
+      blob_db::BlobLogRecord::kHeaderSize + user_key.size() + value.size();
+  blob_db::BlobIndex::EncodeBlob(blob_index, blob_file_number_, value_offset,
+                                 value.size(), kNoCompression);
+  blob_file_size_ += record_size;
+  blob_count_++;
+  blob_bytes_ += record_size;
+
+  if (blob_file_size_ >= ioptions_->blob_file_size) {
+    s = CloseBlobFile();
+  }
+  return s;
+}
+
+Status BlobFileBuilder::Finish() {
+  if (writer_ == nullptr) {
+    return Status::OK();
+  }
+  return CloseBlobFile();
+}
+
+void BlobFileBuilder::Abandon() {
+  writer_.reset();
+  for (uint64_t number : blob_file_numbers_) {
+    env_->DeleteFile(BlobFileName(ioptions_->cf_paths.front().path, number));
+  }
+  blob_file_numbers_.clear();
+  blob_file_additions_.clear();
+}
+
+Status BlobFileBuilder::OpenBlobFile() {
+  assert(writer_ == nullptr);
+  const uint64_t number = versions_->NewFileNumber();
+  const std::string fname =
+      BlobFileName(ioptions_->cf_paths.front().path, number);
+  std::unique_ptr<WritableFile> file;
+  Status s = NewWritableFile(env_, fname, &file, env_options_);
+  if (!s.ok()) {
+    return s;
+  }
+  blob_file_numbers_.push_back(number);
+  file->SetIOPriority(io_priority_);
+  file->SetWriteLifeTimeHint(write_hint_);
+  writer_.reset(new WritableFileWriter(std::move(file), fname, env_options_,
+                                       env_, ioptions_->statistics,
+                                       ioptions_->listeners));
+
+  blob_db::BlobLogHeader header;
+  header.column_family_id = column_family_id_;
+  header.compression = kNoCompression;
+  header.has_ttl = false;
+  header.EncodeTo(&buf_);
+  s = writer_->Append(buf_);
+  if (!s.ok()) {
+    return s;
+  }
+
+  blob_file_number_ = number;
+  blob_file_size_ = blob_db::BlobLogHeader::kSize;
+  blob_count_ = 0;
+  blob_bytes_ = 0;
+  return s;
+}
+
+Status BlobFileBuilder::CloseBlobFile() {
+  assert(writer_ != nullptr);
+  blob_db::BlobLogFooter footer;
+  footer.blob_count = blob_count_;
+  footer.EncodeTo(&buf_);
+  Status s = writer_->Append(buf_);
+  if (s.ok()) {
+    s = writer_->Sync(ioptions_->use_fsync);
+  }
+  if (s.ok()) {
+    s = writer_->Close();
+  }
+  writer_.reset();
+  if (!s.ok()) {
+    return s;
+  }
+
+  blob_file_size_ += blob_db::BlobLogFooter::kSize;
+  bytes_written_ += blob_file_size_;
+  blob_file_additions_.emplace_back(blob_file_number_, blob_count_,
+                                    blob_bytes_);
+  return s;
+}
+
+}  // namespace rocksdb
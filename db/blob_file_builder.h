@@ -0,0 +1,89 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <stdint.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "db/version_edit.h"
+#include "rocksdb/env.h"
+#include "rocksdb/slice.h"
+#include "rocksdb/status.h"
+
+namespace rocksdb {
+
+struct ImmutableCFOptions;
+class VersionSet;
+class WritableFileWriter;
+
+// Moves the values of a flush or a compaction that are at least
+// ColumnFamilyOptions::min_blob_size bytes into blob files, and hands back
+// the blob indexes to store in the table file in their place. The files use
+// the format of utilities/blob_db/blob_log_format.h, without compression or
+// TTL, and a new one is started once the current one reaches
+// ColumnFamilyOptions::blob_file_size.
+//
+// The files are only part of the DB once the version edit that adds
+// GetBlobFileAdditions() is applied. Not thread-safe.
+class BlobFileBuilder {
+ public:
+  BlobFileBuilder(VersionSet* versions, Env* env, const EnvOptions& env_options,
+                  const ImmutableCFOptions* ioptions, uint32_t column_family_id,
+                  Env::IOPriority io_priority,
+                  Env::WriteLifeTimeHint write_hint);
+
+  BlobFileBuilder(const BlobFileBuilder&) = delete;
+  BlobFileBuilder& operator=(const BlobFileBuilder&) = delete;
+
+  ~BlobFileBuilder();
+
+  // Writes `value` to a blob file and stores its blob index in *blob_index.
+  // Leaves *blob_index empty if the value is too small to be moved.
+  Status Add(const Slice& user_key, const Slice& value,
+             std::string* blob_index);
+
+  // Syncs and closes the current blob file.
+  Status Finish();
+
+  // Deletes the blob files written so far, after the flush or compaction
+  // failed or wrote no table file.
+  void Abandon();
+
+  const std::vector<BlobFileAddition>& GetBlobFileAdditions() const {
+    return blob_file_additions_;
+  }
+
+  // Total size of the blob files written so far
+  uint64_t bytes_written() const { return bytes_written_; }
+
+ private:
+  Status OpenBlobFile();
+  Status CloseBlobFile();
+
+  VersionSet* versions_;
+  Env* env_;
+  const EnvOptions env_options_;
+  const ImmutableCFOptions* ioptions_;
+  const uint32_t column_family_id_;
+  const Env::IOPriority io_priority_;
+  const Env::WriteLifeTimeHint write_hint_;
+
+  // The current blob file
+  std::unique_ptr<WritableFileWriter> writer_;
+  uint64_t blob_file_number_ = 0;
+  uint64_t blob_file_size_ = 0;
+  uint64_t blob_count_ = 0;
+  uint64_t blob_bytes_ = 0;
+
+  std::vector<uint64_t> blob_file_numbers_;
+  std::vector<BlobFileAddition> blob_file_additions_;
+  uint64_t bytes_written_ = 0;
+  std::string buf_;
+};
+
+}  // namespace rocksdb
@@ -0,0 +1,82 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/blob_file_cache.h"
+
+#include <memory>
+
+#include "db/blob_file_reader.h"
+#include "monitoring/statistics.h"
+#include "options/cf_options.h"
+
+namespace rocksdb {
+
+namespace {
+
+void DeleteBlobFileReader(const Slice& /*key*/, void* value) {
+  delete reinterpret_cast<BlobFileReader*>(value);
+}
+
+Slice GetSliceForFileNumber(const uint64_t* file_number) {
+  return Slice(reinterpret_cast<const char*>(file_number),
+               sizeof(*file_number));
+}
+
+}  // namespace
+
+BlobFileCache::BlobFileCache(Cache* cache, const ImmutableCFOptions* ioptions,
+                             const EnvOptions& env_options,
+                             uint32_t column_family_id)
+    : cache_(cache),
+      ioptions_(ioptions),
+      env_options_(env_options),
+      column_family_id_(column_family_id) {}
+
+Status BlobFileCache::FindBlobFileReader(uint64_t blob_file_number,
+                                         bool no_io, Cache::Handle** handle) {
+  Slice key = GetSliceForFileNumber(&blob_file_number);
+  *handle = cache_->Lookup(key);
+  if (*handle != nullptr) {
+    return Status::OK();
+  }
+  if (no_io) {
+    return Status::Incomplete("Blob file not open, no_io is set");
+  }
+
+  std::unique_ptr<BlobFileReader> reader;
+  Status s = BlobFileReader::Create(*ioptions_, env_options_,
+                                    column_family_id_, blob_file_number,
+                                    &reader);
+  if (!s.ok()) {
+    RecordTick(ioptions_->statistics, NO_FILE_ERRORS);
+    return s;
+  }
+  s = cache_->Insert(key, reader.get(), 1, &DeleteBlobFileReader, handle);
+  if (s.ok()) {
+    reader.release();
+  }
+  return s;
+}
+
+Status BlobFileCache::GetBlob(const ReadOptions& read_options,
+                              uint64_t blob_file_number,
+                              const Slice& user_key, uint64_t offset,
+                              uint64_t value_size, PinnableSlice* value) {
+  if (read_options.read_tier == kBlockCacheTier) {
+    return Status::Incomplete("Blob values are not cached, no_io is set");
+  }
+  Cache::Handle* handle = nullptr;
+  Status s =
+      FindBlobFileReader(blob_file_number, false /* no_io */, &handle);
+  if (!s.ok()) {
+    return s;
+  }
+  auto reader = reinterpret_cast<BlobFileReader*>(cache_->Value(handle));
+  s = reader->GetBlob(read_options, user_key, offset, value_size, value);
+  cache_->Release(handle);
+  return s;
+}
+
+}  // namespace rocksdb
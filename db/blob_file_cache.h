@@ -0,0 +1,49 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <stdint.h>
+
+#include "rocksdb/cache.h"
+#include "rocksdb/env.h"
+#include "rocksdb/options.h"
+#include "rocksdb/status.h"
+
+namespace rocksdb {
+
+struct ImmutableCFOptions;
+class BlobFileReader;
+
+// Keeps the blob files of a column family open for reads. The readers share
+// the table cache of the DB, where they are keyed by file number like the
+// table readers, so TableCache::Evict() closes an obsolete blob file too.
+class BlobFileCache {
+ public:
+  BlobFileCache(Cache* cache, const ImmutableCFOptions* ioptions,
+                const EnvOptions& env_options, uint32_t column_family_id);
+
+  BlobFileCache(const BlobFileCache&) = delete;
+  BlobFileCache& operator=(const BlobFileCache&) = delete;
+
+  // Reads the value of the blob at `offset` of blob file `blob_file_number`.
+  // See BlobFileReader::GetBlob().
+  Status GetBlob(const ReadOptions& read_options, uint64_t blob_file_number,
+                 const Slice& user_key, uint64_t offset, uint64_t value_size,
+                 PinnableSlice* value);
+
+ private:
+  // Finds the reader of the file, opening it if it is not in the cache.
+  // The caller must release *handle.
+  Status FindBlobFileReader(uint64_t blob_file_number, bool no_io,
+                            Cache::Handle** handle);
+
+  Cache* cache_;
+  const ImmutableCFOptions* ioptions_;
+  const EnvOptions env_options_;
+  const uint32_t column_family_id_;
+};
+
+}  // namespace rocksdb
@@ -0,0 +1,72 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <stdint.h>
+#include <memory>
+
+namespace rocksdb {
+
+// The immutable metadata of a blob file written by a flush or a compaction
+// when ColumnFamilyOptions::enable_blob_files is set. It is shared by all the
+// versions that contain the file; once the last of them is gone, the deleter
+// the VersionBuilder gave it marks the file obsolete.
+class SharedBlobFileMetaData {
+ public:
+  SharedBlobFileMetaData(uint64_t blob_file_number, uint64_t total_blob_count,
+                         uint64_t total_blob_bytes)
+      : blob_file_number_(blob_file_number),
+        total_blob_count_(total_blob_count),
+        total_blob_bytes_(total_blob_bytes) {}
+
+  SharedBlobFileMetaData(const SharedBlobFileMetaData&) = delete;
+  SharedBlobFileMetaData& operator=(const SharedBlobFileMetaData&) = delete;
+
+  uint64_t blob_file_number() const { return blob_file_number_; }
+  uint64_t total_blob_count() const { return total_blob_count_; }
+  // Size of the blob records, each a record header, a user key and a value
+  uint64_t total_blob_bytes() const { return total_blob_bytes_; }
+
+ private:
+  const uint64_t blob_file_number_;
+  const uint64_t total_blob_count_;
+  const uint64_t total_blob_bytes_;
+};
+
+// The state of a blob file in one version: the shared metadata and how many
+// of its blobs are no longer referenced by the table files of the version.
+// A file whose blobs are all garbage is dropped from the version.
+class BlobFileMetaData {
+ public:
+  BlobFileMetaData(std::shared_ptr<SharedBlobFileMetaData> shared_meta,
+                   uint64_t garbage_blob_count, uint64_t garbage_blob_bytes)
+      : shared_meta_(std::move(shared_meta)),
+        garbage_blob_count_(garbage_blob_count),
+        garbage_blob_bytes_(garbage_blob_bytes) {}
+
+  const std::shared_ptr<SharedBlobFileMetaData>& GetSharedMeta() const {
+    return shared_meta_;
+  }
+
+  uint64_t blob_file_number() const {
+    return shared_meta_->blob_file_number();
+  }
+  uint64_t total_blob_count() const {
+    return shared_meta_->total_blob_count();
+  }
+  uint64_t total_blob_bytes() const {
+    return shared_meta_->total_blob_bytes();
+  }
+  uint64_t garbage_blob_count() const { return garbage_blob_count_; }
+  uint64_t garbage_blob_bytes() const { return garbage_blob_bytes_; }
+
+ private:
+  std::shared_ptr<SharedBlobFileMetaData> shared_meta_;
+  uint64_t garbage_blob_count_;
+  uint64_t garbage_blob_bytes_;
+};
+
+}  // namespace rocksdb
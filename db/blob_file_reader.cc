@@ -0,0 +1,144 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/blob_file_reader.h"
+
+#include "file/filename.h"
+#include "options/cf_options.h"
+#include "util/file_reader_writer.h"
+#include "utilities/blob_db/blob_log_format.h"
+
+namespace rocksdb {
+
+namespace {
+
+void DeleteBuffer(void* arg1, void* /*arg2*/) {
+  delete[] reinterpret_cast<char*>(arg1);
+}
+
+}  // namespace
+
+Status BlobFileReader::Create(const ImmutableCFOptions& ioptions,
+                              const EnvOptions& env_options,
+                              uint32_t column_family_id,
+                              uint64_t blob_file_number,
+                              std::unique_ptr<BlobFileReader>* reader) {
+  assert(reader != nullptr);
+  assert(!ioptions.cf_paths.empty());
+  const std::string fname =
+      BlobFileName(ioptions.cf_paths.front().path, blob_file_number);
+
+  uint64_t file_size = 0;
+  Status s = ioptions.env->GetFileSize(fname, &file_size);
+  if (!s.ok()) {
+    return s;
+  }
+  if (file_size <
+      blob_db::BlobLogHeader::kSize + blob_db::BlobLogFooter::kSize) {
+    return Status::Corruption("Truncated blob file", fname);
+  }
+
+  std::unique_ptr<RandomAccessFile> file;
+  s = ioptions.env->NewRandomAccessFile(fname, &file, env_options);
+  if (!s.ok()) {
+    return s;
+  }
+  std::unique_ptr<RandomAccessFileReader> file_reader(
+      new RandomAccessFileReader(std::move(file), fname, ioptions.env,
+                                 ioptions.statistics));
+
+  char header_buf[blob_db::BlobLogHeader::kSize];
+  Slice header_slice;
+  s = file_reader->Read(0, blob_db::BlobLogHeader::kSize, &header_slice,
+                        header_buf);
+  if (!s.ok()) {
+    return s;
+  }
+  blob_db::BlobLogHeader header;
+  s = header.DecodeFrom(header_slice);
+  if (!s.ok()) {
+    return s;
+  }
+  if (header.column_family_id != column_family_id) {
+    return Status::Corruption("Blob file of another column family", fname);
+  }
+  if (header.compression != kNoCompression || header.has_ttl) {
+    return Status::NotSupported("Blob file with compression or TTL", fname);
+  }
+
+  reader->reset(new BlobFileReader(std::move(file_reader), file_size));
+  return s;
+}
+
+BlobFileReader::BlobFileReader(
+    std::unique_ptr<RandomAccessFileReader>&& file_reader, uint64_t file_size)
+    : file_reader_(std::move(file_reader)), file_size_(file_size) {}
+
+BlobFileReader::~BlobFileReader() = default;
+
+Status BlobFileReader::GetBlob(const ReadOptions& read_options,
+                               const Slice& user_key, uint64_t offset,
+                               uint64_t value_size,
+                               PinnableSlice* value) const {
+  assert(value != nullptr);
+  const uint64_t key_size = user_key.size();
+  const uint64_t record_header_size = blob_db::BlobLogRecord::kHeaderSize;
+  if (offset < blob_db::BlobLogHeader::kSize + record_header_size + key_size ||
+      offset + value_size > file_size_ - blob_db::BlobLogFooter::kSize) {
+    return Status::Corruption("Invalid blob offset",
+                              file_reader_->file_name());
+  }
+
+  const uint64_t record_offset = offset - key_size - record_header_size;
+  const size_t record_size =
+      static_cast<size_t>(record_header_size + key_size + value_size);
+  std::unique_ptr<char[]> buf(new char[record_size]);
+  Slice record;
+  Status s = file_reader_->Read(record_offset, record_size, &record, buf.get());
+  if (!s.ok()) {
+    return s;
+  }
+  if (record.size() != record_size) {
+    return Status::Corruption("Truncated blob record",
+                              file_reader_->file_name());
+  }
+
+  const Slice record_key(record.data() + record_header_size, key_size);
+  const Slice record_value(record_key.data() + key_size, value_size);
+  if (record_key != user_key) {
+    return Status::Corruption("Blob record of another key",
+                              file_reader_->file_name());
+  }
+  if (read_options.verify_checksums) {
+    blob_db::BlobLogRecord record_header;
+    s = record_header.DecodeHeaderFrom(
+        Slice(record.data(), record_header_size));
+    if (s.ok() && (record_header.key_size != key_size ||
+                   record_header.value_size != value_size)) {
+      s = Status::Corruption("Blob record does not match the blob index",
+                             file_reader_->file_name());
+    }
+    if (s.ok()) {
+      record_header.key = record_key;
+      record_header.value = record_value;
+      s = record_header.CheckBlobCRC();
+    }
+    if (!s.ok()) {
+      return s;
+    }
+  }
+
+  value->Reset();
+  if (record.data() == buf.get()) {
+    // Hand the buffer over instead of copying the value out of it
+    value->PinSlice(record_value, &DeleteBuffer, buf.release(), nullptr);
+  } else {
+    // Memory-mapped reads do not use the buffer
+    value->PinSelf(record_value);
+  }
+  return s;
+}
+
+}  // namespace rocksdb
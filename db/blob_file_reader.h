@@ -0,0 +1,54 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <stdint.h>
+#include <memory>
+
+#include "rocksdb/env.h"
+#include "rocksdb/options.h"
+#include "rocksdb/slice.h"
+#include "rocksdb/status.h"
+
+namespace rocksdb {
+
+struct ImmutableCFOptions;
+class RandomAccessFileReader;
+
+// Reads the values of a blob file written by BlobFileBuilder.
+class BlobFileReader {
+ public:
+  // Opens the blob file `blob_file_number` of the column family and checks
+  // its header.
+  static Status Create(const ImmutableCFOptions& ioptions,
+                       const EnvOptions& env_options,
+                       uint32_t column_family_id, uint64_t blob_file_number,
+                       std::unique_ptr<BlobFileReader>* reader);
+
+  BlobFileReader(const BlobFileReader&) = delete;
+  BlobFileReader& operator=(const BlobFileReader&) = delete;
+
+  ~BlobFileReader();
+
+  // Reads the value of `value_size` bytes at `offset`, which was written for
+  // `user_key`, with a single read of the whole record. The key is always
+  // checked; the CRCs of the record are checked if
+  // ReadOptions::verify_checksums is set.
+  Status GetBlob(const ReadOptions& read_options, const Slice& user_key,
+                 uint64_t offset, uint64_t value_size,
+                 PinnableSlice* value) const;
+
+  uint64_t file_size() const { return file_size_; }
+
+ private:
+  BlobFileReader(std::unique_ptr<RandomAccessFileReader>&& file_reader,
+                 uint64_t file_size);
+
+  std::unique_ptr<RandomAccessFileReader> file_reader_;
+  const uint64_t file_size_;
+};
+
+}  // namespace rocksdb
@@ -0,0 +1,68 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/blob_garbage_meter.h"
+
+#include "db/dbformat.h"
+#include "db/version_edit.h"
+#include "utilities/blob_db/blob_index.h"
+#include "utilities/blob_db/blob_log_format.h"
+
+namespace rocksdb {
+
+bool BlobGarbageMeter::Parse(const Slice& key, const Slice& value,
+                             uint64_t* blob_file_number, uint64_t* bytes) {
+  ParsedInternalKey ikey;
+  if (!ParseInternalKey(key, &ikey) || ikey.type != kTypeBlobIndex ||
+      value.empty()) {
+    return false;
+  }
+  blob_db::BlobIndex blob_index;
+  if (!blob_index.DecodeFrom(value).ok() || blob_index.IsInlined()) {
+    return false;
+  }
+  *blob_file_number = blob_index.file_number();
+  // The size of the record, like BlobFileAddition::total_blob_bytes
+  *bytes = blob_db::BlobLogRecord::kHeaderSize + ikey.user_key.size() +
+           blob_index.size();
+  return true;
+}
+
+void BlobGarbageMeter::ProcessInFlow(const Slice& key, const Slice& value) {
+  uint64_t blob_file_number = 0;
+  uint64_t bytes = 0;
+  if (Parse(key, value, &blob_file_number, &bytes)) {
+    BlobStats& stats = flows_[blob_file_number].in_flow;
+    stats.count++;
+    stats.bytes += bytes;
+  }
+}
+
+void BlobGarbageMeter::ProcessOutFlow(const Slice& key, const Slice& value) {
+  uint64_t blob_file_number = 0;
+  uint64_t bytes = 0;
+  if (Parse(key, value, &blob_file_number, &bytes)) {
+    // Only the files the compaction read from can gain garbage
+    auto it = flows_.find(blob_file_number);
+    if (it != flows_.end()) {
+      it->second.out_flow.count++;
+      it->second.out_flow.bytes += bytes;
+    }
+  }
+}
+
+void BlobGarbageMeter::AddGarbageTo(VersionEdit* edit) const {
+  for (const auto& file_and_flow : flows_) {
+    const BlobInOutFlow& flow = file_and_flow.second;
+    assert(flow.in_flow.count >= flow.out_flow.count);
+    if (flow.in_flow.count > flow.out_flow.count) {
+      edit->AddBlobFileGarbage(file_and_flow.first,
+                               flow.in_flow.count - flow.out_flow.count,
+                               flow.in_flow.bytes - flow.out_flow.bytes);
+    }
+  }
+}
+
+}  // namespace rocksdb
@@ -0,0 +1,143 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <stdint.h>
+#include <map>
+
+#include "db/dbformat.h"
+#include "rocksdb/slice.h"
+#include "table/internal_iterator.h"
+
+namespace rocksdb {
+
+class VersionEdit;
+
+// Measures the blobs that a compaction turns into garbage: the blob indexes
+// it reads from its input files (the inflow) minus the ones it writes to its
+// output files (the outflow), per blob file. Entries that cannot be decoded
+// are not counted either way; they are the compaction's business, not the
+// meter's.
+class BlobGarbageMeter {
+ public:
+  // Counts an input entry, if it is a blob index.
+  void ProcessInFlow(const Slice& key, const Slice& value);
+
+  // Counts an output entry, if it is a blob index.
+  void ProcessOutFlow(const Slice& key, const Slice& value);
+
+  // Records the garbage of each blob file in `edit`.
+  void AddGarbageTo(VersionEdit* edit) const;
+
+ private:
+  struct BlobStats {
+    uint64_t count = 0;
+    uint64_t bytes = 0;
+  };
+
+  struct BlobInOutFlow {
+    BlobStats in_flow;
+    BlobStats out_flow;
+  };
+
+  // Returns false if the entry is not a blob index pointing into a blob file.
+  static bool Parse(const Slice& key, const Slice& value,
+                    uint64_t* blob_file_number, uint64_t* bytes);
+
+  std::map<uint64_t, BlobInOutFlow> flows_;
+};
+
+// Wraps the input iterator of a subcompaction to count its entries as the
+// inflow of a BlobGarbageMeter. Entries with user keys at or past the end of
+// the subcompaction are not counted, since they are not compacted by it.
+// Entries skipped by a forward Seek, as done for a compaction filter's
+// kRemoveAndSkipUntil, are dropped by the compaction and so are counted too.
+class BlobCountingIterator : public InternalIterator {
+ public:
+  BlobCountingIterator(InternalIterator* iter, BlobGarbageMeter* meter,
+                       const InternalKeyComparator* icmp, const Slice* end)
+      : iter_(iter), meter_(meter), icmp_(icmp), end_(end) {}
+
+  bool Valid() const override { return iter_->Valid(); }
+
+  void SeekToFirst() override {
+    iter_->SeekToFirst();
+    UpdateAndCountBlobIfNeeded();
+  }
+
+  void SeekToLast() override {
+    iter_->SeekToLast();
+    UpdateAndCountBlobIfNeeded();
+  }
+
+  void Seek(const Slice& target) override {
+    // On a forward seek, step over the skipped entries rather than seeking
+    // past them, for as long as they belong to this subcompaction
+    if (iter_->Valid() && icmp_->Compare(iter_->key(), target) < 0) {
+      do {
+        Next();
+      } while (iter_->Valid() && !PastEnd() &&
+               icmp_->Compare(iter_->key(), target) < 0);
+      if (!iter_->Valid() || icmp_->Compare(iter_->key(), target) >= 0) {
+        return;
+      }
+    }
+    iter_->Seek(target);
+    UpdateAndCountBlobIfNeeded();
+  }
+
+  void SeekForPrev(const Slice& target) override {
+    iter_->SeekForPrev(target);
+    UpdateAndCountBlobIfNeeded();
+  }
+
+  void Next() override {
+    iter_->Next();
+    UpdateAndCountBlobIfNeeded();
+  }
+
+  void Prev() override {
+    iter_->Prev();
+    UpdateAndCountBlobIfNeeded();
+  }
+
+  Slice key() const override { return iter_->key(); }
+  Slice user_key() const override { return iter_->user_key(); }
+  Slice value() const override { return iter_->value(); }
+
+  Status status() const override { return iter_->status(); }
+
+  bool IsKeyPinned() const override { return iter_->IsKeyPinned(); }
+  bool IsValuePinned() const override { return iter_->IsValuePinned(); }
+
+  void SetPinnedItersMgr(PinnedIteratorsManager* pinned_iters_mgr) override {
+    iter_->SetPinnedItersMgr(pinned_iters_mgr);
+  }
+
+  Status GetProperty(std::string prop_name, std::string* prop) override {
+    return iter_->GetProperty(prop_name, prop);
+  }
+
+ private:
+  bool PastEnd() const {
+    return end_ != nullptr &&
+           icmp_->user_comparator()->Compare(iter_->user_key(), *end_) >= 0;
+  }
+
+  void UpdateAndCountBlobIfNeeded() {
+    if (!iter_->Valid() || PastEnd()) {
+      return;
+    }
+    meter_->ProcessInFlow(iter_->key(), iter_->value());
+  }
+
+  InternalIterator* iter_;
+  BlobGarbageMeter* meter_;
+  const InternalKeyComparator* icmp_;
+  const Slice* end_;
+};
+
+}  // namespace rocksdb
@@ -13,6 +13,7 @@
 #include <deque>
 #include <vector>
 
+#include "db/blob_file_builder.h"
 #include "db/compaction/compaction_iterator.h"
 #include "db/dbformat.h"
 #include "db/event_helpers.h"
@@ -50,7 +51,8 @@ TableBuilder* NewTableBuilder(
     uint64_t sample_for_compression, const CompressionOptions& compression_opts,
     int level, const bool skip_filters, const uint64_t creation_time,
     const uint64_t oldest_key_time, const uint64_t target_file_size,
-    const uint64_t file_creation_time) {
+    const uint64_t file_creation_time,
+    CompressionDictStore* compression_dict_store) {
   assert((column_family_id ==
           TablePropertiesCollectorFactory::Context::kUnknownColumnFamily) ==
          column_family_name.empty());
@@ -60,7 +62,7 @@ TableBuilder* NewTableBuilder(
                           sample_for_compression, compression_opts,
                           skip_filters, column_family_name, level,
                           creation_time, oldest_key_time, target_file_size,
-                          file_creation_time),
+                          file_creation_time, compression_dict_store),
       column_family_id, file);
 }
 
@@ -82,7 +84,9 @@ Status BuildTable(
     TableFileCreationReason reason, EventLogger* event_logger, int job_id,
     const Env::IOPriority io_priority, TableProperties* table_properties,
     int level, const uint64_t creation_time, const uint64_t oldest_key_time,
-    Env::WriteLifeTimeHint write_hint, const uint64_t file_creation_time) {
+    Env::WriteLifeTimeHint write_hint, const uint64_t file_creation_time,
+    CompressionDictStore* compression_dict_store,
+    BlobFileBuilder* blob_file_builder) {
   assert((column_family_id ==
           TablePropertiesCollectorFactory::Context::kUnknownColumnFamily) ==
          column_family_name.empty());
@@ -109,10 +113,14 @@ Status BuildTable(
     TableBuilder* builder;
     std::unique_ptr<WritableFileWriter> file_writer;
     // Currently we only enable dictionary compression during compaction to the
-    // bottommost level.
+    // bottommost level, unless the dictionaries are shared by the files of a
+    // level, so that flushes mostly reuse one instead of building their own.
     CompressionOptions compression_opts_for_flush(compression_opts);
-    compression_opts_for_flush.max_dict_bytes = 0;
-    compression_opts_for_flush.zstd_max_train_bytes = 0;
+    if (compression_opts.shared_dict_files == 0 ||
+        compression_dict_store == nullptr) {
+      compression_opts_for_flush.max_dict_bytes = 0;
+      compression_opts_for_flush.zstd_max_train_bytes = 0;
+    }
     {
       std::unique_ptr<WritableFile> file;
 #ifndef NDEBUG
@@ -138,7 +146,7 @@ Status BuildTable(
           column_family_name, file_writer.get(), compression,
           sample_for_compression, compression_opts_for_flush, level,
           false /* skip_filters */, creation_time, oldest_key_time,
-          0 /*target_file_size*/, file_creation_time);
+          0 /*target_file_size*/, file_creation_time, compression_dict_store);
     }
 
     MergeHelper merge(env, internal_comparator.user_comparator(),
@@ -151,7 +159,10 @@ Status BuildTable(
         iter, internal_comparator.user_comparator(), &merge, kMaxSequenceNumber,
         &snapshots, earliest_write_conflict_snapshot, snapshot_checker, env,
         ShouldReportDetailedTime(env, ioptions.statistics),
-        true /* internal key corruption is not ok */, range_del_agg.get());
+        true /* internal key corruption is not ok */, range_del_agg.get(),
+        nullptr /* compaction */, nullptr /* compaction_filter */,
+        nullptr /* shutting_down */, 0 /* preserve_deletes_seqnum */,
+        nullptr /* snap_list_callback */, blob_file_builder);
     c_iter.SeekToFirst();
     for (; c_iter.Valid(); c_iter.Next()) {
       const Slice& key = c_iter.key();
@@ -238,6 +249,15 @@ Status BuildTable(
     s = iter->status();
   }
 
+  if (blob_file_builder != nullptr) {
+    if (s.ok() && meta->fd.GetFileSize() > 0) {
+      s = blob_file_builder->Finish();
+    }
+    if (!s.ok() || meta->fd.GetFileSize() == 0) {
+      blob_file_builder->Abandon();
+    }
+  }
+
   if (!s.ok() || meta->fd.GetFileSize() == 0) {
     env->DeleteFile(fname);
   }
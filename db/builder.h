@@ -27,6 +27,8 @@ namespace rocksdb {
 struct Options;
 struct FileMetaData;
 
+class BlobFileBuilder;
+class CompressionDictStore;
 class Env;
 struct EnvOptions;
 class Iterator;
@@ -51,7 +53,8 @@ TableBuilder* NewTableBuilder(
     const CompressionOptions& compression_opts, int level,
     const bool skip_filters = false, const uint64_t creation_time = 0,
     const uint64_t oldest_key_time = 0, const uint64_t target_file_size = 0,
-    const uint64_t file_creation_time = 0);
+    const uint64_t file_creation_time = 0,
+    CompressionDictStore* compression_dict_store = nullptr);
 
 // Build a Table file from the contents of *iter.  The generated file
 // will be named according to number specified in meta. On success, the rest of
@@ -61,6 +64,9 @@ TableBuilder* NewTableBuilder(
 //
 // @param column_family_name Name of the column family that is also identified
 //    by column_family_id, or empty string if unknown.
+// @param blob_file_builder If non-nullptr, large values are moved to the blob
+//    files it writes; they are finished with the table file, or deleted if no
+//    table file is produced.
 extern Status BuildTable(
     const std::string& dbname, Env* env, const ImmutableCFOptions& options,
     const MutableCFOptions& mutable_cf_options, const EnvOptions& env_options,
@@ -82,6 +88,8 @@ extern Status BuildTable(
     TableProperties* table_properties = nullptr, int level = -1,
     const uint64_t creation_time = 0, const uint64_t oldest_key_time = 0,
     Env::WriteLifeTimeHint write_hint = Env::WLTH_NOT_SET,
-    const uint64_t file_creation_time = 0);
+    const uint64_t file_creation_time = 0,
+    CompressionDictStore* compression_dict_store = nullptr,
+    BlobFileBuilder* blob_file_builder = nullptr);
 
 }  // namespace rocksdb
@@ -15,8 +15,10 @@
 #include <algorithm>
 #include <limits>
 
+#include "db/blob_file_cache.h"
 #include "db/compaction/compaction_picker.h"
 #include "db/compaction/compaction_picker_fifo.h"
+#include "db/compaction/compaction_picker_hybrid.h"
 #include "db/compaction/compaction_picker_level.h"
 #include "db/compaction/compaction_picker_universal.h"
 #include "db/db_impl/db_impl.h"
@@ -223,6 +225,12 @@ ColumnFamilyOptions SanitizeOptions(const ImmutableDBOptions& db_options,
       db_options.allow_ingest_behind && result.num_levels < 3) {
     result.num_levels = 3;
   }
+  // Hybrid compaction needs at least one tier level between L0 and the
+  // leveled last level.
+  if (result.compaction_style == kCompactionStyleHybrid &&
+      result.num_levels < 3) {
+    result.num_levels = 3;
+  }
 
   if (result.max_write_buffer_number < 2) {
     result.max_write_buffer_number = 2;
@@ -456,6 +464,8 @@ ColumnFamilyData::ColumnFamilyData(
         new InternalStats(ioptions_.num_levels, db_options.env, this));
     table_cache_.reset(new TableCache(ioptions_, env_options, _table_cache,
                                       block_cache_tracer));
+    blob_file_cache_.reset(
+        new BlobFileCache(_table_cache, &ioptions_, env_options, id_));
     if (ioptions_.compaction_style == kCompactionStyleLevel) {
       compaction_picker_.reset(
           new LevelCompactionPicker(ioptions_, &internal_comparator_));
@@ -466,6 +476,9 @@ ColumnFamilyData::ColumnFamilyData(
     } else if (ioptions_.compaction_style == kCompactionStyleFIFO) {
       compaction_picker_.reset(
           new FIFOCompactionPicker(ioptions_, &internal_comparator_));
+    } else if (ioptions_.compaction_style == kCompactionStyleHybrid) {
+      compaction_picker_.reset(
+          new HybridCompactionPicker(ioptions_, &internal_comparator_));
     } else if (ioptions_.compaction_style == kCompactionStyleNone) {
       compaction_picker_.reset(new NullCompactionPicker(
           ioptions_, &internal_comparator_));
@@ -608,7 +621,8 @@ std::unique_ptr<WriteControllerToken> SetupDelay(
   if (auto_comapctions_disabled) {
     // When auto compaction is disabled, always use the value user gave.
     write_rate = max_write_rate;
-  } else if (write_controller->NeedsDelay() && max_write_rate > kMinWriteRate) {
+  } else if (write_controller->NeedsColumnFamilyDelay() &&
+             max_write_rate > kMinWriteRate) {
     // If user gives rate less than kMinWriteRate, don't adjust it.
     //
     // If already delayed, need to adjust based on previous compaction debt.
@@ -743,7 +757,7 @@ WriteStallCondition ColumnFamilyData::RecalculateWriteStallConditions(
     auto write_stall_cause = write_stall_condition_and_cause.second;
 
     bool was_stopped = write_controller->IsStopped();
-    bool needed_delay = write_controller->NeedsDelay();
+    bool needed_delay = write_controller->NeedsColumnFamilyDelay();
 
     if (write_stall_condition == WriteStallCondition::kStopped &&
         write_stall_cause == WriteStallCause::kMemtableLimit) {
@@ -1180,6 +1194,24 @@ Status ColumnFamilyData::ValidateOptions(
     }
   }
 
+  if (cf_options.compaction_style == kCompactionStyleHybrid &&
+      db_options.allow_ingest_behind) {
+    return Status::NotSupported(
+        "Hybrid compaction does not support allow_ingest_behind. ");
+  }
+
+  if (cf_options.enable_blob_files &&
+      cf_options.compaction_style == kCompactionStyleFIFO) {
+    return Status::NotSupported(
+        "Blob files are not supported with FIFO compaction. ");
+  }
+
+  if (cf_options.blob_garbage_collection_age_cutoff < 0.0 ||
+      cf_options.blob_garbage_collection_age_cutoff > 1.0) {
+    return Status::InvalidArgument(
+        "blob_garbage_collection_age_cutoff must be between 0 and 1. ");
+  }
+
   if (cf_options.periodic_compaction_seconds > 0) {
     if (db_options.max_open_files != -1) {
       return Status::NotSupported(
@@ -14,6 +14,7 @@
 #include <vector>
 #include <atomic>
 
+#include "db/compression_dict_store.h"
 #include "db/memtable_list.h"
 #include "db/table_cache.h"
 #include "db/table_properties_collector.h"
@@ -29,6 +30,7 @@
 
 namespace rocksdb {
 
+class BlobFileCache;
 class Version;
 class VersionSet;
 class VersionStorageInfo;
@@ -375,6 +377,11 @@ class ColumnFamilyData {
                          SequenceNumber earliest_seq);
 
   TableCache* table_cache() const { return table_cache_.get(); }
+  BlobFileCache* blob_file_cache() const { return blob_file_cache_.get(); }
+  // Shared compression dictionaries of the levels
+  CompressionDictStore* compression_dict_store() {
+    return &compression_dict_store_;
+  }
 
   // See documentation in compaction_picker.h
   // REQUIRES: DB mutex held
@@ -528,9 +535,12 @@ class ColumnFamilyData {
   const bool is_delete_range_supported_;
 
   std::unique_ptr<TableCache> table_cache_;
+  std::unique_ptr<BlobFileCache> blob_file_cache_;
 
   std::unique_ptr<InternalStats> internal_stats_;
 
+  CompressionDictStore compression_dict_store_;
+
   WriteBufferManager* write_buffer_manager_;
 
   MemTable* mem_;
@@ -245,9 +245,10 @@ Compaction::Compaction(VersionStorageInfo* vstorage,
   if (max_subcompactions_ == 0) {
     max_subcompactions_ = immutable_cf_options_.max_subcompactions;
   }
-  if (!bottommost_level_) {
+  if (!bottommost_level_ && output_compression_opts_.shared_dict_files == 0) {
     // Currently we only enable dictionary compression during compaction to the
-    // bottommost level.
+    // bottommost level, unless the dictionaries are shared by the files of a
+    // level.
     output_compression_opts_.max_dict_bytes = 0;
     output_compression_opts_.zstd_max_train_bytes = 0;
   }
@@ -317,8 +318,9 @@ bool Compaction::IsTrivialMove() const {
 
   // Used in universal compaction, where trivial move can be done if the
   // input files are non overlapping
-  if ((mutable_cf_options_.compaction_options_universal.allow_trivial_move) &&
-      (output_level_ != 0)) {
+  if (immutable_cf_options_.compaction_style != kCompactionStyleHybrid &&
+      mutable_cf_options_.compaction_options_universal.allow_trivial_move &&
+      output_level_ != 0) {
     return is_trivial_move_;
   }
 
@@ -363,7 +365,8 @@ bool Compaction::KeyNotExistsBeyondOutputLevel(
   if (bottommost_level_) {
     return true;
   } else if (output_level_ != 0 &&
-             cfd_->ioptions()->compaction_style == kCompactionStyleLevel) {
+             (cfd_->ioptions()->compaction_style == kCompactionStyleLevel ||
+              cfd_->ioptions()->compaction_style == kCompactionStyleHybrid)) {
     // Maybe use binary search to find right entry instead of linear search?
     const Comparator* user_cmp = cfd_->user_comparator();
     for (int lvl = output_level_ + 1; lvl < number_levels_; lvl++) {
@@ -538,7 +541,8 @@ bool Compaction::ShouldFormSubcompactions() const {
   if (cfd_->ioptions()->compaction_style == kCompactionStyleLevel) {
     return (start_level_ == 0 || is_manual_compaction_) && output_level_ > 0 &&
            !IsOutputLevelEmpty();
-  } else if (cfd_->ioptions()->compaction_style == kCompactionStyleUniversal) {
+  } else if (cfd_->ioptions()->compaction_style == kCompactionStyleUniversal ||
+             cfd_->ioptions()->compaction_style == kCompactionStyleHybrid) {
     return number_levels_ > 1 && output_level_ > 0;
   } else {
     return false;
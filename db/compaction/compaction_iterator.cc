@@ -4,11 +4,17 @@
 //  (found in the LICENSE.Apache file in the root directory).
 
 #include "db/compaction/compaction_iterator.h"
+
+#include <iterator>
+
+#include "db/blob_file_builder.h"
 #include "db/snapshot_checker.h"
+#include "db/version_set.h"
 #include "port/likely.h"
 #include "rocksdb/listener.h"
 #include "table/internal_iterator.h"
 #include "test_util/sync_point.h"
+#include "utilities/blob_db/blob_index.h"
 
 #define DEFINITELY_IN_SNAPSHOT(seq, snapshot)                       \
   ((seq) <= (snapshot) &&                                           \
@@ -38,7 +44,8 @@ CompactionIterator::CompactionIterator(
     const CompactionFilter* compaction_filter,
     const std::atomic<bool>* shutting_down,
     const SequenceNumber preserve_deletes_seqnum,
-    SnapshotListFetchCallback* snap_list_callback)
+    SnapshotListFetchCallback* snap_list_callback,
+    BlobFileBuilder* blob_file_builder, const Slice* end)
     : CompactionIterator(
           input, cmp, merge_helper, last_sequence, snapshots,
           earliest_write_conflict_snapshot, snapshot_checker, env,
@@ -46,7 +53,7 @@ CompactionIterator::CompactionIterator(
           std::unique_ptr<CompactionProxy>(
               compaction ? new CompactionProxy(compaction) : nullptr),
           compaction_filter, shutting_down, preserve_deletes_seqnum,
-          snap_list_callback) {}
+          snap_list_callback, blob_file_builder, end) {}
 
 CompactionIterator::CompactionIterator(
     InternalIterator* input, const Comparator* cmp, MergeHelper* merge_helper,
@@ -59,7 +66,8 @@ CompactionIterator::CompactionIterator(
     const CompactionFilter* compaction_filter,
     const std::atomic<bool>* shutting_down,
     const SequenceNumber preserve_deletes_seqnum,
-    SnapshotListFetchCallback* snap_list_callback)
+    SnapshotListFetchCallback* snap_list_callback,
+    BlobFileBuilder* blob_file_builder, const Slice* end)
     : input_(input),
       cmp_(cmp),
       merge_helper_(merge_helper),
@@ -78,13 +86,36 @@ CompactionIterator::CompactionIterator(
       current_user_key_snapshot_(0),
       merge_out_iter_(merge_helper_),
       current_key_committed_(false),
-      snap_list_callback_(snap_list_callback) {
+      snap_list_callback_(snap_list_callback),
+      blob_file_builder_(blob_file_builder),
+      end_(end) {
   assert(compaction_filter_ == nullptr || compaction_ != nullptr);
   assert(snapshots_ != nullptr);
   bottommost_level_ =
       compaction_ == nullptr ? false : compaction_->bottommost_level();
   if (compaction_ != nullptr) {
     level_ptrs_ = std::vector<size_t>(compaction_->number_levels(), 0);
+    const Version* version = compaction_->input_version();
+    if (version != nullptr &&
+        !version->storage_info()->GetBlobFiles().empty()) {
+      blob_fetcher_.reset(new BlobFetcher(version, ReadOptions()));
+      if (blob_file_builder_ != nullptr &&
+          compaction_->enable_blob_garbage_collection()) {
+        // The blob files are ordered by number, i.e. by age. The oldest
+        // `age_cutoff` of them are garbage collected.
+        const auto& blob_files = version->storage_info()->GetBlobFiles();
+        const size_t cutoff_index = static_cast<size_t>(
+            compaction_->blob_garbage_collection_age_cutoff() *
+            blob_files.size());
+        if (cutoff_index >= blob_files.size()) {
+          blob_garbage_collection_cutoff_file_number_ = port::kMaxUint64;
+        } else if (cutoff_index > 0) {
+          auto it = blob_files.begin();
+          std::advance(it, cutoff_index);
+          blob_garbage_collection_cutoff_file_number_ = it->first;
+        }
+      }
+    }
   }
   ProcessSnapshotList();
   input_->SetPinnedItersMgr(&pinned_iters_mgr_);
@@ -557,8 +588,9 @@ void CompactionIterator::NextFromInput() {
       // have hit (A)
       // We encapsulate the merge related state machine in a different
       // object to minimize change to the existing flow.
-      Status s = merge_helper_->MergeUntil(input_, range_del_agg_,
-                                           prev_snapshot, bottommost_level_);
+      Status s =
+          merge_helper_->MergeUntil(input_, range_del_agg_, prev_snapshot,
+                                    bottommost_level_, blob_fetcher_.get());
       merge_out_iter_.SeekToFirst();
 
       if (!s.ok() && !s.IsMergeInProgress()) {
@@ -614,7 +646,73 @@ void CompactionIterator::NextFromInput() {
   }
 }
 
+void CompactionIterator::ExtractLargeValueIfNeeded() {
+  assert(ikey_.type == kTypeValue);
+  Status s = blob_file_builder_->Add(ikey_.user_key, value_, &blob_index_);
+  if (!s.ok()) {
+    status_ = s;
+    valid_ = false;
+    return;
+  }
+  if (blob_index_.empty()) {
+    return;
+  }
+  value_ = blob_index_;
+  ikey_.type = kTypeBlobIndex;
+  current_key_.UpdateInternalKey(ikey_.sequence, ikey_.type);
+}
+
+void CompactionIterator::GarbageCollectBlobIfNeeded() {
+  assert(ikey_.type == kTypeBlobIndex);
+  if (blob_garbage_collection_cutoff_file_number_ == 0) {
+    return;
+  }
+  blob_db::BlobIndex blob_index;
+  Status s = blob_index.DecodeFrom(value_);
+  if (!s.ok()) {
+    status_ = s;
+    valid_ = false;
+    return;
+  }
+  // Blob indexes of BlobDB are left alone
+  if (blob_index.IsInlined() || blob_index.HasTTL() ||
+      blob_index.file_number() >=
+          blob_garbage_collection_cutoff_file_number_ ||
+      compaction_->input_version()->storage_info()->GetBlobFiles().count(
+          blob_index.file_number()) == 0) {
+    return;
+  }
+
+  blob_value_.Reset();
+  s = blob_fetcher_->FetchBlob(ikey_.user_key, value_, &blob_value_);
+  if (s.ok()) {
+    s = blob_file_builder_->Add(ikey_.user_key, blob_value_, &blob_index_);
+  }
+  if (!s.ok()) {
+    status_ = s;
+    valid_ = false;
+    return;
+  }
+  if (blob_index_.empty()) {
+    // The value is no longer large enough to be kept in a blob file
+    value_ = blob_value_;
+    ikey_.type = kTypeValue;
+    current_key_.UpdateInternalKey(ikey_.sequence, ikey_.type);
+  } else {
+    value_ = blob_index_;
+  }
+}
+
 void CompactionIterator::PrepareOutput() {
+  if (valid_ && blob_file_builder_ != nullptr &&
+      (end_ == nullptr || cmp_->Compare(ikey_.user_key, *end_) < 0)) {
+    if (ikey_.type == kTypeValue) {
+      ExtractLargeValueIfNeeded();
+    } else if (ikey_.type == kTypeBlobIndex) {
+      GarbageCollectBlobIfNeeded();
+    }
+  }
+
   // Zeroing out the sequence number leads to better compression.
   // If this is the bottommost level (no files in lower levels)
   // and the earliest snapshot is larger than this seqno
@@ -10,6 +10,7 @@
 #include <unordered_set>
 #include <vector>
 
+#include "db/blob_fetcher.h"
 #include "db/compaction/compaction.h"
 #include "db/compaction/compaction_iteration_stats.h"
 #include "db/merge_helper.h"
@@ -21,6 +22,8 @@
 
 namespace rocksdb {
 
+class BlobFileBuilder;
+
 // This callback can be used to refresh the snapshot list from the db. It
 // includes logics to exponentially decrease the refresh rate to limit the
 // overhead of refresh.
@@ -99,6 +102,17 @@ class CompactionIterator {
     virtual bool preserve_deletes() const {
       return compaction_->immutable_cf_options()->preserve_deletes;
     }
+    virtual bool enable_blob_garbage_collection() const {
+      return compaction_->immutable_cf_options()
+          ->enable_blob_garbage_collection;
+    }
+    virtual double blob_garbage_collection_age_cutoff() const {
+      return compaction_->immutable_cf_options()
+          ->blob_garbage_collection_age_cutoff;
+    }
+    virtual const Version* input_version() const {
+      return compaction_->input_version();
+    }
 
    protected:
     CompactionProxy() = default;
@@ -118,7 +132,9 @@ class CompactionIterator {
                      const CompactionFilter* compaction_filter = nullptr,
                      const std::atomic<bool>* shutting_down = nullptr,
                      const SequenceNumber preserve_deletes_seqnum = 0,
-                     SnapshotListFetchCallback* snap_list_callback = nullptr);
+                     SnapshotListFetchCallback* snap_list_callback = nullptr,
+                     BlobFileBuilder* blob_file_builder = nullptr,
+                     const Slice* end = nullptr);
 
   // Constructor with custom CompactionProxy, used for tests.
   CompactionIterator(InternalIterator* input, const Comparator* cmp,
@@ -132,7 +148,9 @@ class CompactionIterator {
                      const CompactionFilter* compaction_filter = nullptr,
                      const std::atomic<bool>* shutting_down = nullptr,
                      const SequenceNumber preserve_deletes_seqnum = 0,
-                     SnapshotListFetchCallback* snap_list_callback = nullptr);
+                     SnapshotListFetchCallback* snap_list_callback = nullptr,
+                     BlobFileBuilder* blob_file_builder = nullptr,
+                     const Slice* end = nullptr);
 
   ~CompactionIterator();
 
@@ -163,11 +181,19 @@ class CompactionIterator {
   // Process snapshots_ and assign related variables
   void ProcessSnapshotList();
 
-  // Do last preparations before presenting the output to the callee. At this
-  // point this only zeroes out the sequence number if possible for better
-  // compression.
+  // Do last preparations before presenting the output to the callee: move
+  // large values to blob files, relocate the blobs of old blob files, and
+  // zero out the sequence number if possible for better compression.
   void PrepareOutput();
 
+  // Writes the value of a put to a blob file if it is large enough, and
+  // outputs its blob index instead.
+  void ExtractLargeValueIfNeeded();
+
+  // Rewrites the blob of a blob index into a new blob file if its blob file
+  // is older than the garbage collection cutoff.
+  void GarbageCollectBlobIfNeeded();
+
   // Invoke compaction filter if needed.
   void InvokeFilterIfNeeded(bool* need_skip, Slice* skip_until);
 
@@ -275,6 +301,21 @@ class CompactionIterator {
   // number of distinct keys processed
   size_t num_keys_ = 0;
 
+  // Writes the blob files of a column family with enable_blob_files
+  BlobFileBuilder* blob_file_builder_;
+  // The end (exclusive) of the subcompaction. Keys at or past it are not
+  // written to blob files, since the caller does not output them.
+  const Slice* end_;
+  // Reads the blobs of the input version, if it has blob files
+  std::unique_ptr<BlobFetcher> blob_fetcher_;
+  // Blob files with smaller numbers are garbage collected; 0 if none are
+  uint64_t blob_garbage_collection_cutoff_file_number_ = 0;
+  // The blob index or the blob value that value_ points to, if the output
+  // was changed by ExtractLargeValueIfNeeded() or
+  // GarbageCollectBlobIfNeeded()
+  std::string blob_index_;
+  PinnableSlice blob_value_;
+
   bool IsShuttingDown() {
     // This is a best-effort facility, so memory_order_relaxed is sufficient.
     return shutting_down_ && shutting_down_->load(std::memory_order_relaxed);
@@ -18,6 +18,8 @@
 #include <utility>
 #include <vector>
 
+#include "db/blob_file_builder.h"
+#include "db/blob_garbage_meter.h"
 #include "db/builder.h"
 #include "db/compaction/compaction_job.h"
 #include "db/db_impl/db_impl.h"
@@ -32,6 +34,7 @@
 #include "db/merge_context.h"
 #include "db/merge_helper.h"
 #include "db/range_del_aggregator.h"
+#include "db/table_cache.h"
 #include "db/version_set.h"
 #include "file/filename.h"
 #include "file/sst_file_manager_impl.h"
@@ -126,6 +129,11 @@ struct CompactionJob::SubcompactionState {
   std::vector<Output> outputs;
   std::unique_ptr<WritableFileWriter> outfile;
   std::unique_ptr<TableBuilder> builder;
+  // Writes the blob files of the subcompaction, if enable_blob_files is set
+  std::unique_ptr<BlobFileBuilder> blob_file_builder;
+  // Measures the blob garbage of the subcompaction, if its input version
+  // has blob files
+  std::unique_ptr<BlobGarbageMeter> blob_garbage_meter;
   Output* current_output() {
     if (outputs.empty()) {
       // This subcompaction's outptut could be empty if compaction was aborted
@@ -183,6 +191,8 @@ struct CompactionJob::SubcompactionState {
     outputs = std::move(o.outputs);
     outfile = std::move(o.outfile);
     builder = std::move(o.builder);
+    blob_file_builder = std::move(o.blob_file_builder);
+    blob_garbage_meter = std::move(o.blob_garbage_meter);
     current_output_file_size = std::move(o.current_output_file_size);
     total_bytes = std::move(o.total_bytes);
     num_input_records = std::move(o.num_input_records);
@@ -295,6 +305,16 @@ void CompactionJob::AggregateStatistics() {
     for (SubcompactionState& sc : compact_->sub_compact_states) {
       compaction_job_stats_->Add(sc.compaction_job_stats);
     }
+    const auto& elapsed = compaction_job_stats_->subcompaction_elapsed_micros;
+    uint64_t total_micros = 0;
+    uint64_t max_micros = 0;
+    for (uint64_t micros : elapsed) {
+      total_micros += micros;
+      max_micros = std::max(max_micros, micros);
+    }
+    compaction_job_stats_->subcompaction_skew =
+        total_micros > 0 ? max_micros * 1.0 * elapsed.size() / total_micros
+                         : 1.0;
   }
 }
 
@@ -439,8 +459,26 @@ struct RangeWithSize {
       : range(a, b), size(s) {}
 };
 
+// Returns the number of output files a compaction of input_size bytes is
+// expected to need, which caps the number of useful subcompactions.
+static uint64_t MaxOutputFilesForCompaction(Compaction* c,
+                                            uint64_t input_size) {
+  const double min_file_fill_percent = 4.0 / 5;
+  int base_level = c->input_version()->storage_info()->base_level();
+  return static_cast<uint64_t>(std::ceil(
+      input_size / min_file_fill_percent /
+      MaxFileSizeForLevel(*(c->mutable_cf_options()), c->output_level(),
+          c->immutable_cf_options()->compaction_style, base_level,
+          c->immutable_cf_options()->level_compaction_dynamic_level_bytes)));
+}
+
 void CompactionJob::GenSubcompactionBoundaries() {
   auto* c = compact_->compaction;
+  if (c->immutable_cf_options()->compaction_style ==
+      kCompactionStyleUniversal) {
+    GenSubcompactionBoundariesFromAnchors();
+    return;
+  }
   auto* cfd = c->column_family_data();
   const Comparator* cfd_comparator = cfd->user_comparator();
   std::vector<Slice> bounds;
@@ -529,13 +567,7 @@ void CompactionJob::GenSubcompactionBoundaries() {
   }
 
   // Group the ranges into subcompactions
-  const double min_file_fill_percent = 4.0 / 5;
-  int base_level = v->storage_info()->base_level();
-  uint64_t max_output_files = static_cast<uint64_t>(std::ceil(
-      sum / min_file_fill_percent /
-      MaxFileSizeForLevel(*(c->mutable_cf_options()), out_lvl,
-          c->immutable_cf_options()->compaction_style, base_level,
-          c->immutable_cf_options()->level_compaction_dynamic_level_bytes)));
+  uint64_t max_output_files = MaxOutputFilesForCompaction(c, sum);
   uint64_t subcompactions =
       std::min({static_cast<uint64_t>(ranges.size()),
                 static_cast<uint64_t>(c->max_subcompactions()),
@@ -567,6 +599,89 @@ void CompactionJob::GenSubcompactionBoundaries() {
   }
 }
 
+void CompactionJob::GenSubcompactionBoundariesFromAnchors() {
+  // Enough anchors per file for the boundaries to land close to the mean
+  // subcompaction size, even if there is just one input file
+  const size_t kMaxAnchorsPerFile = 128;
+
+  auto* c = compact_->compaction;
+  auto* cfd = c->column_family_data();
+  const Comparator* cfd_comparator = cfd->user_comparator();
+
+  std::vector<const FileMetaData*> files;
+  for (size_t lvl_idx = 0; lvl_idx < c->num_input_levels(); lvl_idx++) {
+    for (const FileMetaData* f : *c->inputs(lvl_idx)) {
+      files.push_back(f);
+    }
+  }
+
+  // Sampling the anchors may have to open the table readers and read the
+  // index blocks. The input files are pinned by the input version, so the
+  // db mutex can be released to reduce contention.
+  std::vector<TableReader::Anchor> anchors;
+  uint64_t sum = 0;
+  db_mutex_->Unlock();
+  for (const FileMetaData* f : files) {
+    std::vector<TableReader::Anchor> file_anchors;
+    Status s = cfd->table_cache()->ApproximateKeyAnchors(
+        ReadOptions(), cfd->internal_comparator(), f->fd, kMaxAnchorsPerFile,
+        &file_anchors);
+    if (!s.ok() || file_anchors.empty()) {
+      // Fall back to treating the whole file as one range
+      file_anchors.clear();
+      file_anchors.emplace_back(f->largest.user_key(), f->fd.GetFileSize());
+    }
+    for (auto& anchor : file_anchors) {
+      sum += anchor.range_size;
+      anchors.push_back(std::move(anchor));
+    }
+  }
+  db_mutex_->Lock();
+
+  std::sort(anchors.begin(), anchors.end(),
+            [cfd_comparator](const TableReader::Anchor& a,
+                             const TableReader::Anchor& b) -> bool {
+              return cfd_comparator->Compare(a.user_key, b.user_key) < 0;
+            });
+
+  uint64_t subcompactions =
+      std::min({static_cast<uint64_t>(anchors.size()),
+                static_cast<uint64_t>(c->max_subcompactions()),
+                MaxOutputFilesForCompaction(c, sum)});
+  if (subcompactions <= 1) {
+    sizes_.emplace_back(sum);
+    return;
+  }
+
+  // Greedily close a subcompaction at the first anchor where its size
+  // reaches the expected mean. The last anchor is never used as a boundary
+  // since it would leave the last subcompaction with nothing to do.
+  const double mean = sum * 1.0 / subcompactions;
+  uint64_t range_sum = 0;
+  for (size_t i = 0; i + 1 < anchors.size() && subcompactions > 1; i++) {
+    range_sum += anchors[i].range_size;
+    if (range_sum < mean) {
+      continue;
+    }
+    if (!boundary_keys_.empty() &&
+        cfd_comparator->Compare(anchors[i].user_key, boundary_keys_.back()) <=
+            0) {
+      // Anchors of different files can share a key
+      continue;
+    }
+    boundary_keys_.push_back(anchors[i].user_key);
+    sizes_.emplace_back(range_sum);
+    subcompactions--;
+    sum -= range_sum;
+    range_sum = 0;
+  }
+  sizes_.emplace_back(sum);
+
+  for (const auto& key : boundary_keys_) {
+    boundaries_.emplace_back(key);
+  }
+}
+
 Status CompactionJob::Run() {
   AutoThreadOperationStageUpdater stage_updater(
       ThreadStatus::STAGE_COMPACTION_RUN);
@@ -783,6 +898,17 @@ Status CompactionJob::Install(const MutableCFOptions& mutable_cf_options) {
            << compaction_job_stats_->num_single_del_mismatch;
     stream << "num_single_delete_fallthrough"
            << compaction_job_stats_->num_single_del_fallthru;
+    if (compact_->sub_compact_states.size() > 1) {
+      stream << "subcompaction_input_records";
+      stream.StartArray();
+      for (uint64_t records :
+           compaction_job_stats_->subcompaction_input_records) {
+        stream << records;
+      }
+      stream.EndArray();
+      stream << "subcompaction_skew"
+             << compaction_job_stats_->subcompaction_skew;
+    }
   }
 
   if (measure_io_stats_ && compaction_job_stats_ != nullptr) {
@@ -809,6 +935,7 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
   assert(sub_compact != nullptr);
 
   uint64_t prev_cpu_micros = env_->NowCPUNanos() / 1000;
+  const uint64_t start_micros = env_->NowMicros();
 
   ColumnFamilyData* cfd = sub_compact->compaction->column_family_data();
 
@@ -872,23 +999,45 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
 
   Slice* start = sub_compact->start;
   Slice* end = sub_compact->end;
+
+  // Count the blob indexes read, to find the blobs the compaction turns into
+  // garbage
+  std::unique_ptr<InternalIterator> blob_counting_iter;
+  InternalIterator* input_iter = input.get();
+  if (!sub_compact->compaction->input_version()
+           ->storage_info()
+           ->GetBlobFiles()
+           .empty()) {
+    sub_compact->blob_garbage_meter.reset(new BlobGarbageMeter());
+    blob_counting_iter.reset(new BlobCountingIterator(
+        input_iter, sub_compact->blob_garbage_meter.get(),
+        &cfd->internal_comparator(), end));
+    input_iter = blob_counting_iter.get();
+  }
+  if (cfd->ioptions()->enable_blob_files) {
+    sub_compact->blob_file_builder.reset(new BlobFileBuilder(
+        versions_, env_, env_options_, cfd->ioptions(), cfd->GetID(),
+        Env::IO_LOW, write_hint_));
+  }
+
   if (start != nullptr) {
     IterKey start_iter;
     start_iter.SetInternalKey(*start, kMaxSequenceNumber, kValueTypeForSeek);
-    input->Seek(start_iter.GetInternalKey());
+    input_iter->Seek(start_iter.GetInternalKey());
   } else {
-    input->SeekToFirst();
+    input_iter->SeekToFirst();
   }
 
   Status status;
   sub_compact->c_iter.reset(new CompactionIterator(
-      input.get(), cfd->user_comparator(), &merge, versions_->LastSequence(),
+      input_iter, cfd->user_comparator(), &merge, versions_->LastSequence(),
       &existing_snapshots_, earliest_write_conflict_snapshot_,
       snapshot_checker_, env_, ShouldReportDetailedTime(env_, stats_), false,
       &range_del_agg, sub_compact->compaction, compaction_filter,
       shutting_down_, preserve_deletes_seqnum_,
       // Currently range_del_agg is incompatible with snapshot refresh feature.
-      range_del_agg.IsEmpty() ? snap_list_callback_ : nullptr));
+      range_del_agg.IsEmpty() ? snap_list_callback_ : nullptr,
+      sub_compact->blob_file_builder.get(), end));
   auto c_iter = sub_compact->c_iter.get();
   c_iter->SeekToFirst();
   if (c_iter->Valid() && sub_compact->compaction->output_level() != 0) {
@@ -933,6 +1082,9 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
     sub_compact->current_output()->meta.UpdateBoundaries(
         key, c_iter->ikey().sequence);
     sub_compact->num_output_records++;
+    if (sub_compact->blob_garbage_meter != nullptr) {
+      sub_compact->blob_garbage_meter->ProcessOutFlow(key, value);
+    }
 
     // Close output file if it is big enough. Two possibilities determine it's
     // time to close it: (1) the current key should be this file's last key, (2)
@@ -949,7 +1101,7 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
             sub_compact->compaction->max_output_file_size()) {
       // (1) this key terminates the file. For historical reasons, the iterator
       // status before advancing will be given to FinishCompactionOutputFile().
-      input_status = input->status();
+      input_status = input_iter->status();
       output_file_ended = true;
     }
     c_iter->Next();
@@ -961,7 +1113,7 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
       // (2) this key belongs to the next file. For historical reasons, the
       // iterator status after advancing will be given to
       // FinishCompactionOutputFile().
-      input_status = input->status();
+      input_status = input_iter->status();
       output_file_ended = true;
     }
     if (output_file_ended) {
@@ -1006,7 +1158,7 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
     status = Status::ShutdownInProgress("Database shutdown");
   }
   if (status.ok()) {
-    status = input->status();
+    status = input_iter->status();
   }
   if (status.ok()) {
     status = c_iter->status();
@@ -1030,8 +1182,21 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
     RecordDroppedKeys(range_del_out_stats, &sub_compact->compaction_job_stats);
   }
 
+  if (sub_compact->blob_file_builder != nullptr) {
+    if (status.ok()) {
+      status = sub_compact->blob_file_builder->Finish();
+    }
+    if (!status.ok()) {
+      sub_compact->blob_file_builder->Abandon();
+    }
+  }
+
   sub_compact->compaction_job_stats.cpu_micros =
       env_->NowCPUNanos() / 1000 - prev_cpu_micros;
+  sub_compact->compaction_job_stats.subcompaction_input_records.push_back(
+      sub_compact->num_input_records);
+  sub_compact->compaction_job_stats.subcompaction_elapsed_micros.push_back(
+      env_->NowMicros() - start_micros);
 
   if (measure_io_stats_) {
     sub_compact->compaction_job_stats.file_write_nanos +=
@@ -1052,6 +1217,7 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
   }
 
   sub_compact->c_iter.reset();
+  blob_counting_iter.reset();
   input.reset();
   sub_compact->status = status;
 }
@@ -1403,6 +1569,17 @@ Status CompactionJob::InstallCompactionResults(
     for (const auto& out : sub_compact.outputs) {
       compaction->edit()->AddFile(compaction->output_level(), out.meta);
     }
+    if (sub_compact.blob_file_builder != nullptr) {
+      for (const auto& blob_file :
+           sub_compact.blob_file_builder->GetBlobFileAdditions()) {
+        compaction->edit()->AddBlobFile(blob_file.blob_file_number,
+                                        blob_file.total_blob_count,
+                                        blob_file.total_blob_bytes);
+      }
+    }
+    if (sub_compact.blob_garbage_meter != nullptr) {
+      sub_compact.blob_garbage_meter->AddGarbageTo(compaction->edit());
+    }
   }
   return versions_->LogAndApply(compaction->column_family_data(),
                                 mutable_cf_options, compaction->edit(),
@@ -1506,7 +1683,7 @@ Status CompactionJob::OpenCompactionOutputFile(
       sub_compact->compaction->output_compression_opts(),
       sub_compact->compaction->output_level(), skip_filters, latest_key_time,
       0 /* oldest_key_time */, sub_compact->compaction->max_output_file_size(),
-      current_time));
+      current_time, cfd->compression_dict_store()));
   LogFlush(db_options_.info_log);
   return s;
 }
@@ -1575,6 +1752,10 @@ void CompactionJob::UpdateCompactionStats() {
     for (const auto& out : sub_compact.outputs) {
       compaction_stats_.bytes_written += out.meta.fd.file_size;
     }
+    if (sub_compact.blob_file_builder != nullptr) {
+      compaction_stats_.bytes_written +=
+          sub_compact.blob_file_builder->bytes_written();
+    }
     if (sub_compact.num_input_records > sub_compact.num_output_records) {
       compaction_stats_.num_dropped_records +=
           sub_compact.num_input_records - sub_compact.num_output_records;
@@ -116,6 +116,13 @@ class CompactionJob {
   // consecutive groups such that each group has a similar size.
   void GenSubcompactionBoundaries();
 
+  // Like GenSubcompactionBoundaries(), but the candidate boundaries are key
+  // anchors sampled from the index of every input file instead of the file
+  // boundaries, so a compaction of a few large sorted runs (as picked by
+  // universal compaction) can still be split into evenly sized
+  // subcompactions.
+  void GenSubcompactionBoundariesFromAnchors();
+
   // update the thread status for starting a compaction.
   void ReportStartedCompaction(Compaction* compaction);
   void AllocateCompactionOutputFileNumbers();
@@ -192,6 +199,8 @@ class CompactionJob {
   bool measure_io_stats_;
   // Stores the Slices that designate the boundaries for each subcompaction
   std::vector<Slice> boundaries_;
+  // Backs the boundaries_ that do not point into the input file metadata
+  std::vector<std::string> boundary_keys_;
   // Stores the approx size of keys covered in the range of each subcompaction
   std::vector<uint64_t> sizes_;
   Env::WriteLifeTimeHint write_hint_;
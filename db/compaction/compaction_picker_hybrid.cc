@@ -0,0 +1,283 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+//
+// Copyright (c) 2011 The LevelDB Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file. See the AUTHORS file for names of contributors.
+
+#include "db/compaction/compaction_picker_hybrid.h"
+#ifndef ROCKSDB_LITE
+
+#include <algorithm>
+#include <cinttypes>
+#include <string>
+#include <vector>
+#include "db/column_family.h"
+#include "logging/log_buffer.h"
+#include "monitoring/statistics.h"
+#include "test_util/sync_point.h"
+
+namespace rocksdb {
+
+bool HybridCompactionPicker::NeedsCompaction(
+    const VersionStorageInfo* vstorage) const {
+  for (int i = 0; i <= vstorage->MaxInputLevel(); i++) {
+    if (vstorage->CompactionScore(i) >= 1) {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::vector<HybridCompactionPicker::SortedRun>
+HybridCompactionPicker::CalculateSortedRuns(
+    const VersionStorageInfo& vstorage) {
+  std::vector<SortedRun> ret;
+  for (FileMetaData* f : vstorage.LevelFiles(0)) {
+    ret.emplace_back(0, f, f->fd.GetFileSize(), f->being_compacted);
+  }
+  for (int level = 1; level < vstorage.num_levels() - 1; level++) {
+    uint64_t total_size = 0U;
+    bool being_compacted = false;
+    for (FileMetaData* f : vstorage.LevelFiles(level)) {
+      total_size += f->fd.GetFileSize();
+      being_compacted = being_compacted || f->being_compacted;
+    }
+    if (total_size > 0) {
+      ret.emplace_back(level, nullptr, total_size, being_compacted);
+    }
+  }
+  return ret;
+}
+
+Compaction* HybridCompactionPicker::PickCompaction(
+    const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
+    VersionStorageInfo* vstorage, LogBuffer* log_buffer) {
+  const int last_tier_level = vstorage->num_levels() - 2;
+  Compaction* c = nullptr;
+  for (int i = 0; i <= vstorage->MaxInputLevel() && c == nullptr; i++) {
+    const double score = vstorage->CompactionScore(i);
+    if (score < 1) {
+      break;
+    }
+    const int level = vstorage->CompactionScoreLevel(i);
+    if (level == 0) {
+      c = PickTieredCompaction(cf_name, mutable_cf_options, vstorage, score,
+                               log_buffer);
+    } else if (level == last_tier_level) {
+      c = PickLastLevelCompaction(cf_name, mutable_cf_options, vstorage, score,
+                                  log_buffer);
+    }
+  }
+
+  if (c == nullptr) {
+    TEST_SYNC_POINT_CALLBACK("HybridCompactionPicker::PickCompaction:Return",
+                             nullptr);
+    return nullptr;
+  }
+
+  RecordInHistogram(ioptions_.statistics, NUM_FILES_IN_SINGLE_COMPACTION,
+                    c->inputs(0)->size());
+
+  RegisterCompaction(c);
+  vstorage->ComputeCompactionScore(ioptions_, mutable_cf_options);
+
+  TEST_SYNC_POINT_CALLBACK("HybridCompactionPicker::PickCompaction:Return",
+                           c);
+  return c;
+}
+
+Compaction* HybridCompactionPicker::PickTieredCompaction(
+    const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
+    VersionStorageInfo* vstorage, double score, LogBuffer* log_buffer) {
+  const std::vector<SortedRun> sorted_runs = CalculateSortedRuns(*vstorage);
+  const unsigned int ratio =
+      mutable_cf_options.compaction_options_universal.size_ratio;
+  const size_t min_merge_width = std::max(
+      2U, mutable_cf_options.compaction_options_universal.min_merge_width);
+  const size_t max_merge_width = std::max<size_t>(
+      min_merge_width,
+      mutable_cf_options.compaction_options_universal.max_merge_width);
+
+  // First look for adjacent runs of similar size, as universal compaction
+  // does for its size ratio trigger.
+  size_t start_index = 0;
+  size_t candidate_count = 0;
+  CompactionReason compaction_reason = CompactionReason::kUniversalSizeRatio;
+  for (size_t loop = 0; loop < sorted_runs.size(); loop++) {
+    if (sorted_runs[loop].being_compacted) {
+      continue;
+    }
+    uint64_t candidate_size = sorted_runs[loop].size;
+    size_t count = 1;
+    for (size_t i = loop + 1;
+         i < sorted_runs.size() && count < max_merge_width; i++) {
+      const SortedRun& succeeding_sr = sorted_runs[i];
+      if (succeeding_sr.being_compacted) {
+        break;
+      }
+      const double sz = candidate_size * (100.0 + ratio) / 100.0;
+      if (sz < static_cast<double>(succeeding_sr.size)) {
+        break;
+      }
+      candidate_size += succeeding_sr.size;
+      count++;
+    }
+    if (count >= min_merge_width) {
+      start_index = loop;
+      candidate_count = count;
+      break;
+    }
+  }
+
+  // Otherwise merge the newest runs until we are back under the trigger.
+  if (candidate_count == 0) {
+    const size_t trigger = static_cast<size_t>(
+        std::max(1, mutable_cf_options.level0_file_num_compaction_trigger));
+    if (sorted_runs.size() < trigger) {
+      return nullptr;
+    }
+    const size_t num_to_merge =
+        std::max<size_t>(2, sorted_runs.size() - trigger + 1);
+    for (size_t loop = 0; loop < sorted_runs.size(); loop++) {
+      if (sorted_runs[loop].being_compacted) {
+        continue;
+      }
+      size_t count = 0;
+      while (loop + count < sorted_runs.size() && count < num_to_merge &&
+             !sorted_runs[loop + count].being_compacted) {
+        count++;
+      }
+      if (count >= 2) {
+        start_index = loop;
+        candidate_count = count;
+        compaction_reason = CompactionReason::kUniversalSortedRunNum;
+        break;
+      }
+      loop += count;
+    }
+    if (candidate_count == 0) {
+      return nullptr;
+    }
+  }
+
+  // The output goes just above the next older run so that newer data always
+  // stays in a lower level than older data.
+  const size_t first_index_after = start_index + candidate_count;
+  int output_level;
+  if (first_index_after == sorted_runs.size()) {
+    output_level = vstorage->num_levels() - 2;
+  } else if (sorted_runs[first_index_after].level == 0) {
+    output_level = 0;
+  } else {
+    output_level = sorted_runs[first_index_after].level - 1;
+  }
+
+  const int start_level = sorted_runs[start_index].level;
+  std::vector<CompactionInputFiles> inputs(output_level - start_level + 1);
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    inputs[i].level = start_level + static_cast<int>(i);
+  }
+  uint64_t input_size = 0;
+  for (size_t i = start_index; i < first_index_after; i++) {
+    const SortedRun& sr = sorted_runs[i];
+    input_size += sr.size;
+    if (sr.level == 0) {
+      inputs[0].files.push_back(sr.file);
+    } else {
+      auto& files = inputs[sr.level - start_level].files;
+      for (FileMetaData* f : vstorage->LevelFiles(sr.level)) {
+        files.push_back(f);
+      }
+    }
+  }
+
+  ROCKS_LOG_BUFFER(log_buffer,
+                   "[%s] Hybrid: merging %" ROCKSDB_PRIszt
+                   " sorted runs (%" PRIu64 " bytes) into level %d\n",
+                   cf_name.c_str(), candidate_count, input_size, output_level);
+
+  return new Compaction(
+      vstorage, ioptions_, mutable_cf_options, std::move(inputs), output_level,
+      MaxFileSizeForLevel(mutable_cf_options, output_level,
+                          ioptions_.compaction_style),
+      LLONG_MAX, /* output_path_id */ 0,
+      GetCompressionType(ioptions_, vstorage, mutable_cf_options, output_level,
+                         1),
+      GetCompressionOptions(ioptions_, vstorage, output_level),
+      /* max_subcompactions */ 0, /* grandparents */ {},
+      /* is manual */ false, score, false /* deletion_compaction */,
+      compaction_reason);
+}
+
+Compaction* HybridCompactionPicker::PickLastLevelCompaction(
+    const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
+    VersionStorageInfo* vstorage, double score, LogBuffer* log_buffer) {
+  const int start_level = vstorage->num_levels() - 2;
+  const int output_level = vstorage->num_levels() - 1;
+
+  CompactionInputFiles start_level_inputs;
+  start_level_inputs.level = start_level;
+  CompactionInputFiles output_level_inputs;
+  output_level_inputs.level = output_level;
+
+  const std::vector<int>& file_order =
+      vstorage->FilesByCompactionPri(start_level);
+  const std::vector<FileMetaData*>& level_files =
+      vstorage->LevelFiles(start_level);
+  bool found = false;
+  for (int index : file_order) {
+    FileMetaData* f = level_files[index];
+    if (f->being_compacted) {
+      continue;
+    }
+    start_level_inputs.files.assign(1, f);
+    if (!ExpandInputsToCleanCut(cf_name, vstorage, &start_level_inputs) ||
+        FilesRangeOverlapWithCompaction({start_level_inputs}, output_level)) {
+      continue;
+    }
+    int parent_index = -1;
+    output_level_inputs.clear();
+    if (!SetupOtherInputs(cf_name, mutable_cf_options, vstorage,
+                          &start_level_inputs, &output_level_inputs,
+                          &parent_index, index)) {
+      continue;
+    }
+    found = true;
+    break;
+  }
+  if (!found) {
+    return nullptr;
+  }
+
+  std::vector<CompactionInputFiles> inputs;
+  inputs.push_back(start_level_inputs);
+  if (!output_level_inputs.empty()) {
+    inputs.push_back(output_level_inputs);
+  }
+
+  ROCKS_LOG_BUFFER(log_buffer,
+                   "[%s] Hybrid: draining %" ROCKSDB_PRIszt
+                   " files from level %d into %" ROCKSDB_PRIszt
+                   " files of the last level\n",
+                   cf_name.c_str(), start_level_inputs.size(), start_level,
+                   output_level_inputs.size());
+
+  return new Compaction(
+      vstorage, ioptions_, mutable_cf_options, std::move(inputs), output_level,
+      MaxFileSizeForLevel(mutable_cf_options, output_level,
+                          ioptions_.compaction_style),
+      mutable_cf_options.max_compaction_bytes, /* output_path_id */ 0,
+      GetCompressionType(ioptions_, vstorage, mutable_cf_options, output_level,
+                         1),
+      GetCompressionOptions(ioptions_, vstorage, output_level),
+      /* max_subcompactions */ 0, /* grandparents */ {},
+      /* is manual */ false, score, false /* deletion_compaction */,
+      CompactionReason::kLevelMaxLevelSize);
+}
+
+}  // namespace rocksdb
+
+#endif  // !ROCKSDB_LITE
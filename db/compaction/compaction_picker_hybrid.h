@@ -0,0 +1,73 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+//
+// Copyright (c) 2011 The LevelDB Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file. See the AUTHORS file for names of contributors.
+
+#pragma once
+#ifndef ROCKSDB_LITE
+
+#include <string>
+#include <vector>
+
+#include "db/compaction/compaction_picker.h"
+
+namespace rocksdb {
+// Picks compactions for kCompactionStyleHybrid. L0 files and levels
+// 1..num_levels-2 each form one sorted run and are merged size-tiered,
+// oldest tier landing in num_levels-2. The last level is leveled: the oldest
+// tier is drained into it file by file once it is large enough relative to
+// the last level, as controlled by hybrid_target_write_amplification.
+class HybridCompactionPicker : public CompactionPicker {
+ public:
+  HybridCompactionPicker(const ImmutableCFOptions& ioptions,
+                         const InternalKeyComparator* icmp)
+      : CompactionPicker(ioptions, icmp) {}
+
+  virtual Compaction* PickCompaction(const std::string& cf_name,
+                                     const MutableCFOptions& mutable_cf_options,
+                                     VersionStorageInfo* vstorage,
+                                     LogBuffer* log_buffer) override;
+
+  virtual bool NeedsCompaction(
+      const VersionStorageInfo* vstorage) const override;
+
+ private:
+  struct SortedRun {
+    SortedRun(int _level, FileMetaData* _file, uint64_t _size,
+              bool _being_compacted)
+        : level(_level),
+          file(_file),
+          size(_size),
+          being_compacted(_being_compacted) {}
+
+    // Level of the run; 0 means `file` is a single L0 file.
+    int level;
+    FileMetaData* file;
+    uint64_t size;
+    bool being_compacted;
+  };
+
+  // Returns the tiered sorted runs, newest first. The last level is not
+  // included.
+  static std::vector<SortedRun> CalculateSortedRuns(
+      const VersionStorageInfo& vstorage);
+
+  // Merges adjacent sorted runs of similar size, or the newest runs if there
+  // are more than level0_file_num_compaction_trigger of them.
+  Compaction* PickTieredCompaction(const std::string& cf_name,
+                                   const MutableCFOptions& mutable_cf_options,
+                                   VersionStorageInfo* vstorage, double score,
+                                   LogBuffer* log_buffer);
+
+  // Moves one file of the oldest tier, plus whatever it overlaps, into the
+  // last level.
+  Compaction* PickLastLevelCompaction(
+      const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
+      VersionStorageInfo* vstorage, double score, LogBuffer* log_buffer);
+};
+}  // namespace rocksdb
+#endif  // !ROCKSDB_LITE
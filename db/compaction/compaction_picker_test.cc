@@ -9,6 +9,7 @@
 #include <utility>
 #include "db/compaction/compaction.h"
 #include "db/compaction/compaction_picker_fifo.h"
+#include "db/compaction/compaction_picker_hybrid.h"
 #include "db/compaction/compaction_picker_level.h"
 #include "db/compaction/compaction_picker_universal.h"
 
@@ -529,6 +530,107 @@ TEST_F(CompactionPickerTest, NeedsCompactionFIFO) {
               vstorage_->CompactionScore(0) >= 1);
   }
 }
+
+TEST_F(CompactionPickerTest, HybridMergesSimilarTiers) {
+  const uint64_t kFileSize = 100000;
+  ioptions_.compaction_style = kCompactionStyleHybrid;
+  HybridCompactionPicker hybrid_compaction_picker(ioptions_, &icmp_);
+
+  NewVersionStorage(4, kCompactionStyleHybrid);
+  Add(0, 1U, "150", "200", kFileSize, 0, 500, 550);
+  Add(0, 2U, "201", "250", kFileSize, 0, 401, 450);
+  Add(0, 3U, "100", "300", kFileSize, 0, 301, 350);
+  Add(1, 4U, "100", "300", kFileSize, 0, 201, 250);
+  Add(3, 5U, "100", "300", kFileSize * 100, 0, 10, 100);
+  UpdateVersionStorageInfo();
+
+  ASSERT_TRUE(hybrid_compaction_picker.NeedsCompaction(vstorage_.get()));
+  std::unique_ptr<Compaction> compaction(
+      hybrid_compaction_picker.PickCompaction(
+          cf_name_, mutable_cf_options_, vstorage_.get(), &log_buffer_));
+  ASSERT_TRUE(compaction.get() != nullptr);
+  // All the tiers are merged into the level above the last one, which is
+  // left alone.
+  ASSERT_EQ(2, compaction->output_level());
+  ASSERT_EQ(3U, compaction->num_input_levels());
+  ASSERT_EQ(3U, compaction->num_input_files(0));
+  ASSERT_EQ(1U, compaction->num_input_files(1));
+  ASSERT_EQ(0U, compaction->num_input_files(2));
+  ASSERT_EQ(CompactionReason::kUniversalSizeRatio,
+            compaction->compaction_reason());
+}
+
+TEST_F(CompactionPickerTest, HybridMergeStaysAboveOlderTier) {
+  const uint64_t kFileSize = 100000;
+  mutable_cf_options_.level0_file_num_compaction_trigger = 2;
+  ioptions_.compaction_style = kCompactionStyleHybrid;
+  HybridCompactionPicker hybrid_compaction_picker(ioptions_, &icmp_);
+
+  NewVersionStorage(5, kCompactionStyleHybrid);
+  Add(0, 1U, "150", "200", kFileSize, 0, 500, 550);
+  Add(0, 2U, "201", "250", kFileSize, 0, 401, 450);
+  Add(2, 3U, "100", "300", kFileSize * 10, 0, 201, 250);
+  Add(4, 4U, "100", "300", kFileSize * 1000, 0, 10, 100);
+  UpdateVersionStorageInfo();
+
+  std::unique_ptr<Compaction> compaction(
+      hybrid_compaction_picker.PickCompaction(
+          cf_name_, mutable_cf_options_, vstorage_.get(), &log_buffer_));
+  ASSERT_TRUE(compaction.get() != nullptr);
+  ASSERT_EQ(0, compaction->start_level());
+  ASSERT_EQ(1, compaction->output_level());
+  ASSERT_EQ(2U, compaction->num_input_files(0));
+  ASSERT_EQ(0U, compaction->num_input_files(1));
+}
+
+TEST_F(CompactionPickerTest, HybridDrainsIntoLastLevel) {
+  const uint64_t kFileSize = 100000;
+  mutable_cf_options_.hybrid_target_write_amplification = 10;
+  ioptions_.compaction_style = kCompactionStyleHybrid;
+  HybridCompactionPicker hybrid_compaction_picker(ioptions_, &icmp_);
+
+  NewVersionStorage(4, kCompactionStyleHybrid);
+  Add(2, 1U, "150", "200", kFileSize, 0, 401, 450);
+  Add(2, 2U, "300", "350", kFileSize * 2, 0, 401, 450);
+  Add(3, 3U, "100", "220", kFileSize * 3, 0, 10, 100);
+  Add(3, 4U, "230", "290", kFileSize * 3, 0, 10, 100);
+  Add(3, 5U, "310", "400", kFileSize * 3, 0, 10, 100);
+  UpdateVersionStorageInfo();
+
+  // 3 * (10 - 1) / 9 of the last level is pending in level 2.
+  ASSERT_EQ(2, vstorage_->CompactionScoreLevel(0));
+  ASSERT_DOUBLE_EQ(3.0, vstorage_->CompactionScore(0));
+  ASSERT_TRUE(hybrid_compaction_picker.NeedsCompaction(vstorage_.get()));
+  std::unique_ptr<Compaction> compaction(
+      hybrid_compaction_picker.PickCompaction(
+          cf_name_, mutable_cf_options_, vstorage_.get(), &log_buffer_));
+  ASSERT_TRUE(compaction.get() != nullptr);
+  // The largest file goes first, together with the one file it overlaps.
+  ASSERT_EQ(2, compaction->start_level());
+  ASSERT_EQ(3, compaction->output_level());
+  ASSERT_EQ(1U, compaction->num_input_files(0));
+  ASSERT_EQ(2U, compaction->input(0, 0)->fd.GetNumber());
+  ASSERT_EQ(1U, compaction->num_input_files(1));
+  ASSERT_EQ(5U, compaction->input(1, 0)->fd.GetNumber());
+}
+
+TEST_F(CompactionPickerTest, HybridDoesNotDrainSmallTier) {
+  const uint64_t kFileSize = 100000;
+  mutable_cf_options_.hybrid_target_write_amplification = 10;
+  ioptions_.compaction_style = kCompactionStyleHybrid;
+  HybridCompactionPicker hybrid_compaction_picker(ioptions_, &icmp_);
+
+  NewVersionStorage(4, kCompactionStyleHybrid);
+  Add(2, 1U, "150", "200", kFileSize, 0, 401, 450);
+  Add(3, 2U, "100", "400", kFileSize * 10, 0, 10, 100);
+  UpdateVersionStorageInfo();
+
+  ASSERT_FALSE(hybrid_compaction_picker.NeedsCompaction(vstorage_.get()));
+  std::unique_ptr<Compaction> compaction(
+      hybrid_compaction_picker.PickCompaction(
+          cf_name_, mutable_cf_options_, vstorage_.get(), &log_buffer_));
+  ASSERT_TRUE(compaction.get() == nullptr);
+}
 #endif  // ROCKSDB_LITE
 
 TEST_F(CompactionPickerTest, CompactionPriMinOverlapping1) {
@@ -0,0 +1,91 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/compression_dict_store.h"
+
+#include "db/version_edit.h"
+#include "util/xxhash.h"
+
+namespace rocksdb {
+
+uint64_t SharedCompressionDict::ComputeId(const Slice& dict) {
+  uint64_t id = XXH64(dict.data(), dict.size(), 0);
+  // 0 means that a file has no shared dictionary
+  return id != 0 ? id : 1;
+}
+
+std::shared_ptr<const SharedCompressionDict> CompressionDictStore::Acquire(
+    int level, uint32_t max_files) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = dicts_.find(level);
+  if (it == dicts_.end() || it->second.num_files >= max_files) {
+    return nullptr;
+  }
+  it->second.num_files++;
+  return it->second.dict;
+}
+
+std::shared_ptr<const SharedCompressionDict> CompressionDictStore::Install(
+    int level, std::string dict) {
+  uint64_t id = SharedCompressionDict::ComputeId(dict);
+  auto shared =
+      std::make_shared<const SharedCompressionDict>(id, std::move(dict));
+  std::lock_guard<std::mutex> lock(mutex_);
+  LevelDict& level_dict = dicts_[level];
+  level_dict.dict = shared;
+  // The file that trained it
+  level_dict.num_files = 1;
+  level_dict.persisted = false;
+  return shared;
+}
+
+void CompressionDictStore::Recover(int level, uint64_t id, std::string dict) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  LevelDict& level_dict = dicts_[level];
+  level_dict.dict =
+      std::make_shared<const SharedCompressionDict>(id, std::move(dict));
+  level_dict.num_files = 0;
+  level_dict.persisted = true;
+}
+
+void CompressionDictStore::AddUnpersistedTo(VersionEdit* edit) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& level_and_dict : dicts_) {
+    const LevelDict& level_dict = level_and_dict.second;
+    if (!level_dict.persisted) {
+      edit->AddCompressionDict(level_and_dict.first, level_dict.dict->id,
+                               level_dict.dict->dict);
+    }
+  }
+}
+
+void CompressionDictStore::MarkPersisted(const VersionEdit& edit) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& record : edit.GetCompressionDicts()) {
+    auto it = dicts_.find(record.level);
+    // A newer dictionary may have been installed since the edit was built
+    if (it != dicts_.end() && it->second.dict->id == record.id) {
+      it->second.persisted = true;
+    }
+  }
+}
+
+void CompressionDictStore::AddAllTo(VersionEdit* edit) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& level_and_dict : dicts_) {
+    const LevelDict& level_dict = level_and_dict.second;
+    edit->AddCompressionDict(level_and_dict.first, level_dict.dict->id,
+                             level_dict.dict->dict);
+  }
+}
+
+std::shared_ptr<const SharedCompressionDict> CompressionDictStore::TEST_GetDict(
+    int level) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = dicts_.find(level);
+  return it == dicts_.end() ? nullptr : it->second.dict;
+}
+
+}  // namespace rocksdb
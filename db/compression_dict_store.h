@@ -0,0 +1,92 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <stdint.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "rocksdb/slice.h"
+
+namespace rocksdb {
+
+class VersionEdit;
+
+// A compression dictionary that the table files written to one level of a
+// column family share. Each file still stores a copy of it, so that files
+// can be read on their own, and records its id in the
+// BlockBasedTablePropertyNames::kCompressionDictId property.
+struct SharedCompressionDict {
+  SharedCompressionDict(uint64_t _id, std::string _dict)
+      : id(_id), dict(std::move(_dict)) {}
+
+  // Hash of the contents, never 0
+  const uint64_t id;
+  const std::string dict;
+
+  static uint64_t ComputeId(const Slice& dict);
+};
+
+// The shared compression dictionaries of a column family, one per level.
+// Table builders take the dictionary of their output level instead of
+// training one from the data they buffer. Once a dictionary has been handed
+// out for `CompressionOptions::shared_dict_files` files, builders are told
+// to train again from their own samples, and install the result for the
+// files after them.
+//
+// New dictionaries are recorded in the MANIFEST with the next version edit
+// of the column family, and are restored on recovery.
+//
+// Thread-safe.
+class CompressionDictStore {
+ public:
+  CompressionDictStore() = default;
+
+  CompressionDictStore(const CompressionDictStore&) = delete;
+  CompressionDictStore& operator=(const CompressionDictStore&) = delete;
+
+  // Returns the dictionary for a file written to `level`, and counts the
+  // file against it. Returns nullptr if the level has no dictionary yet, or
+  // if it has been used for `max_files` files, in which case the caller
+  // should train a new one and Install() it.
+  std::shared_ptr<const SharedCompressionDict> Acquire(int level,
+                                                       uint32_t max_files);
+
+  // Makes `dict` the dictionary of `level`. Returns it with its id.
+  std::shared_ptr<const SharedCompressionDict> Install(int level,
+                                                       std::string dict);
+
+  // Restores a dictionary read from the MANIFEST.
+  void Recover(int level, uint64_t id, std::string dict);
+
+  // Adds the dictionaries not yet recorded in the MANIFEST to `edit`. They
+  // count as recorded only once MarkPersisted() is called with the edit, so
+  // that a failed MANIFEST write leaves them for the next edit.
+  void AddUnpersistedTo(VersionEdit* edit);
+
+  // Called once `edit` has been written to the MANIFEST.
+  void MarkPersisted(const VersionEdit& edit);
+
+  // Adds all the dictionaries to `edit`, for a new MANIFEST.
+  void AddAllTo(VersionEdit* edit);
+
+  std::shared_ptr<const SharedCompressionDict> TEST_GetDict(int level);
+
+ private:
+  struct LevelDict {
+    std::shared_ptr<const SharedCompressionDict> dict;
+    // Number of files the dictionary has been handed out for
+    uint32_t num_files = 0;
+    bool persisted = false;
+  };
+
+  std::mutex mutex_;
+  std::map<int, LevelDict> dicts_;
+};
+
+}  // namespace rocksdb
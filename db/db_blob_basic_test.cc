@@ -0,0 +1,255 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include <set>
+
+#include "db/db_test_util.h"
+#include "file/filename.h"
+#include "port/stack_trace.h"
+
+namespace rocksdb {
+
+class DBBlobBasicTest : public DBTestBase {
+ public:
+  DBBlobBasicTest() : DBTestBase("/db_blob_basic_test") {}
+
+  Options GetBlobOptions() {
+    Options options = CurrentOptions();
+    options.enable_blob_files = true;
+    options.min_blob_size = 0;
+    options.disable_auto_compactions = true;
+    return options;
+  }
+
+  std::set<uint64_t> GetBlobFileNumbers() {
+    std::vector<std::string> files;
+    EXPECT_OK(env_->GetChildren(dbname_, &files));
+    std::set<uint64_t> numbers;
+    for (const auto& f : files) {
+      uint64_t number;
+      FileType type;
+      if (ParseFileName(f, &number, &type) && type == kBlobFile) {
+        numbers.insert(number);
+      }
+    }
+    return numbers;
+  }
+};
+
+TEST_F(DBBlobBasicTest, InvalidOptions) {
+  Options options = GetBlobOptions();
+  options.compaction_style = kCompactionStyleFIFO;
+  ASSERT_TRUE(TryReopen(options).IsNotSupported());
+
+  options = GetBlobOptions();
+  options.blob_garbage_collection_age_cutoff = -0.5;
+  ASSERT_TRUE(TryReopen(options).IsInvalidArgument());
+  options.blob_garbage_collection_age_cutoff = 1.5;
+  ASSERT_TRUE(TryReopen(options).IsInvalidArgument());
+}
+
+TEST_F(DBBlobBasicTest, GetBlob) {
+  Options options = GetBlobOptions();
+  options.min_blob_size = 10;
+  Reopen(options);
+
+  const std::string large_value(100, 'x');
+  ASSERT_OK(Put("large", large_value));
+  ASSERT_OK(Put("small", "v"));
+  ASSERT_OK(Flush());
+  ASSERT_EQ(1, GetBlobFileNumbers().size());
+
+  ASSERT_EQ(large_value, Get("large"));
+  ASSERT_EQ("v", Get("small"));
+  ASSERT_EQ("NOT_FOUND", Get("missing"));
+
+  Reopen(options);
+  ASSERT_EQ(large_value, Get("large"));
+  ASSERT_EQ("v", Get("small"));
+}
+
+TEST_F(DBBlobBasicTest, SmallValuesStayInline) {
+  Options options = GetBlobOptions();
+  options.min_blob_size = 1000;
+  Reopen(options);
+
+  ASSERT_OK(Put("k1", "v1"));
+  ASSERT_OK(Put("k2", "v2"));
+  ASSERT_OK(Flush());
+  ASSERT_TRUE(GetBlobFileNumbers().empty());
+  ASSERT_EQ("v1", Get("k1"));
+}
+
+TEST_F(DBBlobBasicTest, MultiGetBlobs) {
+  Options options = GetBlobOptions();
+  Reopen(options);
+
+  const int kNumKeys = 10;
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_OK(Put(Key(i), "value" + ToString(i)));
+  }
+  ASSERT_OK(Flush());
+
+  std::vector<std::string> keys;
+  for (int i = 0; i < kNumKeys + 1; i++) {
+    keys.push_back(Key(i));
+  }
+  std::vector<std::string> values = MultiGet(keys, nullptr);
+  ASSERT_EQ(kNumKeys + 1, values.size());
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_EQ("value" + ToString(i), values[i]);
+  }
+  ASSERT_EQ("NOT_FOUND", values[kNumKeys]);
+}
+
+TEST_F(DBBlobBasicTest, IterateBlobs) {
+  Options options = GetBlobOptions();
+  options.merge_operator = MergeOperators::CreateStringAppendOperator();
+  Reopen(options);
+
+  const int kNumKeys = 10;
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_OK(Put(Key(i), "value" + ToString(i)));
+  }
+  ASSERT_OK(Flush());
+  // A merge on top of a blob
+  ASSERT_OK(Merge(Key(3), "merged"));
+
+  std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+  int i = 0;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next(), i++) {
+    ASSERT_EQ(Key(i), iter->key().ToString());
+    ASSERT_EQ(i == 3 ? "value3,merged" : "value" + ToString(i),
+              iter->value().ToString());
+  }
+  ASSERT_OK(iter->status());
+  ASSERT_EQ(kNumKeys, i);
+
+  for (iter->SeekToLast(); iter->Valid(); iter->Prev()) {
+    i--;
+    ASSERT_EQ(Key(i), iter->key().ToString());
+    ASSERT_EQ(i == 3 ? "value3,merged" : "value" + ToString(i),
+              iter->value().ToString());
+  }
+  ASSERT_OK(iter->status());
+  ASSERT_EQ(0, i);
+  iter.reset();
+
+  ASSERT_EQ("value3,merged", Get(Key(3)));
+}
+
+TEST_F(DBBlobBasicTest, ObsoleteBlobFilesAreDeleted) {
+  Options options = GetBlobOptions();
+  Reopen(options);
+
+  for (int i = 0; i < 10; i++) {
+    ASSERT_OK(Put(Key(i), "old" + ToString(i)));
+  }
+  ASSERT_OK(Flush());
+  std::set<uint64_t> old_files = GetBlobFileNumbers();
+  ASSERT_EQ(1, old_files.size());
+
+  for (int i = 0; i < 10; i++) {
+    ASSERT_OK(Put(Key(i), "new" + ToString(i)));
+  }
+  ASSERT_OK(Flush());
+  ASSERT_EQ(2, GetBlobFileNumbers().size());
+
+  // Every blob of the first file is overwritten
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+  std::set<uint64_t> files = GetBlobFileNumbers();
+  ASSERT_EQ(1, files.size());
+  ASSERT_EQ(0, files.count(*old_files.begin()));
+  for (int i = 0; i < 10; i++) {
+    ASSERT_EQ("new" + ToString(i), Get(Key(i)));
+  }
+
+  // The garbage is recovered from the MANIFEST
+  Reopen(options);
+  ASSERT_EQ(files, GetBlobFileNumbers());
+  for (int i = 0; i < 10; i++) {
+    ASSERT_EQ("new" + ToString(i), Get(Key(i)));
+  }
+}
+
+TEST_F(DBBlobBasicTest, SkippedBlobsAreGarbage) {
+  // Drops the first key and skips over all the others
+  class SkipAllFilter : public CompactionFilter {
+   public:
+    Decision FilterV2(int /*level*/, const Slice& key, ValueType /*value_type*/,
+                      const Slice& /*existing_value*/,
+                      std::string* /*new_value*/,
+                      std::string* skip_until) const override {
+      if (key.starts_with(Key(0))) {
+        *skip_until = Key(100);
+        return Decision::kRemoveAndSkipUntil;
+      }
+      return Decision::kKeep;
+    }
+
+    const char* Name() const override { return "SkipAllFilter"; }
+  };
+
+  SkipAllFilter filter;
+  Options options = GetBlobOptions();
+  options.compaction_filter = &filter;
+  Reopen(options);
+
+  for (int i = 0; i < 10; i++) {
+    ASSERT_OK(Put(Key(i), "value" + ToString(i)));
+  }
+  ASSERT_OK(Flush());
+  ASSERT_EQ(1, GetBlobFileNumbers().size());
+
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+  ASSERT_TRUE(GetBlobFileNumbers().empty());
+  for (int i = 0; i < 10; i++) {
+    ASSERT_EQ("NOT_FOUND", Get(Key(i)));
+  }
+}
+
+TEST_F(DBBlobBasicTest, GarbageCollection) {
+  Options options = GetBlobOptions();
+  options.enable_blob_garbage_collection = true;
+  options.blob_garbage_collection_age_cutoff = 1.0;
+  Reopen(options);
+
+  for (int i = 0; i < 10; i++) {
+    ASSERT_OK(Put(Key(i), "value" + ToString(i)));
+    ASSERT_OK(Flush());
+  }
+  std::set<uint64_t> old_files = GetBlobFileNumbers();
+  ASSERT_EQ(10, old_files.size());
+
+  // All the blobs are relocated to a new file. The table files do not
+  // overlap, so they are moved to the bottommost level first and then
+  // compacted there.
+  MoveFilesToLevel(1);
+  CompactRangeOptions cro;
+  cro.bottommost_level_compaction = BottommostLevelCompaction::kForce;
+  ASSERT_OK(db_->CompactRange(cro, nullptr, nullptr));
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+  std::set<uint64_t> files = GetBlobFileNumbers();
+  ASSERT_EQ(1, files.size());
+  ASSERT_EQ(0, old_files.count(*files.begin()));
+  for (int i = 0; i < 10; i++) {
+    ASSERT_EQ("value" + ToString(i), Get(Key(i)));
+  }
+
+  Reopen(options);
+  for (int i = 0; i < 10; i++) {
+    ASSERT_EQ("value" + ToString(i), Get(Key(i)));
+  }
+}
+
+}  // namespace rocksdb
+
+int main(int argc, char** argv) {
+  rocksdb::port::InstallStackTraceHandler();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -10,6 +10,7 @@
 #include "cache/lru_cache.h"
 #include "db/db_test_util.h"
 #include "port/stack_trace.h"
+#include "rocksdb/secondary_cache.h"
 
 namespace rocksdb {
 
@@ -284,6 +285,44 @@ TEST_F(DBBlockCacheTest, TestWithCompressedBlockCache) {
 }
 #endif  // SNAPPY
 
+TEST_F(DBBlockCacheTest, TestWithSecondaryCache) {
+  auto table_options = GetTableOptions();
+  auto options = GetOptions(table_options);
+  InitTable(options);
+
+  std::shared_ptr<SecondaryCache> secondary_cache =
+      NewCompressedSecondaryCache(
+          CompressedSecondaryCacheOptions(1 << 20, 0 /* num_shard_bits */));
+  LRUCacheOptions cache_opts(1 << 20, 0 /* num_shard_bits */,
+                             false /* strict_capacity_limit */,
+                             0.0 /* high_pri_pool_ratio */);
+  cache_opts.secondary_cache = secondary_cache;
+  std::shared_ptr<Cache> cache = NewLRUCache(cache_opts);
+  table_options.block_cache = cache;
+  options.table_factory.reset(new BlockBasedTableFactory(table_options));
+  Reopen(options);
+  RecordCacheCounters(options);
+
+  std::string value(kValueSize, 'a');
+  for (size_t i = 0; i < kNumBlocks; i++) {
+    ASSERT_EQ(value, Get(ToString(i)));
+  }
+  CheckCacheCounters(options, kNumBlocks, 0, kNumBlocks, 0);
+  ASSERT_EQ(0, secondary_cache->GetUsage());
+
+  // Evict every block to the secondary cache
+  cache->SetCapacity(0);
+  ASSERT_LT(0, secondary_cache->GetUsage());
+  cache->SetCapacity(1 << 20);
+
+  // The blocks are recreated from the secondary cache, which counts as a hit
+  for (size_t i = 0; i < kNumBlocks; i++) {
+    ASSERT_EQ(value, Get(ToString(i)));
+  }
+  CheckCacheCounters(options, 0, kNumBlocks, 0, 0);
+  ASSERT_EQ(0, secondary_cache->GetUsage());
+}
+
 #ifndef ROCKSDB_LITE
 
 // Make sure that when options.block_cache is set, after a new table is
@@ -447,6 +486,18 @@ class MockCache : public LRUCache {
     }
     return LRUCache::Insert(key, value, charge, deleter, handle, priority);
   }
+
+  Status InsertWithHelper(const Slice& key, void* value,
+                          const CacheItemHelper* helper, size_t charge,
+                          Handle** handle, Priority priority) override {
+    if (priority == Priority::LOW) {
+      low_pri_insert_count++;
+    } else {
+      high_pri_insert_count++;
+    }
+    return LRUCache::InsertWithHelper(key, value, helper, charge, handle,
+                                      priority);
+  }
 };
 
 uint32_t MockCache::high_pri_insert_count = 0;
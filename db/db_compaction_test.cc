@@ -840,6 +840,54 @@ TEST_F(DBCompactionTest, MinorCompactionsHappen) {
   } while (ChangeCompactOptions());
 }
 
+TEST_F(DBCompactionTest, HybridCompactionStyle) {
+  Options options = CurrentOptions();
+  options.compaction_style = kCompactionStyleHybrid;
+  options.num_levels = 4;
+  options.write_buffer_size = 32 << 10;
+  options.target_file_size_base = 32 << 10;
+  options.level0_file_num_compaction_trigger = 2;
+  options.hybrid_target_write_amplification = 4;
+  DestroyAndReopen(options);
+
+  const int kNumKeys = 1000;
+  const int kNumRounds = 4;
+  Random rnd(301);
+  std::vector<std::string> values(kNumKeys);
+  for (int round = 0; round < kNumRounds; round++) {
+    for (int i = 0; i < kNumKeys; i++) {
+      values[i] = RandomString(&rnd, 200);
+      ASSERT_OK(Put(Key(i), values[i]));
+    }
+    ASSERT_OK(Flush());
+    dbfull()->TEST_WaitForCompact();
+
+    // Tiers are merged until fewer than the trigger remain above the last
+    // level, and the oldest tier is drained once it is large enough.
+    int num_tiers = NumTableFilesAtLevel(0);
+    for (int level = 1; level < options.num_levels - 1; level++) {
+      if (NumTableFilesAtLevel(level) > 0) {
+        num_tiers++;
+      }
+    }
+    ASSERT_LT(num_tiers, options.level0_file_num_compaction_trigger);
+    ASSERT_GT(NumTableFilesAtLevel(options.num_levels - 1), 0);
+  }
+
+  Reopen(options);
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_EQ(values[i], Get(Key(i)));
+  }
+
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  for (int level = 0; level < options.num_levels - 1; level++) {
+    ASSERT_EQ(0, NumTableFilesAtLevel(level));
+  }
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_EQ(values[i], Get(Key(i)));
+  }
+}
+
 TEST_F(DBCompactionTest, UserKeyCrossFile1) {
   Options options = CurrentOptions();
   options.compaction_style = kCompactionStyleLevel;
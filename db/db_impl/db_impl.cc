@@ -173,6 +173,7 @@ DBImpl::DBImpl(const DBOptions& options, const std::string& dbname,
       total_log_size_(0),
       is_snapshot_supported_(true),
       write_buffer_manager_(immutable_db_options_.write_buffer_manager.get()),
+      write_buffer_manager_delay_ratio_(0),
       write_thread_(immutable_db_options_),
       nonmem_write_thread_(immutable_db_options_),
       write_controller_(mutable_db_options_.delayed_write_rate),
@@ -436,9 +437,16 @@ void DBImpl::CancelAllBackgroundWork(bool wait) {
 }
 
 Status DBImpl::CloseHelper() {
+  // The write buffer manager may outlive the DB, and must stop flushing it
+  if (write_buffer_manager_client_) {
+    write_buffer_manager_->UnregisterClient(
+        write_buffer_manager_client_.get());
+  }
+
   // Guarantee that there is no background error recovery in progress before
   // continuing with the shutdown
   mutex_.Lock();
+  write_buffer_manager_delay_token_.reset();
   shutdown_initiated_ = true;
   error_handler_.CancelErrorRecovery();
   while (error_handler_.IsRecoveryInProgress()) {
@@ -1846,13 +1854,13 @@ void DBImpl::MultiGet(const ReadOptions& read_options,
   }
 
   MultiGetImpl(read_options, column_family, key_context, sorted_input, nullptr,
-               nullptr);
+               false);
 }
 
 void DBImpl::MultiGetImpl(
     const ReadOptions& read_options, ColumnFamilyHandle* column_family,
     autovector<KeyContext, MultiGetContext::MAX_BATCH_SIZE>& key_context,
-    bool sorted_input, ReadCallback* callback, bool* is_blob_index) {
+    bool sorted_input, ReadCallback* callback, bool allow_blob_index) {
   PERF_CPU_TIMER_GUARD(get_cpu_nanos, env_);
   StopWatch sw(env_, stats_, DB_MULTIGET);
   size_t num_keys = key_context.size();
@@ -1964,6 +1972,8 @@ void DBImpl::MultiGetImpl(
       merge_context.Clear();
       Status& s = *mget_iter->s;
       PinnableSlice* value = mget_iter->value;
+      bool* is_blob_index =
+          allow_blob_index ? &mget_iter->is_blob_index : nullptr;
       s = Status::OK();
 
       bool skip_memtable =
@@ -1998,7 +2008,7 @@ void DBImpl::MultiGetImpl(
     if (lookup_current) {
       PERF_TIMER_GUARD(get_from_output_files_time);
       super_version->current->MultiGet(read_options, &range, callback,
-                                       is_blob_index);
+                                       allow_blob_index);
     }
   }
 
@@ -2404,7 +2414,8 @@ ArenaWrappedDBIter* DBImpl::NewIteratorImpl(const ReadOptions& read_options,
       env_, read_options, *cfd->ioptions(), sv->mutable_cf_options, snapshot,
       sv->mutable_cf_options.max_sequential_skip_in_iterations,
       sv->version_number, read_callback, this, cfd, allow_blob,
-      ((read_options.snapshot != nullptr) ? false : allow_refresh));
+      ((read_options.snapshot != nullptr) ? false : allow_refresh),
+      sv->current);
 
   InternalIterator* internal_iter =
       NewInternalIterator(read_options, cfd, sv, db_iter->GetArena(),
@@ -199,11 +199,14 @@ class DBImpl : public DB {
                         PinnableSlice* values, Status* statuses,
                         const bool sorted_input = false) override;
 
+  // If allow_blob_index is true, blob indexes are returned as the values of
+  // their keys and flagged with KeyContext::is_blob_index, instead of failing
+  // the lookup of the key with NotSupported.
   void MultiGetImpl(
       const ReadOptions& options, ColumnFamilyHandle* column_family,
       autovector<KeyContext, MultiGetContext::MAX_BATCH_SIZE>& key_context,
       bool sorted_input, ReadCallback* callback = nullptr,
-      bool* is_blob_index = nullptr);
+      bool allow_blob_index = false);
 
   virtual Status CreateColumnFamily(const ColumnFamilyOptions& cf_options,
                                     const std::string& column_family,
@@ -1441,6 +1444,17 @@ class DBImpl : public DB {
   // REQUIRES: mutex locked
   Status HandleWriteBufferFull(WriteContext* write_context);
 
+  // Slows down writes as told by a write buffer manager that arbitrates
+  // flushes across DBs.
+  // REQUIRES: mutex locked
+  void UpdateWriteBufferManagerDelay();
+
+  // Implements WriteBufferManager::Client.
+  // REQUIRES: mutex not locked
+  void GetWriteBufferManagerFlushCandidates(
+      std::vector<WriteBufferManager::FlushCandidate>* candidates);
+  Status FlushForWriteBufferManager(uint32_t column_family_id);
+
   // REQUIRES: mutex locked
   Status PreprocessWrite(const WriteOptions& write_options, bool* need_log_sync,
                          WriteContext* write_context);
@@ -1739,6 +1753,27 @@ class DBImpl : public DB {
 
   WriteBufferManager* write_buffer_manager_;
 
+  // Registered with write_buffer_manager_ if it arbitrates flushes
+  class WriteBufferManagerClient : public WriteBufferManager::Client {
+   public:
+    explicit WriteBufferManagerClient(DBImpl* db) : db_(db) {}
+    void GetFlushCandidates(
+        std::vector<WriteBufferManager::FlushCandidate>* candidates) override {
+      db_->GetWriteBufferManagerFlushCandidates(candidates);
+    }
+    Status FlushColumnFamily(uint32_t column_family_id) override {
+      return db_->FlushForWriteBufferManager(column_family_id);
+    }
+
+   private:
+    DBImpl* db_;
+  };
+  std::unique_ptr<WriteBufferManagerClient> write_buffer_manager_client_;
+  // The delay write_buffer_manager_ last asked for, and the token that
+  // enforces it
+  double write_buffer_manager_delay_ratio_;
+  std::unique_ptr<WriteControllerToken> write_buffer_manager_delay_token_;
+
   WriteThread write_thread_;
   WriteBatch tmp_batch_;
   // The write thread when the writers have no memtable write. This will be used
@@ -95,6 +95,12 @@ void DBImpl::FindObsoleteFiles(JobContext* job_context, bool force,
     MarkAsGrabbedForPurge(sst_to_del.metadata->fd.GetNumber());
   }
 
+  versions_->GetObsoleteBlobFiles(&job_context->blob_delete_files,
+                                  job_context->min_pending_output);
+  for (const auto& blob_to_del : job_context->blob_delete_files) {
+    MarkAsGrabbedForPurge(blob_to_del.blob_file_number);
+  }
+
   // store the current filenum, lognum, etc
   job_context->manifest_file_number = versions_->manifest_file_number();
   job_context->pending_manifest_file_number =
@@ -103,6 +109,15 @@ void DBImpl::FindObsoleteFiles(JobContext* job_context, bool force,
   job_context->prev_log_number = versions_->prev_log_number();
 
   versions_->AddLiveFiles(&job_context->sst_live);
+  versions_->AddLiveBlobFiles(&job_context->blob_live);
+  job_context->manage_blob_files = !job_context->blob_live.empty() ||
+                                   !job_context->blob_delete_files.empty();
+  for (auto cfd : *versions_->GetColumnFamilySet()) {
+    if (cfd->ioptions()->enable_blob_files) {
+      job_context->manage_blob_files = true;
+      break;
+    }
+  }
   if (doing_the_full_scan) {
     InfoLogPrefix info_log_prefix(!immutable_db_options_.db_log_dir.empty(),
                                   dbname_);
@@ -308,13 +323,16 @@ void DBImpl::PurgeObsoleteFiles(JobContext& state, bool schedule_only) {
   for (const FileDescriptor& fd : state.sst_live) {
     sst_live_map[fd.GetNumber()] = &fd;
   }
+  std::unordered_set<uint64_t> blob_live_set(state.blob_live.begin(),
+                                             state.blob_live.end());
   std::unordered_set<uint64_t> log_recycle_files_set(
       state.log_recycle_files.begin(), state.log_recycle_files.end());
 
   auto candidate_files = state.full_scan_candidate_files;
   candidate_files.reserve(
       candidate_files.size() + state.sst_delete_files.size() +
-      state.log_delete_files.size() + state.manifest_delete_files.size());
+      state.blob_delete_files.size() + state.log_delete_files.size() +
+      state.manifest_delete_files.size());
   // We may ignore the dbname when generating the file names.
   for (auto& file : state.sst_delete_files) {
     candidate_files.emplace_back(
@@ -325,6 +343,11 @@ void DBImpl::PurgeObsoleteFiles(JobContext& state, bool schedule_only) {
     file.DeleteMetadata();
   }
 
+  for (const auto& blob_file : state.blob_delete_files) {
+    candidate_files.emplace_back(BlobFileName(blob_file.blob_file_number),
+                                 blob_file.path);
+  }
+
   for (auto file_num : state.log_delete_files) {
     if (file_num > 0) {
       candidate_files.emplace_back(LogFileName(file_num),
@@ -438,11 +461,20 @@ void DBImpl::PurgeObsoleteFiles(JobContext& state, bool schedule_only) {
             "DBImpl::PurgeObsoleteFiles:CheckOptionsFiles:2",
             reinterpret_cast<void*>(&keep));
         break;
+      case kBlobFile:
+        // Blob files that the DB did not write itself belong to BlobDB,
+        // which deletes them on its own.
+        keep = !state.manage_blob_files ||
+               (blob_live_set.find(number) != blob_live_set.end()) ||
+               number >= state.min_pending_output;
+        if (!keep) {
+          files_to_del.insert(number);
+        }
+        break;
       case kCurrentFile:
       case kDBLockFile:
       case kIdentityFile:
       case kMetaDatabase:
-      case kBlobFile:
         keep = true;
         break;
     }
@@ -458,6 +490,11 @@ void DBImpl::PurgeObsoleteFiles(JobContext& state, bool schedule_only) {
       TableCache::Evict(table_cache_.get(), number);
       fname = MakeTableFileName(candidate_file.file_path, number);
       dir_to_sync = candidate_file.file_path;
+    } else if (type == kBlobFile) {
+      // the readers of blob files share the table cache
+      TableCache::Evict(table_cache_.get(), number);
+      fname = BlobFileName(candidate_file.file_path, number);
+      dir_to_sync = candidate_file.file_path;
     } else {
       dir_to_sync =
           (type == kLogFile) ? immutable_db_options_.wal_dir : dbname_;
@@ -10,6 +10,7 @@
 
 #include <cinttypes>
 
+#include "db/blob_file_builder.h"
 #include "db/builder.h"
 #include "db/error_handler.h"
 #include "file/sst_file_manager_impl.h"
@@ -62,6 +63,10 @@ DBOptions SanitizeOptions(const std::string& dbname, const DBOptions& src) {
                                            Env::Priority::LOW);
   result.env->IncBackgroundThreadsIfNeeded(bg_job_limits.max_flushes,
                                            Env::Priority::HIGH);
+  if (result.max_background_readaheads > 0) {
+    result.env->IncBackgroundThreadsIfNeeded(result.max_background_readaheads,
+                                             Env::Priority::USER);
+  }
 
   if (result.rate_limiter.get() != nullptr) {
     if (result.bytes_per_sync == 0) {
@@ -1135,6 +1140,7 @@ Status DBImpl::WriteLevel0TableForRecovery(int job_id, ColumnFamilyData* cfd,
   Arena arena;
   Status s;
   TableProperties table_properties;
+  std::unique_ptr<BlobFileBuilder> blob_file_builder;
   {
     ScopedArenaIterator iter(mem->NewIterator(ro, &arena));
     ROCKS_LOG_DEBUG(immutable_db_options_.info_log,
@@ -1170,6 +1176,11 @@ Status DBImpl::WriteLevel0TableForRecovery(int job_id, ColumnFamilyData* cfd,
       if (range_del_iter != nullptr) {
         range_del_iters.emplace_back(range_del_iter);
       }
+      if (cfd->ioptions()->enable_blob_files) {
+        blob_file_builder.reset(new BlobFileBuilder(
+            versions_.get(), env_, env_options_for_compaction_,
+            cfd->ioptions(), cfd->GetID(), Env::IO_HIGH, write_hint));
+      }
       s = BuildTable(
           dbname_, env_, *cfd->ioptions(), mutable_cf_options,
           env_options_for_compaction_, cfd->table_cache(), iter.get(),
@@ -1181,7 +1192,9 @@ Status DBImpl::WriteLevel0TableForRecovery(int job_id, ColumnFamilyData* cfd,
           cfd->ioptions()->compression_opts, paranoid_file_checks,
           cfd->internal_stats(), TableFileCreationReason::kRecovery,
           &event_logger_, job_id, Env::IO_HIGH, nullptr /* table_properties */,
-          -1 /* level */, current_time, write_hint);
+          -1 /* level */, current_time, write_hint, Env::WLTH_NOT_SET,
+          0 /* file_creation_time */, nullptr /* compression_dict_store */,
+          blob_file_builder.get());
       LogFlush(immutable_db_options_.info_log);
       ROCKS_LOG_DEBUG(immutable_db_options_.info_log,
                       "[%s] [WriteLevel0TableForRecovery]"
@@ -1201,11 +1214,21 @@ Status DBImpl::WriteLevel0TableForRecovery(int job_id, ColumnFamilyData* cfd,
                   meta.fd.GetFileSize(), meta.smallest, meta.largest,
                   meta.fd.smallest_seqno, meta.fd.largest_seqno,
                   meta.marked_for_compaction);
+    if (blob_file_builder != nullptr) {
+      for (const auto& blob_file : blob_file_builder->GetBlobFileAdditions()) {
+        edit->AddBlobFile(blob_file.blob_file_number,
+                          blob_file.total_blob_count,
+                          blob_file.total_blob_bytes);
+      }
+    }
   }
 
   InternalStats::CompactionStats stats(CompactionReason::kFlush, 1);
   stats.micros = env_->NowMicros() - start_micros;
   stats.bytes_written = meta.fd.GetFileSize();
+  if (blob_file_builder != nullptr) {
+    stats.bytes_written += blob_file_builder->bytes_written();
+  }
   stats.num_output_files = 1;
   cfd->internal_stats()->AddCompactionStats(level, Env::Priority::USER, stats);
   cfd->internal_stats()->AddCFStats(InternalStats::BYTES_FLUSHED,
@@ -1520,6 +1543,12 @@ Status DBImpl::Open(const DBOptions& db_options, const std::string& dbname,
   }
   if (s.ok()) {
     impl->StartTimedTasks();
+    if (impl->write_buffer_manager_->arbitrates()) {
+      impl->write_buffer_manager_client_.reset(
+          new DBImpl::WriteBufferManagerClient(impl));
+      impl->write_buffer_manager_->RegisterClient(
+          impl->write_buffer_manager_client_.get());
+    }
   }
   if (!s.ok()) {
     for (auto* h : *handles) {
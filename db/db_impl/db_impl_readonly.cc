@@ -81,7 +81,9 @@ Iterator* DBImplReadOnly::NewIterator(const ReadOptions& read_options,
       env_, read_options, *cfd->ioptions(), super_version->mutable_cf_options,
       read_seq,
       super_version->mutable_cf_options.max_sequential_skip_in_iterations,
-      super_version->version_number, read_callback);
+      super_version->version_number, read_callback, nullptr /* db_impl */,
+      nullptr /* cfd */, false /* allow_blob */, true /* allow_refresh */,
+      super_version->current);
   auto internal_iter =
       NewInternalIterator(read_options, cfd, super_version, db_iter->GetArena(),
                           db_iter->GetRangeDelAggregator(), read_seq);
@@ -112,7 +114,9 @@ Status DBImplReadOnly::NewIterators(
     auto* db_iter = NewArenaWrappedDbIterator(
         env_, read_options, *cfd->ioptions(), sv->mutable_cf_options, read_seq,
         sv->mutable_cf_options.max_sequential_skip_in_iterations,
-        sv->version_number, read_callback);
+        sv->version_number, read_callback, nullptr /* db_impl */,
+        nullptr /* cfd */, false /* allow_blob */, true /* allow_refresh */,
+        sv->current);
     auto* internal_iter =
         NewInternalIterator(read_options, cfd, sv, db_iter->GetArena(),
                             db_iter->GetRangeDelAggregator(), read_seq);
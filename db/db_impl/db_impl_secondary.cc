@@ -410,7 +410,9 @@ ArenaWrappedDBIter* DBImplSecondary::NewIteratorImpl(
       env_, read_options, *cfd->ioptions(), super_version->mutable_cf_options,
       snapshot,
       super_version->mutable_cf_options.max_sequential_skip_in_iterations,
-      super_version->version_number, read_callback);
+      super_version->version_number, read_callback, nullptr /* db_impl */,
+      nullptr /* cfd */, false /* allow_blob */, true /* allow_refresh */,
+      super_version->current);
   auto internal_iter =
       NewInternalIterator(read_options, cfd, super_version, db_iter->GetArena(),
                           db_iter->GetRangeDelAggregator(), snapshot);
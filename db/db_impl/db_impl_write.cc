@@ -859,7 +859,14 @@ Status DBImpl::PreprocessWrite(const WriteOptions& write_options,
     status = SwitchWAL(write_context);
   }
 
-  if (UNLIKELY(status.ok() && write_buffer_manager_->ShouldFlush())) {
+  if (write_buffer_manager_->arbitrates()) {
+    // The manager picks what to flush among all the DBs sharing it, from its
+    // own thread
+    if (UNLIKELY(status.ok() && write_buffer_manager_->ShouldFlush())) {
+      write_buffer_manager_->MaybeScheduleFlush();
+    }
+    UpdateWriteBufferManagerDelay();
+  } else if (UNLIKELY(status.ok() && write_buffer_manager_->ShouldFlush())) {
     // Before a new memtable is added in SwitchMemtable(),
     // write_buffer_manager_->ShouldFlush() will keep returning true. If another
     // thread is writing to another DB with the same write buffer, they may also
@@ -1343,6 +1350,102 @@ Status DBImpl::HandleWriteBufferFull(WriteContext* write_context) {
   return status;
 }
 
+void DBImpl::UpdateWriteBufferManagerDelay() {
+  mutex_.AssertHeld();
+  double ratio = write_buffer_manager_->DelayedWriteRateRatio();
+  if (ratio == write_buffer_manager_delay_ratio_) {
+    return;
+  }
+  write_buffer_manager_delay_ratio_ = ratio;
+  if (ratio == 0) {
+    write_buffer_manager_delay_token_.reset();
+    return;
+  }
+  uint64_t rate = std::max<uint64_t>(
+      static_cast<uint64_t>(mutable_db_options_.delayed_write_rate * ratio),
+      1);
+  ROCKS_LOG_INFO(immutable_db_options_.info_log,
+                 "Delaying writes to %" PRIu64
+                 " bytes/s. Write buffer is using %" ROCKSDB_PRIszt
+                 " bytes out of a total of %" ROCKSDB_PRIszt ".",
+                 rate, write_buffer_manager_->memory_usage(),
+                 write_buffer_manager_->buffer_size());
+  write_buffer_manager_delay_token_ =
+      write_controller_.GetWriteBufferDelayToken(rate);
+}
+
+void DBImpl::GetWriteBufferManagerFlushCandidates(
+    std::vector<WriteBufferManager::FlushCandidate>* candidates) {
+  int64_t now = 0;
+  if (!env_->GetCurrentTime(&now).ok()) {
+    now = 0;
+  }
+  InstrumentedMutexLock l(&mutex_);
+  if (shutting_down_.load(std::memory_order_acquire) ||
+      error_handler_.IsDBStopped()) {
+    return;
+  }
+  for (auto cfd : *versions_->GetColumnFamilySet()) {
+    if (cfd->IsDropped() || !cfd->initialized() || cfd->mem()->IsEmpty()) {
+      continue;
+    }
+    WriteBufferManager::FlushCandidate candidate;
+    candidate.column_family_id = cfd->GetID();
+    candidate.memory_usage = cfd->mem()->ApproximateMemoryUsageFast();
+    uint64_t oldest_key_time = cfd->mem()->ApproximateOldestKeyTime();
+    if (now > 0 && oldest_key_time < static_cast<uint64_t>(now)) {
+      candidate.age_seconds = static_cast<uint64_t>(now) - oldest_key_time;
+    }
+    candidate.num_immutable_memtables = cfd->imm()->NumNotFlushed();
+    candidate.num_level0_files =
+        cfd->current()->storage_info()->NumLevelFiles(0);
+    candidate.level0_slowdown_writes_trigger =
+        cfd->GetCurrentMutableCFOptions()->level0_slowdown_writes_trigger;
+    candidates->push_back(candidate);
+  }
+}
+
+Status DBImpl::FlushForWriteBufferManager(uint32_t column_family_id) {
+  ColumnFamilyData* cfd = nullptr;
+  {
+    InstrumentedMutexLock l(&mutex_);
+    if (shutting_down_.load(std::memory_order_acquire)) {
+      return Status::ShutdownInProgress();
+    }
+    cfd = versions_->GetColumnFamilySet()->GetColumnFamily(column_family_id);
+    if (cfd == nullptr || cfd->IsDropped()) {
+      return Status::ColumnFamilyDropped();
+    }
+    cfd->Ref();
+  }
+  ROCKS_LOG_INFO(
+      immutable_db_options_.info_log,
+      "[%s] Flushing picked by write buffer manager. Write buffer is using "
+      "%" ROCKSDB_PRIszt " bytes out of a total of %" ROCKSDB_PRIszt ".",
+      cfd->GetName().c_str(), write_buffer_manager_->memory_usage(),
+      write_buffer_manager_->buffer_size());
+  FlushOptions flush_options;
+  flush_options.wait = false;
+  flush_options.allow_write_stall = true;
+  Status s;
+  if (immutable_db_options_.atomic_flush) {
+    autovector<ColumnFamilyData*> cfds;
+    {
+      InstrumentedMutexLock l(&mutex_);
+      SelectColumnFamiliesForAtomicFlush(&cfds);
+    }
+    s = AtomicFlushMemTables(cfds, flush_options,
+                             FlushReason::kWriteBufferManager);
+  } else {
+    s = FlushMemTable(cfd, flush_options, FlushReason::kWriteBufferManager);
+  }
+  if (cfd->Unref()) {
+    InstrumentedMutexLock l(&mutex_);
+    delete cfd;
+  }
+  return s;
+}
+
 uint64_t DBImpl::GetMaxTotalWalSize() const {
   mutex_.AssertHeld();
   return mutable_db_options_.max_total_wal_size == 0
@@ -12,10 +12,12 @@
 #include <iostream>
 #include <limits>
 
+#include "db/blob_fetcher.h"
 #include "db/dbformat.h"
 #include "db/merge_context.h"
 #include "db/merge_helper.h"
 #include "db/pinned_iterators_manager.h"
+#include "db/version_set.h"
 #include "file/filename.h"
 #include "logging/logging.h"
 #include "memory/arena.h"
@@ -118,7 +120,7 @@ class DBIter final: public Iterator {
          InternalIterator* iter, SequenceNumber s, bool arena_mode,
          uint64_t max_sequential_skip_in_iterations,
          ReadCallback* read_callback, DBImpl* db_impl, ColumnFamilyData* cfd,
-         bool allow_blob)
+         bool allow_blob, const Version* version)
       : env_(_env),
         logger_(cf_options.info_log),
         user_comparator_(cmp),
@@ -139,6 +141,14 @@ class DBIter final: public Iterator {
         total_order_seek_(read_options.total_order_seek),
         allow_blob_(allow_blob),
         is_blob_(false),
+        // Blob indexes are only read from the blob files of the version;
+        // in a DB without any, they belong to BlobDB
+        version_(allow_blob || version == nullptr ||
+                         version->storage_info()->GetBlobFiles().empty()
+                     ? nullptr
+                     : version),
+        blob_fetcher_(version_, read_options),
+        is_blob_value_(false),
         arena_mode_(arena_mode),
         range_del_agg_(&cf_options.internal_comparator, s),
         db_impl_(db_impl),
@@ -193,6 +203,8 @@ class DBIter final: public Iterator {
       // If pinned_value_ is set then the result of merge operator is one of
       // the merge operands and we should return it.
       return pinned_value_.data() ? pinned_value_ : saved_value_;
+    } else if (is_blob_value_) {
+      return blob_value_;
     } else if (direction_ == kReverse) {
       return pinned_value_;
     } else {
@@ -234,6 +246,8 @@ class DBIter final: public Iterator {
   }
 
   inline void Next() final override;
+  size_t NextN(size_t n, Slice* keys, Slice* values,
+               std::string* buf) final override;
   inline void Prev() final override;
   inline void Seek(const Slice& target) final override;
   inline void SeekForPrev(const Slice& target) final override;
@@ -253,6 +267,8 @@ class DBIter final: public Iterator {
   // PRE: iter_->Valid() && status_.ok()
   // Return false if there was an error, and status() is non-ok, valid_ = false;
   // in this case callers would usually stop what they were doing and return.
+  // Next() without releasing the blocks pinned so far
+  inline void NextInternal();
   bool ReverseToForward();
   bool ReverseToBackward();
   bool FindValueForCurrentKey();
@@ -263,14 +279,22 @@ class DBIter final: public Iterator {
   bool ParseKey(ParsedInternalKey* key);
   bool MergeValuesNewToOld();
 
+  // Reads the value of a blob index of version_ into blob_value_. Returns
+  // false and makes the iterator invalid if it could not be read.
+  bool SetBlobValue(const Slice& user_key, const Slice& blob_index);
+  void ResetBlobValue() {
+    is_blob_value_ = false;
+    blob_value_.Reset();
+  }
+
   void PrevInternal();
   bool TooManyInternalKeysSkipped(bool increment = true);
   inline bool IsVisible(SequenceNumber sequence);
 
   // Temporarily pin the blocks that we encounter until ReleaseTempPinnedData()
-  // is called
+  // is called. Blocks may already be pinned for a batch of NextN().
   void TempPinData() {
-    if (!pin_thru_lifetime_) {
+    if (!pin_thru_lifetime_ && !pinned_iters_mgr_.PinningEnabled()) {
       pinned_iters_mgr_.StartPinning();
     }
   }
@@ -343,6 +367,13 @@ class DBIter final: public Iterator {
   const bool total_order_seek_;
   bool allow_blob_;
   bool is_blob_;
+  // The version to read the values of blob indexes from; null if they are
+  // returned as they are, or if the iterator is not over a version
+  const Version* version_;
+  BlobFetcher blob_fetcher_;
+  // The value of the current entry, if it is a blob index of version_
+  PinnableSlice blob_value_;
+  bool is_blob_value_;
   bool arena_mode_;
   // List of operands for merge operator.
   MergeContext merge_context_;
@@ -362,6 +393,19 @@ class DBIter final: public Iterator {
   SequenceNumber start_seqnum_;
 };
 
+bool DBIter::SetBlobValue(const Slice& user_key, const Slice& blob_index) {
+  assert(version_ != nullptr);
+  assert(!is_blob_value_);
+  Status s = blob_fetcher_.FetchBlob(user_key, blob_index, &blob_value_);
+  if (!s.ok()) {
+    status_ = s;
+    valid_ = false;
+    return false;
+  }
+  is_blob_value_ = true;
+  return true;
+}
+
 inline bool DBIter::ParseKey(ParsedInternalKey* ikey) {
   if (!ParseInternalKey(iter_.key(), ikey)) {
     status_ = Status::Corruption("corrupted internal key in DBIter");
@@ -381,6 +425,70 @@ void DBIter::Next() {
   PERF_CPU_TIMER_GUARD(iter_next_cpu_nanos, env_);
   // Release temporarily pinned blocks from last operation
   ReleaseTempPinnedData();
+  NextInternal();
+}
+
+size_t DBIter::NextN(size_t n, Slice* keys, Slice* values,
+                     std::string* buf) {
+  buf->clear();
+  if (n == 0 || !valid_) {
+    return 0;
+  }
+  assert(status_.ok());
+
+  PERF_CPU_TIMER_GUARD(iter_next_cpu_nanos, env_);
+  // Slices with a null data pointer are copied to buf, and are pointed into
+  // it once it stops growing. The current entry may be in blocks pinned by
+  // the last operation, which are released below, so it is always copied.
+  size_t count = 0;
+  auto add = [&](bool key_pinned, bool value_pinned) {
+    const Slice k = key();
+    const Slice v = value();
+    if (key_pinned) {
+      keys[count] = k;
+    } else {
+      buf->append(k.data(), k.size());
+      keys[count] = Slice(nullptr, k.size());
+    }
+    if (value_pinned) {
+      values[count] = v;
+    } else {
+      buf->append(v.data(), v.size());
+      values[count] = Slice(nullptr, v.size());
+    }
+    count++;
+  };
+  add(false /* key_pinned */, false /* value_pinned */);
+
+  // Keep the blocks of the other entries until the next operation, so that
+  // their values need not be copied
+  ReleaseTempPinnedData();
+  TempPinData();
+  while (true) {
+    NextInternal();
+    if (!valid_ || count == n) {
+      break;
+    }
+    add(pin_thru_lifetime_ && saved_key_.IsKeyPinned(),
+        !current_entry_is_merged_ && !is_blob_value_ &&
+            iter_.iter()->IsValuePinned());
+  }
+
+  const char* p = buf->data();
+  for (size_t i = 0; i < count; i++) {
+    if (keys[i].data() == nullptr) {
+      keys[i] = Slice(p, keys[i].size());
+      p += keys[i].size();
+    }
+    if (values[i].data() == nullptr) {
+      values[i] = Slice(p, values[i].size());
+      p += values[i].size();
+    }
+  }
+  return count;
+}
+
+inline void DBIter::NextInternal() {
   local_stats_.skip_count_ += num_internal_keys_skipped_;
   local_stats_.skip_count_--;
   num_internal_keys_skipped_ = 0;
@@ -460,6 +568,7 @@ inline bool DBIter::FindNextUserEntryInternal(bool skipping, bool prefix_check)
   bool reseek_done = false;
 
   is_blob_ = false;
+  ResetBlobValue();
 
   do {
     // Will update is_key_seqnum_zero_ as soon as we parsed the current key
@@ -560,6 +669,13 @@ inline bool DBIter::FindNextUserEntryInternal(bool skipping, bool prefix_check)
                 reseek_done = false;
                 PERF_COUNTER_ADD(internal_delete_skipped_count, 1);
               } else if (ikey_.type == kTypeBlobIndex) {
+                if (version_ != nullptr) {
+                  if (!SetBlobValue(ikey_.user_key, iter_.value())) {
+                    return false;
+                  }
+                  valid_ = true;
+                  return true;
+                }
                 if (!allow_blob_) {
                   ROCKS_LOG_ERROR(logger_, "Encounter unexpected blob index.");
                   status_ = Status::NotSupported(
@@ -731,6 +847,26 @@ bool DBIter::MergeValuesNewToOld() {
       merge_context_.PushOperand(
           iter_.value(), iter_.iter()->IsValuePinned() /* operand_pinned */);
       PERF_COUNTER_ADD(internal_merge_count, 1);
+    } else if (kTypeBlobIndex == ikey.type && version_ != nullptr) {
+      // hit a blob index of the version, merge its value with the operands
+      if (!SetBlobValue(ikey.user_key, iter_.value())) {
+        return false;
+      }
+      s = MergeHelper::TimedFullMerge(
+          merge_operator_, ikey.user_key, &blob_value_,
+          merge_context_.GetOperands(), &saved_value_, logger_, statistics_,
+          env_, &pinned_value_, true);
+      if (!s.ok()) {
+        valid_ = false;
+        status_ = s;
+        return false;
+      }
+      iter_.Next();
+      if (!iter_.status().ok()) {
+        valid_ = false;
+        return false;
+      }
+      return true;
     } else if (kTypeBlobIndex == ikey.type) {
       if (!allow_blob_) {
         ROCKS_LOG_ERROR(logger_, "Encounter unexpected blob index.");
@@ -928,6 +1064,7 @@ bool DBIter::FindValueForCurrentKey() {
   assert(iter_.Valid());
   merge_context_.Clear();
   current_entry_is_merged_ = false;
+  ResetBlobValue();
   // last entry before merge (could be kTypeDeletion, kTypeSingleDeletion or
   // kTypeValue)
   ValueType last_not_merge_type = kTypeDeletion;
@@ -1025,6 +1162,15 @@ bool DBIter::FindValueForCurrentKey() {
             merge_operator_, saved_key_.GetUserKey(), nullptr,
             merge_context_.GetOperands(), &saved_value_, logger_, statistics_,
             env_, &pinned_value_, true);
+      } else if (last_not_merge_type == kTypeBlobIndex &&
+                 version_ != nullptr) {
+        if (!SetBlobValue(saved_key_.GetUserKey(), pinned_value_)) {
+          return false;
+        }
+        s = MergeHelper::TimedFullMerge(
+            merge_operator_, saved_key_.GetUserKey(), &blob_value_,
+            merge_context_.GetOperands(), &saved_value_, logger_, statistics_,
+            env_, &pinned_value_, true);
       } else if (last_not_merge_type == kTypeBlobIndex) {
         if (!allow_blob_) {
           ROCKS_LOG_ERROR(logger_, "Encounter unexpected blob index.");
@@ -1049,6 +1195,12 @@ bool DBIter::FindValueForCurrentKey() {
       // do nothing - we've already has value in pinned_value_
       break;
     case kTypeBlobIndex:
+      if (version_ != nullptr) {
+        if (!SetBlobValue(saved_key_.GetUserKey(), pinned_value_)) {
+          return false;
+        }
+        break;
+      }
       if (!allow_blob_) {
         ROCKS_LOG_ERROR(logger_, "Encounter unexpected blob index.");
         status_ = Status::NotSupported(
@@ -1119,6 +1271,13 @@ bool DBIter::FindValueForCurrentKeyUsingSeek() {
     valid_ = false;
     return true;
   }
+  if (ikey.type == kTypeBlobIndex && version_ != nullptr) {
+    if (!SetBlobValue(ikey.user_key, iter_.value())) {
+      return false;
+    }
+    valid_ = true;
+    return true;
+  }
   if (ikey.type == kTypeBlobIndex && !allow_blob_) {
     ROCKS_LOG_ERROR(logger_, "Encounter unexpected blob index.");
     status_ = Status::NotSupported(
@@ -1179,6 +1338,21 @@ bool DBIter::FindValueForCurrentKeyUsingSeek() {
       merge_context_.PushOperand(
           iter_.value(), iter_.iter()->IsValuePinned() /* operand_pinned */);
       PERF_COUNTER_ADD(internal_merge_count, 1);
+    } else if (ikey.type == kTypeBlobIndex && version_ != nullptr) {
+      if (!SetBlobValue(saved_key_.GetUserKey(), iter_.value())) {
+        return false;
+      }
+      Status s = MergeHelper::TimedFullMerge(
+          merge_operator_, saved_key_.GetUserKey(), &blob_value_,
+          merge_context_.GetOperands(), &saved_value_, logger_, statistics_,
+          env_, &pinned_value_, true);
+      if (!s.ok()) {
+        valid_ = false;
+        status_ = s;
+        return false;
+      }
+      valid_ = true;
+      return true;
     } else if (ikey.type == kTypeBlobIndex) {
       if (!allow_blob_) {
         ROCKS_LOG_ERROR(logger_, "Encounter unexpected blob index.");
@@ -1515,11 +1689,12 @@ Iterator* NewDBIterator(Env* env, const ReadOptions& read_options,
                         const SequenceNumber& sequence,
                         uint64_t max_sequential_skip_in_iterations,
                         ReadCallback* read_callback, DBImpl* db_impl,
-                        ColumnFamilyData* cfd, bool allow_blob) {
+                        ColumnFamilyData* cfd, bool allow_blob,
+                        const Version* version) {
   DBIter* db_iter = new DBIter(
       env, read_options, cf_options, mutable_cf_options, user_key_comparator,
       internal_iter, sequence, false, max_sequential_skip_in_iterations,
-      read_callback, db_impl, cfd, allow_blob);
+      read_callback, db_impl, cfd, allow_blob, version);
   return db_iter;
 }
 
@@ -1543,6 +1718,10 @@ inline void ArenaWrappedDBIter::SeekForPrev(const Slice& target) {
   db_iter_->SeekForPrev(target);
 }
 inline void ArenaWrappedDBIter::Next() { db_iter_->Next(); }
+size_t ArenaWrappedDBIter::NextN(size_t n, Slice* keys, Slice* values,
+                                 std::string* buf) {
+  return db_iter_->NextN(n, keys, values, buf);
+}
 inline void ArenaWrappedDBIter::Prev() { db_iter_->Prev(); }
 inline Slice ArenaWrappedDBIter::key() const { return db_iter_->key(); }
 inline Slice ArenaWrappedDBIter::value() const { return db_iter_->value(); }
@@ -1568,12 +1747,12 @@ void ArenaWrappedDBIter::Init(Env* env, const ReadOptions& read_options,
                               uint64_t version_number,
                               ReadCallback* read_callback, DBImpl* db_impl,
                               ColumnFamilyData* cfd, bool allow_blob,
-                              bool allow_refresh) {
+                              bool allow_refresh, const Version* version) {
   auto mem = arena_.AllocateAligned(sizeof(DBIter));
   db_iter_ = new (mem) DBIter(env, read_options, cf_options, mutable_cf_options,
                               cf_options.user_comparator, nullptr, sequence,
                               true, max_sequential_skip_in_iteration,
-                              read_callback, db_impl, cfd, allow_blob);
+                              read_callback, db_impl, cfd, allow_blob, version);
   sv_number_ = version_number;
   allow_refresh_ = allow_refresh;
 }
@@ -1601,7 +1780,7 @@ Status ArenaWrappedDBIter::Refresh() {
     Init(env, read_options_, *(cfd_->ioptions()), sv->mutable_cf_options,
          latest_seq, sv->mutable_cf_options.max_sequential_skip_in_iterations,
          cur_sv_number, read_callback_, db_impl_, cfd_, allow_blob_,
-         allow_refresh_);
+         allow_refresh_, sv->current);
 
     InternalIterator* internal_iter = db_impl_->NewInternalIterator(
         read_options_, cfd_, sv, &arena_, db_iter_->GetRangeDelAggregator(),
@@ -1620,11 +1799,11 @@ ArenaWrappedDBIter* NewArenaWrappedDbIterator(
     const MutableCFOptions& mutable_cf_options, const SequenceNumber& sequence,
     uint64_t max_sequential_skip_in_iterations, uint64_t version_number,
     ReadCallback* read_callback, DBImpl* db_impl, ColumnFamilyData* cfd,
-    bool allow_blob, bool allow_refresh) {
+    bool allow_blob, bool allow_refresh, const Version* version) {
   ArenaWrappedDBIter* iter = new ArenaWrappedDBIter();
   iter->Init(env, read_options, cf_options, mutable_cf_options, sequence,
              max_sequential_skip_in_iterations, version_number, read_callback,
-             db_impl, cfd, allow_blob, allow_refresh);
+             db_impl, cfd, allow_blob, allow_refresh, version);
   if (db_impl != nullptr && cfd != nullptr && allow_refresh) {
     iter->StoreRefreshInfo(read_options, db_impl, cfd, read_callback,
                            allow_blob);
@@ -48,10 +48,13 @@ namespace rocksdb {
 //
 class Arena;
 class DBIter;
+class Version;
 
 // Return a new iterator that converts internal keys (yielded by
 // "*internal_iter") that were live at the specified `sequence` number
 // into appropriate user keys.
+// If `version` is set and `allow_blob` is not, the values of blob indexes
+// are read from the blob files of the version.
 extern Iterator* NewDBIterator(
     Env* env, const ReadOptions& read_options,
     const ImmutableCFOptions& cf_options,
@@ -59,7 +62,8 @@ extern Iterator* NewDBIterator(
     const Comparator* user_key_comparator, InternalIterator* internal_iter,
     const SequenceNumber& sequence, uint64_t max_sequential_skip_in_iterations,
     ReadCallback* read_callback, DBImpl* db_impl = nullptr,
-    ColumnFamilyData* cfd = nullptr, bool allow_blob = false);
+    ColumnFamilyData* cfd = nullptr, bool allow_blob = false,
+    const Version* version = nullptr);
 
 // A wrapper iterator which wraps DB Iterator and the arena, with which the DB
 // iterator is supposed be allocated. This class is used as an entry point of
@@ -86,6 +90,8 @@ class ArenaWrappedDBIter : public Iterator {
   virtual void Seek(const Slice& target) override;
   virtual void SeekForPrev(const Slice& target) override;
   virtual void Next() override;
+  virtual size_t NextN(size_t n, Slice* keys, Slice* values,
+                       std::string* buf) override;
   virtual void Prev() override;
   virtual Slice key() const override;
   virtual Slice value() const override;
@@ -101,7 +107,8 @@ class ArenaWrappedDBIter : public Iterator {
             const SequenceNumber& sequence,
             uint64_t max_sequential_skip_in_iterations, uint64_t version_number,
             ReadCallback* read_callback, DBImpl* db_impl, ColumnFamilyData* cfd,
-            bool allow_blob, bool allow_refresh);
+            bool allow_blob, bool allow_refresh,
+            const Version* version = nullptr);
 
   void StoreRefreshInfo(const ReadOptions& read_options, DBImpl* db_impl,
                         ColumnFamilyData* cfd, ReadCallback* read_callback,
@@ -135,5 +142,5 @@ extern ArenaWrappedDBIter* NewArenaWrappedDbIterator(
     uint64_t max_sequential_skip_in_iterations, uint64_t version_number,
     ReadCallback* read_callback, DBImpl* db_impl = nullptr,
     ColumnFamilyData* cfd = nullptr, bool allow_blob = false,
-    bool allow_refresh = true);
+    bool allow_refresh = true, const Version* version = nullptr);
 }  // namespace rocksdb
@@ -1510,6 +1510,81 @@ TEST_P(DBIteratorTest, PinnedDataIteratorMultipleFiles) {
 }
 #endif
 
+TEST_P(DBIteratorTest, NextN) {
+  Options options = CurrentOptions();
+  options.merge_operator = MergeOperators::CreateStringAppendOperator();
+  BlockBasedTableOptions table_options;
+  table_options.block_size = 256;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  // A file of values, a file of deletes, overwrites and merges, and more
+  // overwrites in the memtable
+  const int kNumKeys = 500;
+  Random rnd(301);
+  std::map<std::string, std::string> expected;
+  for (int i = 0; i < kNumKeys; i++) {
+    expected[Key(i)] = RandomString(&rnd, 50);
+    ASSERT_OK(Put(Key(i), expected[Key(i)]));
+  }
+  ASSERT_OK(Flush());
+  for (int i = 0; i < kNumKeys; i += 7) {
+    expected.erase(Key(i));
+    ASSERT_OK(Delete(Key(i)));
+  }
+  for (int i = 1; i < kNumKeys; i += 11) {
+    auto it = expected.find(Key(i));
+    expected[Key(i)] = it == expected.end() ? "m" : it->second + ",m";
+    ASSERT_OK(Merge(Key(i), "m"));
+  }
+  ASSERT_OK(Flush());
+  for (int i = 2; i < kNumKeys; i += 13) {
+    expected[Key(i)] = RandomString(&rnd, 20);
+    ASSERT_OK(Put(Key(i), expected[Key(i)]));
+  }
+
+  for (bool pin_data : {false, true}) {
+    for (size_t batch_size : {1, 7, 64, 1000}) {
+      ReadOptions ro;
+      ro.pin_data = pin_data;
+      std::unique_ptr<Iterator> iter(NewIterator(ro));
+      std::vector<Slice> keys(batch_size);
+      std::vector<Slice> values(batch_size);
+      std::string buf;
+      auto expected_it = expected.begin();
+      iter->SeekToFirst();
+      while (iter->Valid()) {
+        size_t n = iter->NextN(batch_size, keys.data(), values.data(), &buf);
+        ASSERT_GT(n, 0U);
+        ASSERT_TRUE(n == batch_size || !iter->Valid());
+        // The whole batch is still readable
+        for (size_t i = 0; i < n; i++, ++expected_it) {
+          ASSERT_TRUE(expected_it != expected.end());
+          ASSERT_EQ(expected_it->first, keys[i].ToString());
+          ASSERT_EQ(expected_it->second, values[i].ToString());
+        }
+        // and the iterator is at the entry after it
+        if (iter->Valid()) {
+          ASSERT_EQ(expected_it->first, iter->key().ToString());
+          ASSERT_EQ(expected_it->second, iter->value().ToString());
+        }
+      }
+      ASSERT_OK(iter->status());
+      ASSERT_TRUE(expected_it == expected.end());
+      ASSERT_EQ(0U, iter->NextN(batch_size, keys.data(), values.data(), &buf));
+
+      // A batch after moving backwards
+      iter->SeekToLast();
+      iter->Prev();
+      size_t n = iter->NextN(batch_size, keys.data(), values.data(), &buf);
+      ASSERT_EQ(std::min<size_t>(batch_size, 2), n);
+      ASSERT_EQ(std::next(expected.rbegin())->first, keys[0].ToString());
+      ASSERT_EQ(std::next(expected.rbegin())->second, values[0].ToString());
+      ASSERT_EQ(n == 2, !iter->Valid());
+    }
+  }
+}
+
 TEST_P(DBIteratorTest, PinnedDataIteratorMergeOperator) {
   Options options = CurrentOptions();
   BlockBasedTableOptions table_options;
@@ -2132,6 +2207,59 @@ TEST_P(DBIteratorTest, ReadAhead) {
   delete iter;
 }
 
+TEST_P(DBIteratorTest, AsyncReadAhead) {
+  Options options = CurrentOptions();
+  options.env = env_;
+  options.disable_auto_compactions = true;
+  options.max_background_readaheads = 1;
+  options.compaction_readahead_size = 16 * 1024;
+  BlockBasedTableOptions table_options;
+  table_options.block_size = 1024;
+  table_options.no_block_cache = true;
+  options.table_factory.reset(new BlockBasedTableFactory(table_options));
+  Reopen(options);
+
+  // Two overlapping runs of files, so that compacting them is not a move
+  Random rnd(301);
+  std::vector<std::string> values(1000);
+  for (int run = 0; run < 2; run++) {
+    for (int i = 0; i < 1000; i++) {
+      values[i] = RandomString(&rnd, 200 + rnd.Uniform(800));
+      ASSERT_OK(Put(Key(i), values[i]));
+      if (i % 300 == 299) {
+        ASSERT_OK(Flush());
+      }
+    }
+    ASSERT_OK(Flush());
+  }
+
+  for (size_t readahead_size : {static_cast<size_t>(0),
+                                static_cast<size_t>(8 * 1024)}) {
+    ReadOptions read_options;
+    read_options.async_readahead = true;
+    read_options.readahead_size = readahead_size;
+    std::unique_ptr<Iterator> iter(NewIterator(read_options));
+    int count = 0;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      ASSERT_EQ(values[count], iter->value().ToString());
+      count++;
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(1000, count);
+    for (int i = 0; i < 1000; i += 97) {
+      iter->Seek(Key(i));
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(values[i], iter->value().ToString());
+    }
+  }
+
+  // Compaction inputs are read ahead in the background too
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  for (int i = 0; i < 1000; i++) {
+    ASSERT_EQ(values[i], Get(Key(i)));
+  }
+}
+
 // Insert a key, create a snapshot iterator, overwrite key lots of times,
 // seek to a smaller key. Expect DBIter to fall back to a seek instead of
 // going through all the overwrites linearly.
@@ -455,6 +455,144 @@ TEST_F(DBTest2, SharedWriteBufferLimitAcrossDB) {
   rocksdb::SyncPoint::GetInstance()->DisableProcessing();
 }
 
+TEST_F(DBTest2, ArbitratedWriteBufferAcrossDB) {
+  std::string dbname2 = test::PerThreadDBPath("db_arbitrated_wb_db2");
+  Options options = CurrentOptions();
+  options.arena_block_size = 4096;
+  // Avoid undeterministic value by malloc_usable_size();
+  // Force arena block size to 1
+  rocksdb::SyncPoint::GetInstance()->SetCallBack(
+      "Arena::Arena:0", [&](void* arg) {
+        size_t* block_size = static_cast<size_t*>(arg);
+        *block_size = 1;
+      });
+
+  rocksdb::SyncPoint::GetInstance()->SetCallBack(
+      "Arena::AllocateNewBlock:0", [&](void* arg) {
+        std::pair<size_t*, size_t*>* pair =
+            static_cast<std::pair<size_t*, size_t*>*>(arg);
+        *std::get<0>(*pair) = *std::get<1>(*pair);
+      });
+  rocksdb::SyncPoint::GetInstance()->EnableProcessing();
+
+  options.write_buffer_size = 500000;  // this is never hit
+  // Use a write buffer total size so that the soft limit is about
+  // 105000.
+  options.write_buffer_manager.reset(
+      new WriteBufferManager(120000, {}, true /* arbitrate */));
+  Reopen(options);
+
+  ASSERT_OK(DestroyDB(dbname2, options));
+  DB* db2 = nullptr;
+  ASSERT_OK(DB::Open(options, dbname2, &db2));
+
+  WriteOptions wo;
+  wo.disableWAL = true;
+
+  ASSERT_OK(Put(Key(1), DummyString(30000), wo));
+  ASSERT_OK(db2->Put(wo, Key(1), DummyString(60000)));
+  ASSERT_OK(Put(Key(2), DummyString(20000), wo));
+  uint64_t usage = 0;
+  ASSERT_TRUE(
+      db2->GetIntProperty(DB::Properties::kDBWriteBufferUsage, &usage));
+  ASSERT_GE(usage, 60000);
+
+  // The write that finds the buffer full goes to DB1, but the largest
+  // memtable, in DB2, is the one flushed
+  ASSERT_OK(Put(Key(3), DummyString(1), wo));
+  for (int i = 0; i < 10000; i++) {
+    if (GetNumberOfSstFilesForColumnFamily(db2, "default") > 0) {
+      break;
+    }
+    env_->SleepForMicroseconds(1000);
+  }
+  static_cast<DBImpl*>(db2)->TEST_WaitForFlushMemTable();
+  dbfull()->TEST_WaitForFlushMemTable();
+  ASSERT_EQ(GetNumberOfSstFilesForColumnFamily(db2, "default"),
+            static_cast<uint64_t>(1));
+  ASSERT_EQ(GetNumberOfSstFilesForColumnFamily(db_, "default"),
+            static_cast<uint64_t>(0));
+
+  ASSERT_TRUE(
+      db_->GetIntProperty(DB::Properties::kDBWriteBufferUsage, &usage));
+  ASSERT_GE(usage, 50000);
+  ASSERT_TRUE(
+      db2->GetIntProperty(DB::Properties::kDBWriteBufferUsage, &usage));
+  ASSERT_LT(usage, 50000);
+
+  delete db2;
+  ASSERT_OK(DestroyDB(dbname2, options));
+
+  rocksdb::SyncPoint::GetInstance()->DisableProcessing();
+}
+
+TEST_F(DBTest2, WriteBufferDelayKeepsDelayedWriteRate) {
+  Options options = CurrentOptions();
+  options.arena_block_size = 4096;
+  // Avoid undeterministic value by malloc_usable_size();
+  // Force arena block size to 1
+  rocksdb::SyncPoint::GetInstance()->SetCallBack(
+      "Arena::Arena:0", [&](void* arg) {
+        size_t* block_size = static_cast<size_t*>(arg);
+        *block_size = 1;
+      });
+
+  rocksdb::SyncPoint::GetInstance()->SetCallBack(
+      "Arena::AllocateNewBlock:0", [&](void* arg) {
+        std::pair<size_t*, size_t*>* pair =
+            static_cast<std::pair<size_t*, size_t*>*>(arg);
+        *std::get<0>(*pair) = *std::get<1>(*pair);
+      });
+  rocksdb::SyncPoint::GetInstance()->EnableProcessing();
+
+  options.write_buffer_size = 500000;  // this is never hit
+  options.delayed_write_rate = 64 << 20;
+  options.write_buffer_manager.reset(
+      new WriteBufferManager(120000, {}, true /* arbitrate */));
+  Reopen(options);
+
+  WriteOptions wo;
+  wo.disableWAL = true;
+
+  // Keep the memtables around so that the memory goes over the buffer size
+  ASSERT_OK(dbfull()->PauseBackgroundWork());
+  for (int i = 0; i < 8; i++) {
+    ASSERT_OK(Put(Key(i), DummyString(20000), wo));
+  }
+  WriteController& write_controller = dbfull()->TEST_write_controler();
+  {
+    InstrumentedMutexLock l(dbfull()->mutex());
+    ASSERT_TRUE(write_controller.NeedsDelay());
+    ASSERT_EQ(options.delayed_write_rate,
+              write_controller.delayed_write_rate());
+  }
+
+  ASSERT_OK(dbfull()->ContinueBackgroundWork());
+  dbfull()->TEST_WaitForFlushMemTable();
+  for (int i = 0; i < 10000; i++) {
+    if (options.write_buffer_manager->memory_usage() <
+        options.write_buffer_manager->buffer_size()) {
+      break;
+    }
+    env_->SleepForMicroseconds(1000);
+    dbfull()->TEST_WaitForFlushMemTable();
+  }
+  ASSERT_LT(options.write_buffer_manager->memory_usage(),
+            options.write_buffer_manager->buffer_size());
+
+  // The next write lifts the delay, and the rate the column families' write
+  // stalls start from is still delayed_write_rate
+  ASSERT_OK(Put(Key(100), DummyString(1), wo));
+  {
+    InstrumentedMutexLock l(dbfull()->mutex());
+    ASSERT_FALSE(write_controller.NeedsDelay());
+    ASSERT_EQ(options.delayed_write_rate,
+              write_controller.delayed_write_rate());
+  }
+
+  rocksdb::SyncPoint::GetInstance()->DisableProcessing();
+}
+
 TEST_F(DBTest2, TestWriteBufferNoLimitWithCache) {
   Options options = CurrentOptions();
   options.arena_block_size = 4096;
@@ -1233,6 +1371,318 @@ TEST_F(DBTest2, PresetCompressionDictLocality) {
   }
 }
 
+TEST_F(DBTest2, SharedCompressionDict) {
+  // Verifies that the files written to a level share a compression
+  // dictionary, that a new one is built every `shared_dict_files` files, and
+  // that the dictionaries survive a reopen and are cached once per dictionary.
+  CompressionType compression_type;
+  if (Zlib_Supported()) {
+    compression_type = kZlibCompression;
+  } else if (LZ4_Supported()) {
+    compression_type = kLZ4Compression;
+  } else if (ZSTD_Supported()) {
+    compression_type = kZSTD;
+  } else {
+    return;
+  }
+  const int kNumEntriesPerFile = 1 << 8;
+  const int kNumBytesPerEntry = 1 << 10;
+  const int kNumFiles = 8;
+  const uint32_t kSharedDictFiles = 3;
+  Options options = CurrentOptions();
+  options.compression = compression_type;
+  options.compression_opts.max_dict_bytes = 1 << 12;
+  options.compression_opts.shared_dict_files = kSharedDictFiles;
+  options.target_file_size_base = kNumEntriesPerFile * kNumBytesPerEntry / 2;
+  options.statistics = rocksdb::CreateDBStatistics();
+  BlockBasedTableOptions table_options;
+  table_options.block_cache = NewLRUCache(8 << 20);
+  table_options.cache_index_and_filter_blocks = true;
+  options.table_factory.reset(new BlockBasedTableFactory(table_options));
+  Reopen(options);
+
+  Random rnd(301);
+  std::vector<std::string> values;
+  for (int i = 0; i < kNumFiles; ++i) {
+    for (int j = 0; j < kNumEntriesPerFile; ++j) {
+      std::string value;
+      test::CompressibleString(&rnd, 0.5, kNumBytesPerEntry, &value);
+      ASSERT_OK(Put(Key(i * kNumEntriesPerFile + j), value));
+      values.push_back(value);
+    }
+    ASSERT_OK(Flush());
+    MoveFilesToLevel(1);
+  }
+
+  std::vector<std::string> compression_dicts;
+  rocksdb::SyncPoint::GetInstance()->SetCallBack(
+      "BlockBasedTableBuilder::WriteCompressionDictBlock:RawDict",
+      [&](void* arg) {
+        compression_dicts.emplace_back(static_cast<Slice*>(arg)->ToString());
+      });
+  rocksdb::SyncPoint::GetInstance()->EnableProcessing();
+  CompactRangeOptions compact_range_opts;
+  compact_range_opts.bottommost_level_compaction =
+      BottommostLevelCompaction::kForce;
+  ASSERT_OK(db_->CompactRange(compact_range_opts, nullptr, nullptr));
+  rocksdb::SyncPoint::GetInstance()->DisableProcessing();
+  rocksdb::SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  // Every file stores the dictionary it is compressed with, and a new one is
+  // built for every kSharedDictFiles files
+  const int num_files = NumTableFilesAtLevel(1);
+  ASSERT_GT(num_files, static_cast<int>(kSharedDictFiles));
+  ASSERT_EQ(num_files, static_cast<int>(compression_dicts.size()));
+  std::set<std::string> distinct_dicts(compression_dicts.begin(),
+                                       compression_dicts.end());
+  const size_t num_dicts =
+      (num_files + kSharedDictFiles - 1) / kSharedDictFiles;
+  ASSERT_EQ(num_dicts, distinct_dicts.size());
+  for (int i = 0; i < num_files; ++i) {
+    ASSERT_EQ(compression_dicts[i / kSharedDictFiles * kSharedDictFiles],
+              compression_dicts[i]);
+  }
+
+  TablePropertiesCollection props;
+  ASSERT_OK(db_->GetPropertiesOfAllTables(&props));
+  std::set<uint64_t> dict_ids;
+  for (const auto& file_and_props : props) {
+    const auto& user_props = file_and_props.second->user_collected_properties;
+    auto pos = user_props.find(BlockBasedTablePropertyNames::kCompressionDictId);
+    ASSERT_TRUE(pos != user_props.end());
+    dict_ids.insert(DecodeFixed64(pos->second.data()));
+  }
+  ASSERT_EQ(num_dicts, dict_ids.size());
+
+  // The last dictionary of the level is restored from the MANIFEST, and the
+  // files that share a dictionary share its block cache entry
+  auto* cfd = static_cast<ColumnFamilyHandleImpl*>(db_->DefaultColumnFamily())
+                  ->cfd();
+  auto last_dict = cfd->compression_dict_store()->TEST_GetDict(1);
+  ASSERT_NE(nullptr, last_dict);
+  ASSERT_EQ(compression_dicts.back(), last_dict->dict);
+  table_options.block_cache = NewLRUCache(8 << 20);
+  options.table_factory.reset(new BlockBasedTableFactory(table_options));
+  options.statistics = rocksdb::CreateDBStatistics();
+  Reopen(options);
+  cfd = static_cast<ColumnFamilyHandleImpl*>(db_->DefaultColumnFamily())
+            ->cfd();
+  auto recovered_dict = cfd->compression_dict_store()->TEST_GetDict(1);
+  ASSERT_NE(nullptr, recovered_dict);
+  ASSERT_EQ(last_dict->id, recovered_dict->id);
+  ASSERT_EQ(last_dict->dict, recovered_dict->dict);
+
+  for (int i = 0; i < kNumFiles * kNumEntriesPerFile; ++i) {
+    ASSERT_EQ(values[i], Get(Key(i)));
+  }
+  ASSERT_EQ(num_dicts, options.statistics->getTickerCount(
+                           BLOCK_CACHE_COMPRESSION_DICT_ADD));
+
+  // Like the other meta blocks, the dictionaries stay out of the block cache
+  // unless cache_index_and_filter_blocks is set
+  table_options.block_cache = NewLRUCache(8 << 20);
+  table_options.cache_index_and_filter_blocks = false;
+  options.table_factory.reset(new BlockBasedTableFactory(table_options));
+  options.statistics = rocksdb::CreateDBStatistics();
+  Reopen(options);
+  for (int i = 0; i < kNumFiles * kNumEntriesPerFile; ++i) {
+    ASSERT_EQ(values[i], Get(Key(i)));
+  }
+  ASSERT_EQ(0, options.statistics->getTickerCount(
+                   BLOCK_CACHE_COMPRESSION_DICT_ADD));
+}
+
+TEST_F(DBTest2, SharedCompressionDictRecordedOnce) {
+  // A dictionary is added to every version edit until one of them has been
+  // written to the MANIFEST, so that a failed MANIFEST write does not lose
+  // it.
+  if (!Zlib_Supported()) {
+    return;
+  }
+  Options options = CurrentOptions();
+  options.compression = kZlibCompression;
+  options.compression_opts.max_dict_bytes = 1 << 12;
+  options.compression_opts.shared_dict_files = 100;
+  DestroyAndReopen(options);
+  auto* store =
+      static_cast<ColumnFamilyHandleImpl*>(db_->DefaultColumnFamily())
+          ->cfd()
+          ->compression_dict_store();
+
+  Random rnd(301);
+  for (int i = 0; i < 64; ++i) {
+    std::string value;
+    test::CompressibleString(&rnd, 0.5, 1 << 10, &value);
+    ASSERT_OK(Put(Key(i), value));
+  }
+  ASSERT_OK(Flush());
+  ASSERT_NE(nullptr, store->TEST_GetDict(0));
+  VersionEdit flushed_edit;
+  store->AddUnpersistedTo(&flushed_edit);
+  ASSERT_TRUE(flushed_edit.GetCompressionDicts().empty());
+
+  auto dict = store->Install(1, "dictionary");
+  VersionEdit failed_edit;
+  store->AddUnpersistedTo(&failed_edit);
+  ASSERT_EQ(1, failed_edit.GetCompressionDicts().size());
+  VersionEdit next_edit;
+  store->AddUnpersistedTo(&next_edit);
+  ASSERT_EQ(1, next_edit.GetCompressionDicts().size());
+  ASSERT_EQ(dict->id, next_edit.GetCompressionDicts()[0].id);
+
+  store->MarkPersisted(next_edit);
+  VersionEdit last_edit;
+  store->AddUnpersistedTo(&last_edit);
+  ASSERT_TRUE(last_edit.GetCompressionDicts().empty());
+}
+
+TEST_F(DBTest2, ParallelCompression) {
+  // Data blocks compressed by several threads are written out in the order
+  // they were cut, so the files, their index and their filters are the same
+  // as with one thread.
+  std::vector<CompressionType> compression_types;
+  if (Snappy_Supported()) {
+    compression_types.push_back(kSnappyCompression);
+  }
+  if (Zlib_Supported()) {
+    compression_types.push_back(kZlibCompression);
+  }
+  if (LZ4_Supported()) {
+    compression_types.push_back(kLZ4Compression);
+  }
+  if (ZSTD_Supported()) {
+    compression_types.push_back(kZSTD);
+  }
+  const int kNumFiles = 4;
+  const int kNumKeysPerFile = 2000;
+  const int kValueSize = 200;
+
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  BlockBasedTableOptions table_options;
+  table_options.block_size = 1024;
+  table_options.index_type = BlockBasedTableOptions::kTwoLevelIndexSearch;
+  table_options.metadata_block_size = 256;
+  table_options.partition_filters = true;
+  table_options.filter_policy.reset(NewBloomFilterPolicy(10, false));
+  table_options.verify_compression = true;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+
+  for (auto compression_type : compression_types) {
+    options.compression = compression_type;
+    std::vector<std::string> expected_props;
+    for (uint32_t parallel_threads : {1, 4}) {
+      options.compression_opts.max_dict_bytes = 0;
+      options.compression_opts.parallel_threads = parallel_threads;
+      DestroyAndReopen(options);
+
+      Random rnd(301);
+      std::vector<std::string> values;
+      for (int i = 0; i < kNumFiles; ++i) {
+        for (int j = 0; j < kNumKeysPerFile; ++j) {
+          std::string value;
+          test::CompressibleString(&rnd, 0.5, kValueSize, &value);
+          ASSERT_OK(Put(Key(j * kNumFiles + i), value));
+          values.push_back(value);
+        }
+        ASSERT_OK(Flush());
+      }
+      ASSERT_EQ(kNumFiles, NumTableFilesAtLevel(0));
+      ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+      ASSERT_EQ(1, NumTableFilesAtLevel(1));
+
+      // The compacted file has the same layout with any number of compression
+      // threads.
+      TablePropertiesCollection props;
+      ASSERT_OK(db_->GetPropertiesOfAllTables(&props));
+      ASSERT_EQ(1U, props.size());
+      const auto& p = *props.begin()->second;
+      ASSERT_GT(p.num_data_blocks, 100);
+      std::string props_str =
+          ToString(p.data_size) + "," + ToString(p.num_data_blocks) + "," +
+          ToString(p.index_size) + "," + ToString(p.index_partitions) + "," +
+          ToString(p.filter_size);
+      if (parallel_threads == 1) {
+        expected_props.push_back(props_str);
+      } else {
+        ASSERT_EQ(expected_props[0], props_str);
+      }
+
+      // With a compression dictionary, data blocks are buffered until the
+      // dictionary is built, then handed to the compression threads.
+      options.compression_opts.max_dict_bytes = 4096;
+      Reopen(options);
+      CompactRangeOptions compact_range_opts;
+      compact_range_opts.bottommost_level_compaction =
+          BottommostLevelCompaction::kForce;
+      ASSERT_OK(db_->CompactRange(compact_range_opts, nullptr, nullptr));
+      ASSERT_OK(db_->VerifyChecksum());
+      for (int i = 0; i < kNumFiles; ++i) {
+        for (int j = 0; j < kNumKeysPerFile; ++j) {
+          ASSERT_EQ(values[i * kNumKeysPerFile + j],
+                    Get(Key(j * kNumFiles + i)));
+        }
+      }
+    }
+  }
+}
+
+TEST_F(DBTest2, DataBlockColumnLayout) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  BlockBasedTableOptions table_options;
+  table_options.block_size = 1024;
+  table_options.data_block_column_layout = true;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  // A file of values of the same length, then a file that deletes some of
+  // them and overwrites others with values of other lengths
+  const int kNumKeys = 1000;
+  std::map<std::string, std::string> expected;
+  for (int i = 0; i < kNumKeys; i++) {
+    expected[Key(i)] = ToString(100000000 + i);
+    ASSERT_OK(Put(Key(i), expected[Key(i)]));
+  }
+  ASSERT_OK(Flush());
+  for (int i = 0; i < kNumKeys; i += 3) {
+    if (i % 2 == 0) {
+      expected.erase(Key(i));
+      ASSERT_OK(Delete(Key(i)));
+    } else {
+      expected[Key(i)] = std::string(i % 50, 'v');
+      ASSERT_OK(Put(Key(i), expected[Key(i)]));
+    }
+  }
+  ASSERT_OK(Flush());
+
+  auto verify = [&]() {
+    for (int i = 0; i < kNumKeys; i++) {
+      auto it = expected.find(Key(i));
+      ASSERT_EQ(it == expected.end() ? "NOT_FOUND" : it->second, Get(Key(i)));
+    }
+    std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+    auto expected_it = expected.begin();
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next(), ++expected_it) {
+      ASSERT_TRUE(expected_it != expected.end());
+      ASSERT_EQ(expected_it->first, iter->key().ToString());
+      ASSERT_EQ(expected_it->second, iter->value().ToString());
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_TRUE(expected_it == expected.end());
+    for (iter->SeekToLast(); iter->Valid(); iter->Prev()) {
+      --expected_it;
+      ASSERT_EQ(expected_it->first, iter->key().ToString());
+      ASSERT_EQ(expected_it->second, iter->value().ToString());
+    }
+    ASSERT_TRUE(expected_it == expected.begin());
+  };
+  verify();
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  verify();
+  ASSERT_OK(db_->VerifyChecksum());
+}
+
 class CompactionCompressionListener : public EventListener {
  public:
   explicit CompactionCompressionListener(Options* db_options)
@@ -1706,6 +2156,76 @@ INSTANTIATE_TEST_CASE_P(PinL0IndexAndFilterBlocksTest,
                                           std::make_tuple(false, false),
                                           std::make_tuple(false, true)));
 
+TEST_F(DBTest2, PinPartitionsUpToLevel) {
+  for (bool in_background : {false, true}) {
+    Options options = CurrentOptions();
+    options.create_if_missing = true;
+    options.max_open_files = -1;
+    options.statistics = rocksdb::CreateDBStatistics();
+    if (in_background) {
+      options.max_background_readaheads = 1;
+    }
+    BlockBasedTableOptions table_options;
+    table_options.cache_index_and_filter_blocks = true;
+    table_options.index_type = BlockBasedTableOptions::kTwoLevelIndexSearch;
+    table_options.partition_filters = true;
+    table_options.filter_policy.reset(NewBloomFilterPolicy(20, false));
+    table_options.block_size = 64;
+    table_options.metadata_block_size = 64;
+    table_options.pin_filter_and_index_blocks_up_to_level = 1;
+    table_options.load_partitions_in_background = in_background;
+    options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+    DestroyAndReopen(options);
+
+    for (int i = 0; i < 100; i++) {
+      ASSERT_OK(Put("b" + ToString(1000 + i), "value"));
+    }
+    ASSERT_OK(Flush());
+    MoveFilesToLevel(2);
+    for (int i = 0; i < 100; i++) {
+      ASSERT_OK(Put("a" + ToString(1000 + i), "value"));
+    }
+    ASSERT_OK(Flush());
+    MoveFilesToLevel(1);
+    ASSERT_EQ("0,1,1", FilesPerLevel());
+
+    // Reopen with an empty block cache, loading the partitions of the L1
+    // file. The L2 file is not prefetched on open.
+    std::atomic<int> num_loaded(0);
+    rocksdb::SyncPoint::GetInstance()->SetCallBack(
+        "BlockBasedTable::LoadPartitions:Done",
+        [&](void* /*arg*/) { num_loaded++; });
+    rocksdb::SyncPoint::GetInstance()->EnableProcessing();
+    table_options.block_cache = NewLRUCache(1 << 20);
+    options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+    Reopen(options);
+    while (num_loaded.load() < 1) {
+      env_->SleepForMicroseconds(1000);
+    }
+    rocksdb::SyncPoint::GetInstance()->DisableProcessing();
+    rocksdb::SyncPoint::GetInstance()->ClearAllCallBacks();
+
+    uint64_t fm = TestGetTickerCount(options, BLOCK_CACHE_FILTER_MISS);
+    uint64_t fh = TestGetTickerCount(options, BLOCK_CACHE_FILTER_HIT);
+    uint64_t im = TestGetTickerCount(options, BLOCK_CACHE_INDEX_MISS);
+    uint64_t ih = TestGetTickerCount(options, BLOCK_CACHE_INDEX_HIT);
+
+    // The partitions of the L1 file are pinned
+    ASSERT_EQ("value", Get("a1050"));
+    ASSERT_EQ(fm, TestGetTickerCount(options, BLOCK_CACHE_FILTER_MISS));
+    ASSERT_EQ(fh, TestGetTickerCount(options, BLOCK_CACHE_FILTER_HIT));
+    ASSERT_EQ(im, TestGetTickerCount(options, BLOCK_CACHE_INDEX_MISS));
+    ASSERT_EQ(ih, TestGetTickerCount(options, BLOCK_CACHE_INDEX_HIT));
+
+    // Those of the L2 file are read through the block cache
+    ASSERT_EQ("value", Get("b1050"));
+    ASSERT_LT(fm + fh, TestGetTickerCount(options, BLOCK_CACHE_FILTER_MISS) +
+                           TestGetTickerCount(options, BLOCK_CACHE_FILTER_HIT));
+    ASSERT_LT(im + ih, TestGetTickerCount(options, BLOCK_CACHE_INDEX_MISS) +
+                           TestGetTickerCount(options, BLOCK_CACHE_INDEX_HIT));
+  }
+}
+
 #ifndef ROCKSDB_LITE
 TEST_F(DBTest2, MaxCompactionBytesTest) {
   Options options = CurrentOptions();
@@ -52,7 +52,8 @@ ROT13BlockCipher rot13Cipher_(16);
 #endif  // ROCKSDB_LITE
 
 DBTestBase::DBTestBase(const std::string path)
-    : mem_env_(nullptr),
+    : option_env_(kDefaultEnv),
+      mem_env_(nullptr),
       encrypted_env_(nullptr),
       option_config_(kDefault),
       s3_env_(nullptr) {
@@ -1838,6 +1838,74 @@ TEST_P(DBTestUniversalCompaction, FinalSortedRunCompactFilesConflict) {
   compact_files_thread.join();
 }
 
+TEST_P(DBTestUniversalCompaction, SubcompactionsSplitSingleSortedRun) {
+  if (num_levels_ == 1) {
+    // Compactions into L0 are not split into subcompactions
+    return;
+  }
+
+  class SubcompactionStatsCollector : public EventListener {
+   public:
+    void OnCompactionCompleted(DB* /*db*/,
+                               const CompactionJobInfo& ci) override {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stats_ = ci.stats;
+    }
+    CompactionJobStats stats() {
+      std::lock_guard<std::mutex> lock(mutex_);
+      return stats_;
+    }
+
+   private:
+    std::mutex mutex_;
+    CompactionJobStats stats_;
+  };
+
+  Options options = CurrentOptions();
+  options.compaction_style = kCompactionStyleUniversal;
+  options.num_levels = num_levels_;
+  options.disable_auto_compactions = true;
+  options.max_subcompactions = 4;
+  options.target_file_size_base = 16 << 10;  // 16KB
+  BlockBasedTableOptions table_options;
+  table_options.block_size = 1 << 10;  // 1KB
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  auto collector = std::make_shared<SubcompactionStatsCollector>();
+  options.listeners.emplace_back(collector);
+  DestroyAndReopen(options);
+
+  // The input file boundaries alone would allow a single subcompaction for a
+  // single input file, the keys sampled from its index allow all four.
+  const int kNumKeys = 1000;
+  Random rnd(301);
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_OK(Put(Key(i), RandomString(&rnd, 200)));
+  }
+  ASSERT_OK(Flush());
+  CompactRangeOptions cro;
+  cro.exclusive_manual_compaction = exclusive_manual_compaction_;
+  ASSERT_OK(db_->CompactRange(cro, nullptr, nullptr));
+  ASSERT_EQ(0, NumTableFilesAtLevel(0));
+  ASSERT_GT(NumTableFilesAtLevel(num_levels_ - 1), 0);
+
+  CompactionJobStats stats = collector->stats();
+  ASSERT_EQ(4U, stats.subcompaction_input_records.size());
+  ASSERT_EQ(4U, stats.subcompaction_elapsed_micros.size());
+  uint64_t total_records = 0;
+  for (uint64_t records : stats.subcompaction_input_records) {
+    ASSERT_GE(records, static_cast<uint64_t>(kNumKeys / 8));
+    ASSERT_LE(records, static_cast<uint64_t>(kNumKeys / 2));
+    total_records += records;
+  }
+  // Every subcompaction but the last also reads the first key past its end
+  ASSERT_EQ(static_cast<uint64_t>(kNumKeys + 3), total_records);
+  ASSERT_GE(stats.subcompaction_skew, 1.0);
+
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_EQ(200U, Get(Key(i)).size());
+  }
+}
+
 INSTANTIATE_TEST_CASE_P(UniversalCompactionNumLevels, DBTestUniversalCompaction,
                         ::testing::Combine(::testing::Values(1, 3, 5),
                                            ::testing::Bool()));
@@ -185,6 +185,64 @@ TEST_P(DBWriteTest, LockWalInEffect) {
   ASSERT_OK(dbfull()->UnlockWAL());
 }
 
+TEST_P(DBWriteTest, AdaptiveWriteBatchGroupSize) {
+  constexpr int kNumThreads = 16;
+  constexpr int kNumWrites = 20;
+  Options options = GetOptions();
+  options.adaptive_write_batch_group_size = true;
+  Reopen(options);
+  const uint64_t static_limit = options.max_write_batch_group_size_bytes / 8;
+  std::atomic<uint64_t> max_limit{0};
+  std::atomic<uint64_t> last_limit{0};
+  // Make every write group slow, as if the WAL was synced
+  SyncPoint::GetInstance()->SetCallBack(
+      "WriteThread::EnterAsBatchGroupLeader:End",
+      [&](void* /*arg*/) { env_->SleepForMicroseconds(1000); });
+  SyncPoint::GetInstance()->SetCallBack(
+      "WriteThread::AdaptGroupGrowthLimit:Limit", [&](void* arg) {
+        uint64_t limit = *reinterpret_cast<uint64_t*>(arg);
+        last_limit = limit;
+        if (limit > max_limit) {
+          max_limit = limit;
+        }
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  // Many large writes arrive while a group is written, so groups grow
+  Random rnd(301);
+  std::vector<std::string> values;
+  for (int i = 0; i < kNumThreads; i++) {
+    values.push_back(RandomString(&rnd, 32 * 1024));
+  }
+  std::vector<port::Thread> threads;
+  for (int i = 0; i < kNumThreads; i++) {
+    threads.push_back(port::Thread([&, i]() {
+      for (int j = 0; j < kNumWrites; j++) {
+        ASSERT_OK(Put(Key(i * kNumWrites + j), values[i]));
+      }
+    }));
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  ASSERT_GT(max_limit.load(), static_limit);
+  ASSERT_LE(max_limit.load(), options.max_write_batch_group_size_bytes);
+
+  // A single small writer keeps its groups small
+  for (int j = 0; j < 50; j++) {
+    ASSERT_OK(Put("small" + ToString(j), "value"));
+  }
+  ASSERT_LT(last_limit.load(), static_limit);
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  for (int i = 0; i < kNumThreads; i++) {
+    for (int j = 0; j < kNumWrites; j++) {
+      ASSERT_EQ(values[i], Get(Key(i * kNumWrites + j)));
+    }
+  }
+}
+
 INSTANTIATE_TEST_CASE_P(DBWriteTestInstance, DBWriteTest,
                         testing::Values(DBTestBase::kDefault,
                                         DBTestBase::kConcurrentWALWrites,
@@ -199,6 +199,55 @@ TEST_F(FormatTest, RangeTombstoneSerializeEndKey) {
   ASSERT_LT(cmp.Compare(t.SerializeEndKey(), k), 0);
 }
 
+namespace {
+int Sign(int r) { return r < 0 ? -1 : (r > 0 ? 1 : 0); }
+
+// Orders keys bytewise without telling, so that they are not compared inline
+class OpaqueBytewiseComparator : public Comparator {
+ public:
+  const char* Name() const override { return "OpaqueBytewiseComparator"; }
+  int Compare(const Slice& a, const Slice& b) const override {
+    return a.compare(b);
+  }
+  void FindShortestSeparator(std::string* /*start*/,
+                             const Slice& /*limit*/) const override {}
+  void FindShortSuccessor(std::string* /*key*/) const override {}
+};
+}  // namespace
+
+TEST_F(FormatTest, BytewiseCompare) {
+  ASSERT_TRUE(BytewiseComparator()->IsBytewiseOrder());
+  ASSERT_FALSE(ReverseBytewiseComparator()->IsBytewiseOrder());
+
+  // Keys around the 8 and 16 byte boundaries, differing in any byte, also in
+  // its sign bit
+  std::vector<std::string> keys = {""};
+  for (size_t len = 1; len <= 25; len++) {
+    for (size_t pos = 0; pos < len; pos++) {
+      for (int c : {0x00, 0x01, 0x7f, 0x80, 0xff}) {
+        std::string key(len, 'k');
+        key[pos] = static_cast<char>(c);
+        keys.push_back(key);
+      }
+    }
+  }
+  OpaqueBytewiseComparator opaque;
+  const InternalKeyComparator icmp(BytewiseComparator());
+  const InternalKeyComparator opaque_icmp(&opaque);
+  for (const auto& a : keys) {
+    for (const auto& b : keys) {
+      ASSERT_EQ(Sign(Slice(a).compare(b)), Sign(BytewiseCompare(a, b)));
+      std::string ia = IKey(a, 2, kTypeValue);
+      for (SequenceNumber seq : {1, 2, 3}) {
+        std::string ib = IKey(b, seq, kTypeValue);
+        int expected = Sign(opaque_icmp.Compare(ia, ib));
+        ASSERT_EQ(expected, Sign(BytewiseCompareInternalKeys(ia, ib)));
+        ASSERT_EQ(expected, Sign(icmp.Compare(ia, ib)));
+      }
+    }
+  }
+}
+
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
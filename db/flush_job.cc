@@ -14,6 +14,7 @@
 #include <algorithm>
 #include <vector>
 
+#include "db/blob_file_builder.h"
 #include "db/builder.h"
 #include "db/db_iter.h"
 #include "db/dbformat.h"
@@ -295,6 +296,7 @@ Status FlushJob::WriteLevel0Table() {
   const uint64_t start_micros = db_options_.env->NowMicros();
   const uint64_t start_cpu_micros = db_options_.env->NowCPUNanos() / 1000;
   Status s;
+  std::unique_ptr<BlobFileBuilder> blob_file_builder;
   {
     auto write_hint = cfd_->CalculateSSTWriteHint(0);
     db_mutex_->Unlock();
@@ -365,6 +367,12 @@ Status FlushJob::WriteLevel0Table() {
       uint64_t oldest_key_time =
           mems_.front()->ApproximateOldestKeyTime();
 
+      if (cfd_->ioptions()->enable_blob_files) {
+        blob_file_builder.reset(new BlobFileBuilder(
+            versions_, db_options_.env, env_options_, cfd_->ioptions(),
+            cfd_->GetID(), Env::IO_HIGH, write_hint));
+      }
+
       s = BuildTable(
           dbname_, db_options_.env, *cfd_->ioptions(), mutable_cf_options_,
           env_options_, cfd_->table_cache(), iter.get(),
@@ -377,7 +385,8 @@ Status FlushJob::WriteLevel0Table() {
           mutable_cf_options_.paranoid_file_checks, cfd_->internal_stats(),
           TableFileCreationReason::kFlush, event_logger_, job_context_->job_id,
           Env::IO_HIGH, &table_properties_, 0 /* level */, current_time,
-          oldest_key_time, write_hint, current_time);
+          oldest_key_time, write_hint, current_time,
+          cfd_->compression_dict_store(), blob_file_builder.get());
       LogFlush(db_options_.info_log);
     }
     ROCKS_LOG_INFO(db_options_.info_log,
@@ -409,6 +418,13 @@ Status FlushJob::WriteLevel0Table() {
                    meta_.fd.GetFileSize(), meta_.smallest, meta_.largest,
                    meta_.fd.smallest_seqno, meta_.fd.largest_seqno,
                    meta_.marked_for_compaction);
+    if (blob_file_builder != nullptr) {
+      for (const auto& blob_file : blob_file_builder->GetBlobFileAdditions()) {
+        edit_->AddBlobFile(blob_file.blob_file_number,
+                           blob_file.total_blob_count,
+                           blob_file.total_blob_bytes);
+      }
+    }
   }
 
   // Note that here we treat flush as level 0 compaction in internal stats
@@ -416,6 +432,9 @@ Status FlushJob::WriteLevel0Table() {
   stats.micros = db_options_.env->NowMicros() - start_micros;
   stats.cpu_micros = db_options_.env->NowCPUNanos() / 1000 - start_cpu_micros;
   stats.bytes_written = meta_.fd.GetFileSize();
+  if (blob_file_builder != nullptr) {
+    stats.bytes_written += blob_file_builder->bytes_written();
+  }
   RecordTimeToHistogram(stats_, FLUSH_TIME, stats.micros);
   cfd_->internal_stats()->AddCompactionStats(0 /* level */, thread_pri_, stats);
   cfd_->internal_stats()->AddCFStats(InternalStats::BYTES_FLUSHED,
@@ -103,7 +103,8 @@ struct SuperVersionContext {
 struct JobContext {
   inline bool HaveSomethingToDelete() const {
     return full_scan_candidate_files.size() || sst_delete_files.size() ||
-           log_delete_files.size() || manifest_delete_files.size();
+           blob_delete_files.size() || log_delete_files.size() ||
+           manifest_delete_files.size();
   }
 
   inline bool HaveSomethingToClean() const {
@@ -145,6 +146,17 @@ struct JobContext {
   // a list of sst files that we need to delete
   std::vector<ObsoleteFileInfo> sst_delete_files;
 
+  // the list of all live blob files that cannot be deleted
+  std::vector<uint64_t> blob_live;
+
+  // a list of blob files that we need to delete
+  std::vector<ObsoleteBlobFileInfo> blob_delete_files;
+
+  // true if the DB itself writes blob files, in which case blob files that
+  // are not live can be deleted by a full scan; otherwise they belong to
+  // BlobDB and are left alone
+  bool manage_blob_files = false;
+
   // a list of log files that we need to delete
   std::vector<uint64_t> log_delete_files;
 
@@ -469,7 +469,8 @@ MemTable::MemTableStats MemTable::ApproximateStats(const Slice& start_ikey,
 bool MemTable::Add(SequenceNumber s, ValueType type,
                    const Slice& key, /* user key */
                    const Slice& value, bool allow_concurrent,
-                   MemTablePostProcessInfo* post_process_info, void** hint) {
+                   MemTablePostProcessInfo* post_process_info, void** hint,
+                   std::vector<KeyHandle>* batched_inserts) {
   // Format of an entry is concatenation of:
   //  key_size     : varint32 of internal_key.size()
   //  key bytes    : char[internal_key.size()]
@@ -507,6 +508,8 @@ bool MemTable::Add(SequenceNumber s, ValueType type,
       if (UNLIKELY(!res)) {
         return res;
       }
+    } else if (batched_inserts != nullptr && type != kTypeRangeDeletion) {
+      batched_inserts->push_back(handle);
     } else {
       bool res = table->InsertKey(handle);
       if (UNLIKELY(!res)) {
@@ -588,6 +591,16 @@ bool MemTable::Add(SequenceNumber s, ValueType type,
   return true;
 }
 
+bool MemTable::InsertBatch(std::vector<KeyHandle>* batched_inserts) {
+  if (batched_inserts->empty()) {
+    return true;
+  }
+  bool res =
+      table_->InsertKeyBatch(batched_inserts->data(), batched_inserts->size());
+  batched_inserts->clear();
+  return res;
+}
+
 // Callback from MemTable::Get()
 namespace {
 
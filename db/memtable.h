@@ -85,6 +85,9 @@ class MemTable {
                            const char* prefix_len_key2) const override;
     virtual int operator()(const char* prefix_len_key,
                            const DecodedType& key) const override;
+    virtual const Comparator* user_comparator() const override {
+      return comparator.user_comparator();
+    }
   };
 
   // MemTables are reference counted.  The initial reference count
@@ -178,12 +181,28 @@ class MemTable {
   // REQUIRES: if allow_concurrent = false, external synchronization to prevent
   // simultaneous operations on the same MemTable.
   //
+  // If batched_inserts is not nullptr and allow_concurrent is false, point
+  // entries are only encoded and accounted for; their handles are appended
+  // to *batched_inserts and they become part of the memtable with
+  // InsertBatch(). The caller must make sure that no <key, seq> is added
+  // twice in that case, since the check is deferred too.
+  //
   // Returns false if MemTableRepFactory::CanHandleDuplicatedKey() is true and
   // the <key, seq> already exists.
   bool Add(SequenceNumber seq, ValueType type, const Slice& key,
            const Slice& value, bool allow_concurrent = false,
            MemTablePostProcessInfo* post_process_info = nullptr,
-           void** hint = nullptr);
+           void** hint = nullptr,
+           std::vector<KeyHandle>* batched_inserts = nullptr);
+
+  // Inserts the entries deferred by Add() into the memtable, sorted, and
+  // clears *batched_inserts.
+  //
+  // REQUIRES: external synchronization to prevent simultaneous
+  // operations on the same MemTable.
+  //
+  // Returns false if any of the <key, seq> already existed.
+  bool InsertBatch(std::vector<KeyHandle>* batched_inserts);
 
   // Used to Get value associated with key or Get Merge Operands associated
   // with key.
@@ -655,4 +655,30 @@ uint64_t TableCache::ApproximateSize(
 
   return result;
 }
+
+Status TableCache::ApproximateKeyAnchors(
+    const ReadOptions& read_options,
+    const InternalKeyComparator& internal_comparator, const FileDescriptor& fd,
+    size_t max_anchors, std::vector<TableReader::Anchor>* anchors) {
+  Status s;
+  TableReader* table_reader = fd.table_reader;
+  Cache::Handle* table_handle = nullptr;
+  if (table_reader == nullptr) {
+    s = FindTable(env_options_, internal_comparator, fd, &table_handle,
+                  nullptr /* prefix_extractor */, false /* no_io */,
+                  false /* record_read_stats */);
+    if (s.ok()) {
+      table_reader = GetTableReaderFromHandle(table_handle);
+    }
+  }
+
+  if (table_reader != nullptr) {
+    s = table_reader->ApproximateKeyAnchors(read_options, max_anchors, anchors);
+  }
+  if (table_handle != nullptr) {
+    ReleaseHandle(table_handle);
+  }
+
+  return s;
+}
 }  // namespace rocksdb
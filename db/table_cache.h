@@ -174,6 +174,13 @@ class TableCache {
                            const InternalKeyComparator& internal_comparator,
                            const SliceTransform* prefix_extractor = nullptr);
 
+  // Samples at most max_anchors keys dividing the file represented by fd into
+  // ranges of roughly equal size. See TableReader::ApproximateKeyAnchors().
+  Status ApproximateKeyAnchors(const ReadOptions& read_options,
+                               const InternalKeyComparator& internal_comparator,
+                               const FileDescriptor& fd, size_t max_anchors,
+                               std::vector<TableReader::Anchor>* anchors);
+
   // Release the handle from a cache
   void ReleaseHandle(Cache::Handle* handle);
 
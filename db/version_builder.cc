@@ -14,7 +14,9 @@
 #include <atomic>
 #include <functional>
 #include <map>
+#include <memory>
 #include <set>
+#include <string>
 #include <thread>
 #include <unordered_map>
 #include <unordered_set>
@@ -83,6 +85,11 @@ class VersionBuilder::Rep {
     std::unordered_map<uint64_t, FileMetaData*> added_files;
   };
 
+  struct BlobGarbage {
+    uint64_t count = 0;
+    uint64_t bytes = 0;
+  };
+
   const EnvOptions& env_options_;
   Logger* info_log_;
   TableCache* table_cache_;
@@ -99,16 +106,26 @@ class VersionBuilder::Rep {
   bool has_invalid_levels_;
   FileComparator level_zero_cmp_;
   FileComparator level_nonzero_cmp_;
+  VersionSet* version_set_;
+  const std::string blob_file_path_;
+  // Blob files added by the edits, by number
+  std::map<uint64_t, std::shared_ptr<SharedBlobFileMetaData>>
+      added_blob_files_;
+  // Garbage added by the edits to the base and the added blob files
+  std::map<uint64_t, BlobGarbage> blob_garbage_;
 
  public:
   Rep(const EnvOptions& env_options, Logger* info_log, TableCache* table_cache,
-      VersionStorageInfo* base_vstorage)
+      VersionStorageInfo* base_vstorage, VersionSet* version_set,
+      const std::string& blob_file_path)
       : env_options_(env_options),
         info_log_(info_log),
         table_cache_(table_cache),
         base_vstorage_(base_vstorage),
         num_levels_(base_vstorage->num_levels()),
-        has_invalid_levels_(false) {
+        has_invalid_levels_(false),
+        version_set_(version_set),
+        blob_file_path_(blob_file_path) {
     levels_ = new LevelState[num_levels_];
     level_zero_cmp_.sort_method = FileComparator::kLevel0;
     level_nonzero_cmp_.sort_method = FileComparator::kLevelNon0;
@@ -335,9 +352,77 @@ class VersionBuilder::Rep {
         }
       }
     }
+
+    // Add new blob files
+    for (const auto& blob_file_addition : edit->GetBlobFileAdditions()) {
+      const uint64_t number = blob_file_addition.blob_file_number;
+      if (added_blob_files_.count(number) > 0 ||
+          base_vstorage_->GetBlobFiles().count(number) > 0) {
+        return Status::Corruption("Blob file " + NumberToString(number) +
+                                  " added twice");
+      }
+      VersionSet* const vset = version_set_;
+      const std::string path = blob_file_path_;
+      added_blob_files_.emplace(
+          number, std::shared_ptr<SharedBlobFileMetaData>(
+                      new SharedBlobFileMetaData(
+                          number, blob_file_addition.total_blob_count,
+                          blob_file_addition.total_blob_bytes),
+                      [vset, path](SharedBlobFileMetaData* shared_meta) {
+                        if (vset != nullptr) {
+                          vset->AddObsoleteBlobFile(
+                              shared_meta->blob_file_number(), path);
+                        }
+                        delete shared_meta;
+                      }));
+    }
+
+    // Add garbage to blob files. Garbage of a file that is already gone is
+    // ignored.
+    for (const auto& blob_file_garbage : edit->GetBlobFileGarbages()) {
+      auto& garbage = blob_garbage_[blob_file_garbage.blob_file_number];
+      garbage.count += blob_file_garbage.garbage_blob_count;
+      garbage.bytes += blob_file_garbage.garbage_blob_bytes;
+    }
     return s;
   }
 
+  // Adds a blob file to *vstorage unless all its blobs are garbage.
+  static void MaybeAddBlobFile(
+      VersionStorageInfo* vstorage,
+      const std::shared_ptr<SharedBlobFileMetaData>& shared_meta,
+      uint64_t garbage_blob_count, uint64_t garbage_blob_bytes) {
+    if (garbage_blob_count >= shared_meta->total_blob_count()) {
+      return;
+    }
+    vstorage->AddBlobFile(std::make_shared<BlobFileMetaData>(
+        shared_meta, garbage_blob_count, garbage_blob_bytes));
+  }
+
+  void SaveBlobFilesTo(VersionStorageInfo* vstorage) const {
+    for (const auto& pair : base_vstorage_->GetBlobFiles()) {
+      const auto& base_meta = pair.second;
+      auto garbage = blob_garbage_.find(pair.first);
+      if (garbage == blob_garbage_.end()) {
+        vstorage->AddBlobFile(base_meta);
+        continue;
+      }
+      MaybeAddBlobFile(
+          vstorage, base_meta->GetSharedMeta(),
+          base_meta->garbage_blob_count() + garbage->second.count,
+          base_meta->garbage_blob_bytes() + garbage->second.bytes);
+    }
+    for (const auto& pair : added_blob_files_) {
+      auto garbage = blob_garbage_.find(pair.first);
+      if (garbage == blob_garbage_.end()) {
+        MaybeAddBlobFile(vstorage, pair.second, 0, 0);
+      } else {
+        MaybeAddBlobFile(vstorage, pair.second, garbage->second.count,
+                         garbage->second.bytes);
+      }
+    }
+  }
+
   // Save the current state in *v.
   Status SaveTo(VersionStorageInfo* vstorage) {
     Status s = CheckConsistency(base_vstorage_);
@@ -392,6 +477,8 @@ class VersionBuilder::Rep {
       }
     }
 
+    SaveBlobFilesTo(vstorage);
+
     s = CheckConsistency(vstorage);
     return s;
   }
@@ -506,8 +593,10 @@ class VersionBuilder::Rep {
 VersionBuilder::VersionBuilder(const EnvOptions& env_options,
                                TableCache* table_cache,
                                VersionStorageInfo* base_vstorage,
-                               Logger* info_log)
-    : rep_(new Rep(env_options, info_log, table_cache, base_vstorage)) {}
+                               Logger* info_log, VersionSet* version_set,
+                               const std::string& blob_file_path)
+    : rep_(new Rep(env_options, info_log, table_cache, base_vstorage,
+                   version_set, blob_file_path)) {}
 
 VersionBuilder::~VersionBuilder() { delete rep_; }
 
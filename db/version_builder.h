@@ -8,6 +8,8 @@
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 //
 #pragma once
+#include <string>
+
 #include "rocksdb/env.h"
 #include "rocksdb/slice_transform.h"
 
@@ -16,16 +18,23 @@ namespace rocksdb {
 class TableCache;
 class VersionStorageInfo;
 class VersionEdit;
+class VersionSet;
 struct FileMetaData;
 class InternalStats;
 
 // A helper class so we can efficiently apply a whole sequence
 // of edits to a particular state without creating intermediate
 // Versions that contain full copies of the intermediate state.
+//
+// The blob files added by the edits are reported to
+// VersionSet::AddObsoleteBlobFile() once no version refers to them anymore,
+// if `version_set` is set; `blob_file_path` is the directory they are in.
 class VersionBuilder {
  public:
   VersionBuilder(const EnvOptions& env_options, TableCache* table_cache,
-                 VersionStorageInfo* base_vstorage, Logger* info_log = nullptr);
+                 VersionStorageInfo* base_vstorage, Logger* info_log = nullptr,
+                 VersionSet* version_set = nullptr,
+                 const std::string& blob_file_path = "");
   ~VersionBuilder();
   Status CheckConsistency(VersionStorageInfo* vstorage);
   Status CheckConsistencyForDeletes(VersionEdit* edit, uint64_t number,
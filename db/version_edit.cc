@@ -38,6 +38,7 @@ enum Tag : uint32_t {
   kMinLogNumberToKeep = 10,
   // Ignore-able field
   kDbId = kTagSafeIgnoreMask + 1,
+  kCompressionDict = kTagSafeIgnoreMask + 2,
 
   // these are new formats divergent from open source leveldb
   kNewFile2 = 100,
@@ -49,6 +50,10 @@ enum Tag : uint32_t {
   kMaxColumnFamily = 203,
 
   kInAtomicGroup = 300,
+
+  // Not ignorable: the table files may point to the blob files
+  kBlobFileAddition = 400,
+  kBlobFileGarbage = 401,
 };
 
 enum CustomTag : uint32_t {
@@ -90,6 +95,9 @@ void VersionEdit::Clear() {
   has_min_log_number_to_keep_ = false;
   deleted_files_.clear();
   new_files_.clear();
+  compression_dicts_.clear();
+  blob_file_additions_.clear();
+  blob_file_garbages_.clear();
   column_family_ = 0;
   is_column_family_add_ = 0;
   is_column_family_drop_ = 0;
@@ -204,6 +212,29 @@ bool VersionEdit::EncodeTo(std::string* dst) const {
     }
   }
 
+  for (const auto& compression_dict : compression_dicts_) {
+    // Length-prefixed, so that older releases can skip it
+    std::string record;
+    PutVarint32Varint64(&record, compression_dict.level, compression_dict.id);
+    PutLengthPrefixedSlice(&record, compression_dict.dict);
+    PutVarint32(dst, kCompressionDict);
+    PutLengthPrefixedSlice(dst, record);
+  }
+
+  for (const auto& blob_file_addition : blob_file_additions_) {
+    PutVarint32(dst, kBlobFileAddition);
+    PutVarint64Varint64(dst, blob_file_addition.blob_file_number,
+                        blob_file_addition.total_blob_count);
+    PutVarint64(dst, blob_file_addition.total_blob_bytes);
+  }
+
+  for (const auto& blob_file_garbage : blob_file_garbages_) {
+    PutVarint32(dst, kBlobFileGarbage);
+    PutVarint64Varint64(dst, blob_file_garbage.blob_file_number,
+                        blob_file_garbage.garbage_blob_count);
+    PutVarint64(dst, blob_file_garbage.garbage_blob_bytes);
+  }
+
   // 0 is default and does not need to be explicitly written
   if (column_family_ != 0) {
     PutVarint32Varint32(dst, kColumnFamily, column_family_);
@@ -340,6 +371,52 @@ Status VersionEdit::DecodeFrom(const Slice& src) {
           msg = "db id";
         }
         break;
+      case kCompressionDict: {
+        Slice record;
+        uint32_t dict_level;
+        uint64_t dict_id;
+        Slice dict;
+        if (GetLengthPrefixedSlice(&input, &record) &&
+            GetVarint32(&record, &dict_level) &&
+            GetVarint64(&record, &dict_id) &&
+            GetLengthPrefixedSlice(&record, &dict)) {
+          compression_dicts_.push_back({static_cast<int>(dict_level), dict_id,
+                                        dict.ToString()});
+        } else {
+          msg = "compression dictionary";
+        }
+        break;
+      }
+
+      case kBlobFileAddition: {
+        uint64_t blob_file_number;
+        uint64_t total_blob_count;
+        uint64_t total_blob_bytes;
+        if (GetVarint64(&input, &blob_file_number) &&
+            GetVarint64(&input, &total_blob_count) &&
+            GetVarint64(&input, &total_blob_bytes)) {
+          blob_file_additions_.emplace_back(blob_file_number, total_blob_count,
+                                            total_blob_bytes);
+        } else {
+          msg = "blob file addition";
+        }
+        break;
+      }
+
+      case kBlobFileGarbage: {
+        uint64_t blob_file_number;
+        uint64_t garbage_blob_count;
+        uint64_t garbage_blob_bytes;
+        if (GetVarint64(&input, &blob_file_number) &&
+            GetVarint64(&input, &garbage_blob_count) &&
+            GetVarint64(&input, &garbage_blob_bytes)) {
+          blob_file_garbages_.emplace_back(blob_file_number, garbage_blob_count,
+                                           garbage_blob_bytes);
+        } else {
+          msg = "blob file garbage";
+        }
+        break;
+      }
       case kComparator:
         if (GetLengthPrefixedSlice(&input, &str)) {
           comparator_ = str.ToString();
@@ -603,6 +680,30 @@ std::string VersionEdit::DebugString(bool hex_key) const {
     r.append(" .. ");
     r.append(f.largest.DebugString(hex_key));
   }
+  for (const auto& compression_dict : compression_dicts_) {
+    r.append("\n  CompressionDict: ");
+    AppendNumberTo(&r, compression_dict.level);
+    r.append(" ");
+    AppendNumberTo(&r, compression_dict.id);
+    r.append(" ");
+    AppendNumberTo(&r, compression_dict.dict.size());
+  }
+  for (const auto& blob_file_addition : blob_file_additions_) {
+    r.append("\n  BlobFileAddition: ");
+    AppendNumberTo(&r, blob_file_addition.blob_file_number);
+    r.append(" ");
+    AppendNumberTo(&r, blob_file_addition.total_blob_count);
+    r.append(" ");
+    AppendNumberTo(&r, blob_file_addition.total_blob_bytes);
+  }
+  for (const auto& blob_file_garbage : blob_file_garbages_) {
+    r.append("\n  BlobFileGarbage: ");
+    AppendNumberTo(&r, blob_file_garbage.blob_file_number);
+    r.append(" ");
+    AppendNumberTo(&r, blob_file_garbage.garbage_blob_count);
+    r.append(" ");
+    AppendNumberTo(&r, blob_file_garbage.garbage_blob_bytes);
+  }
   r.append("\n  ColumnFamily: ");
   AppendNumberTo(&r, column_family_);
   if (is_column_family_add_) {
@@ -682,6 +783,51 @@ std::string VersionEdit::DebugJSON(int edit_num, bool hex_key) const {
     jw.EndArray();
   }
 
+  if (!compression_dicts_.empty()) {
+    jw << "CompressionDicts";
+    jw.StartArray();
+
+    for (const auto& compression_dict : compression_dicts_) {
+      jw.StartArrayedObject();
+      jw << "Level" << compression_dict.level;
+      jw << "Id" << compression_dict.id;
+      jw << "Size" << compression_dict.dict.size();
+      jw.EndArrayedObject();
+    }
+
+    jw.EndArray();
+  }
+
+  if (!blob_file_additions_.empty()) {
+    jw << "BlobFileAdditions";
+    jw.StartArray();
+
+    for (const auto& blob_file_addition : blob_file_additions_) {
+      jw.StartArrayedObject();
+      jw << "BlobFileNumber" << blob_file_addition.blob_file_number;
+      jw << "TotalBlobCount" << blob_file_addition.total_blob_count;
+      jw << "TotalBlobBytes" << blob_file_addition.total_blob_bytes;
+      jw.EndArrayedObject();
+    }
+
+    jw.EndArray();
+  }
+
+  if (!blob_file_garbages_.empty()) {
+    jw << "BlobFileGarbages";
+    jw.StartArray();
+
+    for (const auto& blob_file_garbage : blob_file_garbages_) {
+      jw.StartArrayedObject();
+      jw << "BlobFileNumber" << blob_file_garbage.blob_file_number;
+      jw << "GarbageBlobCount" << blob_file_garbage.garbage_blob_count;
+      jw << "GarbageBlobBytes" << blob_file_garbage.garbage_blob_bytes;
+      jw.EndArrayedObject();
+    }
+
+    jw.EndArray();
+  }
+
   jw << "ColumnFamily" << column_family_;
 
   if (is_column_family_add_) {
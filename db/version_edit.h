@@ -156,6 +156,33 @@ struct FileMetaData {
   }
 };
 
+// A blob file written by a flush or a compaction, see BlobFileBuilder.
+struct BlobFileAddition {
+  BlobFileAddition(uint64_t _blob_file_number, uint64_t _total_blob_count,
+                   uint64_t _total_blob_bytes)
+      : blob_file_number(_blob_file_number),
+        total_blob_count(_total_blob_count),
+        total_blob_bytes(_total_blob_bytes) {}
+
+  uint64_t blob_file_number;
+  uint64_t total_blob_count;
+  // Size of the blob records, each a record header, a user key and a value
+  uint64_t total_blob_bytes;
+};
+
+// Blobs of a blob file that a compaction stopped referencing
+struct BlobFileGarbage {
+  BlobFileGarbage(uint64_t _blob_file_number, uint64_t _garbage_blob_count,
+                  uint64_t _garbage_blob_bytes)
+      : blob_file_number(_blob_file_number),
+        garbage_blob_count(_garbage_blob_count),
+        garbage_blob_bytes(_garbage_blob_bytes) {}
+
+  uint64_t blob_file_number;
+  uint64_t garbage_blob_count;
+  uint64_t garbage_blob_bytes;
+};
+
 // A compressed copy of file meta data that just contain minimum data needed
 // to server read operations, while still keeping the pointer to full metadata
 // of the file in case it is needed.
@@ -272,8 +299,47 @@ class VersionEdit {
     deleted_files_.insert({level, file});
   }
 
+  void AddBlobFile(uint64_t blob_file_number, uint64_t total_blob_count,
+                   uint64_t total_blob_bytes) {
+    blob_file_additions_.emplace_back(blob_file_number, total_blob_count,
+                                      total_blob_bytes);
+  }
+
+  void AddBlobFileGarbage(uint64_t blob_file_number,
+                          uint64_t garbage_blob_count,
+                          uint64_t garbage_blob_bytes) {
+    blob_file_garbages_.emplace_back(blob_file_number, garbage_blob_count,
+                                     garbage_blob_bytes);
+  }
+
+  const std::vector<BlobFileAddition>& GetBlobFileAdditions() const {
+    return blob_file_additions_;
+  }
+  const std::vector<BlobFileGarbage>& GetBlobFileGarbages() const {
+    return blob_file_garbages_;
+  }
+
   // Number of edits
-  size_t NumEntries() { return new_files_.size() + deleted_files_.size(); }
+  size_t NumEntries() {
+    return new_files_.size() + deleted_files_.size() +
+           blob_file_additions_.size() + blob_file_garbages_.size();
+  }
+
+  // A compression dictionary shared by the files of a level. See
+  // CompressionDictStore.
+  struct CompressionDictRecord {
+    int level;
+    uint64_t id;
+    std::string dict;
+  };
+
+  void AddCompressionDict(int level, uint64_t id, const std::string& dict) {
+    compression_dicts_.push_back({level, id, dict});
+  }
+
+  const std::vector<CompressionDictRecord>& GetCompressionDicts() const {
+    return compression_dicts_;
+  }
 
   bool IsColumnFamilyManipulation() {
     return is_column_family_add_ || is_column_family_drop_;
@@ -358,6 +424,9 @@ class VersionEdit {
 
   DeletedFileSet deleted_files_;
   std::vector<std::pair<int, FileMetaData>> new_files_;
+  std::vector<CompressionDictRecord> compression_dicts_;
+  std::vector<BlobFileAddition> blob_file_additions_;
+  std::vector<BlobFileGarbage> blob_file_garbages_;
 
   // Each version edit record should have column_family_ set
   // If it's not set, it is default (0)
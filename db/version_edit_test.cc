@@ -249,6 +249,51 @@ TEST_F(VersionEditTest, DbId) {
   TestEncodeDecode(edit);
 }
 
+TEST_F(VersionEditTest, CompressionDict) {
+  VersionEdit edit;
+  edit.AddCompressionDict(1, 0x1234567890abcdefull, std::string(100, 'a'));
+  edit.AddCompressionDict(6, 1, "");
+  TestEncodeDecode(edit);
+
+  std::string encoded;
+  edit.EncodeTo(&encoded);
+  VersionEdit parsed;
+  ASSERT_OK(parsed.DecodeFrom(encoded));
+  const auto& dicts = parsed.GetCompressionDicts();
+  ASSERT_EQ(2U, dicts.size());
+  ASSERT_EQ(1, dicts[0].level);
+  ASSERT_EQ(0x1234567890abcdefull, dicts[0].id);
+  ASSERT_EQ(std::string(100, 'a'), dicts[0].dict);
+  ASSERT_EQ(6, dicts[1].level);
+  ASSERT_EQ(1U, dicts[1].id);
+  ASSERT_EQ("", dicts[1].dict);
+}
+
+TEST_F(VersionEditTest, BlobFiles) {
+  VersionEdit edit;
+  edit.AddBlobFile(10, 100, 1 << 20);
+  edit.AddBlobFile(11, 1, 64);
+  edit.AddBlobFileGarbage(5, 7, 4096);
+  TestEncodeDecode(edit);
+  ASSERT_EQ(3U, edit.NumEntries());
+
+  std::string encoded;
+  edit.EncodeTo(&encoded);
+  VersionEdit parsed;
+  ASSERT_OK(parsed.DecodeFrom(encoded));
+  const auto& additions = parsed.GetBlobFileAdditions();
+  ASSERT_EQ(2U, additions.size());
+  ASSERT_EQ(10U, additions[0].blob_file_number);
+  ASSERT_EQ(100U, additions[0].total_blob_count);
+  ASSERT_EQ(1U << 20, additions[0].total_blob_bytes);
+  ASSERT_EQ(11U, additions[1].blob_file_number);
+  const auto& garbages = parsed.GetBlobFileGarbages();
+  ASSERT_EQ(1U, garbages.size());
+  ASSERT_EQ(5U, garbages[0].blob_file_number);
+  ASSERT_EQ(7U, garbages[0].garbage_blob_count);
+  ASSERT_EQ(4096U, garbages[0].garbage_blob_bytes);
+}
+
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
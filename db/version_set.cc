@@ -20,6 +20,8 @@
 #include <unordered_map>
 #include <vector>
 #include "compaction/compaction.h"
+#include "db/blob_fetcher.h"
+#include "db/blob_file_cache.h"
 #include "db/internal_stats.h"
 #include "db/log_reader.h"
 #include "db/log_writer.h"
@@ -48,9 +50,11 @@
 #include "test_util/sync_point.h"
 #include "util/coding.h"
 #include "util/file_reader_writer.h"
+#include "util/mutexlock.h"
 #include "util/stop_watch.h"
 #include "util/string_util.h"
 #include "util/user_comparator_wrapper.h"
+#include "utilities/blob_db/blob_index.h"
 
 namespace rocksdb {
 
@@ -1175,7 +1179,9 @@ class BaseReferencedVersionBuilder {
   explicit BaseReferencedVersionBuilder(ColumnFamilyData* cfd)
       : version_builder_(new VersionBuilder(
             cfd->current()->version_set()->env_options(), cfd->table_cache(),
-            cfd->current()->storage_info(), cfd->ioptions()->info_log)),
+            cfd->current()->storage_info(), cfd->ioptions()->info_log,
+            cfd->current()->version_set(),
+            cfd->ioptions()->cf_paths.front().path)),
         version_(cfd->current()) {
     version_->Ref();
   }
@@ -1721,13 +1727,15 @@ void Version::Get(const ReadOptions& read_options, const LookupKey& k,
       vset_->block_cache_tracer_->is_tracing_enabled()) {
     tracing_get_id = vset_->block_cache_tracer_->NextGetId();
   }
+  BlobFetcher blob_fetcher(this, read_options);
   GetContext get_context(
       user_comparator(), merge_operator_, info_log_, db_statistics_,
       status->ok() ? GetContext::kNotFound : GetContext::kMerge, user_key,
       do_merge ? value : nullptr, value_found, merge_context, do_merge,
       max_covering_tombstone_seq, this->env_, seq,
       merge_operator_ ? &pinned_iters_mgr : nullptr, callback, is_blob,
-      tracing_get_id);
+      tracing_get_id,
+      storage_info_.blob_files_.empty() ? nullptr : &blob_fetcher);
 
   // Pin blocks that we read to hold merge operands
   if (merge_operator_) {
@@ -1799,6 +1807,10 @@ void Version::Get(const ReadOptions& read_options, const LookupKey& k,
         *status = Status::NotFound();
         return;
       case GetContext::kCorrupt:
+        if (!get_context.blob_status().ok()) {
+          *status = get_context.blob_status();
+          return;
+        }
         *status = Status::Corruption("corrupted key for ", user_key);
         return;
       case GetContext::kBlobIndex:
@@ -1841,8 +1853,30 @@ void Version::Get(const ReadOptions& read_options, const LookupKey& k,
   }
 }
 
+Status Version::GetBlob(const ReadOptions& read_options, const Slice& user_key,
+                        const Slice& blob_index, PinnableSlice* value) const {
+  blob_db::BlobIndex blob_idx;
+  Status s = blob_idx.DecodeFrom(blob_index);
+  if (!s.ok()) {
+    return s;
+  }
+  if (blob_idx.HasTTL() || blob_idx.IsInlined()) {
+    return Status::Corruption("Unexpected TTL blob index for ", user_key);
+  }
+  if (blob_idx.compression() != kNoCompression) {
+    return Status::NotSupported("Compressed blob for ", user_key);
+  }
+  if (storage_info_.blob_files_.find(blob_idx.file_number()) ==
+      storage_info_.blob_files_.end()) {
+    return Status::Corruption("Invalid blob file number for ", user_key);
+  }
+  return cfd_->blob_file_cache()->GetBlob(read_options, blob_idx.file_number(),
+                                          user_key, blob_idx.offset(),
+                                          blob_idx.size(), value);
+}
+
 void Version::MultiGet(const ReadOptions& read_options, MultiGetRange* range,
-                       ReadCallback* callback, bool* is_blob) {
+                       ReadCallback* callback, bool allow_blob_index) {
   PinnedIteratorsManager pinned_iters_mgr;
 
   // Pin blocks that we read to hold merge operands
@@ -1858,6 +1892,7 @@ void Version::MultiGet(const ReadOptions& read_options, MultiGetRange* range,
   // Even though we know the batch size won't be > MAX_BATCH_SIZE,
   // use autovector in order to avoid unnecessary construction of GetContext
   // objects, which is expensive
+  BlobFetcher blob_fetcher(this, read_options);
   autovector<GetContext, 16> get_ctx;
   for (auto iter = range->begin(); iter != range->end(); ++iter) {
     assert(iter->s->ok() || iter->s->IsMergeInProgress());
@@ -1866,8 +1901,9 @@ void Version::MultiGet(const ReadOptions& read_options, MultiGetRange* range,
         iter->s->ok() ? GetContext::kNotFound : GetContext::kMerge, iter->ukey,
         iter->value, nullptr, &(iter->merge_context), true,
         &iter->max_covering_tombstone_seq, this->env_, nullptr,
-        merge_operator_ ? &pinned_iters_mgr : nullptr, callback, is_blob,
-        tracing_mget_id);
+        merge_operator_ ? &pinned_iters_mgr : nullptr, callback,
+        allow_blob_index ? &iter->is_blob_index : nullptr, tracing_mget_id,
+        storage_info_.blob_files_.empty() ? nullptr : &blob_fetcher);
   }
   int get_ctx_index = 0;
   for (auto iter = range->begin(); iter != range->end();
@@ -1954,8 +1990,12 @@ void Version::MultiGet(const ReadOptions& read_options, MultiGetRange* range,
           file_range.MarkKeyDone(iter);
           continue;
         case GetContext::kCorrupt:
-          *status =
-              Status::Corruption("corrupted key for ", iter->lkey->user_key());
+          if (!get_context.blob_status().ok()) {
+            *status = get_context.blob_status();
+          } else {
+            *status = Status::Corruption("corrupted key for ",
+                                         iter->lkey->user_key());
+          }
           file_range.MarkKeyDone(iter);
           continue;
         case GetContext::kBlobIndex:
@@ -2172,7 +2212,8 @@ void VersionStorageInfo::ComputeCompensatedSizes() {
 }
 
 int VersionStorageInfo::MaxInputLevel() const {
-  if (compaction_style_ == kCompactionStyleLevel) {
+  if (compaction_style_ == kCompactionStyleLevel ||
+      compaction_style_ == kCompactionStyleHybrid) {
     return num_levels() - 2;
   }
   return 0;
@@ -2331,6 +2372,15 @@ void VersionStorageInfo::ComputeCompactionScore(
             num_sorted_runs++;
           }
         }
+      } else if (compaction_style_ == kCompactionStyleHybrid) {
+        // Hybrid compaction tiers everything above the last level, so the
+        // level0 score covers those sorted runs. The last level is leveled
+        // and is scored separately below.
+        for (int i = 1; i < num_levels() - 1; i++) {
+          if (!files_[i].empty() && !files_[i][0]->being_compacted) {
+            num_sorted_runs++;
+          }
+        }
       }
 
       if (compaction_style_ == kCompactionStyleFIFO) {
@@ -2361,6 +2411,25 @@ void VersionStorageInfo::ComputeCompactionScore(
                      mutable_cf_options.max_bytes_for_level_base);
         }
       }
+    } else if (compaction_style_ == kCompactionStyleHybrid) {
+      // Only the oldest tier is ever compacted into the last level. It is
+      // drained once it holds at least 1/(W-1) of the last level's size,
+      // which bounds the last level's write amplification by roughly W.
+      score = 0;
+      if (level == num_levels() - 2) {
+        uint64_t level_bytes_no_compacting = 0;
+        for (auto f : files_[level]) {
+          if (!f->being_compacted) {
+            level_bytes_no_compacting += f->fd.GetFileSize();
+          }
+        }
+        const double target_write_amp = std::max(
+            2.0, mutable_cf_options.hybrid_target_write_amplification);
+        const uint64_t last_level_bytes =
+            std::max<uint64_t>(NumLevelBytes(num_levels() - 1), 1);
+        score = static_cast<double>(level_bytes_no_compacting) *
+                (target_write_amp - 1) / last_level_bytes;
+      }
     } else {
       // Compute the ratio of current size to size limit.
       uint64_t level_bytes_no_compacting = 0;
@@ -2548,6 +2617,13 @@ void VersionStorageInfo::AddFile(int level, FileMetaData* f, Logger* info_log) {
   level_files->push_back(f);
 }
 
+void VersionStorageInfo::AddBlobFile(
+    std::shared_ptr<BlobFileMetaData> blob_file_meta) {
+  assert(blob_file_meta != nullptr);
+  const uint64_t blob_file_number = blob_file_meta->blob_file_number();
+  blob_files_.emplace(blob_file_number, std::move(blob_file_meta));
+}
+
 // Version::PrepareApply() need to be called before calling the function, or
 // following functions called:
 // 1. UpdateNumNonEmptyLevels();
@@ -3138,6 +3214,12 @@ void VersionStorageInfo::CalculateBaseBytes(const ImmutableCFOptions& ioptions,
         num_l0_count++;
       }
     }
+  } else if (compaction_style_ == kCompactionStyleHybrid) {
+    for (int i = 1; i < num_levels() - 1; i++) {
+      if (!files_[i].empty()) {
+        num_l0_count++;
+      }
+    }
   }
   set_l0_delay_trigger_count(num_l0_count);
 
@@ -3870,6 +3952,11 @@ Status VersionSet::ProcessManifestWrites(
 
       for (int i = 0; i < static_cast<int>(versions.size()); ++i) {
         ColumnFamilyData* cfd = versions[i]->cfd_;
+        for (const auto& e : batch_edits) {
+          if (e->column_family_ == cfd->GetID()) {
+            cfd->compression_dict_store()->MarkPersisted(*e);
+          }
+        }
         AppendVersion(cfd, versions[i]);
       }
     }
@@ -4026,9 +4113,6 @@ void VersionSet::LogAndApplyCFHelper(VersionEdit* edit) {
 Status VersionSet::LogAndApplyHelper(ColumnFamilyData* cfd,
                                      VersionBuilder* builder, VersionEdit* edit,
                                      InstrumentedMutex* mu) {
-#ifdef NDEBUG
-  (void)cfd;
-#endif
   mu->AssertHeld();
   assert(!edit->IsColumnFamilyManipulation());
 
@@ -4048,6 +4132,8 @@ Status VersionSet::LogAndApplyHelper(ColumnFamilyData* cfd,
   // last_allocated_sequence_ as the last sequence.
   edit->SetLastSequence(db_options_->two_write_queues ? last_allocated_sequence_
                                                       : last_sequence_);
+  // Record the compression dictionaries trained since the last edit
+  cfd->compression_dict_store()->AddUnpersistedTo(edit);
 
   Status s = builder->Apply(edit);
 
@@ -4173,6 +4259,11 @@ Status VersionSet::ExtractInfoFromVersionEdit(
           cfd->user_comparator()->Name(),
           "does not match existing comparator " + from_edit.comparator_);
     }
+    for (const auto& compression_dict : from_edit.compression_dicts_) {
+      cfd->compression_dict_store()->Recover(compression_dict.level,
+                                             compression_dict.id,
+                                             compression_dict.dict);
+    }
   }
 
   if (from_edit.has_prev_log_number_) {
@@ -4924,6 +5015,18 @@ Status VersionSet::WriteCurrentStateToManifest(log::Writer* log) {
                        f->marked_for_compaction);
         }
       }
+      for (const auto& pair :
+           cfd->current()->storage_info()->GetBlobFiles()) {
+        const auto& meta = pair.second;
+        edit.AddBlobFile(meta->blob_file_number(), meta->total_blob_count(),
+                         meta->total_blob_bytes());
+        if (meta->garbage_blob_count() > 0) {
+          edit.AddBlobFileGarbage(meta->blob_file_number(),
+                                  meta->garbage_blob_count(),
+                                  meta->garbage_blob_bytes());
+        }
+      }
+      cfd->compression_dict_store()->AddAllTo(&edit);
       edit.SetLogNumber(cfd->GetLogNumber());
       std::string record;
       if (!edit.EncodeTo(&record)) {
@@ -5179,6 +5282,21 @@ void VersionSet::AddLiveFiles(std::vector<FileDescriptor>* live_list) {
   }
 }
 
+void VersionSet::AddLiveBlobFiles(std::vector<uint64_t>* live_list) {
+  for (auto cfd : *column_family_set_) {
+    if (!cfd->initialized()) {
+      continue;
+    }
+    Version* dummy_versions = cfd->dummy_versions();
+    for (Version* v = dummy_versions->next_; v != dummy_versions;
+         v = v->next_) {
+      for (const auto& pair : v->storage_info()->GetBlobFiles()) {
+        live_list->push_back(pair.first);
+      }
+    }
+  }
+}
+
 InternalIterator* VersionSet::MakeInputIterator(
     const Compaction* c, RangeDelAggregator* range_del_agg,
     const EnvOptions& env_options_compactions) {
@@ -5191,6 +5309,7 @@ InternalIterator* VersionSet::MakeInputIterator(
   // (a) concurrent compactions,
   // (b) CompactionFilter::Decision::kRemoveAndSkipUntil.
   read_options.total_order_seek = true;
+  read_options.async_readahead = db_options_->max_background_readaheads > 0;
 
   // Level-0 files have to be merged together.  For other levels,
   // we will make a concatenating iterator per level.
@@ -5363,6 +5482,26 @@ void VersionSet::GetObsoleteFiles(std::vector<ObsoleteFileInfo>* files,
   obsolete_files_.swap(pending_files);
 }
 
+void VersionSet::AddObsoleteBlobFile(uint64_t blob_file_number,
+                                     std::string path) {
+  MutexLock l(&obsolete_blob_files_mutex_);
+  obsolete_blob_files_.emplace_back(blob_file_number, std::move(path));
+}
+
+void VersionSet::GetObsoleteBlobFiles(std::vector<ObsoleteBlobFileInfo>* files,
+                                      uint64_t min_pending_output) {
+  MutexLock l(&obsolete_blob_files_mutex_);
+  std::vector<ObsoleteBlobFileInfo> pending_files;
+  for (auto& f : obsolete_blob_files_) {
+    if (f.blob_file_number < min_pending_output) {
+      files->push_back(std::move(f));
+    } else {
+      pending_files.push_back(std::move(f));
+    }
+  }
+  obsolete_blob_files_.swap(pending_files);
+}
+
 ColumnFamilyData* VersionSet::CreateColumnFamily(
     const ColumnFamilyOptions& cf_options, VersionEdit* edit) {
   assert(edit->is_column_family_add_);
@@ -28,6 +28,7 @@
 #include <utility>
 #include <vector>
 
+#include "db/blob_file_meta.h"
 #include "db/column_family.h"
 #include "db/compaction/compaction.h"
 #include "db/compaction/compaction_picker.h"
@@ -118,6 +119,8 @@ class VersionStorageInfo {
 
   void AddFile(int level, FileMetaData* f, Logger* info_log = nullptr);
 
+  void AddBlobFile(std::shared_ptr<BlobFileMetaData> blob_file_meta);
+
   void SetFinalized();
 
   // Update num_non_empty_levels_.
@@ -283,6 +286,11 @@ class VersionStorageInfo {
     return level_files_brief_[level];
   }
 
+  using BlobFiles = std::map<uint64_t, std::shared_ptr<BlobFileMetaData>>;
+
+  // The blob files that the table files of the version point to, by number
+  const BlobFiles& GetBlobFiles() const { return blob_files_; }
+
   // REQUIRES: This version has been saved (see VersionSet::SaveTo)
   const std::vector<int>& FilesByCompactionPri(int level) const {
     assert(finalized_);
@@ -448,6 +456,8 @@ class VersionStorageInfo {
   // in increasing order of keys
   std::vector<FileMetaData*>* files_;
 
+  BlobFiles blob_files_;
+
   // Level that L0 data should be compacted to. All levels < base_level_ should
   // be empty. -1 if it is not level-compaction so it's not applicable.
   int base_level_;
@@ -596,8 +606,18 @@ class Version {
            SequenceNumber* seq = nullptr, ReadCallback* callback = nullptr,
            bool* is_blob = nullptr, bool do_merge = true);
 
+  // If allow_blob_index is true, blob indexes are returned as values and
+  // flagged with KeyContext::is_blob_index.
   void MultiGet(const ReadOptions&, MultiGetRange* range,
-                ReadCallback* callback = nullptr, bool* is_blob = nullptr);
+                ReadCallback* callback = nullptr,
+                bool allow_blob_index = false);
+
+  // Reads the value that `blob_index`, the value of `user_key` in a table
+  // file of the version, points to, from one of the blob files of the
+  // version. Returns Incomplete if the blob is not cached and
+  // read_options.read_tier is kBlockCacheTier.
+  Status GetBlob(const ReadOptions& read_options, const Slice& user_key,
+                 const Slice& blob_index, PinnableSlice* value) const;
 
   // Loads some stats information from files. Call without mutex held. It needs
   // to be called before applying the version to the version set.
@@ -665,6 +685,7 @@ class Version {
   int TEST_refs() const { return refs_; }
 
   VersionStorageInfo* storage_info() { return &storage_info_; }
+  const VersionStorageInfo* storage_info() const { return &storage_info_; }
 
   VersionSet* version_set() { return vset_; }
 
@@ -738,6 +759,14 @@ class Version {
   void operator=(const Version&) = delete;
 };
 
+struct ObsoleteBlobFileInfo {
+  ObsoleteBlobFileInfo(uint64_t _blob_file_number, std::string _path)
+      : blob_file_number(_blob_file_number), path(std::move(_path)) {}
+
+  uint64_t blob_file_number;
+  std::string path;
+};
+
 struct ObsoleteFileInfo {
   FileMetaData* metadata;
   std::string   path;
@@ -1001,6 +1030,9 @@ class VersionSet {
   // Add all files listed in any live version to *live.
   void AddLiveFiles(std::vector<FileDescriptor>* live_list);
 
+  // Add the numbers of the blob files of all live versions to *live.
+  void AddLiveBlobFiles(std::vector<uint64_t>* live_list);
+
   // Return the approximate size of data to be scanned for range [start, end)
   // in levels [start_level, end_level). If end_level == -1 it will search
   // through all non-empty levels
@@ -1028,6 +1060,14 @@ class VersionSet {
                         std::vector<std::string>* manifest_filenames,
                         uint64_t min_pending_output);
 
+  // Records a blob file that no live version refers to anymore, for
+  // GetObsoleteBlobFiles(). Called when the last reference to the file's
+  // metadata goes away, which may happen without the DB mutex held.
+  void AddObsoleteBlobFile(uint64_t blob_file_number, std::string path);
+
+  void GetObsoleteBlobFiles(std::vector<ObsoleteBlobFileInfo>* files,
+                            uint64_t min_pending_output);
+
   ColumnFamilySet* GetColumnFamilySet() { return column_family_set_.get(); }
   const EnvOptions& env_options() { return env_options_; }
   void ChangeEnvOptions(const MutableDBOptions& new_options) {
@@ -1140,6 +1180,10 @@ class VersionSet {
   uint64_t manifest_file_size_;
 
   std::vector<ObsoleteFileInfo> obsolete_files_;
+  // Protects obsolete_blob_files_, which, unlike obsolete_files_, is not
+  // guarded by the DB mutex
+  port::Mutex obsolete_blob_files_mutex_;
+  std::vector<ObsoleteBlobFileInfo> obsolete_blob_files_;
   std::vector<std::string> obsolete_manifests_;
 
   // env options for all reads and writes except compactions
@@ -81,6 +81,10 @@ enum ContentFlags : uint32_t {
   HAS_BEGIN_UNPREPARE = 1 << 11,
 };
 
+// Writes of at least this many entries into the memtables have their
+// inserts sorted and applied together, walking each skip list once
+const uint32_t kMinBatchedMemTableInserts = 64;
+
 struct BatchContentClassifier : public WriteBatch::Handler {
   uint32_t content_flags = 0;
 
@@ -1228,6 +1232,10 @@ class MemTableInserter : public WriteBatch::Handler {
 
   bool hint_per_batch_;
   bool hint_created_;
+  // Whether point entries are collected per memtable and inserted together
+  // by InsertBatchedEntries()
+  bool batch_memtable_inserts_;
+  std::vector<std::pair<MemTable*, std::vector<KeyHandle>>> batched_inserts_;
   // Hints for this batch
   using HintMap = std::unordered_map<MemTable*, void*>;
   using HintMapType = std::aligned_storage<sizeof(HintMap)>::type;
@@ -1301,7 +1309,8 @@ class MemTableInserter : public WriteBatch::Handler {
         duplicate_detector_(),
         dup_dectector_on_(false),
         hint_per_batch_(hint_per_batch),
-        hint_created_(false) {
+        hint_created_(false),
+        batch_memtable_inserts_(false) {
     assert(cf_mems_);
   }
 
@@ -1344,6 +1353,28 @@ class MemTableInserter : public WriteBatch::Handler {
 
   void set_log_number_ref(uint64_t log) { log_number_ref_ = log; }
 
+  // Defers the memtable inserts of point entries until
+  // InsertBatchedEntries(), which inserts each memtable's entries sorted. A
+  // key+seq cannot repeat with one seq per key, and the deferred check
+  // would not be able to report it otherwise.
+  void EnableBatchedMemTableInserts() {
+    assert(!concurrent_memtable_writes_ && !seq_per_batch_);
+    batch_memtable_inserts_ = true;
+  }
+
+  // Inserts the entries deferred for mem, or for all memtables if mem is
+  // nullptr. Must be called before reading a memtable, and once the batch
+  // is iterated.
+  void InsertBatchedEntries(MemTable* mem = nullptr) {
+    for (auto& pair : batched_inserts_) {
+      if (mem == nullptr || pair.first == mem) {
+        bool mem_res __attribute__((__unused__));
+        mem_res = pair.first->InsertBatch(&pair.second);
+        assert(mem_res);
+      }
+    }
+  }
+
   SequenceNumber sequence() const { return sequence_; }
 
   void PostProcess() {
@@ -1430,7 +1461,8 @@ class MemTableInserter : public WriteBatch::Handler {
       bool mem_res =
           mem->Add(sequence_, value_type, key, value,
                    concurrent_memtable_writes_, get_post_process_info(mem),
-                   hint_per_batch_ ? &GetHintMap()[mem] : nullptr);
+                   hint_per_batch_ ? &GetHintMap()[mem] : nullptr,
+                   get_batched_inserts(mem));
       if (UNLIKELY(!mem_res)) {
         assert(seq_per_batch_);
         ret_status = Status::TryAgain("key+seq exists");
@@ -1439,9 +1471,11 @@ class MemTableInserter : public WriteBatch::Handler {
       }
     } else if (moptions->inplace_callback == nullptr) {
       assert(!concurrent_memtable_writes_);
+      InsertBatchedEntries(mem);
       mem->Update(sequence_, key, value);
     } else {
       assert(!concurrent_memtable_writes_);
+      InsertBatchedEntries(mem);
       if (mem->UpdateCallback(sequence_, key, value)) {
       } else {
         // key not found in memtable. Do sst get, update, add
@@ -1514,7 +1548,8 @@ class MemTableInserter : public WriteBatch::Handler {
     bool mem_res =
         mem->Add(sequence_, delete_type, key, value,
                  concurrent_memtable_writes_, get_post_process_info(mem),
-                 hint_per_batch_ ? &GetHintMap()[mem] : nullptr);
+                 hint_per_batch_ ? &GetHintMap()[mem] : nullptr,
+                 get_batched_inserts(mem));
     if (UNLIKELY(!mem_res)) {
       assert(seq_per_batch_);
       ret_status = Status::TryAgain("key+seq exists");
@@ -1685,6 +1720,7 @@ class MemTableInserter : public WriteBatch::Handler {
     if (moptions->max_successive_merges > 0 && db_ != nullptr &&
         recovering_log_number_ == 0) {
       assert(!concurrent_memtable_writes_);
+      InsertBatchedEntries(mem);
       LookupKey lkey(key, sequence_);
 
       // Count the number of successive merges at the head
@@ -1745,7 +1781,8 @@ class MemTableInserter : public WriteBatch::Handler {
       // Add merge operator to memtable
       bool mem_res =
           mem->Add(sequence_, kTypeMerge, key, value,
-                   concurrent_memtable_writes_, get_post_process_info(mem));
+                   concurrent_memtable_writes_, get_post_process_info(mem),
+                   nullptr /* hint */, get_batched_inserts(mem));
       if (UNLIKELY(!mem_res)) {
         assert(seq_per_batch_);
         ret_status = Status::TryAgain("key+seq exists");
@@ -1943,6 +1980,19 @@ class MemTableInserter : public WriteBatch::Handler {
     }
     return &GetPostMap()[mem];
   }
+
+  std::vector<KeyHandle>* get_batched_inserts(MemTable* mem) {
+    if (!batch_memtable_inserts_) {
+      return nullptr;
+    }
+    for (auto& pair : batched_inserts_) {
+      if (pair.first == mem) {
+        return &pair.second;
+      }
+    }
+    batched_inserts_.emplace_back(mem, std::vector<KeyHandle>());
+    return &batched_inserts_.back().second;
+  }
 };
 
 // This function can only be called in these conditions:
@@ -1961,6 +2011,15 @@ Status WriteBatchInternal::InsertInto(
       ignore_missing_column_families, recovery_log_number, db,
       concurrent_memtable_writes, nullptr /*has_valid_writes*/, seq_per_batch,
       batch_per_txn);
+  if (!concurrent_memtable_writes && !seq_per_batch) {
+    uint32_t count = 0;
+    for (auto w : write_group) {
+      count += WriteBatchInternal::Count(w->batch);
+    }
+    if (count >= kMinBatchedMemTableInserts) {
+      inserter.EnableBatchedMemTableInserts();
+    }
+  }
   for (auto w : write_group) {
     if (w->CallbackFailed()) {
       continue;
@@ -1975,11 +2034,13 @@ Status WriteBatchInternal::InsertInto(
     inserter.set_log_number_ref(w->log_ref);
     w->status = w->batch->Iterate(&inserter);
     if (!w->status.ok()) {
+      inserter.InsertBatchedEntries();
       return w->status;
     }
     assert(!seq_per_batch || w->batch_cnt != 0);
     assert(!seq_per_batch || inserter.sequence() - w->sequence == w->batch_cnt);
   }
+  inserter.InsertBatchedEntries();
   return Status::OK();
 }
 
@@ -2022,7 +2083,12 @@ Status WriteBatchInternal::InsertInto(
                             ignore_missing_column_families, log_number, db,
                             concurrent_memtable_writes, has_valid_writes,
                             seq_per_batch, batch_per_txn);
+  if (!concurrent_memtable_writes && !seq_per_batch &&
+      WriteBatchInternal::Count(batch) >= kMinBatchedMemTableInserts) {
+    inserter.EnableBatchedMemTableInserts();
+  }
   Status s = batch->Iterate(&inserter);
+  inserter.InsertBatchedEntries();
   if (next_seq != nullptr) {
     *next_seq = inserter.sequence();
   }
@@ -154,6 +154,35 @@ TEST_F(WriteBatchTest, Multiple) {
   ASSERT_EQ(4u, batch.Count());
 }
 
+TEST_F(WriteBatchTest, ManyEntries) {
+  // Large batches are inserted into the memtable sorted, all at once
+  WriteBatch batch;
+  const int kNumKeys = 100;
+  char key[16];
+  for (int i = kNumKeys - 1; i >= 0; i--) {
+    snprintf(key, sizeof(key), "k%03d", i);
+    batch.Put(Slice(key), Slice(std::string("v") + (key + 1)));
+  }
+  batch.Delete(Slice("k050"));
+  batch.DeleteRange(Slice("k000"), Slice("k010"));
+  batch.Merge(Slice("k007"), Slice("m"));
+  WriteBatchInternal::SetSequence(&batch, 100);
+
+  std::string expected;
+  for (int i = 0; i < kNumKeys; i++) {
+    snprintf(key, sizeof(key), "k%03d", i);
+    if (i == 7) {
+      expected += "Merge(k007, m)@" + NumberToString(100 + kNumKeys + 2);
+    } else if (i == 50) {
+      expected += "Delete(k050)@" + NumberToString(100 + kNumKeys);
+    }
+    expected += std::string("Put(") + key + ", v" + (key + 1) + ")@" +
+                NumberToString(100 + kNumKeys - 1 - i);
+  }
+  expected += "DeleteRange(k000, k010)@" + NumberToString(100 + kNumKeys + 1);
+  ASSERT_EQ(expected, PrintContents(&batch));
+}
+
 TEST_F(WriteBatchTest, Corruption) {
   WriteBatch batch;
   batch.Put(Slice("foo"), Slice("bar"));
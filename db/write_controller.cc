@@ -5,6 +5,7 @@
 
 #include "db/write_controller.h"
 
+#include <algorithm>
 #include <atomic>
 #include <cassert>
 #include <ratio>
@@ -27,6 +28,22 @@ std::unique_ptr<WriteControllerToken> WriteController::GetDelayToken(
   return std::unique_ptr<WriteControllerToken>(new DelayWriteToken(this));
 }
 
+std::unique_ptr<WriteControllerToken>
+WriteController::GetWriteBufferDelayToken(uint64_t write_rate) {
+  total_write_buffer_delayed_++;
+  // Reset counters.
+  last_refill_time_ = 0;
+  bytes_left_ = 0;
+  if (write_rate == 0) {
+    write_rate = 1u;
+  } else if (write_rate > max_delayed_write_rate()) {
+    write_rate = max_delayed_write_rate();
+  }
+  write_buffer_delayed_write_rate_ = write_rate;
+  return std::unique_ptr<WriteControllerToken>(
+      new WriteBufferDelayToken(this));
+}
+
 std::unique_ptr<WriteControllerToken>
 WriteController::GetCompactionPressureToken() {
   ++total_compaction_pressure_;
@@ -37,6 +54,19 @@ WriteController::GetCompactionPressureToken() {
 bool WriteController::IsStopped() const {
   return total_stopped_.load(std::memory_order_relaxed) > 0;
 }
+
+uint64_t WriteController::EffectiveDelayedWriteRate() const {
+  const int write_buffer_delayed =
+      total_write_buffer_delayed_.load(std::memory_order_relaxed);
+  if (write_buffer_delayed == 0) {
+    return delayed_write_rate_;
+  }
+  if (total_delayed_.load(std::memory_order_relaxed) > 0) {
+    return std::min(delayed_write_rate_, write_buffer_delayed_write_rate_);
+  }
+  return write_buffer_delayed_write_rate_;
+}
+
 // This is inside DB mutex, so we can't sleep and need to minimize
 // frequency to get time.
 // If it turns out to be a performance issue, we can redesign the thread
@@ -46,12 +76,13 @@ uint64_t WriteController::GetDelay(Env* env, uint64_t num_bytes) {
   if (total_stopped_.load(std::memory_order_relaxed) > 0) {
     return 0;
   }
-  if (total_delayed_.load(std::memory_order_relaxed) == 0) {
+  if (!NeedsDelay()) {
     return 0;
   }
 
   const uint64_t kMicrosPerSecond = 1000000;
   const uint64_t kRefillInterval = 1024U;
+  const uint64_t delayed_write_rate = EffectiveDelayedWriteRate();
 
   if (bytes_left_ >= num_bytes) {
     bytes_left_ -= num_bytes;
@@ -70,7 +101,7 @@ uint64_t WriteController::GetDelay(Env* env, uint64_t num_bytes) {
       time_since_last_refill = time_now - last_refill_time_;
       bytes_left_ +=
           static_cast<uint64_t>(static_cast<double>(time_since_last_refill) /
-                                kMicrosPerSecond * delayed_write_rate_);
+                                kMicrosPerSecond * delayed_write_rate);
       if (time_since_last_refill >= kRefillInterval &&
           bytes_left_ > num_bytes) {
         // If refill interval already passed and we have enough bytes
@@ -83,7 +114,7 @@ uint64_t WriteController::GetDelay(Env* env, uint64_t num_bytes) {
   }
 
   uint64_t single_refill_amount =
-      delayed_write_rate_ * kRefillInterval / kMicrosPerSecond;
+      delayed_write_rate * kRefillInterval / kMicrosPerSecond;
   if (bytes_left_ + single_refill_amount >= num_bytes) {
     // Wait until a refill interval
     // Never trigger expire for less than one refill interval to avoid to get
@@ -99,7 +130,7 @@ uint64_t WriteController::GetDelay(Env* env, uint64_t num_bytes) {
   // Sleep just until `num_bytes` is allowed.
   uint64_t sleep_amount =
       static_cast<uint64_t>(num_bytes /
-                            static_cast<long double>(delayed_write_rate_) *
+                            static_cast<long double>(delayed_write_rate) *
                             kMicrosPerSecond) +
       sleep_debt;
   last_refill_time_ = time_now + sleep_amount;
@@ -120,6 +151,11 @@ DelayWriteToken::~DelayWriteToken() {
   assert(controller_->total_delayed_.load() >= 0);
 }
 
+WriteBufferDelayToken::~WriteBufferDelayToken() {
+  controller_->total_write_buffer_delayed_--;
+  assert(controller_->total_write_buffer_delayed_.load() >= 0);
+}
+
 CompactionPressureToken::~CompactionPressureToken() {
   controller_->total_compaction_pressure_--;
   assert(controller_->total_compaction_pressure_ >= 0);
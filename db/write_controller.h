@@ -26,9 +26,11 @@ class WriteController {
                            int64_t low_pri_rate_bytes_per_sec = 1024 * 1024)
       : total_stopped_(0),
         total_delayed_(0),
+        total_write_buffer_delayed_(0),
         total_compaction_pressure_(0),
         bytes_left_(0),
         last_refill_time_(0),
+        write_buffer_delayed_write_rate_(0),
         low_pri_rate_limiter_(
             NewGenericRateLimiter(low_pri_rate_bytes_per_sec)) {
     set_max_delayed_write_rate(_delayed_write_rate);
@@ -44,13 +46,26 @@ class WriteController {
   // which returns number of microseconds to sleep.
   std::unique_ptr<WriteControllerToken> GetDelayToken(
       uint64_t delayed_write_rate);
+  // Like GetDelayToken(), but for the memory limit of a write buffer manager.
+  // Its rate is kept apart from delayed_write_rate(): while both kinds of
+  // tokens are held, writes are delayed at the lower of the two rates, and
+  // releasing the token leaves delayed_write_rate() as it was. It is not
+  // counted by NeedsColumnFamilyDelay(). A new token replaces the rate of the
+  // previous one.
+  std::unique_ptr<WriteControllerToken> GetWriteBufferDelayToken(
+      uint64_t delayed_write_rate);
   // When an actor (column family) requests a moderate token, compaction
   // threads will be increased
   std::unique_ptr<WriteControllerToken> GetCompactionPressureToken();
 
-  // these three metods are querying the state of the WriteController
+  // these metods are querying the state of the WriteController
   bool IsStopped() const;
-  bool NeedsDelay() const { return total_delayed_.load() > 0; }
+  bool NeedsDelay() const {
+    return total_delayed_.load() > 0 || total_write_buffer_delayed_.load() > 0;
+  }
+  // Whether a column family holds a delay token, which is what the column
+  // families adjust delayed_write_rate() by
+  bool NeedsColumnFamilyDelay() const { return total_delayed_.load() > 0; }
   bool NeedSpeedupCompaction() const {
     return IsStopped() || NeedsDelay() || total_compaction_pressure_ > 0;
   }
@@ -86,14 +101,19 @@ class WriteController {
 
  private:
   uint64_t NowMicrosMonotonic(Env* env);
+  // The rate GetDelay() throttles writes to
+  uint64_t EffectiveDelayedWriteRate() const;
 
   friend class WriteControllerToken;
   friend class StopWriteToken;
   friend class DelayWriteToken;
+  friend class WriteBufferDelayToken;
   friend class CompactionPressureToken;
 
   std::atomic<int> total_stopped_;
   std::atomic<int> total_delayed_;
+  // Held by write buffer delay tokens, which total_delayed_ does not count
+  std::atomic<int> total_write_buffer_delayed_;
   std::atomic<int> total_compaction_pressure_;
   uint64_t bytes_left_;
   uint64_t last_refill_time_;
@@ -101,6 +121,8 @@ class WriteController {
   uint64_t max_delayed_write_rate_;
   // current write rate
   uint64_t delayed_write_rate_;
+  // write rate requested by the last write buffer delay token
+  uint64_t write_buffer_delayed_write_rate_;
 
   std::unique_ptr<RateLimiter> low_pri_rate_limiter_;
 };
@@ -134,6 +156,13 @@ class DelayWriteToken : public WriteControllerToken {
   virtual ~DelayWriteToken();
 };
 
+class WriteBufferDelayToken : public WriteControllerToken {
+ public:
+  explicit WriteBufferDelayToken(WriteController* controller)
+      : WriteControllerToken(controller) {}
+  virtual ~WriteBufferDelayToken();
+};
+
 class CompactionPressureToken : public WriteControllerToken {
  public:
   explicit CompactionPressureToken(WriteController* controller)
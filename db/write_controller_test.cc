@@ -45,6 +45,65 @@ TEST_F(WriteControllerTest, ChangeDelayRateTest) {
             controller.GetDelay(&env, 20000000u));
 }
 
+TEST_F(WriteControllerTest, WriteBufferDelayRateTest) {
+  TimeSetEnv env;
+  WriteController controller(40000000u);
+  controller.set_delayed_write_rate(10000000u);
+
+  auto wb_token = controller.GetWriteBufferDelayToken(2000000u);
+  ASSERT_TRUE(controller.NeedsDelay());
+  ASSERT_FALSE(controller.NeedsColumnFamilyDelay());
+  // The column families' rate is left alone
+  ASSERT_EQ(static_cast<uint64_t>(10000000), controller.delayed_write_rate());
+  ASSERT_EQ(static_cast<uint64_t>(10000000),
+            controller.GetDelay(&env, 20000000u));
+
+  // A new token replaces the rate of the previous one
+  wb_token = controller.GetWriteBufferDelayToken(4000000u);
+  ASSERT_EQ(static_cast<uint64_t>(5000000),
+            controller.GetDelay(&env, 20000000u));
+
+  // The lower of the two rates applies while both delay writes
+  auto delay_token = controller.GetDelayToken(20000000u);
+  ASSERT_EQ(static_cast<uint64_t>(5000000),
+            controller.GetDelay(&env, 20000000u));
+  delay_token = controller.GetDelayToken(1000000u);
+  ASSERT_EQ(static_cast<uint64_t>(20000000),
+            controller.GetDelay(&env, 20000000u));
+
+  ASSERT_TRUE(controller.NeedsColumnFamilyDelay());
+  wb_token.reset();
+  ASSERT_TRUE(controller.NeedsDelay());
+  ASSERT_EQ(static_cast<uint64_t>(1000000), controller.delayed_write_rate());
+  delay_token = controller.GetDelayToken(8000000u);
+  ASSERT_EQ(static_cast<uint64_t>(2500000),
+            controller.GetDelay(&env, 20000000u));
+  delay_token.reset();
+  ASSERT_FALSE(controller.NeedsDelay());
+}
+
+TEST_F(WriteControllerTest, WriteBufferDelayOnlyTest) {
+  // While only the write buffer manager delays writes, the column families
+  // see no delay, so they neither slow down nor speed up
+  // delayed_write_rate.
+  TimeSetEnv env;
+  WriteController controller(40000000u);
+  controller.set_delayed_write_rate(10000000u);
+
+  auto wb_token = controller.GetWriteBufferDelayToken(2000000u);
+  ASSERT_TRUE(controller.NeedsDelay());
+  ASSERT_FALSE(controller.NeedsColumnFamilyDelay());
+  ASSERT_TRUE(controller.NeedSpeedupCompaction());
+  ASSERT_EQ(static_cast<uint64_t>(10000000),
+            controller.GetDelay(&env, 20000000u));
+  ASSERT_EQ(static_cast<uint64_t>(10000000), controller.delayed_write_rate());
+
+  wb_token.reset();
+  ASSERT_FALSE(controller.NeedsDelay());
+  ASSERT_EQ(static_cast<uint64_t>(0), controller.GetDelay(&env, 20000000u));
+  ASSERT_EQ(static_cast<uint64_t>(10000000), controller.delayed_write_rate());
+}
+
 TEST_F(WriteControllerTest, SanityTest) {
   WriteController controller(10000000u);
   auto stop_token_1 = controller.GetStopToken();
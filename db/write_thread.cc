@@ -4,6 +4,7 @@
 //  (found in the LICENSE.Apache file in the root directory).
 
 #include "db/write_thread.h"
+#include <algorithm>
 #include <chrono>
 #include <thread>
 #include "db/column_family.h"
@@ -24,6 +25,17 @@ WriteThread::WriteThread(const ImmutableDBOptions& db_options)
       enable_pipelined_write_(db_options.enable_pipelined_write),
       max_write_batch_group_size_bytes(
           db_options.max_write_batch_group_size_bytes),
+      adaptive_write_batch_group_size_(
+          db_options.adaptive_write_batch_group_size),
+      env_(db_options.env),
+      group_growth_limit_(max_write_batch_group_size_bytes / 8),
+      last_group_start_micros_(0),
+      group_start_micros_(0),
+      group_bytes_(0),
+      group_size_limited_(false),
+      avg_group_interval_micros_(0),
+      avg_group_latency_micros_(0),
+      avg_group_bytes_(0),
       newest_writer_(nullptr),
       newest_memtable_writer_(nullptr),
       last_sequence_(0),
@@ -404,15 +416,8 @@ size_t WriteThread::EnterAsBatchGroupLeader(Writer* leader,
   assert(write_group != nullptr);
 
   size_t size = WriteBatchInternal::ByteSize(leader->batch);
-
-  // Allow the group to grow up to a maximum size, but if the
-  // original write is small, limit the growth so we do not slow
-  // down the small write too much.
-  size_t max_size = max_write_batch_group_size_bytes;
-  const uint64_t min_batch_size_bytes = max_write_batch_group_size_bytes / 8;
-  if (size <= min_batch_size_bytes) {
-    max_size = size + min_batch_size_bytes;
-  }
+  size_t max_size = MaxGroupSize(size);
+  bool size_limited = false;
 
   leader->write_group = write_group;
   write_group->leader = leader;
@@ -464,6 +469,7 @@ size_t WriteThread::EnterAsBatchGroupLeader(Writer* leader,
     auto batch_size = WriteBatchInternal::ByteSize(w->batch);
     if (size + batch_size > max_size) {
       // Do not make batch too big
+      size_limited = true;
       break;
     }
 
@@ -472,6 +478,11 @@ size_t WriteThread::EnterAsBatchGroupLeader(Writer* leader,
     write_group->last_writer = w;
     write_group->size++;
   }
+  if (adaptive_write_batch_group_size_) {
+    group_start_micros_ = env_->NowMicros();
+    group_bytes_ = size;
+    group_size_limited_ = size_limited;
+  }
   TEST_SYNC_POINT_CALLBACK("WriteThread::EnterAsBatchGroupLeader:End", w);
   return size;
 }
@@ -484,15 +495,7 @@ void WriteThread::EnterAsMemTableWriter(Writer* leader,
   assert(write_group != nullptr);
 
   size_t size = WriteBatchInternal::ByteSize(leader->batch);
-
-  // Allow the group to grow up to a maximum size, but if the
-  // original write is small, limit the growth so we do not slow
-  // down the small write too much.
-  size_t max_size = max_write_batch_group_size_bytes;
-  const uint64_t min_batch_size_bytes = max_write_batch_group_size_bytes / 8;
-  if (size <= min_batch_size_bytes) {
-    max_size = size + min_batch_size_bytes;
-  }
+  size_t max_size = MaxGroupSize(size);
 
   leader->write_group = write_group;
   write_group->leader = leader;
@@ -567,6 +570,59 @@ void WriteThread::ExitAsMemTableWriter(Writer* /*self*/,
   SetState(leader, STATE_COMPLETED);
 }
 
+size_t WriteThread::MaxGroupSize(size_t leader_size) const {
+  // Allow the group to grow up to a maximum size, but if the
+  // original write is small, limit the growth so we do not slow
+  // down the small write too much.
+  size_t max_size = max_write_batch_group_size_bytes;
+  const uint64_t min_batch_size_bytes =
+      group_growth_limit_.load(std::memory_order_relaxed);
+  if (leader_size <= min_batch_size_bytes) {
+    max_size = std::min<size_t>(max_size, leader_size + min_batch_size_bytes);
+  }
+  return max_size;
+}
+
+void WriteThread::AdaptGroupGrowthLimit() {
+  const double kWeight = 0.25;
+  uint64_t now = env_->NowMicros();
+  if (last_group_start_micros_ == 0 ||
+      group_start_micros_ <= last_group_start_micros_ ||
+      now < group_start_micros_) {
+    last_group_start_micros_ = group_start_micros_;
+    return;
+  }
+  double interval =
+      static_cast<double>(group_start_micros_ - last_group_start_micros_);
+  double latency = static_cast<double>(now - group_start_micros_);
+  last_group_start_micros_ = group_start_micros_;
+  if (avg_group_interval_micros_ == 0) {
+    avg_group_interval_micros_ = interval;
+    avg_group_latency_micros_ = latency;
+    avg_group_bytes_ = static_cast<double>(group_bytes_);
+  } else {
+    avg_group_interval_micros_ +=
+        kWeight * (interval - avg_group_interval_micros_);
+    avg_group_latency_micros_ +=
+        kWeight * (latency - avg_group_latency_micros_);
+    avg_group_bytes_ +=
+        kWeight * (static_cast<double>(group_bytes_) - avg_group_bytes_);
+  }
+
+  // The bytes that arrive while a group is being written
+  uint64_t limit = static_cast<uint64_t>(avg_group_bytes_ /
+                                         avg_group_interval_micros_ *
+                                         avg_group_latency_micros_);
+  if (group_size_limited_) {
+    limit = std::max(limit,
+                     2 * group_growth_limit_.load(std::memory_order_relaxed));
+  }
+  limit = std::max(limit, max_write_batch_group_size_bytes / 64);
+  limit = std::min(limit, max_write_batch_group_size_bytes);
+  group_growth_limit_.store(limit, std::memory_order_relaxed);
+  TEST_SYNC_POINT_CALLBACK("WriteThread::AdaptGroupGrowthLimit:Limit", &limit);
+}
+
 void WriteThread::LaunchParallelMemTableWriters(WriteGroup* write_group) {
   assert(write_group != nullptr);
   write_group->running.store(write_group->size);
@@ -618,6 +674,11 @@ void WriteThread::ExitAsBatchGroupLeader(WriteGroup& write_group,
     status = write_group.status;
   }
 
+  // Still the leader, until the next one is woken up below
+  if (adaptive_write_batch_group_size_ && status.ok()) {
+    AdaptGroupGrowthLimit();
+  }
+
   if (enable_pipelined_write_) {
     // Notify writers don't write to memtable to exit.
     for (Writer* w = last_writer; w != leader;) {
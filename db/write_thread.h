@@ -362,9 +362,31 @@ class WriteThread {
 
   // The maximum limit of number of bytes that are written in a single batch
   // of WAL or memtable write. It is followed when the leader write size
-  // is larger than 1/8 of this limit.
+  // is larger than group_growth_limit_.
   const uint64_t max_write_batch_group_size_bytes;
 
+  // Adapt group_growth_limit_ to the observed group write latency and
+  // write arrival rate.
+  const bool adaptive_write_batch_group_size_;
+  Env* const env_;
+
+  // The number of bytes a small leader write may grow its group by. 1/8 of
+  // max_write_batch_group_size_bytes unless adaptive.
+  std::atomic<uint64_t> group_growth_limit_;
+
+  // Statistics of the recent write groups, used to adapt
+  // group_growth_limit_. Only accessed by the batch group leader.
+  uint64_t last_group_start_micros_;
+  uint64_t group_start_micros_;
+  uint64_t group_bytes_;
+  // Whether the current group left out writers because of its size limit
+  bool group_size_limited_;
+  // Moving averages of the time between the start of two groups, and of the
+  // time between the start and the end of a group
+  double avg_group_interval_micros_;
+  double avg_group_latency_micros_;
+  double avg_group_bytes_;
+
   // Points to the newest pending writer. Only leader can remove
   // elements, adding can be done lock-free by anybody.
   std::atomic<Writer*> newest_writer_;
@@ -419,6 +441,15 @@ class WriteThread {
   // leader, until we hit boundary.
   Writer* FindNextLeader(Writer* pending_writer, Writer* boundary);
 
+  // Returns the maximum size of a group led by a write of leader_size bytes.
+  size_t MaxGroupSize(size_t leader_size) const;
+
+  // Updates group_growth_limit_ at the end of a batch group. The limit
+  // tracks the number of bytes expected to arrive while a group is written,
+  // so that they make up a single group. It doubles while groups leave
+  // writers out.
+  void AdaptGroupGrowthLimit();
+
   // Set the leader in write_group to completed state and remove it from the
   // write group.
   void CompleteLeader(WriteGroup& write_group);
@@ -286,7 +286,12 @@ class PosixEnv : public Env {
         }
 #endif
       }
+#if defined(ROCKSDB_IOURING_PRESENT)
+      result->reset(new PosixRandomAccessFile(fname, fd, options,
+                                              thread_local_io_urings_.get()));
+#else
       result->reset(new PosixRandomAccessFile(fname, fd, options));
+#endif
     }
     return s;
   }
@@ -988,12 +993,12 @@ class PosixEnv : public Env {
 
   // Allow increasing the number of worker threads.
   void SetBackgroundThreads(int num, Priority pri) override {
-    assert(pri >= Priority::BOTTOM && pri <= Priority::HIGH);
+    assert(pri >= Priority::BOTTOM && pri <= Priority::USER);
     thread_pools_[pri].SetBackgroundThreads(num);
   }
 
   int GetBackgroundThreads(Priority pri) override {
-    assert(pri >= Priority::BOTTOM && pri <= Priority::HIGH);
+    assert(pri >= Priority::BOTTOM && pri <= Priority::USER);
     return thread_pools_[pri].GetBackgroundThreads();
   }
 
@@ -1004,12 +1009,12 @@ class PosixEnv : public Env {
 
   // Allow increasing the number of worker threads.
   void IncBackgroundThreadsIfNeeded(int num, Priority pri) override {
-    assert(pri >= Priority::BOTTOM && pri <= Priority::HIGH);
+    assert(pri >= Priority::BOTTOM && pri <= Priority::USER);
     thread_pools_[pri].IncBackgroundThreadsIfNeeded(num);
   }
 
   void LowerThreadPoolIOPriority(Priority pool = LOW) override {
-    assert(pool >= Priority::BOTTOM && pool <= Priority::HIGH);
+    assert(pool >= Priority::BOTTOM && pool <= Priority::USER);
 #ifdef OS_LINUX
     thread_pools_[pool].LowerIOPriority();
 #else
@@ -1018,7 +1023,7 @@ class PosixEnv : public Env {
   }
 
   void LowerThreadPoolCPUPriority(Priority pool = LOW) override {
-    assert(pool >= Priority::BOTTOM && pool <= Priority::HIGH);
+    assert(pool >= Priority::BOTTOM && pool <= Priority::USER);
 #ifdef OS_LINUX
     thread_pools_[pool].LowerCPUPriority();
 #else
@@ -1113,6 +1118,11 @@ class PosixEnv : public Env {
   // If true, allow non owner read access for db files. Otherwise, non-owner
   //  has no access to db files.
   bool allow_non_owner_access_;
+#if defined(ROCKSDB_IOURING_PRESENT)
+  // The io_uring of each thread that reads files with MultiRead() or
+  // ReadAsync()
+  std::unique_ptr<ThreadLocalPtr> thread_local_io_urings_;
+#endif
 };
 
 PosixEnv::PosixEnv()
@@ -1121,6 +1131,9 @@ PosixEnv::PosixEnv()
       page_size_(getpagesize()),
       thread_pools_(Priority::TOTAL),
       allow_non_owner_access_(true) {
+#if defined(ROCKSDB_IOURING_PRESENT)
+  thread_local_io_urings_.reset(new ThreadLocalPtr(DeleteIOUring));
+#endif
   ThreadPoolImpl::PthreadCall("mutex_init", pthread_mutex_init(&mu_, nullptr));
   for (int pool_id = 0; pool_id < Env::Priority::TOTAL; ++pool_id) {
     thread_pools_[pool_id].SetThreadPriority(
@@ -1133,7 +1146,7 @@ PosixEnv::PosixEnv()
 
 void PosixEnv::Schedule(void (*function)(void* arg1), void* arg, Priority pri,
                         void* tag, void (*unschedFunction)(void* arg)) {
-  assert(pri >= Priority::BOTTOM && pri <= Priority::HIGH);
+  assert(pri >= Priority::BOTTOM && pri <= Priority::USER);
   thread_pools_[pri].Schedule(function, arg, tag, unschedFunction);
 }
 
@@ -1142,7 +1155,7 @@ int PosixEnv::UnSchedule(void* arg, Priority pri) {
 }
 
 unsigned int PosixEnv::GetThreadPoolQueueLen(Priority pri) const {
-  assert(pri >= Priority::BOTTOM && pri <= Priority::HIGH);
+  assert(pri >= Priority::BOTTOM && pri <= Priority::USER);
   return thread_pools_[pri].GetQueueLen();
 }
 
@@ -1158,6 +1158,100 @@ TEST_P(EnvPosixTestWithParam, MultiRead) {
   }
 }
 
+TEST_P(EnvPosixTestWithParam, MultiReadManyRequests) {
+  EnvOptions soptions;
+  std::string fname = test::PerThreadDBPath(env_, "testfile");
+
+  // More requests than the ring of a thread takes at once
+  const size_t kSectorSize = 4096;
+  const size_t kNumSectors = 300;
+  {
+    std::unique_ptr<WritableFile> wfile;
+    ASSERT_OK(env_->NewWritableFile(fname, &wfile, soptions));
+    for (size_t i = 0; i < kNumSectors; ++i) {
+      std::string data(kSectorSize, static_cast<char>(i % 251 + 1));
+      ASSERT_OK(wfile->Append(data));
+    }
+    ASSERT_OK(wfile->Close());
+  }
+
+  std::unique_ptr<RandomAccessFile> file;
+  ASSERT_OK(env_->NewRandomAccessFile(fname, &file, soptions));
+  // Every sector in reverse order, and one that starts half a sector before
+  // the end of the file
+  std::vector<ReadRequest> reqs(kNumSectors + 1);
+  std::vector<std::string> data(reqs.size(), std::string(kSectorSize, 0));
+  for (size_t i = 0; i < kNumSectors; ++i) {
+    reqs[i].offset = (kNumSectors - 1 - i) * kSectorSize;
+    reqs[i].len = kSectorSize;
+    reqs[i].scratch = &data[i][0];
+  }
+  reqs[kNumSectors].offset = kNumSectors * kSectorSize - kSectorSize / 2;
+  reqs[kNumSectors].len = kSectorSize;
+  reqs[kNumSectors].scratch = &data[kNumSectors][0];
+
+  ASSERT_OK(file->MultiRead(reqs.data(), reqs.size()));
+  for (size_t i = 0; i < kNumSectors; ++i) {
+    ASSERT_OK(reqs[i].status);
+    char c = static_cast<char>((kNumSectors - 1 - i) % 251 + 1);
+    ASSERT_EQ(std::string(kSectorSize, c), reqs[i].result.ToString());
+  }
+  ASSERT_OK(reqs[kNumSectors].status);
+  ASSERT_EQ(std::string(kSectorSize / 2,
+                        static_cast<char>((kNumSectors - 1) % 251 + 1)),
+            reqs[kNumSectors].result.ToString());
+}
+
+TEST_P(EnvPosixTestWithParam, ReadAsync) {
+  EnvOptions soptions;
+  std::string fname = test::PerThreadDBPath(env_, "testfile");
+
+  const size_t kSectorSize = 4096;
+  const size_t kNumSectors = 16;
+  {
+    std::unique_ptr<WritableFile> wfile;
+    ASSERT_OK(env_->NewWritableFile(fname, &wfile, soptions));
+    for (size_t i = 0; i < kNumSectors; ++i) {
+      std::string data(kSectorSize, static_cast<char>(i + 1));
+      ASSERT_OK(wfile->Append(data));
+    }
+    ASSERT_OK(wfile->Close());
+  }
+
+  std::unique_ptr<RandomAccessFile> file;
+  ASSERT_OK(env_->NewRandomAccessFile(fname, &file, soptions));
+  std::vector<ReadRequest> reqs(kNumSectors);
+  std::vector<std::string> data(reqs.size(), std::string(2 * kSectorSize, 0));
+  std::vector<void*> io_handles(reqs.size());
+  for (size_t i = 0; i < kNumSectors; ++i) {
+    reqs[i].offset = i * kSectorSize;
+    reqs[i].len = 2 * kSectorSize;
+    reqs[i].scratch = &data[i][0];
+    Status s = file->ReadAsync(&reqs[i], &io_handles[i]);
+    if (s.IsNotSupported()) {
+      // Not an Env with asynchronous reads, or no io_uring in this kernel
+      ASSERT_EQ(0, i);
+      return;
+    }
+    ASSERT_OK(s);
+  }
+  // Wait for them in reverse order, the last one from another thread
+  port::Thread waiter(
+      [&] { file->WaitAsyncRead(io_handles[kNumSectors - 1]); });
+  waiter.join();
+  for (size_t i = kNumSectors - 1; i-- > 0;) {
+    file->WaitAsyncRead(io_handles[i]);
+  }
+  for (size_t i = 0; i < kNumSectors; ++i) {
+    ASSERT_OK(reqs[i].status);
+    std::string expected(kSectorSize, static_cast<char>(i + 1));
+    if (i + 1 < kNumSectors) {
+      expected.append(kSectorSize, static_cast<char>(i + 2));
+    }
+    ASSERT_EQ(expected, reqs[i].result.ToString());
+  }
+}
+
 // Only works in linux platforms
 #ifdef OS_WIN
 TEST_P(EnvPosixTestWithParam, DISABLED_InvalidateCache) {
@@ -12,6 +12,7 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <algorithm>
+#include <vector>
 #if defined(OS_LINUX)
 #include <linux/fs.h>
 #ifndef FALLOC_FL_KEEP_SIZE
@@ -410,11 +411,21 @@ size_t PosixHelper::GetUniqueIdFromFile(int fd, char* id, size_t max_size) {
  * pread() based random-access
  */
 PosixRandomAccessFile::PosixRandomAccessFile(const std::string& fname, int fd,
-                                             const EnvOptions& options)
+                                             const EnvOptions& options
+#if defined(ROCKSDB_IOURING_PRESENT)
+                                             ,
+                                             ThreadLocalPtr* thread_local_io_urings
+#endif
+                                             )
     : filename_(fname),
       fd_(fd),
       use_direct_io_(options.use_direct_reads),
-      logical_sector_size_(GetLogicalBufferSize(fd_)) {
+      logical_sector_size_(GetLogicalBufferSize(fd_))
+#if defined(ROCKSDB_IOURING_PRESENT)
+      ,
+      thread_local_io_urings_(thread_local_io_urings)
+#endif
+{
   assert(!options.use_direct_reads || !options.use_mmap_reads);
   assert(!options.use_mmap_reads || sizeof(void*) < 8);
 }
@@ -460,6 +471,115 @@ Status PosixRandomAccessFile::Read(uint64_t offset, size_t n, Slice* result,
   return s;
 }
 
+#if defined(ROCKSDB_IOURING_PRESENT)
+namespace {
+// The handle of a read started by PosixRandomAccessFile::ReadAsync()
+struct PosixAsyncRead {
+  PosixAsyncRead(std::shared_ptr<IOUring>&& _ring, ReadRequest* _req,
+                 const IOUring::Read& _read)
+      : ring(std::move(_ring)), req(_req), read(_read) {}
+
+  // Keeps the ring alive if the thread that started the read exits
+  std::shared_ptr<IOUring> ring;
+  ReadRequest* req;
+  IOUring::Read read;
+};
+}  // namespace
+
+std::shared_ptr<IOUring> PosixRandomAccessFile::GetIOUring() {
+  if (thread_local_io_urings_ == nullptr) {
+    return nullptr;
+  }
+  auto* ring =
+      static_cast<std::shared_ptr<IOUring>*>(thread_local_io_urings_->Get());
+  if (ring == nullptr) {
+    ring = new std::shared_ptr<IOUring>(IOUring::Create(kIOUringDepth));
+    thread_local_io_urings_->Reset(ring);
+  }
+  return *ring;
+}
+
+void PosixRandomAccessFile::FinishRead(const IOUring::Read& read,
+                                       ReadRequest* req) const {
+  assert(read.finished);
+  if (read.error != 0) {
+    req->result = Slice(req->scratch, 0);
+    req->status = IOError("While reading offset " + ToString(req->offset) +
+                              " len " + ToString(req->len) + " with io_uring",
+                          filename_, read.error);
+  } else {
+    req->result = Slice(req->scratch, read.bytes_read);
+    req->status = Status::OK();
+  }
+}
+
+Status PosixRandomAccessFile::MultiRead(ReadRequest* reqs, size_t num_reqs) {
+  std::shared_ptr<IOUring> ring;
+  if (num_reqs > 1) {
+    ring = GetIOUring();
+  }
+  if (ring == nullptr) {
+    return RandomAccessFile::MultiRead(reqs, num_reqs);
+  }
+
+  size_t alignment = use_direct_io() ? GetRequiredBufferAlignment() : 1;
+  std::vector<IOUring::Read> reads;
+  std::vector<IOUring::Read*> read_ptrs;
+  reads.reserve(num_reqs);
+  read_ptrs.reserve(num_reqs);
+  for (size_t i = 0; i < num_reqs; ++i) {
+    ReadRequest& req = reqs[i];
+    if (use_direct_io()) {
+      assert(IsSectorAligned(req.offset, GetRequiredBufferAlignment()));
+      assert(IsSectorAligned(req.len, GetRequiredBufferAlignment()));
+      assert(IsSectorAligned(req.scratch, GetRequiredBufferAlignment()));
+    }
+    reads.emplace_back(fd_, req.offset, req.len, req.scratch, alignment);
+    read_ptrs.push_back(&reads.back());
+  }
+  // Submit everything before waiting for anything, so that the device gets
+  // all of the requests at once
+  for (size_t i = 0; i < num_reqs; i += ring->depth()) {
+    ring->Submit(&read_ptrs[i], std::min(ring->depth(), num_reqs - i));
+  }
+  for (size_t i = 0; i < num_reqs; ++i) {
+    ring->Wait(&reads[i]);
+    FinishRead(reads[i], &reqs[i]);
+  }
+  return Status::OK();
+}
+
+Status PosixRandomAccessFile::ReadAsync(ReadRequest* req, void** io_handle) {
+  std::shared_ptr<IOUring> ring = GetIOUring();
+  if (ring == nullptr) {
+    return Status::NotSupported("io_uring is not available");
+  }
+  if (use_direct_io()) {
+    assert(IsSectorAligned(req->offset, GetRequiredBufferAlignment()));
+    assert(IsSectorAligned(req->len, GetRequiredBufferAlignment()));
+    assert(IsSectorAligned(req->scratch, GetRequiredBufferAlignment()));
+  }
+  size_t alignment = use_direct_io() ? GetRequiredBufferAlignment() : 1;
+  std::unique_ptr<PosixAsyncRead> handle(new PosixAsyncRead(
+      std::move(ring), req,
+      IOUring::Read(fd_, req->offset, req->len, req->scratch, alignment)));
+  IOUring::Read* read = &handle->read;
+  int err = handle->ring->Submit(&read, 1);
+  if (err != 0) {
+    return IOError("While submitting a read with io_uring", filename_, err);
+  }
+  *io_handle = handle.release();
+  return Status::OK();
+}
+
+void PosixRandomAccessFile::WaitAsyncRead(void* io_handle) {
+  std::unique_ptr<PosixAsyncRead> handle(
+      static_cast<PosixAsyncRead*>(io_handle));
+  handle->ring->Wait(&handle->read);
+  FinishRead(handle->read, handle->req);
+}
+#endif  // ROCKSDB_IOURING_PRESENT
+
 Status PosixRandomAccessFile::Prefetch(uint64_t offset, size_t n) {
   Status s;
   if (!use_direct_io()) {
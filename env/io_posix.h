@@ -10,8 +10,13 @@
 #include <errno.h>
 #include <unistd.h>
 #include <atomic>
+#include <memory>
 #include <string>
 #include "rocksdb/env.h"
+#if defined(ROCKSDB_IOURING_PRESENT)
+#include "env/io_uring.h"
+#include "util/thread_local.h"
+#endif
 
 // For non linux platform, the following macros are used only as place
 // holder.
@@ -79,21 +84,51 @@ class PosixSequentialFile : public SequentialFile {
   }
 };
 
+#if defined(ROCKSDB_IOURING_PRESENT)
+// Submission queue depth of the io_uring of a thread
+static const unsigned kIOUringDepth = 256;
+
+// Deletes the io_uring of a thread that exits
+inline void DeleteIOUring(void* p) {
+  delete static_cast<std::shared_ptr<IOUring>*>(p);
+}
+#endif
+
 class PosixRandomAccessFile : public RandomAccessFile {
  protected:
   std::string filename_;
   int fd_;
   bool use_direct_io_;
   size_t logical_sector_size_;
+#if defined(ROCKSDB_IOURING_PRESENT)
+  // One std::shared_ptr<IOUring> per thread, owned by the Env. Empty where
+  // the kernel did not give the thread an io_uring.
+  ThreadLocalPtr* thread_local_io_urings_;
+#endif
 
  public:
   PosixRandomAccessFile(const std::string& fname, int fd,
-                        const EnvOptions& options);
+                        const EnvOptions& options
+#if defined(ROCKSDB_IOURING_PRESENT)
+                        ,
+                        ThreadLocalPtr* thread_local_io_urings = nullptr
+#endif
+  );
   virtual ~PosixRandomAccessFile();
 
   virtual Status Read(uint64_t offset, size_t n, Slice* result,
                       char* scratch) const override;
 
+#if defined(ROCKSDB_IOURING_PRESENT)
+  // Submits all requests to the io_uring of this thread at once, and
+  // reads them one by one if the kernel does not support io_uring.
+  virtual Status MultiRead(ReadRequest* reqs, size_t num_reqs) override;
+
+  virtual Status ReadAsync(ReadRequest* req, void** io_handle) override;
+
+  virtual void WaitAsyncRead(void* io_handle) override;
+#endif
+
   virtual Status Prefetch(uint64_t offset, size_t n) override;
 
 #if defined(OS_LINUX) || defined(OS_MACOSX) || defined(OS_AIX)
@@ -105,6 +140,14 @@ class PosixRandomAccessFile : public RandomAccessFile {
   virtual size_t GetRequiredBufferAlignment() const override {
     return logical_sector_size_;
   }
+
+#if defined(ROCKSDB_IOURING_PRESENT)
+ private:
+  // Returns the io_uring of this thread, creating it on first use, or
+  // nullptr if there is none.
+  std::shared_ptr<IOUring> GetIOUring();
+  void FinishRead(const IOUring::Read& read, ReadRequest* req) const;
+#endif
 };
 
 class PosixWritableFile : public WritableFile {
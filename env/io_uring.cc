@@ -0,0 +1,241 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#ifdef ROCKSDB_IOURING_PRESENT
+
+#include "env/io_uring.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <thread>
+
+namespace rocksdb {
+
+std::shared_ptr<IOUring> IOUring::Create(unsigned entries) {
+  struct io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  int fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+  if (fd < 0) {
+    return nullptr;
+  }
+  std::shared_ptr<IOUring> ring(new IOUring());
+  ring->ring_fd_ = fd;
+
+  ring->sq_ring_size_ =
+      params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  void* sq_ring =
+      mmap(nullptr, ring->sq_ring_size_, PROT_READ | PROT_WRITE,
+           MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+  if (sq_ring == MAP_FAILED) {
+    return nullptr;
+  }
+  ring->sq_ring_ = sq_ring;
+  char* sq = static_cast<char*>(sq_ring);
+  ring->sq_head_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+  ring->sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+  ring->sq_mask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+  ring->sq_entries_ =
+      *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_entries);
+  ring->sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+
+  ring->sqes_size_ = params.sq_entries * sizeof(struct io_uring_sqe);
+  void* sqes = mmap(nullptr, ring->sqes_size_, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+  if (sqes == MAP_FAILED) {
+    return nullptr;
+  }
+  ring->sqes_ = static_cast<struct io_uring_sqe*>(sqes);
+
+  ring->cq_ring_size_ =
+      params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+  void* cq_ring =
+      mmap(nullptr, ring->cq_ring_size_, PROT_READ | PROT_WRITE,
+           MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+  if (cq_ring == MAP_FAILED) {
+    return nullptr;
+  }
+  ring->cq_ring_ = cq_ring;
+  char* cq = static_cast<char*>(cq_ring);
+  ring->cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+  ring->cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+  ring->cq_mask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+  ring->cq_entries_ =
+      *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_entries);
+  ring->cqes_ = reinterpret_cast<struct io_uring_cqe*>(cq + params.cq_off.cqes);
+  // Never have more reads in flight than completions fit in the ring
+  if (ring->cq_entries_ < ring->sq_entries_) {
+    ring->sq_entries_ = ring->cq_entries_;
+  }
+  return ring;
+}
+
+IOUring::~IOUring() {
+  assert(in_flight_ == 0);
+  if (cq_ring_ != nullptr) {
+    munmap(cq_ring_, cq_ring_size_);
+  }
+  if (sqes_ != nullptr) {
+    munmap(sqes_, sqes_size_);
+  }
+  if (sq_ring_ != nullptr) {
+    munmap(sq_ring_, sq_ring_size_);
+  }
+  if (ring_fd_ >= 0) {
+    close(ring_fd_);
+  }
+}
+
+bool IOUring::PushLocked(Read* read) {
+  unsigned tail = *sq_tail_;
+  unsigned head = __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+  if (tail - head >= sq_entries_) {
+    return false;
+  }
+  unsigned index = tail & sq_mask_;
+  struct io_uring_sqe* sqe = &sqes_[index];
+  memset(sqe, 0, sizeof(*sqe));
+  read->iov.iov_base = read->buf + read->bytes_read;
+  read->iov.iov_len = read->len - read->bytes_read;
+  sqe->opcode = IORING_OP_READV;
+  sqe->fd = read->fd;
+  sqe->off = read->offset + read->bytes_read;
+  sqe->addr = reinterpret_cast<uint64_t>(&read->iov);
+  sqe->len = 1;
+  sqe->user_data = reinterpret_cast<uint64_t>(read);
+  sq_array_[index] = index;
+  __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+  to_submit_++;
+  return true;
+}
+
+int IOUring::EnterLocked(unsigned min_complete) {
+  while (true) {
+    unsigned flags = min_complete > 0 ? IORING_ENTER_GETEVENTS : 0;
+    long ret = syscall(__NR_io_uring_enter, ring_fd_, to_submit_,
+                       min_complete, flags, nullptr, 0);
+    if (ret >= 0) {
+      assert(static_cast<unsigned>(ret) <= to_submit_);
+      to_submit_ -= static_cast<unsigned>(ret);
+      if (to_submit_ == 0) {
+        return 0;
+      }
+    } else if (errno == EAGAIN || errno == EBUSY) {
+      // Out of kernel resources or the completion queue is full; give back
+      // completion slots and retry
+      ReapLocked();
+    } else if (errno != EINTR) {
+      return errno;
+    }
+  }
+}
+
+void IOUring::ReapLocked() {
+  unsigned head = *cq_head_;
+  unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+  for (; head != tail; ++head) {
+    const struct io_uring_cqe& cqe = cqes_[head & cq_mask_];
+    Read* read = reinterpret_cast<Read*>(cqe.user_data);
+    if (cqe.res == -EINTR || cqe.res == -EAGAIN) {
+      resubmit_.push_back(read);
+      continue;
+    }
+    if (cqe.res < 0) {
+      read->error = -cqe.res;
+    } else {
+      size_t res = static_cast<size_t>(cqe.res);
+      read->bytes_read += res;
+      if (res > 0 && read->bytes_read < read->len &&
+          res % read->alignment == 0) {
+        // A short read that is not at the end of the file
+        resubmit_.push_back(read);
+        continue;
+      }
+    }
+    read->finished = true;
+    in_flight_--;
+  }
+  __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+
+  // A resubmission takes the place of a completed submission, so it fits
+  for (Read* read : resubmit_) {
+    bool pushed = PushLocked(read);
+    assert(pushed);
+    (void)pushed;
+  }
+  resubmit_.clear();
+}
+
+int IOUring::Submit(Read** reads, size_t num_reads) {
+  auto fail = [&](int err) {
+    for (size_t i = 0; i < num_reads; i++) {
+      reads[i]->error = err;
+      reads[i]->finished = true;
+    }
+    return err;
+  };
+  std::lock_guard<std::mutex> lock(mu_);
+  if (num_reads > sq_entries_) {
+    return fail(EINVAL);
+  }
+  ReapLocked();
+  while (in_flight_ + num_reads > sq_entries_) {
+    int err = EnterLocked(1);
+    if (err != 0) {
+      return fail(err);
+    }
+    ReapLocked();
+  }
+  for (size_t i = 0; i < num_reads; i++) {
+    bool pushed = PushLocked(reads[i]);
+    assert(pushed);
+    (void)pushed;
+  }
+  in_flight_ += static_cast<unsigned>(num_reads);
+  int err = EnterLocked(0);
+  if (err != 0) {
+    FailUnsubmittedLocked(err);
+  }
+  return err;
+}
+
+void IOUring::FailUnsubmittedLocked(int err) {
+  unsigned tail = *sq_tail_;
+  for (unsigned i = tail - to_submit_; i != tail; i++) {
+    Read* read = reinterpret_cast<Read*>(sqes_[i & sq_mask_].user_data);
+    read->error = err;
+    read->finished = true;
+    in_flight_--;
+  }
+  __atomic_store_n(sq_tail_, tail - to_submit_, __ATOMIC_RELEASE);
+  to_submit_ = 0;
+}
+
+void IOUring::Wait(Read* read) {
+  std::lock_guard<std::mutex> lock(mu_);
+  ReapLocked();
+  while (!read->finished) {
+    int err = EnterLocked(1);
+    if (err != 0) {
+      // The reads that never reached the kernel fail right away. If `read`
+      // did, the kernel may write into its buffer until it posts the
+      // completion, so it cannot be finished before that. Keep polling the
+      // completion queue without blocking in the kernel.
+      FailUnsubmittedLocked(err);
+      if (!read->finished) {
+        std::this_thread::yield();
+      }
+    }
+    ReapLocked();
+  }
+}
+
+}  // namespace rocksdb
+
+#endif  // ROCKSDB_IOURING_PRESENT
@@ -0,0 +1,121 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+#ifdef ROCKSDB_IOURING_PRESENT
+
+#include <linux/io_uring.h>
+#include <sys/uio.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace rocksdb {
+
+// A Linux io_uring used for file reads, talking to the kernel through the
+// raw system calls. Reads are submitted to the submission queue, and the
+// completions of all of them are reaped by whichever thread waits for one,
+// so that a ring can be shared, although PosixEnv gives each thread its own.
+class IOUring {
+ public:
+  // A read, which is also the user data of its submission. It must stay
+  // alive and unmodified until it is finished.
+  struct Read {
+    Read(int _fd, uint64_t _offset, size_t _len, char* _buf,
+         size_t _alignment)
+        : fd(_fd),
+          offset(_offset),
+          len(_len),
+          buf(_buf),
+          alignment(_alignment),
+          bytes_read(0),
+          error(0),
+          finished(false) {}
+
+    int fd;
+    uint64_t offset;
+    size_t len;
+    char* buf;
+    // Reads shorter than len are continued, unless they are not a multiple
+    // of alignment, which is the end of a file opened for direct I/O.
+    size_t alignment;
+
+    // Set once finished
+    size_t bytes_read;
+    // errno of a failed read
+    int error;
+    bool finished;
+
+    // The part of the read that is in flight
+    struct iovec iov;
+  };
+
+  // Returns nullptr if the kernel does not support io_uring, or does not let
+  // this process use it.
+  static std::shared_ptr<IOUring> Create(unsigned entries);
+
+  ~IOUring();
+
+  // Submits the reads to the kernel, at most depth() of them. Reaps
+  // completions while the ring is full. Returns an errno if not all of them
+  // could be submitted; those are finished with that error.
+  int Submit(Read** reads, size_t num_reads);
+
+  // Returns when `read` is finished.
+  void Wait(Read* read);
+
+  // The number of reads that can be in flight.
+  size_t depth() const { return sq_entries_; }
+
+  IOUring(const IOUring&) = delete;
+  IOUring& operator=(const IOUring&) = delete;
+
+ private:
+  IOUring() = default;
+
+  // Adds a submission for the unread part of `read`. Returns false if the
+  // ring is full.
+  bool PushLocked(Read* read);
+  // Submits the pushed submissions and waits for `min_complete`
+  // completions.
+  int EnterLocked(unsigned min_complete);
+  // Processes the completions posted so far.
+  void ReapLocked();
+  // Finishes the reads that were pushed but not submitted with `err`.
+  void FailUnsubmittedLocked(int err);
+
+  std::mutex mu_;
+  int ring_fd_ = -1;
+
+  void* sq_ring_ = nullptr;
+  size_t sq_ring_size_ = 0;
+  unsigned* sq_head_ = nullptr;
+  unsigned* sq_tail_ = nullptr;
+  unsigned sq_mask_ = 0;
+  unsigned sq_entries_ = 0;
+  unsigned* sq_array_ = nullptr;
+  struct io_uring_sqe* sqes_ = nullptr;
+  size_t sqes_size_ = 0;
+
+  void* cq_ring_ = nullptr;
+  size_t cq_ring_size_ = 0;
+  unsigned* cq_head_ = nullptr;
+  unsigned* cq_tail_ = nullptr;
+  unsigned cq_mask_ = 0;
+  unsigned cq_entries_ = 0;
+  struct io_uring_cqe* cqes_ = nullptr;
+
+  // Pushed but not yet submitted
+  unsigned to_submit_ = 0;
+  // Submitted or pushed but not yet reaped
+  unsigned in_flight_ = 0;
+  std::vector<Read*> resubmit_;
+};
+
+}  // namespace rocksdb
+
+#endif  // ROCKSDB_IOURING_PRESENT
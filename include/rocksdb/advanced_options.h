@@ -35,6 +35,15 @@ enum CompactionStyle : char {
   // via CompactFiles().
   // Not supported in ROCKSDB_LITE
   kCompactionStyleNone = 0x3,
+  // Tiered above the last level, leveled in the last level. The sorted runs
+  // of L0 and of the levels above the last one are merged like in universal
+  // compaction, which keeps the write amplification low, and the level
+  // above the last one is merged into the last level one file at a time like
+  // in level based compaction, which avoids the full compactions of
+  // universal compaction. See hybrid_target_write_amplification.
+  // Requires num_levels >= 3.
+  // Not supported in ROCKSDB_LITE
+  kCompactionStyleHybrid = 0x4,
 };
 
 // In Level-based compaction, it Determines which file from a level to be
@@ -117,6 +126,37 @@ struct CompressionOptions {
   // Default: 0.
   uint32_t zstd_max_train_bytes;
 
+  // Number of threads compressing the data blocks of each table file. When
+  // greater than 1, a table builder hands the data blocks it cuts to that
+  // many threads of its own and writes them out in their original order once
+  // compressed, so the file is the same as with a single thread. Up to four
+  // blocks per thread are kept in memory while they wait to be compressed or
+  // written. Files are cut from an estimate of their compressed size, so
+  // compaction output files can be slightly smaller or larger than with a
+  // single thread.
+  //
+  // Default: 1.
+  uint32_t parallel_threads;
+
+  // When nonzero, the files written to a level of a column family share one
+  // compression dictionary instead of each sampling its data to build its
+  // own. Only the first file of a level builds a dictionary, from its own
+  // data like above; the files after it start compressing right away with
+  // that dictionary, without buffering. Once a dictionary has been used for
+  // this many files, the next file builds a new one from its data, so that
+  // the dictionary follows the data. The dictionaries are recorded in the
+  // MANIFEST, and if the dictionary blocks are cached like the index and
+  // filter blocks (`cache_index_and_filter_blocks`), a reader keeps a
+  // dictionary in the block cache once for all the files that use it.
+  //
+  // As building a dictionary costs little, dictionaries are then also used
+  // for flushes and for compactions to levels other than the bottommost one.
+  //
+  // Only used if `max_dict_bytes` is nonzero.
+  //
+  // Default: 0.
+  uint32_t shared_dict_files;
+
   // When the compression options are set by the user, it will be set to "true".
   // For bottommost_compression_opts, to enable it, user must set enabled=true.
   // Otherwise, bottommost compression will use compression_opts as default
@@ -134,6 +174,8 @@ struct CompressionOptions {
         strategy(0),
         max_dict_bytes(0),
         zstd_max_train_bytes(0),
+        parallel_threads(1),
+        shared_dict_files(0),
         enabled(false) {}
   CompressionOptions(int wbits, int _lev, int _strategy, int _max_dict_bytes,
                      int _zstd_max_train_bytes, bool _enabled)
@@ -142,6 +184,8 @@ struct CompressionOptions {
         strategy(_strategy),
         max_dict_bytes(_max_dict_bytes),
         zstd_max_train_bytes(_zstd_max_train_bytes),
+        parallel_threads(1),
+        shared_dict_files(0),
         enabled(_enabled) {}
 };
 
@@ -560,6 +604,21 @@ struct AdvancedColumnFamilyOptions {
   // SetOptions("compaction_options_fifo", "{max_table_files_size=100;}")
   CompactionOptionsFIFO compaction_options_fifo;
 
+  // Only used by kCompactionStyleHybrid, whose tiered levels are merged
+  // following compaction_options_universal.size_ratio, min_merge_width and
+  // max_merge_width. The level above the last one is merged into the last
+  // level once it holds at least 1/(hybrid_target_write_amplification - 1)
+  // of the size of the last level, so that merging a byte into the last
+  // level rewrites about hybrid_target_write_amplification bytes. Lower
+  // values reduce the write amplification, but keep more data in the tiered
+  // levels, which increases the space and read amplification. Values below
+  // 2 are treated as 2.
+  //
+  // Default: 10
+  //
+  // Dynamically changeable through SetOptions() API
+  double hybrid_target_write_amplification = 10;
+
   // An iteration->Next() sequentially skips over keys with the same
   // user-key unless this option is set. This number specifies the number
   // of keys (with the same userkey) that will be sequentially
@@ -681,6 +740,59 @@ struct AdvancedColumnFamilyOptions {
   // data is left uncompressed (unless compression is also requested).
   uint64_t sample_for_compression = 0;
 
+  // If set, flushes and compactions move the values that are at least
+  // min_blob_size bytes into blob files, and store a reference to the blob
+  // in the table files in their place. Large values are then written once,
+  // instead of being rewritten by every compaction of the keys they belong
+  // to, at the cost of an extra read to fetch them.
+  //
+  // The blob files are part of the LSM-tree like the table files: they are
+  // recorded in the MANIFEST, and deleted once none of the values they hold
+  // is referenced anymore. Not supported with BlobDB, DBCloud or FIFO
+  // compaction, which fail to open with it, with tailing iterators, or with
+  // the compaction filters that need the values, since compaction filters
+  // are given the blob references of the moved values.
+  //
+  // Default: false
+  //
+  // Not dynamically changeable through SetOptions() API
+  bool enable_blob_files = false;
+
+  // The smallest value that is moved into a blob file, when
+  // enable_blob_files is set.
+  //
+  // Default: 0
+  //
+  // Not dynamically changeable through SetOptions() API
+  uint64_t min_blob_size = 0;
+
+  // A blob file is closed and another one started once it reaches this
+  // size.
+  //
+  // Default: 256MB
+  //
+  // Not dynamically changeable through SetOptions() API
+  uint64_t blob_file_size = 1ULL << 28;
+
+  // If set, compactions relocate the live blobs of the oldest blob files
+  // they read to new blob files, so that the old files can be deleted
+  // once all their blobs are garbage. A compaction only reclaims the blobs
+  // of the keys it compacts, so a blob file is only deleted once all of its
+  // keys have been compacted.
+  //
+  // Default: false
+  //
+  // Not dynamically changeable through SetOptions() API
+  bool enable_blob_garbage_collection = false;
+
+  // The fraction of the blob files, oldest first, whose blobs are relocated
+  // by blob garbage collection.
+  //
+  // Default: 0.25
+  //
+  // Not dynamically changeable through SetOptions() API
+  double blob_garbage_collection_age_cutoff = 0.25;
+
   // Create ColumnFamilyOptions with default values for all fields
   AdvancedColumnFamilyOptions();
   // Create ColumnFamilyOptions from Options
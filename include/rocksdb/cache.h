@@ -23,6 +23,7 @@
 #pragma once
 
 #include <stdint.h>
+#include <functional>
 #include <memory>
 #include <string>
 #include "rocksdb/memory_allocator.h"
@@ -33,6 +34,7 @@
 namespace rocksdb {
 
 class Cache;
+class SecondaryCache;
 
 extern const bool kDefaultToAdaptiveMutex;
 
@@ -76,6 +78,25 @@ struct LRUCacheOptions {
   // -DROCKSDB_DEFAULT_TO_ADAPTIVE_MUTEX, false otherwise.
   bool use_adaptive_mutex = kDefaultToAdaptiveMutex;
 
+  // If non-nullptr, entries inserted with Cache::InsertWithHelper() are
+  // saved to this tier when evicted, and Cache::LookupWithHelper() brings
+  // them back on a miss. The memory used by the secondary cache is charged
+  // against the capacity of this cache with dummy entries, the same way
+  // WriteBufferManager charges memtables, so that both tiers share one
+  // memory budget. See NewCompressedSecondaryCache().
+  std::shared_ptr<SecondaryCache> secondary_cache;
+
+  // If true, an insert that needs to evict is only admitted if the new
+  // entry was looked up more often than the least recently used entry it
+  // would evict first, as estimated by a per-shard frequency sketch
+  // (TinyLFU) that follows the number of entries the cache holds and
+  // decays over time. Blocks read once, like those of a long scan or of a
+  // compaction with fill_cache=true, no longer push hot blocks out. An
+  // insert that is turned away returns OK, with a handle to an entry kept
+  // outside of the cache until it is released if one was requested.
+  // High priority entries are always admitted.
+  bool tiny_lfu_admission = false;
+
   LRUCacheOptions() {}
   LRUCacheOptions(size_t _capacity, int _num_shard_bits,
                   bool _strict_capacity_limit, double _high_pri_pool_ratio,
@@ -114,6 +135,23 @@ extern std::shared_ptr<Cache> NewClockCache(size_t capacity,
                                             int num_shard_bits = -1,
                                             bool strict_capacity_limit = false);
 
+// Similar to NewLRUCache, but create a cache based on CLOCK algorithm that
+// takes no lock on any operation, including Lookup and Release, so it scales
+// to many threads hitting the same shard. It does not depend on TBB. See
+// cache/lock_free_clock_cache.h for more detail.
+//
+// The hash table of each shard is allocated up front and does not grow, so
+// estimated_entry_charge, the expected average charge of an entry (e.g. the
+// block size for a block cache), has to be given. If entries are much
+// smaller than estimated, the table fills up before the cache reaches its
+// capacity; if much larger, memory is wasted on unused slots.
+//
+// Return nullptr if the arguments are invalid.
+extern std::shared_ptr<Cache> NewLockFreeClockCache(
+    size_t capacity, size_t estimated_entry_charge, int num_shard_bits = -1,
+    bool strict_capacity_limit = false,
+    std::shared_ptr<MemoryAllocator> memory_allocator = nullptr);
+
 class Cache {
  public:
   // Depending on implementation, cache entries with high priority could be less
@@ -135,6 +173,32 @@ class Cache {
   // Opaque handle to an entry stored in the cache.
   struct Handle {};
 
+  typedef void (*DeleterFn)(const Slice& key, void* value);
+
+  // Callbacks that let a cache save an entry it evicts to a secondary cache
+  // tier (see SecondaryCache), as a flat buffer of size_cb(obj) bytes.
+  // saveto_cb copies length bytes of that buffer, starting at from_offset,
+  // to out. del_cb is the deleter of the entry.
+  typedef size_t (*SizeCallback)(void* obj);
+  typedef Status (*SaveToCallback)(void* from_obj, size_t from_offset,
+                                   size_t length, void* out);
+
+  struct CacheItemHelper {
+    SizeCallback size_cb;
+    SaveToCallback saveto_cb;
+    DeleterFn del_cb;
+
+    CacheItemHelper(SizeCallback _size_cb, SaveToCallback _saveto_cb,
+                    DeleterFn _del_cb)
+        : size_cb(_size_cb), saveto_cb(_saveto_cb), del_cb(_del_cb) {}
+  };
+
+  // Recreates an entry from the buffer saved through its CacheItemHelper,
+  // returning the new value in *out_obj and its charge in *charge.
+  typedef std::function<Status(const void* buf, size_t size, void** out_obj,
+                               size_t* charge)>
+      CreateCallback;
+
   // The type of the Cache
   virtual const char* Name() const = 0;
 
@@ -167,6 +231,27 @@ class Cache {
   // function.
   virtual Handle* Lookup(const Slice& key, Statistics* stats = nullptr) = 0;
 
+  // Like Insert(), but with the deleter in helper, and the entry may be
+  // saved to the secondary cache tier of this cache, if any, when it is
+  // evicted. helper must outlive the cache.
+  virtual Status InsertWithHelper(const Slice& key, void* value,
+                                  const CacheItemHelper* helper, size_t charge,
+                                  Handle** handle = nullptr,
+                                  Priority priority = Priority::LOW) {
+    return Insert(key, value, charge, helper->del_cb, handle, priority);
+  }
+
+  // Like Lookup(), but if key is not in this cache and was saved to its
+  // secondary cache tier, the entry is recreated with create_cb, inserted
+  // with helper and priority, and returned.
+  virtual Handle* LookupWithHelper(const Slice& key,
+                                   const CacheItemHelper* /*helper*/,
+                                   const CreateCallback& /*create_cb*/,
+                                   Priority /*priority*/ = Priority::LOW,
+                                   Statistics* stats = nullptr) {
+    return Lookup(key, stats);
+  }
+
   // Increments the reference count for the handle if it refers to an entry in
   // the cache. Returns true if refcount was incremented; otherwise, returns
   // false.
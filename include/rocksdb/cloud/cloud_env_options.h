@@ -106,6 +106,71 @@ enum class CloudRequestOpType {
 using CloudRequestCallback =
     std::function<void(CloudRequestOpType, uint64_t, uint64_t, bool)>;
 
+// The classes of data transfers to and from cloud storage that are throttled
+// by a CloudTransferLimiter. Lower values have higher priority.
+enum class CloudTransferPriority : unsigned char {
+  kUserRead = 0x0,        // reads issued by user threads (Get, iterators)
+  kCompactionRead = 0x1,  // reads issued by background flush/compaction jobs
+  kUpload = 0x2,          // uploads of newly created files
+  kTotal = 0x3,
+};
+
+//
+// Throttles data transfers between the local machine and cloud storage. A
+// limiter enforces two budgets at the same time: a request rate (requests
+// are what cloud providers bill for) and a byte rate (which keeps the NIC
+// from being saturated). A value of zero for either rate means that budget
+// is unlimited. Waiting requests are admitted in priority order, so a burst
+// of compaction traffic does not starve user reads.
+//
+// A single limiter can be shared among multiple CloudEnvs.
+//
+class CloudTransferLimiter {
+ public:
+  virtual ~CloudTransferLimiter() {}
+
+  // Blocks until a request that transfers `bytes` bytes is admitted. Requests
+  // larger than the byte budget of a refill period are admitted once the
+  // budget is positive, and the overdraft delays subsequent requests.
+  virtual void Request(int64_t bytes, CloudTransferPriority pri) = 0;
+
+  // Accounts for `bytes` that were transferred by an already admitted
+  // request whose size was not known up front (e.g. whole-object downloads).
+  // Never blocks; the overdraft delays subsequent requests.
+  virtual void Charge(int64_t bytes, CloudTransferPriority pri) = 0;
+
+  // Dynamically changes the budgets. Zero disables the respective budget.
+  // REQUIRED: bytes_per_second >= 0, requests_per_second >= 0
+  virtual void SetBytesPerSecond(int64_t bytes_per_second) = 0;
+  virtual void SetRequestsPerSecond(int64_t requests_per_second) = 0;
+
+  virtual int64_t GetBytesPerSecond() const = 0;
+  virtual int64_t GetRequestsPerSecond() const = 0;
+
+  // Total bytes and requests that went through the limiter
+  virtual int64_t GetTotalBytesThrough(
+      CloudTransferPriority pri = CloudTransferPriority::kTotal) const = 0;
+  virtual int64_t GetTotalRequests(
+      CloudTransferPriority pri = CloudTransferPriority::kTotal) const = 0;
+
+  // Total time requests spent blocked in Request(), in microseconds
+  virtual int64_t GetTotalWaitMicros(
+      CloudTransferPriority pri = CloudTransferPriority::kTotal) const = 0;
+};
+
+// Create a CloudTransferLimiter.
+// @bytes_per_second: the byte budget shared by all transfers, 0 to disable.
+// @requests_per_second: the request budget shared by all transfers, 0 to
+// disable.
+// @refill_period_us: budgets are accumulated for at most this long, which
+// bounds the size of a burst after an idle period.
+// @fairness: a waiting lower-priority request is admitted after at most
+// `fairness` higher-priority requests were admitted ahead of it. This keeps
+// uploads (and therefore flushes) from starving under heavy read load.
+extern CloudTransferLimiter* NewCloudTransferLimiter(
+    int64_t bytes_per_second, int64_t requests_per_second,
+    int64_t refill_period_us = 100 * 1000, int32_t fairness = 10);
+
 class BucketOptions {
 private:
   std::string bucket_; // The suffix for the bucket name
@@ -266,6 +331,15 @@ private:
   // Default: false
   bool use_aws_transfer_manager;
 
+  // If non-null, throttles downloads, ranged reads and uploads between this
+  // env and cloud storage. Reads issued from background jobs are charged as
+  // CloudTransferPriority::kCompactionRead, reads from other threads as
+  // kUserRead, and uploads as kUpload. The budgets of the limiter can be
+  // changed at runtime through DBCloud::SetDBOptions() using the keys
+  // "cloud_transfer_bytes_per_sec" and "cloud_transfer_requests_per_sec".
+  // Default: nullptr
+  std::shared_ptr<CloudTransferLimiter> transfer_limiter;
+
   CloudEnvOptions(
       CloudType _cloud_type = CloudType::kCloudAws,
       LogType _log_type = LogType::kLogKafka,
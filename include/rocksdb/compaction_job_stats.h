@@ -7,6 +7,7 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <string>
+#include <vector>
 
 namespace rocksdb {
 struct CompactionJobStats {
@@ -90,5 +91,16 @@ struct CompactionJobStats {
 
   // number of single-deletes which meet something other than a put
   uint64_t num_single_del_mismatch;
+
+  // the number of input records and the elapsed time in microseconds of
+  // each subcompaction, in key order. The spread between the entries shows
+  // how evenly the work was split between the subcompactions.
+  std::vector<uint64_t> subcompaction_input_records;
+  std::vector<uint64_t> subcompaction_elapsed_micros;
+
+  // the elapsed time of the slowest subcompaction divided by the mean
+  // elapsed time of all subcompactions. 1.0 means the subcompactions were
+  // perfectly balanced.
+  double subcompaction_skew;
 };
 }  // namespace rocksdb
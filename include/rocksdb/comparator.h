@@ -93,6 +93,13 @@ class Comparator {
   // with the customized comparator.
   virtual bool CanKeysWithDifferentByteContentsBeEqual() const { return true; }
 
+  // return true if Compare() orders keys like BytewiseComparator(), i.e. by
+  // memcmp() and then by length. Such keys, and the user keys of internal
+  // keys, are then compared inline on the hot paths of block seeks, merging
+  // iterators and the memtable, with their first 16 bytes loaded as
+  // big-endian integers, instead of through a virtual Compare() call.
+  virtual bool IsBytewiseOrder() const { return false; }
+
   inline size_t timestamp_size() const { return timestamp_size_; }
 
   virtual int CompareWithoutTimestamp(const Slice& a, const Slice& b) const {
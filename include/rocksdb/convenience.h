@@ -64,8 +64,8 @@ namespace rocksdb {
 //   - CompressionType: valid values are "kNoCompression",
 //     "kSnappyCompression", "kZlibCompression", "kBZip2Compression", ...
 //   - CompactionStyle: valid values are "kCompactionStyleLevel",
-//     "kCompactionStyleUniversal", "kCompactionStyleFIFO", and
-//     "kCompactionStyleNone".
+//     "kCompactionStyleUniversal", "kCompactionStyleFIFO",
+//     "kCompactionStyleNone", and "kCompactionStyleHybrid".
 //
 
 // Take a default ColumnFamilyOptions "base_options" in addition to a
@@ -752,6 +752,12 @@ class DB {
     //      entries being pinned.
     static const std::string kBlockCachePinnedUsage;
 
+    //  "rocksdb.db-write-buffer-usage" - returns the approximate size of the
+    //      active, unflushed immutable, and pinned immutable memtables of all
+    //      the column families of the DB, i.e. the share of the DB in the
+    //      memory charged to its write buffer manager (bytes).
+    static const std::string kDBWriteBufferUsage;
+
     // "rocksdb.options-statistics" - returns multi-line string
     //      of options.statistics
     static const std::string kOptionsStatistics;
@@ -811,6 +817,7 @@ class DB {
   //  "rocksdb.block-cache-capacity"
   //  "rocksdb.block-cache-usage"
   //  "rocksdb.block-cache-pinned-usage"
+  //  "rocksdb.db-write-buffer-usage"
   virtual bool GetIntProperty(ColumnFamilyHandle* column_family,
                               const Slice& property, uint64_t* value) = 0;
   virtual bool GetIntProperty(const Slice& property, uint64_t* value) {
@@ -648,6 +648,19 @@ class RandomAccessFile {
     return Status::OK();
   }
 
+  // Starts reading req->len bytes at req->offset into req->scratch, and
+  // returns without waiting for them. On success, *io_handle must be passed
+  // to WaitAsyncRead() exactly once, which waits for the read to complete
+  // and sets req->result and req->status. req and req->scratch must stay
+  // valid until then. Returns NotSupported if the file cannot read
+  // asynchronously, in which case the caller should read synchronously.
+  virtual Status ReadAsync(ReadRequest* /*req*/, void** /*io_handle*/) {
+    return Status::NotSupported("ReadAsync");
+  }
+
+  // Waits for a read started by ReadAsync().
+  virtual void WaitAsyncRead(void* /*io_handle*/) {}
+
   // Tries to get an unique ID for this file that will be the same each time
   // the file is opened (and will stay the same while the file is open).
   // Furthermore, it tries to make this ID at most "max_size" bytes. If such an
@@ -1400,6 +1413,12 @@ class RandomAccessFileWrapper : public RandomAccessFile {
   Status MultiRead(ReadRequest* reqs, size_t num_reqs) override {
     return target_->MultiRead(reqs, num_reqs);
   }
+  Status ReadAsync(ReadRequest* req, void** io_handle) override {
+    return target_->ReadAsync(req, io_handle);
+  }
+  void WaitAsyncRead(void* io_handle) override {
+    target_->WaitAsyncRead(io_handle);
+  }
   Status Prefetch(uint64_t offset, size_t n) override {
     return target_->Prefetch(offset, n);
   }
@@ -28,6 +28,7 @@
 namespace rocksdb {
 
 class Slice;
+struct BlockBasedTableOptions;
 
 // A class that takes a bunch of keys, then generates filter
 class FilterBitsBuilder {
@@ -92,6 +93,20 @@ class FilterBitsReader {
 // Set 1 MUST be implemented correctly, Set 2 is optional
 // RocksDB would first try using functions in Set 2. if they return nullptr,
 // it would use Set 1 instead.
+// Contextual information passed to FilterPolicy::GetBuilderWithContext(),
+// so that a policy can choose a filter by where the table will live.
+struct FilterBuildingContext {
+  explicit FilterBuildingContext(const BlockBasedTableOptions& _table_options)
+      : table_options(_table_options) {}
+
+  // Options for the table being built
+  const BlockBasedTableOptions& table_options;
+
+  // The LSM level the table is created for; -1 if unknown, e.g. for files
+  // written by SstFileWriter. Flushes create tables at level 0.
+  int level_at_creation = -1;
+};
+
 // You can choose filter type in NewBloomFilterPolicy
 class FilterPolicy {
  public:
@@ -123,6 +138,14 @@ class FilterPolicy {
   // It contains interface to take individual key, then generate filter
   virtual FilterBitsBuilder* GetFilterBitsBuilder() const { return nullptr; }
 
+  // Like GetFilterBitsBuilder(), but with information about the table the
+  // filter is built for. This is what the block-based table builder calls;
+  // the default ignores the context.
+  virtual FilterBitsBuilder* GetBuilderWithContext(
+      const FilterBuildingContext& /*context*/) const {
+    return GetFilterBitsBuilder();
+  }
+
   // Get the FilterBitsReader, which is ONLY used for full filter block
   // It contains interface to tell if key can be in filter
   // The input slice should NOT be deleted by FilterPolicy
@@ -132,6 +155,21 @@ class FilterPolicy {
   }
 };
 
+// The format of full (and partitioned) filters built by the policy returned
+// from NewBloomFilterPolicy(). Filters of either format are read by any
+// policy returned from NewBloomFilterPolicy(), so the format can be changed
+// on an existing DB. Block-based filters always use the legacy format.
+enum class BloomFilterImpl : char {
+  // Understood by all versions of RocksDB.
+  kLegacy = 0,
+  // All probes for a key fall into one 64-byte cache line and are checked
+  // at once with AVX2 where available. Noticeably more accurate than kLegacy
+  // at the same bits/key, especially for bits/key above 10. Older versions
+  // of RocksDB treat these filters as always matching (no false negatives,
+  // but no filtering either).
+  kFastLocal = 1,
+};
+
 // Return a new filter policy that uses a bloom filter with approximately
 // the specified number of bits per key.
 //
@@ -139,6 +177,7 @@ class FilterPolicy {
 // is 10, which yields a filter with ~ 1% false positive rate.
 // use_block_based_builder: use block based filter rather than full filter.
 // If you want to builder full filter, it needs to be set to false.
+// impl: the format of full filters built by this policy.
 //
 // Callers must delete the result after any database that is using the
 // result has been closed.
@@ -151,5 +190,25 @@ class FilterPolicy {
 // FilterPolicy (like NewBloomFilterPolicy) that does not ignore
 // trailing spaces in keys.
 extern const FilterPolicy* NewBloomFilterPolicy(
-    int bits_per_key, bool use_block_based_builder = false);
+    int bits_per_key, bool use_block_based_builder = false,
+    BloomFilterImpl impl = BloomFilterImpl::kLegacy);
+
+// Return a new filter policy that builds static XOR filters, which reach
+// about the false positive rate of a Bloom filter with bits_per_key bits
+// per key in less space (e.g. 0.8% FP rate in ~8.6 bits/key for
+// bits_per_key=10), at the cost of slower, more memory-hungry construction
+// (~40 bytes per key while building). Best suited to the last levels,
+// which hold most of the data and are rewritten only by compaction.
+//
+// Tables created for levels below bloom_before_level get a
+// BloomFilterImpl::kFastLocal Bloom filter instead, e.g.
+// bloom_before_level = 3 keeps the cheaper-to-build Bloom filter for
+// flushes and L1-L2 compactions. Tables of unknown level get XOR filters.
+//
+// Filters built by this policy and by NewBloomFilterPolicy() are readable
+// by either, so switching between them is safe. Older versions of RocksDB
+// treat XOR filters as always matching. Block-based filters are not
+// supported.
+extern const FilterPolicy* NewXorFilterPolicy(int bits_per_key,
+                                              int bloom_before_level = 0);
 }  // namespace rocksdb
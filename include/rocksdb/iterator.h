@@ -70,6 +70,19 @@ class Iterator : public Cleanable {
   // REQUIRES: Valid()
   virtual void Prev() = 0;
 
+  // Stores the keys and the values of up to `n` entries, starting at the
+  // current one, in the arrays `keys` and `values`, and moves past them as
+  // Next() would. Returns the number of entries stored, which is less than
+  // `n` only if the iterator became invalid; check status() then.
+  //
+  // The keys and the values are copied to `buf`, except that an iterator of
+  // a DB does not copy the values that are in memtables or in blocks, and
+  // with ReadOptions::pin_data not the keys either. The blocks of a batch
+  // stay pinned until the iterator is next modified. The returned slices are
+  // valid until the iterator or `buf` is next modified.
+  virtual size_t NextN(size_t n, Slice* keys, Slice* values,
+                       std::string* buf);
+
   // Return the key for the current entry.  The underlying storage for
   // the returned slice is valid only until the next modification of
   // the iterator.
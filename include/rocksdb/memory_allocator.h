@@ -7,6 +7,7 @@
 
 #include "rocksdb/status.h"
 
+#include <stddef.h>
 #include <memory>
 
 namespace rocksdb {
@@ -74,4 +75,26 @@ extern Status NewJemallocNodumpAllocator(
     JemallocAllocatorOptions& options,
     std::shared_ptr<MemoryAllocator>* memory_allocator);
 
+struct SlabMemoryAllocatorOptions {
+  // Smaller allocations are rounded up to this size.
+  size_t min_allocation_size = 1024;
+
+  // Larger allocations are not pooled: they are allocated and freed with the
+  // default allocator.
+  size_t max_allocation_size = 256 * 1024;
+
+  // The most memory that the freed buffers waiting to be reused can hold.
+  // It comes in addition to the capacity of the cache using the allocator.
+  size_t max_pooled_bytes = 64 << 20;
+};
+
+// Generate memory allocators that recycle the buffers they are given back,
+// by size class, instead of freeing them. Used with the block cache, blocks
+// loaded into the cache take the buffers of those that were evicted, without
+// going through malloc() and free(). Sizes are rounded up to one of 8 size
+// classes per power of two.
+extern Status NewSlabMemoryAllocator(
+    const SlabMemoryAllocatorOptions& options,
+    std::shared_ptr<MemoryAllocator>* memory_allocator);
+
 }  // namespace rocksdb
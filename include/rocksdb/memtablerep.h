@@ -45,6 +45,7 @@ namespace rocksdb {
 
 class Arena;
 class Allocator;
+class Comparator;
 class LookupKey;
 class SliceTransform;
 class Logger;
@@ -75,6 +76,11 @@ class MemTableRep {
     virtual int operator()(const char* prefix_len_key,
                            const Slice& key) const = 0;
 
+    // Comparator of the user keys, which order the internal keys first, or
+    // nullptr if unknown. A representation may use it to order most keys
+    // without calling the comparator.
+    virtual const Comparator* user_comparator() const { return nullptr; }
+
     virtual ~KeyComparator() {}
   };
 
@@ -157,6 +163,23 @@ class MemTableRep {
     return true;
   }
 
+  // Inserts num keys, like a call to InsertKey() for each of them. The
+  // handles array may be reordered. Returns false if any of the <key, seq>
+  // already existed.
+  //
+  // Currently only skip-list based memtable implement the interface, by
+  // sorting the keys and inserting them in order. Other implementations
+  // fallback to InsertKey() by default.
+  virtual bool InsertKeyBatch(KeyHandle* handles, size_t num) {
+    bool res = true;
+    for (size_t i = 0; i < num; i++) {
+      if (!InsertKey(handles[i])) {
+        res = false;
+      }
+    }
+    return res;
+  }
+
   // Returns true iff an entry that compares equal to key is in the collection.
   virtual bool Contains(const char* key) const = 0;
 
@@ -349,6 +372,26 @@ class VectorRepFactory : public MemTableRepFactory {
   virtual const char* Name() const override { return "VectorRepFactory"; }
 };
 
+// This creates MemTableReps that are backed by a B+-tree with cache-line
+// aligned nodes allocated from the memtable's arena. Compared to the skip
+// list, a lookup reads a few contiguous nodes instead of chasing a pointer
+// per level, which helps seek-heavy workloads on large memtables. Inserts,
+// concurrent or not, are serialized by a spin lock and do not scale like the
+// skip list's; reads never block.
+class BPlusTreeRepFactory : public MemTableRepFactory {
+ public:
+  using MemTableRepFactory::CreateMemTableRep;
+  virtual MemTableRep* CreateMemTableRep(const MemTableRep::KeyComparator&,
+                                         Allocator*, const SliceTransform*,
+                                         Logger* logger) override;
+
+  virtual const char* Name() const override { return "BPlusTreeRepFactory"; }
+
+  bool IsInsertConcurrentlySupported() const override { return true; }
+
+  bool CanHandleDuplicatedKey() const override { return true; }
+};
+
 // This class contains a fixed array of buckets, each
 // pointing to a skiplist (null if the bucket is empty).
 // bucket_count: number of fixed array buckets
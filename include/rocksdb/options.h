@@ -781,6 +781,15 @@ struct DBOptions {
   // Dynamically changeable through SetDBOptions() API.
   size_t compaction_readahead_size = 0;
 
+  // Number of threads of the Env::USER pool that fill readahead buffers in
+  // the background. When non-zero, compactions with a non-zero
+  // compaction_readahead_size read the next readahead window of each input
+  // file while they process the current one, and iterators created with
+  // ReadOptions::async_readahead do the same with their readahead.
+  //
+  // Default: 0
+  int max_background_readaheads = 0;
+
   // This is a maximum buffer size that is used by WinMmapReadableFile in
   // unbuffered disk I/O mode. We need to maintain an aligned buffer for
   // reads. We allow the buffer to grow until the specified value and then
@@ -963,6 +972,18 @@ struct DBOptions {
   // Default: 1 MB
   uint64_t max_write_batch_group_size_bytes = 1 << 20;
 
+  // If true, the number of bytes a small leader write may batch with, 1/8 of
+  // max_write_batch_group_size_bytes by default, adapts to the observed
+  // write latency (including WAL sync) and write arrival rate. It tracks the
+  // bytes expected to arrive while a group is written, between 1/64 and all
+  // of max_write_batch_group_size_bytes, so that slow WAL syncs under many
+  // concurrent writers are amortized over larger groups, while fast writes
+  // keep small groups and low latency. Applies to both stages of
+  // enable_pipelined_write.
+  //
+  // Default: false
+  bool adaptive_write_batch_group_size = false;
+
   // The maximum number of microseconds that a write operation will use
   // a yielding spin loop to coordinate with other write threads before
   // blocking on a mutex.  (Assuming write_thread_slow_yield_usec is
@@ -1212,6 +1233,15 @@ struct ReadOptions {
   // Default: 0
   size_t readahead_size;
 
+  // If true, readahead, whether automatic or set by `readahead_size`, is
+  // double-buffered: while the iterator consumes one buffer, the next
+  // readahead window of the file is read into another one by a thread of the
+  // Env::USER pool, whose size is set by DBOptions::max_background_readaheads.
+  // If no thread has started that read by the time the iterator needs it,
+  // the iterator does it itself. Not used with mmap reads.
+  // Default: false
+  bool async_readahead;
+
   // A threshold for the number of keys that can be skipped before failing an
   // iterator seek as incomplete. The default value of 0 should be used to
   // never fail a request as incomplete, even on skipping too many keys.
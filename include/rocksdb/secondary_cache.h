@@ -0,0 +1,95 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <stdint.h>
+#include <memory>
+#include <string>
+
+#include "rocksdb/cache.h"
+#include "rocksdb/memory_allocator.h"
+#include "rocksdb/options.h"
+#include "rocksdb/slice.h"
+#include "rocksdb/status.h"
+
+namespace rocksdb {
+
+// SecondaryCache
+//
+// A second tier behind a Cache (see LRUCacheOptions::secondary_cache).
+// Entries evicted from the primary cache are offered to it in the flat
+// form defined by their Cache::CacheItemHelper, and a lookup that misses
+// the primary cache can recreate the entry from there. The primary cache
+// calls these methods without holding any of its locks.
+class SecondaryCache {
+ public:
+  virtual ~SecondaryCache() {}
+
+  virtual const char* Name() const = 0;
+
+  // Saves the entry for key, which is being evicted from the primary cache.
+  // value stays owned by the caller; it is only read through helper. A
+  // secondary cache may decline to keep the entry.
+  virtual Status Insert(const Slice& key, void* value,
+                        const Cache::CacheItemHelper* helper) = 0;
+
+  // If key was saved, recreates its value with create_cb and returns OK,
+  // with ownership of *value and its charge in *charge going to the
+  // caller. Since the caller inserts the value back into the primary cache,
+  // the entry is removed from this tier. Returns NotFound otherwise.
+  virtual Status Lookup(const Slice& key,
+                        const Cache::CreateCallback& create_cb, void** value,
+                        size_t* charge) = 0;
+
+  // Removes the entry for key, if any.
+  virtual void Erase(const Slice& key) = 0;
+
+  // Memory used by the saved entries, which the primary cache charges
+  // against its own capacity.
+  virtual size_t GetUsage() const = 0;
+
+  virtual std::string GetPrintableOptions() const = 0;
+};
+
+struct CompressedSecondaryCacheOptions {
+  // Maximum memory used by the compressed entries.
+  size_t capacity = 0;
+
+  // The tier is an LRU cache of compressed entries, sharded into
+  // 2^num_shard_bits shards as in NewLRUCache().
+  int num_shard_bits = -1;
+
+  // Compression applied to saved entries. Entries that do not compress
+  // well, or all entries if the type is not supported by this build, are
+  // kept uncompressed.
+  CompressionType compression_type = kLZ4Compression;
+
+  // Allocator for the decompressed buffers handed to CreateCallback.
+  std::shared_ptr<MemoryAllocator> memory_allocator;
+
+  CompressedSecondaryCacheOptions() {}
+  CompressedSecondaryCacheOptions(
+      size_t _capacity, int _num_shard_bits,
+      CompressionType _compression_type = kLZ4Compression,
+      std::shared_ptr<MemoryAllocator> _memory_allocator = nullptr)
+      : capacity(_capacity),
+        num_shard_bits(_num_shard_bits),
+        compression_type(_compression_type),
+        memory_allocator(std::move(_memory_allocator)) {}
+};
+
+// Create an in-memory secondary cache that keeps entries evicted from the
+// primary cache in compressed form, so that the same memory holds more of
+// a skewed working set at the cost of decompressing on a hit. With a block
+// cache, this replaces BlockBasedTableOptions::block_cache_compressed: blocks
+// are only compressed once evicted, and are promoted back to the primary
+// cache when hit.
+//
+// Return nullptr if the options are invalid.
+extern std::shared_ptr<SecondaryCache> NewCompressedSecondaryCache(
+    const CompressedSecondaryCacheOptions& opts);
+
+}  // namespace rocksdb
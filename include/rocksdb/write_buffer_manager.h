@@ -12,9 +12,12 @@
 
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <cstddef>
+#include <vector>
 #include "rocksdb/cache.h"
+#include "rocksdb/status.h"
 
 namespace rocksdb {
 
@@ -24,8 +27,17 @@ class WriteBufferManager {
   // memory_usage() won't be valid and ShouldFlush() will always return true.
   // if `cache` is provided, we'll put dummy entries in the cache and cost
   // the memory allocated to the cache. It can be used even if _buffer_size = 0.
+  //
+  // If `arbitrate` is true, the manager picks the memtable to flush when the
+  // buffer is full among all the DBs sharing it (see Client), instead of
+  // letting the DB that happens to be writing flush one of its own. It flushes
+  // from a thread of its own, so that DBs that are not being written to get
+  // flushed too. Writes are also slowed down gradually once the memory usage
+  // exceeds the buffer size (see DelayedWriteRateRatio()). Only used if
+  // _buffer_size > 0.
   explicit WriteBufferManager(size_t _buffer_size,
-                              std::shared_ptr<Cache> cache = {});
+                              std::shared_ptr<Cache> cache = {},
+                              bool arbitrate = false);
   // No copying allowed
   WriteBufferManager(const WriteBufferManager&) = delete;
   WriteBufferManager& operator=(const WriteBufferManager&) = delete;
@@ -87,6 +99,72 @@ class WriteBufferManager {
     }
   }
 
+  // Whether the manager picks the memtables to flush itself.
+  bool arbitrates() const { return arbiter_ != nullptr; }
+
+  // A mutable memtable that a flush would free, as reported by a Client.
+  struct FlushCandidate {
+    uint32_t column_family_id = 0;
+    // Memory used by the memtable
+    size_t memory_usage = 0;
+    // Seconds since the oldest entry of the memtable was written
+    uint64_t age_seconds = 0;
+    // The state of the column family, which tells how likely a flush is to
+    // stall its writes
+    int num_immutable_memtables = 0;
+    int num_level0_files = 0;
+    int level0_slowdown_writes_trigger = 0;
+  };
+
+  // A DB whose memtables are charged to an arbitrating manager. DBs register
+  // themselves when they are opened.
+  class Client {
+   public:
+    virtual ~Client() {}
+
+    // Appends the mutable memtables of the DB that could be flushed.
+    virtual void GetFlushCandidates(
+        std::vector<FlushCandidate>* candidates) = 0;
+
+    // Switches the mutable memtable of the column family to immutable and
+    // schedules its flush, without waiting for the flush.
+    virtual Status FlushColumnFamily(uint32_t column_family_id) = 0;
+  };
+
+  // Neither may be called while holding a lock the client methods need.
+  // Once UnregisterClient() returns, the manager does not call the client
+  // anymore.
+  void RegisterClient(Client* client);
+  void UnregisterClient(Client* client);
+
+  // With arbitration, asks the manager's thread to flush memtables, picked
+  // among all the clients, until ShouldFlush() is false. Called by writers
+  // when ShouldFlush() is true.
+  void MaybeScheduleFlush();
+
+  // With arbitration, the fraction of DBOptions::delayed_write_rate that
+  // writes to the DBs sharing the manager should be limited to, or 0 if
+  // they need no delay. Writes are delayed once the memory usage exceeds the
+  // buffer size, and the rate halves for every eighth of the buffer size
+  // over it, down to 1/16.
+  double DelayedWriteRateRatio() const {
+    if (arbiter_ == nullptr || !enabled()) {
+      return 0;
+    }
+    size_t usage = memory_usage();
+    if (usage <= buffer_size_) {
+      return 0;
+    }
+    size_t steps = (usage - buffer_size_) / (buffer_size_ / 8 + 1);
+    return 1.0 / static_cast<double>(1 << std::min<size_t>(steps, 4));
+  }
+
+  // How much flushing the candidate is worth to the manager: the memory it
+  // frees, weighed up by the age of the memtable and down by how close the
+  // column family is to a write stall. The candidate with the highest score
+  // is flushed first.
+  static double FlushScore(const FlushCandidate& candidate);
+
  private:
   const size_t buffer_size_;
   const size_t mutable_limit_;
@@ -95,8 +173,15 @@ class WriteBufferManager {
   std::atomic<size_t> memory_active_;
   struct CacheRep;
   std::unique_ptr<CacheRep> cache_rep_;
+  struct Arbiter;
+  std::unique_ptr<Arbiter> arbiter_;
 
   void ReserveMemWithCache(size_t mem);
   void FreeMemWithCache(size_t mem);
+
+  void ArbiterLoop();
+  // Flushes the candidate with the highest score. Returns false if there was
+  // none or it could not be flushed.
+  bool FlushBestCandidate(const std::vector<Client*>& clients);
 };
 }  // namespace rocksdb
@@ -5985,6 +5985,8 @@ class ChecksumTypeJni {
        return 0x2;
      case rocksdb::ChecksumType::kxxHash64:
        return 0x3;
+     case rocksdb::ChecksumType::kXXH3:
+       return 0x4;
      default:
        return 0x7F;  // undefined
    }
@@ -6003,6 +6005,8 @@ class ChecksumTypeJni {
        return rocksdb::ChecksumType::kxxHash;
      case 0x3:
        return rocksdb::ChecksumType::kxxHash64;
+     case 0x4:
+       return rocksdb::ChecksumType::kXXH3;
      default:
        // undefined/default
        return rocksdb::ChecksumType::kCRC32c;
@@ -0,0 +1,145 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "memory/slab_memory_allocator.h"
+
+#include <assert.h>
+#include <string.h>
+#include <algorithm>
+
+#include "util/mutexlock.h"
+
+namespace rocksdb {
+
+namespace {
+
+// The index of the highest bit set in `v`, which is not 0
+inline int HighestBit(size_t v) {
+  assert(v != 0);
+  int bit = 0;
+  while (v >>= 1) {
+    bit++;
+  }
+  return bit;
+}
+
+}  // namespace
+
+SlabMemoryAllocator::SlabMemoryAllocator(
+    const SlabMemoryAllocatorOptions& options)
+    : max_pooled_bytes_(options.max_pooled_bytes), pooled_bytes_(0) {
+  // A class needs 2^kClassBitsPerDoubling steps between powers of two
+  min_size_bits_ = std::max(HighestBit(std::max<size_t>(
+                                options.min_allocation_size, 1)),
+                            kClassBitsPerDoubling);
+  if ((size_t{1} << min_size_bits_) < options.min_allocation_size) {
+    min_size_bits_++;
+  }
+  max_size_ = std::max(options.max_allocation_size, size_t{1} << min_size_bits_);
+  size_t ignored;
+  num_classes_ = ClassFor(max_size_, &ignored) + 1;
+  classes_.reset(new SizeClass[num_classes_]);
+}
+
+SlabMemoryAllocator::~SlabMemoryAllocator() {
+  for (uint32_t i = 0; i < num_classes_; i++) {
+    for (char* buffer : classes_[i].free_buffers) {
+      delete[] buffer;
+    }
+  }
+}
+
+uint32_t SlabMemoryAllocator::ClassFor(size_t size, size_t* class_size) const {
+  const size_t min_size = size_t{1} << min_size_bits_;
+  if (size <= min_size) {
+    *class_size = min_size;
+    return 0;
+  }
+  if (size > max_size_) {
+    *class_size = size;
+    return kUnpooledClass;
+  }
+  // 2^bit < size <= 2^(bit + 1), split into steps of 2^bit / 8
+  const int bit = HighestBit(size - 1);
+  const int step_bits = bit - kClassBitsPerDoubling;
+  const size_t steps = ((size - 1) >> step_bits) + 1;
+  *class_size = steps << step_bits;
+  return static_cast<uint32_t>(
+      ((bit - min_size_bits_) << kClassBitsPerDoubling) +
+      (steps - (size_t{1} << kClassBitsPerDoubling)));
+}
+
+size_t SlabMemoryAllocator::ClassSize(uint32_t size_class) const {
+  if (size_class == 0) {
+    return size_t{1} << min_size_bits_;
+  }
+  const uint32_t kSteps = uint32_t{1} << kClassBitsPerDoubling;
+  const int bit = min_size_bits_ + static_cast<int>((size_class - 1) / kSteps);
+  const size_t steps = kSteps + 1 + (size_class - 1) % kSteps;
+  return steps << (bit - kClassBitsPerDoubling);
+}
+
+void* SlabMemoryAllocator::Allocate(size_t size) {
+  size_t class_size;
+  const uint32_t size_class = ClassFor(size, &class_size);
+  char* buffer = nullptr;
+  if (size_class != kUnpooledClass) {
+    SizeClass& c = classes_[size_class];
+    MutexLock lock(&c.mutex);
+    if (!c.free_buffers.empty()) {
+      buffer = c.free_buffers.back();
+      c.free_buffers.pop_back();
+      pooled_bytes_.fetch_sub(class_size, std::memory_order_relaxed);
+    }
+  }
+  if (buffer == nullptr) {
+    buffer = new char[kHeaderSize + class_size];
+    memcpy(buffer, &size_class, sizeof(size_class));
+  }
+  return buffer + kHeaderSize;
+}
+
+void SlabMemoryAllocator::Deallocate(void* p) {
+  char* buffer = static_cast<char*>(p) - kHeaderSize;
+  uint32_t size_class;
+  memcpy(&size_class, buffer, sizeof(size_class));
+  if (size_class != kUnpooledClass) {
+    const size_t class_size = ClassSize(size_class);
+    // Only keep the buffer if the pool has room for it. The check races with
+    // other threads, so the pool may exceed its limit by a few buffers.
+    if (pooled_bytes_.load(std::memory_order_relaxed) + class_size <=
+        max_pooled_bytes_) {
+      SizeClass& c = classes_[size_class];
+      MutexLock lock(&c.mutex);
+      c.free_buffers.push_back(buffer);
+      pooled_bytes_.fetch_add(class_size, std::memory_order_relaxed);
+      return;
+    }
+  }
+  delete[] buffer;
+}
+
+size_t SlabMemoryAllocator::UsableSize(void* p,
+                                       size_t allocation_size) const {
+  uint32_t size_class;
+  memcpy(&size_class, static_cast<char*>(p) - kHeaderSize,
+         sizeof(size_class));
+  return size_class == kUnpooledClass ? allocation_size
+                                      : ClassSize(size_class);
+}
+
+Status NewSlabMemoryAllocator(
+    const SlabMemoryAllocatorOptions& options,
+    std::shared_ptr<MemoryAllocator>* memory_allocator) {
+  if (options.min_allocation_size > options.max_allocation_size) {
+    *memory_allocator = nullptr;
+    return Status::InvalidArgument(
+        "min_allocation_size larger than max_allocation_size");
+  }
+  memory_allocator->reset(new SlabMemoryAllocator(options));
+  return Status::OK();
+}
+
+}  // namespace rocksdb
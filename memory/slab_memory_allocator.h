@@ -0,0 +1,66 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "port/port.h"
+#include "rocksdb/memory_allocator.h"
+
+namespace rocksdb {
+
+// A MemoryAllocator that keeps the buffers it is given back, by size class,
+// and hands them out again, so that a block cache that evicts and loads
+// blocks of similar sizes all day does not go through malloc() and free()
+// for each of them.
+//
+// Sizes up to max_allocation_size are rounded up to one of 8 classes per
+// power of two, which wastes at most 1/8 of a buffer. Each buffer is
+// preceded by a header that records its class.
+class SlabMemoryAllocator : public MemoryAllocator {
+ public:
+  explicit SlabMemoryAllocator(const SlabMemoryAllocatorOptions& options);
+  ~SlabMemoryAllocator() override;
+
+  const char* Name() const override { return "SlabMemoryAllocator"; }
+  void* Allocate(size_t size) override;
+  void Deallocate(void* p) override;
+  size_t UsableSize(void* p, size_t allocation_size) const override;
+
+  // The bytes held by the buffers that wait to be reused
+  size_t GetPooledBytes() const {
+    return pooled_bytes_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  // The number of size classes per power of two, as a power of two
+  static const int kClassBitsPerDoubling = 3;
+  // Keeps the buffers aligned like those of malloc()
+  static const size_t kHeaderSize = 16;
+  // The class of the buffers larger than max_allocation_size
+  static const uint32_t kUnpooledClass = ~uint32_t{0};
+
+  struct SizeClass {
+    port::Mutex mutex;
+    std::vector<char*> free_buffers;
+  };
+
+  // Returns the class for `size`, and its buffer size in `*class_size`, or
+  // kUnpooledClass if buffers of `size` bytes are not pooled
+  uint32_t ClassFor(size_t size, size_t* class_size) const;
+  size_t ClassSize(uint32_t size_class) const;
+
+  const size_t max_pooled_bytes_;
+  int min_size_bits_;
+  size_t max_size_;
+  std::unique_ptr<SizeClass[]> classes_;
+  uint32_t num_classes_;
+  std::atomic<size_t> pooled_bytes_;
+};
+
+}  // namespace rocksdb
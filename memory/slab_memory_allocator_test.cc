@@ -0,0 +1,110 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "memory/slab_memory_allocator.h"
+
+#include <string.h>
+#include <vector>
+
+#include "memory/memory_allocator.h"
+#include "test_util/testharness.h"
+#include "util/random.h"
+
+namespace rocksdb {
+
+class SlabMemoryAllocatorTest : public testing::Test {
+ public:
+  SlabMemoryAllocatorTest() {
+    options_.min_allocation_size = 1024;
+    options_.max_allocation_size = 64 * 1024;
+    options_.max_pooled_bytes = 256 * 1024;
+  }
+
+  SlabMemoryAllocatorOptions options_;
+};
+
+TEST_F(SlabMemoryAllocatorTest, SizeClasses) {
+  SlabMemoryAllocator allocator(options_);
+  for (size_t size = 1; size <= 2 * options_.max_allocation_size; size++) {
+    void* p = allocator.Allocate(size);
+    size_t usable = allocator.UsableSize(p, size);
+    ASSERT_GE(usable, size);
+    if (size <= options_.min_allocation_size) {
+      ASSERT_EQ(options_.min_allocation_size, usable);
+    } else if (size <= options_.max_allocation_size) {
+      // At most 1/8 wasted
+      ASSERT_LE(usable - size, usable / 8);
+    } else {
+      ASSERT_EQ(size, usable);
+    }
+    // Aligned like malloc()
+    ASSERT_EQ(0, reinterpret_cast<uintptr_t>(p) % 16);
+    memset(p, 0xab, usable);
+    allocator.Deallocate(p);
+  }
+}
+
+TEST_F(SlabMemoryAllocatorTest, ReusesBuffers) {
+  SlabMemoryAllocator allocator(options_);
+  void* p = allocator.Allocate(4100);
+  size_t usable = allocator.UsableSize(p, 4100);
+  allocator.Deallocate(p);
+  ASSERT_EQ(usable, allocator.GetPooledBytes());
+
+  // Any size of the same class gets the buffer back
+  void* q = allocator.Allocate(usable);
+  ASSERT_EQ(p, q);
+  ASSERT_EQ(0, allocator.GetPooledBytes());
+  allocator.Deallocate(q);
+
+  // Buffers too large to be pooled are freed
+  void* large = allocator.Allocate(options_.max_allocation_size + 1);
+  allocator.Deallocate(large);
+  ASSERT_EQ(usable, allocator.GetPooledBytes());
+}
+
+TEST_F(SlabMemoryAllocatorTest, PoolLimit) {
+  SlabMemoryAllocator allocator(options_);
+  std::vector<void*> buffers;
+  for (int i = 0; i < 10; i++) {
+    buffers.push_back(allocator.Allocate(32 * 1024));
+  }
+  for (void* p : buffers) {
+    allocator.Deallocate(p);
+  }
+  ASSERT_EQ(options_.max_pooled_bytes, allocator.GetPooledBytes());
+}
+
+TEST_F(SlabMemoryAllocatorTest, BlockCache) {
+  std::shared_ptr<MemoryAllocator> allocator;
+  ASSERT_OK(NewSlabMemoryAllocator(options_, &allocator));
+  Random rnd(301);
+  std::vector<CacheAllocationPtr> blocks;
+  for (int i = 0; i < 1000; i++) {
+    size_t size = 4000 + rnd.Uniform(200);
+    blocks.push_back(AllocateBlock(size, allocator.get()));
+    memset(blocks.back().get(), 0, size);
+    if (blocks.size() > 16) {
+      blocks.erase(blocks.begin() + rnd.Uniform(16));
+    }
+  }
+  blocks.clear();
+  auto slab_allocator = static_cast<SlabMemoryAllocator*>(allocator.get());
+  // Only a few buffers were ever allocated, of the classes of 4096 and 4608
+  // bytes
+  ASSERT_LE(slab_allocator->GetPooledBytes(), 17 * (4096 + 4608));
+
+  SlabMemoryAllocatorOptions bad_options;
+  bad_options.min_allocation_size = 2 * bad_options.max_allocation_size;
+  ASSERT_TRUE(
+      NewSlabMemoryAllocator(bad_options, &allocator).IsInvalidArgument());
+}
+
+}  // namespace rocksdb
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
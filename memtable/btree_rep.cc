@@ -0,0 +1,519 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+//
+// A B+-tree of memtable entries that readers search without locking.
+//
+// Each node holds up to kFanout entries in sorted order. Next to the pointer
+// to each entry, a node keeps the first 8 bytes of the entry's user key as a
+// big-endian integer (when the user comparator is bytewise), so that most
+// comparisons on the way down are decided by the node itself instead of a
+// comparator call on an entry somewhere else in the arena. Nodes are aligned
+// to cache lines and never freed, merged or moved.
+//
+// Writers are serialized by a spin lock. A reader copies a node and then
+// checks that the node's version was even and did not change while copying,
+// retrying otherwise, as with a sequence lock. A split first fills the new
+// right sibling with the upper half of the node, then publishes it through
+// the node's right link, and only then adds it to the parent. Readers that
+// copied the parent before that can reach the moved entries by following the
+// right links: every node records the key its entries are below (its high
+// key), and a reader looking for a key at or above it moves right. This is
+// the B-link tree of Lehman and Yao, without deletions.
+
+#ifndef ROCKSDB_LITE
+#include "rocksdb/memtablerep.h"
+
+#include <assert.h>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <string>
+
+#include "db/memtable.h"
+#include "memory/allocator.h"
+#include "memory/arena.h"
+#include "port/port.h"
+#include "rocksdb/comparator.h"
+#include "util/mutexlock.h"
+
+namespace rocksdb {
+namespace {
+
+const int kFanout = 16;
+// Nodes are at least half full, so this is plenty.
+const int kMaxHeight = 32;
+
+struct Node {
+  // Odd while the writer changes the node.
+  std::atomic<uint32_t> version;
+  // 0 for leaves. Never changes.
+  uint16_t level;
+  std::atomic<uint16_t> count;
+  // The next node to the right at the same level, or nullptr.
+  std::atomic<Node*> next;
+  // The entries of the node and its subtree are below this key, or there is
+  // no bound if high_key is nullptr. The ones at or above it moved to next.
+  std::atomic<uint64_t> high_prefix;
+  std::atomic<const char*> high_key;
+  std::atomic<uint64_t> prefixes[kFanout];
+  std::atomic<const char*> keys[kFanout];
+
+  explicit Node(uint16_t _level)
+      : version(0), level(_level), count(0), next(nullptr), high_prefix(0),
+        high_key(nullptr) {}
+};
+
+struct InternalNode : public Node {
+  // children[i] holds the entries from keys[i] up to keys[i + 1]. keys[0] is
+  // nullptr in the leftmost node of each level, where it stands for a key
+  // below all others.
+  std::atomic<Node*> children[kFanout];
+
+  explicit InternalNode(uint16_t _level) : Node(_level) {}
+};
+
+// A consistent copy of a node, as seen by a reader.
+struct NodeCopy {
+  int level;
+  int count;
+  Node* next;
+  uint64_t high_prefix;
+  const char* high_key;
+  uint64_t prefixes[kFanout + 1];
+  const char* keys[kFanout + 1];
+  // Internal nodes only
+  Node* children[kFanout + 1];
+};
+
+class BPlusTreeRep : public MemTableRep {
+ public:
+  BPlusTreeRep(const KeyComparator& compare, Allocator* allocator);
+
+  void Insert(KeyHandle handle) override {
+    bool inserted = InsertKey(handle);
+    assert(inserted);
+    (void)inserted;
+  }
+
+  bool InsertKey(KeyHandle handle) override {
+    std::lock_guard<SpinMutex> guard(write_mutex_);
+    return InsertLocked(static_cast<const char*>(handle));
+  }
+
+  void InsertConcurrently(KeyHandle handle) override { Insert(handle); }
+
+  bool InsertKeyConcurrently(KeyHandle handle) override {
+    return InsertKey(handle);
+  }
+
+  // Returns true iff an entry that compares equal to key is in the tree.
+  bool Contains(const char* key) const override;
+
+  size_t ApproximateMemoryUsage() override {
+    // All memory is allocated through allocator; nothing to report here
+    return 0;
+  }
+
+  void Get(const LookupKey& k, void* callback_args,
+           bool (*callback_func)(void* arg, const char* entry)) override;
+
+  ~BPlusTreeRep() override {}
+
+  class Iterator : public MemTableRep::Iterator {
+   public:
+    // The returned iterator is not valid.
+    explicit Iterator(const BPlusTreeRep* tree) : tree_(tree), index_(-1) {
+      leaf_.count = 0;
+    }
+
+    ~Iterator() override {}
+
+    bool Valid() const override { return index_ >= 0 && index_ < leaf_.count; }
+
+    const char* key() const override {
+      assert(Valid());
+      return leaf_.keys[index_];
+    }
+
+    // Entries inserted after the iterator copied the current leaf may be
+    // skipped, as with the other representations.
+    void Next() override;
+
+    void Prev() override;
+
+    void Seek(const Slice& user_key, const char* memtable_key) override;
+
+    void SeekForPrev(const Slice& user_key, const char* memtable_key) override;
+
+    void SeekToFirst() override;
+
+    void SeekToLast() override;
+
+   private:
+    const BPlusTreeRep* tree_;
+    // Copy of the current leaf
+    NodeCopy leaf_;
+    int index_;
+    std::string tmp_;  // For passing to EncodeKey
+  };
+
+  MemTableRep::Iterator* GetIterator(Arena* arena = nullptr) override {
+    void* mem = arena ? arena->AllocateAligned(sizeof(Iterator))
+                      : operator new(sizeof(Iterator));
+    return new (mem) Iterator(this);
+  }
+
+ private:
+  // Big-endian first 8 bytes of the user key of an entry, padded with zeros,
+  // if the user keys are ordered bytewise. Otherwise 0, which leaves all the
+  // work to compare_.
+  uint64_t KeyPrefix(const char* key) const {
+    if (!use_prefixes_) {
+      return 0;
+    }
+    Slice internal_key = GetLengthPrefixedSlice(key);
+    assert(internal_key.size() >= 8);
+    size_t n = std::min<size_t>(8, internal_key.size() - 8);
+    uint64_t prefix = 0;
+    for (size_t i = 0; i < n; i++) {
+      prefix |= static_cast<uint64_t>(static_cast<unsigned char>(
+                    internal_key[i]))
+                << (56 - 8 * i);
+    }
+    return prefix;
+  }
+
+  int Compare(uint64_t prefix_a, const char* a, uint64_t prefix_b,
+              const char* b) const {
+    if (prefix_a != prefix_b) {
+      return prefix_a < prefix_b ? -1 : 1;
+    }
+    return compare_(a, b);
+  }
+
+  // Index of the first key of copy at or after from that is above the target,
+  // or at or above it if !inclusive. count if there is none.
+  int UpperBound(const NodeCopy& copy, int from, uint64_t prefix,
+                 const char* key, bool inclusive) const {
+    int lo = from;
+    int hi = copy.count;
+    while (lo < hi) {
+      int mid = (lo + hi) / 2;
+      int cmp = Compare(copy.prefixes[mid], copy.keys[mid], prefix, key);
+      if (cmp < 0 || (inclusive && cmp == 0)) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    return lo;
+  }
+
+  static void ReadNode(const Node* node, NodeCopy* copy);
+
+  // Copies into *copy the leaf whose range holds the target, or if strict,
+  // the leaf that holds the last entry below the target, if any.
+  void FindLeaf(uint64_t prefix, const char* key, bool strict,
+                NodeCopy* copy) const;
+
+  Node* NewNode(int level);
+
+  bool InsertLocked(const char* key);
+
+  // Sets entry i of node. Only the writer calls these.
+  static void SetEntry(Node* node, int i, uint64_t prefix, const char* key,
+                       Node* child) {
+    node->prefixes[i].store(prefix, std::memory_order_relaxed);
+    node->keys[i].store(key, std::memory_order_relaxed);
+    if (node->level > 0) {
+      static_cast<InternalNode*>(node)->children[i].store(
+          child, std::memory_order_relaxed);
+    }
+  }
+
+  static uint32_t BeginWrite(Node* node) {
+    uint32_t version = node->version.load(std::memory_order_relaxed);
+    assert((version & 1) == 0);
+    node->version.store(version + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    return version;
+  }
+
+  static void EndWrite(Node* node, uint32_t version) {
+    node->version.store(version + 2, std::memory_order_release);
+  }
+
+  const KeyComparator& compare_;
+  const bool use_prefixes_;
+  SpinMutex write_mutex_;
+  std::atomic<Node*> root_;
+};
+
+BPlusTreeRep::BPlusTreeRep(const KeyComparator& compare, Allocator* allocator)
+    : MemTableRep(allocator),
+      compare_(compare),
+      use_prefixes_(compare.user_comparator() == BytewiseComparator()),
+      root_(nullptr) {
+  root_.store(NewNode(0), std::memory_order_relaxed);
+}
+
+void BPlusTreeRep::ReadNode(const Node* node, NodeCopy* copy) {
+  const InternalNode* internal =
+      node->level > 0 ? static_cast<const InternalNode*>(node) : nullptr;
+  while (true) {
+    uint32_t version = node->version.load(std::memory_order_acquire);
+    if ((version & 1) == 0) {
+      copy->level = node->level;
+      copy->count = node->count.load(std::memory_order_relaxed);
+      copy->next = node->next.load(std::memory_order_relaxed);
+      copy->high_prefix = node->high_prefix.load(std::memory_order_relaxed);
+      copy->high_key = node->high_key.load(std::memory_order_relaxed);
+      for (int i = 0; i < copy->count; i++) {
+        copy->prefixes[i] = node->prefixes[i].load(std::memory_order_relaxed);
+        copy->keys[i] = node->keys[i].load(std::memory_order_relaxed);
+      }
+      if (internal != nullptr) {
+        for (int i = 0; i < copy->count; i++) {
+          copy->children[i] =
+              internal->children[i].load(std::memory_order_relaxed);
+        }
+      }
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (node->version.load(std::memory_order_relaxed) == version) {
+        return;
+      }
+    }
+    port::AsmVolatilePause();
+  }
+}
+
+void BPlusTreeRep::FindLeaf(uint64_t prefix, const char* key, bool strict,
+                            NodeCopy* copy) const {
+  const Node* node = root_.load(std::memory_order_acquire);
+  while (true) {
+    ReadNode(node, copy);
+    if (copy->high_key != nullptr) {
+      int cmp = Compare(copy->high_prefix, copy->high_key, prefix, key);
+      if (cmp < 0 || (!strict && cmp == 0)) {
+        // Split since the parent was read
+        node = copy->next;
+        continue;
+      }
+    }
+    if (copy->level == 0) {
+      return;
+    }
+    // Skip keys[0], which may stand for a key below all others
+    node = copy->children[UpperBound(*copy, 1, prefix, key, !strict) - 1];
+  }
+}
+
+Node* BPlusTreeRep::NewNode(int level) {
+  size_t size = level == 0 ? sizeof(Node) : sizeof(InternalNode);
+  char* mem = allocator_->AllocateAligned(size + CACHE_LINE_SIZE - 1);
+  mem = reinterpret_cast<char*>(
+      (reinterpret_cast<uintptr_t>(mem) + CACHE_LINE_SIZE - 1) &
+      ~static_cast<uintptr_t>(CACHE_LINE_SIZE - 1));
+  if (level == 0) {
+    return new (mem) Node(0);
+  }
+  return new (mem) InternalNode(static_cast<uint16_t>(level));
+}
+
+bool BPlusTreeRep::InsertLocked(const char* key) {
+  uint64_t prefix = KeyPrefix(key);
+  // The internal nodes on the way down and the index taken in each
+  InternalNode* path[kMaxHeight];
+  int path_index[kMaxHeight];
+  NodeCopy copy;
+
+  Node* node = root_.load(std::memory_order_relaxed);
+  ReadNode(node, &copy);
+  while (copy.level > 0) {
+    int index = UpperBound(copy, 1, prefix, key, true) - 1;
+    path[copy.level] = static_cast<InternalNode*>(node);
+    path_index[copy.level] = index;
+    node = copy.children[index];
+    ReadNode(node, &copy);
+  }
+  int pos = UpperBound(copy, 0, prefix, key, false);
+  if (pos < copy.count &&
+      Compare(copy.prefixes[pos], copy.keys[pos], prefix, key) == 0) {
+    return false;
+  }
+
+  Node* child = nullptr;
+  while (true) {
+    if (copy.count < kFanout) {
+      uint32_t version = BeginWrite(node);
+      for (int i = copy.count; i > pos; i--) {
+        SetEntry(node, i, copy.prefixes[i - 1], copy.keys[i - 1],
+                 copy.children[i - 1]);
+      }
+      SetEntry(node, pos, prefix, key, child);
+      node->count.store(static_cast<uint16_t>(copy.count + 1),
+                        std::memory_order_relaxed);
+      EndWrite(node, version);
+      return true;
+    }
+
+    // The node is full: add the new entry to the copy, and move the upper
+    // half to a new right sibling, which nobody can reach yet.
+    for (int i = copy.count; i > pos; i--) {
+      copy.prefixes[i] = copy.prefixes[i - 1];
+      copy.keys[i] = copy.keys[i - 1];
+      copy.children[i] = copy.children[i - 1];
+    }
+    copy.prefixes[pos] = prefix;
+    copy.keys[pos] = key;
+    copy.children[pos] = child;
+    const int total = kFanout + 1;
+    const int split = total / 2;
+
+    Node* right = NewNode(copy.level);
+    for (int i = split; i < total; i++) {
+      SetEntry(right, i - split, copy.prefixes[i], copy.keys[i],
+               copy.children[i]);
+    }
+    right->count.store(static_cast<uint16_t>(total - split),
+                       std::memory_order_relaxed);
+    right->next.store(copy.next, std::memory_order_relaxed);
+    right->high_prefix.store(copy.high_prefix, std::memory_order_relaxed);
+    right->high_key.store(copy.high_key, std::memory_order_relaxed);
+
+    // Publish it
+    uint32_t version = BeginWrite(node);
+    for (int i = pos; i < split; i++) {
+      SetEntry(node, i, copy.prefixes[i], copy.keys[i], copy.children[i]);
+    }
+    node->count.store(static_cast<uint16_t>(split), std::memory_order_relaxed);
+    node->high_prefix.store(copy.prefixes[split], std::memory_order_relaxed);
+    node->high_key.store(copy.keys[split], std::memory_order_relaxed);
+    node->next.store(right, std::memory_order_relaxed);
+    EndWrite(node, version);
+
+    // Then tell the parent, whose entry for right is its first key
+    prefix = copy.prefixes[split];
+    key = copy.keys[split];
+    child = right;
+    if (node == root_.load(std::memory_order_relaxed)) {
+      assert(copy.level + 1 < kMaxHeight);
+      InternalNode* root =
+          static_cast<InternalNode*>(NewNode(copy.level + 1));
+      SetEntry(root, 0, 0, nullptr, node);
+      SetEntry(root, 1, prefix, key, right);
+      root->count.store(2, std::memory_order_relaxed);
+      root_.store(root, std::memory_order_release);
+      return true;
+    }
+    int level = copy.level + 1;
+    node = path[level];
+    pos = path_index[level] + 1;
+    ReadNode(node, &copy);
+  }
+}
+
+bool BPlusTreeRep::Contains(const char* key) const {
+  uint64_t prefix = KeyPrefix(key);
+  NodeCopy copy;
+  FindLeaf(prefix, key, false, &copy);
+  int pos = UpperBound(copy, 0, prefix, key, false);
+  return pos < copy.count &&
+         Compare(copy.prefixes[pos], copy.keys[pos], prefix, key) == 0;
+}
+
+void BPlusTreeRep::Get(const LookupKey& k, void* callback_args,
+                       bool (*callback_func)(void* arg, const char* entry)) {
+  BPlusTreeRep::Iterator iter(this);
+  Slice dummy_slice;
+  for (iter.Seek(dummy_slice, k.memtable_key().data());
+       iter.Valid() && callback_func(callback_args, iter.key()); iter.Next()) {
+  }
+}
+
+void BPlusTreeRep::Iterator::Next() {
+  assert(Valid());
+  index_++;
+  if (index_ == leaf_.count && leaf_.next != nullptr) {
+    // The copy is consistent, so its right link leads to the entries above
+    // it even if the leaf was split since
+    ReadNode(leaf_.next, &leaf_);
+    index_ = 0;
+  }
+}
+
+void BPlusTreeRep::Iterator::Prev() {
+  assert(Valid());
+  if (index_ > 0) {
+    index_--;
+    return;
+  }
+  // Every leaf but the leftmost one starts with the key that its parent
+  // knows it by, so the key is below this one unless there is none.
+  uint64_t prefix = leaf_.prefixes[0];
+  const char* target = leaf_.keys[0];
+  tree_->FindLeaf(prefix, target, true, &leaf_);
+  index_ = tree_->UpperBound(leaf_, 0, prefix, target, false) - 1;
+}
+
+void BPlusTreeRep::Iterator::Seek(const Slice& user_key,
+                                  const char* memtable_key) {
+  const char* target =
+      memtable_key != nullptr ? memtable_key : EncodeKey(&tmp_, user_key);
+  uint64_t prefix = tree_->KeyPrefix(target);
+  tree_->FindLeaf(prefix, target, false, &leaf_);
+  index_ = tree_->UpperBound(leaf_, 0, prefix, target, false);
+  if (index_ == leaf_.count && leaf_.next != nullptr) {
+    // All of the next leaf is at or above the high key, which is above the
+    // target
+    ReadNode(leaf_.next, &leaf_);
+    index_ = 0;
+  }
+}
+
+void BPlusTreeRep::Iterator::SeekForPrev(const Slice& user_key,
+                                         const char* memtable_key) {
+  const char* target =
+      memtable_key != nullptr ? memtable_key : EncodeKey(&tmp_, user_key);
+  uint64_t prefix = tree_->KeyPrefix(target);
+  tree_->FindLeaf(prefix, target, false, &leaf_);
+  index_ = tree_->UpperBound(leaf_, 0, prefix, target, true) - 1;
+}
+
+void BPlusTreeRep::Iterator::SeekToFirst() {
+  // The leftmost node of a level stays the leftmost one when it is split
+  const Node* node = tree_->root_.load(std::memory_order_acquire);
+  ReadNode(node, &leaf_);
+  while (leaf_.level > 0) {
+    ReadNode(leaf_.children[0], &leaf_);
+  }
+  index_ = 0;
+}
+
+void BPlusTreeRep::Iterator::SeekToLast() {
+  const Node* node = tree_->root_.load(std::memory_order_acquire);
+  while (true) {
+    ReadNode(node, &leaf_);
+    if (leaf_.next != nullptr) {
+      node = leaf_.next;
+    } else if (leaf_.level > 0) {
+      node = leaf_.children[leaf_.count - 1];
+    } else {
+      break;
+    }
+  }
+  index_ = leaf_.count - 1;
+}
+
+}  // anon namespace
+
+MemTableRep* BPlusTreeRepFactory::CreateMemTableRep(
+    const MemTableRep::KeyComparator& compare, Allocator* allocator,
+    const SliceTransform* /*transform*/, Logger* /*logger*/) {
+  return new BPlusTreeRep(compare, allocator);
+}
+
+}  // namespace rocksdb
+#endif  // ROCKSDB_LITE
@@ -0,0 +1,257 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#ifndef ROCKSDB_LITE
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "db/dbformat.h"
+#include "db/memtable.h"
+#include "memory/concurrent_arena.h"
+#include "rocksdb/comparator.h"
+#include "rocksdb/memtablerep.h"
+#include "test_util/testharness.h"
+#include "util/coding.h"
+#include "util/random.h"
+#include "util/string_util.h"
+
+namespace rocksdb {
+
+class BPlusTreeRepTest : public testing::TestWithParam<bool> {
+ public:
+  BPlusTreeRepTest()
+      : icmp_(GetParam() ? ReverseBytewiseComparator()
+                         : BytewiseComparator()),
+        key_cmp_(icmp_) {
+    rep_.reset(BPlusTreeRepFactory().CreateMemTableRep(key_cmp_, &arena_,
+                                                        nullptr, nullptr));
+  }
+
+  // The internal key of an entry
+  static std::string IKey(const std::string& user_key, SequenceNumber seq) {
+    std::string key;
+    AppendInternalKey(&key, ParsedInternalKey(user_key, seq, kTypeValue));
+    return key;
+  }
+
+  // Allocates an entry laid out like MemTable::Add() does, without a value
+  KeyHandle NewEntry(const std::string& user_key, SequenceNumber seq) {
+    std::string ikey = IKey(user_key, seq);
+    char* buf = nullptr;
+    KeyHandle handle =
+        rep_->Allocate(VarintLength(ikey.size()) + ikey.size(), &buf);
+    char* p = EncodeVarint32(buf, static_cast<uint32_t>(ikey.size()));
+    memcpy(p, ikey.data(), ikey.size());
+    return handle;
+  }
+
+  static std::string EntryKey(const char* entry) {
+    return GetLengthPrefixedSlice(entry).ToString();
+  }
+
+  bool Less(const std::string& a, const std::string& b) const {
+    return icmp_.Compare(a, b) < 0;
+  }
+
+  // Random user keys, many of them sharing their first 8 bytes or more
+  std::string RandomUserKey(Random* rnd) {
+    std::string key = "prefix" + ToString(rnd->Uniform(4));
+    int len = static_cast<int>(rnd->Uniform(10));
+    for (int i = 0; i < len; i++) {
+      key.push_back(static_cast<char>('a' + rnd->Uniform(3)));
+    }
+    return key;
+  }
+
+  InternalKeyComparator icmp_;
+  MemTable::KeyComparator key_cmp_;
+  ConcurrentArena arena_;
+  std::unique_ptr<MemTableRep> rep_;
+};
+
+TEST_P(BPlusTreeRepTest, Empty) {
+  std::unique_ptr<MemTableRep::Iterator> iter(rep_->GetIterator());
+  ASSERT_FALSE(iter->Valid());
+  iter->SeekToFirst();
+  ASSERT_FALSE(iter->Valid());
+  iter->SeekToLast();
+  ASSERT_FALSE(iter->Valid());
+  std::string target = IKey("foo", 100);
+  iter->Seek(target, nullptr);
+  ASSERT_FALSE(iter->Valid());
+  iter->SeekForPrev(target, nullptr);
+  ASSERT_FALSE(iter->Valid());
+}
+
+TEST_P(BPlusTreeRepTest, InsertAndLookup) {
+  const int kNumEntries = 5000;
+  Random rnd(301);
+  std::set<std::string> inserted_keys;
+  for (int i = 0; i < kNumEntries; i++) {
+    std::string user_key = RandomUserKey(&rnd);
+    SequenceNumber seq = rnd.Uniform(1000);
+    bool inserted = rep_->InsertKey(NewEntry(user_key, seq));
+    ASSERT_EQ(inserted_keys.insert(IKey(user_key, seq)).second, inserted);
+  }
+  std::vector<std::string> expected(inserted_keys.begin(),
+                                    inserted_keys.end());
+  std::sort(expected.begin(), expected.end(),
+            [this](const std::string& a, const std::string& b) {
+              return Less(a, b);
+            });
+
+  std::unique_ptr<MemTableRep::Iterator> iter(rep_->GetIterator());
+  size_t i = 0;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next(), i++) {
+    ASSERT_LT(i, expected.size());
+    ASSERT_EQ(expected[i], EntryKey(iter->key()));
+  }
+  ASSERT_EQ(expected.size(), i);
+
+  for (iter->SeekToLast(); iter->Valid(); iter->Prev()) {
+    ASSERT_GT(i, 0);
+    ASSERT_EQ(expected[--i], EntryKey(iter->key()));
+  }
+  ASSERT_EQ(0, i);
+
+  for (int j = 0; j < 1000; j++) {
+    std::string target = IKey(RandomUserKey(&rnd), rnd.Uniform(1000));
+    auto lower = std::lower_bound(
+        expected.begin(), expected.end(), target,
+        [this](const std::string& a, const std::string& b) {
+          return Less(a, b);
+        });
+    iter->Seek(target, nullptr);
+    if (lower == expected.end()) {
+      ASSERT_FALSE(iter->Valid());
+    } else {
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(*lower, EntryKey(iter->key()));
+    }
+
+    bool found = lower != expected.end() && *lower == target;
+    std::string encoded;
+    ASSERT_EQ(found, rep_->Contains(EncodeKey(&encoded, target)));
+
+    iter->SeekForPrev(target, nullptr);
+    auto last = found ? lower : lower - 1;
+    if (lower == expected.begin() && !found) {
+      ASSERT_FALSE(iter->Valid());
+    } else {
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(*last, EntryKey(iter->key()));
+    }
+  }
+}
+
+TEST_P(BPlusTreeRepTest, Get) {
+  for (SequenceNumber seq = 1; seq <= 100; seq++) {
+    rep_->Insert(NewEntry("a", seq));
+    rep_->Insert(NewEntry("b", seq));
+    rep_->Insert(NewEntry("c", seq));
+  }
+  // The entries of a user key at or below the sequence number, newest first
+  struct Collector {
+    std::vector<std::string> keys;
+    static bool Callback(void* arg, const char* entry) {
+      auto* self = reinterpret_cast<Collector*>(arg);
+      Slice key = GetLengthPrefixedSlice(entry);
+      if (ExtractUserKey(key) != "b") {
+        return false;
+      }
+      self->keys.push_back(key.ToString());
+      return true;
+    }
+  } collector;
+  LookupKey lkey("b", 60);
+  rep_->Get(lkey, &collector, &Collector::Callback);
+  ASSERT_EQ(60, collector.keys.size());
+  ASSERT_EQ(IKey("b", 60), collector.keys.front());
+  ASSERT_EQ(IKey("b", 1), collector.keys.back());
+}
+
+TEST_P(BPlusTreeRepTest, ConcurrentInsertAndRead) {
+  const int kNumWriters = 2;
+  const int kEntriesPerWriter = 20000;
+  std::atomic<bool> done(false);
+  std::atomic<int> num_checks(0);
+
+  // Readers check that the tree stays sorted and that they can find what was
+  // inserted before they started looking
+  auto reader = [&]() {
+    std::unique_ptr<MemTableRep::Iterator> iter(rep_->GetIterator());
+    while (!done.load()) {
+      std::string prev;
+      size_t count = 0;
+      for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+        std::string key = EntryKey(iter->key());
+        if (count++ > 0) {
+          ASSERT_TRUE(Less(prev, key));
+        }
+        prev = key;
+      }
+      if (count > 0) {
+        iter->Seek(prev, nullptr);
+        ASSERT_TRUE(iter->Valid());
+        ASSERT_EQ(prev, EntryKey(iter->key()));
+        std::string encoded;
+        ASSERT_TRUE(rep_->Contains(EncodeKey(&encoded, prev)));
+      }
+      num_checks++;
+    }
+  };
+
+  auto writer = [&](int id) {
+    Random rnd(id + 1);
+    for (int i = 0; i < kEntriesPerWriter; i++) {
+      std::string user_key = ToString(id) + "_" + ToString(rnd.Next());
+      rep_->InsertConcurrently(NewEntry(user_key, i));
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.emplace_back(reader);
+  for (int id = 0; id < kNumWriters; id++) {
+    threads.emplace_back(writer, id);
+  }
+  for (size_t i = 1; i < threads.size(); i++) {
+    threads[i].join();
+  }
+  done = true;
+  threads[0].join();
+  ASSERT_GT(num_checks.load(), 0);
+
+  std::unique_ptr<MemTableRep::Iterator> iter(rep_->GetIterator());
+  int count = 0;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+    count++;
+  }
+  ASSERT_EQ(kNumWriters * kEntriesPerWriter, count);
+}
+
+INSTANTIATE_TEST_CASE_P(BPlusTreeRepTest, BPlusTreeRepTest, testing::Bool());
+
+}  // namespace rocksdb
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+#else
+#include <stdio.h>
+
+int main(int /*argc*/, char** /*argv*/) {
+  fprintf(stderr, "SKIPPED as BPlusTreeRep is not supported in ROCKSDB_LITE\n");
+  return 0;
+}
+
+#endif  // !ROCKSDB_LITE
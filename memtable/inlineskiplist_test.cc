@@ -10,6 +10,7 @@
 #include "memtable/inlineskiplist.h"
 #include <set>
 #include <unordered_set>
+#include <vector>
 #include "memory/concurrent_arena.h"
 #include "rocksdb/env.h"
 #include "test_util/testharness.h"
@@ -78,6 +79,17 @@ class InlineSkipTest : public testing::Test {
     return res;
   }
 
+  bool InsertBatch(TestInlineSkipList* list, const std::vector<Key>& keys) {
+    std::vector<char*> bufs;
+    for (Key key : keys) {
+      char* buf = list->AllocateKey(sizeof(Key));
+      memcpy(buf, &key, sizeof(Key));
+      bufs.push_back(buf);
+      keys_.insert(key);
+    }
+    return list->InsertBatch(bufs.data(), bufs.size());
+  }
+
   void Validate(TestInlineSkipList* list) {
     // Check keys exist.
     for (Key key : keys_) {
@@ -309,6 +321,42 @@ TEST_F(InlineSkipTest, InsertWithHint_CompatibleWithInsertWithoutHint) {
   Validate(&list);
 }
 
+TEST_F(InlineSkipTest, InsertBatch) {
+  const int N = 1000;
+  const size_t kBatchSize = 100;
+  Random rnd(301);
+  Arena arena;
+  TestComparator cmp;
+  TestInlineSkipList list(cmp, &arena);
+  std::unordered_set<Key> used;
+  for (int i = 0; i < N; i++) {
+    std::vector<Key> batch;
+    while (batch.size() < kBatchSize) {
+      Key key = rnd.Next();
+      if (used.insert(key).second) {
+        batch.push_back(key);
+      }
+    }
+    // Batches mix with single inserts
+    if (i % 2 == 0) {
+      ASSERT_TRUE(InsertBatch(&list, batch));
+    } else {
+      for (Key key : batch) {
+        Insert(&list, key);
+      }
+    }
+  }
+  Validate(&list);
+
+  // A batch with a key that is already in the list inserts the others
+  Key existing = *used.begin();
+  Key fresh = 0;
+  ASSERT_FALSE(used.count(fresh));
+  ASSERT_FALSE(InsertBatch(&list, {fresh, existing}));
+  ASSERT_TRUE(list.Contains(Encode(&fresh)));
+  Validate(&list);
+}
+
 #ifndef ROCKSDB_VALGRIND_RUN
 // We want to make sure that with a single writer and multiple
 // concurrent readers (with no synchronization other than when a
@@ -61,6 +61,7 @@ DEFINE_string(memtablerep, "skiplist",
               "\tvector              -- backed by an std::vector\n"
               "\thashskiplist        -- backed by a hash skip list\n"
               "\thashlinklist        -- backed by a hash linked list\n"
+              "\tbplustree           -- backed by a B+-tree\n"
               "\tcuckoo              -- backed by a cuckoo hash table");
 
 DEFINE_int64(bucket_count, 1000000,
@@ -109,6 +110,11 @@ DEFINE_int32(num_scans, 10,
 
 DEFINE_int32(item_size, 100, "Number of bytes each item should be");
 
+DEFINE_int32(batch_size, 1,
+             "Number of keys the fill benchmarks insert together with "
+             "MemTableRep::InsertKeyBatch(), as for a large write batch. 1 "
+             "inserts them one at a time");
+
 DEFINE_int32(prefix_length, 8,
              "Prefix length to pass into NewFixedPrefixTransform");
 
@@ -233,7 +239,8 @@ class FillBenchmarkThread : public BenchmarkThread {
       : BenchmarkThread(table, key_gen, bytes_written, bytes_read, sequence,
                         num_ops, read_hits) {}
 
-  void FillOne() {
+  // Inserts a new entry, or appends its handle to *batch if not nullptr
+  void FillOne(std::vector<KeyHandle>* batch = nullptr) {
     char* buf = nullptr;
     auto internal_key_size = 16;
     auto encoded_len =
@@ -250,13 +257,30 @@ class FillBenchmarkThread : public BenchmarkThread {
     memcpy(p, bytes.data(), FLAGS_item_size);
     p += FLAGS_item_size;
     assert(p == buf + encoded_len);
-    table_->Insert(handle);
+    if (batch != nullptr) {
+      batch->push_back(handle);
+    } else {
+      table_->Insert(handle);
+    }
     *bytes_written_ += encoded_len;
   }
 
   void operator()() override {
+    if (FLAGS_batch_size <= 1) {
+      for (unsigned int i = 0; i < num_ops_; ++i) {
+        FillOne();
+      }
+      return;
+    }
+    std::vector<KeyHandle> batch;
+    batch.reserve(FLAGS_batch_size);
     for (unsigned int i = 0; i < num_ops_; ++i) {
-      FillOne();
+      FillOne(&batch);
+      if (batch.size() == static_cast<size_t>(FLAGS_batch_size) ||
+          i + 1 == num_ops_) {
+        table_->InsertKeyBatch(batch.data(), batch.size());
+        batch.clear();
+      }
     }
   }
 };
@@ -581,6 +605,8 @@ int main(int argc, char** argv) {
 #ifndef ROCKSDB_LITE
   } else if (FLAGS_memtablerep == "vector") {
     factory.reset(new rocksdb::VectorRepFactory);
+  } else if (FLAGS_memtablerep == "bplustree") {
+    factory.reset(new rocksdb::BPlusTreeRepFactory);
   } else if (FLAGS_memtablerep == "hashskiplist") {
     factory.reset(rocksdb::NewHashSkipListRepFactory(
         FLAGS_bucket_count, FLAGS_hashskiplist_height,
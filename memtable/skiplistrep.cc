@@ -67,6 +67,10 @@ public:
    return skip_list_.InsertConcurrently(static_cast<char*>(handle));
  }
 
+ bool InsertKeyBatch(KeyHandle* handles, size_t num) override {
+   return skip_list_.InsertBatch(reinterpret_cast<char**>(handles), num);
+ }
+
   // Returns true iff an entry that compares equal to key is in the list.
  bool Contains(const char* key) const override {
    return skip_list_.Contains(key);
@@ -8,7 +8,9 @@
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 
 #include "rocksdb/write_buffer_manager.h"
+#include <condition_variable>
 #include <mutex>
+#include "port/port.h"
 #include "util/coding.h"
 
 namespace rocksdb {
@@ -48,8 +50,23 @@ struct WriteBufferManager::CacheRep {
 struct WriteBufferManager::CacheRep {};
 #endif  // ROCKSDB_LITE
 
+struct WriteBufferManager::Arbiter {
+  // Protects the fields below, never held while calling a client
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::vector<Client*> clients_;
+  bool flush_requested_ = false;
+  // Whether the thread is calling clients outside of mutex_
+  bool busy_ = false;
+  bool stop_ = false;
+  // Lets writers skip mutex_ while a flush request is pending
+  std::atomic<bool> pending_{false};
+  port::Thread thread_;
+};
+
 WriteBufferManager::WriteBufferManager(size_t _buffer_size,
-                                       std::shared_ptr<Cache> cache)
+                                       std::shared_ptr<Cache> cache,
+                                       bool arbitrate)
     : buffer_size_(_buffer_size),
       mutable_limit_(buffer_size_ * 7 / 8),
       memory_used_(0),
@@ -63,9 +80,21 @@ WriteBufferManager::WriteBufferManager(size_t _buffer_size,
 #else
   (void)cache;
 #endif  // ROCKSDB_LITE
+  if (arbitrate && enabled()) {
+    arbiter_.reset(new Arbiter());
+    arbiter_->thread_ = port::Thread([this] { ArbiterLoop(); });
+  }
 }
 
 WriteBufferManager::~WriteBufferManager() {
+  if (arbiter_) {
+    {
+      std::lock_guard<std::mutex> lock(arbiter_->mutex_);
+      arbiter_->stop_ = true;
+    }
+    arbiter_->cv_.notify_all();
+    arbiter_->thread_.join();
+  }
 #ifndef ROCKSDB_LITE
   if (cache_rep_) {
     for (auto* handle : cache_rep_->dummy_handles_) {
@@ -127,4 +156,110 @@ void WriteBufferManager::FreeMemWithCache(size_t mem) {
   (void)mem;
 #endif  // ROCKSDB_LITE
 }
+
+void WriteBufferManager::RegisterClient(Client* client) {
+  if (arbiter_ == nullptr) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(arbiter_->mutex_);
+  arbiter_->clients_.push_back(client);
+}
+
+void WriteBufferManager::UnregisterClient(Client* client) {
+  if (arbiter_ == nullptr) {
+    return;
+  }
+  std::unique_lock<std::mutex> lock(arbiter_->mutex_);
+  auto& clients = arbiter_->clients_;
+  clients.erase(std::remove(clients.begin(), clients.end(), client),
+                clients.end());
+  // The thread may still be working on its own copy of the clients
+  while (arbiter_->busy_) {
+    arbiter_->cv_.wait(lock);
+  }
+}
+
+void WriteBufferManager::MaybeScheduleFlush() {
+  if (arbiter_ == nullptr ||
+      arbiter_->pending_.load(std::memory_order_relaxed)) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(arbiter_->mutex_);
+    arbiter_->flush_requested_ = true;
+    arbiter_->pending_.store(true, std::memory_order_relaxed);
+  }
+  arbiter_->cv_.notify_all();
+}
+
+double WriteBufferManager::FlushScore(const FlushCandidate& candidate) {
+  // Old memtables hold back the WAL files and are flushed sooner; column
+  // families with a backlog of immutable memtables or L0 files are close to
+  // stalling their writes, and are left alone when there is a choice.
+  double score = static_cast<double>(candidate.memory_usage) *
+                 (1.0 + static_cast<double>(candidate.age_seconds) / 600.0);
+  double backlog = candidate.num_immutable_memtables;
+  if (candidate.level0_slowdown_writes_trigger > 0) {
+    backlog += static_cast<double>(candidate.num_level0_files) /
+               candidate.level0_slowdown_writes_trigger;
+  }
+  return score / (1.0 + backlog);
+}
+
+void WriteBufferManager::ArbiterLoop() {
+  std::unique_lock<std::mutex> lock(arbiter_->mutex_);
+  while (true) {
+    while (!arbiter_->stop_ && !arbiter_->flush_requested_) {
+      arbiter_->cv_.wait(lock);
+    }
+    if (arbiter_->stop_) {
+      break;
+    }
+    arbiter_->flush_requested_ = false;
+    std::vector<Client*> clients = arbiter_->clients_;
+    arbiter_->busy_ = true;
+    lock.unlock();
+
+    // Writers asking for a flush from now on must wake the thread again
+    arbiter_->pending_.store(false, std::memory_order_relaxed);
+    // Stop as well if a flush did not free any mutable memory, rather than
+    // spin on the same candidate
+    size_t mutable_usage = mutable_memtable_memory_usage();
+    while (ShouldFlush() && FlushBestCandidate(clients)) {
+      size_t new_mutable_usage = mutable_memtable_memory_usage();
+      if (new_mutable_usage >= mutable_usage) {
+        break;
+      }
+      mutable_usage = new_mutable_usage;
+    }
+
+    lock.lock();
+    arbiter_->busy_ = false;
+    arbiter_->cv_.notify_all();
+  }
+}
+
+bool WriteBufferManager::FlushBestCandidate(
+    const std::vector<Client*>& clients) {
+  Client* best_client = nullptr;
+  FlushCandidate best;
+  double best_score = 0;
+  std::vector<FlushCandidate> candidates;
+  for (Client* client : clients) {
+    candidates.clear();
+    client->GetFlushCandidates(&candidates);
+    for (const auto& candidate : candidates) {
+      double score = FlushScore(candidate);
+      if (best_client == nullptr || score > best_score) {
+        best_client = client;
+        best = candidate;
+        best_score = score;
+      }
+    }
+  }
+  if (best_client == nullptr) {
+    return false;
+  }
+  return best_client->FlushColumnFamily(best.column_family_id).ok();
+}
 }  // namespace rocksdb
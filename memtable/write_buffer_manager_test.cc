@@ -8,6 +8,10 @@
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 
 #include "rocksdb/write_buffer_manager.h"
+#include <map>
+#include <mutex>
+#include <vector>
+#include "rocksdb/env.h"
 #include "test_util/testharness.h"
 
 namespace rocksdb {
@@ -142,6 +146,136 @@ TEST_F(WriteBufferManagerTest, NoCapCacheCost) {
   ASSERT_GE(cache->GetPinnedUsage(), 1024 * 1024);
   ASSERT_LT(cache->GetPinnedUsage(), 1024 * 1024 + 10000);
 }
+
+namespace {
+// A DB with column families of the given sizes, which frees the memory of a
+// column family as soon as it is flushed
+class FakeClient : public WriteBufferManager::Client {
+ public:
+  explicit FakeClient(WriteBufferManager* wbm) : wbm_(wbm) {}
+
+  void AddColumnFamily(const WriteBufferManager::FlushCandidate& candidate) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    wbm_->ReserveMem(candidate.memory_usage);
+    cfs_[candidate.column_family_id] = candidate;
+  }
+
+  void GetFlushCandidates(
+      std::vector<WriteBufferManager::FlushCandidate>* candidates) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& cf : cfs_) {
+      candidates->push_back(cf.second);
+    }
+  }
+
+  Status FlushColumnFamily(uint32_t column_family_id) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = cfs_.find(column_family_id);
+    if (it == cfs_.end()) {
+      return Status::InvalidArgument();
+    }
+    wbm_->ScheduleFreeMem(it->second.memory_usage);
+    wbm_->FreeMem(it->second.memory_usage);
+    cfs_.erase(it);
+    flushed_.push_back(column_family_id);
+    return Status::OK();
+  }
+
+  std::vector<uint32_t> flushed() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return flushed_;
+  }
+
+ private:
+  WriteBufferManager* wbm_;
+  std::mutex mutex_;
+  std::map<uint32_t, WriteBufferManager::FlushCandidate> cfs_;
+  std::vector<uint32_t> flushed_;
+};
+
+WriteBufferManager::FlushCandidate Candidate(uint32_t id, size_t mb,
+                                             uint64_t age_seconds = 0,
+                                             int num_level0_files = 0) {
+  WriteBufferManager::FlushCandidate candidate;
+  candidate.column_family_id = id;
+  candidate.memory_usage = mb * 1024 * 1024;
+  candidate.age_seconds = age_seconds;
+  candidate.num_level0_files = num_level0_files;
+  candidate.level0_slowdown_writes_trigger = 20;
+  return candidate;
+}
+
+// Waits until the client has flushed `count` column families
+bool WaitForFlushes(FakeClient* client, size_t count) {
+  for (int i = 0; i < 10000 && client->flushed().size() < count; i++) {
+    Env::Default()->SleepForMicroseconds(1000);
+  }
+  return client->flushed().size() == count;
+}
+}  // namespace
+
+TEST_F(WriteBufferManagerTest, ArbitrateFlushes) {
+  // A write buffer manager of size 10MB shared by two DBs
+  WriteBufferManager wbf(10 * 1024 * 1024, {}, true /* arbitrate */);
+  ASSERT_TRUE(wbf.arbitrates());
+  FakeClient db1(&wbf);
+  FakeClient db2(&wbf);
+  wbf.RegisterClient(&db1);
+  wbf.RegisterClient(&db2);
+
+  db1.AddColumnFamily(Candidate(1, 4));
+  // Its flush would stall writes
+  db1.AddColumnFamily(Candidate(2, 3, 0, 20));
+  ASSERT_FALSE(wbf.ShouldFlush());
+  // Smaller but older
+  db2.AddColumnFamily(Candidate(1, 2, 1200));
+  ASSERT_TRUE(wbf.ShouldFlush());
+  wbf.MaybeScheduleFlush();
+  ASSERT_TRUE(WaitForFlushes(&db2, 1));
+  ASSERT_FALSE(wbf.ShouldFlush());
+  ASSERT_TRUE(db1.flushed().empty());
+
+  // The largest column family is flushed first when they are as old
+  db1.AddColumnFamily(Candidate(3, 2));
+  ASSERT_TRUE(wbf.ShouldFlush());
+  wbf.MaybeScheduleFlush();
+  ASSERT_TRUE(WaitForFlushes(&db1, 1));
+  ASSERT_EQ(std::vector<uint32_t>({1}), db1.flushed());
+  ASSERT_FALSE(wbf.ShouldFlush());
+
+  // Unregistered clients are left alone
+  wbf.UnregisterClient(&db1);
+  db2.AddColumnFamily(Candidate(2, 1));
+  db1.AddColumnFamily(Candidate(4, 5));
+  ASSERT_TRUE(wbf.ShouldFlush());
+  wbf.MaybeScheduleFlush();
+  ASSERT_TRUE(WaitForFlushes(&db2, 2));
+  ASSERT_EQ(1, db1.flushed().size());
+  wbf.UnregisterClient(&db2);
+}
+
+TEST_F(WriteBufferManagerTest, DelayedWriteRateRatio) {
+  WriteBufferManager wbf(8 * 1024 * 1024, {}, true /* arbitrate */);
+  wbf.ReserveMem(8 * 1024 * 1024);
+  ASSERT_EQ(0, wbf.DelayedWriteRateRatio());
+  // The rate halves for every 1MB over the limit
+  wbf.ReserveMem(1);
+  ASSERT_EQ(1.0, wbf.DelayedWriteRateRatio());
+  wbf.ReserveMem(1024 * 1024);
+  ASSERT_EQ(0.5, wbf.DelayedWriteRateRatio());
+  wbf.ReserveMem(2 * 1024 * 1024);
+  ASSERT_EQ(0.25, wbf.DelayedWriteRateRatio());
+  wbf.ReserveMem(10 * 1024 * 1024);
+  ASSERT_EQ(1.0 / 16, wbf.DelayedWriteRateRatio());
+  wbf.FreeMem(21 * 1024 * 1024);
+  ASSERT_EQ(0, wbf.DelayedWriteRateRatio());
+
+  // Only arbitrating managers delay writes
+  WriteBufferManager wbf2(8 * 1024 * 1024);
+  ASSERT_FALSE(wbf2.arbitrates());
+  wbf2.ReserveMem(16 * 1024 * 1024);
+  ASSERT_EQ(0, wbf2.DelayedWriteRateRatio());
+}
 #endif  // ROCKSDB_LITE
 }  // namespace rocksdb
 
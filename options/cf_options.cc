@@ -67,6 +67,12 @@ ImmutableCFOptions::ImmutableCFOptions(const ImmutableDBOptions& db_options,
       num_levels(cf_options.num_levels),
       optimize_filters_for_hits(cf_options.optimize_filters_for_hits),
       force_consistency_checks(cf_options.force_consistency_checks),
+      enable_blob_files(cf_options.enable_blob_files),
+      min_blob_size(cf_options.min_blob_size),
+      blob_file_size(cf_options.blob_file_size),
+      enable_blob_garbage_collection(cf_options.enable_blob_garbage_collection),
+      blob_garbage_collection_age_cutoff(
+          cf_options.blob_garbage_collection_age_cutoff),
       allow_ingest_behind(db_options.allow_ingest_behind),
       preserve_deletes(db_options.preserve_deletes),
       listeners(db_options.listeners),
@@ -110,7 +116,8 @@ void MutableCFOptions::RefreshDerivedOptions(int num_levels,
                                              CompactionStyle compaction_style) {
   max_file_size.resize(num_levels);
   for (int i = 0; i < num_levels; ++i) {
-    if (i == 0 && compaction_style == kCompactionStyleUniversal) {
+    if (i == 0 && (compaction_style == kCompactionStyleUniversal ||
+                   compaction_style == kCompactionStyleHybrid)) {
       max_file_size[i] = ULLONG_MAX;
     } else if (i > 1) {
       max_file_size[i] = MultiplyCheckOverflow(max_file_size[i - 1],
@@ -222,6 +229,10 @@ void MutableCFOptions::Dump(Logger* log) const {
                  compaction_options_fifo.max_table_files_size);
   ROCKS_LOG_INFO(log, "compaction_options_fifo.allow_compaction : %d",
                  compaction_options_fifo.allow_compaction);
+
+  // Hybrid Compaction Options
+  ROCKS_LOG_INFO(log, "hybrid_target_write_amplification : %f",
+                 hybrid_target_write_amplification);
 }
 
 MutableCFOptions::MutableCFOptions(const Options& options)
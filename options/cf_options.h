@@ -107,6 +107,16 @@ struct ImmutableCFOptions {
 
   bool force_consistency_checks;
 
+  bool enable_blob_files;
+
+  uint64_t min_blob_size;
+
+  uint64_t blob_file_size;
+
+  bool enable_blob_garbage_collection;
+
+  double blob_garbage_collection_age_cutoff;
+
   bool allow_ingest_behind;
 
   bool preserve_deletes;
@@ -159,6 +169,8 @@ struct MutableCFOptions {
             options.max_bytes_for_level_multiplier_additional),
         compaction_options_fifo(options.compaction_options_fifo),
         compaction_options_universal(options.compaction_options_universal),
+        hybrid_target_write_amplification(
+            options.hybrid_target_write_amplification),
         max_sequential_skip_in_iterations(
             options.max_sequential_skip_in_iterations),
         paranoid_file_checks(options.paranoid_file_checks),
@@ -193,6 +205,7 @@ struct MutableCFOptions {
         ttl(0),
         periodic_compaction_seconds(0),
         compaction_options_fifo(),
+        hybrid_target_write_amplification(0),
         max_sequential_skip_in_iterations(0),
         paranoid_file_checks(false),
         report_bg_io_stats(false),
@@ -247,6 +260,7 @@ struct MutableCFOptions {
   std::vector<int> max_bytes_for_level_multiplier_additional;
   CompactionOptionsFIFO compaction_options_fifo;
   CompactionOptionsUniversal compaction_options_universal;
+  double hybrid_target_write_amplification;
 
   // Misc options
   uint64_t max_sequential_skip_in_iterations;
@@ -36,6 +36,7 @@ ImmutableDBOptions::ImmutableDBOptions(const DBOptions& options)
       wal_dir(options.wal_dir),
       max_subcompactions(options.max_subcompactions),
       max_background_flushes(options.max_background_flushes),
+      max_background_readaheads(options.max_background_readaheads),
       max_log_file_size(options.max_log_file_size),
       log_file_time_to_roll(options.log_file_time_to_roll),
       keep_log_file_num(options.keep_log_file_num),
@@ -46,6 +47,7 @@ ImmutableDBOptions::ImmutableDBOptions(const DBOptions& options)
       wal_size_limit_mb(options.WAL_size_limit_MB),
       max_write_batch_group_size_bytes(
           options.max_write_batch_group_size_bytes),
+      adaptive_write_batch_group_size(options.adaptive_write_batch_group_size),
       manifest_preallocation_size(options.manifest_preallocation_size),
       allow_mmap_reads(options.allow_mmap_reads),
       allow_mmap_writes(options.allow_mmap_writes),
@@ -149,6 +151,8 @@ void ImmutableDBOptions::Dump(Logger* log) const {
                    max_subcompactions);
   ROCKS_LOG_HEADER(log, "                 Options.max_background_flushes: %d",
                    max_background_flushes);
+  ROCKS_LOG_HEADER(log, "              Options.max_background_readaheads: %d",
+                   max_background_readaheads);
   ROCKS_LOG_HEADER(log,
                    "                        Options.WAL_ttl_seconds: %" PRIu64,
                    wal_ttl_seconds);
@@ -159,6 +163,10 @@ void ImmutableDBOptions::Dump(Logger* log) const {
                    "                       "
                    "Options.max_write_batch_group_size_bytes: %" PRIu64,
                    max_write_batch_group_size_bytes);
+  ROCKS_LOG_HEADER(log,
+                   "                        "
+                   "Options.adaptive_write_batch_group_size: %d",
+                   adaptive_write_batch_group_size);
   ROCKS_LOG_HEADER(
       log, "            Options.manifest_preallocation_size: %" ROCKSDB_PRIszt,
       manifest_preallocation_size);
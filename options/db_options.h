@@ -35,6 +35,7 @@ struct ImmutableDBOptions {
   std::string wal_dir;
   uint32_t max_subcompactions;
   int max_background_flushes;
+  int max_background_readaheads;
   size_t max_log_file_size;
   size_t log_file_time_to_roll;
   size_t keep_log_file_num;
@@ -44,6 +45,7 @@ struct ImmutableDBOptions {
   uint64_t wal_ttl_seconds;
   uint64_t wal_size_limit_mb;
   uint64_t max_write_batch_group_size_bytes;
+  bool adaptive_write_batch_group_size;
   size_t manifest_preallocation_size;
   bool allow_mmap_reads;
   bool allow_mmap_writes;
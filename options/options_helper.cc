@@ -63,6 +63,8 @@ DBOptions BuildDBOptions(const ImmutableDBOptions& immutable_db_options,
   options.strict_bytes_per_sync = mutable_db_options.strict_bytes_per_sync;
   options.max_subcompactions = immutable_db_options.max_subcompactions;
   options.max_background_flushes = immutable_db_options.max_background_flushes;
+  options.max_background_readaheads =
+      immutable_db_options.max_background_readaheads;
   options.max_log_file_size = immutable_db_options.max_log_file_size;
   options.log_file_time_to_roll = immutable_db_options.log_file_time_to_roll;
   options.keep_log_file_num = immutable_db_options.keep_log_file_num;
@@ -112,6 +114,8 @@ DBOptions BuildDBOptions(const ImmutableDBOptions& immutable_db_options,
       immutable_db_options.enable_write_thread_adaptive_yield;
   options.max_write_batch_group_size_bytes =
       immutable_db_options.max_write_batch_group_size_bytes;
+  options.adaptive_write_batch_group_size =
+      immutable_db_options.adaptive_write_batch_group_size;
   options.write_thread_max_yield_usec =
       immutable_db_options.write_thread_max_yield_usec;
   options.write_thread_slow_yield_usec =
@@ -198,6 +202,8 @@ ColumnFamilyOptions BuildColumnFamilyOptions(
   cf_opts.compaction_options_fifo = mutable_cf_options.compaction_options_fifo;
   cf_opts.compaction_options_universal =
       mutable_cf_options.compaction_options_universal;
+  cf_opts.hybrid_target_write_amplification =
+      mutable_cf_options.hybrid_target_write_amplification;
 
   // Misc options
   cf_opts.max_sequential_skip_in_iterations =
@@ -219,7 +225,8 @@ std::map<CompactionStyle, std::string>
         {kCompactionStyleLevel, "kCompactionStyleLevel"},
         {kCompactionStyleUniversal, "kCompactionStyleUniversal"},
         {kCompactionStyleFIFO, "kCompactionStyleFIFO"},
-        {kCompactionStyleNone, "kCompactionStyleNone"}};
+        {kCompactionStyleNone, "kCompactionStyleNone"},
+        {kCompactionStyleHybrid, "kCompactionStyleHybrid"}};
 
 std::map<CompactionPri, std::string> OptionsHelper::compaction_pri_to_string = {
     {kByCompensatedSize, "kByCompensatedSize"},
@@ -236,7 +243,8 @@ std::unordered_map<std::string, ChecksumType>
     OptionsHelper::checksum_type_string_map = {{"kNoChecksum", kNoChecksum},
                                                {"kCRC32c", kCRC32c},
                                                {"kxxHash", kxxHash},
-                                               {"kxxHash64", kxxHash64}};
+                                               {"kxxHash64", kxxHash64},
+                                               {"kXXH3", kXXH3}};
 
 std::unordered_map<std::string, CompressionType>
     OptionsHelper::compression_type_string_map = {
@@ -978,8 +986,33 @@ Status ParseCompressionOptions(const std::string& value, const std::string& name
       return Status::InvalidArgument(
           "unable to parse the specified CF option " + name);
     }
-    compression_opts.enabled =
-        ParseBoolean("", value.substr(start, value.size() - start));
+    end = value.find(':', start);
+    compression_opts.enabled = ParseBoolean(
+        "", value.substr(start, end == std::string::npos ? std::string::npos
+                                                          : end - start));
+  }
+  // parallel_threads is optional for backwards compatibility
+  if (end != std::string::npos) {
+    start = end + 1;
+    if (start >= value.size()) {
+      return Status::InvalidArgument(
+          "unable to parse the specified CF option " + name);
+    }
+    end = value.find(':', start);
+    compression_opts.parallel_threads =
+        ParseUint32(value.substr(start, end == std::string::npos
+                                            ? std::string::npos
+                                            : end - start));
+  }
+  // shared_dict_files is optional for backwards compatibility
+  if (end != std::string::npos) {
+    start = end + 1;
+    if (start >= value.size()) {
+      return Status::InvalidArgument(
+          "unable to parse the specified CF option " + name);
+    }
+    compression_opts.shared_dict_files =
+        ParseUint32(value.substr(start, value.size() - start));
   }
   return Status::OK();
 }
@@ -1504,6 +1537,9 @@ std::unordered_map<std::string, OptionTypeInfo>
         {"max_background_flushes",
          {offsetof(struct DBOptions, max_background_flushes), OptionType::kInt,
           OptionVerificationType::kNormal, false, 0}},
+        {"max_background_readaheads",
+         {offsetof(struct DBOptions, max_background_readaheads),
+          OptionType::kInt, OptionVerificationType::kNormal, false, 0}},
         {"max_file_opening_threads",
          {offsetof(struct DBOptions, max_file_opening_threads),
           OptionType::kInt, OptionVerificationType::kNormal, false, 0}},
@@ -1616,6 +1652,9 @@ std::unordered_map<std::string, OptionTypeInfo>
         {"max_write_batch_group_size_bytes",
          {offsetof(struct DBOptions, max_write_batch_group_size_bytes),
           OptionType::kUInt64T, OptionVerificationType::kNormal, false, 0}},
+        {"adaptive_write_batch_group_size",
+         {offsetof(struct DBOptions, adaptive_write_batch_group_size),
+          OptionType::kBoolean, OptionVerificationType::kNormal, false, 0}},
         {"write_thread_max_yield_usec",
          {offsetof(struct DBOptions, write_thread_max_yield_usec),
           OptionType::kUInt64T, OptionVerificationType::kNormal, false, 0}},
@@ -1684,7 +1723,9 @@ std::unordered_map<std::string, BlockBasedTableOptions::IndexType>
         {"kTwoLevelIndexSearch",
          BlockBasedTableOptions::IndexType::kTwoLevelIndexSearch},
         {"kBinarySearchWithFirstKey",
-         BlockBasedTableOptions::IndexType::kBinarySearchWithFirstKey}};
+         BlockBasedTableOptions::IndexType::kBinarySearchWithFirstKey},
+        {"kInterpolationSearch",
+         BlockBasedTableOptions::IndexType::kInterpolationSearch}};
 
 std::unordered_map<std::string, BlockBasedTableOptions::DataBlockIndexType>
     OptionsHelper::block_base_table_data_block_index_type_string_map = {
@@ -1712,7 +1753,8 @@ std::unordered_map<std::string, CompactionStyle>
         {"kCompactionStyleLevel", kCompactionStyleLevel},
         {"kCompactionStyleUniversal", kCompactionStyleUniversal},
         {"kCompactionStyleFIFO", kCompactionStyleFIFO},
-        {"kCompactionStyleNone", kCompactionStyleNone}};
+        {"kCompactionStyleNone", kCompactionStyleNone},
+        {"kCompactionStyleHybrid", kCompactionStyleHybrid}};
 
 std::unordered_map<std::string, CompactionPri>
     OptionsHelper::compaction_pri_string_map = {
@@ -1829,6 +1871,21 @@ std::unordered_map<std::string, OptionTypeInfo>
         {"force_consistency_checks",
          {offset_of(&ColumnFamilyOptions::force_consistency_checks),
           OptionType::kBoolean, OptionVerificationType::kNormal, false, 0}},
+        {"enable_blob_files",
+         {offset_of(&ColumnFamilyOptions::enable_blob_files),
+          OptionType::kBoolean, OptionVerificationType::kNormal, false, 0}},
+        {"min_blob_size",
+         {offset_of(&ColumnFamilyOptions::min_blob_size),
+          OptionType::kUInt64T, OptionVerificationType::kNormal, false, 0}},
+        {"blob_file_size",
+         {offset_of(&ColumnFamilyOptions::blob_file_size),
+          OptionType::kUInt64T, OptionVerificationType::kNormal, false, 0}},
+        {"enable_blob_garbage_collection",
+         {offset_of(&ColumnFamilyOptions::enable_blob_garbage_collection),
+          OptionType::kBoolean, OptionVerificationType::kNormal, false, 0}},
+        {"blob_garbage_collection_age_cutoff",
+         {offset_of(&ColumnFamilyOptions::blob_garbage_collection_age_cutoff),
+          OptionType::kDouble, OptionVerificationType::kNormal, false, 0}},
         {"purge_redundant_kvs_while_flush",
          {offset_of(&ColumnFamilyOptions::purge_redundant_kvs_while_flush),
           OptionType::kBoolean, OptionVerificationType::kDeprecated, false, 0}},
@@ -1950,6 +2007,11 @@ std::unordered_map<std::string, OptionTypeInfo>
          {offset_of(&ColumnFamilyOptions::max_bytes_for_level_multiplier),
           OptionType::kDouble, OptionVerificationType::kNormal, true,
           offsetof(struct MutableCFOptions, max_bytes_for_level_multiplier)}},
+        {"hybrid_target_write_amplification",
+         {offset_of(&ColumnFamilyOptions::hybrid_target_write_amplification),
+          OptionType::kDouble, OptionVerificationType::kNormal, true,
+          offsetof(struct MutableCFOptions,
+                   hybrid_target_write_amplification)}},
         {"max_bytes_for_level_multiplier_additional",
          {offset_of(
               &ColumnFamilyOptions::max_bytes_for_level_multiplier_additional),
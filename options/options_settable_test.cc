@@ -137,10 +137,12 @@ TEST_F(OptionsSettableTest, BlockBasedTableOptionsAllFieldsSettable) {
       "cache_index_and_filter_blocks_with_high_priority=true;"
       "pin_l0_filter_and_index_blocks_in_cache=1;"
       "pin_top_level_index_and_filter=1;"
+      "pin_filter_and_index_blocks_up_to_level=1;"
+      "load_partitions_in_background=1;"
       "index_type=kHashSearch;"
       "data_block_index_type=kDataBlockBinaryAndHash;"
       "index_shortening=kNoShortening;"
-      "data_block_hash_table_util_ratio=0.75;"
+      "data_block_hash_table_util_ratio=0.75;data_block_column_layout=1;"
       "checksum=kxxHash;hash_index_allow_collision=1;no_block_cache=1;"
       "block_cache=1M;block_cache_compressed=1k;block_size=1024;"
       "block_size_deviation=8;block_restart_interval=4; "
@@ -230,6 +232,7 @@ TEST_F(OptionsSettableTest, DBOptionsAllFieldsSettable) {
                              "WAL_ttl_seconds=4295008036;"
                              "WAL_size_limit_MB=4295036161;"
                              "max_write_batch_group_size_bytes=1048576;"
+                             "adaptive_write_batch_group_size=false;"
                              "wal_dir=path/to/wal_dir;"
                              "db_write_buffer_size=2587;"
                              "max_subcompactions=64330;"
@@ -259,6 +262,7 @@ TEST_F(OptionsSettableTest, DBOptionsAllFieldsSettable) {
                              "create_missing_column_families=true;"
                              "log_file_time_to_roll=3097;"
                              "max_background_flushes=35;"
+                             "max_background_readaheads=2;"
                              "create_if_missing=false;"
                              "error_if_exists=true;"
                              "delayed_write_rate=4294976214;"
@@ -429,6 +433,7 @@ TEST_F(OptionsSettableTest, ColumnFamilyOptionsAllFieldsSettable) {
       "write_buffer_size=1653;"
       "max_compaction_bytes=64;"
       "max_bytes_for_level_multiplier=60;"
+      "hybrid_target_write_amplification=8;"
       "memtable_factory=SkipListFactory;"
       "compression=kNoCompression;"
       "bottommost_compression=kDisableCompressionOption;"
@@ -459,6 +464,11 @@ TEST_F(OptionsSettableTest, ColumnFamilyOptionsAllFieldsSettable) {
       "ttl=60;"
       "periodic_compaction_seconds=3600;"
       "sample_for_compression=0;"
+      "enable_blob_files=true;"
+      "min_blob_size=256;"
+      "blob_file_size=1000000;"
+      "enable_blob_garbage_collection=true;"
+      "blob_garbage_collection_age_cutoff=0.5;"
       "compaction_options_fifo={max_table_files_size=3;allow_"
       "compaction=false;};",
       new_options));
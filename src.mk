@@ -1,8 +1,15 @@
 # These are the sources from which librocksdb.a is built:
 LIB_SOURCES =                                                   \
   cache/clock_cache.cc                                          \
+  cache/compressed_secondary_cache.cc                           \
+  cache/lock_free_clock_cache.cc                                \
   cache/lru_cache.cc                                            \
   cache/sharded_cache.cc                                        \
+  db/blob_fetcher.cc                                            \
+  db/blob_file_builder.cc                                       \
+  db/blob_file_cache.cc                                         \
+  db/blob_file_reader.cc                                        \
+  db/blob_garbage_meter.cc                                      \
   db/builder.cc                                                 \
   db/c.cc                                                       \
   db/column_family.cc                                           \
@@ -12,8 +19,10 @@ LIB_SOURCES =                                                   \
   db/compaction/compaction_job.cc                               \
   db/compaction/compaction_picker.cc                            \
   db/compaction/compaction_picker_fifo.cc                       \
+  db/compaction/compaction_picker_hybrid.cc                     \
   db/compaction/compaction_picker_level.cc                      \
   db/compaction/compaction_picker_universal.cc                 	\
+  db/compression_dict_store.cc                                  \
   db/convenience.cc                                             \
   db/db_filesnapshot.cc                                         \
   db/db_impl/db_impl.cc                                         \
@@ -68,6 +77,7 @@ LIB_SOURCES =                                                   \
   env/env_hdfs.cc                                               \
   env/env_posix.cc                                              \
   env/io_posix.cc                                               \
+  env/io_uring.cc                                               \
   env/mock_env.cc                                               \
   file/delete_scheduler.cc                                      \
   file/file_util.cc                                             \
@@ -79,7 +89,9 @@ LIB_SOURCES =                                                   \
   memory/arena.cc                                               \
   memory/concurrent_arena.cc                                    \
   memory/jemalloc_nodump_allocator.cc                           \
+  memory/slab_memory_allocator.cc                               \
   memtable/alloc_tracker.cc                                     \
+  memtable/btree_rep.cc                                         \
   memtable/hash_linklist_rep.cc                                 \
   memtable/hash_skiplist_rep.cc                                 \
   memtable/skiplistrep.cc                                       \
@@ -114,6 +126,7 @@ LIB_SOURCES =                                                   \
   table/block_based/block_based_table_factory.cc                \
   table/block_based/block_based_table_reader.cc                 \
   table/block_based/block_builder.cc                            \
+  table/block_based/block_interpolation_index.cc                \
   table/block_based/block_prefix_index.cc                       \
   table/block_based/data_block_hash_index.cc                    \
   table/block_based/data_block_footer.cc                        \
@@ -169,6 +182,7 @@ LIB_SOURCES =                                                   \
   util/string_util.cc                                           \
   util/thread_local.cc                                          \
   util/threadpool_imp.cc                                        \
+  util/xxh3.cc                                                  \
   util/xxhash.cc                                                \
   utilities/backupable/backupable_db.cc                         \
   utilities/blob_db/blob_compaction_filter.cc                   \
@@ -238,6 +252,7 @@ LIB_SOURCES =                                                   \
   cloud/manifest_reader.cc                                      \
   cloud/purge.cc                                                \
   cloud/cloud_manifest.cc                                       \
+  cloud/cloud_transfer_limiter.cc                               \
   db/db_impl/db_impl_remote_compaction.cc
 
 ifeq ($(ARMCRC_SOURCE),1)
@@ -288,9 +303,12 @@ FOLLY_SOURCES = \
 MAIN_SOURCES =                                                          \
   cloud/db_cloud_test.cc                                                \
   cloud/cloud_manifest_test.cc                                          \
+  cloud/cloud_transfer_limiter_test.cc                                  \
   db/remote_compaction.cc                                               \
   cache/cache_bench.cc                                                  \
   cache/cache_test.cc                                                   \
+  cache/compressed_secondary_cache_test.cc                              \
+  cache/lock_free_clock_cache_test.cc                                   \
   db/column_family_test.cc                                              \
   db/compact_files_test.cc                                              \
   db/compaction/compaction_iterator_test.cc                             \
@@ -301,6 +319,7 @@ MAIN_SOURCES =                                                          \
   db/corruption_test.cc                                                 \
   db/cuckoo_table_db_test.cc                                            \
   db/db_basic_test.cc                                                   \
+  db/db_blob_basic_test.cc                                              \
   db/db_blob_index_test.cc                                              \
   db/db_block_cache_test.cc                                             \
   db/db_bloom_filter_test.cc                                            \
@@ -379,6 +398,8 @@ MAIN_SOURCES =                                                          \
   logging/env_logger_test.cc                                            \
   logging/event_logger_test.cc                                          \
   memory/arena_test.cc                                                  \
+  memory/slab_memory_allocator_test.cc                                  \
+  memtable/btree_rep_test.cc                                            \
   memtable/inlineskiplist_test.cc                                       \
   memtable/memtablerep_bench.cc                                         \
   memtable/skiplist_test.cc                                             \
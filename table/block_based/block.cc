@@ -20,6 +20,7 @@
 #include "port/port.h"
 #include "port/stack_trace.h"
 #include "rocksdb/comparator.h"
+#include "table/block_based/block_interpolation_index.h"
 #include "table/block_based/block_prefix_index.h"
 #include "table/block_based/data_block_footer.h"
 #include "table/format.h"
@@ -137,6 +138,33 @@ void DataBlockIter::NextOrReport() {
   ParseNextDataKey<CheckAndDecodeEntry>();
 }
 
+size_t DataBlockIter::NextN(size_t n, Slice* keys, Slice* values,
+                            std::string* key_buf) {
+  key_buf->clear();
+  size_t count = 0;
+  for (; count < n && Valid(); count++) {
+    const Slice key = key_.GetKey();
+    if (key_pinned_) {
+      keys[count] = key;
+    } else {
+      key_buf->append(key.data(), key.size());
+      // Pointed into key_buf once it stops growing
+      keys[count] = Slice(nullptr, key.size());
+    }
+    values[count] = value();
+    ParseNextDataKey<DecodeEntry>();
+  }
+
+  const char* buf = key_buf->data();
+  for (size_t i = 0; i < count; i++) {
+    if (keys[i].data() == nullptr) {
+      keys[i] = Slice(buf, keys[i].size());
+      buf += keys[i].size();
+    }
+  }
+  return count;
+}
+
 void IndexBlockIter::Next() {
   assert(Valid());
   ParseNextIndexKey();
@@ -190,6 +218,11 @@ void DataBlockIter::Prev() {
     }
     const Slice current_key(key_ptr, current_prev_entry.key_size);
 
+    if (column_layout_) {
+      // The entry after the cached one is the one we are leaving
+      next_entry_index_--;
+      next_entry_offset_ = current_;
+    }
     current_ = current_prev_entry.offset;
     key_.SetKey(current_key, false /* copy */);
     value_ = current_prev_entry.value;
@@ -246,8 +279,12 @@ void DataBlockIter::Seek(const Slice& target) {
     return;
   }
   uint32_t index = 0;
-  bool ok = BinarySeek<DecodeKey>(seek_key, 0, num_restarts_ - 1, &index,
-                                  comparator_);
+  // Keys of the column layout are encoded as in index blocks of
+  // format_version 4
+  bool ok =
+      column_layout_
+          ? BinarySeek<DecodeKeyV4>(seek_key, 0, num_restarts_ - 1, &index)
+          : BinarySeek<DecodeKey>(seek_key, 0, num_restarts_ - 1, &index);
 
   if (!ok) {
     return;
@@ -394,12 +431,12 @@ void IndexBlockIter::Seek(const Slice& target) {
   bool ok = false;
   if (prefix_index_) {
     ok = PrefixSeek(target, &index);
+  } else if (interpolation_index_) {
+    ok = InterpolationSeek(target, seek_key, &index);
   } else if (value_delta_encoded_) {
-    ok = BinarySeek<DecodeKeyV4>(seek_key, 0, num_restarts_ - 1, &index,
-                                 comparator_);
+    ok = BinarySeek<DecodeKeyV4>(seek_key, 0, num_restarts_ - 1, &index);
   } else {
-    ok = BinarySeek<DecodeKey>(seek_key, 0, num_restarts_ - 1, &index,
-                               comparator_);
+    ok = BinarySeek<DecodeKey>(seek_key, 0, num_restarts_ - 1, &index);
   }
 
   if (!ok) {
@@ -422,8 +459,12 @@ void DataBlockIter::SeekForPrev(const Slice& target) {
     return;
   }
   uint32_t index = 0;
-  bool ok = BinarySeek<DecodeKey>(seek_key, 0, num_restarts_ - 1, &index,
-                                  comparator_);
+  // Keys of the column layout are encoded as in index blocks of
+  // format_version 4
+  bool ok =
+      column_layout_
+          ? BinarySeek<DecodeKeyV4>(seek_key, 0, num_restarts_ - 1, &index)
+          : BinarySeek<DecodeKey>(seek_key, 0, num_restarts_ - 1, &index);
 
   if (!ok) {
     return;
@@ -512,7 +553,16 @@ bool DataBlockIter::ParseNextDataKey(const char* limit) {
 
   // Decode next entry
   uint32_t shared, non_shared, value_length;
-  p = DecodeEntryFunc()(p, limit, &shared, &non_shared, &value_length);
+  if (column_layout_) {
+    p = DecodeKeyV4()(p, limit, &shared, &non_shared);
+    if (p != nullptr && (static_cast<uint32_t>(limit - p) < non_shared ||
+                         next_entry_index_ >= columns_.num_entries)) {
+      p = nullptr;
+    }
+    value_length = 0;
+  } else {
+    p = DecodeEntryFunc()(p, limit, &shared, &non_shared, &value_length);
+  }
   if (p == nullptr || key_.Size() < shared) {
     CorruptionError();
     return false;
@@ -553,7 +603,12 @@ bool DataBlockIter::ParseNextDataKey(const char* limit) {
       key_.UpdateInternalKey(global_seqno_, value_type);
     }
 
-    value_ = Slice(p + non_shared, value_length);
+    if (column_layout_) {
+      value_ = ColumnValue(next_entry_index_++);
+      next_entry_offset_ = static_cast<uint32_t>(p + non_shared - data_);
+    } else {
+      value_ = Slice(p + non_shared, value_length);
+    }
     if (shared == 0) {
       while (restart_index_ + 1 < num_restarts_ &&
              GetRestartPoint(restart_index_ + 1) < current_) {
@@ -662,8 +717,7 @@ void IndexBlockIter::DecodeCurrentValue(uint32_t shared) {
 template <class TValue>
 template <typename DecodeKeyFunc>
 bool BlockIter<TValue>::BinarySeek(const Slice& target, uint32_t left,
-                                   uint32_t right, uint32_t* index,
-                                   const Comparator* comp) {
+                                   uint32_t right, uint32_t* index) {
   assert(left <= right);
 
   while (left < right) {
@@ -677,7 +731,7 @@ bool BlockIter<TValue>::BinarySeek(const Slice& target, uint32_t left,
       return false;
     }
     Slice mid_key(key_ptr, non_shared);
-    int cmp = comp->Compare(mid_key, target);
+    int cmp = CompareKeys(mid_key, target);
     if (cmp < 0) {
       // Key at "mid" is smaller than "target". Therefore all
       // blocks before "mid" are uninteresting.
@@ -766,6 +820,52 @@ bool IndexBlockIter::BinaryBlockIndexSeek(const Slice& target,
   }
 }
 
+// Binary search for the restart point to start the linear search of Seek()
+// from, among the restart points the interpolation index predicts for the
+// key. BinarySeek() does not compare the keys at the ends of the range it
+// searches, so if it ends up at one, the key of the restart point just
+// outside tells whether the key is in the rest of the block instead.
+bool IndexBlockIter::InterpolationSeek(const Slice& target,
+                                       const Slice& seek_key,
+                                       uint32_t* index) {
+  auto binary_seek = [&](uint32_t left, uint32_t right) {
+    return value_delta_encoded_
+               ? BinarySeek<DecodeKeyV4>(seek_key, left, right, index)
+               : BinarySeek<DecodeKey>(seek_key, left, right, index);
+  };
+  const uint32_t last = num_restarts_ - 1;
+  uint32_t left = 0;
+  uint32_t right = last;
+  if (!interpolation_index_->Predict(ExtractUserKey(target), &left, &right)) {
+    return binary_seek(0, last);
+  }
+  if (!binary_seek(left, right)) {
+    return false;
+  }
+  if (*index == left && left > 0) {
+    int cmp = CompareBlockKey(left, seek_key);
+    if (!status_.ok()) {
+      return false;
+    }
+    if (cmp > 0) {
+      TEST_SYNC_POINT("IndexBlockIter::InterpolationSeek:Miss");
+      return binary_seek(0, left - 1);
+    }
+  }
+  if (*index == right && right < last) {
+    int cmp = CompareBlockKey(right + 1, seek_key);
+    if (!status_.ok()) {
+      return false;
+    }
+    if (cmp <= 0) {
+      TEST_SYNC_POINT("IndexBlockIter::InterpolationSeek:Miss");
+      return binary_seek(right + 1, last);
+    }
+  }
+  TEST_SYNC_POINT("IndexBlockIter::InterpolationSeek:Hit");
+  return true;
+}
+
 bool IndexBlockIter::PrefixSeek(const Slice& target, uint32_t* index) {
   assert(prefix_index_);
   Slice seek_key = target;
@@ -798,6 +898,14 @@ uint32_t Block::NumRestarts() const {
     // Such check is for backward compatibility. We can ensure legacy block
     // with a vary large num_restarts i.e. >= 0x80000000 can be interpreted
     // correctly as no HashIndex even if the MSB of num_restarts is set.
+    //
+    // Blocks of the column layout may be of any size, and have no HashIndex.
+    bool column_layout = false;
+    UnPackIndexTypeAndNumRestarts(block_footer, nullptr, nullptr,
+                                  &column_layout);
+    if (column_layout) {
+      UnPackIndexTypeAndNumRestarts(block_footer, nullptr, &num_restarts);
+    }
     return num_restarts;
   }
   BlockBasedTableOptions::DataBlockIndexType index_type;
@@ -831,15 +939,25 @@ Block::Block(BlockContents&& contents, SequenceNumber _global_seqno,
       size_(contents_.data.size()),
       restart_offset_(0),
       num_restarts_(0),
-      global_seqno_(_global_seqno) {
+      global_seqno_(_global_seqno),
+      column_layout_(false) {
   TEST_SYNC_POINT("Block::Block:0");
   if (size_ < sizeof(uint32_t)) {
     size_ = 0;  // Error marker
   } else {
     // Should only decode restart points for uncompressed blocks
     num_restarts_ = NumRestarts();
+    UnPackIndexTypeAndNumRestarts(
+        DecodeFixed32(data_ + size_ - sizeof(uint32_t)), nullptr, nullptr,
+        &column_layout_);
     switch (IndexType()) {
       case BlockBasedTableOptions::kDataBlockBinarySearch:
+        if (column_layout_) {
+          if (!InitializeColumns()) {
+            size_ = 0;
+          }
+          break;
+        }
         restart_offset_ = static_cast<uint32_t>(size_) -
                           (1 + num_restarts_) * sizeof(uint32_t);
         if (restart_offset_ > size_ - sizeof(uint32_t)) {
@@ -882,6 +1000,55 @@ Block::Block(BlockContents&& contents, SequenceNumber _global_seqno,
   }
 }
 
+bool Block::InitializeColumns() {
+  if (size_ < sizeof(uint32_t) + kColumnLayoutTrailerSize ||
+      num_restarts_ == 0) {
+    return false;
+  }
+  const uint32_t trailer_offset = static_cast<uint32_t>(
+      size_ - sizeof(uint32_t) - kColumnLayoutTrailerSize);
+  const char* trailer = data_ + trailer_offset;
+  columns_.num_entries = DecodeFixed32(trailer);
+  columns_.value_width = DecodeFixed32(trailer + sizeof(uint32_t));
+  columns_.restart_interval = DecodeFixed32(trailer + 2 * sizeof(uint32_t));
+  columns_.values_offset = DecodeFixed32(trailer + 3 * sizeof(uint32_t));
+
+  // Check that the arrays fit, in the order they are laid out
+  uint64_t values_end = trailer_offset;
+  if (columns_.value_width == kColumnLayoutVariableValueWidth) {
+    uint64_t value_ends_size =
+        uint64_t{columns_.num_entries} * sizeof(uint32_t);
+    if (value_ends_size > values_end) {
+      return false;
+    }
+    values_end -= value_ends_size;
+    columns_.value_ends_offset = static_cast<uint32_t>(values_end);
+  }
+  if (columns_.values_offset > values_end) {
+    return false;
+  }
+  if (columns_.value_width != kColumnLayoutVariableValueWidth &&
+      uint64_t{columns_.num_entries} * columns_.value_width >
+          values_end - columns_.values_offset) {
+    return false;
+  }
+  uint64_t restarts_size = uint64_t{num_restarts_} * sizeof(uint32_t);
+  if (restarts_size > columns_.values_offset) {
+    return false;
+  }
+  restart_offset_ =
+      columns_.values_offset - static_cast<uint32_t>(restarts_size);
+
+  // Every restart interval but the last is full
+  if (columns_.restart_interval == 0 ||
+      (columns_.num_entries > 0 &&
+       uint64_t{num_restarts_ - 1} * columns_.restart_interval >=
+           columns_.num_entries)) {
+    return false;
+  }
+  return true;
+}
+
 DataBlockIter* Block::NewDataIterator(const Comparator* cmp,
                                       const Comparator* ucmp,
                                       DataBlockIter* iter, Statistics* stats,
@@ -904,7 +1071,8 @@ DataBlockIter* Block::NewDataIterator(const Comparator* cmp,
     ret_iter->Initialize(
         cmp, ucmp, data_, restart_offset_, num_restarts_, global_seqno_,
         read_amp_bitmap_.get(), block_contents_pinned,
-        data_block_hash_index_.Valid() ? &data_block_hash_index_ : nullptr);
+        data_block_hash_index_.Valid() ? &data_block_hash_index_ : nullptr,
+        column_layout_ ? &columns_ : nullptr);
     if (read_amp_bitmap_) {
       if (read_amp_bitmap_->GetStatistics() != stats) {
         // DB changed the Statistics pointer, we need to notify read_amp_bitmap_
@@ -920,7 +1088,8 @@ IndexBlockIter* Block::NewIndexIterator(
     const Comparator* cmp, const Comparator* ucmp, IndexBlockIter* iter,
     Statistics* /*stats*/, bool total_order_seek, bool have_first_key,
     bool key_includes_seq, bool value_is_full, bool block_contents_pinned,
-    BlockPrefixIndex* prefix_index) {
+    BlockPrefixIndex* prefix_index,
+    const BlockInterpolationIndex* interpolation_index) {
   IndexBlockIter* ret_iter;
   if (iter != nullptr) {
     ret_iter = iter;
@@ -938,10 +1107,15 @@ IndexBlockIter* Block::NewIndexIterator(
   } else {
     BlockPrefixIndex* prefix_index_ptr =
         total_order_seek ? nullptr : prefix_index;
+    // The model only fits the block it was built with
+    if (interpolation_index != nullptr &&
+        interpolation_index->num_restarts() != num_restarts_) {
+      interpolation_index = nullptr;
+    }
     ret_iter->Initialize(cmp, ucmp, data_, restart_offset_, num_restarts_,
                          global_seqno_, prefix_index_ptr, have_first_key,
                          key_includes_seq, value_is_full,
-                         block_contents_pinned);
+                         block_contents_pinned, interpolation_index);
   }
 
   return ret_iter;
@@ -22,11 +22,13 @@
 
 #include "db/dbformat.h"
 #include "db/pinned_iterators_manager.h"
+#include "monitoring/perf_context_imp.h"
 #include "rocksdb/iterator.h"
 #include "rocksdb/options.h"
 #include "rocksdb/statistics.h"
 #include "rocksdb/table.h"
 #include "table/block_based/block_prefix_index.h"
+#include "table/block_based/data_block_footer.h"
 #include "table/block_based/data_block_hash_index.h"
 #include "table/format.h"
 #include "table/internal_iterator.h"
@@ -42,6 +44,7 @@ class BlockIter;
 class DataBlockIter;
 class IndexBlockIter;
 class BlockPrefixIndex;
+class BlockInterpolationIndex;
 
 // BlockReadAmpBitmap is a bitmap that map the rocksdb::Block data bytes to
 // a bitmap with ratio bytes_per_bit. Whenever we access a range of bytes in
@@ -141,6 +144,17 @@ class BlockReadAmpBitmap {
   uint32_t rnd_;
 };
 
+// Where the values of a data block of the column layout are, see
+// block_builder.cc
+struct DataBlockColumns {
+  uint32_t num_entries = 0;
+  uint32_t value_width = 0;
+  uint32_t restart_interval = 0;
+  uint32_t values_offset = 0;
+  // Offset of value_ends, if value_width is kColumnLayoutVariableValueWidth
+  uint32_t value_ends_offset = 0;
+};
+
 class Block {
  public:
   // Initialize the block with the specified contents.
@@ -161,6 +175,8 @@ class Block {
   bool own_bytes() const { return contents_.own_bytes(); }
 
   BlockBasedTableOptions::DataBlockIndexType IndexType() const;
+  // Whether this is a data block of the column layout
+  bool IsColumnLayout() const { return column_layout_; }
 
   // If comparator is InternalKeyComparator, user_comparator is its user
   // comparator; they are equal otherwise.
@@ -206,7 +222,9 @@ class Block {
                                    bool total_order_seek, bool have_first_key,
                                    bool key_includes_seq, bool value_is_full,
                                    bool block_contents_pinned = false,
-                                   BlockPrefixIndex* prefix_index = nullptr);
+                                   BlockPrefixIndex* prefix_index = nullptr,
+                                   const BlockInterpolationIndex*
+                                       interpolation_index = nullptr);
 
   // Report an approximation of how much memory has been used.
   size_t ApproximateMemoryUsage() const;
@@ -225,6 +243,13 @@ class Block {
   const SequenceNumber global_seqno_;
 
   DataBlockHashIndex data_block_hash_index_;
+
+  bool column_layout_;
+  DataBlockColumns columns_;
+
+  // Reads the trailer of a data block of the column layout, and sets
+  // restart_offset_. Returns false if the block is corrupted.
+  bool InitializeColumns();
 };
 
 template <class TValue>
@@ -237,6 +262,7 @@ class BlockIter : public InternalIteratorBase<TValue> {
     assert(num_restarts > 0);  // Ensure the param is valid
 
     comparator_ = comparator;
+    inline_compare_ = InlineCompare::kNone;
     data_ = data;
     restarts_ = restarts;
     num_restarts_ = num_restarts;
@@ -302,6 +328,16 @@ class BlockIter : public InternalIteratorBase<TValue> {
   // Note: The type could be changed to InternalKeyComparator but we see a weird
   // performance drop by that.
   const Comparator* comparator_;
+  // How CompareKeys() can compare keys without calling comparator_
+  enum class InlineCompare : uint8_t {
+    kNone,
+    // comparator_ orders keys bytewise
+    kBytewise,
+    // comparator_ orders internal keys, and user_comparator their user keys
+    // bytewise
+    kBytewiseUserKeys,
+  };
+  InlineCompare inline_compare_;
   const char* data_;       // underlying block contents
   uint32_t num_restarts_;  // Number of uint32_t entries in restart array
 
@@ -352,9 +388,35 @@ class BlockIter : public InternalIteratorBase<TValue> {
 
   void CorruptionError();
 
+  // Sets inline_compare_ once comparator_ is set. A comparator_ other than
+  // user_comparator orders internal keys.
+  void SetInlineCompare(const Comparator* user_comparator) {
+    if (comparator_->IsBytewiseOrder() && comparator_->timestamp_size() == 0) {
+      inline_compare_ = InlineCompare::kBytewise;
+    } else if (comparator_ != user_comparator && user_comparator != nullptr &&
+               user_comparator->IsBytewiseOrder() &&
+               user_comparator->timestamp_size() == 0) {
+      inline_compare_ = InlineCompare::kBytewiseUserKeys;
+    } else {
+      inline_compare_ = InlineCompare::kNone;
+    }
+  }
+
+  inline int CompareKeys(const Slice& a, const Slice& b) const {
+    switch (inline_compare_) {
+      case InlineCompare::kBytewise:
+        return BytewiseCompare(a, b);
+      case InlineCompare::kBytewiseUserKeys:
+        PERF_COUNTER_ADD(user_key_comparison_count, 1);
+        return BytewiseCompareInternalKeys(a, b);
+      default:
+        return comparator_->Compare(a, b);
+    }
+  }
+
   template <typename DecodeKeyFunc>
   inline bool BinarySeek(const Slice& target, uint32_t left, uint32_t right,
-                         uint32_t* index, const Comparator* comp);
+                         uint32_t* index);
 };
 
 class DataBlockIter final : public BlockIter<Slice> {
@@ -365,26 +427,34 @@ class DataBlockIter final : public BlockIter<Slice> {
                 const char* data, uint32_t restarts, uint32_t num_restarts,
                 SequenceNumber global_seqno,
                 BlockReadAmpBitmap* read_amp_bitmap, bool block_contents_pinned,
-                DataBlockHashIndex* data_block_hash_index)
+                DataBlockHashIndex* data_block_hash_index,
+                const DataBlockColumns* columns = nullptr)
       : DataBlockIter() {
     Initialize(comparator, user_comparator, data, restarts, num_restarts,
                global_seqno, read_amp_bitmap, block_contents_pinned,
-               data_block_hash_index);
+               data_block_hash_index, columns);
   }
+  // `columns` is set for blocks of the column layout
   void Initialize(const Comparator* comparator,
                   const Comparator* user_comparator, const char* data,
                   uint32_t restarts, uint32_t num_restarts,
                   SequenceNumber global_seqno,
                   BlockReadAmpBitmap* read_amp_bitmap,
                   bool block_contents_pinned,
-                  DataBlockHashIndex* data_block_hash_index) {
+                  DataBlockHashIndex* data_block_hash_index,
+                  const DataBlockColumns* columns = nullptr) {
     InitializeBase(comparator, data, restarts, num_restarts, global_seqno,
                    block_contents_pinned);
+    SetInlineCompare(user_comparator);
     user_comparator_ = user_comparator;
     key_.SetIsUserKey(false);
     read_amp_bitmap_ = read_amp_bitmap;
     last_bitmap_offset_ = current_ + 1;
     data_block_hash_index_ = data_block_hash_index;
+    column_layout_ = columns != nullptr;
+    if (column_layout_) {
+      columns_ = *columns;
+    }
   }
 
   virtual Slice value() const override {
@@ -415,6 +485,13 @@ class DataBlockIter final : public BlockIter<Slice> {
 
   virtual void Next() final override;
 
+  // Decodes up to `n` entries, starting at the current one, into `keys` and
+  // `values`, and moves to the entry after the last of them. Keys that are
+  // not stored whole in the block are copied to `key_buf`, which the returned
+  // keys point into until it is modified. Returns the number of entries
+  // decoded, which is less than `n` only at the end of the block.
+  size_t NextN(size_t n, Slice* keys, Slice* values, std::string* key_buf);
+
   // Try to advance to the next entry in the block. If there is data corruption
   // or error, report it to the caller instead of aborting the process. May
   // incur higher CPU overhead because we need to perform check on every entry.
@@ -469,11 +546,46 @@ class DataBlockIter final : public BlockIter<Slice> {
   DataBlockHashIndex* data_block_hash_index_;
   const Comparator* user_comparator_;
 
+  bool column_layout_ = false;
+  DataBlockColumns columns_;
+  // In the column layout, the index and the offset of the entry after the
+  // current one
+  uint32_t next_entry_index_ = 0;
+  uint32_t next_entry_offset_ = 0;
+
+  // These hide the ones of BlockIter, which find the next entry at the end of
+  // value_.
+  inline uint32_t NextEntryOffset() const {
+    return column_layout_ ? next_entry_offset_ : BlockIter::NextEntryOffset();
+  }
+
+  void SeekToRestartPoint(uint32_t index) {
+    BlockIter::SeekToRestartPoint(index);
+    if (column_layout_) {
+      next_entry_index_ = index * columns_.restart_interval;
+      next_entry_offset_ = GetRestartPoint(index);
+    }
+  }
+
+  // The value of the `index`th entry of a block of the column layout
+  inline Slice ColumnValue(uint32_t index) const {
+    const char* values = data_ + columns_.values_offset;
+    if (columns_.value_width != kColumnLayoutVariableValueWidth) {
+      return Slice(values + static_cast<size_t>(index) * columns_.value_width,
+                   columns_.value_width);
+    }
+    const char* value_ends = data_ + columns_.value_ends_offset;
+    uint32_t begin =
+        index == 0 ? 0 : DecodeFixed32(value_ends + (index - 1) * 4);
+    return Slice(values + begin,
+                 DecodeFixed32(value_ends + index * 4) - begin);
+  }
+
   template <typename DecodeEntryFunc>
   inline bool ParseNextDataKey(const char* limit = nullptr);
 
   inline int Compare(const IterKey& ikey, const Slice& b) const {
-    return comparator_->Compare(ikey.GetInternalKey(), b);
+    return CompareKeys(ikey.GetInternalKey(), b);
   }
 
   bool SeekForGetImpl(const Slice& target);
@@ -481,7 +593,8 @@ class DataBlockIter final : public BlockIter<Slice> {
 
 class IndexBlockIter final : public BlockIter<IndexValue> {
  public:
-  IndexBlockIter() : BlockIter(), prefix_index_(nullptr) {}
+  IndexBlockIter()
+      : BlockIter(), prefix_index_(nullptr), interpolation_index_(nullptr) {}
 
   virtual Slice key() const override {
     assert(Valid());
@@ -491,18 +604,23 @@ class IndexBlockIter final : public BlockIter<IndexValue> {
   // format.
   // value_is_full, default true, means that no delta encoding is
   // applied to values.
+  // interpolation_index, if not null, is a model of the keys of the restart
+  // points, which narrows the binary search of Seek().
   void Initialize(const Comparator* comparator,
                   const Comparator* user_comparator, const char* data,
                   uint32_t restarts, uint32_t num_restarts,
                   SequenceNumber global_seqno, BlockPrefixIndex* prefix_index,
                   bool have_first_key, bool key_includes_seq,
-                  bool value_is_full, bool block_contents_pinned) {
+                  bool value_is_full, bool block_contents_pinned,
+                  const BlockInterpolationIndex* interpolation_index = nullptr) {
     InitializeBase(key_includes_seq ? comparator : user_comparator, data,
                    restarts, num_restarts, kDisableGlobalSequenceNumber,
                    block_contents_pinned);
+    SetInlineCompare(user_comparator);
     key_includes_seq_ = key_includes_seq;
     key_.SetIsUserKey(!key_includes_seq_);
     prefix_index_ = prefix_index;
+    interpolation_index_ = interpolation_index;
     value_delta_encoded_ = !value_is_full;
     have_first_key_ = have_first_key;
     if (have_first_key_ && global_seqno != kDisableGlobalSequenceNumber) {
@@ -566,6 +684,7 @@ class IndexBlockIter final : public BlockIter<IndexValue> {
   bool value_delta_encoded_;
   bool have_first_key_;  // value includes first_internal_key
   BlockPrefixIndex* prefix_index_;
+  const BlockInterpolationIndex* interpolation_index_;
   // Whether the value is delta encoded. In that case the value is assumed to be
   // BlockHandle. The first value in each restart interval is the full encoded
   // BlockHandle; the restart of encoded size part of the BlockHandle. The
@@ -590,16 +709,18 @@ class IndexBlockIter final : public BlockIter<IndexValue> {
   std::unique_ptr<GlobalSeqnoState> global_seqno_state_;
 
   bool PrefixSeek(const Slice& target, uint32_t* index);
+  bool InterpolationSeek(const Slice& target, const Slice& seek_key,
+                         uint32_t* index);
   bool BinaryBlockIndexSeek(const Slice& target, uint32_t* block_ids,
                             uint32_t left, uint32_t right, uint32_t* index);
   inline int CompareBlockKey(uint32_t block_index, const Slice& target);
 
   inline int Compare(const Slice& a, const Slice& b) const {
-    return comparator_->Compare(a, b);
+    return CompareKeys(a, b);
   }
 
   inline int Compare(const IterKey& ikey, const Slice& b) const {
-    return comparator_->Compare(ikey.GetKey(), b);
+    return CompareKeys(ikey.GetKey(), b);
   }
 
   inline bool ParseNextIndexKey();
@@ -12,13 +12,17 @@
 #include <assert.h>
 #include <stdio.h>
 
+#include <condition_variable>
+#include <deque>
 #include <list>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <utility>
 
+#include "db/compression_dict_store.h"
 #include "db/dbformat.h"
 #include "index_builder.h"
 
@@ -42,6 +46,7 @@
 #include "table/table_builder.h"
 
 #include "memory/memory_allocator.h"
+#include "port/port.h"
 #include "util/coding.h"
 #include "util/compression.h"
 #include "util/crc32c.h"
@@ -64,11 +69,14 @@ FilterBlockBuilder* CreateFilterBlockBuilder(
     const ImmutableCFOptions& /*opt*/, const MutableCFOptions& mopt,
     const BlockBasedTableOptions& table_opt,
     const bool use_delta_encoding_for_index_values,
-    PartitionedIndexBuilder* const p_index_builder) {
+    PartitionedIndexBuilder* const p_index_builder,
+    const int level_at_creation) {
   if (table_opt.filter_policy == nullptr) return nullptr;
 
+  FilterBuildingContext context(table_opt);
+  context.level_at_creation = level_at_creation;
   FilterBitsBuilder* filter_bits_builder =
-      table_opt.filter_policy->GetFilterBitsBuilder();
+      table_opt.filter_policy->GetBuilderWithContext(context);
   if (filter_bits_builder == nullptr) {
     return new BlockBasedFilterBlockBuilder(mopt.prefix_extractor.get(),
                                             table_opt);
@@ -275,6 +283,59 @@ class BlockBasedTableBuilder::BlockBasedTablePropertiesCollector
   bool prefix_filtering_;
 };
 
+// State of parallel compression. Data blocks are compressed by
+// `parallel_threads` threads of the builder, but written out by the thread
+// calling Add() and Finish(), in the order they were cut. The keys of a block
+// are added to the index and filter builders when the block is written, as
+// `EnterUnbuffered()` does, so the file, its index and its filter are the same
+// as with serial compression.
+struct BlockBasedTableBuilder::ParallelCompressionRep {
+  struct BlockRep {
+    std::string raw;
+    std::vector<std::string> keys;
+    std::string compressed;
+    // Points to `compressed` or `raw`
+    Slice contents;
+    CompressionType type = kNoCompression;
+    Status status;
+    size_t sampled_output_fast_size = 0;
+    size_t sampled_output_slow_size = 0;
+    // Set by the compression thread under `mu`
+    bool compressed_done = false;
+  };
+
+  // Blocks per thread kept in memory while waiting to be compressed or
+  // written out.
+  static const size_t kBlocksInFlightPerThread = 4;
+
+  ParallelCompressionRep(uint32_t _num_threads, size_t block_size)
+      : num_threads(_num_threads),
+        max_inflight_bytes(std::max(block_size, size_t{4096}) * _num_threads *
+                           kBlocksInFlightPerThread) {}
+
+  const uint32_t num_threads;
+  // Uncompressed size of `blocks`, bounded by `max_inflight_bytes`.
+  const size_t max_inflight_bytes;
+  size_t inflight_bytes = 0;
+  // Blocks queued and not written out yet, in file order.
+  std::deque<std::unique_ptr<BlockRep>> blocks;
+  // Keys of the data block being built.
+  std::vector<std::string> curr_block_keys;
+  // Uncompressed and stored size of the data blocks written out, to estimate
+  // the size of `blocks` once written.
+  uint64_t raw_bytes_written = 0;
+  uint64_t stored_bytes_written = 0;
+
+  std::mutex mu;
+  // Signaled when a block is queued or on shutdown.
+  std::condition_variable work_cv;
+  // Signaled when a block is compressed.
+  std::condition_variable done_cv;
+  std::deque<BlockRep*> work_queue;
+  bool shutdown = false;
+  std::vector<port::Thread> threads;
+};
+
 struct BlockBasedTableBuilder::Rep {
   const ImmutableCFOptions ioptions;
   const MutableCFOptions moptions;
@@ -306,6 +367,11 @@ struct BlockBasedTableBuilder::Rep {
   CompressionContext compression_ctx;
   std::unique_ptr<UncompressionContext> verify_ctx;
   std::unique_ptr<UncompressionDict> verify_dict;
+  // Shared compression dictionaries of the column family, if they are enabled
+  CompressionDictStore* compression_dict_store = nullptr;
+  const int level_at_creation;
+  // Id of the shared dictionary the file is compressed with, or 0
+  uint64_t compression_dict_id = 0;
 
   size_t data_begin_offset = 0;
 
@@ -354,6 +420,10 @@ struct BlockBasedTableBuilder::Rep {
 
   std::vector<std::unique_ptr<IntTblPropCollector>> table_properties_collectors;
 
+  std::unique_ptr<ParallelCompressionRep> pc_rep;
+
+  bool IsParallelCompressionEnabled() const { return pc_rep != nullptr; }
+
   Rep(const ImmutableCFOptions& _ioptions, const MutableCFOptions& _moptions,
       const BlockBasedTableOptions& table_opt,
       const InternalKeyComparator& icomparator,
@@ -365,7 +435,8 @@ struct BlockBasedTableBuilder::Rep {
       const CompressionOptions& _compression_opts, const bool skip_filters,
       const std::string& _column_family_name, const uint64_t _creation_time,
       const uint64_t _oldest_key_time, const uint64_t _target_file_size,
-      const uint64_t _file_creation_time)
+      const uint64_t _file_creation_time, const int _level_at_creation,
+      CompressionDictStore* _compression_dict_store)
       : ioptions(_ioptions),
         moptions(_moptions),
         table_options(table_opt),
@@ -381,7 +452,8 @@ struct BlockBasedTableBuilder::Rep {
                            ->CanKeysWithDifferentByteContentsBeEqual()
                        ? BlockBasedTableOptions::kDataBlockBinarySearch
                        : table_options.data_block_index_type,
-                   table_options.data_block_hash_table_util_ratio),
+                   table_options.data_block_hash_table_util_ratio,
+                   table_options.data_block_column_layout),
         range_del_block(1 /* block_restart_interval */),
         internal_prefix_transform(_moptions.prefix_extractor.get()),
         compression_type(_compression_type),
@@ -390,6 +462,7 @@ struct BlockBasedTableBuilder::Rep {
         compression_dict(),
         compression_ctx(_compression_type),
         verify_dict(),
+        level_at_creation(_level_at_creation),
         state((_compression_opts.max_dict_bytes > 0) ? State::kBuffered
                                                      : State::kUnbuffered),
         use_delta_encoding_for_index_values(table_opt.format_version >= 4 &&
@@ -421,7 +494,8 @@ struct BlockBasedTableBuilder::Rep {
     } else {
       filter_builder.reset(CreateFilterBlockBuilder(
           _ioptions, _moptions, table_options,
-          use_delta_encoding_for_index_values, p_index_builder_));
+          use_delta_encoding_for_index_values, p_index_builder_,
+          _level_at_creation));
     }
 
     for (auto& collector_factories : *int_tbl_prop_collector_factories) {
@@ -436,6 +510,34 @@ struct BlockBasedTableBuilder::Rep {
       verify_ctx.reset(new UncompressionContext(UncompressionContext::NoCache(),
                                                 compression_type));
     }
+    if (compression_opts.parallel_threads > 1 &&
+        compression_type != kNoCompression) {
+      pc_rep.reset(new ParallelCompressionRep(compression_opts.parallel_threads,
+                                              table_options.block_size));
+    }
+    if (compression_opts.max_dict_bytes > 0 &&
+        compression_opts.shared_dict_files > 0) {
+      compression_dict_store = _compression_dict_store;
+    }
+    if (compression_dict_store != nullptr) {
+      std::shared_ptr<const SharedCompressionDict> shared_dict =
+          compression_dict_store->Acquire(level_at_creation,
+                                          compression_opts.shared_dict_files);
+      if (shared_dict != nullptr) {
+        // Nothing to sample, so no need to buffer
+        SetCompressionDict(shared_dict->dict);
+        compression_dict_id = shared_dict->id;
+        state = State::kUnbuffered;
+      }
+    }
+  }
+
+  void SetCompressionDict(const std::string& dict) {
+    compression_dict.reset(
+        new CompressionDict(dict, compression_type, compression_opts.level));
+    verify_dict.reset(new UncompressionDict(
+        dict, compression_type == kZSTD ||
+                  compression_type == kZSTDNotFinalCompression));
   }
 
   Rep(const Rep&) = delete;
@@ -456,7 +558,8 @@ BlockBasedTableBuilder::BlockBasedTableBuilder(
     const CompressionOptions& compression_opts, const bool skip_filters,
     const std::string& column_family_name, const uint64_t creation_time,
     const uint64_t oldest_key_time, const uint64_t target_file_size,
-    const uint64_t file_creation_time) {
+    const uint64_t file_creation_time, const int level_at_creation,
+    CompressionDictStore* compression_dict_store) {
   BlockBasedTableOptions sanitized_table_options(table_options);
   if (sanitized_table_options.format_version == 0 &&
       sanitized_table_options.checksum != kCRC32c) {
@@ -474,7 +577,8 @@ BlockBasedTableBuilder::BlockBasedTableBuilder(
               int_tbl_prop_collector_factories, column_family_id, file,
               compression_type, sample_for_compression, compression_opts,
               skip_filters, column_family_name, creation_time, oldest_key_time,
-              target_file_size, file_creation_time);
+              target_file_size, file_creation_time, level_at_creation,
+              compression_dict_store);
 
   if (rep_->filter_builder != nullptr) {
     rep_->filter_builder->StartBlock(0);
@@ -485,6 +589,9 @@ BlockBasedTableBuilder::BlockBasedTableBuilder(
         &rep_->compressed_cache_key_prefix[0],
         &rep_->compressed_cache_key_prefix_size);
   }
+  if (rep_->IsParallelCompressionEnabled()) {
+    StartParallelCompression();
+  }
 }
 
 BlockBasedTableBuilder::~BlockBasedTableBuilder() {
@@ -523,14 +630,18 @@ void BlockBasedTableBuilder::Add(const Slice& key, const Slice& value) {
       // "the r" as the key for the index block entry since it is >= all
       // entries in the first block and < all entries in subsequent
       // blocks.
-      if (ok() && r->state == Rep::State::kUnbuffered) {
+      // With parallel compression, the index entry is added once the block
+      // is written out.
+      if (ok() && r->state == Rep::State::kUnbuffered &&
+          !r->IsParallelCompressionEnabled()) {
         r->index_builder->AddIndexEntry(&r->last_key, &key, r->pending_handle);
       }
     }
 
     // Note: PartitionedFilterBlockBuilder requires key being added to filter
     // builder after being added to index builder.
-    if (r->state == Rep::State::kUnbuffered && r->filter_builder != nullptr) {
+    if (r->state == Rep::State::kUnbuffered && r->filter_builder != nullptr &&
+        !r->IsParallelCompressionEnabled()) {
       size_t ts_sz = r->internal_comparator.user_comparator()->timestamp_size();
       r->filter_builder->Add(ExtractUserKeyAndStripTimestamp(key, ts_sz));
     }
@@ -544,6 +655,8 @@ void BlockBasedTableBuilder::Add(const Slice& key, const Slice& value) {
         r->data_block_and_keys_buffers.emplace_back();
       }
       r->data_block_and_keys_buffers.back().second.emplace_back(key.ToString());
+    } else if (r->IsParallelCompressionEnabled()) {
+      r->pc_rep->curr_block_keys.emplace_back(key.ToString());
     } else {
       r->index_builder->OnKeyAdded(key);
     }
@@ -578,6 +691,14 @@ void BlockBasedTableBuilder::Flush() {
   assert(rep_->state != Rep::State::kClosed);
   if (!ok()) return;
   if (r->data_block.empty()) return;
+  if (r->IsParallelCompressionEnabled() &&
+      r->state == Rep::State::kUnbuffered) {
+    CompressDataBlockInParallel(r->data_block.Finish().ToString(),
+                                std::move(r->pc_rep->curr_block_keys));
+    r->pc_rep->curr_block_keys.clear();
+    r->data_block.Reset();
+    return;
+  }
   WriteBlock(&r->data_block, &r->pending_handle, true /* is_data_block */);
 }
 
@@ -598,15 +719,6 @@ void BlockBasedTableBuilder::WriteBlock(const Slice& raw_block_contents,
   assert(ok());
   Rep* r = rep_;
 
-  auto type = r->compression_type;
-  uint64_t sample_for_compression = r->sample_for_compression;
-  Slice block_contents;
-  bool abort_compression = false;
-
-  StopWatchNano timer(
-      r->ioptions.env,
-      ShouldReportDetailedTime(r->ioptions.env, r->ioptions.statistics));
-
   if (r->state == Rep::State::kBuffered) {
     assert(is_data_block);
     assert(!r->data_block_and_keys_buffers.empty());
@@ -615,6 +727,49 @@ void BlockBasedTableBuilder::WriteBlock(const Slice& raw_block_contents,
     return;
   }
 
+  Slice block_contents;
+  CompressionType type;
+  std::string sampled_output_fast;
+  std::string sampled_output_slow;
+  CompressAndVerifyBlock(raw_block_contents, is_data_block, r->compression_ctx,
+                         r->verify_ctx.get(), &r->compressed_output,
+                         &block_contents, &type, &r->status,
+                         &sampled_output_fast, &sampled_output_slow);
+  if (raw_block_contents.size() < kCompressionSizeLimit) {
+    // notify collectors on block add
+    NotifyCollectTableCollectorsOnBlockAdd(
+        r->table_properties_collectors, raw_block_contents.size(),
+        sampled_output_fast.size(), sampled_output_slow.size());
+  }
+  if (!ok()) {
+    return;
+  }
+
+  WriteRawBlock(block_contents, type, handle, is_data_block);
+  r->compressed_output.clear();
+  if (is_data_block) {
+    if (r->filter_builder != nullptr) {
+      r->filter_builder->StartBlock(r->offset);
+    }
+    r->props.data_size = r->offset;
+    ++r->props.num_data_blocks;
+  }
+}
+
+void BlockBasedTableBuilder::CompressAndVerifyBlock(
+    const Slice& raw_block_contents, bool is_data_block,
+    const CompressionContext& compression_ctx, UncompressionContext* verify_ctx,
+    std::string* compressed_output, Slice* block_contents,
+    CompressionType* type, Status* out_status,
+    std::string* sampled_output_fast, std::string* sampled_output_slow) {
+  Rep* r = rep_;
+  bool abort_compression = false;
+  *type = r->compression_type;
+
+  StopWatchNano timer(
+      r->ioptions.env,
+      ShouldReportDetailedTime(r->ioptions.env, r->ioptions.statistics));
+
   if (raw_block_contents.size() < kCompressionSizeLimit) {
     const CompressionDict* compression_dict;
     if (!is_data_block || r->compression_dict == nullptr) {
@@ -623,26 +778,19 @@ void BlockBasedTableBuilder::WriteBlock(const Slice& raw_block_contents,
       compression_dict = r->compression_dict.get();
     }
     assert(compression_dict != nullptr);
-    CompressionInfo compression_info(r->compression_opts, r->compression_ctx,
-                                     *compression_dict, type,
-                                     sample_for_compression);
+    CompressionInfo compression_info(r->compression_opts, compression_ctx,
+                                     *compression_dict, *type,
+                                     r->sample_for_compression);
 
-    std::string sampled_output_fast;
-    std::string sampled_output_slow;
-    block_contents = CompressBlock(
-        raw_block_contents, compression_info, &type,
+    *block_contents = CompressBlock(
+        raw_block_contents, compression_info, type,
         r->table_options.format_version, is_data_block /* do_sample */,
-        &r->compressed_output, &sampled_output_fast, &sampled_output_slow);
-
-    // notify collectors on block add
-    NotifyCollectTableCollectorsOnBlockAdd(
-        r->table_properties_collectors, raw_block_contents.size(),
-        sampled_output_fast.size(), sampled_output_slow.size());
+        compressed_output, sampled_output_fast, sampled_output_slow);
 
     // Some of the compression algorithms are known to be unreliable. If
     // the verify_compression flag is set then try to de-compress the
     // compressed data and compare to the input.
-    if (type != kNoCompression && r->table_options.verify_compression) {
+    if (*type != kNoCompression && r->table_options.verify_compression) {
       // Retrieve the uncompressed contents into a new buffer
       const UncompressionDict* verify_dict;
       if (!is_data_block || r->verify_dict == nullptr) {
@@ -651,11 +799,12 @@ void BlockBasedTableBuilder::WriteBlock(const Slice& raw_block_contents,
         verify_dict = r->verify_dict.get();
       }
       assert(verify_dict != nullptr);
+      assert(verify_ctx != nullptr);
       BlockContents contents;
-      UncompressionInfo uncompression_info(*r->verify_ctx, *verify_dict,
+      UncompressionInfo uncompression_info(*verify_ctx, *verify_dict,
                                            r->compression_type);
       Status stat = UncompressBlockContentsForCompressionType(
-          uncompression_info, block_contents.data(), block_contents.size(),
+          uncompression_info, block_contents->data(), block_contents->size(),
           &contents, r->table_options.format_version, r->ioptions);
 
       if (stat.ok()) {
@@ -665,12 +814,12 @@ void BlockBasedTableBuilder::WriteBlock(const Slice& raw_block_contents,
           abort_compression = true;
           ROCKS_LOG_ERROR(r->ioptions.info_log,
                           "Decompressed block did not match raw block");
-          r->status =
+          *out_status =
               Status::Corruption("Decompressed block did not match raw block");
         }
       } else {
         // Decompression reported an error. abort.
-        r->status = Status::Corruption("Could not decompress");
+        *out_status = Status::Corruption("Could not decompress");
         abort_compression = true;
       }
     }
@@ -683,9 +832,9 @@ void BlockBasedTableBuilder::WriteBlock(const Slice& raw_block_contents,
   // verification.
   if (abort_compression) {
     RecordTick(r->ioptions.statistics, NUMBER_BLOCK_NOT_COMPRESSED);
-    type = kNoCompression;
-    block_contents = raw_block_contents;
-  } else if (type != kNoCompression) {
+    *type = kNoCompression;
+    *block_contents = raw_block_contents;
+  } else if (*type != kNoCompression) {
     if (ShouldReportDetailedTime(r->ioptions.env, r->ioptions.statistics)) {
       RecordTimeToHistogram(r->ioptions.statistics, COMPRESSION_TIMES_NANOS,
                             timer.ElapsedNanos());
@@ -693,18 +842,144 @@ void BlockBasedTableBuilder::WriteBlock(const Slice& raw_block_contents,
     RecordInHistogram(r->ioptions.statistics, BYTES_COMPRESSED,
                       raw_block_contents.size());
     RecordTick(r->ioptions.statistics, NUMBER_BLOCK_COMPRESSED);
-  } else if (type != r->compression_type) {
+  } else if (*type != r->compression_type) {
     RecordTick(r->ioptions.statistics, NUMBER_BLOCK_NOT_COMPRESSED);
   }
+}
+
+void BlockBasedTableBuilder::StartParallelCompression() {
+  ParallelCompressionRep* pc = rep_->pc_rep.get();
+  for (uint32_t i = 0; i < pc->num_threads; ++i) {
+    pc->threads.emplace_back([this] { BGWorkCompression(); });
+  }
+}
 
-  WriteRawBlock(block_contents, type, handle, is_data_block);
-  r->compressed_output.clear();
-  if (is_data_block) {
-    if (r->filter_builder != nullptr) {
-      r->filter_builder->StartBlock(r->offset);
+void BlockBasedTableBuilder::StopParallelCompression() {
+  ParallelCompressionRep* pc = rep_->pc_rep.get();
+  {
+    std::lock_guard<std::mutex> lock(pc->mu);
+    pc->shutdown = true;
+  }
+  pc->work_cv.notify_all();
+  for (auto& thread : pc->threads) {
+    thread.join();
+  }
+  pc->threads.clear();
+}
+
+void BlockBasedTableBuilder::BGWorkCompression() {
+  Rep* r = rep_;
+  ParallelCompressionRep* pc = r->pc_rep.get();
+  CompressionContext compression_ctx(r->compression_type);
+  std::unique_ptr<UncompressionContext> verify_ctx;
+  if (r->table_options.verify_compression) {
+    verify_ctx.reset(new UncompressionContext(UncompressionContext::NoCache(),
+                                              r->compression_type));
+  }
+  while (true) {
+    ParallelCompressionRep::BlockRep* block;
+    {
+      std::unique_lock<std::mutex> lock(pc->mu);
+      pc->work_cv.wait(
+          lock, [pc] { return pc->shutdown || !pc->work_queue.empty(); });
+      if (pc->shutdown) {
+        return;
+      }
+      block = pc->work_queue.front();
+      pc->work_queue.pop_front();
     }
-    r->props.data_size = r->offset;
-    ++r->props.num_data_blocks;
+    std::string sampled_output_fast;
+    std::string sampled_output_slow;
+    CompressAndVerifyBlock(block->raw, true /* is_data_block */,
+                           compression_ctx, verify_ctx.get(),
+                           &block->compressed, &block->contents, &block->type,
+                           &block->status, &sampled_output_fast,
+                           &sampled_output_slow);
+    block->sampled_output_fast_size = sampled_output_fast.size();
+    block->sampled_output_slow_size = sampled_output_slow.size();
+    {
+      std::lock_guard<std::mutex> lock(pc->mu);
+      block->compressed_done = true;
+    }
+    pc->done_cv.notify_all();
+  }
+}
+
+void BlockBasedTableBuilder::CompressDataBlockInParallel(
+    std::string&& raw_block_contents, std::vector<std::string>&& keys) {
+  ParallelCompressionRep* pc = rep_->pc_rep.get();
+  assert(!keys.empty());
+  std::unique_ptr<ParallelCompressionRep::BlockRep> block(
+      new ParallelCompressionRep::BlockRep);
+  block->raw = std::move(raw_block_contents);
+  block->keys = std::move(keys);
+  pc->inflight_bytes += block->raw.size();
+  {
+    std::lock_guard<std::mutex> lock(pc->mu);
+    pc->work_queue.push_back(block.get());
+  }
+  pc->blocks.push_back(std::move(block));
+  pc->work_cv.notify_one();
+  WriteCompressedDataBlocks(false /* all */);
+}
+
+void BlockBasedTableBuilder::WriteCompressedDataBlocks(bool all) {
+  Rep* r = rep_;
+  ParallelCompressionRep* pc = r->pc_rep.get();
+  const size_t ts_sz =
+      r->internal_comparator.user_comparator()->timestamp_size();
+  while (!pc->blocks.empty()) {
+    ParallelCompressionRep::BlockRep* block = pc->blocks.front().get();
+    // The index entry of a block needs the first key of the next one. The
+    // entry of the last block is added by Finish().
+    const bool has_next = pc->blocks.size() > 1;
+    if (!has_next && !all) {
+      break;
+    }
+    {
+      std::unique_lock<std::mutex> lock(pc->mu);
+      if (!block->compressed_done) {
+        if (!all && pc->inflight_bytes <= pc->max_inflight_bytes) {
+          break;
+        }
+        pc->done_cv.wait(lock, [block] { return block->compressed_done; });
+      }
+    }
+    if (ok()) {
+      for (const auto& key : block->keys) {
+        if (r->filter_builder != nullptr) {
+          r->filter_builder->Add(ExtractUserKeyAndStripTimestamp(key, ts_sz));
+        }
+        r->index_builder->OnKeyAdded(key);
+      }
+      if (block->raw.size() < kCompressionSizeLimit) {
+        NotifyCollectTableCollectorsOnBlockAdd(
+            r->table_properties_collectors, block->raw.size(),
+            block->sampled_output_fast_size, block->sampled_output_slow_size);
+      }
+      r->status = block->status;
+    }
+    if (ok()) {
+      WriteRawBlock(block->contents, block->type, &r->pending_handle,
+                    true /* is_data_block */);
+    }
+    if (ok()) {
+      if (r->filter_builder != nullptr) {
+        r->filter_builder->StartBlock(r->offset);
+      }
+      r->props.data_size = r->offset;
+      ++r->props.num_data_blocks;
+      pc->raw_bytes_written += block->raw.size();
+      pc->stored_bytes_written += block->contents.size() + kBlockTrailerSize;
+      if (has_next) {
+        Slice first_key_in_next_block = pc->blocks[1]->keys.front();
+        r->index_builder->AddIndexEntry(&block->keys.back(),
+                                        &first_key_in_next_block,
+                                        r->pending_handle);
+      }
+    }
+    pc->inflight_bytes -= block->raw.size();
+    pc->blocks.pop_front();
   }
 }
 
@@ -753,6 +1028,11 @@ void BlockBasedTableBuilder::WriteRawBlock(const Slice& block_contents,
         XXH64_freeState(state);
         break;
       }
+      case kXXH3:
+        EncodeFixed32(trailer_without_type,
+                      ComputeXXH3BlockChecksum(block_contents.data(),
+                                               block_contents.size(), type));
+        break;
     }
 
     assert(r->status.ok());
@@ -970,6 +1250,13 @@ void BlockBasedTableBuilder::WritePropertiesBlock(
                                          rep_->ioptions.info_log,
                                          &property_block_builder);
 
+    if (rep_->compression_dict_id != 0) {
+      std::string val;
+      PutFixed64(&val, rep_->compression_dict_id);
+      property_block_builder.Add(
+          BlockBasedTablePropertyNames::kCompressionDictId, val);
+    }
+
     WriteRawBlock(property_block_builder.Finish(), kNoCompression,
                   &properties_block_handle);
   }
@@ -1085,13 +1372,20 @@ void BlockBasedTableBuilder::EnterUnbuffered() {
   } else {
     dict = std::move(compression_dict_samples);
   }
-  r->compression_dict.reset(new CompressionDict(dict, r->compression_type,
-                                                r->compression_opts.level));
-  r->verify_dict.reset(new UncompressionDict(
-      dict, r->compression_type == kZSTD ||
-                r->compression_type == kZSTDNotFinalCompression));
+  if (r->compression_dict_store != nullptr && !dict.empty()) {
+    // The files written to the level after this one use it too
+    r->compression_dict_id =
+        r->compression_dict_store->Install(r->level_at_creation, dict)->id;
+  }
+  r->SetCompressionDict(dict);
 
   for (size_t i = 0; ok() && i < r->data_block_and_keys_buffers.size(); ++i) {
+    if (r->IsParallelCompressionEnabled()) {
+      CompressDataBlockInParallel(
+          std::move(r->data_block_and_keys_buffers[i].first),
+          std::move(r->data_block_and_keys_buffers[i].second));
+      continue;
+    }
     const auto& data_block = r->data_block_and_keys_buffers[i].first;
     auto& keys = r->data_block_and_keys_buffers[i].second;
     assert(!data_block.empty());
@@ -1123,6 +1417,10 @@ Status BlockBasedTableBuilder::Finish() {
   if (r->state == Rep::State::kBuffered) {
     EnterUnbuffered();
   }
+  if (r->IsParallelCompressionEnabled()) {
+    WriteCompressedDataBlocks(true /* all */);
+    StopParallelCompression();
+  }
   // To make sure properties block is able to keep the accurate size of index
   // block, we will finish writing all index entries first.
   if (ok() && !empty_data_block) {
@@ -1159,6 +1457,9 @@ Status BlockBasedTableBuilder::Finish() {
 
 void BlockBasedTableBuilder::Abandon() {
   assert(rep_->state != Rep::State::kClosed);
+  if (rep_->IsParallelCompressionEnabled()) {
+    StopParallelCompression();
+  }
   rep_->state = Rep::State::kClosed;
 }
 
@@ -1166,7 +1467,19 @@ uint64_t BlockBasedTableBuilder::NumEntries() const {
   return rep_->props.num_entries;
 }
 
-uint64_t BlockBasedTableBuilder::FileSize() const { return rep_->offset; }
+uint64_t BlockBasedTableBuilder::FileSize() const {
+  Rep* r = rep_;
+  if (!r->IsParallelCompressionEnabled() || r->pc_rep->inflight_bytes == 0) {
+    return r->offset;
+  }
+  const ParallelCompressionRep* pc = r->pc_rep.get();
+  double ratio = 1.0;
+  if (pc->raw_bytes_written > 0) {
+    ratio = static_cast<double>(pc->stored_bytes_written) /
+            static_cast<double>(pc->raw_bytes_written);
+  }
+  return r->offset + static_cast<uint64_t>(pc->inflight_bytes * ratio);
+}
 
 bool BlockBasedTableBuilder::NeedCompact() const {
   for (const auto& collector : rep_->table_properties_collectors) {
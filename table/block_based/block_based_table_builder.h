@@ -49,7 +49,8 @@ class BlockBasedTableBuilder : public TableBuilder {
       const CompressionOptions& compression_opts, const bool skip_filters,
       const std::string& column_family_name, const uint64_t creation_time = 0,
       const uint64_t oldest_key_time = 0, const uint64_t target_file_size = 0,
-      const uint64_t file_creation_time = 0);
+      const uint64_t file_creation_time = 0, const int level_at_creation = -1,
+      CompressionDictStore* compression_dict_store = nullptr);
 
   // No copying allowed
   BlockBasedTableBuilder(const BlockBasedTableBuilder&) = delete;
@@ -83,6 +84,8 @@ class BlockBasedTableBuilder : public TableBuilder {
 
   // Size of the file generated so far.  If invoked after a successful
   // Finish() call, returns the size of the final generated file.
+  // With parallel compression, the blocks not written out yet are counted
+  // at the compression ratio of the blocks written so far.
   uint64_t FileSize() const override;
 
   bool NeedCompact() const override;
@@ -105,6 +108,19 @@ class BlockBasedTableBuilder : public TableBuilder {
   // Compress and write block content to the file.
   void WriteBlock(const Slice& block_contents, BlockHandle* handle,
                   bool is_data_block);
+  // Compress a block, verifying the result if `verify_compression` is set.
+  // `*block_contents` points to `*compressed_output` or to `raw_block_contents`
+  // if the block is not compressed. Only reads the builder state, so it may be
+  // called from the parallel compression threads.
+  void CompressAndVerifyBlock(const Slice& raw_block_contents,
+                              bool is_data_block,
+                              const CompressionContext& compression_ctx,
+                              UncompressionContext* verify_ctx,
+                              std::string* compressed_output,
+                              Slice* block_contents, CompressionType* type,
+                              Status* out_status,
+                              std::string* sampled_output_fast,
+                              std::string* sampled_output_slow);
   // Directly write data to the file.
   void WriteRawBlock(const Slice& data, CompressionType, BlockHandle* handle,
                      bool is_data_block = false);
@@ -122,10 +138,25 @@ class BlockBasedTableBuilder : public TableBuilder {
                    BlockHandle& index_block_handle);
 
   struct Rep;
+  struct ParallelCompressionRep;
   class BlockBasedTablePropertiesCollectorFactory;
   class BlockBasedTablePropertiesCollector;
   Rep* rep_;
 
+  // Parallel compression, enabled by `CompressionOptions::parallel_threads`.
+  void StartParallelCompression();
+  void StopParallelCompression();
+  // Body of a compression thread.
+  void BGWorkCompression();
+  // Queue a data block and the keys in it for the compression threads.
+  void CompressDataBlockInParallel(std::string&& raw_block_contents,
+                                   std::vector<std::string>&& keys);
+  // Write out, in the order they were queued, the compressed data blocks at
+  // the head of the queue that are followed by another block. If `all`,
+  // waits for and writes every block queued; otherwise only waits for a
+  // block while the queued bytes exceed their limit.
+  void WriteCompressedDataBlocks(bool all);
+
   // Advanced operation: flush any buffered key/value pairs to file.
   // Can be used to ensure that two adjacent entries never live in
   // the same data block.  Most clients should not need to use this method.
@@ -222,7 +222,8 @@ TableBuilder* BlockBasedTableFactory::NewTableBuilder(
       table_builder_options.creation_time,
       table_builder_options.oldest_key_time,
       table_builder_options.target_file_size,
-      table_builder_options.file_creation_time);
+      table_builder_options.file_creation_time, table_builder_options.level,
+      table_builder_options.compression_dict_store);
 
   return table_builder;
 }
@@ -247,6 +248,12 @@ Status BlockBasedTableFactory::SanitizeOptions(
         "Enable pin_l0_filter_and_index_blocks_in_cache, "
         ", but block cache is disabled");
   }
+  if (table_options_.pin_filter_and_index_blocks_up_to_level >= 0 &&
+      table_options_.no_block_cache) {
+    return Status::InvalidArgument(
+        "Enable pin_filter_and_index_blocks_up_to_level, "
+        ", but block cache is disabled");
+  }
   if (!BlockBasedTableSupportedVersion(table_options_.format_version)) {
     return Status::InvalidArgument(
         "Unsupported BlockBasedTable format_version. Please check "
@@ -306,6 +313,13 @@ std::string BlockBasedTableFactory::GetPrintableTableOptions() const {
   snprintf(buffer, kBufferSize, "  pin_top_level_index_and_filter: %d\n",
            table_options_.pin_top_level_index_and_filter);
   ret.append(buffer);
+  snprintf(buffer, kBufferSize,
+           "  pin_filter_and_index_blocks_up_to_level: %d\n",
+           table_options_.pin_filter_and_index_blocks_up_to_level);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  load_partitions_in_background: %d\n",
+           table_options_.load_partitions_in_background);
+  ret.append(buffer);
   snprintf(buffer, kBufferSize, "  index_type: %d\n",
            table_options_.index_type);
   ret.append(buffer);
@@ -318,6 +332,9 @@ std::string BlockBasedTableFactory::GetPrintableTableOptions() const {
   snprintf(buffer, kBufferSize, "  data_block_hash_table_util_ratio: %lf\n",
            table_options_.data_block_hash_table_util_ratio);
   ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  data_block_column_layout: %d\n",
+           table_options_.data_block_column_layout);
+  ret.append(buffer);
   snprintf(buffer, kBufferSize, "  hash_index_allow_collision: %d\n",
            table_options_.hash_index_allow_collision);
   ret.append(buffer);
@@ -633,9 +650,13 @@ const std::string BlockBasedTablePropertyNames::kWholeKeyFiltering =
     "rocksdb.block.based.table.whole.key.filtering";
 const std::string BlockBasedTablePropertyNames::kPrefixFiltering =
     "rocksdb.block.based.table.prefix.filtering";
+const std::string BlockBasedTablePropertyNames::kCompressionDictId =
+    "rocksdb.block.based.table.compression.dict.id";
 const std::string kHashIndexPrefixesBlock = "rocksdb.hashindex.prefixes";
 const std::string kHashIndexPrefixesMetadataBlock =
     "rocksdb.hashindex.metadata";
+const std::string kInterpolationIndexModelBlock =
+    "rocksdb.interpolationindex.model";
 const std::string kPropTrue = "1";
 const std::string kPropFalse = "0";
 
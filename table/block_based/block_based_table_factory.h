@@ -84,6 +84,7 @@ class BlockBasedTableFactory : public TableFactory {
 
 extern const std::string kHashIndexPrefixesBlock;
 extern const std::string kHashIndexPrefixesMetadataBlock;
+extern const std::string kInterpolationIndexModelBlock;
 extern const std::string kPropTrue;
 extern const std::string kPropFalse;
 
@@ -115,6 +116,14 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct BlockBasedTableOptions,
                    pin_l0_filter_and_index_blocks_in_cache),
           OptionType::kBoolean, OptionVerificationType::kNormal, false, 0}},
+        {"pin_filter_and_index_blocks_up_to_level",
+         {offsetof(struct BlockBasedTableOptions,
+                   pin_filter_and_index_blocks_up_to_level),
+          OptionType::kInt, OptionVerificationType::kNormal, false, 0}},
+        {"load_partitions_in_background",
+         {offsetof(struct BlockBasedTableOptions,
+                   load_partitions_in_background),
+          OptionType::kBoolean, OptionVerificationType::kNormal, false, 0}},
         {"index_type",
          {offsetof(struct BlockBasedTableOptions, index_type),
           OptionType::kBlockBasedTableIndexType,
@@ -134,6 +143,9 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct BlockBasedTableOptions,
                    data_block_hash_table_util_ratio),
           OptionType::kDouble, OptionVerificationType::kNormal, false, 0}},
+        {"data_block_column_layout",
+         {offsetof(struct BlockBasedTableOptions, data_block_column_layout),
+          OptionType::kBoolean, OptionVerificationType::kNormal, false, 0}},
         {"checksum",
          {offsetof(struct BlockBasedTableOptions, checksum),
           OptionType::kChecksumType, OptionVerificationType::kNormal, false,
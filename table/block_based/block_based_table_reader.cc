@@ -10,7 +10,9 @@
 
 #include <algorithm>
 #include <array>
+#include <condition_variable>
 #include <limits>
+#include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
@@ -31,6 +33,7 @@
 #include "table/block_based/block.h"
 #include "table/block_based/block_based_filter_block.h"
 #include "table/block_based/block_based_table_factory.h"
+#include "table/block_based/block_interpolation_index.h"
 #include "table/block_based/block_prefix_index.h"
 #include "table/block_based/filter_block.h"
 #include "table/block_based/full_filter_block.h"
@@ -59,6 +62,7 @@ namespace rocksdb {
 extern const uint64_t kBlockBasedTableMagicNumber;
 extern const std::string kHashIndexPrefixesBlock;
 extern const std::string kHashIndexPrefixesMetadataBlock;
+extern const std::string kInterpolationIndexModelBlock;
 
 typedef BlockBasedTable::IndexReader IndexReader;
 
@@ -66,10 +70,69 @@ typedef BlockBasedTable::IndexReader IndexReader;
 // experiments, for auto readahead. Experiment data is in PR #3282.
 const size_t BlockBasedTable::kMaxAutoReadaheadSize = 256 * 1024;
 
+// The loading of the partitions of a table by a thread of the Env::USER
+// pool. Shared with the job, so that the table can be closed while the job is
+// still queued.
+struct BlockBasedTable::PartitionLoad {
+  enum State {
+    kScheduled,
+    kRunning,
+    kDone,
+    // The table was closed before the job started
+    kCancelled,
+  };
+
+  PartitionLoad(BlockBasedTable* _table, bool _pin)
+      : state(kScheduled), table(_table), pin(_pin) {}
+
+  std::mutex mu;
+  std::condition_variable cv;
+  State state;
+  BlockBasedTable* const table;
+  const bool pin;
+};
+
 BlockBasedTable::~BlockBasedTable() {
+  if (partition_load_ != nullptr) {
+    PartitionLoad* load = partition_load_.get();
+    std::unique_lock<std::mutex> lock(load->mu);
+    if (load->state == PartitionLoad::kScheduled) {
+      load->state = PartitionLoad::kCancelled;
+    } else {
+      load->cv.wait(lock,
+                    [load] { return load->state == PartitionLoad::kDone; });
+    }
+  }
   delete rep_;
 }
 
+void BlockBasedTable::BGLoadPartitions(void* arg) {
+  std::unique_ptr<std::shared_ptr<PartitionLoad>> load_ptr(
+      static_cast<std::shared_ptr<PartitionLoad>*>(arg));
+  PartitionLoad* load = load_ptr->get();
+  {
+    std::lock_guard<std::mutex> lock(load->mu);
+    if (load->state != PartitionLoad::kScheduled) {
+      return;
+    }
+    load->state = PartitionLoad::kRunning;
+  }
+  load->table->LoadPartitions(load->pin);
+  {
+    std::lock_guard<std::mutex> lock(load->mu);
+    load->state = PartitionLoad::kDone;
+  }
+  load->cv.notify_all();
+}
+
+void BlockBasedTable::LoadPartitions(bool pin) {
+  rep_->index_reader->CacheDependencies(pin);
+  if (rep_->filter) {
+    rep_->filter->CacheDependencies(pin);
+  }
+  TEST_SYNC_POINT("BlockBasedTable::LoadPartitions:Done");
+}
+
 std::atomic<uint64_t> BlockBasedTable::next_cache_key_id_(0);
 
 template <typename TBlocklike>
@@ -89,6 +152,10 @@ class BlocklikeTraits<BlockContents> {
   static uint32_t GetNumRestarts(const BlockContents& /* contents */) {
     return 0;
   }
+
+  static Slice GetRawContents(const BlockContents& contents) {
+    return contents.data;
+  }
 };
 
 template <>
@@ -104,6 +171,10 @@ class BlocklikeTraits<Block> {
   static uint32_t GetNumRestarts(const Block& block) {
     return block.NumRestarts();
   }
+
+  static Slice GetRawContents(const Block& block) {
+    return Slice(block.data(), block.size());
+  }
 };
 
 template <>
@@ -121,6 +192,10 @@ class BlocklikeTraits<UncompressionDict> {
   static uint32_t GetNumRestarts(const UncompressionDict& /* dict */) {
     return 0;
   }
+
+  static Slice GetRawContents(const UncompressionDict& dict) {
+    return dict.GetRawDict();
+  }
 };
 
 namespace {
@@ -178,6 +253,68 @@ void DeleteCachedEntry(const Slice& /*key*/, void* value) {
   delete entry;
 }
 
+// Serialize the entry resided in the cache for a secondary cache tier, as
+// its uncompressed block contents.
+template <class Entry>
+size_t SizeOfCachedEntry(void* value) {
+  return BlocklikeTraits<Entry>::GetRawContents(*reinterpret_cast<Entry*>(value))
+      .size();
+}
+
+template <class Entry>
+Status SaveCachedEntryTo(void* from_obj, size_t from_offset, size_t length,
+                         void* out) {
+  Slice raw =
+      BlocklikeTraits<Entry>::GetRawContents(*reinterpret_cast<Entry*>(from_obj));
+  assert(from_offset + length <= raw.size());
+  memcpy(out, raw.data() + from_offset, length);
+  return Status::OK();
+}
+
+template <class Entry>
+const Cache::CacheItemHelper* GetCacheItemHelper() {
+  static const Cache::CacheItemHelper helper(&SizeOfCachedEntry<Entry>,
+                                             &SaveCachedEntryTo<Entry>,
+                                             &DeleteCachedEntry<Entry>);
+  return &helper;
+}
+
+// What a block found in a secondary cache tier is recreated with. The
+// create callback only refers to it, so that building the callback on every
+// lookup does not allocate.
+struct CachedEntryCreateContext {
+  MemoryAllocator* allocator;
+  SequenceNumber global_seqno;
+  size_t read_amp_bytes_per_bit;
+  Statistics* statistics;
+  bool using_zstd;
+};
+
+// Recreates the entry from the uncompressed block contents saved by
+// SaveCachedEntryTo().
+template <class Entry>
+Status CreateCachedEntry(const CachedEntryCreateContext& ctx, const void* buf,
+                         size_t size, void** out_obj, size_t* charge) {
+  CacheAllocationPtr allocation = AllocateBlock(size, ctx.allocator);
+  memcpy(allocation.get(), buf, size);
+  std::unique_ptr<Entry> holder(BlocklikeTraits<Entry>::Create(
+      BlockContents(std::move(allocation), size), ctx.global_seqno,
+      ctx.read_amp_bytes_per_bit, ctx.statistics, ctx.using_zstd));
+  *charge = holder->ApproximateMemoryUsage();
+  *out_obj = holder.release();
+  return Status::OK();
+}
+
+Cache::Priority GetCachePriority(const BlockBasedTableOptions& table_options,
+                                 BlockType block_type) {
+  return table_options.cache_index_and_filter_blocks_with_high_priority &&
+                 (block_type == BlockType::kFilter ||
+                  block_type == BlockType::kCompressionDictionary ||
+                  block_type == BlockType::kIndex)
+             ? Cache::Priority::HIGH
+             : Cache::Priority::LOW;
+}
+
 // Release the cached entry and decrement its ref count.
 void ForceReleaseCachedEntry(void* arg, void* h) {
   Cache* cache = reinterpret_cast<Cache*>(arg);
@@ -395,7 +532,7 @@ class PartitionIndexReader : public BlockBasedTable::IndexReaderCommon {
 
     Statistics* kNullStats = nullptr;
     // Filters are already checked before seeking the index
-    if (!partition_map_.empty()) {
+    if (partition_map_ready_.load(std::memory_order_acquire)) {
       // We don't return pinned data from index blocks, so no need
       // to set `block_contents_pinned`.
       it = NewTwoLevelIterator(
@@ -485,6 +622,7 @@ class PartitionIndexReader : public BlockBasedTable::IndexReaderCommon {
     // After prefetch, read the partitions one by one
     biter.SeekToFirst();
     auto ro = ReadOptions();
+    std::unordered_map<uint64_t, CachableEntry<Block>> partition_map;
     for (; biter.Valid(); biter.Next()) {
       handle = biter.value().handle;
       CachableEntry<Block> block;
@@ -499,11 +637,15 @@ class PartitionIndexReader : public BlockBasedTable::IndexReaderCommon {
       if (s.ok() && block.GetValue() != nullptr) {
         if (block.IsCached()) {
           if (pin) {
-            partition_map_[handle.offset()] = std::move(block);
+            partition_map[handle.offset()] = std::move(block);
           }
         }
       }
     }
+    if (!partition_map.empty()) {
+      partition_map_ = std::move(partition_map);
+      partition_map_ready_.store(true, std::memory_order_release);
+    }
   }
 
   size_t ApproximateMemoryUsage() const override {
@@ -522,7 +664,10 @@ class PartitionIndexReader : public BlockBasedTable::IndexReaderCommon {
                        CachableEntry<Block>&& index_block)
       : IndexReaderCommon(t, std::move(index_block)) {}
 
+  // The pinned partitions. They may be loaded by a background thread, so they
+  // are only looked at once partition_map_ready_ is set.
   std::unordered_map<uint64_t, CachableEntry<Block>> partition_map_;
+  std::atomic<bool> partition_map_ready_{false};
 };
 
 // Index that allows binary search lookup for the first key of each block.
@@ -764,6 +909,136 @@ class HashIndexReader : public BlockBasedTable::IndexReaderCommon {
   std::unique_ptr<BlockPrefixIndex> prefix_index_;
 };
 
+// Index that narrows the binary search of the index block with a model of its
+// keys, see BlockInterpolationIndex.
+class InterpolationIndexReader : public BlockBasedTable::IndexReaderCommon {
+ public:
+  static Status Create(const BlockBasedTable* table,
+                       FilePrefetchBuffer* prefetch_buffer,
+                       InternalIterator* meta_index_iter, bool use_cache,
+                       bool prefetch, bool pin,
+                       BlockCacheLookupContext* lookup_context,
+                       std::unique_ptr<IndexReader>* index_reader) {
+    assert(table != nullptr);
+    assert(index_reader != nullptr);
+    assert(!pin || prefetch);
+
+    const BlockBasedTable::Rep* rep = table->get_rep();
+    assert(rep != nullptr);
+
+    CachableEntry<Block> index_block;
+    if (prefetch || !use_cache) {
+      const Status s =
+          ReadIndexBlock(table, prefetch_buffer, ReadOptions(), use_cache,
+                         /*get_context=*/nullptr, lookup_context, &index_block);
+      if (!s.ok()) {
+        return s;
+      }
+
+      if (use_cache && !pin) {
+        index_block.Reset();
+      }
+    }
+
+    index_reader->reset(
+        new InterpolationIndexReader(table, std::move(index_block)));
+
+    // Tables of comparators other than the bytewise one have no model, and
+    // failing to read it is not a hard error either; the index block is then
+    // binary searched as a whole.
+    BlockHandle model_handle;
+    Status s = FindMetaBlock(meta_index_iter, kInterpolationIndexModelBlock,
+                             &model_handle);
+    if (!s.ok()) {
+      return Status::OK();
+    }
+
+    BlockContents model_contents;
+    BlockFetcher model_block_fetcher(
+        rep->file.get(), prefetch_buffer, rep->footer, ReadOptions(),
+        model_handle, &model_contents, rep->ioptions, true /*decompress*/,
+        true /*maybe_compressed*/, BlockType::kInterpolationIndexModel,
+        UncompressionDict::GetEmptyDict(), rep->persistent_cache_options,
+        GetMemoryAllocator(rep->table_options));
+    s = model_block_fetcher.ReadBlockContents();
+    if (!s.ok()) {
+      ROCKS_LOG_WARN(rep->ioptions.info_log,
+                     "Unable to read the interpolation index model: %s",
+                     s.ToString().c_str());
+      return Status::OK();
+    }
+
+    BlockInterpolationIndex* interpolation_index = nullptr;
+    s = BlockInterpolationIndex::Create(model_contents.data,
+                                        &interpolation_index);
+    if (s.ok()) {
+      InterpolationIndexReader* const interpolation_index_reader =
+          static_cast<InterpolationIndexReader*>(index_reader->get());
+      interpolation_index_reader->interpolation_index_.reset(
+          interpolation_index);
+    } else {
+      ROCKS_LOG_WARN(rep->ioptions.info_log,
+                     "Unable to create the interpolation index: %s",
+                     s.ToString().c_str());
+    }
+
+    return Status::OK();
+  }
+
+  InternalIteratorBase<IndexValue>* NewIterator(
+      const ReadOptions& read_options, bool /* disable_prefix_seek */,
+      IndexBlockIter* iter, GetContext* get_context,
+      BlockCacheLookupContext* lookup_context) override {
+    const bool no_io = (read_options.read_tier == kBlockCacheTier);
+    CachableEntry<Block> index_block;
+    const Status s =
+        GetOrReadIndexBlock(no_io, get_context, lookup_context, &index_block);
+    if (!s.ok()) {
+      if (iter != nullptr) {
+        iter->Invalidate(s);
+        return iter;
+      }
+
+      return NewErrorInternalIterator<IndexValue>(s);
+    }
+
+    Statistics* kNullStats = nullptr;
+    // We don't return pinned data from index blocks, so no need
+    // to set `block_contents_pinned`.
+    auto it = index_block.GetValue()->NewIndexIterator(
+        internal_comparator(), internal_comparator()->user_comparator(), iter,
+        kNullStats, true, index_has_first_key(), index_key_includes_seq(),
+        index_value_is_full(), false /* block_contents_pinned */,
+        nullptr /* prefix_index */, interpolation_index_.get());
+
+    assert(it != nullptr);
+    index_block.TransferTo(it);
+
+    return it;
+  }
+
+  size_t ApproximateMemoryUsage() const override {
+    size_t usage = ApproximateIndexBlockMemoryUsage();
+#ifdef ROCKSDB_MALLOC_USABLE_SIZE
+    usage +=
+        malloc_usable_size(const_cast<InterpolationIndexReader*>(this));
+#else
+    usage += sizeof(*this);
+#endif  // ROCKSDB_MALLOC_USABLE_SIZE
+    if (interpolation_index_) {
+      usage += interpolation_index_->ApproximateMemoryUsage();
+    }
+    return usage;
+  }
+
+ private:
+  InterpolationIndexReader(const BlockBasedTable* t,
+                           CachableEntry<Block>&& index_block)
+      : IndexReaderCommon(t, std::move(index_block)) {}
+
+  std::unique_ptr<BlockInterpolationIndex> interpolation_index_;
+};
+
 void BlockBasedTable::UpdateCacheHitMetrics(BlockType block_type,
                                             GetContext* get_context,
                                             size_t usage) const {
@@ -938,8 +1213,10 @@ void BlockBasedTable::UpdateCacheInsertionMetrics(BlockType block_type,
 
 Cache::Handle* BlockBasedTable::GetEntryFromCache(
     Cache* block_cache, const Slice& key, BlockType block_type,
-    GetContext* get_context) const {
-  auto cache_handle = block_cache->Lookup(key, rep_->ioptions.statistics);
+    GetContext* get_context, const Cache::CacheItemHelper* helper,
+    const Cache::CreateCallback& create_cb, Cache::Priority priority) const {
+  auto cache_handle = block_cache->LookupWithHelper(
+      key, helper, create_cb, priority, rep_->ioptions.statistics);
 
   if (cache_handle != nullptr) {
     UpdateCacheHitMetrics(block_type, get_context,
@@ -1104,6 +1381,29 @@ Slice BlockBasedTable::GetCacheKey(const char* cache_key_prefix,
   return Slice(cache_key, static_cast<size_t>(end - cache_key));
 }
 
+Slice BlockBasedTable::GetSharedCompressionDictCacheKey(uint64_t dict_id,
+                                                        char* cache_key) {
+  static const char kPrefix[] = "rocksdb.compression.dict.";
+  static const size_t kPrefixSize = sizeof(kPrefix) - 1;
+  static_assert(kPrefixSize + sizeof(uint64_t) <=
+                    kMaxCacheKeyPrefixSize + kMaxVarint64Length,
+                "shared compression dictionary cache key too long");
+  assert(cache_key != nullptr);
+  memcpy(cache_key, kPrefix, kPrefixSize);
+  EncodeFixed64(cache_key + kPrefixSize, dict_id);
+  return Slice(cache_key, kPrefixSize + sizeof(uint64_t));
+}
+
+// Whether all the index and filter blocks of a file at `level`, including
+// the partitions, are pinned in the block cache
+static bool PinIndexAndFilterBlocks(const BlockBasedTableOptions& table_options,
+                                    int level) {
+  return (table_options.pin_l0_filter_and_index_blocks_in_cache &&
+          level == 0) ||
+         (level >= 0 &&
+          level <= table_options.pin_filter_and_index_blocks_up_to_level);
+}
+
 Status BlockBasedTable::Open(
     const ImmutableCFOptions& ioptions, const EnvOptions& env_options,
     const BlockBasedTableOptions& table_options,
@@ -1122,7 +1422,8 @@ Status BlockBasedTable::Open(
   std::unique_ptr<FilePrefetchBuffer> prefetch_buffer;
 
   // prefetch both index and filters, down to all partitions
-  const bool prefetch_all = prefetch_index_and_filter_in_cache || level == 0;
+  const bool prefetch_all = prefetch_index_and_filter_in_cache || level == 0 ||
+                            PinIndexAndFilterBlocks(table_options, level);
   const bool preload_all = !table_options.cache_index_and_filter_blocks;
 
   s = PrefetchTail(file.get(), file_size, tail_prefetch_stats, prefetch_all,
@@ -1278,6 +1579,10 @@ Status VerifyChecksum(const ChecksumType type, const char* buf, size_t len,
       actual = static_cast<uint32_t>(XXH64(buf, static_cast<int>(len), 0) &
                                      uint64_t{0xffffffff});
       break;
+    case kXXH3:
+      // The block is followed by its compression type
+      actual = ComputeXXH3BlockChecksum(buf, len - 1, buf[len - 1]);
+      break;
     default:
       s = Status::Corruption("unknown checksum type");
   }
@@ -1406,6 +1711,10 @@ Status BlockBasedTable::ReadPropertiesBlock(
       rep_->index_type = static_cast<BlockBasedTableOptions::IndexType>(
           DecodeFixed32(pos->second.c_str()));
     }
+    pos = props.find(BlockBasedTablePropertyNames::kCompressionDictId);
+    if (pos != props.end() && pos->second.size() == sizeof(uint64_t)) {
+      rep_->compression_dict_id = DecodeFixed64(pos->second.c_str());
+    }
 
     rep_->index_has_first_key =
         rep_->index_type == BlockBasedTableOptions::kBinarySearchWithFirstKey;
@@ -1503,8 +1812,7 @@ Status BlockBasedTable::PrefetchIndexAndFilterBlocks(
   const bool use_cache = table_options.cache_index_and_filter_blocks;
 
   // pin both index and filters, down to all partitions
-  const bool pin_all =
-      rep_->table_options.pin_l0_filter_and_index_blocks_in_cache && level == 0;
+  const bool pin_all = PinIndexAndFilterBlocks(rep_->table_options, level);
 
   // prefetch the first level of index
   const bool prefetch_index =
@@ -1526,13 +1834,6 @@ Status BlockBasedTable::PrefetchIndexAndFilterBlocks(
 
   rep_->index_reader = std::move(index_reader);
 
-  // The partitions of partitioned index are always stored in cache. They
-  // are hence follow the configuration for pin and prefetch regardless of
-  // the value of cache_index_and_filter_blocks
-  if (prefetch_all) {
-    rep_->index_reader->CacheDependencies(pin_all);
-  }
-
   // prefetch the first level of filter
   const bool prefetch_filter =
       prefetch_all ||
@@ -1550,15 +1851,27 @@ Status BlockBasedTable::PrefetchIndexAndFilterBlocks(
         prefetch_buffer, use_cache, prefetch_filter, pin_filter,
         lookup_context);
     if (filter) {
-      // Refer to the comment above about paritioned indexes always being cached
-      if (prefetch_all) {
-        filter->CacheDependencies(pin_all);
-      }
-
       rep_->filter = std::move(filter);
     }
   }
 
+  // The partitions of partitioned index and filters are always stored in
+  // cache. They hence follow the configuration for pin and prefetch
+  // regardless of the value of cache_index_and_filter_blocks
+  if (prefetch_all) {
+    Env* env = rep_->ioptions.env;
+    if (table_options.load_partitions_in_background &&
+        index_type == BlockBasedTableOptions::kTwoLevelIndexSearch &&
+        env->GetBackgroundThreads(Env::Priority::USER) > 0) {
+      partition_load_ = std::make_shared<PartitionLoad>(this, pin_all);
+      env->Schedule(&BlockBasedTable::BGLoadPartitions,
+                    new std::shared_ptr<PartitionLoad>(partition_load_),
+                    Env::Priority::USER);
+    } else {
+      LoadPartitions(pin_all);
+    }
+  }
+
   if (!rep_->compression_dict_handle.IsNull()) {
     std::unique_ptr<UncompressionDictReader> uncompression_dict_reader;
     s = UncompressionDictReader::Create(this, prefetch_buffer, use_cache,
@@ -1661,11 +1974,27 @@ Status BlockBasedTable::GetDataBlockFromCache(
   Status s;
   BlockContents* compressed_block = nullptr;
   Cache::Handle* block_cache_compressed_handle = nullptr;
+  Statistics* statistics = rep_->ioptions.statistics;
 
   // Lookup uncompressed cache first
   if (block_cache != nullptr) {
-    auto cache_handle = GetEntryFromCache(block_cache, block_cache_key,
-                                          block_type, get_context);
+    // Recreates the block from its uncompressed contents if it is found in
+    // a secondary cache tier of block_cache
+    const CachedEntryCreateContext create_ctx{
+        block_cache->memory_allocator(), rep_->get_global_seqno(block_type),
+        read_amp_bytes_per_bit, statistics,
+        rep_->blocks_definitely_zstd_compressed};
+    Cache::CreateCallback create_cb = [&create_ctx](const void* buf,
+                                                    size_t size,
+                                                    void** out_obj,
+                                                    size_t* charge) {
+      return CreateCachedEntry<TBlocklike>(create_ctx, buf, size, out_obj,
+                                           charge);
+    };
+    auto cache_handle = GetEntryFromCache(
+        block_cache, block_cache_key, block_type, get_context,
+        GetCacheItemHelper<TBlocklike>(), create_cb,
+        GetCachePriority(rep_->table_options, block_type));
     if (cache_handle != nullptr) {
       block->SetCachedValue(
           reinterpret_cast<TBlocklike*>(block_cache->Value(cache_handle)),
@@ -1685,8 +2014,6 @@ Status BlockBasedTable::GetDataBlockFromCache(
   block_cache_compressed_handle =
       block_cache_compressed->Lookup(compressed_block_cache_key);
 
-  Statistics* statistics = rep_->ioptions.statistics;
-
   // if we found in the compressed cache, then uncompress and insert into
   // uncompressed cache
   if (block_cache_compressed_handle == nullptr) {
@@ -1722,8 +2049,9 @@ Status BlockBasedTable::GetDataBlockFromCache(
         read_options.fill_cache) {
       size_t charge = block_holder->ApproximateMemoryUsage();
       Cache::Handle* cache_handle = nullptr;
-      s = block_cache->Insert(block_cache_key, block_holder.get(), charge,
-                              &DeleteCachedEntry<TBlocklike>, &cache_handle);
+      s = block_cache->InsertWithHelper(block_cache_key, block_holder.get(),
+                                        GetCacheItemHelper<TBlocklike>(),
+                                        charge, &cache_handle);
       if (s.ok()) {
         assert(cache_handle != nullptr);
         block->SetCachedValue(block_holder.release(), block_cache,
@@ -1759,12 +2087,7 @@ Status BlockBasedTable::PutDataBlockToCache(
           ? rep_->table_options.read_amp_bytes_per_bit
           : 0;
   const Cache::Priority priority =
-      rep_->table_options.cache_index_and_filter_blocks_with_high_priority &&
-              (block_type == BlockType::kFilter ||
-               block_type == BlockType::kCompressionDictionary ||
-               block_type == BlockType::kIndex)
-          ? Cache::Priority::HIGH
-          : Cache::Priority::LOW;
+      GetCachePriority(rep_->table_options, block_type);
   assert(cached_block);
   assert(cached_block->IsEmpty());
 
@@ -1824,9 +2147,9 @@ Status BlockBasedTable::PutDataBlockToCache(
   if (block_cache != nullptr && block_holder->own_bytes()) {
     size_t charge = block_holder->ApproximateMemoryUsage();
     Cache::Handle* cache_handle = nullptr;
-    s = block_cache->Insert(block_cache_key, block_holder.get(), charge,
-                            &DeleteCachedEntry<TBlocklike>, &cache_handle,
-                            priority);
+    s = block_cache->InsertWithHelper(block_cache_key, block_holder.get(),
+                                      GetCacheItemHelper<TBlocklike>(), charge,
+                                      &cache_handle, priority);
     if (s.ok()) {
       assert(cache_handle != nullptr);
       cached_block->SetCachedValue(block_holder.release(), block_cache,
@@ -2113,8 +2436,14 @@ Status BlockBasedTable::MaybeReadBlockAndLoadToCache(
   if (block_cache != nullptr || block_cache_compressed != nullptr) {
     // create key for block cache
     if (block_cache != nullptr) {
-      key = GetCacheKey(rep_->cache_key_prefix, rep_->cache_key_prefix_size,
-                        handle, cache_key);
+      if (block_type == BlockType::kCompressionDictionary &&
+          rep_->compression_dict_id != 0) {
+        key = GetSharedCompressionDictCacheKey(rep_->compression_dict_id,
+                                               cache_key);
+      } else {
+        key = GetCacheKey(rep_->cache_key_prefix, rep_->cache_key_prefix_size,
+                          handle, cache_key);
+      }
     }
 
     if (block_cache_compressed != nullptr) {
@@ -2878,13 +3207,19 @@ void BlockBasedTableIterator<TBlockIter, TValue>::InitDataBlock() {
     //   Enabled after 2 sequential IOs when ReadOptions.readahead_size == 0.
     // Explicit user requested readahead:
     //   Enabled from the very first IO when ReadOptions.readahead_size is set.
+    // With ReadOptions.async_readahead, a FilePrefetchBuffer reads the next
+    // window in the background for both, and for buffered I/O as well.
+    Env* async_env =
+        read_options_.async_readahead && !rep->ioptions.allow_mmap_reads
+            ? rep->ioptions.env
+            : nullptr;
     if (lookup_context_.caller != TableReaderCaller::kCompaction) {
       if (read_options_.readahead_size == 0) {
         // Implicit auto readahead
         num_file_reads_++;
         if (num_file_reads_ >
             BlockBasedTable::kMinNumFileReadsToStartAutoReadahead) {
-          if (!rep->file->use_direct_io() &&
+          if (!rep->file->use_direct_io() && async_env == nullptr &&
               (data_block_handle.offset() +
                    static_cast<size_t>(block_size(data_block_handle)) >
                readahead_limit_)) {
@@ -2898,12 +3233,14 @@ void BlockBasedTableIterator<TBlockIter, TValue>::InitDataBlock() {
             // kMaxAutoReadaheadSize.
             readahead_size_ = std::min(BlockBasedTable::kMaxAutoReadaheadSize,
                                        readahead_size_ * 2);
-          } else if (rep->file->use_direct_io() && !prefetch_buffer_) {
-            // Direct I/O
+          } else if ((rep->file->use_direct_io() || async_env != nullptr) &&
+                     !prefetch_buffer_) {
+            // Direct I/O or asynchronous readahead
             // Let FilePrefetchBuffer take care of the readahead.
             prefetch_buffer_.reset(new FilePrefetchBuffer(
                 rep->file.get(), BlockBasedTable::kInitAutoReadaheadSize,
-                BlockBasedTable::kMaxAutoReadaheadSize));
+                BlockBasedTable::kMaxAutoReadaheadSize, true /* enable */,
+                false /* track_min_offset */, async_env));
           }
         }
       } else if (!prefetch_buffer_) {
@@ -2912,12 +3249,14 @@ void BlockBasedTableIterator<TBlockIter, TValue>::InitDataBlock() {
         // if (read_options_.readahead_size != 0 && !prefetch_buffer_)
         prefetch_buffer_.reset(new FilePrefetchBuffer(
             rep->file.get(), read_options_.readahead_size,
-            read_options_.readahead_size));
+            read_options_.readahead_size, true /* enable */,
+            false /* track_min_offset */, async_env));
       }
     } else if (!prefetch_buffer_) {
-      prefetch_buffer_.reset(
-          new FilePrefetchBuffer(rep->file.get(), compaction_readahead_size_,
-                                 compaction_readahead_size_));
+      prefetch_buffer_.reset(new FilePrefetchBuffer(
+          rep->file.get(), compaction_readahead_size_,
+          compaction_readahead_size_, true /* enable */,
+          false /* track_min_offset */, async_env));
     }
 
     Status s;
@@ -3808,6 +4147,10 @@ BlockType BlockBasedTable::GetBlockTypeForMetaBlockByName(
     return BlockType::kHashIndexMetadata;
   }
 
+  if (meta_block_name == kInterpolationIndexModelBlock) {
+    return BlockType::kInterpolationIndexModel;
+  }
+
   assert(false);
   return BlockType::kInvalid;
 }
@@ -3932,6 +4275,27 @@ Status BlockBasedTable::CreateIndexReader(
                                      use_cache, prefetch, pin, lookup_context,
                                      index_reader);
     }
+    case BlockBasedTableOptions::kInterpolationSearch: {
+      std::unique_ptr<Block> meta_guard;
+      std::unique_ptr<InternalIterator> meta_iter_guard;
+      auto meta_index_iter = preloaded_meta_index_iter;
+      if (meta_index_iter == nullptr) {
+        auto s = ReadMetaBlock(prefetch_buffer, &meta_guard, &meta_iter_guard);
+        if (!s.ok()) {
+          ROCKS_LOG_WARN(rep_->ioptions.info_log,
+                         "Unable to read the metaindex block."
+                         " Fall back to binary search index.");
+          return BinarySearchIndexReader::Create(this, prefetch_buffer,
+                                                 use_cache, prefetch, pin,
+                                                 lookup_context, index_reader);
+        }
+        meta_index_iter = meta_iter_guard.get();
+      }
+
+      return InterpolationIndexReader::Create(
+          this, prefetch_buffer, meta_index_iter, use_cache, prefetch, pin,
+          lookup_context, index_reader);
+    }
     default: {
       std::string error_message =
           "Unrecognized index type: " + ToString(rep_->index_type);
@@ -4003,6 +4367,62 @@ uint64_t BlockBasedTable::ApproximateSize(const Slice& start, const Slice& end,
   return end_offset - start_offset;
 }
 
+Status BlockBasedTable::ApproximateKeyAnchors(const ReadOptions& read_options,
+                                              size_t max_anchors,
+                                              std::vector<Anchor>* anchors) {
+  assert(anchors != nullptr);
+  if (max_anchors == 0) {
+    return Status::OK();
+  }
+
+  // This walks the whole index, which is cheap next to reading the data
+  // blocks that the caller is about to compact anyway.
+  BlockCacheLookupContext context(TableReaderCaller::kCompaction);
+  ReadOptions ro = read_options;
+  ro.total_order_seek = true;
+  IndexBlockIter iiter_on_stack;
+  auto index_iter =
+      NewIndexIterator(ro, /*disable_prefix_seek=*/true,
+                       /*input_iter=*/&iiter_on_stack, /*get_context=*/nullptr,
+                       /*lookup_context=*/&context);
+  std::unique_ptr<InternalIteratorBase<IndexValue>> iiter_unique_ptr;
+  if (index_iter != &iiter_on_stack) {
+    iiter_unique_ptr.reset(index_iter);
+  }
+
+  uint64_t num_blocks = 0;
+  for (index_iter->SeekToFirst(); index_iter->Valid(); index_iter->Next()) {
+    num_blocks++;
+  }
+  if (!index_iter->status().ok()) {
+    return index_iter->status();
+  }
+  if (num_blocks == 0) {
+    return Status::OK();
+  }
+
+  // Emit an anchor every blocks_per_anchor data blocks, and always one for
+  // the last block so the anchors cover the whole table.
+  const uint64_t blocks_per_anchor =
+      (num_blocks + max_anchors - 1) / max_anchors;
+  uint64_t block_index = 0;
+  uint64_t prev_end_offset = 0;
+  for (index_iter->SeekToFirst(); index_iter->Valid(); index_iter->Next()) {
+    block_index++;
+    if (block_index % blocks_per_anchor != 0 && block_index != num_blocks) {
+      continue;
+    }
+    const BlockHandle handle = index_iter->value().handle;
+    const uint64_t end_offset = handle.offset() + handle.size();
+    anchors->emplace_back(index_iter->user_key(),
+                          end_offset > prev_end_offset
+                              ? end_offset - prev_end_offset
+                              : 0);
+    prev_end_offset = end_offset;
+  }
+  return index_iter->status();
+}
+
 bool BlockBasedTable::TEST_FilterBlockInCache() const {
   assert(rep_ != nullptr);
   return TEST_BlockInCache(rep_->filter_handle);
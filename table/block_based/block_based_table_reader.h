@@ -172,6 +172,12 @@ class BlockBasedTable : public TableReader {
   uint64_t ApproximateSize(const Slice& start, const Slice& end,
                            TableReaderCaller caller) override;
 
+  // Samples the anchors from the index, so every anchor is the separator key
+  // that ends a data block.
+  Status ApproximateKeyAnchors(const ReadOptions& read_options,
+                               size_t max_anchors,
+                               std::vector<Anchor>* anchors) override;
+
   bool TEST_BlockInCache(const BlockHandle& handle) const;
 
   // Returns true if the block for the specified key is in cache.
@@ -229,6 +235,12 @@ class BlockBasedTable : public TableReader {
                            size_t cache_key_prefix_size,
                            const BlockHandle& handle, char* cache_key);
 
+  // The block cache key of a shared compression dictionary, the same for all
+  // the files that use it. `cache_key` must have room for
+  // kMaxCacheKeyPrefixSize + kMaxVarint64Length bytes.
+  static Slice GetSharedCompressionDictCacheKey(uint64_t dict_id,
+                                                char* cache_key);
+
   // Retrieve all key value pairs from data blocks in the table.
   // The key retrieved are internal keys.
   Status GetKVPairsFromDataBlocks(std::vector<KVPairBlock>* kv_pair_blocks);
@@ -274,15 +286,29 @@ class BlockBasedTable : public TableReader {
   static std::atomic<uint64_t> next_cache_key_id_;
   BlockCacheTracer* const block_cache_tracer_;
 
+  struct PartitionLoad;
+  // Set if the partitions are loaded in the background
+  std::shared_ptr<PartitionLoad> partition_load_;
+
+  // Loads the partitions of partitioned index and filter blocks into the
+  // block cache, pinning them if `pin`.
+  void LoadPartitions(bool pin);
+  static void BGLoadPartitions(void* arg);
+
   void UpdateCacheHitMetrics(BlockType block_type, GetContext* get_context,
                              size_t usage) const;
   void UpdateCacheMissMetrics(BlockType block_type,
                               GetContext* get_context) const;
   void UpdateCacheInsertionMetrics(BlockType block_type,
                                    GetContext* get_context, size_t usage) const;
+  // helper, create_cb and priority are for a secondary cache tier of
+  // block_cache, see Cache::LookupWithHelper().
   Cache::Handle* GetEntryFromCache(Cache* block_cache, const Slice& key,
                                    BlockType block_type,
-                                   GetContext* get_context) const;
+                                   GetContext* get_context,
+                                   const Cache::CacheItemHelper* helper,
+                                   const Cache::CreateCallback& create_cb,
+                                   Cache::Priority priority) const;
 
   // Either Block::NewDataIterator() or Block::NewIndexIterator().
   template <typename TBlockIter>
@@ -538,6 +564,10 @@ struct BlockBasedTable::Rep {
   FilterType filter_type;
   BlockHandle filter_handle;
   BlockHandle compression_dict_handle;
+  // Id of the shared compression dictionary of the file, or 0 if the file
+  // has its own. The files of a shared dictionary share its block cache
+  // entry.
+  uint64_t compression_dict_id = 0;
 
   std::shared_ptr<const TableProperties> table_properties;
   BlockBasedTableOptions::IndexType index_type;
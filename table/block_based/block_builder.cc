@@ -30,6 +30,26 @@
 //     restarts: uint32[num_restarts]
 //     num_restarts: uint32
 // restarts[i] contains the offset within the block of the ith restart point.
+//
+// Data blocks of the column layout keep the keys and the values in two
+// separate arrays, so that the values are contiguous and their lengths are
+// not decoded entry by entry:
+//     keys: entry[num_entries]
+//     restarts: uint32[num_restarts]
+//     values: char[]
+//     value_ends: uint32[num_entries]
+//     num_entries: uint32
+//     value_width: uint32
+//     restart_interval: uint32
+//     values_offset: uint32
+//     num_restarts: uint32
+// where each entry is a key as above, without value_length and value. Every
+// restart interval but the last holds restart_interval entries, so the index
+// of an entry follows from its restart point. If all the values have the
+// same length, value_width is that length, value_ends is left out and the
+// ith value starts at i * value_width. Otherwise value_width is
+// kColumnLayoutVariableValueWidth and value_ends[i] is the offset just past
+// the ith value. values_offset is the offset of values within the block.
 
 #include "table/block_based/block_builder.h"
 
@@ -46,36 +66,48 @@ BlockBuilder::BlockBuilder(
     int block_restart_interval, bool use_delta_encoding,
     bool use_value_delta_encoding,
     BlockBasedTableOptions::DataBlockIndexType index_type,
-    double data_block_hash_table_util_ratio)
+    double data_block_hash_table_util_ratio, bool column_layout)
     : block_restart_interval_(block_restart_interval),
       use_delta_encoding_(use_delta_encoding),
       use_value_delta_encoding_(use_value_delta_encoding),
+      column_layout_(column_layout),
       restarts_(),
       counter_(0),
       finished_(false) {
+  assert(!column_layout_ || !use_value_delta_encoding_);
   switch (index_type) {
     case BlockBasedTableOptions::kDataBlockBinarySearch:
       break;
     case BlockBasedTableOptions::kDataBlockBinaryAndHash:
-      data_block_hash_index_builder_.Initialize(
-          data_block_hash_table_util_ratio);
+      // The hash index is not supported by the column layout
+      if (!column_layout_) {
+        data_block_hash_index_builder_.Initialize(
+            data_block_hash_table_util_ratio);
+      }
       break;
     default:
       assert(0);
   }
   assert(block_restart_interval_ >= 1);
   restarts_.push_back(0);  // First restart point is at offset 0
-  estimate_ = sizeof(uint32_t) + sizeof(uint32_t);
+  estimate_ = InitialSizeEstimate();
+}
+
+size_t BlockBuilder::InitialSizeEstimate() const {
+  return sizeof(uint32_t) + sizeof(uint32_t) +
+         (column_layout_ ? kColumnLayoutTrailerSize : 0);
 }
 
 void BlockBuilder::Reset() {
   buffer_.clear();
   restarts_.clear();
   restarts_.push_back(0);  // First restart point is at offset 0
-  estimate_ = sizeof(uint32_t) + sizeof(uint32_t);
+  estimate_ = InitialSizeEstimate();
   counter_ = 0;
   finished_ = false;
   last_key_.clear();
+  values_.clear();
+  value_ends_.clear();
   if (data_block_hash_index_builder_.Valid()) {
     data_block_hash_index_builder_.Reset();
   }
@@ -118,20 +150,48 @@ Slice BlockBuilder::Finish() {
   uint32_t num_restarts = static_cast<uint32_t>(restarts_.size());
   BlockBasedTableOptions::DataBlockIndexType index_type =
       BlockBasedTableOptions::kDataBlockBinarySearch;
-  if (data_block_hash_index_builder_.Valid() &&
-      CurrentSizeEstimate() <= kMaxBlockSizeSupportedByHashIndex) {
+  if (column_layout_) {
+    FinishColumns();
+  } else if (data_block_hash_index_builder_.Valid() &&
+             CurrentSizeEstimate() <= kMaxBlockSizeSupportedByHashIndex) {
     data_block_hash_index_builder_.Finish(buffer_);
     index_type = BlockBasedTableOptions::kDataBlockBinaryAndHash;
   }
 
-  // footer is a packed format of data_block_index_type and num_restarts
-  uint32_t block_footer = PackIndexTypeAndNumRestarts(index_type, num_restarts);
+  // footer is a packed format of data_block_index_type, num_restarts and
+  // whether the block has the column layout
+  uint32_t block_footer =
+      PackIndexTypeAndNumRestarts(index_type, num_restarts, column_layout_);
 
   PutFixed32(&buffer_, block_footer);
   finished_ = true;
   return Slice(buffer_);
 }
 
+void BlockBuilder::FinishColumns() {
+  const uint32_t values_offset = static_cast<uint32_t>(buffer_.size());
+  buffer_.append(values_);
+
+  // Whether all the values are as long as the first one
+  uint32_t value_width = value_ends_.empty() ? 0 : value_ends_[0];
+  for (size_t i = 1; i < value_ends_.size(); i++) {
+    if (value_ends_[i] - value_ends_[i - 1] != value_width) {
+      value_width = kColumnLayoutVariableValueWidth;
+      break;
+    }
+  }
+  if (value_width == kColumnLayoutVariableValueWidth) {
+    for (uint32_t value_end : value_ends_) {
+      PutFixed32(&buffer_, value_end);
+    }
+  }
+
+  PutFixed32(&buffer_, static_cast<uint32_t>(value_ends_.size()));
+  PutFixed32(&buffer_, value_width);
+  PutFixed32(&buffer_, static_cast<uint32_t>(block_restart_interval_));
+  PutFixed32(&buffer_, values_offset);
+}
+
 void BlockBuilder::Add(const Slice& key, const Slice& value,
                        const Slice* const delta_value) {
   assert(!finished_);
@@ -162,7 +222,7 @@ void BlockBuilder::Add(const Slice& key, const Slice& value,
   const size_t non_shared = key.size() - shared;
   const size_t curr_size = buffer_.size();
 
-  if (use_value_delta_encoding_) {
+  if (use_value_delta_encoding_ || column_layout_) {
     // Add "<shared><non_shared>" to buffer_
     PutVarint32Varint32(&buffer_, static_cast<uint32_t>(shared),
                         static_cast<uint32_t>(non_shared));
@@ -175,10 +235,15 @@ void BlockBuilder::Add(const Slice& key, const Slice& value,
 
   // Add string delta to buffer_ followed by value
   buffer_.append(key.data() + shared, non_shared);
-  // Use value delta encoding only when the key has shared bytes. This would
-  // simplify the decoding, where it can figure which decoding to use simply by
-  // looking at the shared bytes size.
-  if (shared != 0 && use_value_delta_encoding_) {
+  if (column_layout_) {
+    // The value goes to its own array
+    values_.append(value.data(), value.size());
+    value_ends_.push_back(static_cast<uint32_t>(values_.size()));
+    estimate_ += value.size() + sizeof(uint32_t);
+  } else if (shared != 0 && use_value_delta_encoding_) {
+    // Use value delta encoding only when the key has shared bytes. This would
+    // simplify the decoding, where it can figure which decoding to use simply
+    // by looking at the shared bytes size.
     buffer_.append(delta_value->data(), delta_value->size());
   } else {
     buffer_.append(value.data(), value.size());
@@ -27,7 +27,8 @@ class BlockBuilder {
                         bool use_value_delta_encoding = false,
                         BlockBasedTableOptions::DataBlockIndexType index_type =
                             BlockBasedTableOptions::kDataBlockBinarySearch,
-                        double data_block_hash_table_util_ratio = 0.75);
+                        double data_block_hash_table_util_ratio = 0.75,
+                        bool column_layout = false);
 
   // Reset the contents as if the BlockBuilder was just constructed.
   void Reset();
@@ -57,13 +58,22 @@ class BlockBuilder {
   bool empty() const { return buffer_.empty(); }
 
  private:
+  size_t InitialSizeEstimate() const;
+  // Appends the values and the trailer of the column layout
+  void FinishColumns();
+
   const int block_restart_interval_;
   // TODO(myabandeh): put it into a separate IndexBlockBuilder
   const bool use_delta_encoding_;
   // Refer to BlockIter::DecodeCurrentValue for format of delta encoded values
   const bool use_value_delta_encoding_;
+  // Refer to block_builder.cc for the column layout of data blocks
+  const bool column_layout_;
 
   std::string buffer_;              // Destination buffer
+  // Values and the offsets just past each of them, in the column layout
+  std::string values_;
+  std::vector<uint32_t> value_ends_;
   std::vector<uint32_t> restarts_;  // Restart points
   size_t estimate_;
   int counter_;    // Number of entries emitted since restart
@@ -0,0 +1,208 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "table/block_based/block_interpolation_index.h"
+
+#include <string.h>
+#include <algorithm>
+#include <limits>
+#include <memory>
+
+#include "util/coding.h"
+
+namespace rocksdb {
+
+// The model block is
+//
+//   num_restarts: varint32
+//   max_error: varint32
+//   prefix: length-prefixed slice
+//   num_segments: varint32
+//   segments: num_segments times
+//     first_position: fixed64
+//     first_restart: fixed32
+//     slope: fixed64, the bits of a double
+//
+// A segment predicts
+//   first_restart + slope * (position - first_position)
+// for the positions from its first_position to the first_position of the
+// next segment.
+
+namespace {
+
+const size_t kSegmentSize = 2 * sizeof(uint64_t) + sizeof(uint32_t);
+
+// The number of a key, given the size of the prefix shared by all the keys
+inline uint64_t KeyPosition(const Slice& user_key, size_t prefix_size) {
+  uint64_t position = 0;
+  size_t i = prefix_size;
+  for (size_t n = 0; n < sizeof(uint64_t); n++, i++) {
+    position <<= 8;
+    if (i < user_key.size()) {
+      position |= static_cast<unsigned char>(user_key[i]);
+    }
+  }
+  return position;
+}
+
+inline uint64_t EncodeDouble(double d) {
+  uint64_t bits;
+  memcpy(&bits, &d, sizeof(bits));
+  return bits;
+}
+
+inline double DecodeDouble(uint64_t bits) {
+  double d;
+  memcpy(&d, &bits, sizeof(d));
+  return d;
+}
+
+}  // namespace
+
+void BlockInterpolationIndex::Builder::Add(const Slice& user_key) {
+  key_offsets_.push_back(keys_.size());
+  keys_.append(user_key.data(), user_key.size());
+}
+
+Slice BlockInterpolationIndex::Builder::Finish() {
+  model_.clear();
+  const size_t num_keys = key_offsets_.size();
+  auto key_at = [&](size_t i) {
+    size_t end = i + 1 < num_keys ? key_offsets_[i + 1] : keys_.size();
+    return Slice(keys_.data() + key_offsets_[i], end - key_offsets_[i]);
+  };
+
+  // The keys between the first and the last share their common prefix
+  size_t prefix_size = 0;
+  if (num_keys > 0) {
+    Slice first = key_at(0);
+    Slice last = key_at(num_keys - 1);
+    prefix_size = first.difference_offset(last);
+  }
+
+  PutVarint32(&model_, static_cast<uint32_t>(num_keys));
+  PutVarint32(&model_, max_error_);
+  PutLengthPrefixedSlice(&model_,
+                         Slice(keys_.data(), num_keys > 0 ? prefix_size : 0));
+  std::string segments;
+  uint32_t num_segments = 0;
+
+  // Grow each segment while a line through its first point can predict all
+  // its points within max_error, keeping the range of such slopes.
+  size_t first = 0;
+  while (first < num_keys) {
+    const uint64_t x0 = KeyPosition(key_at(first), prefix_size);
+    const double y0 = static_cast<double>(first);
+    double min_slope = 0;
+    double max_slope = std::numeric_limits<double>::max();
+    size_t i = first + 1;
+    for (; i < num_keys; i++) {
+      const uint64_t x = KeyPosition(key_at(i), prefix_size);
+      const double y = static_cast<double>(i);
+      if (x == x0) {
+        if (y - y0 > max_error_) {
+          break;
+        }
+        continue;
+      }
+      const double dx = static_cast<double>(x - x0);
+      const double low = (y - max_error_ - y0) / dx;
+      const double high = (y + max_error_ - y0) / dx;
+      if (low > max_slope || high < min_slope) {
+        break;
+      }
+      min_slope = std::max(min_slope, low);
+      max_slope = std::min(max_slope, high);
+    }
+    double slope = max_slope == std::numeric_limits<double>::max()
+                       ? min_slope
+                       : (min_slope + max_slope) / 2;
+    PutFixed64(&segments, x0);
+    PutFixed32(&segments, static_cast<uint32_t>(first));
+    PutFixed64(&segments, EncodeDouble(slope));
+    num_segments++;
+    first = i;
+  }
+  PutVarint32(&model_, num_segments);
+  model_.append(segments);
+
+  keys_.clear();
+  key_offsets_.clear();
+  return Slice(model_);
+}
+
+Status BlockInterpolationIndex::Create(const Slice& model_block,
+                                       BlockInterpolationIndex** index) {
+  Slice input = model_block;
+  uint32_t num_restarts = 0;
+  uint32_t max_error = 0;
+  Slice prefix;
+  uint32_t num_segments = 0;
+  if (!GetVarint32(&input, &num_restarts) ||
+      !GetVarint32(&input, &max_error) ||
+      !GetLengthPrefixedSlice(&input, &prefix) ||
+      !GetVarint32(&input, &num_segments) ||
+      input.size() != num_segments * kSegmentSize || num_segments == 0) {
+    return Status::Corruption("bad interpolation index model block");
+  }
+
+  std::unique_ptr<BlockInterpolationIndex> result(
+      new BlockInterpolationIndex());
+  result->num_restarts_ = num_restarts;
+  result->max_error_ = max_error;
+  result->prefix_ = prefix.ToString();
+  result->segment_positions_.reserve(num_segments);
+  result->segment_restarts_.reserve(num_segments);
+  result->segment_slopes_.reserve(num_segments);
+  const char* p = input.data();
+  for (uint32_t i = 0; i < num_segments; i++) {
+    uint64_t position = DecodeFixed64(p);
+    uint32_t restart = DecodeFixed32(p + sizeof(uint64_t));
+    double slope = DecodeDouble(DecodeFixed64(p + sizeof(uint64_t) +
+                                              sizeof(uint32_t)));
+    p += kSegmentSize;
+    if (restart >= num_restarts ||
+        (i > 0 && (position < result->segment_positions_.back() ||
+                   restart <= result->segment_restarts_.back()))) {
+      return Status::Corruption("bad interpolation index segment");
+    }
+    result->segment_positions_.push_back(position);
+    result->segment_restarts_.push_back(restart);
+    result->segment_slopes_.push_back(slope);
+  }
+  *index = result.release();
+  return Status::OK();
+}
+
+bool BlockInterpolationIndex::Predict(const Slice& user_key, uint32_t* left,
+                                      uint32_t* right) const {
+  if (!user_key.starts_with(prefix_)) {
+    return false;
+  }
+  const uint64_t position = KeyPosition(user_key, prefix_.size());
+  // The last segment that starts at or before the key
+  auto it = std::upper_bound(segment_positions_.begin(),
+                             segment_positions_.end(), position);
+  size_t segment = it == segment_positions_.begin()
+                       ? 0
+                       : static_cast<size_t>(it - segment_positions_.begin()) -
+                             1;
+  double predicted = static_cast<double>(segment_restarts_[segment]);
+  if (position > segment_positions_[segment]) {
+    predicted += segment_slopes_[segment] *
+                 static_cast<double>(position - segment_positions_[segment]);
+  }
+  const uint32_t last = num_restarts_ - 1;
+  uint32_t restart =
+      predicted >= last ? last : static_cast<uint32_t>(predicted + 0.5);
+  // A key between the keys of two restart points is predicted between their
+  // predictions
+  const uint32_t error = max_error_ + 1;
+  *left = restart > error ? restart - error : 0;
+  *right = last - restart > error ? restart + error : last;
+  return true;
+}
+
+}  // namespace rocksdb
@@ -0,0 +1,85 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "rocksdb/slice.h"
+#include "rocksdb/status.h"
+
+namespace rocksdb {
+
+// A piecewise-linear model of the keys of the restart points of an index
+// block, used by BlockBasedTableOptions::kInterpolationSearch to narrow the
+// binary search of IndexBlockIter::Seek() to a few restart points.
+//
+// Keys are mapped to numbers by the 8 bytes that follow the prefix that all
+// the keys of the block share, read as a big-endian integer, which preserves
+// the bytewise order. The model is a sequence of segments, each a line from
+// such a number to a restart index, that predicts the restart index of each
+// key it covers within `max_error`. Keys with numeric or near-uniformly
+// distributed bytes after their common prefix, such as timestamps, need few
+// segments.
+//
+// A prediction is only a hint: the iterator checks the keys at the ends of
+// the window it searches, and searches the rest of the block if the key is
+// outside of it.
+class BlockInterpolationIndex {
+ public:
+  class Builder {
+   public:
+    explicit Builder(uint32_t max_error) : max_error_(max_error) {}
+
+    // Adds the user key of the next restart point. Keys must be added in
+    // bytewise order.
+    void Add(const Slice& user_key);
+
+    // Returns the contents of the model block.
+    Slice Finish();
+
+    bool empty() const { return key_offsets_.empty(); }
+
+   private:
+    const uint32_t max_error_;
+    std::string keys_;
+    std::vector<size_t> key_offsets_;
+    std::string model_;
+  };
+
+  // Creates the model from the contents of a model block.
+  static Status Create(const Slice& model_block,
+                       BlockInterpolationIndex** index);
+
+  // The number of restart points of the index block that the model is for
+  uint32_t num_restarts() const { return num_restarts_; }
+
+  // Stores the range of restart points that the last restart point with a
+  // key not greater than `user_key` is predicted to be in, in [*left,
+  // *right]. Returns false if there is no prediction for the key, because
+  // it does not have the prefix of the block.
+  bool Predict(const Slice& user_key, uint32_t* left, uint32_t* right) const;
+
+  size_t ApproximateMemoryUsage() const {
+    return sizeof(BlockInterpolationIndex) + prefix_.capacity() +
+           segment_positions_.capacity() * sizeof(uint64_t) +
+           segment_restarts_.capacity() * sizeof(uint32_t) +
+           segment_slopes_.capacity() * sizeof(double);
+  }
+
+ private:
+  BlockInterpolationIndex() = default;
+
+  uint32_t num_restarts_ = 0;
+  uint32_t max_error_ = 0;
+  std::string prefix_;
+  // The segments, in the order of the numbers of their first keys
+  std::vector<uint64_t> segment_positions_;
+  std::vector<uint32_t> segment_restarts_;
+  std::vector<double> segment_slopes_;
+};
+
+}  // namespace rocksdb
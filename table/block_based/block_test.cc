@@ -126,6 +126,96 @@ TEST_F(BlockTest, SimpleTest) {
   delete iter;
 }
 
+TEST_F(BlockTest, ColumnLayout) {
+  Random rnd(301);
+  const int kNumRecords = 2000;
+  std::vector<std::string> keys;
+  std::vector<std::string> values;
+  GenerateRandomKVs(&keys, &values, 0 /* first key id */, kNumRecords / 5,
+                    1 /* step */, 4 /* padding size */,
+                    5 /* keys share prefix */);
+
+  for (bool fixed_width : {true, false}) {
+    if (!fixed_width) {
+      for (size_t i = 0; i < values.size(); i++) {
+        values[i] = RandomString(&rnd, static_cast<int>(i % 17));
+      }
+    }
+    BlockBuilder builder(16, true /* use_delta_encoding */,
+                         false /* use_value_delta_encoding */,
+                         BlockBasedTableOptions::kDataBlockBinaryAndHash,
+                         0.75 /* data_block_hash_table_util_ratio */,
+                         true /* column_layout */);
+    for (size_t i = 0; i < keys.size(); i++) {
+      builder.Add(keys[i], values[i]);
+    }
+    BlockContents contents;
+    contents.data = builder.Finish();
+    Block reader(std::move(contents), kDisableGlobalSequenceNumber);
+    ASSERT_TRUE(reader.IsColumnLayout());
+    // The hash index is not built for the column layout
+    ASSERT_EQ(BlockBasedTableOptions::kDataBlockBinarySearch,
+              reader.IndexType());
+
+    std::unique_ptr<DataBlockIter> iter(
+        reader.NewDataIterator(BytewiseComparator(), BytewiseComparator()));
+
+    // Forward and backward
+    size_t count = 0;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next(), count++) {
+      ASSERT_EQ(keys[count], iter->key().ToString());
+      ASSERT_EQ(values[count], iter->value().ToString());
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(keys.size(), count);
+    for (iter->SeekToLast(); iter->Valid(); iter->Prev()) {
+      count--;
+      ASSERT_EQ(keys[count], iter->key().ToString());
+      ASSERT_EQ(values[count], iter->value().ToString());
+    }
+    ASSERT_EQ(0U, count);
+
+    // Seeks, then a step in each direction
+    for (int i = 0; i < 1000; i++) {
+      size_t index = rnd.Uniform(kNumRecords);
+      iter->Seek(keys[index]);
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(values[index], iter->value().ToString());
+      if (index > 0) {
+        iter->Prev();
+        ASSERT_EQ(values[index - 1], iter->value().ToString());
+        iter->Next();
+      }
+      iter->Next();
+      if (index + 1 < keys.size()) {
+        ASSERT_EQ(keys[index + 1], iter->key().ToString());
+        ASSERT_EQ(values[index + 1], iter->value().ToString());
+      } else {
+        ASSERT_FALSE(iter->Valid());
+      }
+      iter->SeekForPrev(keys[index]);
+      ASSERT_EQ(values[index], iter->value().ToString());
+    }
+
+    // Batches
+    const size_t kBatchSize = 7;
+    Slice batch_keys[kBatchSize];
+    Slice batch_values[kBatchSize];
+    std::string key_buf;
+    count = 0;
+    iter->SeekToFirst();
+    while (iter->Valid()) {
+      size_t n = iter->NextN(kBatchSize, batch_keys, batch_values, &key_buf);
+      ASSERT_GT(n, 0U);
+      for (size_t i = 0; i < n; i++, count++) {
+        ASSERT_EQ(keys[count], batch_keys[i].ToString());
+        ASSERT_EQ(values[count], batch_values[i].ToString());
+      }
+    }
+    ASSERT_EQ(keys.size(), count);
+  }
+}
+
 // return the block contents
 BlockContents GetBlockContents(std::unique_ptr<BlockBuilder> *builder,
                                const std::vector<std::string> &keys,
@@ -13,13 +13,23 @@
 
 namespace rocksdb {
 
+// The trailer of a data block of the column layout, before the footer, holds
+// num_entries, value_width, restart_interval and values_offset as fixed32.
+const size_t kColumnLayoutTrailerSize = 4 * sizeof(uint32_t);
+
+// The value_width of a data block of the column layout whose values are not
+// all of the same length.
+const uint32_t kColumnLayoutVariableValueWidth = 0xFFFFFFFFu;
+
+// `column_layout` marks a data block written with
+// BlockBasedTableOptions::data_block_column_layout, see block_builder.cc.
 uint32_t PackIndexTypeAndNumRestarts(
     BlockBasedTableOptions::DataBlockIndexType index_type,
-    uint32_t num_restarts);
+    uint32_t num_restarts, bool column_layout = false);
 
 void UnPackIndexTypeAndNumRestarts(
     uint32_t block_footer,
     BlockBasedTableOptions::DataBlockIndexType* index_type,
-    uint32_t* num_restarts);
+    uint32_t* num_restarts, bool* column_layout = nullptr);
 
 }  // namespace rocksdb
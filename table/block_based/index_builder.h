@@ -12,6 +12,7 @@
 #include <assert.h>
 #include <cinttypes>
 
+#include <algorithm>
 #include <list>
 #include <string>
 #include <unordered_map>
@@ -19,6 +20,7 @@
 #include "rocksdb/comparator.h"
 #include "table/block_based/block_based_table_factory.h"
 #include "table/block_based/block_builder.h"
+#include "table/block_based/block_interpolation_index.h"
 #include "table/format.h"
 
 namespace rocksdb {
@@ -352,6 +354,73 @@ class HashIndexBuilder : public IndexBuilder {
   uint64_t current_restart_index_ = 0;
 };
 
+// InterpolationIndexBuilder contains a binary-searchable primary index and a
+// metablock with a model of the keys of its restart points, which narrows
+// the binary search, see block_interpolation_index.h. The model relies on the
+// bytewise order of keys, so it is only built for the bytewise comparator.
+class InterpolationIndexBuilder : public IndexBuilder {
+ public:
+  explicit InterpolationIndexBuilder(
+      const InternalKeyComparator* comparator,
+      int index_block_restart_interval, int format_version,
+      bool use_value_delta_encoding,
+      BlockBasedTableOptions::IndexShorteningMode shortening_mode)
+      : IndexBuilder(comparator),
+        primary_index_builder_(comparator, index_block_restart_interval,
+                               format_version, use_value_delta_encoding,
+                               shortening_mode, /* include_first_key */ false),
+        model_builder_(kModelMaxError),
+        build_model_(comparator->user_comparator() == BytewiseComparator()),
+        index_block_restart_interval_(
+            static_cast<uint64_t>(std::max(index_block_restart_interval, 1))) {
+  }
+
+  virtual void AddIndexEntry(std::string* last_key_in_current_block,
+                             const Slice* first_key_in_next_block,
+                             const BlockHandle& block_handle) override {
+    primary_index_builder_.AddIndexEntry(last_key_in_current_block,
+                                         first_key_in_next_block, block_handle);
+    // The separator that was added starts a restart interval
+    if (build_model_ && num_entries_ % index_block_restart_interval_ == 0) {
+      model_builder_.Add(ExtractUserKey(*last_key_in_current_block));
+    }
+    ++num_entries_;
+  }
+
+  virtual Status Finish(
+      IndexBlocks* index_blocks,
+      const BlockHandle& last_partition_block_handle) override {
+    primary_index_builder_.Finish(index_blocks, last_partition_block_handle);
+    if (build_model_ && !model_builder_.empty()) {
+      Slice model_block = model_builder_.Finish();
+      model_size_ = model_block.size();
+      index_blocks->meta_blocks.insert(
+          {kInterpolationIndexModelBlock.c_str(), model_block});
+    }
+    return Status::OK();
+  }
+
+  virtual size_t IndexSize() const override {
+    return primary_index_builder_.IndexSize() + model_size_;
+  }
+
+  virtual bool seperator_is_key_plus_seq() override {
+    return primary_index_builder_.seperator_is_key_plus_seq();
+  }
+
+ private:
+  // The number of restart points around the predicted one that a seek
+  // searches
+  static const uint32_t kModelMaxError = 4;
+
+  ShortenedIndexBuilder primary_index_builder_;
+  BlockInterpolationIndex::Builder model_builder_;
+  const bool build_model_;
+  const uint64_t index_block_restart_interval_;
+  uint64_t num_entries_ = 0;
+  size_t model_size_ = 0;
+};
+
 /**
  * IndexBuilder for two-level indexing. Internally it creates a new index for
  * each partition and Finish then in order when Finish is called on it
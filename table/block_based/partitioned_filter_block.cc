@@ -213,7 +213,7 @@ Status PartitionedFilterBlockReader::GetFilterPartitionBlock(
   assert(filter_block);
   assert(filter_block->IsEmpty());
 
-  if (!filter_map_.empty()) {
+  if (filter_map_ready_.load(std::memory_order_acquire)) {
     auto iter = filter_map_.find(fltr_blk_handle.offset());
     // This is a possible scenario since block cache might not have had space
     // for the partition
@@ -334,6 +334,7 @@ void PartitionedFilterBlockReader::CacheDependencies(bool pin) {
 
   // After prefetch, read the partitions one by one
   ReadOptions read_options;
+  std::unordered_map<uint64_t, CachableEntry<BlockContents>> filter_map;
   for (biter.SeekToFirst(); biter.Valid(); biter.Next()) {
     handle = biter.value().handle;
 
@@ -349,11 +350,15 @@ void PartitionedFilterBlockReader::CacheDependencies(bool pin) {
     if (s.ok() && block.GetValue() != nullptr) {
       if (block.IsCached()) {
         if (pin) {
-          filter_map_[handle.offset()] = std::move(block);
+          filter_map[handle.offset()] = std::move(block);
         }
       }
     }
   }
+  if (!filter_map.empty()) {
+    filter_map_ = std::move(filter_map);
+    filter_map_ready_.store(true, std::memory_order_release);
+  }
 }
 
 const InternalKeyComparator* PartitionedFilterBlockReader::internal_comparator()
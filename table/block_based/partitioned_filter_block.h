@@ -5,6 +5,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <list>
 #include <string>
 #include <unordered_map>
@@ -118,7 +119,10 @@ class PartitionedFilterBlockReader : public FilterBlockReaderCommon<Block> {
   bool index_value_is_full() const;
 
  protected:
+  // The pinned partitions. They may be loaded by a background thread, so they
+  // are only looked at once filter_map_ready_ is set.
   std::unordered_map<uint64_t, CachableEntry<BlockContents>> filter_map_;
+  std::atomic<bool> filter_map_ready_{false};
 };
 
 }  // namespace rocksdb
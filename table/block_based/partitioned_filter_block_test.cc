@@ -46,6 +46,7 @@ class MyPartitionedFilterBlockReader : public PartitionedFilterBlockReader {
           nullptr /* cache_handle */, true /* own_value */);
       filter_map_[offset] = std::move(block);
     }
+    filter_map_ready_ = true;
   }
 };
 
@@ -52,6 +52,9 @@ inline void BlockFetcher::CheckBlockChecksum() {
             XXH64(data, static_cast<int>(block_size_) + 1, 0) &
             uint64_t{0xffffffff});
         break;
+      case kXXH3:
+        actual = ComputeXXH3BlockChecksum(data, block_size_, data[block_size_]);
+        break;
       default:
         status_ = Status::Corruption(
             "unknown checksum type " + ToString(footer_.checksum()) + " in " +
@@ -129,10 +132,17 @@ inline bool BlockFetcher::TryGetCompressedBlockFromPersistentCache() {
 
 inline void BlockFetcher::PrepareBufferForBlockFromFile() {
   // cache miss read from device
-  if (do_uncompress_ &&
-      block_size_ + kBlockTrailerSize < kDefaultStackBufferSize) {
+  const bool fits_in_stack_buf =
+      block_size_ + kBlockTrailerSize < kDefaultStackBufferSize;
+  if (fits_in_stack_buf &&
+      ((do_uncompress_ && maybe_compressed_) ||
+       (ioptions_.allow_mmap_reads && !file_->use_direct_io()))) {
     // If we've got a small enough hunk of data, read it in to the
-    // trivially allocated stack buffer instead of needing a full malloc()
+    // trivially allocated stack buffer instead of needing a full malloc().
+    // A block that is compressed is uncompressed into a new buffer anyway,
+    // and a memory-mapped file returns its blocks without copying them into
+    // the buffer. A block read from an uncompressed file, however, is read
+    // straight into a heap buffer, to save the copy from the stack.
     used_buf_ = &stack_buf_[0];
   } else if (maybe_compressed_ && !do_uncompress_) {
     compressed_buf_ = AllocateBlock(block_size_ + kBlockTrailerSize,
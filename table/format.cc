@@ -25,6 +25,7 @@
 #include "util/compression.h"
 #include "util/crc32c.h"
 #include "util/file_reader_writer.h"
+#include "util/hash.h"
 #include "util/stop_watch.h"
 #include "util/string_util.h"
 #include "util/xxhash.h"
@@ -280,6 +281,12 @@ std::string Footer::ToString() const {
   return result;
 }
 
+uint32_t ComputeXXH3BlockChecksum(const char* data, size_t size, char type) {
+  const uint32_t kRandomPrime = 0x6b9083d9;
+  uint32_t checksum = static_cast<uint32_t>(XXH3Hash64(data, size));
+  return checksum ^ (static_cast<uint8_t>(type) * kRandomPrime);
+}
+
 Status ReadFooterFromFile(RandomAccessFileReader* file,
                           FilePrefetchBuffer* prefetch_buffer,
                           uint64_t file_size, Footer* footer,
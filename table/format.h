@@ -220,6 +220,13 @@ Status ReadFooterFromFile(RandomAccessFileReader* file,
 // 1-byte type + 32-bit crc
 static const size_t kBlockTrailerSize = 5;
 
+// The kXXH3 checksum of the `size` bytes of a block followed by `type`, the
+// compression type byte of its trailer. Rather than being hashed after the
+// block, which would need a streaming state, `type` is mixed into the lower
+// 32 bits of the hash of the block.
+extern uint32_t ComputeXXH3BlockChecksum(const char* data, size_t size,
+                                         char type);
+
 // Make block size calculation for IO less error prone
 inline uint64_t block_size(const BlockHandle& handle) {
   return handle.size() + kBlockTrailerSize;
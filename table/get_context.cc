@@ -4,6 +4,7 @@
 //  (found in the LICENSE.Apache file in the root directory).
 
 #include "table/get_context.h"
+#include "db/blob_fetcher.h"
 #include "db/merge_helper.h"
 #include "db/pinned_iterators_manager.h"
 #include "db/read_callback.h"
@@ -44,7 +45,8 @@ GetContext::GetContext(
     PinnableSlice* pinnable_val, bool* value_found, MergeContext* merge_context,
     bool do_merge, SequenceNumber* _max_covering_tombstone_seq, Env* env,
     SequenceNumber* seq, PinnedIteratorsManager* _pinned_iters_mgr,
-    ReadCallback* callback, bool* is_blob_index, uint64_t tracing_get_id)
+    ReadCallback* callback, bool* is_blob_index, uint64_t tracing_get_id,
+    BlobFetcher* blob_fetcher)
     : ucmp_(ucmp),
       merge_operator_(merge_operator),
       logger_(logger),
@@ -62,7 +64,8 @@ GetContext::GetContext(
       callback_(callback),
       do_merge_(do_merge),
       is_blob_index_(is_blob_index),
-      tracing_get_id_(tracing_get_id) {
+      tracing_get_id_(tracing_get_id),
+      blob_fetcher_(blob_fetcher) {
   if (seq_) {
     *seq_ = kMaxSequenceNumber;
   }
@@ -207,8 +210,22 @@ bool GetContext::SaveValue(const ParsedInternalKey& parsed_key,
     }
     switch (type) {
       case kTypeValue:
-      case kTypeBlobIndex:
+      case kTypeBlobIndex: {
         assert(state_ == kNotFound || state_ == kMerge);
+        // A blob index written by a flush or a compaction of a column family
+        // with enable_blob_files is resolved here, so that the rest of the
+        // lookup sees the value itself.
+        Slice found_value = value;
+        Cleanable* found_value_pinner = value_pinner;
+        PinnableSlice blob_value;
+        if (type == kTypeBlobIndex && blob_fetcher_ != nullptr) {
+          if (!GetBlobValue(value, &blob_value)) {
+            return false;
+          }
+          type = kTypeValue;
+          found_value = blob_value;
+          found_value_pinner = blob_value.IsPinned() ? &blob_value : nullptr;
+        }
         if (type == kTypeBlobIndex && is_blob_index_ == nullptr) {
           // Blob value not supported. Stop.
           state_ = kBlobIndex;
@@ -218,22 +235,22 @@ bool GetContext::SaveValue(const ParsedInternalKey& parsed_key,
           state_ = kFound;
           if (do_merge_) {
             if (LIKELY(pinnable_val_ != nullptr)) {
-              if (LIKELY(value_pinner != nullptr)) {
+              if (LIKELY(found_value_pinner != nullptr)) {
                 // If the backing resources for the value are provided, pin them
-                pinnable_val_->PinSlice(value, value_pinner);
+                pinnable_val_->PinSlice(found_value, found_value_pinner);
               } else {
                 TEST_SYNC_POINT_CALLBACK("GetContext::SaveValue::PinSelf",
                                          this);
 
                 // Otherwise copy the value
-                pinnable_val_->PinSelf(value);
+                pinnable_val_->PinSelf(found_value);
               }
             }
           } else {
             // It means this function is called as part of DB GetMergeOperands
             // API and the current value should be part of
             // merge_context_->operand_list
-            push_operand(value, value_pinner);
+            push_operand(found_value, found_value_pinner);
           }
         } else if (kMerge == state_) {
           assert(merge_operator_ != nullptr);
@@ -241,7 +258,7 @@ bool GetContext::SaveValue(const ParsedInternalKey& parsed_key,
           if (do_merge_) {
             if (LIKELY(pinnable_val_ != nullptr)) {
               Status merge_status = MergeHelper::TimedFullMerge(
-                  merge_operator_, user_key_, &value,
+                  merge_operator_, user_key_, &found_value,
                   merge_context_->GetOperands(), pinnable_val_->GetSelf(),
                   logger_, statistics_, env_);
               pinnable_val_->PinSelf();
@@ -253,13 +270,14 @@ bool GetContext::SaveValue(const ParsedInternalKey& parsed_key,
             // It means this function is called as part of DB GetMergeOperands
             // API and the current value should be part of
             // merge_context_->operand_list
-            push_operand(value, value_pinner);
+            push_operand(found_value, found_value_pinner);
           }
         }
         if (is_blob_index_ != nullptr) {
           *is_blob_index_ = (type == kTypeBlobIndex);
         }
         return false;
+      }
 
       case kTypeDeletion:
       case kTypeSingleDeletion:
@@ -325,6 +343,20 @@ bool GetContext::SaveValue(const ParsedInternalKey& parsed_key,
   return false;
 }
 
+bool GetContext::GetBlobValue(const Slice& blob_index,
+                              PinnableSlice* blob_value) {
+  blob_status_ = blob_fetcher_->FetchBlob(user_key_, blob_index, blob_value);
+  if (!blob_status_.ok()) {
+    if (blob_status_.IsIncomplete()) {
+      // The blob file is not open and the read is not allowed to do IO
+      MarkKeyMayExist();
+    }
+    state_ = kCorrupt;
+    return false;
+  }
+  return true;
+}
+
 void GetContext::push_operand(const Slice& value, Cleanable* value_pinner) {
   if (pinned_iters_mgr() && pinned_iters_mgr()->PinningEnabled() &&
       value_pinner != nullptr) {
@@ -14,6 +14,7 @@
 #include "table/block_based/block.h"
 
 namespace rocksdb {
+class BlobFetcher;
 class MergeContext;
 class PinnedIteratorsManager;
 
@@ -81,6 +82,8 @@ class GetContext {
   //                 for visibility of a key
   // @param is_blob_index If non-nullptr, will be used to indicate if a found
   //                      key is of type blob index
+  // @param blob_fetcher If non-nullptr, the values of the blob indexes found
+  //                     are read from the blob files of the version
   // @param do_merge True if value associated with user_key has to be returned
   // and false if all the merge operands associated with user_key has to be
   // returned. Id do_merge=false then all the merge operands are stored in
@@ -93,7 +96,7 @@ class GetContext {
              SequenceNumber* seq = nullptr,
              PinnedIteratorsManager* _pinned_iters_mgr = nullptr,
              ReadCallback* callback = nullptr, bool* is_blob_index = nullptr,
-             uint64_t tracing_get_id = 0);
+             uint64_t tracing_get_id = 0, BlobFetcher* blob_fetcher = nullptr);
 
   GetContext() = delete;
 
@@ -118,6 +121,9 @@ class GetContext {
 
   GetState State() const { return state_; }
 
+  // The error of the blob read that set the state to kCorrupt, if any
+  const Status& blob_status() const { return blob_status_; }
+
   SequenceNumber* max_covering_tombstone_seq() {
     return max_covering_tombstone_seq_;
   }
@@ -150,6 +156,10 @@ class GetContext {
   void push_operand(const Slice& value, Cleanable* value_pinner);
 
  private:
+  // Reads the value of a blob index into *blob_value. Returns false, and
+  // sets the state to kCorrupt, if the value could not be read.
+  bool GetBlobValue(const Slice& blob_index, PinnableSlice* blob_value);
+
   const Comparator* ucmp_;
   const MergeOperator* merge_operator_;
   // the merge operations encountered;
@@ -179,6 +189,8 @@ class GetContext {
   // Used for block cache tracing only. A tracing get id uniquely identifies a
   // Get or a MultiGet.
   const uint64_t tracing_get_id_;
+  BlobFetcher* blob_fetcher_;
+  Status blob_status_;
 };
 
 // Call this to replay a log and bring the get_context up to date. The replay
@@ -95,6 +95,31 @@ void Cleanable::RegisterCleanup(CleanupFunction func, void* arg1, void* arg2) {
   c->arg2 = arg2;
 }
 
+size_t Iterator::NextN(size_t n, Slice* keys, Slice* values,
+                       std::string* buf) {
+  buf->clear();
+  size_t count = 0;
+  for (; count < n && Valid(); count++) {
+    const Slice key = this->key();
+    const Slice value = this->value();
+    buf->append(key.data(), key.size());
+    buf->append(value.data(), value.size());
+    keys[count] = Slice(nullptr, key.size());
+    values[count] = Slice(nullptr, value.size());
+    Next();
+  }
+
+  // Point into buf once it stops growing
+  const char* p = buf->data();
+  for (size_t i = 0; i < count; i++) {
+    keys[i] = Slice(p, keys[i].size());
+    p += keys[i].size();
+    values[i] = Slice(p, values[i].size());
+    p += values[i].size();
+  }
+  return count;
+}
+
 Status Iterator::GetProperty(std::string prop_name, std::string* prop) {
   if (prop == nullptr) {
     return Status::InvalidArgument("prop is nullptr");
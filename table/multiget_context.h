@@ -28,6 +28,8 @@ struct KeyContext {
   void* cb_arg;
   PinnableSlice* value;
   GetContext* get_context;
+  // Set if the value found is a blob index, see DBImpl::MultiGetImpl()
+  bool is_blob_index;
 
   KeyContext(const Slice& user_key, PinnableSlice* val, Status* stat)
       : key(&user_key),
@@ -37,7 +39,8 @@ struct KeyContext {
         key_exists(false),
         cb_arg(nullptr),
         value(val),
-        get_context(nullptr) {}
+        get_context(nullptr),
+        is_blob_index(false) {}
 
   KeyContext() = default;
 };
@@ -147,6 +147,14 @@ Status GetMemTableRepFactoryFromString(
     } else if (1 == len) {
       mem_factory = new VectorRepFactory();
     }
+  } else if (opts_list[0] == "bplus_tree") {
+    // Expecting format
+    // bplus_tree
+    if (1 != len) {
+      return Status::InvalidArgument("Can't parse memtable_factory option ",
+                                     opts_str);
+    }
+    mem_factory = new BPlusTreeRepFactory();
   } else if (opts_list[0] == "cuckoo") {
     return Status::NotSupported(
         "cuckoo hash memtable is not supported anymore.");
@@ -9,6 +9,8 @@
 
 #pragma once
 #include <memory>
+#include <string>
+#include <vector>
 #include "db/range_tombstone_fragmenter.h"
 #include "rocksdb/slice_transform.h"
 #include "table/get_context.h"
@@ -71,6 +73,25 @@ class TableReader {
   virtual uint64_t ApproximateSize(const Slice& start, const Slice& end,
                                    TableReaderCaller caller) = 0;
 
+  // A user key sampled from the table, together with the approximate size
+  // in file bytes of the data between the previous anchor and this one.
+  struct Anchor {
+    Anchor(const Slice& _user_key, uint64_t _range_size)
+        : user_key(_user_key.ToString()), range_size(_range_size) {}
+    std::string user_key;
+    uint64_t range_size;
+  };
+
+  // Samples at most max_anchors keys from the table, in key order, that
+  // divide it into ranges of roughly equal size. The last anchor is no
+  // smaller than the largest key in the table. Returns NotSupported if the
+  // table format cannot provide such keys cheaply.
+  virtual Status ApproximateKeyAnchors(const ReadOptions& /*read_options*/,
+                                       size_t /*max_anchors*/,
+                                       std::vector<Anchor>* /*anchors*/) {
+    return Status::NotSupported("ApproximateKeyAnchors() not supported");
+  }
+
   // Set up the table for Compaction. Might change some parameters with
   // posix_fadvise
   virtual void SetupForCompaction() = 0;
@@ -1898,6 +1898,109 @@ TEST_P(BlockBasedTableTest, HashIndexTest) {
   IndexTest(table_options);
 }
 
+TEST_P(BlockBasedTableTest, InterpolationIndexTest) {
+  BlockBasedTableOptions table_options = GetBlockBasedTableOptions();
+  table_options.index_type = BlockBasedTableOptions::kInterpolationSearch;
+  IndexTest(table_options);
+}
+
+// Seeks with an interpolation index find the same keys as with a binary
+// search, whether the keys fit the model well or not.
+TEST_P(BlockBasedTableTest, InterpolationIndexSeek) {
+  Random rnd(301);
+  for (bool time_series : {true, false}) {
+    for (int restart_interval : {1, 4}) {
+      BlockBasedTableOptions table_options = GetBlockBasedTableOptions();
+      table_options.index_type = BlockBasedTableOptions::kInterpolationSearch;
+      table_options.index_block_restart_interval = restart_interval;
+      // A data block per key
+      table_options.block_size = 1;
+
+      TableConstructor c(BytewiseComparator(),
+                         true /* convert_to_internal_key_ */);
+      uint64_t timestamp = 1500000000000;
+      for (int i = 0; i < 2000; i++) {
+        std::string key = "sensor:";
+        if (time_series) {
+          timestamp += 1000 + rnd.Uniform(100);
+          for (int b = 7; b >= 0; b--) {
+            key.push_back(static_cast<char>(timestamp >> (8 * b)));
+          }
+        } else {
+          key += RandomString(&rnd, 8);
+        }
+        c.Add(key, "v");
+      }
+
+      Options options;
+      options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+      const ImmutableCFOptions ioptions(options);
+      const MutableCFOptions moptions(options);
+      std::vector<std::string> keys;
+      stl_wrappers::KVMap kvmap;
+      const InternalKeyComparator ikc(options.comparator);
+      c.Finish(options, ioptions, moptions, table_options, ikc, &keys,
+               &kvmap);
+      ASSERT_EQ(kvmap.size(),
+                c.GetTableReader()->GetTableProperties()->num_data_blocks);
+
+      std::atomic<int> hits(0);
+      std::atomic<int> misses(0);
+      SyncPoint::GetInstance()->SetCallBack(
+          "IndexBlockIter::InterpolationSeek:Hit",
+          [&](void* /*arg*/) { hits++; });
+      SyncPoint::GetInstance()->SetCallBack(
+          "IndexBlockIter::InterpolationSeek:Miss",
+          [&](void* /*arg*/) { misses++; });
+      SyncPoint::GetInstance()->EnableProcessing();
+
+      std::unique_ptr<InternalIterator> iter(c.GetTableReader()->NewIterator(
+          ReadOptions(), moptions.prefix_extractor.get(), /*arena=*/nullptr,
+          /*skip_filters=*/false, TableReaderCaller::kUncategorized));
+      std::string prev_user_key = "sensor:";
+      for (const auto& kv : kvmap) {
+        const std::string& user_key = kv.first;
+        iter->Seek(InternalKey(user_key, kMaxSequenceNumber, kValueTypeForSeek)
+                       .Encode());
+        ASSERT_OK(iter->status());
+        ASSERT_TRUE(iter->Valid());
+        ASSERT_EQ(user_key, ExtractUserKey(iter->key()).ToString());
+
+        // A key between the previous key and this one
+        std::string between = prev_user_key;
+        between.push_back('\0');
+        iter->Seek(InternalKey(between, kMaxSequenceNumber, kValueTypeForSeek)
+                       .Encode());
+        ASSERT_OK(iter->status());
+        ASSERT_TRUE(iter->Valid());
+        ASSERT_EQ(user_key, ExtractUserKey(iter->key()).ToString());
+        prev_user_key = user_key;
+      }
+      // Keys without the prefix of the keys of the table
+      iter->Seek(InternalKey("a", kMaxSequenceNumber, kValueTypeForSeek)
+                     .Encode());
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(kvmap.begin()->first, ExtractUserKey(iter->key()).ToString());
+      iter->Seek(InternalKey("z", kMaxSequenceNumber, kValueTypeForSeek)
+                     .Encode());
+      ASSERT_OK(iter->status());
+      ASSERT_FALSE(iter->Valid());
+
+      SyncPoint::GetInstance()->DisableProcessing();
+      SyncPoint::GetInstance()->ClearAllCallBacks();
+#ifndef NDEBUG
+      ASSERT_GT(hits.load(), 0);
+      if (time_series) {
+        // Evenly spaced keys fit the model
+        ASSERT_EQ(0, misses.load());
+      }
+#endif  // NDEBUG
+      iter.reset();
+      c.ResetTableReader();
+    }
+  }
+}
+
 TEST_P(BlockBasedTableTest, PartitionIndexTest) {
   const int max_index_keys = 5;
   const int est_max_index_key_value_size = 32;
@@ -2300,6 +2403,60 @@ TEST_P(BlockBasedTableTest, NumBlockStat) {
   c.ResetTableReader();
 }
 
+TEST_P(BlockBasedTableTest, XXH3Checksum) {
+  std::vector<CompressionType> compression_types{kNoCompression};
+  if (Zlib_Supported()) {
+    compression_types.push_back(kZlibCompression);
+  }
+  for (CompressionType compression_type : compression_types) {
+    TableConstructor c(BytewiseComparator(),
+                       true /* convert_to_internal_key_ */);
+    for (int i = 0; i < 100; ++i) {
+      c.Add("key" + ToString(i), "value" + ToString(i));
+    }
+    Options options;
+    options.compression = compression_type;
+    BlockBasedTableOptions table_options = GetBlockBasedTableOptions();
+    table_options.checksum = kXXH3;
+    table_options.block_size = 256;
+    // Every read goes to the file, so that the corruption below is seen
+    table_options.no_block_cache = true;
+    options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+
+    std::vector<std::string> keys;
+    stl_wrappers::KVMap kvmap;
+    const ImmutableCFOptions ioptions(options);
+    const MutableCFOptions moptions(options);
+    c.Finish(options, ioptions, moptions, table_options,
+             GetPlainInternalComparator(options.comparator), &keys, &kvmap);
+    ASSERT_GT(c.GetTableReader()->GetTableProperties()->num_data_blocks, 1);
+
+    std::unique_ptr<InternalIterator> iter(
+        c.NewIterator(moptions.prefix_extractor.get()));
+    auto kv = kvmap.begin();
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next(), ++kv) {
+      ASSERT_TRUE(kv != kvmap.end());
+      ASSERT_EQ(kv->first, iter->key().ToString());
+      ASSERT_EQ(kv->second, iter->value().ToString());
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_TRUE(kv == kvmap.end());
+    iter.reset();
+
+    // Flip a byte of the first data block
+    c.TEST_GetSink()->contents_[10] ^= 0x1;
+    ASSERT_OK(c.Reopen(ioptions, moptions));
+    iter.reset(c.NewIterator(moptions.prefix_extractor.get()));
+    iter->SeekToFirst();
+    ASSERT_FALSE(iter->Valid());
+    ASSERT_TRUE(iter->status().IsCorruption());
+    ASSERT_NE(std::string::npos,
+              iter->status().ToString().find("block checksum mismatch"));
+    iter.reset();
+    c.ResetTableReader();
+  }
+}
+
 TEST_P(BlockBasedTableTest, TracingGetTest) {
   TableConstructor c(BytewiseComparator());
   Options options;
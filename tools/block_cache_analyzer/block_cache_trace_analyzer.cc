@@ -33,8 +33,10 @@ DEFINE_string(
     "The config file path. One cache configuration per line. The format of a "
     "cache configuration is "
     "cache_name,num_shard_bits,ghost_capacity,cache_capacity_1,...,cache_"
-    "capacity_N. Supported cache names are lru, lru_priority, lru_hybrid, and "
-    "lru_hybrid_no_insert_on_row_miss. User may also add a prefix 'ghost_' to "
+    "capacity_N. Supported cache names are lru, lru_priority, lru_hybrid, "
+    "lru_hybrid_no_insert_on_row_miss, and lru_tinylfu and "
+    "lru_priority_tinylfu, which enable the TinyLFU admission policy of "
+    "the LRU cache. User may also add a prefix 'ghost_' to "
     "a cache_name to add a ghost cache in front of the real cache. "
     "ghost_capacity and cache_capacity can be xK, xM or xG where x is a "
     "positive number.");
@@ -167,7 +169,8 @@ const std::set<std::string> kGroupbyLabels{
 const std::string kSupportedCacheNames =
     " lru ghost_lru lru_priority ghost_lru_priority lru_hybrid "
     "ghost_lru_hybrid lru_hybrid_no_insert_on_row_miss "
-    "ghost_lru_hybrid_no_insert_on_row_miss ";
+    "ghost_lru_hybrid_no_insert_on_row_miss lru_tinylfu ghost_lru_tinylfu "
+    "lru_priority_tinylfu ghost_lru_priority_tinylfu ";
 
 // The suffix for the generated csv files.
 const std::string kFileNameSuffixMissRatioTimeline = "miss_ratio_timeline";
@@ -48,6 +48,7 @@
 #include "rocksdb/perf_context.h"
 #include "rocksdb/persistent_cache.h"
 #include "rocksdb/rate_limiter.h"
+#include "rocksdb/secondary_cache.h"
 #include "rocksdb/slice.h"
 #include "rocksdb/slice_transform.h"
 #include "rocksdb/stats_history.h"
@@ -254,6 +255,11 @@ DEFINE_int32(seek_nexts, 0,
              "fillseekseq, seekrandom, seekrandomwhilewriting and "
              "seekrandomwhilemerging");
 
+DEFINE_int32(seek_nexts_batch_size, 0,
+             "If positive, seekrandom reads the entries after each Seek() "
+             "with Iterator::NextN() in batches of up to this many entries "
+             "instead of calling Next() -seek_nexts times");
+
 DEFINE_bool(reverse_iterator, false,
             "When true use Prev rather than Next for iterators that do "
             "Seek and then Next");
@@ -394,7 +400,7 @@ DEFINE_int32(max_background_flushes,
 
 static rocksdb::CompactionStyle FLAGS_compaction_style_e;
 DEFINE_int32(compaction_style, (int32_t) rocksdb::Options().compaction_style,
-             "style of compaction: level-based, universal and fifo");
+             "style of compaction: level-based, universal, fifo and hybrid");
 
 static rocksdb::CompactionPri FLAGS_compaction_pri_e;
 DEFINE_int32(compaction_pri, (int32_t)rocksdb::Options().compaction_pri,
@@ -436,6 +442,16 @@ DEFINE_double(cache_high_pri_pool_ratio, 0.0,
 DEFINE_bool(use_clock_cache, false,
             "Replace default LRU block cache with clock cache.");
 
+DEFINE_bool(use_slab_allocator, false,
+            "Allocate the blocks of the LRU block cache with a slab memory "
+            "allocator, which recycles the buffers of evicted blocks.");
+
+DEFINE_int64(secondary_cache_size, 0,
+             "If positive, the LRU block cache spills evicted blocks to a "
+             "compressed secondary cache of this many bytes, compressed "
+             "with --compression_type. Its memory is charged to the block "
+             "cache.");
+
 DEFINE_int64(simcache_size, -1,
              "Number of bytes to use as a simcache of "
              "uncompressed data. Nagative value disables simcache.");
@@ -464,6 +480,16 @@ DEFINE_bool(
     pin_top_level_index_and_filter, false,
     "Pin top-level index of partitioned index/filter blocks in block cache.");
 
+DEFINE_int32(pin_filter_and_index_blocks_up_to_level,
+             rocksdb::BlockBasedTableOptions()
+                 .pin_filter_and_index_blocks_up_to_level,
+             "Pin index/filter blocks of the files at levels up to this one "
+             "in block cache, including all partitions. Negative to disable.");
+
+DEFINE_bool(load_partitions_in_background, false,
+            "Load the index/filter partitions of a file opened in a thread "
+            "of the pool set by -max_background_readaheads.");
+
 DEFINE_int32(block_size,
              static_cast<int32_t>(rocksdb::BlockBasedTableOptions().block_size),
              "Number of bytes in a block.");
@@ -504,6 +530,9 @@ DEFINE_double(data_block_hash_table_util_ratio, 0.75,
               "This is only valid if use_data_block_hash_index is "
               "set to true");
 
+DEFINE_bool(data_block_column_layout, false,
+            "Keep the keys and the values of data blocks in separate arrays");
+
 DEFINE_int64(compressed_cache_size, -1,
              "Number of bytes to use as a cache of compressed data.");
 
@@ -524,6 +553,11 @@ DEFINE_bool(new_table_reader_for_compaction_inputs, true,
 
 DEFINE_int32(compaction_readahead_size, 0, "Compaction readahead size");
 
+DEFINE_int32(max_background_readaheads,
+             rocksdb::Options().max_background_readaheads,
+             "Number of threads doing background readahead for compactions "
+             "and iterators with -async_readahead");
+
 DEFINE_int32(random_access_max_buffer_size, 1024 * 1024,
              "Maximum windows randomaccess buffer size");
 
@@ -746,6 +780,12 @@ DEFINE_bool(fifo_compaction_allow_compaction, true,
 
 DEFINE_uint64(fifo_compaction_ttl, 0, "TTL for the SST Files in seconds.");
 
+// Hybrid Compaction Options
+DEFINE_double(hybrid_target_write_amplification,
+              rocksdb::Options().hybrid_target_write_amplification,
+              "Target write amplification of the last level for hybrid "
+              "compaction. The universal_* flags control the tiered levels.");
+
 // Blob DB Options
 DEFINE_bool(use_blob_db, false,
             "Open a BlobDB instance. "
@@ -851,6 +891,29 @@ static enum rocksdb::CompressionType FLAGS_compression_type_e =
 
 DEFINE_int64(sample_for_compression, 0, "Sample every N block for compression");
 
+DEFINE_string(checksum_type, "crc32c",
+              "Algorithm to checksum the blocks of table files with: none, "
+              "crc32c, xxhash, xxhash64 or xxh3");
+
+static enum rocksdb::ChecksumType StringToChecksumType(const char* ctype) {
+  assert(ctype);
+
+  if (!strcasecmp(ctype, "none"))
+    return rocksdb::kNoChecksum;
+  else if (!strcasecmp(ctype, "crc32c"))
+    return rocksdb::kCRC32c;
+  else if (!strcasecmp(ctype, "xxhash"))
+    return rocksdb::kxxHash;
+  else if (!strcasecmp(ctype, "xxhash64"))
+    return rocksdb::kxxHash64;
+  else if (!strcasecmp(ctype, "xxh3"))
+    return rocksdb::kXXH3;
+
+  fprintf(stdout, "Cannot parse checksum type '%s'\n", ctype);
+  return rocksdb::kCRC32c;  // default value
+}
+static enum rocksdb::ChecksumType FLAGS_checksum_type_e = rocksdb::kCRC32c;
+
 DEFINE_int32(compression_level, rocksdb::CompressionOptions().level,
              "Compression level. The meaning of this value is library-"
              "dependent. If unset, we try to use the default for the library "
@@ -866,6 +929,17 @@ DEFINE_int32(compression_zstd_max_train_bytes,
              "Maximum size of training data passed to zstd's dictionary "
              "trainer.");
 
+DEFINE_int32(compression_parallel_threads,
+             rocksdb::CompressionOptions().parallel_threads,
+             "Number of threads compressing the data blocks of each table "
+             "file.");
+
+DEFINE_int32(compression_shared_dict_files,
+             rocksdb::CompressionOptions().shared_dict_files,
+             "Number of table files of a level that share a compression "
+             "dictionary before a new one is built. 0 to build one per "
+             "file.");
+
 DEFINE_int32(min_level_to_compress, -1, "If non-negative, compression starts"
              " from this level. Levels with number < min_level_to_compress are"
              " not compressed. Otherwise, apply compression_type to "
@@ -960,6 +1034,15 @@ DEFINE_uint64(inplace_update_num_locks,
 DEFINE_bool(enable_write_thread_adaptive_yield, true,
             "Use a yielding spin loop for brief writer thread waits.");
 
+DEFINE_uint64(max_write_batch_group_size_bytes,
+              rocksdb::Options().max_write_batch_group_size_bytes,
+              "Maximum number of bytes written in a single write group.");
+
+DEFINE_bool(adaptive_write_batch_group_size,
+            rocksdb::Options().adaptive_write_batch_group_size,
+            "Adapt the write group size to the observed write latency and "
+            "write arrival rate.");
+
 DEFINE_uint64(
     write_thread_max_yield_usec, 100,
     "Maximum microseconds for enable_write_thread_adaptive_yield operation.");
@@ -1190,6 +1273,7 @@ enum RepFactory {
   kPrefixHash,
   kVectorRep,
   kHashLinkedList,
+  kBPlusTree,
 };
 
 // create Factory for creating S3 Envs
@@ -1242,6 +1326,8 @@ static enum RepFactory StringToRepFactory(const char* ctype) {
     return kVectorRep;
   else if (!strcasecmp(ctype, "hash_linkedlist"))
     return kHashLinkedList;
+  else if (!strcasecmp(ctype, "bplus_tree"))
+    return kBPlusTree;
 
   fprintf(stdout, "Cannot parse memreptable %s\n", ctype);
   return kSkipList;
@@ -1257,9 +1343,15 @@ DEFINE_double(cuckoo_hash_ratio, 0.9, "Hash ratio for Cuckoo SST table.");
 DEFINE_bool(use_hash_search, false, "if use kHashSearch "
             "instead of kBinarySearch. "
             "This is valid if only we use BlockTable");
+DEFINE_bool(use_interpolation_search, false, "if use kInterpolationSearch "
+            "instead of kBinarySearch. "
+            "This is valid if only we use BlockTable");
 DEFINE_bool(use_block_based_filter, false, "if use kBlockBasedFilter "
             "instead of kFullFilter for filter block. "
             "This is valid if only we use BlockTable");
+DEFINE_bool(use_fast_local_bloom, false, "Build full filters with "
+            "BloomFilterImpl::kFastLocal (cache-local, SIMD query) instead "
+            "of the legacy format");
 DEFINE_string(merge_operator, "", "The merge operator to use with the database."
               "If a new merge operator is specified, be sure to use fresh"
               " database The possible merge operators are defined in"
@@ -1270,6 +1362,8 @@ DEFINE_int32(skip_list_lookahead, 0, "Used with skip_list memtablerep; try "
 DEFINE_bool(report_file_operations, false, "if report number of file "
             "operations");
 DEFINE_int32(readahead_size, 0, "Iterator readahead size");
+DEFINE_bool(async_readahead, false,
+            "Read the next readahead window of iterators in the background");
 
 static const bool FLAGS_soft_rate_limit_dummy __attribute__((__unused__)) =
     RegisterFlagValidator(&FLAGS_soft_rate_limit, &ValidateRateLimit);
@@ -2323,6 +2417,9 @@ class Benchmark {
       case kHashLinkedList:
         fprintf(stdout, "Memtablerep: hash_linkedlist\n");
         break;
+      case kBPlusTree:
+        fprintf(stdout, "Memtablerep: bplus_tree\n");
+        break;
     }
     fprintf(stdout, "Perf Level: %d\n", FLAGS_perf_level);
 
@@ -2460,7 +2557,8 @@ class Benchmark {
     const char* Name() const override { return "KeepFilter"; }
   };
 
-  std::shared_ptr<Cache> NewCache(int64_t capacity) {
+  std::shared_ptr<Cache> NewCache(int64_t capacity,
+                                  int64_t secondary_capacity = 0) {
     if (capacity <= 0) {
       return nullptr;
     }
@@ -2473,19 +2571,38 @@ class Benchmark {
       }
       return cache;
     } else {
-      return NewLRUCache(
+      LRUCacheOptions opts(
           static_cast<size_t>(capacity), FLAGS_cache_numshardbits,
           false /*strict_capacity_limit*/, FLAGS_cache_high_pri_pool_ratio);
+      if (FLAGS_use_slab_allocator) {
+        Status s = NewSlabMemoryAllocator(SlabMemoryAllocatorOptions(),
+                                          &opts.memory_allocator);
+        if (!s.ok()) {
+          fprintf(stderr, "Failed to create slab allocator: %s\n",
+                  s.ToString().c_str());
+          exit(1);
+        }
+      }
+      if (secondary_capacity > 0) {
+        opts.secondary_cache =
+            NewCompressedSecondaryCache(CompressedSecondaryCacheOptions(
+                static_cast<size_t>(secondary_capacity),
+                FLAGS_cache_numshardbits, FLAGS_compression_type_e));
+      }
+      return NewLRUCache(opts);
     }
   }
 
  public:
   Benchmark()
-      : cache_(NewCache(FLAGS_cache_size)),
+      : cache_(NewCache(FLAGS_cache_size, FLAGS_secondary_cache_size)),
         compressed_cache_(NewCache(FLAGS_compressed_cache_size)),
         filter_policy_(FLAGS_bloom_bits >= 0
-                           ? NewBloomFilterPolicy(FLAGS_bloom_bits,
-                                                  FLAGS_use_block_based_filter)
+                           ? NewBloomFilterPolicy(
+                                 FLAGS_bloom_bits, FLAGS_use_block_based_filter,
+                                 FLAGS_use_fast_local_bloom
+                                     ? BloomFilterImpl::kFastLocal
+                                     : BloomFilterImpl::kLegacy)
                            : nullptr),
         prefix_extractor_(NewFixedPrefixTransform(FLAGS_prefix_size)),
         num_(FLAGS_num),
@@ -3471,6 +3588,8 @@ class Benchmark {
     options.compaction_options_fifo = CompactionOptionsFIFO(
         FLAGS_fifo_compaction_max_table_files_size_mb * 1024 * 1024,
         FLAGS_fifo_compaction_allow_compaction);
+    options.hybrid_target_write_amplification =
+        FLAGS_hybrid_target_write_amplification;
 #endif  // ROCKSDB_LITE
     if (FLAGS_prefix_size != 0) {
       options.prefix_extractor.reset(
@@ -3499,6 +3618,7 @@ class Benchmark {
     options.new_table_reader_for_compaction_inputs =
         FLAGS_new_table_reader_for_compaction_inputs;
     options.compaction_readahead_size = FLAGS_compaction_readahead_size;
+    options.max_background_readaheads = FLAGS_max_background_readaheads;
     options.random_access_max_buffer_size = FLAGS_random_access_max_buffer_size;
     options.writable_file_max_buffer_size = FLAGS_writable_file_max_buffer_size;
     options.use_fsync = FLAGS_use_fsync;
@@ -3535,6 +3655,9 @@ class Benchmark {
           new VectorRepFactory
         );
         break;
+      case kBPlusTree:
+        options.memtable_factory.reset(new BPlusTreeRepFactory);
+        break;
 #else
       default:
         fprintf(stderr, "Only skip list is supported in lite mode\n");
@@ -3593,6 +3716,9 @@ class Benchmark {
           exit(1);
         }
         block_based_options.index_type = BlockBasedTableOptions::kHashSearch;
+      } else if (FLAGS_use_interpolation_search) {
+        block_based_options.index_type =
+            BlockBasedTableOptions::kInterpolationSearch;
       } else {
         block_based_options.index_type = BlockBasedTableOptions::kBinarySearch;
       }
@@ -3618,6 +3744,10 @@ class Benchmark {
           FLAGS_pin_l0_filter_and_index_blocks_in_cache;
       block_based_options.pin_top_level_index_and_filter =
           FLAGS_pin_top_level_index_and_filter;
+      block_based_options.pin_filter_and_index_blocks_up_to_level =
+          FLAGS_pin_filter_and_index_blocks_up_to_level;
+      block_based_options.load_partitions_in_background =
+          FLAGS_load_partitions_in_background;
       if (FLAGS_cache_high_pri_pool_ratio > 1e-6) {  // > 0.0 + eps
         block_based_options.cache_index_and_filter_blocks_with_high_priority =
             true;
@@ -3631,6 +3761,7 @@ class Benchmark {
       block_based_options.filter_policy = filter_policy_;
       block_based_options.format_version =
           static_cast<uint32_t>(FLAGS_format_version);
+      block_based_options.checksum = FLAGS_checksum_type_e;
       block_based_options.read_amp_bytes_per_bit = FLAGS_read_amp_bytes_per_bit;
       block_based_options.enable_index_compression =
           FLAGS_enable_index_compression;
@@ -3644,6 +3775,8 @@ class Benchmark {
       }
       block_based_options.data_block_hash_table_util_ratio =
           FLAGS_data_block_hash_table_util_ratio;
+      block_based_options.data_block_column_layout =
+          FLAGS_data_block_column_layout;
       if (FLAGS_read_cache_path != "") {
 #ifndef ROCKSDB_LITE
         Status rc_status;
@@ -3734,6 +3867,10 @@ class Benchmark {
         FLAGS_enable_write_thread_adaptive_yield;
     options.enable_pipelined_write = FLAGS_enable_pipelined_write;
     options.unordered_write = FLAGS_unordered_write;
+    options.max_write_batch_group_size_bytes =
+        FLAGS_max_write_batch_group_size_bytes;
+    options.adaptive_write_batch_group_size =
+        FLAGS_adaptive_write_batch_group_size;
     options.write_thread_max_yield_usec = FLAGS_write_thread_max_yield_usec;
     options.write_thread_slow_yield_usec = FLAGS_write_thread_slow_yield_usec;
     options.rate_limit_delay_max_milliseconds =
@@ -3822,6 +3959,10 @@ class Benchmark {
     options.compression_opts.max_dict_bytes = FLAGS_compression_max_dict_bytes;
     options.compression_opts.zstd_max_train_bytes =
         FLAGS_compression_zstd_max_train_bytes;
+    options.compression_opts.parallel_threads =
+        FLAGS_compression_parallel_threads;
+    options.compression_opts.shared_dict_files =
+        FLAGS_compression_shared_dict_files;
     // If this is a block based table, set some related options
     if (options.table_factory->Name() == BlockBasedTableFactory::kName &&
         options.table_factory->GetOptions() != nullptr) {
@@ -3833,7 +3974,9 @@ class Benchmark {
       }
       if (FLAGS_bloom_bits >= 0) {
         table_options->filter_policy.reset(NewBloomFilterPolicy(
-            FLAGS_bloom_bits, FLAGS_use_block_based_filter));
+            FLAGS_bloom_bits, FLAGS_use_block_based_filter,
+            FLAGS_use_fast_local_bloom ? BloomFilterImpl::kFastLocal
+                                       : BloomFilterImpl::kLegacy));
       }
     }
     if (FLAGS_row_cache_size) {
@@ -4650,6 +4793,8 @@ class Benchmark {
   void ReadSequential(ThreadState* thread, DB* db) {
     ReadOptions options(FLAGS_verify_checksum, true);
     options.tailing = FLAGS_use_tailing_iterator;
+    options.readahead_size = FLAGS_readahead_size;
+    options.async_readahead = FLAGS_async_readahead;
 
     Iterator* iter = db->NewIterator(options);
     int64_t i = 0;
@@ -5272,6 +5417,7 @@ class Benchmark {
     options.prefix_same_as_start = FLAGS_prefix_same_as_start;
     options.tailing = FLAGS_use_tailing_iterator;
     options.readahead_size = FLAGS_readahead_size;
+    options.async_readahead = FLAGS_async_readahead;
 
     Iterator* single_iter = nullptr;
     std::vector<Iterator*> multi_iters;
@@ -5293,6 +5439,11 @@ class Benchmark {
 
     Duration duration(FLAGS_duration, reads_);
     char value_buffer[256];
+    const size_t batch_size =
+        static_cast<size_t>(std::max(FLAGS_seek_nexts_batch_size, 1));
+    std::vector<Slice> batch_keys(batch_size);
+    std::vector<Slice> batch_values(batch_size);
+    std::string batch_buf;
     while (!duration.Done(1)) {
       int64_t seek_pos = thread->rand.Next() % FLAGS_num;
       GenerateKeyFromIntForSeek(static_cast<uint64_t>(seek_pos), FLAGS_num,
@@ -5339,7 +5490,23 @@ class Benchmark {
         found++;
       }
 
-      for (int j = 0; j < FLAGS_seek_nexts && iter_to_use->Valid(); ++j) {
+      int remaining = FLAGS_seek_nexts;
+      while (FLAGS_seek_nexts_batch_size > 0 && !FLAGS_reverse_iterator &&
+             remaining > 0 && iter_to_use->Valid()) {
+        size_t n = iter_to_use->NextN(
+            std::min(batch_size, static_cast<size_t>(remaining)),
+            batch_keys.data(), batch_values.data(), &batch_buf);
+        for (size_t j = 0; j < n; ++j) {
+          // Copy out iterator's value to make sure we read them.
+          memcpy(value_buffer, batch_values[j].data(),
+                 std::min(batch_values[j].size(), sizeof(value_buffer)));
+          bytes += batch_keys[j].size() + batch_values[j].size();
+        }
+        remaining -= static_cast<int>(n);
+        assert(iter_to_use->status().ok());
+      }
+
+      for (int j = 0; j < remaining && iter_to_use->Valid(); ++j) {
         // Copy out iterator's value to make sure we read them.
         Slice value = iter_to_use->value();
         memcpy(value_buffer, value.data(),
@@ -6628,6 +6795,7 @@ int db_bench_tool(int argc, char** argv) {
 
   FLAGS_compression_type_e =
     StringToCompressionType(FLAGS_compression_type.c_str());
+  FLAGS_checksum_type_e = StringToChecksumType(FLAGS_checksum_type.c_str());
 
 #ifndef ROCKSDB_LITE
   if (!FLAGS_hdfs.empty() && !FLAGS_env_uri.empty()) {
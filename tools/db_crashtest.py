@@ -31,6 +31,8 @@ default_params = {
     "compression_type": "snappy",
     "compression_max_dict_bytes": lambda: 16384 * random.randint(0, 1),
     "compression_zstd_max_train_bytes": lambda: 65536 * random.randint(0, 1),
+    "compression_parallel_threads": lambda: random.choice([1, 1, 4]),
+    "compression_shared_dict_files": lambda: random.choice([0, 0, 4]),
     "clear_column_family_one_in": 0,
     "compact_files_one_in": 1000000,
     "compact_range_one_in": 1000000,
@@ -42,7 +44,7 @@ default_params = {
     "expected_values_path": expected_values_file.name,
     "flush_one_in": 1000000,
     # Temporarily disable hash index
-    "index_type": lambda: random.choice([0, 2]),
+    "index_type": lambda: random.choice([0, 2, 4]),
     "max_background_compactions": 20,
     "max_bytes_for_level_base": 10485760,
     "max_key": 100000000,
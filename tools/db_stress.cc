@@ -619,6 +619,15 @@ DEFINE_int32(compression_zstd_max_train_bytes, 0,
              "Maximum size of training data passed to zstd's dictionary "
              "trainer.");
 
+DEFINE_int32(compression_parallel_threads, 1,
+             "Number of threads compressing the data blocks of each table "
+             "file.");
+
+DEFINE_int32(compression_shared_dict_files, 0,
+             "Number of table files of a level that share a compression "
+             "dictionary before a new one is built. 0 to build one per "
+             "file.");
+
 DEFINE_string(checksum_type, "kCRC32c", "Algorithm to use to checksum blocks");
 static enum rocksdb::ChecksumType FLAGS_checksum_type_e = rocksdb::kCRC32c;
 
@@ -648,7 +657,8 @@ static std::shared_ptr<rocksdb::Statistics> dbstats_secondaries;
 enum RepFactory {
   kSkipList,
   kHashSkipList,
-  kVectorRep
+  kVectorRep,
+  kBPlusTree
 };
 
 namespace {
@@ -661,6 +671,8 @@ enum RepFactory StringToRepFactory(const char* ctype) {
     return kHashSkipList;
   else if (!strcasecmp(ctype, "vector"))
     return kVectorRep;
+  else if (!strcasecmp(ctype, "bplus_tree"))
+    return kBPlusTree;
 
   fprintf(stdout, "Cannot parse memreptable %s\n", ctype);
   return kSkipList;
@@ -2746,6 +2758,9 @@ class StressTest {
       case kVectorRep:
         memtablerep = "vector";
         break;
+      case kBPlusTree:
+        memtablerep = "bplus_tree";
+        break;
     }
 
     fprintf(stdout, "Memtablerep               : %s\n", memtablerep);
@@ -2836,6 +2851,10 @@ class StressTest {
           FLAGS_compression_max_dict_bytes;
       options_.compression_opts.zstd_max_train_bytes =
           FLAGS_compression_zstd_max_train_bytes;
+      options_.compression_opts.parallel_threads =
+          FLAGS_compression_parallel_threads;
+      options_.compression_opts.shared_dict_files =
+          FLAGS_compression_shared_dict_files;
       options_.create_if_missing = true;
       options_.max_manifest_file_size = FLAGS_max_manifest_file_size;
       options_.inplace_update_support = FLAGS_in_place_update;
@@ -2906,6 +2925,9 @@ class StressTest {
       case kVectorRep:
         options_.memtable_factory.reset(new VectorRepFactory());
         break;
+      case kBPlusTree:
+        options_.memtable_factory.reset(new BPlusTreeRepFactory());
+        break;
 #else
       default:
         fprintf(stderr,
@@ -9,6 +9,9 @@
 
 #include "rocksdb/filter_policy.h"
 
+#include <algorithm>
+#include <array>
+
 #include "rocksdb/slice.h"
 #include "table/block_based/block_based_filter_block.h"
 #include "table/block_based/full_filter_block.h"
@@ -17,6 +20,7 @@
 #include "util/bloom_impl.h"
 #include "util/coding.h"
 #include "util/hash.h"
+#include "util/xor_filter_impl.h"
 
 namespace rocksdb {
 
@@ -133,6 +137,335 @@ inline void FullFilterBitsBuilder::AddHash(uint32_t h, char* data,
 }
 
 namespace {
+
+// Metadata trailer common to all full filter formats. The legacy format
+// stores num_probes (1..30) in the first byte, so a first byte with a
+// negative value marks one of the newer formats.
+//
+// +-----------------------------------------------------------------+
+// |          filter data: len_bytes (a multiple of 64 bytes)        |
+// +-----------------------------------------------------------------+
+// | -1 : 1 byte | sub-impl : 1 byte | num_probes : 1 byte | 2 bytes |
+// +-----------------------------------------------------------------+
+static const uint32_t kMetadataLen = 5;
+static const char kNewImplMarker = static_cast<char>(-1);
+static const char kFastLocalBloomSubImpl = 0;
+// For XOR filters, the last two bytes hold the construction seed
+static const char kXorFilterSubImpl = 1;
+
+class FastLocalBloomBitsBuilder : public FilterBitsBuilder {
+ public:
+  explicit FastLocalBloomBitsBuilder(const int bits_per_key)
+      : bits_per_key_(bits_per_key),
+        num_probes_(FastLocalBloomImpl::ChooseNumProbes(bits_per_key * 1000)) {
+    assert(bits_per_key_);
+  }
+
+  // No Copy allowed
+  FastLocalBloomBitsBuilder(const FastLocalBloomBitsBuilder&) = delete;
+  void operator=(const FastLocalBloomBitsBuilder&) = delete;
+
+  ~FastLocalBloomBitsBuilder() override {}
+
+  void AddKey(const Slice& key) override { AddHash(GetSliceHash64(key)); }
+
+  void AddHash(uint64_t hash) {
+    if (hash_entries_.size() == 0 || hash != hash_entries_.back()) {
+      hash_entries_.push_back(hash);
+    }
+  }
+
+  Slice Finish(std::unique_ptr<const char[]>* buf) override {
+    uint32_t len_with_metadata =
+        CalculateSpace(static_cast<int>(hash_entries_.size()));
+    char* data = new char[len_with_metadata];
+    memset(data, 0, len_with_metadata);
+
+    assert(data);
+    assert(len_with_metadata >= kMetadataLen);
+
+    uint32_t len = len_with_metadata - kMetadataLen;
+    if (len > 0) {
+      AddAllEntries(data, len);
+    }
+
+    data[len] = kNewImplMarker;
+    data[len + 1] = kFastLocalBloomSubImpl;
+    data[len + 2] = static_cast<char>(num_probes_);
+    // rest of metadata stays zero
+
+    const char* const_data = data;
+    buf->reset(const_data);
+    hash_entries_.clear();
+
+    return Slice(data, len_with_metadata);
+  }
+
+  int CalculateNumEntry(const uint32_t space) override {
+    assert(bits_per_key_);
+    assert(space > 0);
+    if (space <= kMetadataLen) {
+      return 0;
+    }
+    uint32_t num_cache_lines = (space - kMetadataLen) / 64;
+    return static_cast<int>(uint64_t{num_cache_lines} * 512 / bits_per_key_);
+  }
+
+  uint32_t CalculateSpace(const int num_entry) {
+    // Round up to nearest multiple of 64 (in bytes); no need for the odd
+    // number of lines the legacy format uses, since fastrange32 mixes all
+    // bits of the hash into the choice of cache line.
+    uint64_t num_cache_lines =
+        (uint64_t{static_cast<uint32_t>(num_entry)} * bits_per_key_ + 511) /
+        512;
+    return static_cast<uint32_t>(num_cache_lines * 64) + kMetadataLen;
+  }
+
+ private:
+  void AddAllEntries(char* data, uint32_t len) {
+    // Simple prefetching: compute the cache line of an entry a few entries
+    // ahead of adding it, so that the memory latency of the random writes
+    // overlaps.
+    const size_t num_entries = hash_entries_.size();
+    constexpr size_t kBufferMask = 7;
+    static_assert(((kBufferMask + 1) & kBufferMask) == 0,
+                  "Must be power of 2 minus 1");
+
+    std::array<uint32_t, kBufferMask + 1> hashes;
+    std::array<uint32_t, kBufferMask + 1> byte_offsets;
+
+    // Prime the buffer
+    size_t i = 0;
+    for (; i <= kBufferMask && i < num_entries; ++i) {
+      uint64_t h = hash_entries_[i];
+      FastLocalBloomImpl::PrepareHash(Lower32of64(h), len, data,
+                                      /*out*/ &byte_offsets[i]);
+      hashes[i] = Upper32of64(h);
+    }
+
+    // Process and buffer
+    for (; i < num_entries; ++i) {
+      uint32_t& hash_ref = hashes[i & kBufferMask];
+      uint32_t& byte_offset_ref = byte_offsets[i & kBufferMask];
+      // Process (add)
+      FastLocalBloomImpl::AddHashPrepared(hash_ref, num_probes_,
+                                          data + byte_offset_ref);
+      // And buffer
+      uint64_t h = hash_entries_[i];
+      FastLocalBloomImpl::PrepareHash(Lower32of64(h), len, data,
+                                      /*out*/ &byte_offset_ref);
+      hash_ref = Upper32of64(h);
+    }
+
+    // Finish processing
+    for (i = 0; i <= kBufferMask && i < num_entries; ++i) {
+      FastLocalBloomImpl::AddHashPrepared(hashes[i], num_probes_,
+                                          data + byte_offsets[i]);
+    }
+  }
+
+  static uint32_t Lower32of64(uint64_t v) { return static_cast<uint32_t>(v); }
+  static uint32_t Upper32of64(uint64_t v) {
+    return static_cast<uint32_t>(v >> 32);
+  }
+
+  int bits_per_key_;
+  int num_probes_;
+  std::vector<uint64_t> hash_entries_;
+};
+
+class FastLocalBloomBitsReader : public FilterBitsReader {
+ public:
+  FastLocalBloomBitsReader(const char* data, int num_probes,
+                           uint32_t len_bytes)
+      : data_(data), num_probes_(num_probes), len_bytes_(len_bytes) {}
+
+  // No Copy allowed
+  FastLocalBloomBitsReader(const FastLocalBloomBitsReader&) = delete;
+  void operator=(const FastLocalBloomBitsReader&) = delete;
+
+  ~FastLocalBloomBitsReader() override {}
+
+  bool MayMatch(const Slice& key) override {
+    uint64_t h = GetSliceHash64(key);
+    uint32_t byte_offset;
+    FastLocalBloomImpl::PrepareHash(static_cast<uint32_t>(h), len_bytes_,
+                                    data_, /*out*/ &byte_offset);
+    return FastLocalBloomImpl::HashMayMatchPrepared(
+        static_cast<uint32_t>(h >> 32), num_probes_, data_ + byte_offset);
+  }
+
+  virtual void MayMatch(int num_keys, Slice** keys, bool* may_match) override {
+    uint32_t hashes[MultiGetContext::MAX_BATCH_SIZE];
+    uint32_t byte_offsets[MultiGetContext::MAX_BATCH_SIZE];
+    for (int i = 0; i < num_keys; ++i) {
+      uint64_t h = GetSliceHash64(*keys[i]);
+      FastLocalBloomImpl::PrepareHash(static_cast<uint32_t>(h), len_bytes_,
+                                      data_, /*out*/ &byte_offsets[i]);
+      hashes[i] = static_cast<uint32_t>(h >> 32);
+    }
+    for (int i = 0; i < num_keys; ++i) {
+      may_match[i] = FastLocalBloomImpl::HashMayMatchPrepared(
+          hashes[i], num_probes_, data_ + byte_offsets[i]);
+    }
+  }
+
+ private:
+  const char* data_;
+  const int num_probes_;
+  const uint32_t len_bytes_;
+};
+
+// Used for filters of an unknown or broken format
+class AlwaysTrueFilter : public FilterBitsReader {
+ public:
+  bool MayMatch(const Slice&) override { return true; }
+  using FilterBitsReader::MayMatch;  // inherit overload
+};
+
+class XorFilterBitsBuilder : public FilterBitsBuilder {
+ public:
+  explicit XorFilterBitsBuilder(const int bits_per_key)
+      : bits_per_key_(bits_per_key),
+        fp_bits_(XorFilterImpl::ChooseFingerprintBits(bits_per_key)) {
+    assert(bits_per_key_);
+  }
+
+  // No Copy allowed
+  XorFilterBitsBuilder(const XorFilterBitsBuilder&) = delete;
+  void operator=(const XorFilterBitsBuilder&) = delete;
+
+  ~XorFilterBitsBuilder() override {}
+
+  void AddKey(const Slice& key) override {
+    uint64_t hash = GetSliceHash64(key);
+    if (hash_entries_.size() == 0 || hash != hash_entries_.back()) {
+      hash_entries_.push_back(hash);
+    }
+  }
+
+  Slice Finish(std::unique_ptr<const char[]>* buf) override {
+    // Keys are sorted, but whole keys and prefixes are interleaved, so
+    // duplicates are not necessarily adjacent. The filter cannot be
+    // solved with duplicate hashes.
+    std::sort(hash_entries_.begin(), hash_entries_.end());
+    hash_entries_.erase(std::unique(hash_entries_.begin(), hash_entries_.end()),
+                        hash_entries_.end());
+
+    uint32_t num_entries = static_cast<uint32_t>(hash_entries_.size());
+    if (num_entries == 0) {
+      // Same as an empty Bloom filter; matches nothing
+      return FastLocalBloomBitsBuilder(bits_per_key_).Finish(buf);
+    }
+    uint32_t segment_length = XorFilterImpl::GetSegmentLength(num_entries);
+    uint32_t len = XorFilterImpl::GetDataLength(segment_length, fp_bits_);
+    uint32_t len_with_metadata = len + kMetadataLen;
+    char* data = new char[len_with_metadata];
+    memset(data, 0, len_with_metadata);
+    EncodeFixed32(data, segment_length);
+
+    char* slots_data = data + XorFilterImpl::kHeaderLen;
+    uint32_t seed = 0;
+    for (; seed < kMaxSeeds; ++seed) {
+      if (XorFilterImpl::Build(hash_entries_, seed, segment_length, fp_bits_,
+                               slots_data)) {
+        break;
+      }
+    }
+    if (seed == kMaxSeeds) {
+      // Practically impossible except with an extremely poor hash function,
+      // but always have a working filter.
+      delete[] data;
+      FastLocalBloomBitsBuilder fallback(bits_per_key_);
+      for (uint64_t h : hash_entries_) {
+        fallback.AddHash(h);
+      }
+      hash_entries_.clear();
+      return fallback.Finish(buf);
+    }
+
+    data[len] = kNewImplMarker;
+    data[len + 1] = kXorFilterSubImpl;
+    data[len + 2] = static_cast<char>(fp_bits_);
+    data[len + 3] = static_cast<char>(seed & 0xff);
+    data[len + 4] = static_cast<char>(seed >> 8);
+
+    const char* const_data = data;
+    buf->reset(const_data);
+    hash_entries_.clear();
+
+    return Slice(data, len_with_metadata);
+  }
+
+  int CalculateNumEntry(const uint32_t space) override {
+    assert(bits_per_key_);
+    assert(space > 0);
+    // Upper bound first, then step down to the exact answer
+    int n = static_cast<int>(uint64_t{space} * 8 / fp_bits_ * 100 / 123);
+    for (; n > 0; --n) {
+      if (CalculateSpace(n) <= space) {
+        break;
+      }
+    }
+    return n;
+  }
+
+  uint32_t CalculateSpace(const int num_entry) {
+    uint32_t segment_length =
+        XorFilterImpl::GetSegmentLength(static_cast<uint32_t>(num_entry));
+    return XorFilterImpl::GetDataLength(segment_length, fp_bits_) +
+           kMetadataLen;
+  }
+
+ private:
+  static const uint32_t kMaxSeeds = 1000;
+
+  int bits_per_key_;
+  int fp_bits_;
+  std::vector<uint64_t> hash_entries_;
+};
+
+class XorFilterBitsReader : public FilterBitsReader {
+ public:
+  XorFilterBitsReader(const char* slots_data, uint32_t segment_length,
+                      int fp_bits, uint32_t seed)
+      : slots_data_(slots_data),
+        segment_length_(segment_length),
+        fp_bits_(fp_bits),
+        seed_(seed) {}
+
+  // No Copy allowed
+  XorFilterBitsReader(const XorFilterBitsReader&) = delete;
+  void operator=(const XorFilterBitsReader&) = delete;
+
+  ~XorFilterBitsReader() override {}
+
+  bool MayMatch(const Slice& key) override {
+    return XorFilterImpl::HashMayMatch(GetSliceHash64(key), seed_,
+                                       segment_length_, fp_bits_, slots_data_);
+  }
+
+  virtual void MayMatch(int num_keys, Slice** keys, bool* may_match) override {
+    uint64_t hashes[MultiGetContext::MAX_BATCH_SIZE];
+    uint32_t slots[MultiGetContext::MAX_BATCH_SIZE][3];
+    for (int i = 0; i < num_keys; ++i) {
+      XorFilterImpl::PrepareHash(GetSliceHash64(*keys[i]), seed_,
+                                 segment_length_, fp_bits_, slots_data_,
+                                 &hashes[i], slots[i]);
+    }
+    for (int i = 0; i < num_keys; ++i) {
+      may_match[i] = XorFilterImpl::HashMayMatchPrepared(
+          hashes[i], slots[i], fp_bits_, slots_data_);
+    }
+  }
+
+ private:
+  const char* slots_data_;
+  const uint32_t segment_length_;
+  const int fp_bits_;
+  const uint32_t seed_;
+};
+
 class FullFilterBitsReader : public FilterBitsReader {
  public:
   explicit FullFilterBitsReader(const Slice& contents)
@@ -252,9 +585,11 @@ void FullFilterBitsReader::GetFilterMeta(const Slice& filter,
 // An implementation of filter policy
 class BloomFilterPolicy : public FilterPolicy {
  public:
-  explicit BloomFilterPolicy(int bits_per_key, bool use_block_based_builder)
+  explicit BloomFilterPolicy(int bits_per_key, bool use_block_based_builder,
+                             BloomFilterImpl impl)
       : bits_per_key_(bits_per_key), hash_func_(BloomHash),
-        use_block_based_builder_(use_block_based_builder) {
+        use_block_based_builder_(use_block_based_builder),
+        impl_(impl) {
     initialize();
   }
 
@@ -308,23 +643,57 @@ class BloomFilterPolicy : public FilterPolicy {
       return nullptr;
     }
 
+    if (impl_ == BloomFilterImpl::kFastLocal) {
+      return new FastLocalBloomBitsBuilder(bits_per_key_);
+    }
     return new FullFilterBitsBuilder(bits_per_key_, num_probes_);
   }
 
+  // Independent of impl_, so that filters of all formats can be read
   FilterBitsReader* GetFilterBitsReader(const Slice& contents) const override {
-    return new FullFilterBitsReader(contents);
+    uint32_t len_with_meta = static_cast<uint32_t>(contents.size());
+    if (len_with_meta <= kMetadataLen ||
+        contents.data()[len_with_meta - kMetadataLen] != kNewImplMarker) {
+      // Legacy format, or empty filter which the legacy reader handles
+      return new FullFilterBitsReader(contents);
+    }
+    uint32_t len = len_with_meta - kMetadataLen;
+    char sub_impl = contents.data()[len + 1];
+    int num_probes = static_cast<uint8_t>(contents.data()[len + 2]);
+    if (sub_impl == kFastLocalBloomSubImpl && num_probes >= 1 &&
+        num_probes <= 30 && len % 64 == 0) {
+      return new FastLocalBloomBitsReader(contents.data(), num_probes, len);
+    }
+    if (sub_impl == kXorFilterSubImpl && len > XorFilterImpl::kHeaderLen) {
+      int fp_bits = num_probes;
+      uint32_t segment_length = DecodeFixed32(contents.data());
+      uint32_t seed = static_cast<uint8_t>(contents.data()[len + 3]) |
+                      (uint32_t{static_cast<uint8_t>(contents.data()[len + 4])}
+                       << 8);
+      if (fp_bits >= 1 && fp_bits <= XorFilterImpl::kMaxFingerprintBits &&
+          segment_length > 0 &&
+          XorFilterImpl::GetDataLength(segment_length, fp_bits) == len) {
+        return new XorFilterBitsReader(
+            contents.data() + XorFilterImpl::kHeaderLen, segment_length,
+            fp_bits, seed);
+      }
+    }
+    // Reserved for future formats, or broken
+    return new AlwaysTrueFilter();
   }
 
   // If choose to use block based builder
   bool UseBlockBasedBuilder() { return use_block_based_builder_; }
 
- private:
+ protected:
   int bits_per_key_;
   int num_probes_;
   uint32_t (*hash_func_)(const Slice& key);
 
   const bool use_block_based_builder_;
+  const BloomFilterImpl impl_;
 
+ private:
   void initialize() {
     // We intentionally round down to reduce probing cost a little bit
     num_probes_ = static_cast<int>(bits_per_key_ * 0.69);  // 0.69 =~ ln(2)
@@ -333,11 +702,44 @@ class BloomFilterPolicy : public FilterPolicy {
   }
 };
 
+// XOR filters for the last levels, fast local Bloom filters above
+class XorFilterPolicy : public BloomFilterPolicy {
+ public:
+  XorFilterPolicy(int bits_per_key, int bloom_before_level)
+      : BloomFilterPolicy(bits_per_key, false /* use_block_based_builder */,
+                          BloomFilterImpl::kFastLocal),
+        bloom_before_level_(bloom_before_level) {}
+
+  ~XorFilterPolicy() override {}
+
+  FilterBitsBuilder* GetFilterBitsBuilder() const override {
+    return new XorFilterBitsBuilder(bits_per_key_);
+  }
+
+  FilterBitsBuilder* GetBuilderWithContext(
+      const FilterBuildingContext& context) const override {
+    if (context.level_at_creation >= 0 &&
+        context.level_at_creation < bloom_before_level_) {
+      return BloomFilterPolicy::GetFilterBitsBuilder();
+    }
+    return GetFilterBitsBuilder();
+  }
+
+ private:
+  const int bloom_before_level_;
+};
+
 }  // namespace
 
 const FilterPolicy* NewBloomFilterPolicy(int bits_per_key,
-                                         bool use_block_based_builder) {
-  return new BloomFilterPolicy(bits_per_key, use_block_based_builder);
+                                         bool use_block_based_builder,
+                                         BloomFilterImpl impl) {
+  return new BloomFilterPolicy(bits_per_key, use_block_based_builder, impl);
+}
+
+const FilterPolicy* NewXorFilterPolicy(int bits_per_key,
+                                       int bloom_before_level) {
+  return new XorFilterPolicy(bits_per_key, bloom_before_level);
 }
 
 }  // namespace rocksdb
@@ -7,28 +7,26 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 
-#ifndef GFLAGS
-#include <cstdio>
-int main() {
-  fprintf(stderr, "Please install gflags to run this test... Skipping...\n");
-  return 0;
-}
-#else
-
 #include <vector>
 
 #include "logging/logging.h"
 #include "memory/arena.h"
 #include "rocksdb/filter_policy.h"
+#include "rocksdb/table.h"
 #include "table/full_filter_bits_builder.h"
 #include "test_util/testharness.h"
 #include "test_util/testutil.h"
+#include "util/bloom_impl.h"
 #include "util/hash.h"
-#include "util/gflags_compat.h"
+#include "util/random.h"
 
+#ifndef GFLAGS
+const int32_t FLAGS_bits_per_key = 10;
+#else
+#include "util/gflags_compat.h"
 using GFLAGS_NAMESPACE::ParseCommandLineFlags;
-
 DEFINE_int32(bits_per_key, 10, "");
+#endif  // GFLAGS
 
 namespace rocksdb {
 
@@ -253,6 +251,8 @@ class FullBloomTest : public testing::Test {
     Reset();
   }
 
+  FilterBitsBuilder* GetBitsBuilder() { return bits_builder_.get(); }
+
   FullFilterBitsBuilder* GetFullFilterBitsBuilder() {
     return dynamic_cast<FullFilterBitsBuilder*>(bits_builder_.get());
   }
@@ -458,13 +458,417 @@ TEST_F(FullBloomTest, Schema) {
   ResetPolicy();
 }
 
+TEST_F(FullBloomTest, FastLocalFilterSize) {
+  for (int bpk : {1, 5, 10, 16, 23}) {
+    ResetPolicy(NewBloomFilterPolicy(bpk, false, BloomFilterImpl::kFastLocal));
+    for (int n = 1; n < 3000; n = NextLength(n)) {
+      char buffer[sizeof(int)];
+      for (int i = 0; i < n; i++) {
+        Add(Key(i, buffer));
+      }
+      Build();
+      size_t space = FilterSize();
+      ASSERT_EQ((space - 5) % 64, 0U);
+      // Any number of entries reported to fit must build a filter no larger
+      int n2 = GetBitsBuilder()->CalculateNumEntry(static_cast<uint32_t>(space));
+      ASSERT_GE(n2, n);
+      Reset();
+      for (int i = 0; i < n2; i++) {
+        Add(Key(i, buffer));
+      }
+      Build();
+      ASSERT_EQ(space, FilterSize());
+      Reset();
+    }
+  }
+}
+
+TEST_F(FullBloomTest, FastLocalEmptyFilter) {
+  ResetPolicy(NewBloomFilterPolicy(FLAGS_bits_per_key, false,
+                                   BloomFilterImpl::kFastLocal));
+  ASSERT_TRUE(!Matches("hello"));
+  ASSERT_TRUE(!Matches("world"));
+}
+
+TEST_F(FullBloomTest, FastLocalSmall) {
+  ResetPolicy(NewBloomFilterPolicy(FLAGS_bits_per_key, false,
+                                   BloomFilterImpl::kFastLocal));
+  Add("hello");
+  Add("world");
+  ASSERT_TRUE(Matches("hello"));
+  ASSERT_TRUE(Matches("world"));
+  ASSERT_TRUE(!Matches("x"));
+  ASSERT_TRUE(!Matches("foo"));
+}
+
+TEST_F(FullBloomTest, FastLocalVaryingLengths) {
+  char buffer[sizeof(int)];
+  ResetPolicy(NewBloomFilterPolicy(10, false, BloomFilterImpl::kFastLocal));
+
+  int mediocre_filters = 0;
+  int good_filters = 0;
+
+  for (int length = 1; length <= 10000; length = NextLength(length)) {
+    Reset();
+    for (int i = 0; i < length; i++) {
+      Add(Key(i, buffer));
+    }
+    Build();
+
+    // No rounding to an odd number of cache lines
+    ASSERT_LE(FilterSize(), (size_t)((length * 10 / 8) + 64 + 5));
+
+    for (int i = 0; i < length; i++) {
+      ASSERT_TRUE(Matches(Key(i, buffer)))
+          << "Length " << length << "; key " << i;
+    }
+
+    double rate = FalsePositiveRate();
+    if (kVerbose >= 1) {
+      fprintf(stderr, "False positives: %5.2f%% @ length = %6d ; bytes = %6d\n",
+              rate * 100.0, length, static_cast<int>(FilterSize()));
+    }
+    ASSERT_LE(rate, 0.02);  // Must not be over 2%
+    if (rate > 0.0125)
+      mediocre_filters++;  // Allowed, but not too often
+    else
+      good_filters++;
+  }
+  if (kVerbose >= 1) {
+    fprintf(stderr, "Filters: %d good, %d mediocre\n", good_filters,
+            mediocre_filters);
+  }
+  ASSERT_LE(mediocre_filters, good_filters / 5);
+}
+
+// Filters of both formats are readable by either policy, and metadata of
+// an unknown newer format is treated as "always match".
+TEST_F(FullBloomTest, FastLocalCompatibility) {
+  char buffer[sizeof(int)];
+  std::unique_ptr<const FilterPolicy> legacy(NewBloomFilterPolicy(10));
+  std::unique_ptr<const FilterPolicy> fast_local(
+      NewBloomFilterPolicy(10, false, BloomFilterImpl::kFastLocal));
+
+  for (const FilterPolicy* builder_policy : {legacy.get(), fast_local.get()}) {
+    std::unique_ptr<FilterBitsBuilder> builder(
+        builder_policy->GetFilterBitsBuilder());
+    for (int i = 0; i < 1000; i++) {
+      builder->AddKey(Key(i, buffer));
+    }
+    std::unique_ptr<const char[]> buf;
+    Slice filter = builder->Finish(&buf);
+    for (const FilterPolicy* reader_policy : {legacy.get(), fast_local.get()}) {
+      std::unique_ptr<FilterBitsReader> reader(
+          reader_policy->GetFilterBitsReader(filter));
+      int fp = 0;
+      for (int i = 0; i < 1000; i++) {
+        ASSERT_TRUE(reader->MayMatch(Key(i, buffer)));
+        fp += reader->MayMatch(Key(i + 1000000000, buffer)) ? 1 : 0;
+      }
+      ASSERT_LE(fp, 30);
+    }
+  }
+
+  std::unique_ptr<FilterBitsBuilder> builder(
+      fast_local->GetFilterBitsBuilder());
+  builder->AddKey("hello");
+  std::unique_ptr<const char[]> buf;
+  Slice filter = builder->Finish(&buf);
+  std::string modified = filter.ToString();
+  // Unknown sub-implementation
+  modified[modified.size() - 4] = 42;
+  std::unique_ptr<FilterBitsReader> reader(
+      fast_local->GetFilterBitsReader(modified));
+  ASSERT_TRUE(reader->MayMatch("hello"));
+  ASSERT_TRUE(reader->MayMatch("x"));
+  ASSERT_TRUE(reader->MayMatch("foo"));
+}
+
+// At the same bits/key, all probes landing in one cache line (like the
+// legacy format) but with better hashing must not lose accuracy, and
+// beats the legacy format at higher bits/key. Also reports the query cost
+// of both formats, e.g. for comparing SIMD and non-SIMD builds.
+TEST_F(FullBloomTest, FastLocalVsLegacy) {
+  const int kNumKeys = 200000;
+  const int kNumQueries = 1000000;
+  char buffer[sizeof(int)];
+  Env* env = Env::Default();
+
+  for (int bpk : {6, 10, 16, 20}) {
+    double rates[2];
+    double ns_per_query[2];
+    for (int impl = 0; impl < 2; ++impl) {
+      ResetPolicy(NewBloomFilterPolicy(
+          bpk, false,
+          impl == 0 ? BloomFilterImpl::kLegacy : BloomFilterImpl::kFastLocal));
+      for (int i = 0; i < kNumKeys; i++) {
+        Add(Key(i, buffer));
+      }
+      Build();
+      int fp = 0;
+      uint64_t start = env->NowNanos();
+      for (int i = 0; i < kNumQueries; i++) {
+        fp += Matches(Key(i + 1000000000, buffer)) ? 1 : 0;
+      }
+      ns_per_query[impl] =
+          static_cast<double>(env->NowNanos() - start) / kNumQueries;
+      rates[impl] = static_cast<double>(fp) / kNumQueries;
+    }
+    if (kVerbose >= 1) {
+      fprintf(stderr,
+              "%2d bits/key: legacy %6.3f%% FP, %5.1f ns/query; "
+              "fast local %6.3f%% FP, %5.1f ns/query\n",
+              bpk, rates[0] * 100.0, ns_per_query[0], rates[1] * 100.0,
+              ns_per_query[1]);
+    }
+    // Small allowance for sampling noise
+    ASSERT_LE(rates[1], rates[0] * 1.05);
+    if (bpk >= 16) {
+      ASSERT_LT(rates[1], rates[0] * 0.8);
+    }
+  }
+}
+
+#ifdef __AVX2__
+TEST_F(FullBloomTest, FastLocalAVX2MatchesPortable) {
+  Random64 rnd(301);
+  // Two cache lines, so that the data is not necessarily 64-byte aligned
+  // in memory, with a varied density of set bits.
+  char data[128 + 1];
+  for (int density = 1; density <= 8; density *= 2) {
+    for (size_t i = 0; i < sizeof(data); i++) {
+      uint8_t byte = 0xff;
+      for (int j = 0; j < density; j++) {
+        byte &= static_cast<uint8_t>(rnd.Next());
+      }
+      data[i] = static_cast<char>(~byte);
+    }
+    for (int i = 0; i < 100000; i++) {
+      uint32_t h = static_cast<uint32_t>(rnd.Next());
+      int num_probes = static_cast<int>(rnd.Uniform(30)) + 1;
+      const char* line = data + rnd.Uniform(65);
+      ASSERT_EQ(
+          FastLocalBloomImpl::HashMayMatchPreparedPortable(h, num_probes, line),
+          FastLocalBloomImpl::HashMayMatchPreparedAVX2(h, num_probes, line))
+          << "h=" << h << " num_probes=" << num_probes;
+    }
+  }
+}
+#endif  // __AVX2__
+
+// Ensure the implementation doesn't accidentally change in an
+// incompatible way
+TEST_F(FullBloomTest, FastLocalSchema) {
+  char buffer[sizeof(int)];
+
+  ResetPolicy(NewBloomFilterPolicy(8, false, BloomFilterImpl::kFastLocal));
+  for (int key = 0; key < 2087; key++) {
+    Add(Key(key, buffer));
+  }
+  Build();
+  ASSERT_EQ(BloomHash(FilterData()), 4083291697U);
+
+  ResetPolicy(NewBloomFilterPolicy(10, false, BloomFilterImpl::kFastLocal));
+  for (int key = 0; key < 2087; key++) {
+    Add(Key(key, buffer));
+  }
+  Build();
+  ASSERT_EQ(BloomHash(FilterData()), 1721932919);
+
+  ResetPolicy(NewBloomFilterPolicy(16, false, BloomFilterImpl::kFastLocal));
+  for (int key = 0; key < 2087; key++) {
+    Add(Key(key, buffer));
+  }
+  Build();
+  ASSERT_EQ(BloomHash(FilterData()), 1320544452);
+
+  ResetPolicy();
+}
+
+TEST_F(FullBloomTest, XorFilterSize) {
+  for (int bpk : {1, 5, 10, 16, 23}) {
+    ResetPolicy(NewXorFilterPolicy(bpk));
+    for (int n = 1; n < 3000; n = NextLength(n)) {
+      char buffer[sizeof(int)];
+      for (int i = 0; i < n; i++) {
+        Add(Key(i, buffer));
+      }
+      Build();
+      size_t space = FilterSize();
+      int n2 = GetBitsBuilder()->CalculateNumEntry(static_cast<uint32_t>(space));
+      ASSERT_GE(n2, n);
+      Reset();
+      for (int i = 0; i < n2; i++) {
+        Add(Key(i, buffer));
+      }
+      Build();
+      ASSERT_EQ(space, FilterSize());
+      Reset();
+    }
+  }
+}
+
+TEST_F(FullBloomTest, XorSmall) {
+  ResetPolicy(NewXorFilterPolicy(FLAGS_bits_per_key));
+  ASSERT_TRUE(!Matches("hello"));
+  Reset();
+  Add("hello");
+  Add("world");
+  // Non-adjacent duplicates, as with prefixes and whole keys
+  Add("hello");
+  ASSERT_TRUE(Matches("hello"));
+  ASSERT_TRUE(Matches("world"));
+  ASSERT_TRUE(!Matches("x"));
+  ASSERT_TRUE(!Matches("foo"));
+}
+
+TEST_F(FullBloomTest, XorVaryingLengths) {
+  char buffer[sizeof(int)];
+  ResetPolicy(NewXorFilterPolicy(10));
+
+  for (int length = 1; length <= 10000; length = NextLength(length)) {
+    Reset();
+    for (int i = 0; i < length; i++) {
+      Add(Key(i, buffer));
+    }
+    Build();
+
+    // 7-bit fingerprints in 1.23 slots per key, plus fixed overhead
+    ASSERT_LE(FilterSize(), (size_t)(length * 123 * 7 / 800 + 48)) << length;
+
+    for (int i = 0; i < length; i++) {
+      ASSERT_TRUE(Matches(Key(i, buffer)))
+          << "Length " << length << "; key " << i;
+    }
+
+    double rate = FalsePositiveRate();
+    if (kVerbose >= 1) {
+      fprintf(stderr, "False positives: %5.2f%% @ length = %6d ; bytes = %6d\n",
+              rate * 100.0, length, static_cast<int>(FilterSize()));
+    }
+    // 2^-7 = 0.78%, with sampling noise
+    ASSERT_LE(rate, 0.0125);
+  }
+}
+
+// XOR filters need less space than Bloom filters of about the same
+// accuracy. Also reports the query cost of each.
+TEST_F(FullBloomTest, XorVsBloom) {
+  const int kNumKeys = 200000;
+  const int kNumQueries = 1000000;
+  char buffer[sizeof(int)];
+  Env* env = Env::Default();
+
+  for (int bpk : {10, 16}) {
+    const char* names[3] = {"legacy", "fast local", "xor"};
+    double rates[3];
+    double bits_per_key[3];
+    double ns_per_query[3];
+    for (int impl = 0; impl < 3; ++impl) {
+      if (impl == 2) {
+        ResetPolicy(NewXorFilterPolicy(bpk));
+      } else {
+        ResetPolicy(NewBloomFilterPolicy(bpk, false,
+                                         impl == 0
+                                             ? BloomFilterImpl::kLegacy
+                                             : BloomFilterImpl::kFastLocal));
+      }
+      for (int i = 0; i < kNumKeys; i++) {
+        Add(Key(i, buffer));
+      }
+      Build();
+      bits_per_key[impl] = FilterSize() * 8.0 / kNumKeys;
+      int fp = 0;
+      uint64_t start = env->NowNanos();
+      for (int i = 0; i < kNumQueries; i++) {
+        fp += Matches(Key(i + 1000000000, buffer)) ? 1 : 0;
+      }
+      ns_per_query[impl] =
+          static_cast<double>(env->NowNanos() - start) / kNumQueries;
+      rates[impl] = static_cast<double>(fp) / kNumQueries;
+      if (kVerbose >= 1) {
+        fprintf(stderr,
+                "%2d bits/key %-10s: %6.3f%% FP, %5.2f bits/key, "
+                "%5.1f ns/query\n",
+                bpk, names[impl], rates[impl] * 100.0, bits_per_key[impl],
+                ns_per_query[impl]);
+      }
+    }
+    ASSERT_LT(bits_per_key[2], bits_per_key[1] * 0.9);
+    ASSERT_LT(rates[2], rates[0]);
+  }
+}
+
+TEST_F(FullBloomTest, XorPerLevel) {
+  char buffer[sizeof(int)];
+  std::unique_ptr<const FilterPolicy> policy(NewXorFilterPolicy(10, 2));
+  std::unique_ptr<const FilterPolicy> bloom(
+      NewBloomFilterPolicy(10, false, BloomFilterImpl::kFastLocal));
+  BlockBasedTableOptions table_options;
+  FilterBuildingContext context(table_options);
+
+  size_t sizes[4];
+  for (int level = -1; level < 3; ++level) {
+    context.level_at_creation = level;
+    std::unique_ptr<FilterBitsBuilder> builder(
+        policy->GetBuilderWithContext(context));
+    for (int i = 0; i < 1000; i++) {
+      builder->AddKey(Key(i, buffer));
+    }
+    std::unique_ptr<const char[]> buf;
+    Slice filter = builder->Finish(&buf);
+    sizes[level + 1] = filter.size();
+    // Readable by both policies
+    for (const FilterPolicy* reader_policy : {policy.get(), bloom.get()}) {
+      std::unique_ptr<FilterBitsReader> reader(
+          reader_policy->GetFilterBitsReader(filter));
+      for (int i = 0; i < 1000; i++) {
+        ASSERT_TRUE(reader->MayMatch(Key(i, buffer)));
+      }
+    }
+  }
+  // Levels 0 and 1 get the (larger) Bloom filter, the rest XOR filters
+  ASSERT_EQ(sizes[1], sizes[2]);
+  ASSERT_EQ(sizes[0], sizes[3]);
+  ASSERT_GT(sizes[1], sizes[0]);
+}
+
+// Ensure the implementation doesn't accidentally change in an
+// incompatible way
+TEST_F(FullBloomTest, XorSchema) {
+  char buffer[sizeof(int)];
+
+  ResetPolicy(NewXorFilterPolicy(8));  // 6-bit fingerprints
+  for (int key = 0; key < 2087; key++) {
+    Add(Key(key, buffer));
+  }
+  Build();
+  ASSERT_EQ(BloomHash(FilterData()), 2907008729U);
+
+  ResetPolicy(NewXorFilterPolicy(10));  // 7-bit fingerprints
+  for (int key = 0; key < 2087; key++) {
+    Add(Key(key, buffer));
+  }
+  Build();
+  ASSERT_EQ(BloomHash(FilterData()), 271032115);
+
+  ResetPolicy(NewXorFilterPolicy(16));  // 11-bit fingerprints
+  for (int key = 0; key < 2087; key++) {
+    Add(Key(key, buffer));
+  }
+  Build();
+  ASSERT_EQ(BloomHash(FilterData()), 3694753622U);
+
+  ResetPolicy();
+}
+
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
+#ifdef GFLAGS
   ParseCommandLineFlags(&argc, &argv, true);
+#endif  // GFLAGS
 
   return RUN_ALL_TESTS();
 }
-
-#endif  // GFLAGS
@@ -0,0 +1,82 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+
+#include "port/port.h"
+#include "rocksdb/slice.h"
+
+namespace rocksdb {
+
+// Loads 8 bytes as a big-endian integer, so that comparing two loaded
+// integers orders the bytes like memcmp() does.
+inline uint64_t LoadBigEndian64(const char* ptr) {
+  uint64_t v;
+  memcpy(&v, ptr, sizeof(v));
+  if (port::kLittleEndian) {
+#if defined(__GNUC__) || defined(__clang__)
+    v = __builtin_bswap64(v);
+#elif defined(_MSC_VER)
+    v = _byteswap_uint64(v);
+#else
+    v = ((v & 0x00000000000000ffULL) << 56) |
+        ((v & 0x000000000000ff00ULL) << 40) |
+        ((v & 0x0000000000ff0000ULL) << 24) |
+        ((v & 0x00000000ff000000ULL) << 8) |
+        ((v & 0x000000ff00000000ULL) >> 8) |
+        ((v & 0x0000ff0000000000ULL) >> 24) |
+        ((v & 0x00ff000000000000ULL) >> 40) |
+        ((v & 0xff00000000000000ULL) >> 56);
+#endif
+  }
+  return v;
+}
+
+inline int CompareBigEndian64(const char* a, const char* b) {
+  uint64_t x = LoadBigEndian64(a);
+  uint64_t y = LoadBigEndian64(b);
+  return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+// Same order as Slice::compare(), which BytewiseComparator() uses. Keys that
+// share at most 16 bytes, like fixed-width big-endian integer keys, are told
+// apart with two or three integer comparisons instead of a memcmp() call.
+inline int BytewiseCompare(const Slice& a, const Slice& b) {
+  const size_t min_len = std::min(a.size(), b.size());
+  const char* pa = a.data();
+  const char* pb = b.data();
+  int r;
+  if (min_len >= 8) {
+    r = CompareBigEndian64(pa, pb);
+    if (r == 0 && min_len > 8) {
+      if (min_len <= 16) {
+        // The bytes before the last 8 are equal, so the last 8 (which may
+        // overlap the first 8) decide
+        r = CompareBigEndian64(pa + min_len - 8, pb + min_len - 8);
+      } else {
+        r = CompareBigEndian64(pa + 8, pb + 8);
+        if (r == 0) {
+          r = memcmp(pa + 16, pb + 16, min_len - 16);
+        }
+      }
+    }
+  } else {
+    r = memcmp(pa, pb, min_len);
+  }
+  if (r == 0) {
+    if (a.size() < b.size()) {
+      r = -1;
+    } else if (a.size() > b.size()) {
+      r = +1;
+    }
+  }
+  return r;
+}
+
+}  // namespace rocksdb
@@ -45,6 +45,10 @@ void CompactionJobStats::Reset() {
 
   num_single_del_fallthru = 0;
   num_single_del_mismatch = 0;
+
+  subcompaction_input_records.clear();
+  subcompaction_elapsed_micros.clear();
+  subcompaction_skew = 0;
 }
 
 void CompactionJobStats::Add(const CompactionJobStats& stats) {
@@ -78,6 +82,14 @@ void CompactionJobStats::Add(const CompactionJobStats& stats) {
 
   num_single_del_fallthru += stats.num_single_del_fallthru;
   num_single_del_mismatch += stats.num_single_del_mismatch;
+
+  subcompaction_input_records.insert(subcompaction_input_records.end(),
+                                     stats.subcompaction_input_records.begin(),
+                                     stats.subcompaction_input_records.end());
+  subcompaction_elapsed_micros.insert(
+      subcompaction_elapsed_micros.end(),
+      stats.subcompaction_elapsed_micros.begin(),
+      stats.subcompaction_elapsed_micros.end());
 }
 
 #else
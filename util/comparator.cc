@@ -125,6 +125,8 @@ class BytewiseComparatorImpl : public Comparator {
     return false;
   }
 
+  bool IsBytewiseOrder() const override { return true; }
+
   int CompareWithoutTimestamp(const Slice& a, const Slice& b) const override {
     return a.compare(b);
   }
@@ -197,6 +199,8 @@ class ReverseBytewiseComparatorImpl : public BytewiseComparatorImpl {
     return false;
   }
 
+  bool IsBytewiseOrder() const override { return false; }
+
   int CompareWithoutTimestamp(const Slice& a, const Slice& b) const override {
     return -a.compare(b);
   }
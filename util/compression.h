@@ -588,6 +588,12 @@ inline std::string CompressionOptionsToString(
   result.append("zstd_max_train_bytes=")
       .append(ToString(compression_options.zstd_max_train_bytes))
       .append("; ");
+  result.append("parallel_threads=")
+      .append(ToString(compression_options.parallel_threads))
+      .append("; ");
+  result.append("shared_dict_files=")
+      .append(ToString(compression_options.shared_dict_files))
+      .append("; ");
   result.append("enabled=")
       .append(ToString(compression_options.enabled))
       .append("; ");
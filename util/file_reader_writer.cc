@@ -10,6 +10,7 @@
 #include "util/file_reader_writer.h"
 
 #include <algorithm>
+#include <condition_variable>
 #include <mutex>
 
 #include "monitoring/histogram.h"
@@ -234,6 +235,30 @@ Status RandomAccessFileReader::MultiRead(ReadRequest* read_reqs,
   return s;
 }
 
+Status RandomAccessFileReader::ReadAsync(ReadRequest* req, void** io_handle,
+                                         bool for_compaction) const {
+  if (for_compaction && rate_limiter_ != nullptr) {
+    return Status::NotSupported("Rate limited reads are synchronous");
+  }
+  if (use_direct_io()) {
+    size_t alignment = file_->GetRequiredBufferAlignment();
+    if (req->offset % alignment != 0 || req->len % alignment != 0 ||
+        reinterpret_cast<uintptr_t>(req->scratch) % alignment != 0) {
+      return Status::NotSupported("Unaligned direct I/O read");
+    }
+  }
+  return file_->ReadAsync(req, io_handle);
+}
+
+void RandomAccessFileReader::WaitAsyncRead(ReadRequest* req,
+                                           void* io_handle) const {
+  {
+    IOSTATS_TIMER_GUARD(read_nanos);
+    file_->WaitAsyncRead(io_handle);
+  }
+  IOSTATS_ADD_IF_POSITIVE(bytes_read, req->result.size());
+}
+
 Status WritableFileWriter::Append(const Slice& data) {
   const char* src = data.data();
   size_t left = data.size();
@@ -980,6 +1005,202 @@ Status FilePrefetchBuffer::Prefetch(RandomAccessFileReader* reader,
   return s;
 }
 
+// A readahead into next_buffer_, either submitted to the file with
+// ReadAsync() or scheduled for a thread of the Env::USER pool. In the latter
+// case it is shared with the job, so that the FilePrefetchBuffer can go away
+// while the job is still queued.
+struct FilePrefetchBuffer::AsyncReadState {
+  enum State {
+    kSubmitted,
+    kScheduled,
+    kRunning,
+    kDone,
+    // The FilePrefetchBuffer did the read itself or no longer needs it
+    kCancelled,
+  };
+
+  AsyncReadState(RandomAccessFileReader* _reader, uint64_t offset, size_t len,
+                 char* scratch, bool _for_compaction)
+      : state(kScheduled),
+        reader(_reader),
+        for_compaction(_for_compaction),
+        io_handle(nullptr) {
+    req.offset = offset;
+    req.len = len;
+    req.scratch = scratch;
+  }
+
+  void Read() {
+    req.status = reader->Read(req.offset, req.len, &req.result, req.scratch,
+                              for_compaction);
+    if (req.status.ok() && req.result.data() != req.scratch) {
+      memmove(req.scratch, req.result.data(), req.result.size());
+    }
+  }
+
+  std::mutex mu;
+  std::condition_variable cv;
+  State state;
+  RandomAccessFileReader* const reader;
+  const bool for_compaction;
+  ReadRequest req;
+  // Set if kSubmitted
+  void* io_handle;
+};
+
+FilePrefetchBuffer::~FilePrefetchBuffer() {
+  if (async_read_ != nullptr) {
+    AsyncReadState* state = async_read_.get();
+    if (state->state == AsyncReadState::kSubmitted) {
+      file_reader_->WaitAsyncRead(&state->req, state->io_handle);
+      return;
+    }
+    std::unique_lock<std::mutex> lock(state->mu);
+    if (state->state == AsyncReadState::kScheduled) {
+      state->state = AsyncReadState::kCancelled;
+    } else {
+      // The job reads into next_buffer_, which is about to be freed
+      state->cv.wait(lock, [state] {
+        return state->state == AsyncReadState::kDone;
+      });
+    }
+  }
+}
+
+void FilePrefetchBuffer::BGReadahead(void* arg) {
+  std::unique_ptr<std::shared_ptr<AsyncReadState>> state_ptr(
+      static_cast<std::shared_ptr<AsyncReadState>*>(arg));
+  AsyncReadState* state = state_ptr->get();
+  {
+    std::lock_guard<std::mutex> lock(state->mu);
+    if (state->state != AsyncReadState::kScheduled) {
+      return;
+    }
+    state->state = AsyncReadState::kRunning;
+  }
+  TEST_SYNC_POINT("FilePrefetchBuffer::BGReadahead");
+  state->Read();
+  {
+    std::lock_guard<std::mutex> lock(state->mu);
+    state->state = AsyncReadState::kDone;
+  }
+  state->cv.notify_all();
+}
+
+void FilePrefetchBuffer::ScheduleReadahead(bool for_compaction) {
+  assert(async_read_ == nullptr);
+  size_t alignment = file_reader_->file()->GetRequiredBufferAlignment();
+  uint64_t offset = buffer_offset_ + buffer_.CurrentSize();
+  if (offset % alignment != 0) {
+    // The last read was short, so the end of the file has been reached
+    return;
+  }
+  size_t len = Roundup(readahead_size_, alignment);
+  if (next_buffer_.Capacity() < len) {
+    next_buffer_.Alignment(alignment);
+    next_buffer_.AllocateNewBuffer(len);
+  }
+  next_buffer_.Clear();
+  next_buffer_offset_ = offset;
+  async_read_ = std::make_shared<AsyncReadState>(
+      file_reader_, offset, len, next_buffer_.BufferStart(), for_compaction);
+  if (file_reader_
+          ->ReadAsync(&async_read_->req, &async_read_->io_handle,
+                      for_compaction)
+          .ok()) {
+    async_read_->state = AsyncReadState::kSubmitted;
+    return;
+  }
+  if (!use_thread_pool_) {
+    async_read_.reset();
+    return;
+  }
+  async_env_->Schedule(&FilePrefetchBuffer::BGReadahead,
+                       new std::shared_ptr<AsyncReadState>(async_read_),
+                       Env::Priority::USER);
+}
+
+Status FilePrefetchBuffer::WaitForReadahead() {
+  assert(async_read_ != nullptr);
+  std::shared_ptr<AsyncReadState> state = std::move(async_read_);
+  if (state->state == AsyncReadState::kSubmitted) {
+    file_reader_->WaitAsyncRead(&state->req, state->io_handle);
+  } else {
+    bool read_here = false;
+    {
+      std::unique_lock<std::mutex> lock(state->mu);
+      if (state->state == AsyncReadState::kScheduled) {
+        // No thread got to it yet. Reading it here is no slower than waiting
+        // for one, and cannot wait on a busy pool.
+        state->state = AsyncReadState::kCancelled;
+        read_here = true;
+      } else {
+        state->cv.wait(lock, [&state] {
+          return state->state == AsyncReadState::kDone;
+        });
+      }
+    }
+    if (read_here) {
+      state->Read();
+    }
+  }
+  if (state->req.status.ok()) {
+    next_buffer_.Size(state->req.result.size());
+  }
+  return state->req.status;
+}
+
+Status FilePrefetchBuffer::FillBufferAsync(uint64_t offset, size_t n,
+                                           bool for_compaction) {
+  if (async_read_ != nullptr) {
+    Status s = WaitForReadahead();
+    uint64_t buffer_end = buffer_offset_ + buffer_.CurrentSize();
+    uint64_t next_buffer_end = next_buffer_offset_ + next_buffer_.CurrentSize();
+    if (s.ok() && offset >= next_buffer_offset_ &&
+        offset + n <= next_buffer_end) {
+      std::swap(buffer_, next_buffer_);
+      std::swap(buffer_offset_, next_buffer_offset_);
+    } else if (s.ok() && next_buffer_offset_ == buffer_end &&
+               offset >= buffer_offset_ && offset < buffer_end &&
+               offset + n <= next_buffer_end) {
+      // The request starts in buffer_ and ends in next_buffer_. Move the
+      // aligned tail of buffer_ to its front and append next_buffer_.
+      size_t alignment = file_reader_->file()->GetRequiredBufferAlignment();
+      size_t tail_offset =
+          Rounddown(static_cast<size_t>(offset - buffer_offset_), alignment);
+      size_t tail_len = buffer_.CurrentSize() - tail_offset;
+      size_t new_size = tail_len + next_buffer_.CurrentSize();
+      if (buffer_.Capacity() < new_size) {
+        buffer_.AllocateNewBuffer(new_size, true /* copy_data */, tail_offset,
+                                  tail_len);
+      } else {
+        buffer_.RefitTail(tail_offset, tail_len);
+      }
+      buffer_.Append(next_buffer_.BufferStart(), next_buffer_.CurrentSize());
+      buffer_offset_ += tail_offset;
+    }
+    // Otherwise the readahead failed or missed, e.g. after a seek, and the
+    // request is read below.
+    next_buffer_.Clear();
+  }
+
+  if (offset < buffer_offset_ ||
+      offset + n > buffer_offset_ + buffer_.CurrentSize()) {
+    Status s;
+    if (for_compaction) {
+      s = Prefetch(file_reader_, offset, std::max(n, readahead_size_),
+                   for_compaction);
+    } else {
+      s = Prefetch(file_reader_, offset, n + readahead_size_, for_compaction);
+    }
+    if (!s.ok()) {
+      return s;
+    }
+  }
+  ScheduleReadahead(for_compaction);
+  return Status::OK();
+}
+
 bool FilePrefetchBuffer::TryReadFromCache(uint64_t offset, size_t n,
                                           Slice* result, bool for_compaction) {
   if (track_min_offset_ && offset < min_offset_read_) {
@@ -998,7 +1219,9 @@ bool FilePrefetchBuffer::TryReadFromCache(uint64_t offset, size_t n,
       assert(file_reader_ != nullptr);
       assert(max_readahead_size_ >= readahead_size_);
       Status s;
-      if (for_compaction) {
+      if (async_env_ != nullptr) {
+        s = FillBufferAsync(offset, n, for_compaction);
+      } else if (for_compaction) {
         s = Prefetch(file_reader_, offset, std::max(n, readahead_size_), for_compaction);
       } else {
         s = Prefetch(file_reader_, offset, n + readahead_size_, for_compaction);
@@ -9,6 +9,7 @@
 
 #pragma once
 #include <atomic>
+#include <memory>
 #include <sstream>
 #include <string>
 #include "port/port.h"
@@ -170,6 +171,15 @@ class RandomAccessFileReader {
 
   Status MultiRead(ReadRequest* reqs, size_t num_reqs) const;
 
+  // Starts reading *req with RandomAccessFile::ReadAsync(). Returns
+  // NotSupported for rate limited compaction reads, and for direct I/O
+  // reads that are not aligned.
+  Status ReadAsync(ReadRequest* req, void** io_handle,
+                   bool for_compaction = false) const;
+
+  // Waits for a read started by ReadAsync().
+  void WaitAsyncRead(ReadRequest* req, void* io_handle) const;
+
   Status Prefetch(uint64_t offset, size_t n) const {
     return file_->Prefetch(offset, n);
   }
@@ -338,16 +348,34 @@ class FilePrefetchBuffer {
   // does not make any sense. So it does nothing.
   // A user can construct a FilePrefetchBuffer without any arguments, but use
   // `Prefetch` to load data into the buffer.
+  // async_env : if not nullptr, readahead is double buffered. Once the buffer
+  //   is filled, the next readahead_size bytes are read into a second buffer
+  //   while the caller consumes the first one, with an asynchronous read of
+  //   the file if it supports them, or else by a thread of async_env's
+  //   Env::USER pool if that has any.
   FilePrefetchBuffer(RandomAccessFileReader* file_reader = nullptr,
                      size_t readadhead_size = 0, size_t max_readahead_size = 0,
-                     bool enable = true, bool track_min_offset = false)
+                     bool enable = true, bool track_min_offset = false,
+                     Env* async_env = nullptr)
       : buffer_offset_(0),
         file_reader_(file_reader),
         readahead_size_(readadhead_size),
         max_readahead_size_(max_readahead_size),
         min_offset_read_(port::kMaxSizet),
         enable_(enable),
-        track_min_offset_(track_min_offset) {}
+        track_min_offset_(track_min_offset),
+        async_env_(nullptr),
+        use_thread_pool_(false),
+        next_buffer_offset_(0) {
+    if (async_env != nullptr && file_reader != nullptr && readadhead_size > 0) {
+      async_env_ = async_env;
+      use_thread_pool_ =
+          async_env->GetBackgroundThreads(Env::Priority::USER) > 0;
+    }
+  }
+
+  // Waits for an in-flight background readahead, if any.
+  ~FilePrefetchBuffer();
 
   // Load data into the buffer from a file.
   // reader : the file reader.
@@ -375,6 +403,19 @@ class FilePrefetchBuffer {
   size_t min_offset_read() const { return min_offset_read_; }
 
  private:
+  struct AsyncReadState;
+
+  // Makes [offset, offset + n) available in buffer_, using the data of the
+  // background readahead where possible.
+  Status FillBufferAsync(uint64_t offset, size_t n, bool for_compaction);
+  // Starts a background read of the readahead_size_ bytes that follow
+  // buffer_ into next_buffer_.
+  void ScheduleReadahead(bool for_compaction);
+  // Waits for the scheduled readahead to complete, or does the read in the
+  // calling thread if no background thread has picked it up yet.
+  Status WaitForReadahead();
+  static void BGReadahead(void* arg);
+
   AlignedBuffer buffer_;
   uint64_t buffer_offset_;
   RandomAccessFileReader* file_reader_;
@@ -388,6 +429,15 @@ class FilePrefetchBuffer {
   // If true, track minimum `offset` ever passed to TryReadFromCache(), which
   // can be fetched from min_offset_read().
   bool track_min_offset_;
+  // Non-null if readahead is double buffered.
+  Env* async_env_;
+  // Whether readaheads the file cannot do asynchronously are done by the
+  // threads of async_env_
+  bool use_thread_pool_;
+  AlignedBuffer next_buffer_;
+  uint64_t next_buffer_offset_;
+  // Set while a readahead into next_buffer_ is outstanding.
+  std::shared_ptr<AsyncReadState> async_read_;
 };
 
 // Returns a WritableFile.
@@ -321,6 +321,65 @@ INSTANTIATE_TEST_CASE_P(
     ReadExceedsReadaheadSizeTest, ReadaheadRandomAccessFileTest,
     ::testing::ValuesIn(ReadaheadRandomAccessFileTest::GetReadaheadSizeList()));
 
+class FilePrefetchBufferTest : public testing::Test,
+                               public testing::WithParamInterface<bool> {
+ public:
+  static const size_t kReadaheadSize = 1lu << 14;
+
+  void SetUp() override {
+    Env::Default()->SetBackgroundThreads(2, Env::Priority::USER);
+    Random rng(301);
+    contents_ = test::RandomHumanReadableString(
+        &rng, static_cast<int>(64 * kReadaheadSize + rng.Uniform(4096)));
+    reader_.reset(new RandomAccessFileReader(
+        std::unique_ptr<RandomAccessFile>(new test::StringSource(contents_)),
+        "" /* don't care */));
+  }
+
+  FilePrefetchBuffer* NewPrefetchBuffer() {
+    return new FilePrefetchBuffer(reader_.get(), kReadaheadSize,
+                                  4 * kReadaheadSize, true /* enable */,
+                                  false /* track_min_offset */,
+                                  GetParam() ? Env::Default() : nullptr);
+  }
+
+  std::string contents_;
+  std::unique_ptr<RandomAccessFileReader> reader_;
+};
+
+TEST_P(FilePrefetchBufferTest, SequentialReads) {
+  Random rng(17);
+  for (int iter = 0; iter < 10; ++iter) {
+    std::unique_ptr<FilePrefetchBuffer> buffer(NewPrefetchBuffer());
+    size_t offset = 0;
+    while (offset < contents_.size()) {
+      size_t n = std::min<size_t>(
+          1 + rng.Uniform(static_cast<int>(kReadaheadSize)),
+          contents_.size() - offset);
+      Slice result;
+      ASSERT_TRUE(buffer->TryReadFromCache(offset, n, &result));
+      ASSERT_EQ(contents_.substr(offset, n), result.ToString());
+      offset += n;
+      if (rng.OneIn(10)) {
+        // Skip ahead, past what has been read ahead at times
+        offset += rng.Uniform(static_cast<int>(4 * kReadaheadSize));
+      }
+    }
+  }
+}
+
+TEST_P(FilePrefetchBufferTest, DestroyWithReadaheadInFlight) {
+  for (int iter = 0; iter < 100; ++iter) {
+    std::unique_ptr<FilePrefetchBuffer> buffer(NewPrefetchBuffer());
+    Slice result;
+    ASSERT_TRUE(buffer->TryReadFromCache(iter * 100, 100, &result));
+    ASSERT_EQ(contents_.substr(iter * 100, 100), result.ToString());
+  }
+}
+
+INSTANTIATE_TEST_CASE_P(FilePrefetchBufferTest, FilePrefetchBufferTest,
+                        ::testing::Bool());
+
 class ReadaheadSequentialFileTest : public testing::Test,
                                     public testing::WithParamInterface<size_t> {
  public:
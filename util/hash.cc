@@ -11,6 +11,7 @@
 #include "util/coding.h"
 #include "util/hash.h"
 #include "util/util.h"
+#include "util/xxhash.h"
 
 namespace rocksdb {
 
@@ -54,4 +55,8 @@ uint32_t Hash(const char* data, size_t n, uint32_t seed) {
   return h;
 }
 
+uint64_t Hash64(const char* data, size_t n, uint64_t seed) {
+  return XXH64(data, n, seed);
+}
+
 }  // namespace rocksdb
@@ -24,10 +24,23 @@ extern uint64_t NPHash64(const char* data, size_t n, uint32_t seed);
 
 extern uint32_t Hash(const char* data, size_t n, uint32_t seed);
 
+// Stable/persistent 64-bit hash (xxHash64). Higher quality than Hash(), so
+// it is suitable for hash-based structures whose accuracy depends on all 64
+// bits being well mixed, such as cache-local Bloom filters.
+extern uint64_t Hash64(const char* data, size_t n, uint64_t seed);
+
+// Stable/persistent 64-bit hash (XXH3 of xxHash 0.8). Several times faster
+// than Hash64() on long inputs, as it is vectorized.
+extern uint64_t XXH3Hash64(const char* data, size_t n);
+
 inline uint32_t BloomHash(const Slice& key) {
   return Hash(key.data(), key.size(), 0xbc9f1d34);
 }
 
+inline uint64_t GetSliceHash64(const Slice& key) {
+  return Hash64(key.data(), key.size(), 0);
+}
+
 inline uint64_t GetSliceNPHash64(const Slice& s) {
   return NPHash64(s.data(), s.size(), 0);
 }
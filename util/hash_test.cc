@@ -7,6 +7,7 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 
+#include <string>
 #include <vector>
 
 #include "test_util/testharness.h"
@@ -66,6 +67,38 @@ TEST(HashTest, Values) {
             3382479516u);
 }
 
+TEST(HashTest, XXH3Hash64Values) {
+  using rocksdb::XXH3Hash64;
+  // Covers each of the code paths of XXH3 for the lengths of the inputs
+  auto data = [](size_t n) {
+    std::string s;
+    for (size_t i = 0; i < n; i++) {
+      s.push_back(static_cast<char>(i * 31 + 7));
+    }
+    return s;
+  };
+  auto hash = [&](size_t n) {
+    std::string s = data(n);
+    return XXH3Hash64(s.data(), s.size());
+  };
+
+  EXPECT_EQ(hash(0), uint64_t{0x2d06800538d394c2});
+  EXPECT_EQ(hash(1), uint64_t{0x4c5cca45d0f4811f});
+  EXPECT_EQ(hash(3), uint64_t{0x15f7093b173d005c});
+  EXPECT_EQ(hash(4), uint64_t{0xdca012f95811b6b9});
+  EXPECT_EQ(hash(8), uint64_t{0xdec6a9a43575982e});
+  EXPECT_EQ(hash(9), uint64_t{0xcbe393399f17ffbd});
+  EXPECT_EQ(hash(16), uint64_t{0x7e484c18d74895d0});
+  EXPECT_EQ(hash(17), uint64_t{0x208bde5ee2bed407});
+  EXPECT_EQ(hash(128), uint64_t{0xf92b70eaa21a6288});
+  EXPECT_EQ(hash(129), uint64_t{0xf8f76713f2bb60fa});
+  EXPECT_EQ(hash(240), uint64_t{0xccc7375172c41f03});
+  EXPECT_EQ(hash(241), uint64_t{0x0b3b630948ce4a00});
+  EXPECT_EQ(hash(1000), uint64_t{0x989765d0ea7a5ecd});
+  EXPECT_EQ(hash(4096), uint64_t{0xa3c19f8174cde0bb});
+  EXPECT_EQ(hash(100000), uint64_t{0xccf90df7e7e37036});
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
 
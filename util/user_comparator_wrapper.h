@@ -10,27 +10,37 @@
 
 #include "monitoring/perf_context_imp.h"
 #include "rocksdb/comparator.h"
+#include "util/bytewise_compare.h"
 
 namespace rocksdb {
 
 // Wrapper of user comparator, with auto increment to
-// perf_context.user_key_comparison_count.
+// perf_context.user_key_comparison_count. Compares inline if the user
+// comparator is ordered bytewise.
 class UserComparatorWrapper final : public Comparator {
  public:
   explicit UserComparatorWrapper(const Comparator* const user_cmp)
-      : user_comparator_(user_cmp) {}
-  
+      : user_comparator_(user_cmp),
+        bytewise_(user_cmp != nullptr && user_cmp->IsBytewiseOrder() &&
+                  user_cmp->timestamp_size() == 0) {}
+
   ~UserComparatorWrapper() = default;
 
   const Comparator* user_comparator() const { return user_comparator_; }
 
   int Compare(const Slice& a, const Slice& b) const override {
     PERF_COUNTER_ADD(user_key_comparison_count, 1);
+    if (bytewise_) {
+      return BytewiseCompare(a, b);
+    }
     return user_comparator_->Compare(a, b);
   }
 
   bool Equal(const Slice& a, const Slice& b) const override {
     PERF_COUNTER_ADD(user_key_comparison_count, 1);
+    if (bytewise_) {
+      return a == b;
+    }
     return user_comparator_->Equal(a, b);
   }
 
@@ -58,8 +68,13 @@ class UserComparatorWrapper final : public Comparator {
     return user_comparator_->CanKeysWithDifferentByteContentsBeEqual();
   }
 
+  bool IsBytewiseOrder() const override {
+    return user_comparator_->IsBytewiseOrder();
+  }
+
  private:
   const Comparator* user_comparator_;
+  bool bytewise_;
 };
 
 }  // namespace rocksdb
@@ -0,0 +1,210 @@
+//  Copyright (c) 2019-present, Facebook, Inc. All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+//
+// Implementation details of the static XOR filter used for full filters
+// (see NewXorFilterPolicy()).
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cmath>
+#include <vector>
+
+#include "port/port.h"
+#include "util/coding.h"
+#include "util/hash.h"
+
+namespace rocksdb {
+
+// A static XOR filter [Graf, Lemire 2019]: every key maps to three slots,
+// one in each third of an array of f-bit fingerprints, and the filter is
+// solved such that the XOR of the three slots equals the fingerprint of
+// the key. A query is three (independent, so overlapping) random reads and
+// the false positive rate is 2^-f, in about 1.23 * f bits per key instead
+// of the ~1.44 * f bits per key a Bloom filter needs in theory (more in
+// practice, especially for a cache-local Bloom filter).
+//
+// Construction needs all keys up front and a few passes over arrays of
+// about 20 bytes per slot. It fails with small probability for a given
+// seed, so the builder retries with another seed, recorded in the filter.
+//
+// The filter data is
+//   [segment_length : fixed32][3 * segment_length packed f-bit slots]
+//   [3 bytes of padding, so that any slot can be read with one 32-bit load]
+//
+class XorFilterImpl {
+ public:
+  // Fingerprint bits for about the FP rate of a Bloom filter with the
+  // given bits per key: a theoretical Bloom filter reaches 0.6185^bpk,
+  // i.e. 2^-(0.6931 * bpk).
+  static inline int ChooseFingerprintBits(int bits_per_key) {
+    int fp_bits = static_cast<int>(std::lround(bits_per_key * 0.6931));
+    if (fp_bits < 1) fp_bits = 1;
+    if (fp_bits > kMaxFingerprintBits) fp_bits = kMaxFingerprintBits;
+    return fp_bits;
+  }
+
+  static inline uint32_t GetSegmentLength(uint32_t num_entries) {
+    // 1.23 * n slots are enough for construction to succeed with high
+    // probability for large n; small filters need a little more.
+    uint64_t slots = 32 + (uint64_t{num_entries} * 123 + 99) / 100;
+    return static_cast<uint32_t>((slots + 2) / 3);
+  }
+
+  // Bytes of filter data, including the header and padding
+  static inline uint32_t GetDataLength(uint32_t segment_length, int fp_bits) {
+    uint64_t bits = uint64_t{segment_length} * 3 * fp_bits;
+    return static_cast<uint32_t>(kHeaderLen + (bits + 7) / 8 + kPaddingLen);
+  }
+
+  // Mixes a seed into the 64-bit key hash, so that each construction
+  // attempt uses independent slots.
+  static inline uint64_t Remix(uint64_t h, uint32_t seed) {
+    h += (seed + 1) * uint64_t{0x9e3779b97f4a7c15};
+    // MurmurHash3 finalizer
+    h ^= h >> 33;
+    h *= uint64_t{0xff51afd7ed558ccd};
+    h ^= h >> 33;
+    h *= uint64_t{0xc4ceb9fe1a85ec53};
+    h ^= h >> 33;
+    return h;
+  }
+
+  static inline void GetSlots(uint64_t h, uint32_t segment_length,
+                              uint32_t* slots) {
+    slots[0] = fastrange32(segment_length, static_cast<uint32_t>(h));
+    slots[1] = segment_length +
+               fastrange32(segment_length, static_cast<uint32_t>(h >> 21));
+    slots[2] = 2 * segment_length +
+               fastrange32(segment_length, static_cast<uint32_t>(h >> 32));
+  }
+
+  static inline uint32_t Fingerprint(uint64_t h, int fp_bits) {
+    // Mostly low bits of both halves, which fastrange32 in GetSlots()
+    // gives little weight
+    return static_cast<uint32_t>(h ^ (h >> 32)) &
+           ((uint32_t{1} << fp_bits) - 1);
+  }
+
+  static inline uint32_t GetFingerprint(const char* slots_data, uint32_t slot,
+                                        int fp_bits) {
+    uint64_t bit_offset = uint64_t{slot} * fp_bits;
+    uint32_t word = DecodeFixed32(slots_data + (bit_offset >> 3));
+    return (word >> (bit_offset & 7)) & ((uint32_t{1} << fp_bits) - 1);
+  }
+
+  static inline void XorFingerprint(char* slots_data, uint32_t slot,
+                                    int fp_bits, uint32_t value) {
+    uint64_t bit_offset = uint64_t{slot} * fp_bits;
+    value <<= (bit_offset & 7);
+    char* p = slots_data + (bit_offset >> 3);
+    for (; value != 0; value >>= 8, ++p) {
+      *p ^= static_cast<char>(value & 0xff);
+    }
+  }
+
+  // Solves the filter for the given unique key hashes into the zeroed
+  // slots_data (3 * segment_length slots). Returns false if the hashes
+  // could not be mapped for this seed; slots_data is then unchanged.
+  static bool Build(const std::vector<uint64_t>& hashes, uint32_t seed,
+                    uint32_t segment_length, int fp_bits, char* slots_data) {
+    const uint32_t num_slots = 3 * segment_length;
+    std::vector<uint32_t> counts(num_slots, 0);
+    std::vector<uint64_t> xor_hashes(num_slots, 0);
+    uint32_t slots[3];
+    for (uint64_t hash : hashes) {
+      uint64_t h = Remix(hash, seed);
+      GetSlots(h, segment_length, slots);
+      for (uint32_t slot : slots) {
+        counts[slot]++;
+        xor_hashes[slot] ^= h;
+      }
+    }
+
+    // Peel: repeatedly take a key that is alone in one of its slots and
+    // remove it from the other two. Keys are assigned in reverse order of
+    // peeling, so that the slot each key owns is not touched afterwards.
+    std::vector<uint32_t> queue;
+    queue.reserve(num_slots);
+    for (uint32_t i = 0; i < num_slots; ++i) {
+      if (counts[i] == 1) {
+        queue.push_back(i);
+      }
+    }
+    std::vector<std::pair<uint64_t, uint32_t>> stack;
+    stack.reserve(hashes.size());
+    while (!queue.empty()) {
+      uint32_t owned = queue.back();
+      queue.pop_back();
+      if (counts[owned] != 1) {
+        continue;
+      }
+      uint64_t h = xor_hashes[owned];
+      stack.emplace_back(h, owned);
+      GetSlots(h, segment_length, slots);
+      for (uint32_t slot : slots) {
+        counts[slot]--;
+        xor_hashes[slot] ^= h;
+        if (counts[slot] == 1) {
+          queue.push_back(slot);
+        }
+      }
+    }
+    if (stack.size() != hashes.size()) {
+      return false;
+    }
+
+    for (auto it = stack.rbegin(); it != stack.rend(); ++it) {
+      uint64_t h = it->first;
+      uint32_t owned = it->second;
+      GetSlots(h, segment_length, slots);
+      uint32_t fp = Fingerprint(h, fp_bits);
+      for (uint32_t slot : slots) {
+        if (slot != owned) {
+          fp ^= GetFingerprint(slots_data, slot, fp_bits);
+        }
+      }
+      XorFingerprint(slots_data, owned, fp_bits, fp);
+    }
+    return true;
+  }
+
+  static inline void PrepareHash(uint64_t hash, uint32_t seed,
+                                 uint32_t segment_length, int fp_bits,
+                                 const char* slots_data, uint64_t* h,
+                                 uint32_t* slots) {
+    *h = Remix(hash, seed);
+    GetSlots(*h, segment_length, slots);
+    for (int i = 0; i < 3; ++i) {
+      PREFETCH(slots_data + ((uint64_t{slots[i]} * fp_bits) >> 3),
+               0 /* rw */, 1 /* locality */);
+    }
+  }
+
+  static inline bool HashMayMatchPrepared(uint64_t h, const uint32_t* slots,
+                                          int fp_bits,
+                                          const char* slots_data) {
+    uint32_t fp = GetFingerprint(slots_data, slots[0], fp_bits) ^
+                  GetFingerprint(slots_data, slots[1], fp_bits) ^
+                  GetFingerprint(slots_data, slots[2], fp_bits);
+    return fp == Fingerprint(h, fp_bits);
+  }
+
+  static inline bool HashMayMatch(uint64_t hash, uint32_t seed,
+                                  uint32_t segment_length, int fp_bits,
+                                  const char* slots_data) {
+    uint64_t h = Remix(hash, seed);
+    uint32_t slots[3];
+    GetSlots(h, segment_length, slots);
+    return HashMayMatchPrepared(h, slots, fp_bits, slots_data);
+  }
+
+  static const int kMaxFingerprintBits = 24;
+  static const uint32_t kHeaderLen = 4;
+  static const uint32_t kPaddingLen = 3;
+};
+
+}  // namespace rocksdb
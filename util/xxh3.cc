@@ -0,0 +1,31 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+// XXH3 comes from a newer xxHash than util/xxhash.h, whose declarations
+// conflict with it, so it is inlined here, away from the files that include
+// util/xxhash.h. The vector instructions it uses (SSE2, AVX2, AVX-512, NEON,
+// VSX) are those that the build targets, e.g. the host's unless PORTABLE.
+#if defined(__GNUC__) && !defined(__clang__)
+// GCC reports its own AVX-512 intrinsics as using uninitialized values
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+#define XXH_INLINE_ALL
+#include "third-party/xxhash/xxhash.h"
+
+#include "util/hash.h"
+
+namespace rocksdb {
+
+uint64_t XXH3Hash64(const char* data, size_t n) {
+  return XXH3_64bits(data, n);
+}
+
+}  // namespace rocksdb
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
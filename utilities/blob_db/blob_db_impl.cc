@@ -30,6 +30,7 @@
 #include "table/meta_blocks.h"
 #include "test_util/sync_point.h"
 #include "util/cast_util.h"
+#include "util/autovector.h"
 #include "util/crc32c.h"
 #include "util/file_reader_writer.h"
 #include "util/mutexlock.h"
@@ -43,6 +44,10 @@
 
 namespace {
 int kBlockBasedTableVersionFormat = 2;
+
+// Blobs of the same blob file that MultiGetBlobValues() reads are merged into
+// one read request if they are at most this many bytes apart.
+const uint64_t kMultiGetBlobReadGap = 4096;
 }  // end namespace
 
 namespace rocksdb {
@@ -136,6 +141,11 @@ Status BlobDBImpl::Open(std::vector<ColumnFamilyHandle*>* handles) {
       cf_options_.compaction_filter_factory != nullptr) {
     return Status::NotSupported("Blob DB doesn't support compaction filter.");
   }
+  if (cf_options_.enable_blob_files) {
+    return Status::NotSupported(
+        "Blob DB doesn't support enable_blob_files, it keeps its own blob "
+        "files.");
+  }
 
   Status s;
 
@@ -931,27 +941,73 @@ Status BlobDBImpl::AppendBlob(const std::shared_ptr<BlobFile>& bfile,
 std::vector<Status> BlobDBImpl::MultiGet(
     const ReadOptions& read_options,
     const std::vector<Slice>& keys, std::vector<std::string>* values) {
+  std::vector<Status> statuses(keys.size());
+  std::unique_ptr<PinnableSlice[]> pinnable_values(
+      new PinnableSlice[keys.size()]);
+  MultiGet(read_options, DefaultColumnFamily(), keys.size(), keys.data(),
+           pinnable_values.get(), statuses.data());
+  values->clear();
+  values->reserve(keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    values->push_back(pinnable_values[i].ToString());
+  }
+  return statuses;
+}
+
+void BlobDBImpl::MultiGet(const ReadOptions& read_options,
+                          ColumnFamilyHandle* column_family,
+                          const size_t num_keys, const Slice* keys,
+                          PinnableSlice* values, Status* statuses,
+                          const bool sorted_input) {
   StopWatch multiget_sw(env_, statistics_, BLOB_DB_MULTIGET_MICROS);
   RecordTick(statistics_, BLOB_DB_NUM_MULTIGET);
+  if (column_family != DefaultColumnFamily()) {
+    for (size_t i = 0; i < num_keys; i++) {
+      statuses[i] = Status::NotSupported(
+          "Blob DB doesn't support non-default column family.");
+    }
+    return;
+  }
   // Get a snapshot to avoid blob file get deleted between we
   // fetch and index entry and reading from the file.
   ReadOptions ro(read_options);
   bool snapshot_created = SetSnapshotIfNeeded(&ro);
 
-  std::vector<Status> statuses;
-  statuses.reserve(keys.size());
-  values->clear();
-  values->reserve(keys.size());
-  PinnableSlice value;
-  for (size_t i = 0; i < keys.size(); i++) {
-    statuses.push_back(Get(ro, DefaultColumnFamily(), keys[i], &value));
-    values->push_back(value.ToString());
-    value.Reset();
+  autovector<KeyContext, MultiGetContext::MAX_BATCH_SIZE> key_context;
+  for (size_t i = 0; i < num_keys; i++) {
+    key_context.emplace_back(keys[i], &values[i], &statuses[i]);
+  }
+  db_impl_->MultiGetImpl(ro, column_family, key_context, sorted_input,
+                         nullptr /* callback */, true /* allow_blob_index */);
+  RecordTick(statistics_, BLOB_DB_NUM_KEYS_READ, num_keys);
+
+  // The blob values replace the blob indexes, so the indexes are copied out
+  // first.
+  std::vector<std::string> index_entries;
+  index_entries.reserve(num_keys);
+  std::vector<BlobValueRequest> requests;
+  for (size_t i = 0; i < num_keys; i++) {
+    if (statuses[i].ok() && key_context[i].is_blob_index) {
+      index_entries.emplace_back(values[i].data(), values[i].size());
+      values[i].Reset();
+      requests.push_back(
+          {keys[i], index_entries.back(), &values[i], &statuses[i]});
+    }
+  }
+  if (!requests.empty()) {
+    MultiGetBlobValues(requests.data(), requests.size());
+  }
+
+  uint64_t bytes_read = 0;
+  for (size_t i = 0; i < num_keys; i++) {
+    if (statuses[i].ok()) {
+      bytes_read += values[i].size();
+    }
   }
+  RecordTick(statistics_, BLOB_DB_BYTES_READ, bytes_read);
   if (snapshot_created) {
     db_->ReleaseSnapshot(ro.snapshot);
   }
-  return statuses;
 }
 
 bool BlobDBImpl::SetSnapshotIfNeeded(ReadOptions* read_options) {
@@ -981,31 +1037,10 @@ Status BlobDBImpl::GetBlobValue(const Slice& key, const Slice& index_entry,
       *expiration = kNoExpiration;
     }
   }
-  if (blob_index.IsInlined()) {
-    // TODO(yiwu): If index_entry is a PinnableSlice, we can also pin the same
-    // memory buffer to avoid extra copy.
-    value->PinSelf(blob_index.value());
-    return Status::OK();
-  }
-  if (blob_index.size() == 0) {
-    value->PinSelf("");
-    return Status::OK();
-  }
-
-  // offset has to have certain min, as we will read CRC
-  // later from the Blob Header, which needs to be also a
-  // valid offset.
-  if (blob_index.offset() <
-      (BlobLogHeader::kSize + BlobLogRecord::kHeaderSize + key.size())) {
-    if (debug_level_ >= 2) {
-      ROCKS_LOG_ERROR(db_options_.info_log,
-                      "Invalid blob index file_number: %" PRIu64
-                      " blob_offset: %" PRIu64 " blob_size: %" PRIu64
-                      " key: %s",
-                      blob_index.file_number(), blob_index.offset(),
-                      blob_index.size(), key.data());
-    }
-    return Status::NotFound("Invalid blob offset");
+  bool done = false;
+  s = GetBlobValueWithoutRead(key, blob_index, value, &done);
+  if (!s.ok() || done) {
+    return s;
   }
 
   std::shared_ptr<BlobFile> bfile;
@@ -1021,11 +1056,6 @@ Status BlobDBImpl::GetBlobValue(const Slice& key, const Slice& index_entry,
     bfile = hitr->second;
   }
 
-  if (blob_index.size() == 0 && value != nullptr) {
-    value->PinSelf("");
-    return Status::OK();
-  }
-
   // takes locks when called
   std::shared_ptr<RandomAccessFileReader> reader;
   s = GetBlobFileReader(bfile, &reader);
@@ -1057,6 +1087,213 @@ Status BlobDBImpl::GetBlobValue(const Slice& key, const Slice& index_entry,
                     blob_index.size(), key.size(), s.ToString().c_str());
     return s;
   }
+  return GetBlobValueFromRecord(bfile, key, blob_index, blob_record, value);
+}
+
+void BlobDBImpl::MultiGetBlobValues(BlobValueRequest* requests,
+                                    size_t num_requests) {
+  // A blob to read, with the byte range of its checksum, key and value
+  struct BlobRead {
+    BlobValueRequest* request;
+    BlobIndex blob_index;
+    uint64_t record_offset;
+    uint64_t record_size;
+  };
+
+  std::vector<BlobRead> reads;
+  reads.reserve(num_requests);
+  for (size_t i = 0; i < num_requests; i++) {
+    BlobValueRequest& request = requests[i];
+    BlobRead read;
+    read.request = &request;
+    Status& s = *request.status;
+    s = read.blob_index.DecodeFrom(request.index_entry);
+    if (!s.ok()) {
+      continue;
+    }
+    if (read.blob_index.HasTTL() &&
+        read.blob_index.expiration() <= EpochNow()) {
+      s = Status::NotFound("Key expired");
+      continue;
+    }
+    bool done = false;
+    s = GetBlobValueWithoutRead(request.key, read.blob_index, request.value,
+                                &done);
+    if (!s.ok() || done) {
+      continue;
+    }
+    assert(read.blob_index.offset() > request.key.size() + sizeof(uint32_t));
+    read.record_offset =
+        read.blob_index.offset() - request.key.size() - sizeof(uint32_t);
+    read.record_size =
+        sizeof(uint32_t) + request.key.size() + read.blob_index.size();
+    reads.push_back(read);
+  }
+  std::sort(reads.begin(), reads.end(),
+            [](const BlobRead& lhs, const BlobRead& rhs) {
+              if (lhs.blob_index.file_number() !=
+                  rhs.blob_index.file_number()) {
+                return lhs.blob_index.file_number() <
+                       rhs.blob_index.file_number();
+              }
+              return lhs.record_offset < rhs.record_offset;
+            });
+
+  size_t file_begin = 0;
+  while (file_begin < reads.size()) {
+    const uint64_t file_number = reads[file_begin].blob_index.file_number();
+    size_t file_end = file_begin + 1;
+    while (file_end < reads.size() &&
+           reads[file_end].blob_index.file_number() == file_number) {
+      file_end++;
+    }
+
+    std::shared_ptr<BlobFile> bfile;
+    {
+      ReadLock rl(&mutex_);
+      auto hitr = blob_files_.find(file_number);
+      if (hitr != blob_files_.end()) {
+        bfile = hitr->second;
+      }
+    }
+    std::shared_ptr<RandomAccessFileReader> reader;
+    Status s;
+    if (bfile == nullptr) {
+      s = Status::NotFound("Blob Not Found as blob file missing");
+    } else {
+      s = GetBlobFileReader(bfile, &reader);
+    }
+    if (!s.ok()) {
+      for (size_t i = file_begin; i < file_end; i++) {
+        *reads[i].request->status = s;
+      }
+      file_begin = file_end;
+      continue;
+    }
+
+    // Blobs less than kMultiGetBlobReadGap bytes apart, such as the blobs of
+    // keys written together, are read with one request.
+    std::vector<ReadRequest> read_reqs;
+    std::vector<size_t> read_req_index(file_end - file_begin);
+    size_t total_len = 0;
+    for (size_t i = file_begin; i < file_end; i++) {
+      const BlobRead& read = reads[i];
+      if (!read_reqs.empty() &&
+          read.record_offset <= read_reqs.back().offset +
+                                    read_reqs.back().len +
+                                    kMultiGetBlobReadGap) {
+        ReadRequest& req = read_reqs.back();
+        const uint64_t req_end = std::max<uint64_t>(
+            req.offset + req.len, read.record_offset + read.record_size);
+        total_len += static_cast<size_t>(req_end - req.offset) - req.len;
+        req.len = static_cast<size_t>(req_end - req.offset);
+      } else {
+        ReadRequest req;
+        req.offset = read.record_offset;
+        req.len = static_cast<size_t>(read.record_size);
+        req.scratch = nullptr;
+        read_reqs.push_back(req);
+        total_len += req.len;
+      }
+      read_req_index[i - file_begin] = read_reqs.size() - 1;
+    }
+    std::unique_ptr<char[]> buffer(new char[total_len]);
+    size_t buf_offset = 0;
+    for (ReadRequest& req : read_reqs) {
+      req.scratch = buffer.get() + buf_offset;
+      buf_offset += req.len;
+    }
+    TEST_SYNC_POINT_CALLBACK("BlobDBImpl::MultiGetBlobValues:ReadRequests",
+                             &read_reqs);
+
+    {
+      StopWatch read_sw(env_, statistics_, BLOB_DB_BLOB_FILE_READ_MICROS);
+      if (reader->use_direct_io()) {
+        for (ReadRequest& req : read_reqs) {
+          req.status = reader->Read(req.offset, req.len, &req.result,
+                                    req.scratch);
+        }
+      } else {
+        s = reader->MultiRead(read_reqs.data(), read_reqs.size());
+      }
+    }
+    uint64_t bytes_read = 0;
+    for (const ReadRequest& req : read_reqs) {
+      bytes_read += req.result.size();
+    }
+    RecordTick(statistics_, BLOB_DB_BLOB_FILE_BYTES_READ, bytes_read);
+
+    for (size_t i = file_begin; i < file_end; i++) {
+      const BlobRead& read = reads[i];
+      const ReadRequest& req = read_reqs[read_req_index[i - file_begin]];
+      Status& read_status = *read.request->status;
+      read_status = s.ok() ? req.status : s;
+      if (!read_status.ok()) {
+        ROCKS_LOG_DEBUG(db_options_.info_log,
+                        "Failed to read blob from blob file %" PRIu64
+                        ", blob_offset: %" PRIu64 ", blob_size: %" PRIu64
+                        ", key_size: %" ROCKSDB_PRIszt ", status: '%s'",
+                        file_number, read.blob_index.offset(),
+                        read.blob_index.size(), read.request->key.size(),
+                        read_status.ToString().c_str());
+        continue;
+      }
+      const uint64_t offset_in_req = read.record_offset - req.offset;
+      Slice blob_record;
+      if (req.result.size() > offset_in_req) {
+        blob_record = Slice(
+            req.result.data() + offset_in_req,
+            std::min<size_t>(req.result.size() - offset_in_req,
+                             static_cast<size_t>(read.record_size)));
+      }
+      read_status = GetBlobValueFromRecord(bfile, read.request->key,
+                                           read.blob_index, blob_record,
+                                           read.request->value);
+    }
+    file_begin = file_end;
+  }
+}
+
+Status BlobDBImpl::GetBlobValueWithoutRead(const Slice& key,
+                                           const BlobIndex& blob_index,
+                                           PinnableSlice* value, bool* done) {
+  *done = true;
+  if (blob_index.IsInlined()) {
+    // TODO(yiwu): If index_entry is a PinnableSlice, we can also pin the same
+    // memory buffer to avoid extra copy.
+    value->PinSelf(blob_index.value());
+    return Status::OK();
+  }
+  if (blob_index.size() == 0) {
+    value->PinSelf("");
+    return Status::OK();
+  }
+
+  // offset has to have certain min, as we will read CRC
+  // later from the Blob Header, which needs to be also a
+  // valid offset.
+  if (blob_index.offset() <
+      (BlobLogHeader::kSize + BlobLogRecord::kHeaderSize + key.size())) {
+    if (debug_level_ >= 2) {
+      ROCKS_LOG_ERROR(db_options_.info_log,
+                      "Invalid blob index file_number: %" PRIu64
+                      " blob_offset: %" PRIu64 " blob_size: %" PRIu64
+                      " key: %s",
+                      blob_index.file_number(), blob_index.offset(),
+                      blob_index.size(), key.data());
+    }
+    return Status::NotFound("Invalid blob offset");
+  }
+  *done = false;
+  return Status::OK();
+}
+
+Status BlobDBImpl::GetBlobValueFromRecord(
+    const std::shared_ptr<BlobFile>& bfile, const Slice& key,
+    const BlobIndex& blob_index, const Slice& blob_record,
+    PinnableSlice* value) {
+  Status s;
+  uint64_t record_size = sizeof(uint32_t) + key.size() + blob_index.size();
   if (blob_record.size() != record_size) {
     ROCKS_LOG_DEBUG(
         db_options_.info_log,
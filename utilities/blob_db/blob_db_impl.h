@@ -46,6 +46,7 @@ namespace blob_db {
 struct BlobCompactionContext;
 class BlobDBImpl;
 class BlobFile;
+class BlobIndex;
 
 // Comparator to sort "TTL" aware Blob files based on the lower value of
 // TTL range.
@@ -136,6 +137,14 @@ class BlobDBImpl : public BlobDB {
       const std::vector<Slice>& keys,
       std::vector<std::string>* values) override;
 
+  // Looks up the blob indexes of all the keys with one batched lookup of the
+  // base DB, then reads the blobs of each blob file with one MultiRead().
+  virtual void MultiGet(const ReadOptions& read_options,
+                        ColumnFamilyHandle* column_family,
+                        const size_t num_keys, const Slice* keys,
+                        PinnableSlice* values, Status* statuses,
+                        const bool sorted_input = false) override;
+
   virtual Status Write(const WriteOptions& opts, WriteBatch* updates) override;
 
   virtual Status Close() override;
@@ -216,6 +225,31 @@ class BlobDBImpl : public BlobDB {
   Status GetBlobValue(const Slice& key, const Slice& index_entry,
                       PinnableSlice* value, uint64_t* expiration = nullptr);
 
+  // A blob value to be read by MultiGetBlobValues().
+  struct BlobValueRequest {
+    Slice key;
+    Slice index_entry;
+    PinnableSlice* value;
+    Status* status;
+  };
+
+  // Reads the values of a batch of blob indexes like GetBlobValue(). The
+  // reads of each blob file are sorted by offset, reads of nearby blobs are
+  // merged, and they are all issued with one MultiRead().
+  void MultiGetBlobValues(BlobValueRequest* requests, size_t num_requests);
+
+  // Sets *value for the blob indexes whose value is known without reading
+  // the blob file, in which case *done is set to true.
+  Status GetBlobValueWithoutRead(const Slice& key, const BlobIndex& blob_index,
+                                 PinnableSlice* value, bool* done);
+
+  // Checks and decompresses `blob_record`, the checksum, key and value of
+  // the blob of `blob_index` read from `bfile`, into *value.
+  Status GetBlobValueFromRecord(const std::shared_ptr<BlobFile>& bfile,
+                                const Slice& key, const BlobIndex& blob_index,
+                                const Slice& blob_record,
+                                PinnableSlice* value);
+
   Slice GetCompressedSlice(const Slice& raw,
                            std::string* compression_output) const;
 
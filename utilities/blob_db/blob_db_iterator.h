@@ -16,6 +16,12 @@ namespace blob_db {
 
 using rocksdb::ManagedSnapshot;
 
+// Iterates over a snapshot of the base DB, reading the values of the blob
+// indexes from the blob files. Once a scan moves forward with Next() a few
+// times in a row, the entries ahead of it are read in batches, and the blobs
+// of a batch are read with one MultiRead() per blob file instead of one read
+// per entry. The batch size doubles with each batch, up to
+// kMaxPrefetchEntries.
 class BlobDBIterator : public Iterator {
  public:
   BlobDBIterator(ManagedSnapshot* snapshot, ArenaWrappedDBIter* iter,
@@ -29,6 +35,9 @@ class BlobDBIterator : public Iterator {
   virtual ~BlobDBIterator() = default;
 
   bool Valid() const override {
+    if (IsPrefetched()) {
+      return prefetched_statuses_[prefetched_pos_].ok();
+    }
     if (!iter_->Valid()) {
       return false;
     }
@@ -36,6 +45,9 @@ class BlobDBIterator : public Iterator {
   }
 
   Status status() const override {
+    if (IsPrefetched()) {
+      return prefetched_statuses_[prefetched_pos_];
+    }
     if (!iter_->status().ok()) {
       return iter_->status();
     }
@@ -45,6 +57,7 @@ class BlobDBIterator : public Iterator {
   void SeekToFirst() override {
     StopWatch seek_sw(env_, statistics_, BLOB_DB_SEEK_MICROS);
     RecordTick(statistics_, BLOB_DB_NUM_SEEK);
+    ResetPrefetch();
     iter_->SeekToFirst();
     while (UpdateBlobValue()) {
       iter_->Next();
@@ -54,6 +67,7 @@ class BlobDBIterator : public Iterator {
   void SeekToLast() override {
     StopWatch seek_sw(env_, statistics_, BLOB_DB_SEEK_MICROS);
     RecordTick(statistics_, BLOB_DB_NUM_SEEK);
+    ResetPrefetch();
     iter_->SeekToLast();
     while (UpdateBlobValue()) {
       iter_->Prev();
@@ -63,6 +77,7 @@ class BlobDBIterator : public Iterator {
   void Seek(const Slice& target) override {
     StopWatch seek_sw(env_, statistics_, BLOB_DB_SEEK_MICROS);
     RecordTick(statistics_, BLOB_DB_NUM_SEEK);
+    ResetPrefetch();
     iter_->Seek(target);
     while (UpdateBlobValue()) {
       iter_->Next();
@@ -72,6 +87,7 @@ class BlobDBIterator : public Iterator {
   void SeekForPrev(const Slice& target) override {
     StopWatch seek_sw(env_, statistics_, BLOB_DB_SEEK_MICROS);
     RecordTick(statistics_, BLOB_DB_NUM_SEEK);
+    ResetPrefetch();
     iter_->SeekForPrev(target);
     while (UpdateBlobValue()) {
       iter_->Prev();
@@ -82,7 +98,20 @@ class BlobDBIterator : public Iterator {
     assert(Valid());
     StopWatch next_sw(env_, statistics_, BLOB_DB_NEXT_MICROS);
     RecordTick(statistics_, BLOB_DB_NUM_NEXT);
+    if (IsPrefetched()) {
+      if (++prefetched_pos_ < prefetched_keys_.size()) {
+        return;
+      }
+      // iter_ is already at the entry after the last prefetched one
+      ClearPrefetched();
+      Prefetch();
+      return;
+    }
     iter_->Next();
+    if (++num_sequential_nexts_ >= kNextsBeforePrefetch) {
+      Prefetch();
+      return;
+    }
     while (UpdateBlobValue()) {
       iter_->Next();
     }
@@ -92,6 +121,12 @@ class BlobDBIterator : public Iterator {
     assert(Valid());
     StopWatch prev_sw(env_, statistics_, BLOB_DB_PREV_MICROS);
     RecordTick(statistics_, BLOB_DB_NUM_PREV);
+    if (IsPrefetched()) {
+      // Move iter_ back to the current entry. The iterator reads a
+      // snapshot, so the entry is still there.
+      iter_->Seek(prefetched_keys_[prefetched_pos_]);
+    }
+    ResetPrefetch();
     iter_->Prev();
     while (UpdateBlobValue()) {
       iter_->Prev();
@@ -100,11 +135,17 @@ class BlobDBIterator : public Iterator {
 
   Slice key() const override {
     assert(Valid());
+    if (IsPrefetched()) {
+      return prefetched_keys_[prefetched_pos_];
+    }
     return iter_->key();
   }
 
   Slice value() const override {
     assert(Valid());
+    if (IsPrefetched()) {
+      return prefetched_values_[prefetched_pos_];
+    }
     if (!iter_->IsBlob()) {
       return iter_->value();
     }
@@ -114,6 +155,11 @@ class BlobDBIterator : public Iterator {
   // Iterator::Refresh() not supported.
 
  private:
+  // Number of consecutive Next() calls after which entries are prefetched
+  static const size_t kNextsBeforePrefetch = 2;
+  static const size_t kMinPrefetchEntries = 4;
+  static const size_t kMaxPrefetchEntries = 64;
+
   // Return true if caller should continue to next value.
   bool UpdateBlobValue() {
     TEST_SYNC_POINT("BlobDBIterator::UpdateBlobValue:Start:1");
@@ -135,6 +181,84 @@ class BlobDBIterator : public Iterator {
     }
   }
 
+  bool IsPrefetched() const {
+    return prefetched_pos_ < prefetched_keys_.size();
+  }
+
+  void ClearPrefetched() {
+    prefetched_keys_.clear();
+    prefetched_statuses_.clear();
+    prefetched_pos_ = 0;
+  }
+
+  void ResetPrefetch() {
+    ClearPrefetched();
+    num_sequential_nexts_ = 0;
+    prefetch_entries_ = kMinPrefetchEntries;
+  }
+
+  // Reads the next prefetch_entries_ entries of iter_, starting with the
+  // current one, and the values of their blob indexes, skipping the expired
+  // blobs. If they are all skipped, reads the next batch.
+  void Prefetch() {
+    value_.Reset();
+    status_ = Status::OK();
+    if (prefetched_values_ == nullptr) {
+      prefetched_values_.reset(new PinnableSlice[kMaxPrefetchEntries]);
+    }
+    while (!IsPrefetched() && iter_->Valid() && iter_->status().ok()) {
+      // The requests refer to the keys and the index entries, so neither
+      // may be reallocated while they are filled.
+      prefetched_keys_.reserve(prefetch_entries_);
+      std::vector<std::string> index_entries;
+      index_entries.reserve(prefetch_entries_);
+      std::vector<BlobDBImpl::BlobValueRequest> requests;
+      prefetched_statuses_.resize(prefetch_entries_);
+      size_t num_entries = 0;
+      for (; num_entries < prefetch_entries_ && iter_->Valid() &&
+             iter_->status().ok();
+           num_entries++, iter_->Next()) {
+        prefetched_keys_.emplace_back(iter_->key().data(),
+                                      iter_->key().size());
+        PinnableSlice* value = &prefetched_values_[num_entries];
+        Status* status = &prefetched_statuses_[num_entries];
+        value->Reset();
+        *status = Status::OK();
+        if (iter_->IsBlob()) {
+          index_entries.emplace_back(iter_->value().data(),
+                                     iter_->value().size());
+          requests.push_back(
+              {prefetched_keys_.back(), index_entries.back(), value, status});
+        } else {
+          value->PinSelf(iter_->value());
+        }
+      }
+      if (!requests.empty()) {
+        blob_db_->MultiGetBlobValues(requests.data(), requests.size());
+      }
+      // Drop the expired blobs, moving the other entries up
+      size_t num_kept = 0;
+      for (size_t i = 0; i < num_entries; i++) {
+        if (prefetched_statuses_[i].IsNotFound()) {
+          continue;
+        }
+        if (num_kept != i) {
+          prefetched_keys_[num_kept].swap(prefetched_keys_[i]);
+          prefetched_statuses_[num_kept] = prefetched_statuses_[i];
+          prefetched_values_[num_kept].Reset();
+          prefetched_values_[num_kept].PinSelf(prefetched_values_[i]);
+        }
+        num_kept++;
+      }
+      prefetched_keys_.resize(num_kept);
+      prefetched_statuses_.resize(num_kept);
+      prefetched_pos_ = 0;
+      if (prefetch_entries_ < kMaxPrefetchEntries) {
+        prefetch_entries_ *= 2;
+      }
+    }
+  }
+
   std::unique_ptr<ManagedSnapshot> snapshot_;
   std::unique_ptr<ArenaWrappedDBIter> iter_;
   BlobDBImpl* blob_db_;
@@ -142,6 +266,16 @@ class BlobDBIterator : public Iterator {
   Statistics* statistics_;
   Status status_;
   PinnableSlice value_;
+
+  // While the iterator is positioned on a prefetched entry, i.e. while
+  // prefetched_pos_ < prefetched_keys_.size(), iter_ is positioned on the
+  // entry after the last prefetched one.
+  std::vector<std::string> prefetched_keys_;
+  std::unique_ptr<PinnableSlice[]> prefetched_values_;
+  std::vector<Status> prefetched_statuses_;
+  size_t prefetched_pos_ = 0;
+  size_t num_sequential_nexts_ = 0;
+  size_t prefetch_entries_ = kMinPrefetchEntries;
 };
 }  // namespace blob_db
 }  // namespace rocksdb
@@ -201,6 +201,20 @@ class BlobDBTest : public testing::Test {
     ASSERT_FALSE(iter->Valid());
     ASSERT_OK(iter->status());
     delete iter;
+
+    // Verify MultiGet
+    std::vector<Slice> keys;
+    for (auto &p : data) {
+      keys.push_back(p.first);
+    }
+    std::vector<std::string> values;
+    std::vector<Status> statuses = db->MultiGet(ReadOptions(), keys, &values);
+    size_t i = 0;
+    for (auto &p : data) {
+      ASSERT_OK(statuses[i]);
+      ASSERT_EQ(p.second, values[i]);
+      i++;
+    }
   }
 
   void VerifyBaseDB(
@@ -1303,6 +1317,138 @@ TEST_F(BlobDBTest, InlineSmallValues) {
   ASSERT_TRUE(ttl_file->HasTTL());
 }
 
+TEST_F(BlobDBTest, MultiGetAndIteratorPrefetch) {
+  Random rnd(301);
+  BlobDBOptions bdb_options;
+  bdb_options.min_blob_size = 100;
+  bdb_options.blob_file_size = 20000;
+  bdb_options.disable_background_tasks = true;
+  Open(bdb_options);
+  std::map<std::string, std::string> data;
+  for (size_t i = 0; i < 300; i++) {
+    // Keys are written out of order, so that the blobs of neighbouring keys
+    // are in different blob files.
+    std::string key = "key" + ToString((i * 7) % 300 + 1000);
+    int len = (i % 3 == 0) ? 50 : 150;
+    data[key] = test::RandomHumanReadableString(&rnd, len);
+    ASSERT_OK(blob_db_->Put(WriteOptions(), key, data[key]));
+  }
+  auto *bdb_impl = static_cast<BlobDBImpl *>(blob_db_);
+  ASSERT_LT(1, bdb_impl->TEST_GetBlobFiles().size());
+  VerifyDB(data);
+
+  // Each blob file read by a batch gets one MultiRead, in which blobs less
+  // than kMultiGetBlobReadGap (4096) bytes apart share a request
+  const uint64_t kReadGap = 4096;
+  int num_file_reads = 0;
+  int num_read_requests = 0;
+  int num_unmerged_requests = 0;
+  SyncPoint::GetInstance()->SetCallBack(
+      "BlobDBImpl::MultiGetBlobValues:ReadRequests", [&](void *arg) {
+        auto *read_reqs = static_cast<std::vector<ReadRequest> *>(arg);
+        num_file_reads++;
+        num_read_requests += static_cast<int>(read_reqs->size());
+        for (size_t i = 1; i < read_reqs->size(); i++) {
+          const ReadRequest &prev = (*read_reqs)[i - 1];
+          if ((*read_reqs)[i].offset <= prev.offset + prev.len + kReadGap) {
+            num_unmerged_requests++;
+          }
+        }
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  // Keys written one after another have their blobs next to each other, in
+  // at most two blob files
+  std::vector<std::string> batch_key_strs;
+  int num_blobs = 0;
+  for (size_t i = 100; i < 120; i++) {
+    batch_key_strs.push_back("key" + ToString((i * 7) % 300 + 1000));
+    if (i % 3 != 0) {
+      num_blobs++;
+    }
+  }
+  std::vector<Slice> batch_keys(batch_key_strs.begin(), batch_key_strs.end());
+  std::vector<PinnableSlice> batch_values(batch_keys.size());
+  std::vector<Status> batch_statuses(batch_keys.size());
+  blob_db_->MultiGet(ReadOptions(), blob_db_->DefaultColumnFamily(),
+                     batch_keys.size(), batch_keys.data(), batch_values.data(),
+                     batch_statuses.data());
+  for (size_t i = 0; i < batch_keys.size(); i++) {
+    ASSERT_OK(batch_statuses[i]);
+    ASSERT_EQ(data[batch_key_strs[i]], batch_values[i].ToString());
+  }
+  ASSERT_GE(2, num_file_reads);
+  ASSERT_EQ(num_file_reads, num_read_requests);
+  ASSERT_LT(num_read_requests, num_blobs);
+
+  // Batched MultiGet with missing keys
+  num_file_reads = 0;
+  std::vector<std::string> key_strs;
+  for (size_t i = 0; i < 100; i++) {
+    key_strs.push_back("key" + ToString(i * 4 + 1000 - 50));
+  }
+  std::vector<Slice> keys(key_strs.begin(), key_strs.end());
+  std::vector<PinnableSlice> values(keys.size());
+  std::vector<Status> statuses(keys.size());
+  blob_db_->MultiGet(ReadOptions(), blob_db_->DefaultColumnFamily(),
+                     keys.size(), keys.data(), values.data(), statuses.data());
+  for (size_t i = 0; i < keys.size(); i++) {
+    auto it = data.find(key_strs[i]);
+    if (it == data.end()) {
+      ASSERT_TRUE(statuses[i].IsNotFound());
+    } else {
+      ASSERT_OK(statuses[i]);
+      ASSERT_EQ(it->second, values[i].ToString());
+    }
+  }
+  // One read per blob file
+  ASSERT_GE(bdb_impl->TEST_GetBlobFiles().size(),
+            static_cast<size_t>(num_file_reads));
+
+  // Change direction in the middle of a prefetched batch, then scan forward
+  // again
+  num_file_reads = 0;
+  num_read_requests = 0;
+  std::unique_ptr<Iterator> iter(blob_db_->NewIterator(ReadOptions()));
+  iter->Seek("key1100");
+  auto expected = data.find("key1100");
+  for (int i = 0; i < 20; i++) {
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(expected->first, iter->key().ToString());
+    ASSERT_EQ(expected->second, iter->value().ToString());
+    iter->Next();
+    ++expected;
+  }
+  for (int i = 0; i < 10; i++) {
+    iter->Prev();
+    --expected;
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(expected->first, iter->key().ToString());
+    ASSERT_EQ(expected->second, iter->value().ToString());
+  }
+  for (; expected != data.end(); ++expected) {
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(expected->first, iter->key().ToString());
+    ASSERT_EQ(expected->second, iter->value().ToString());
+    iter->Next();
+  }
+  ASSERT_FALSE(iter->Valid());
+  ASSERT_OK(iter->status());
+  // The blobs are prefetched in batches, with several reads merged, rather
+  // than read one by one
+  int num_scanned_blobs = 0;
+  for (auto it = data.find("key1100"); it != data.end(); ++it) {
+    if (it->second.size() >= bdb_options.min_blob_size) {
+      num_scanned_blobs++;
+    }
+  }
+  ASSERT_LT(num_file_reads, num_read_requests);
+  ASSERT_LT(num_read_requests, num_scanned_blobs);
+  ASSERT_EQ(0, num_unmerged_requests);
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+}
+
 TEST_F(BlobDBTest, CompactionFilterNotSupported) {
   class TestCompactionFilter : public CompactionFilter {
     const char *Name() const override { return "TestCompactionFilter"; }
@@ -1327,6 +1473,12 @@ TEST_F(BlobDBTest, CompactionFilterNotSupported) {
   }
 }
 
+TEST_F(BlobDBTest, BlobFilesNotSupported) {
+  Options options;
+  options.enable_blob_files = true;
+  ASSERT_TRUE(TryOpen(BlobDBOptions(), options).IsNotSupported());
+}
+
 // Test comapction filter should remove any expired blob index.
 TEST_F(BlobDBTest, FilterExpiredBlobIndex) {
   constexpr size_t kNumKeys = 100;
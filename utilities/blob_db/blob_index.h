@@ -3,7 +3,6 @@
 //  COPYING file in the root directory) and Apache 2.0 License
 //  (found in the LICENSE.Apache file in the root directory).
 #pragma once
-#ifndef ROCKSDB_LITE
 
 #include "rocksdb/options.h"
 #include "util/coding.h"
@@ -81,6 +80,11 @@ class BlobIndex {
     return size_;
   }
 
+  CompressionType compression() const {
+    assert(!IsInlined());
+    return compression_;
+  }
+
   Status DecodeFrom(Slice slice) {
     static const std::string kErrorMessage = "Error while decoding blob index";
     assert(slice.size() > 0);
@@ -158,4 +162,3 @@ class BlobIndex {
 
 }  // namespace blob_db
 }  // namespace rocksdb
-#endif  // ROCKSDB_LITE
@@ -3,8 +3,6 @@
 //  COPYING file in the root directory) and Apache 2.0 License
 //  (found in the LICENSE.Apache file in the root directory).
 //
-#ifndef ROCKSDB_LITE
-
 #include "utilities/blob_db/blob_log_format.h"
 
 #include "util/coding.h"
@@ -146,4 +144,3 @@ Status BlobLogRecord::CheckBlobCRC() const {
 
 }  // namespace blob_db
 }  // namespace rocksdb
-#endif  // ROCKSDB_LITE
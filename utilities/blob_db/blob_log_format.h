@@ -7,8 +7,6 @@
 
 #pragma once
 
-#ifndef ROCKSDB_LITE
-
 #include <limits>
 #include <memory>
 #include <utility>
@@ -122,4 +120,3 @@ struct BlobLogRecord {
 
 }  // namespace blob_db
 }  // namespace rocksdb
-#endif  // ROCKSDB_LITE
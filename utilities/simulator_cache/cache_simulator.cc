@@ -218,6 +218,20 @@ Status BlockCacheTraceSimulator::InitializeCaches() {
             NewLRUCache(simulate_cache_capacity, config.num_shard_bits,
                         /*strict_capacity_limit=*/false,
                         /*high_pri_pool_ratio=*/0));
+      } else if (cache_name == "lru_tinylfu" ||
+                 cache_name == "lru_priority_tinylfu") {
+        LRUCacheOptions opts(simulate_cache_capacity, config.num_shard_bits,
+                             /*strict_capacity_limit=*/false,
+                             /*high_pri_pool_ratio=*/0);
+        opts.tiny_lfu_admission = true;
+        if (cache_name == "lru_tinylfu") {
+          sim_cache = std::make_shared<CacheSimulator>(std::move(ghost_cache),
+                                                       NewLRUCache(opts));
+        } else {
+          opts.high_pri_pool_ratio = 0.5;
+          sim_cache = std::make_shared<PrioritizedCacheSimulator>(
+              std::move(ghost_cache), NewLRUCache(opts));
+        }
       } else if (cache_name == "lru_priority") {
         sim_cache = std::make_shared<PrioritizedCacheSimulator>(
             std::move(ghost_cache),
@@ -140,6 +140,52 @@ TEST_F(CacheSimulatorTest, CacheSimulator) {
   ASSERT_EQ(nullptr, handle);
 }
 
+TEST_F(CacheSimulatorTest, TinyLFUCacheSimulator) {
+  // A hot set that fits in the cache, accessed a few times, is followed by
+  // a scan of blocks accessed once and by the hot set again.
+  const uint64_t kNumHotBlocks = 8;
+  const uint64_t kNumScanBlocks = 100;
+  std::vector<BlockCacheTraceRecord> trace;
+  for (int round = 0; round < 5; round++) {
+    for (uint64_t i = 0; i < kNumHotBlocks; i++) {
+      trace.push_back(GenerateGetRecord(kGetId));
+      trace.back().block_key = kBlockKeyPrefix + std::to_string(i);
+    }
+  }
+  for (uint64_t i = 0; i < kNumScanBlocks; i++) {
+    trace.push_back(GenerateCompactionRecord());
+    trace.back().block_key = kBlockKeyPrefix + std::to_string(1000 + i);
+    trace.back().no_insert = Boolean::kFalse;
+  }
+  for (uint64_t i = 0; i < kNumHotBlocks; i++) {
+    trace.push_back(GenerateGetRecord(kGetId));
+    trace.back().block_key = kBlockKeyPrefix + std::to_string(i);
+  }
+
+  LRUCacheOptions opts(/*capacity=*/10 * 4096, /*num_shard_bits=*/0,
+                       /*strict_capacity_limit=*/false,
+                       /*high_pri_pool_ratio=*/0);
+  std::unique_ptr<CacheSimulator> lru(
+      new CacheSimulator(nullptr, NewLRUCache(opts)));
+  opts.tiny_lfu_admission = true;
+  std::unique_ptr<CacheSimulator> tiny_lfu(
+      new CacheSimulator(nullptr, NewLRUCache(opts)));
+  for (const auto& access : trace) {
+    lru->Access(access);
+    tiny_lfu->Access(access);
+  }
+  ASSERT_EQ(trace.size(), lru->miss_ratio_stats().total_accesses());
+  ASSERT_EQ(trace.size(), tiny_lfu->miss_ratio_stats().total_accesses());
+  // The scan flushes the hot set out of the plain LRU cache, but not out of
+  // the one with an admission policy.
+  const uint64_t kColdMisses = kNumHotBlocks + kNumScanBlocks;
+  ASSERT_EQ(kColdMisses + kNumHotBlocks,
+            lru->miss_ratio_stats().total_misses());
+  ASSERT_EQ(kColdMisses, tiny_lfu->miss_ratio_stats().total_misses());
+  ASSERT_LT(tiny_lfu->miss_ratio_stats().user_miss_ratio(),
+            lru->miss_ratio_stats().user_miss_ratio());
+}
+
 TEST_F(CacheSimulatorTest, GhostCacheSimulator) {
   const BlockCacheTraceRecord& access = GenerateGetRecord(kGetId);
   std::unique_ptr<GhostCache> ghost_cache(new GhostCache(